@@ -61,6 +61,10 @@ IF (OONF_REMOVE_HELPTEXT)
     ADD_DEFINITIONS(-DREMOVE_HELPTEXT)
 ENDIF(OONF_REMOVE_HELPTEXT)
 
+IF (OONF_TIMER_WHEEL)
+    ADD_DEFINITIONS(-DOONF_TIMER_WHEEL)
+ENDIF(OONF_TIMER_WHEEL)
+
 # OS-specific compiler settings
 IF(ANDROID OR WIN32)
     # Android and windows don't compile well with c99
@@ -20,3 +20,12 @@ function (oonf_create_test executable source libraries)
 
     ADD_TEST(NAME ${executable} COMMAND ${executable})
 endfunction (oonf_create_test)
+
+function (oonf_create_benchmark executable source libraries)
+    # create executable, benchmarks are built with the tests but not run by ctest
+    ADD_EXECUTABLE(${executable} ${source})
+
+    add_dependencies(build_tests ${executable})
+
+    TARGET_LINK_LIBRARIES(${executable} ${libraries})
+endfunction (oonf_create_benchmark)
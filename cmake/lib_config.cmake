@@ -26,6 +26,10 @@ set (OONF_REMOVE_HELPTEXT false CACHE BOOL
 set (OONF_SANITIZE false CACHE BOOL
      "Activate the address sanitizer")
 
+# use a hierarchical timing wheel instead of an AVL tree for the timer scheduler
+set (OONF_TIMER_WHEEL true CACHE BOOL
+     "Use hierarchical timing wheel (O(1) start/stop) for the timer scheduler")
+
 ######################################
 #### Install target configuration ####
 ######################################
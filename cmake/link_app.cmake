@@ -77,6 +77,16 @@ function (oonf_create_app executable static_plugins optional_static_plugins)
         ENDIF(TARGET oonf_static_${plugin})
     ENDFOREACH(plugin)
 
+    # extract external libraries of the framework libraries linked into the static executable
+    FOREACH(library libcommon libconfig libcore librfc5444)
+        get_property(value TARGET oonf_${library} PROPERTY LINK_LIBRARIES)
+        FOREACH(lib ${value})
+            IF(NOT "${lib}" MATCHES "^oonf_")
+                SET(EXTERNAL_LIBRARIES ${EXTERNAL_LIBRARIES} ${lib})
+            ENDIF()
+        ENDFOREACH(lib)
+    ENDFOREACH(library)
+
     # create executables
     ADD_EXECUTABLE(${executable}_dynamic ${MAIN_C}
                                          ${PROJECT_BINARY_DIR}/${executable}_app_data.c
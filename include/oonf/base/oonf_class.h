@@ -53,6 +53,15 @@
 /*! subsystem identifier */
 #define OONF_CLASS_SUBSYSTEM "class"
 
+/*! minimal size of a slab, objects of a class are carved out of slabs */
+#define OONF_CLASS_SLAB_MIN_SIZE 4096
+
+/*! maximum size of a slab, larger objects are allocated one by one */
+#define OONF_CLASS_SLAB_MAX_SIZE 65536
+
+/*! minimal number of objects within a slab */
+#define OONF_CLASS_SLAB_MIN_OBJECTS 8
+
 /**
  * Events triggered for memory class members
  */
@@ -107,9 +116,21 @@ struct oonf_class {
   /*! List node for classes */
   struct avl_node _node;
 
-  /*! List head for recyclable blocks */
+  /*! List head for recyclable blocks, only used without slabs */
   struct list_entity _free_list;
 
+  /*! List of slabs with free and used objects */
+  struct list_entity _partial_slabs;
+
+  /*! List of slabs without used objects */
+  struct list_entity _empty_slabs;
+
+  /*! size of a slab in bytes, 0 if objects are allocated one by one */
+  size_t _slab_size;
+
+  /*! number of objects within a slab */
+  uint32_t _slab_capacity;
+
   /*! extensions of this class */
   struct list_entity _extensions;
 
@@ -124,6 +145,18 @@ struct oonf_class {
 
   /*! Stats, recycled memory blocks */
   uint32_t _recycled;
+
+  /*! Stats, number of slabs of class */
+  uint32_t _slab_count;
+
+  /*! Stats, number of slabs without used objects */
+  uint32_t _slab_empty;
+
+  /*! Stats, total number of slabs allocated */
+  uint32_t _slab_allocated;
+
+  /*! Stats, total number of slabs returned to the system */
+  uint32_t _slab_released;
 };
 
 /**
@@ -164,6 +197,16 @@ struct oonf_class_extension {
    */
   void (*cb_remove)(void *ptr);
 
+  /**
+   * Callback to notify about any event of a class object. It is called
+   * after the event specific callback and gets the extension itself,
+   * which allows listeners that are created at runtime.
+   * @param ext this class extension
+   * @param ptr pointer to object
+   * @param evt type of event
+   */
+  void (*cb_event)(struct oonf_class_extension *ext, void *ptr, enum oonf_class_event evt);
+
   /*! node for hooking the consumer into the provider */
   struct list_entity _node;
 };
@@ -219,6 +262,51 @@ oonf_class_get_recycled(struct oonf_class *ci) {
   return ci->_recycled;
 }
 
+/**
+ * @param ci pointer to class
+ * @return size of a slab in bytes, 0 if class does not use slabs
+ */
+static INLINE size_t
+oonf_class_get_slab_size(struct oonf_class *ci) {
+  return ci->_slab_size;
+}
+
+/**
+ * @param ci pointer to class
+ * @return number of slabs currently allocated
+ */
+static INLINE uint32_t
+oonf_class_get_slabs(struct oonf_class *ci) {
+  return ci->_slab_count;
+}
+
+/**
+ * @param ci pointer to class
+ * @return number of allocated slabs without used objects
+ */
+static INLINE uint32_t
+oonf_class_get_empty_slabs(struct oonf_class *ci) {
+  return ci->_slab_empty;
+}
+
+/**
+ * @param ci pointer to class
+ * @return total number of slab allocations during runtime
+ */
+static INLINE uint32_t
+oonf_class_get_slab_allocations(struct oonf_class *ci) {
+  return ci->_slab_allocated;
+}
+
+/**
+ * @param ci pointer to class
+ * @return total number of slabs returned to the system during runtime
+ */
+static INLINE uint32_t
+oonf_class_get_slab_releases(struct oonf_class *ci) {
+  return ci->_slab_released;
+}
+
 /**
  * @param ext extension data structure
  * @param ptr pointer to base block
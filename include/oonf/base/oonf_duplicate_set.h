@@ -46,7 +46,6 @@
 #ifndef OONF_DUPLICATE_SET_H_
 #define OONF_DUPLICATE_SET_H_
 
-#include <oonf/libcommon/avl.h>
 #include <oonf/oonf.h>
 #include <oonf/libcommon/netaddr.h>
 #include <oonf/base/oonf_timer.h>
@@ -63,7 +62,13 @@ enum
    * number of consecutive 'too old' sequence numbers before
    * algorithm resets
    */
-  OONF_DUPSET_MAXIMUM_TOO_OLD = 8
+  OONF_DUPSET_MAXIMUM_TOO_OLD = 8,
+
+  /*! initial number of slots of the hash table, must be a power of 2 */
+  OONF_DUPSET_MINIMUM_SIZE = 16,
+
+  /*! interval in milliseconds between two sweeps for timed out entries */
+  OONF_DUPSET_SWEEP_INTERVAL = 5000,
 };
 
 /**
@@ -90,23 +95,6 @@ enum oonf_duplicate_result
   OONF_DUPSET_FIRST,
 };
 
-/**
- * session data for detecting duplicate sequence numbers for addresses
- */
-struct oonf_duplicate_set {
-  /*! tree of duplicate entries */
-  struct avl_tree _tree;
-
-  /*! mask for detecting overflow */
-  int64_t _mask;
-
-  /*! comparison limit to detect overflow */
-  int64_t _limit;
-
-  /*! offset to fix overflow */
-  int64_t _offset;
-};
-
 /**
  * Unique key for duplicate entry
  */
@@ -134,14 +122,40 @@ struct oonf_duplicate_entry {
   /*! number of too old consecutive sequence numbers without a newer one */
   uint16_t too_old_count;
 
-  /*! back pointer to duplicate set */
-  struct oonf_duplicate_set *set;
+  /*! true if this slot of the hash table is used */
+  bool _used;
 
-  /*! node for tree of duplicate set */
-  struct avl_node _node;
+  /*! precalculated hash of the key */
+  uint32_t _hash;
 
-  /*! timer for removing outdated duplicate set data */
-  struct oonf_timer_instance _vtime;
+  /*! absolute timestamp when this entry times out */
+  uint64_t _vtime;
+};
+
+/**
+ * session data for detecting duplicate sequence numbers for addresses
+ */
+struct oonf_duplicate_set {
+  /*! open addressing hash table (linear probing) of duplicate entries */
+  struct oonf_duplicate_entry *_table;
+
+  /*! number of slots of the hash table, always a power of 2 */
+  uint32_t _size;
+
+  /*! number of used slots, including timed out entries not swept yet */
+  uint32_t _count;
+
+  /*! timer for removing timed out entries in batches */
+  struct oonf_timer_instance _sweep;
+
+  /*! mask for detecting overflow */
+  int64_t _mask;
+
+  /*! comparison limit to detect overflow */
+  int64_t _limit;
+
+  /*! offset to fix overflow */
+  int64_t _offset;
 };
 
 /**
@@ -83,6 +83,7 @@ enum
 enum oonf_http_result
 {
   HTTP_200_OK = 200,
+  HTTP_304_NOT_MODIFIED = 304,
   HTTP_400_BAD_REQ = 400,
   HTTP_401_UNAUTHORIZED = 401,
   HTTP_403_FORBIDDEN = STREAM_REQUEST_FORBIDDEN,
@@ -94,6 +95,9 @@ enum oonf_http_result
 
   /*! special result to signal start of file transfer */
   HTTP_START_FILE_TRANSFER = 99999,
+
+  /*! special result to signal start of continous output */
+  HTTP_START_STREAM = 99998,
 };
 
 /**
@@ -137,11 +141,17 @@ struct oonf_http_session {
   /*! content type for answer, NULL means plain/html */
   const char *content_type;
 
+  /*! entity tag (without quotes) of the answer, NULL if the content has no version */
+  const char *etag;
+
   /*! file descriptor to file that is being downloaded in this session */
   int transfer_fd;
 
   /*! number of bytes already being downloaded */
   size_t transfer_length;
+
+  /*! stream session of the request, kept open for continous output */
+  struct oonf_stream_session *stream;
 };
 
 /**
@@ -47,6 +47,7 @@
 #define OONF_LAYER2_H_
 
 #include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/lpm_trie.h>
 #include <oonf/oonf.h>
 #include <oonf/libcore/oonf_subsystem.h>
 #include <oonf/base/os_interface.h>
@@ -580,6 +581,9 @@ struct oonf_layer2_neighbor_address {
 
   /*! node for tree of ip addresses */
   struct avl_node _neigh_node;
+
+  /*! node for global longest prefix match trie of neighbor addresses */
+  struct lpm_trie_node _lpm_node;
 };
 
 /**
@@ -79,6 +79,20 @@ struct oonf_packet_config {
   /*! length of input buffer */
   size_t input_buffer_length;
 
+  /**
+   * maximum number of datagrams received during a single socket event,
+   * 0 or 1 to receive only a single datagram per event
+   */
+  size_t input_batch;
+
+  /**
+   * maximum number of datagrams sent with a single system call,
+   * datagrams sent during a scheduler iteration after the first one
+   * are queued and flushed together at the end of the iteration.
+   * 0 or 1 to send every datagram directly.
+   */
+  size_t output_batch;
+
   /**
    * Callback triggered when an UDP packet has been received
    * @param psock packet socket
@@ -123,6 +137,18 @@ struct oonf_packet_socket {
   /*! name of socket */
   char socket_name[sizeof(struct netaddr_str) + 5];
 
+  /*! array of receive buffers for batched receiving, NULL if not used */
+  uint8_t *_rx_buffers;
+
+  /*! number of buffers in receive buffer array */
+  size_t _rx_batch;
+
+  /*! true while the receive callback handles datagrams of a batch */
+  bool _rx_busy;
+
+  /*! true if outgoing datagrams are queued until the end of the scheduler iteration */
+  bool _tx_coalesce;
+
   /*! true if errno==1 suppression is active */
   bool _errno1_suppression;
 
@@ -176,6 +202,12 @@ struct oonf_packet_managed_config {
 
   /*! IP dscp value for outgoing traffic */
   int32_t dscp;
+
+  /*! maximum number of incoming packets handled during one socket event */
+  int32_t rx_batch;
+
+  /*! maximum number of outgoing packets sent with one system call */
+  int32_t tx_batch;
 };
 
 /**
@@ -61,6 +61,9 @@
 /*! subsystem identifier */
 #define OONF_RFC5444_SUBSYSTEM "rfc5444"
 
+/*! name of the default IANA RFC5444 protocol */
+#define RFC5444_PROTOCOL "rfc5444_iana"
+
 /**
  * suggested priorities for RFC5444 readers
  */
@@ -71,9 +71,22 @@ struct oonf_socket_entry {
    */
   void (*process)(struct oonf_socket_entry *entry);
 
+  /**
+   * Callback to send data queued during the current scheduler iteration,
+   * called at the end of the iteration after oonf_socket_register_flush()
+   * @param entry socket entry
+   */
+  void (*flush)(struct oonf_socket_entry *entry);
+
   /*! usage counter, will be increased every times the socket receives data */
   uint32_t _stat_recv;
 
+  /*!
+   * usage counter, will be increased for every datagram received
+   * by a packet socket (multiple ones per receive event when batching)
+   */
+  uint32_t _stat_recv_packets;
+
   /*! usage counter, will be increased every times the socket sends data */
   uint32_t _stat_send;
 
@@ -85,12 +98,16 @@ struct oonf_socket_entry {
 
   /*! list of socket handlers */
   struct list_entity _node;
+
+  /*! hook into list of socket handlers waiting for a flush */
+  struct list_entity _flush_node;
 };
 
 EXPORT void oonf_socket_add(struct oonf_socket_entry *);
 EXPORT void oonf_socket_remove(struct oonf_socket_entry *);
 EXPORT void oonf_socket_set_read(struct oonf_socket_entry *entry, bool event_read);
 EXPORT void oonf_socket_set_write(struct oonf_socket_entry *entry, bool event_write);
+EXPORT void oonf_socket_register_flush(struct oonf_socket_entry *entry);
 EXPORT struct list_entity *oonf_socket_get_list(void);
 
 /**
@@ -120,6 +137,16 @@ oonf_socket_register_direct_send(struct oonf_socket_entry *entry) {
   entry->_stat_send++;
 }
 
+/**
+ * Registers a number of datagrams received during a single recv event
+ * @param entry socket entry
+ * @param count number of datagrams
+ */
+static INLINE void
+oonf_socket_register_recv_packets(struct oonf_socket_entry *entry, uint32_t count) {
+  entry->_stat_recv_packets += count;
+}
+
 /**
  * @param sock pointer to socket entry
  * @return number of recv events of socket
@@ -129,6 +156,15 @@ oonf_socket_get_recv(struct oonf_socket_entry *sock) {
   return sock->_stat_recv;
 }
 
+/**
+ * @param sock pointer to socket entry
+ * @return number of datagrams received by socket
+ */
+static INLINE uint32_t
+oonf_socket_get_recv_packets(struct oonf_socket_entry *sock) {
+  return sock->_stat_recv_packets;
+}
+
 /**
  * @param sock pointer to socket entry
  * @return number of send events of socket
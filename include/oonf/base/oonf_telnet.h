@@ -56,6 +56,12 @@
 /*! subsystem identifier */
 #define OONF_TELNET_SUBSYSTEM "telnet"
 
+/*! number of buffered output bytes a streaming command should generate per step */
+#define OONF_TELNET_STREAM_CHUNK 16384
+
+/*! maximum length of the version string of a command output */
+#define OONF_TELNET_VERSION_LENGTH 48
+
 /**
  * telnet session status
  */
@@ -132,6 +138,25 @@ struct oonf_telnet_data {
   /*! custom data for stop handler */
   void *stop_data[4];
 
+  /*! true if the current command may stream its output through the underrun_handler */
+  bool allow_streaming;
+
+  /**
+   * Callback triggered when the output buffer of a continuous command
+   * has been sent completely. Will be reset together with the stop_handler.
+   * @param data this telnet data object
+   * @return true if the command has generated all its output,
+   *   false if it should be called again
+   */
+  bool (*underrun_handler)(struct oonf_telnet_data *data);
+
+  /**
+   * version of the command output, the same version must result
+   * in the same output. Used as entity tag by the HTTP server,
+   * empty string if the output has no version.
+   */
+  char output_version[OONF_TELNET_VERSION_LENGTH];
+
   /*! custom timer for stop handler */
   struct oonf_timer_instance stop_timer;
 
@@ -203,6 +228,9 @@ EXPORT void oonf_telnet_stop(struct oonf_telnet_data *data, bool print_prompt);
 
 EXPORT enum oonf_telnet_result oonf_telnet_execute(
   const char *cmd, const char *para, struct autobuf *out, struct netaddr *remote);
+EXPORT enum oonf_telnet_result oonf_telnet_execute_continous(
+  const char *cmd, const char *para, struct oonf_telnet_session *session);
+EXPORT void oonf_telnet_cleanup_session(struct oonf_telnet_session *session);
 
 /**
  * Add a cleanup handler to a telnet session
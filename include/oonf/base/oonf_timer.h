@@ -49,6 +49,7 @@
 #include <oonf/libcommon/avl.h>
 #include <oonf/oonf.h>
 #include <oonf/libcommon/list.h>
+#include <oonf/libcommon/timing_wheel.h>
 
 #include <oonf/base/oonf_clock.h>
 
@@ -103,7 +104,10 @@ struct oonf_timer_class {
  * A single timer instance of a timer class
  */
 struct oonf_timer_instance {
-  /*! node of timer class tree of instances */
+  /*! node of timing wheel of running timers (timing wheel backend) */
+  struct timing_wheel_node _wheel_node;
+
+  /*! node of tree of running timers (AVL backend) */
   struct avl_node _node;
 
   /*! backpointer to timer class */
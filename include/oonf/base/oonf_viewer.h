@@ -78,6 +78,24 @@
  */
 #define OONF_VIEWER_DATA_RAW_FORMAT "dataraw"
 
+/**
+ * viewer should output the current table and all later changes
+ * of the table as newline delimited JSON
+ */
+#define OONF_VIEWER_SUBSCRIBE_FORMAT "subscribe"
+
+/**
+ * viewer should output the current table and all later changes
+ * of the table as newline delimited JSON with raw numbers
+ */
+#define OONF_VIEWER_SUBSCRIBE_RAW_FORMAT "subscriberaw"
+
+enum
+{
+  /*! maximum number of unsent bytes of a subscriber before changes are dropped */
+  OONF_VIEWER_SUBSCRIPTION_BACKLOG = 65536,
+};
+
 /**
  * This struct defines a template engine command that can output both
  * table and JSON.
@@ -117,6 +135,21 @@ struct oonf_viewer_template {
    */
   int (*cb_function)(struct oonf_viewer_template *);
 
+  /*! name of the class whose objects are the rows of the output, NULL if it cannot be subscribed */
+  const char *class_name;
+
+  /**
+   * Callback triggered to generate the output of a single class object,
+   * necessary if class_name is set
+   * @param this viewer template
+   * @param ptr pointer to class object
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*cb_object)(struct oonf_viewer_template *, void *ptr);
+
+  /*! internal variable with name of the event of the output, NULL for normal output */
+  const char *_event;
+
   /*! internal variable for template engine storage array */
   struct abuf_template_storage *_storage;
 
@@ -135,6 +168,8 @@ EXPORT int oonf_viewer_call_subcommands(struct autobuf *out, struct abuf_templat
   struct oonf_viewer_template *templates, size_t count);
 EXPORT enum oonf_telnet_result oonf_viewer_telnet_handler(struct autobuf *out, struct abuf_template_storage *storage,
   const char *cmd, const char *param, struct oonf_viewer_template *templates, size_t count);
+EXPORT enum oonf_telnet_result oonf_viewer_telnet_session_handler(struct oonf_telnet_data *con,
+  struct abuf_template_storage *storage, const char *cmd, struct oonf_viewer_template *templates, size_t count);
 EXPORT enum oonf_telnet_result oonf_viewer_telnet_help(
   struct autobuf *out, const char *cmd, const char *parameter, struct oonf_viewer_template *template, size_t count);
 
@@ -60,10 +60,30 @@
 /*! subsystem identifier */
 #define OONF_OS_FD_SUBSYSTEM "os_fd"
 
+/*! maximum number of datagrams handled by a single batched socket call */
+#define OS_FD_MAX_BATCH 64
+
 /* pre-definition of structs */
 struct os_fd;
 struct os_fd_select;
 
+/**
+ * Buffer for a single datagram of a batched socket call
+ */
+struct os_fd_datagram {
+  /*! pointer to datagram buffer */
+  void *buf;
+
+  /*! length of datagram buffer */
+  size_t buflen;
+
+  /*! source of received datagram or destination of outgoing one */
+  union netaddr_socket remote;
+
+  /*! length of received or outgoing datagram */
+  size_t length;
+};
+
 /* pre-declare inlines */
 static INLINE int os_fd_init(struct os_fd *, int fd);
 static INLINE int os_fd_copy(struct os_fd *dst, struct os_fd *from);
@@ -95,6 +115,10 @@ static INLINE ssize_t os_fd_sendto(
   struct os_fd *, const void *buf, size_t length, const union netaddr_socket *dst, bool dont_route);
 static INLINE ssize_t os_fd_recvfrom(
   struct os_fd *, void *buf, size_t length, union netaddr_socket *source, const struct os_interface *);
+static INLINE int os_fd_recvfrom_batch(
+  struct os_fd *, struct os_fd_datagram *dgrams, size_t count, const struct os_interface *);
+static INLINE int os_fd_sendto_batch(
+  struct os_fd *, const struct os_fd_datagram *dgrams, size_t count, bool dont_route, bool gso);
 static INLINE const char *os_fd_get_loopback_name(void);
 static INLINE ssize_t os_fd_sendfile(struct os_fd *, struct os_fd *, size_t offset, size_t count);
 
@@ -97,6 +97,9 @@ struct os_fd_select {
 EXPORT int os_fd_linux_event_wait(struct os_fd_select *);
 EXPORT int os_fd_linux_event_socket_modify(struct os_fd_select *sel, struct os_fd *sock);
 EXPORT uint8_t *os_fd_linux_skip_rawsocket_prefix(uint8_t *ptr, ssize_t *len, int af_type);
+EXPORT int os_fd_linux_recvfrom_batch(struct os_fd *sockfd, struct os_fd_datagram *dgrams, size_t count);
+EXPORT int os_fd_linux_sendto_batch(
+  struct os_fd *sockfd, const struct os_fd_datagram *dgrams, size_t count, bool dont_route, bool gso);
 
 /**
  * Redirect to linux specific event wait call
@@ -529,6 +532,39 @@ os_fd_recvfrom(struct os_fd *sockfd, void *buf, size_t length, union netaddr_soc
   }
 }
 
+/**
+ * Receive multiple datagrams from an UDP socket with a single
+ * system call.
+ * @param sockfd filedescriptor of UDP socket
+ * @param dgrams array of datagram buffers
+ * @param count number of datagram buffers
+ * @param interf limit received data to certain interface
+ *   (only used if socket cannot be bound to interface)
+ * @return number of received datagrams, -1 if an error happened
+ */
+static INLINE int
+os_fd_recvfrom_batch(struct os_fd *sockfd, struct os_fd_datagram *dgrams, size_t count,
+  const struct os_interface *interf __attribute__((unused))) {
+  return os_fd_linux_recvfrom_batch(sockfd, dgrams, count);
+}
+
+/**
+ * Send multiple datagrams through an UDP socket with a single
+ * system call.
+ * @param sockfd filedescriptor of UDP socket
+ * @param dgrams array of outgoing datagrams
+ * @param count number of datagrams
+ * @param dont_route true to suppress routing of data
+ * @param gso true to allow UDP segmentation offload for consecutive
+ *   datagrams to the same destination
+ * @return number of sent datagrams, -1 if an error happened
+ */
+static INLINE int
+os_fd_sendto_batch(
+  struct os_fd *sockfd, const struct os_fd_datagram *dgrams, size_t count, bool dont_route, bool gso) {
+  return os_fd_linux_sendto_batch(sockfd, dgrams, count, dont_route, gso);
+}
+
 /**
  * Binds a socket to a certain interface
  * @param sock filedescriptor of socket
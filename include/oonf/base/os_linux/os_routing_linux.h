@@ -49,6 +49,7 @@
 #include <oonf/libcommon/avl.h>
 #include <oonf/oonf.h>
 #include <oonf/libcommon/list.h>
+#include <oonf/base/os_linux/os_system_linux.h>
 
 /**
  * linux specifc data for changing a kernel route
@@ -59,6 +60,18 @@ struct os_route_internal {
 
   /*! netlink sequence number of command sent to the kernel */
   uint32_t nl_seq;
+
+  /*! hook into tree of route changes of the current transaction */
+  struct avl_node _tx_node;
+
+  /*! hook into ordered list of pending or superseded route changes */
+  struct list_entity _tx_list_node;
+
+  /*! true if the pending change sets the route, false if it removes it */
+  bool _tx_set;
+
+  /*! true if the pending removal should also remove similar routes */
+  bool _tx_del_similar;
 };
 
 /**
@@ -69,6 +82,14 @@ struct os_route_listener_internal {
   struct list_entity _node;
 };
 
+/**
+ * linux specific data for subscribing to the kernel route mirror
+ */
+struct os_route_mirror_internal {
+  /*! hook into list of mirror subscribers */
+  struct list_entity _node;
+};
+
 #include <oonf/base/os_generic/os_routing_generic_init_half_route_key.h>
 #include <oonf/base/os_generic/os_routing_generic_rt_to_string.h>
 
@@ -78,13 +99,23 @@ EXPORT int os_routing_linux_query(struct os_route *);
 EXPORT void os_routing_linux_interrupt(struct os_route *);
 EXPORT bool os_routing_linux_is_in_progress(struct os_route *);
 
+EXPORT void os_routing_linux_transaction_begin(void);
+EXPORT void os_routing_linux_transaction_commit(void);
+
 EXPORT void os_routing_linux_listener_add(struct os_route_listener *);
 EXPORT void os_routing_linux_listener_remove(struct os_route_listener *);
 
+EXPORT void os_routing_linux_mirror_add(struct os_route_mirror_subscriber *);
+EXPORT void os_routing_linux_mirror_remove(struct os_route_mirror_subscriber *);
+EXPORT void os_routing_linux_mirror_replay(struct os_route_mirror_subscriber *);
+EXPORT size_t os_routing_linux_mirror_get_size(void);
+
 EXPORT const char *os_routing_linux_to_string(struct os_route_str *buf, const struct os_route_parameter *route_param);
 
 EXPORT void os_routing_linux_init_wildcard_route(struct os_route *);
 
+EXPORT const struct os_system_netlink_statistics *os_routing_linux_get_statistics(void);
+
 /**
  * Check if kernel supports source-specific routing
  * @param af_family address family
@@ -140,6 +171,25 @@ os_routing_is_in_progress(struct os_route *route) {
   return os_routing_linux_is_in_progress(route);
 }
 
+/**
+ * Start a route transaction. Until the transaction is committed all
+ * route changes are collected and changes for the same kernel route
+ * are collapsed into one. Transactions can be nested.
+ */
+static INLINE void
+os_routing_transaction_begin(void) {
+  os_routing_linux_transaction_begin();
+}
+
+/**
+ * Commit a route transaction and send all collected route changes
+ * to the kernel in a single burst.
+ */
+static INLINE void
+os_routing_transaction_commit(void) {
+  os_routing_linux_transaction_commit();
+}
+
 /**
  * Add routing change listener
  * @param listener routing change listener
@@ -158,6 +208,46 @@ os_routing_listener_remove(struct os_route_listener *listener) {
   os_routing_linux_listener_remove(listener);
 }
 
+/**
+ * Subscribe to the kernel route mirror. The first subscriber seeds the
+ * mirror with a dump of the kernel routing tables, later subscribers
+ * get all matching routes of the mirror immediately. Calling this for
+ * a subscriber that is already registered reports all matching routes again.
+ * @param subscriber route mirror subscriber
+ */
+static INLINE void
+os_routing_mirror_add(struct os_route_mirror_subscriber *subscriber) {
+  os_routing_linux_mirror_add(subscriber);
+}
+
+/**
+ * Unsubscribe from the kernel route mirror. The mirror is cleared
+ * when the last subscriber is removed.
+ * @param subscriber route mirror subscriber
+ */
+static INLINE void
+os_routing_mirror_remove(struct os_route_mirror_subscriber *subscriber) {
+  os_routing_linux_mirror_remove(subscriber);
+}
+
+/**
+ * Report all mirrored routes matching the filter of a subscriber
+ * without querying the kernel.
+ * @param subscriber route mirror subscriber
+ */
+static INLINE void
+os_routing_mirror_replay(struct os_route_mirror_subscriber *subscriber) {
+  os_routing_linux_mirror_replay(subscriber);
+}
+
+/**
+ * @return number of kernel routes in the route mirror
+ */
+static INLINE size_t
+os_routing_mirror_get_size(void) {
+  return os_routing_linux_mirror_get_size();
+}
+
 /**
  * Initializes a route with default values. Will zero all
  * other fields in the struct.
@@ -168,6 +258,14 @@ os_routing_init_wildcard_route(struct os_route *route) {
   return os_routing_linux_init_wildcard_route(route);
 }
 
+/**
+ * @return statistics of the netlink socket used to program routes
+ */
+static INLINE const struct os_system_netlink_statistics *
+os_routing_get_statistics(void) {
+  return os_routing_linux_get_statistics();
+}
+
 /**
  * Print OS route to string buffer
  * @param buf pointer to string buffer
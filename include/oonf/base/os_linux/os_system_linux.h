@@ -57,6 +57,12 @@
 /*! default timeout for netlink messages */
 #define OS_SYSTEM_NETLINK_TIMEOUT 1000
 
+/*! default maximum number of netlink messages in transit to the kernel */
+#define OS_SYSTEM_NETLINK_WINDOW_MESSAGES 256
+
+/*! default maximum number of netlink bytes in transit to the kernel */
+#define OS_SYSTEM_NETLINK_WINDOW_BYTES 65536
+
 /**
  * A buffer for transmitting netlink commands to the operation system
  */
@@ -69,6 +75,41 @@ struct os_system_netlink_buffer {
 
   /*! total number of messages in buffer */
   uint32_t messages;
+
+  /*! number of messages of this buffer still waiting for kernel feedback */
+  uint32_t _pending;
+
+  /*! sequence number of first message in buffer */
+  uint32_t _first_seq;
+
+  /*! sequence number of last message in buffer */
+  uint32_t _last_seq;
+};
+
+/**
+ * Statistics of a netlink handler
+ */
+struct os_system_netlink_statistics {
+  /*! number of buffers sent to the kernel */
+  uint64_t buffers_sent;
+
+  /*! number of messages sent to the kernel */
+  uint64_t messages_sent;
+
+  /*! number of bytes sent to the kernel */
+  uint64_t bytes_sent;
+
+  /*! number of messages the kernel processed successfully */
+  uint64_t messages_done;
+
+  /*! number of messages that failed */
+  uint64_t messages_failed;
+
+  /*! number of feedback timeouts */
+  uint64_t timeouts;
+
+  /*! highest number of messages that were in transit at the same time */
+  uint32_t max_in_transit;
 };
 
 /**
@@ -102,6 +143,15 @@ struct os_system_netlink {
   /*! number of messages in transit to the kernel */
   int msg_in_transit;
 
+  /*! number of bytes in transit to the kernel */
+  uint32_t bytes_in_transit;
+
+  /*! list of sent buffers still waiting for kernel feedback */
+  struct list_entity _in_transit;
+
+  /*! netlink statistics */
+  struct os_system_netlink_statistics stats;
+
   /**
    * Callback to handle incoming message from the kernel
    * @param hdr netlink message header
@@ -136,6 +186,7 @@ EXPORT bool os_system_linux_is_minimal_kernel(int v1, int v2, int v3);
 EXPORT int os_system_linux_netlink_add(struct os_system_netlink *, int protocol);
 EXPORT void os_system_linux_netlink_remove(struct os_system_netlink *);
 EXPORT int os_system_linux_netlink_send(struct os_system_netlink *fd, struct nlmsghdr *nl_hdr);
+EXPORT void os_system_linux_netlink_flush(struct os_system_netlink *nl);
 EXPORT int os_system_linux_netlink_add_mc(struct os_system_netlink *, const uint32_t *groups, size_t groupcount);
 EXPORT int os_system_linux_netlink_drop_mc(struct os_system_netlink *, const int *groups, size_t groupcount);
 
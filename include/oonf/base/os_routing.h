@@ -63,6 +63,7 @@
 
 struct os_route;
 struct os_route_listener;
+struct os_route_mirror_subscriber;
 struct os_route_str;
 
 /* make sure default values for routing are there */
@@ -238,20 +239,54 @@ struct os_route_listener {
   void (*cb_get)(const struct os_route *route, bool set);
 };
 
+/**
+ * Subscriber of the kernel route mirror. The mirror keeps a copy of
+ * the kernel routing tables as long as it has subscribers and reports
+ * the changes of matching routes.
+ */
+struct os_route_mirror_subscriber {
+  /*! only routes matching this filter are reported, initialize with os_routing_init_wildcard_route() */
+  struct os_route filter;
+
+  /**
+   * Callback triggered when a matching route changes in the kernel
+   * @param subscriber this subscriber
+   * @param route changed route
+   * @param set true if route has been set/changed,
+   *   false if it has been removed
+   */
+  void (*cb_get)(struct os_route_mirror_subscriber *subscriber, const struct os_route *route, bool set);
+
+  /*! true to get repeated kernel announcements of unchanged routes too, e.g. to refresh a timeout */
+  bool want_refresh;
+
+  /*! hook into the kernel route mirror */
+  struct os_route_mirror_internal _internal;
+};
+
 /* prototypes for all os_routing functions */
 static INLINE bool os_routing_supports_source_specific(int af_family);
 static INLINE int os_routing_set(struct os_route *, bool set, bool del_similar);
 static INLINE int os_routing_query(struct os_route *);
 static INLINE void os_routing_interrupt(struct os_route *);
 static INLINE bool os_routing_is_in_progress(struct os_route *);
+static INLINE void os_routing_transaction_begin(void);
+static INLINE void os_routing_transaction_commit(void);
 
 static INLINE void os_routing_listener_add(struct os_route_listener *);
 static INLINE void os_routing_listener_remove(struct os_route_listener *);
 
+static INLINE void os_routing_mirror_add(struct os_route_mirror_subscriber *);
+static INLINE void os_routing_mirror_remove(struct os_route_mirror_subscriber *);
+static INLINE void os_routing_mirror_replay(struct os_route_mirror_subscriber *);
+static INLINE size_t os_routing_mirror_get_size(void);
+
 static INLINE const char *os_routing_to_string(struct os_route_str *buf, const struct os_route_parameter *route_param);
 
 static INLINE void os_routing_init_wildcard_route(struct os_route *);
 
+static INLINE const struct os_system_netlink_statistics *os_routing_get_statistics(void);
+
 static INLINE void os_routing_init_half_os_route_key(
   struct netaddr *any, struct netaddr *specific, const struct netaddr *source);
 
@@ -0,0 +1,154 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef RFC5444_SIGNATURE_H_
+#define RFC5444_SIGNATURE_H_
+
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/oonf.h>
+#include <oonf/crypto/rfc7182_provider/rfc7182_provider.h>
+#include <oonf/librfc5444/rfc5444_writer.h>
+
+/*! subsystem identifier */
+#define OONF_RFC5444_SIG_SUBSYSTEM "rfc5444_sig"
+
+/**
+ * Result of the key-id check of an incoming signature
+ */
+enum rfc5444_sigid_check
+{
+  /*! key-id is okay, check signature */
+  RFC5444_SIGID_OKAY,
+
+  /*! ignore this signature TLV */
+  RFC5444_SIGID_IGNORE,
+
+  /*! drop the message/packet */
+  RFC5444_SIGID_DROP,
+};
+
+/**
+ * Key of a signature, combination of hash and crypto function
+ */
+struct rfc5444_signature_key {
+  /*! RFC7182 hash function */
+  uint8_t hash_function;
+
+  /*! RFC7182 crypto function */
+  uint8_t crypt_function;
+};
+
+/**
+ * Definition of a message or packet signature
+ */
+struct rfc5444_signature {
+  /*! hash and crypto function of signature */
+  struct rfc5444_signature_key key;
+
+  /*! hash definition, NULL if not available */
+  struct rfc7182_hash *hash;
+
+  /*! crypto definition, NULL if not available */
+  struct rfc7182_crypt *crypt;
+
+  /*! true if message/packet should be dropped without valid signature */
+  bool drop_if_invalid;
+
+  /*! true if the source IP is part of the signature */
+  bool source_specific;
+
+  /**
+   * Checks if signature applies to a message/packet
+   * @param sig this signature
+   * @param msg_type message type, RFC5444_WRITER_PKT_POSTPROCESSOR for packets
+   * @return true if signature applies
+   */
+  bool (*is_matching_signature)(struct rfc5444_signature *sig, int msg_type);
+
+  /**
+   * Checks the key-id of an incoming signature before the signature
+   * itself is checked.
+   * @param sig this signature
+   * @param id pointer to key-id
+   * @param len length of key-id
+   * @return okay, ignore or drop
+   */
+  enum rfc5444_sigid_check (*verify_id)(struct rfc5444_signature *sig, const void *id, size_t len);
+
+  /**
+   * @param sig this signature
+   * @param length pointer to length of key material, will be set by callback
+   * @return pointer to key material
+   */
+  const void *(*getCryptoKey)(struct rfc5444_signature *sig, size_t *length);
+
+  /**
+   * @param sig this signature
+   * @param length pointer to length of key-id, will be set by callback
+   * @return pointer to key-id
+   */
+  const void *(*getKeyId)(struct rfc5444_signature *sig, size_t *length);
+
+  /*! source IP of the message/packet currently checked */
+  const struct netaddr *source;
+
+  /*! true if the signature of the current message/packet is valid */
+  bool verified;
+
+  /*! true if the current message/packet must have a valid signature */
+  bool _must_be_verified;
+
+  /*! post-processor to add outgoing signatures */
+  struct rfc5444_writer_postprocessor _postprocessor;
+
+  /*! node for tree of signatures */
+  struct avl_node _node;
+};
+
+EXPORT void rfc5444_sig_add(struct rfc5444_signature *sig);
+EXPORT void rfc5444_sig_remove(struct rfc5444_signature *sig);
+
+#endif /* RFC5444_SIGNATURE_H_ */
@@ -0,0 +1,112 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef WORKER_POOL_H_
+#define WORKER_POOL_H_
+
+#include <pthread.h>
+
+#include <oonf/oonf.h>
+
+/**
+ * Single unit of work for a worker pool. Embed it into a larger
+ * struct and use container_of() in the callback to get the job data.
+ */
+struct worker_job {
+  /**
+   * Callback to execute the job, called from a worker thread.
+   * It must not touch any state shared with other jobs of the same
+   * batch or with the main loop (this includes the logging system).
+   * @param job this job
+   */
+  void (*run)(struct worker_job *job);
+};
+
+/**
+ * Fixed set of threads executing batches of independent jobs.
+ * The thread calling worker_pool_run() takes part in the batch
+ * and returns when all jobs have been finished, so the results
+ * can be consumed in the order of the job array.
+ */
+struct worker_pool {
+  /*! number of threads executing a batch, including the caller */
+  size_t threads;
+
+  /*! array of additional worker threads (threads - 1 elements) */
+  pthread_t *_workers;
+
+  /*! number of additional worker threads that have been started */
+  size_t _started;
+
+  /*! mutex protecting the batch state */
+  pthread_mutex_t _mutex;
+
+  /*! signals the workers that a batch is available or shutdown */
+  pthread_cond_t _work;
+
+  /*! signals the caller that the last job has been finished */
+  pthread_cond_t _done;
+
+  /*! jobs of the current batch */
+  struct worker_job **_jobs;
+
+  /*! number of jobs in the current batch */
+  size_t _job_count;
+
+  /*! index of the next job to be executed */
+  size_t _next_job;
+
+  /*! number of finished jobs of the current batch */
+  size_t _finished;
+
+  /*! true if the worker threads should terminate */
+  bool _shutdown;
+};
+
+EXPORT int worker_pool_init(struct worker_pool *, size_t threads);
+EXPORT void worker_pool_remove(struct worker_pool *);
+EXPORT void worker_pool_run(struct worker_pool *, struct worker_job **jobs, size_t count);
+
+#endif /* WORKER_POOL_H_ */
@@ -0,0 +1,205 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef RFC7182_PROVIDER_H_
+#define RFC7182_PROVIDER_H_
+
+#include <oonf/libcommon/avl.h>
+#include <oonf/oonf.h>
+
+/*! subsystem identifier */
+#define OONF_RFC7182_PROVIDER_SUBSYSTEM "rfc7182_provider"
+
+/*! class name for hash functions */
+#define OONF_RFC7182_HASH_CLASS "rfc7182_hash"
+
+/*! class name for crypto functions */
+#define OONF_RFC7182_CRYPTO_CLASS "rfc7182_crypto"
+
+/**
+ * Result of a signature validation. Validation might run in a
+ * worker thread, so it reports the reason of a failure instead
+ * of logging it.
+ */
+enum rfc7182_validation
+{
+  /*! signature matches */
+  RFC7182_VALIDATION_OKAY,
+
+  /*! local signature could not be generated */
+  RFC7182_VALIDATION_SIGN_FAILED,
+
+  /*! signature has the wrong length */
+  RFC7182_VALIDATION_WRONG_LENGTH,
+
+  /*! signature does not match */
+  RFC7182_VALIDATION_MISMATCH,
+};
+
+/**
+ * Definition of a RFC7182 hash function
+ */
+struct rfc7182_hash {
+  /*! RFC7182 hash type */
+  uint8_t type;
+
+  /*! length of hash in bytes, 0 if variable */
+  size_t hash_length;
+
+  /**
+   * Calculate hash of data
+   * @param hash this hash definition
+   * @param dst output buffer for hash
+   * @param dst_len pointer to length of output buffer,
+   *   will be set to hash length afterwards
+   * @param src unsigned original data
+   * @param src_len length of original data
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*hash)(struct rfc7182_hash *hash, void *dst, size_t *dst_len, const void *src, size_t src_len);
+
+  /*! node for tree of hash functions */
+  struct avl_node _node;
+};
+
+/**
+ * Definition of a RFC7182 crypto function
+ */
+struct rfc7182_crypt {
+  /*! RFC7182 crypto type */
+  uint8_t type;
+
+  /**
+   * Encrypt a hash value
+   * @param crypt this crypto definition
+   * @param dst output buffer for cryptographic signature
+   * @param dst_len pointer to length of output buffer,
+   *   will be set to signature length afterwards
+   * @param src hash value
+   * @param src_len length of hash value
+   * @param key key material for signature
+   * @param key_len length of key material
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*encrypt)(struct rfc7182_crypt *crypt, void *dst, size_t *dst_len, const void *src, size_t src_len,
+    const void *key, size_t key_len);
+
+  /**
+   * Generate a signature for data, default implementation
+   * combines 'hash' and 'encrypt'. Might be called from a worker
+   * thread through the default 'validate' callback.
+   * @param crypt this crypto definition
+   * @param hash hash definition
+   * @param dst output buffer for signature
+   * @param dst_len pointer to length of output buffer,
+   *   will be set to signature length afterwards
+   * @param src unsigned original data
+   * @param src_len length of original data
+   * @param key key material for signature
+   * @param key_len length of key material
+   * @return -1 if an error happened, 0 otherwise
+   */
+  int (*sign)(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, void *dst, size_t *dst_len, const void *src,
+    size_t src_len, const void *key, size_t key_len);
+
+  /**
+   * Check a signature, default implementation generates a local
+   * signature with 'sign' and compares both. Might be called from
+   * a worker thread, so it must not log or touch shared state.
+   * @param crypt this crypto definition
+   * @param hash hash definition
+   * @param encrypted received signature
+   * @param encrypted_length length of received signature
+   * @param src unsigned original data
+   * @param src_len length of original data
+   * @param key key material for signature
+   * @param key_len length of key material
+   * @return result of validation
+   */
+  enum rfc7182_validation (*validate)(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, const void *encrypted,
+    size_t encrypted_length, const void *src, size_t src_len, const void *key, size_t key_len);
+
+  /**
+   * @param crypt this crypto definition
+   * @param hash hash definition
+   * @return maximum length of a signature
+   */
+  size_t (*getSignSize)(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash);
+
+  /*! node for tree of crypto functions */
+  struct avl_node _node;
+};
+
+EXPORT void rfc7182_add_hash(struct rfc7182_hash *hash);
+EXPORT void rfc7182_remove_hash(struct rfc7182_hash *hash);
+EXPORT struct avl_tree *rfc7182_get_hash_tree(void);
+
+EXPORT void rfc7182_add_crypt(struct rfc7182_crypt *crypt);
+EXPORT void rfc7182_remove_crypt(struct rfc7182_crypt *crypt);
+EXPORT struct avl_tree *rfc7182_get_crypt_tree(void);
+
+EXPORT const char *rfc7182_get_validation_string(enum rfc7182_validation);
+
+/**
+ * @param type RFC7182 hash type
+ * @return hash definition, NULL if not registered
+ */
+static INLINE struct rfc7182_hash *
+rfc7182_get_hash(uint8_t type) {
+  struct rfc7182_hash *hash;
+  return avl_find_element(rfc7182_get_hash_tree(), &type, hash, _node);
+}
+
+/**
+ * @param type RFC7182 crypto type
+ * @return crypto definition, NULL if not registered
+ */
+static INLINE struct rfc7182_crypt *
+rfc7182_get_crypt(uint8_t type) {
+  struct rfc7182_crypt *crypt;
+  return avl_find_element(rfc7182_get_crypt_tree(), &type, crypt, _node);
+}
+
+#endif /* RFC7182_PROVIDER_H_ */
@@ -97,6 +97,21 @@ enum dlep_parser_error
   DLEP_NEW_PARSER_INTERNAL_ERROR = -9,
 };
 
+/**
+ * Constants of the direct-indexed table of allowed TLVs
+ */
+enum
+{
+  /*! number of bits of a TLV id used as index into a table page */
+  DLEP_PARSER_TLV_PAGE_BITS = 8,
+
+  /*! number of TLV entries of a table page */
+  DLEP_PARSER_TLV_PAGE_SIZE = 1 << DLEP_PARSER_TLV_PAGE_BITS,
+
+  /*! number of pages necessary to cover the 16 bit TLV id space */
+  DLEP_PARSER_TLV_PAGE_COUNT = 1 << (16 - DLEP_PARSER_TLV_PAGE_BITS),
+};
+
 /**
  * Definition of a TLV that has been parsed by DLEP
  */
@@ -110,6 +125,9 @@ struct dlep_parser_tlv {
   /*! index of last session value for tlv, -1 if none */
   int32_t tlv_last;
 
+  /*! parser generation tlv_first/tlv_last belong to, outdated values mean 'none' */
+  uint32_t _generation;
+
   /*! minimal length of tlv */
   uint16_t length_min;
 
@@ -137,6 +155,15 @@ struct dlep_parser_value {
   uint16_t length;
 };
 
+/**
+ * Page of the direct-indexed TLV table, covering
+ * DLEP_PARSER_TLV_PAGE_SIZE consecutive TLV ids
+ */
+struct dlep_parser_tlv_page {
+  /*! allowed TLVs of this page, NULL if TLV is not allowed */
+  struct dlep_parser_tlv *tlvs[DLEP_PARSER_TLV_PAGE_SIZE];
+};
+
 /**
  * Session for the DLEP tlv parser
  */
@@ -144,6 +171,12 @@ struct dlep_session_parser {
   /*! tree of allowed TLVs for this session */
   struct avl_tree allowed_tlvs;
 
+  /*! table of allowed TLVs indexed by TLV id, pages are allocated on demand */
+  struct dlep_parser_tlv_page *tlv_table[DLEP_PARSER_TLV_PAGE_COUNT];
+
+  /*! generation of the last parsed signal */
+  uint32_t _generation;
+
   /*! array of TLV values */
   struct dlep_parser_value *values;
 
@@ -367,6 +400,13 @@ int dlep_session_generate_signal_status(struct dlep_session *session, int32_t si
   enum dlep_status status, const char *msg);
 struct dlep_parser_value *dlep_session_get_tlv_value(struct dlep_session *session, uint16_t tlvtype);
 
+int dlep_parser_init(struct dlep_session_parser *parser);
+void dlep_parser_cleanup(struct dlep_session_parser *parser);
+int dlep_parser_add_tlv(struct dlep_session_parser *parser, struct dlep_parser_tlv *tlv);
+void dlep_parser_remove_tlv(struct dlep_session_parser *parser, struct dlep_parser_tlv *tlv);
+enum dlep_parser_error dlep_parser_parse_tlvstream(
+  struct dlep_session_parser *parser, enum oonf_log_source log_source, const uint8_t *buffer, size_t length);
+
 struct dlep_local_neighbor *dlep_session_add_local_neighbor(struct dlep_session *session, const struct oonf_layer2_neigh_key *key);
 void dlep_session_remove_local_neighbor(struct dlep_session *session, struct dlep_local_neighbor *local);
 struct oonf_layer2_neigh *dlep_session_get_local_l2_neighbor(struct dlep_session *session, const struct oonf_layer2_neigh_key *key);
@@ -380,8 +420,20 @@ struct oonf_layer2_neigh *dlep_session_get_l2_from_neighbor(struct dlep_local_ne
  */
 static INLINE struct dlep_parser_tlv *
 dlep_parser_get_tlv(struct dlep_session_parser *parser, uint16_t tlvtype) {
-  struct dlep_parser_tlv *tlv;
-  return avl_find_element(&parser->allowed_tlvs, &tlvtype, tlv, _node);
+  struct dlep_parser_tlv_page *page;
+
+  page = parser->tlv_table[tlvtype >> DLEP_PARSER_TLV_PAGE_BITS];
+  return page ? page->tlvs[tlvtype & (DLEP_PARSER_TLV_PAGE_SIZE - 1)] : NULL;
+}
+
+/**
+ * @param parser dlep session parser
+ * @param tlv dlep session tlv
+ * @return true if the last parsed signal contained the TLV
+ */
+static INLINE bool
+dlep_parser_has_tlv_value(struct dlep_session_parser *parser, struct dlep_parser_tlv *tlv) {
+  return tlv->_generation == parser->_generation && tlv->tlv_first != -1;
 }
 
 /**
@@ -392,7 +444,7 @@ dlep_parser_get_tlv(struct dlep_session_parser *parser, uint16_t tlvtype) {
  */
 static INLINE struct dlep_parser_value *
 dlep_session_get_tlv_first_value(struct dlep_session *session, struct dlep_parser_tlv *tlv) {
-  if (tlv->tlv_first == -1) {
+  if (!dlep_parser_has_tlv_value(&session->parser, tlv)) {
     return NULL;
   }
   return &session->parser.values[tlv->tlv_first];
@@ -0,0 +1,147 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef HEAP_H_
+#define HEAP_H_
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/container_of.h>
+
+/**
+ * A node of an indexed binary heap. It must be contained in all
+ * larger structs that should be put into a heap. The node must be
+ * initialized with zero before it is added to a heap the first time.
+ */
+struct heap_node {
+  /*! key of the node, the node with the lowest key is the first one */
+  uint64_t key;
+
+  /*! insertion order of the node, breaks ties between equal keys */
+  uint64_t _seq;
+
+  /*! position of the node in the heap array plus one, 0 if not in a heap */
+  uint32_t _index;
+};
+
+/**
+ * Indexed binary min-heap. The heap only stores an array of pointers,
+ * each node remembers its position in the array, which allows
+ * removal and key updates of arbitrary nodes in O(log n).
+ * Nodes with equal keys leave the heap in the order they were
+ * inserted or got their current key (FIFO).
+ */
+struct heap {
+  /*! array of node pointers */
+  struct heap_node **_nodes;
+
+  /*! number of nodes in the heap */
+  uint32_t count;
+
+  /*! number of allocated node pointers */
+  uint32_t _size;
+
+  /*! insertion order for the next node with a new key */
+  uint64_t _next_seq;
+};
+
+EXPORT void heap_init(struct heap *);
+EXPORT void heap_free(struct heap *);
+EXPORT int heap_reserve(struct heap *, uint32_t size);
+EXPORT int heap_insert(struct heap *, struct heap_node *);
+EXPORT void heap_remove(struct heap *, struct heap_node *);
+EXPORT void heap_decrease_key(struct heap *, struct heap_node *, uint64_t key);
+EXPORT void heap_set_key(struct heap *, struct heap_node *, uint64_t key);
+EXPORT struct heap_node *heap_extract_min(struct heap *);
+
+/**
+ * @param heap pointer to heap
+ * @return true if the heap is empty, false otherwise
+ */
+static INLINE bool
+heap_is_empty(const struct heap *heap) {
+  return heap->count == 0;
+}
+
+/**
+ * @param node pointer to heap node
+ * @return true if node is currently in a heap, false otherwise
+ */
+static INLINE bool
+heap_is_node_added(const struct heap_node *node) {
+  return node->_index != 0;
+}
+
+/**
+ * @param heap pointer to heap
+ * @return pointer to the node with the lowest key, NULL if heap is empty
+ */
+static INLINE struct heap_node *
+heap_first(const struct heap *heap) {
+  return heap->count > 0 ? heap->_nodes[0] : NULL;
+}
+
+/**
+ * @param heap pointer to heap
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_member name of the heap_node element inside the
+ *    larger struct
+ * @return pointer to the element with the lowest key, heap must not be empty
+ */
+#define heap_first_element(heap, element, node_member) container_of((heap)->_nodes[0], typeof(*(element)), node_member)
+
+/**
+ * Remove the element with the lowest key from the heap
+ * @param heap pointer to heap
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_member name of the heap_node element inside the
+ *    larger struct
+ * @return pointer to the removed element, heap must not be empty
+ */
+#define heap_extract_min_element(heap, element, node_member)                                                           \
+  container_of(heap_extract_min(heap), typeof(*(element)), node_member)
+
+#endif /* HEAP_H_ */
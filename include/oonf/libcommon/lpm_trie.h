@@ -0,0 +1,155 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef LPM_TRIE_H_
+#define LPM_TRIE_H_
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/container_of.h>
+#include <oonf/libcommon/list.h>
+#include <oonf/libcommon/netaddr.h>
+
+/*! number of address families supported by a longest prefix match trie */
+#define LPM_TRIE_FAMILY_COUNT 4
+
+/**
+ * This element is a member of a longest prefix match trie. It must be
+ * contained in all larger structs that should be put into a trie.
+ */
+struct lpm_trie_node {
+  /*! pointer to key (address and prefix length) of the node */
+  const struct netaddr *key;
+
+  /*! hook into list of nodes with the same key */
+  struct list_entity _node;
+
+  /*! trie vertex storing the nodes key, NULL if not in a trie */
+  struct _lpm_trie_vertex *_vertex;
+};
+
+/**
+ * INTERNAL vertex of a path compressed binary (Patricia) trie.
+ * Each vertex represents a prefix, vertices without nodes
+ * are only used to branch between two subtries.
+ */
+struct _lpm_trie_vertex {
+  /*! prefix of the vertex, bits beyond the prefix length are ignored */
+  struct netaddr prefix;
+
+  /*! parent vertex, NULL for root vertex */
+  struct _lpm_trie_vertex *parent;
+
+  /*! subtries for the next bit after the prefix being 0 or 1 */
+  struct _lpm_trie_vertex *child[2];
+
+  /*! list of trie nodes with this prefix */
+  struct list_entity nodes;
+};
+
+/**
+ * Longest prefix match trie for network prefixes. The trie keeps
+ * a separate root for each supported address family (IPv4, IPv6,
+ * MAC48 and EUI64), lookups are O(prefix length).
+ */
+struct lpm_trie {
+  /*! root vertex for each address family */
+  struct _lpm_trie_vertex *_root[LPM_TRIE_FAMILY_COUNT];
+
+  /*! number of nodes in the trie */
+  uint32_t count;
+};
+
+EXPORT void lpm_trie_init(struct lpm_trie *);
+EXPORT void lpm_trie_free(struct lpm_trie *);
+EXPORT int lpm_trie_insert(struct lpm_trie *, struct lpm_trie_node *);
+EXPORT void lpm_trie_remove(struct lpm_trie *, struct lpm_trie_node *);
+EXPORT struct lpm_trie_node *lpm_trie_find(const struct lpm_trie *, const struct netaddr *key);
+EXPORT struct lpm_trie_node *lpm_trie_find_best(const struct lpm_trie *, const struct netaddr *addr);
+
+/**
+ * @param trie pointer to trie
+ * @return true if the trie is empty, false otherwise
+ */
+static INLINE bool
+lpm_trie_is_empty(const struct lpm_trie *trie) {
+  return trie->count == 0;
+}
+
+/**
+ * @param node pointer to trie node
+ * @return true if node is currently in a trie, false otherwise
+ */
+static INLINE bool
+lpm_trie_is_node_added(const struct lpm_trie_node *node) {
+  return node->_vertex != NULL;
+}
+
+/**
+ * Find the first element with exactly the key
+ * @param trie pointer to trie
+ * @param key pointer to key (address and prefix length)
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_member name of the lpm_trie_node element inside the
+ *    larger struct
+ * @return pointer to element, NULL if no element was found
+ */
+#define lpm_trie_find_element(trie, key, element, node_member)                                                         \
+  container_of_if_notnull(lpm_trie_find(trie, key), typeof(*(element)), node_member)
+
+/**
+ * Find the element with the longest prefix containing an address
+ * @param trie pointer to trie
+ * @param addr pointer to address (or prefix)
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_member name of the lpm_trie_node element inside the
+ *    larger struct
+ * @return pointer to element, NULL if no prefix contains the address
+ */
+#define lpm_trie_find_best_element(trie, addr, element, node_member)                                                   \
+  container_of_if_notnull(lpm_trie_find_best(trie, addr), typeof(*(element)), node_member)
+
+#endif /* LPM_TRIE_H_ */
@@ -69,6 +69,9 @@
 /*! text name for rejecting an address if no list matches */
 #define ACL_DEFAULT_REJECT "default_reject"
 
+/* internal lookup structure of a compiled ACL */
+struct _netaddr_acl_compiled;
+
 /**
  * represents an netaddr access control list with white/blacklist
  */
@@ -93,12 +96,19 @@ struct netaddr_acl {
 
   /*! result of the check if neither of the arrays have a match */
   bool accept_default;
+
+  /**
+   * prefix trie compiled from the accept and reject arrays,
+   * NULL if the arrays have to be checked linear
+   */
+  struct _netaddr_acl_compiled *_compiled;
 };
 
 EXPORT void netaddr_acl_add(struct netaddr_acl *);
 EXPORT int netaddr_acl_from_strarray(struct netaddr_acl *, const struct const_strarray *value);
 EXPORT void netaddr_acl_remove(struct netaddr_acl *);
 EXPORT int netaddr_acl_copy(struct netaddr_acl *to, const struct netaddr_acl *from);
+EXPORT int netaddr_acl_compile(struct netaddr_acl *);
 
 EXPORT bool netaddr_acl_check_accept(const struct netaddr_acl *, const struct netaddr *);
 EXPORT int netaddr_acl_handle_keywords(struct netaddr_acl *acl, const char *cmd);
@@ -0,0 +1,125 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef NETADDR_HASH_H_
+#define NETADDR_HASH_H_
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/container_of.h>
+#include <oonf/libcommon/netaddr.h>
+
+/*! number of buckets embedded into the hash table, must be a power of 2 */
+#define NETADDR_HASH_INITIAL_SIZE 8
+
+/**
+ * This element is a member of a netaddr hash index. It must be
+ * contained in all larger structs that should be put into an index.
+ */
+struct netaddr_hash_node {
+  /*! pointer to key of the node */
+  const struct netaddr *key;
+
+  /*! next node in the same bucket */
+  struct netaddr_hash_node *_next;
+
+  /*! precalculated hash of the key */
+  uint32_t _hash;
+};
+
+/**
+ * Intrusive hash index with separate chaining for netaddr keys. It is
+ * meant as a secondary index for point lookups next to an AVL tree,
+ * which is still used for ordered iteration. Keys must be unique.
+ */
+struct netaddr_hash {
+  /*! array of buckets, points to _initial_buckets until the first resize */
+  struct netaddr_hash_node **_buckets;
+
+  /*! number of buckets, always a power of 2 */
+  uint32_t _size;
+
+  /*! number of nodes in the index */
+  uint32_t count;
+
+  /*! number of lookups, shown by the nhdpinfo and olsrv2info 'hash' views */
+  uint64_t lookups;
+
+  /*! number of lookups which found a node */
+  uint64_t hits;
+
+  /*! buckets used before the index grows the first time */
+  struct netaddr_hash_node *_initial_buckets[NETADDR_HASH_INITIAL_SIZE];
+};
+
+EXPORT void netaddr_hash_init(struct netaddr_hash *);
+EXPORT void netaddr_hash_free(struct netaddr_hash *);
+EXPORT void netaddr_hash_insert(struct netaddr_hash *, struct netaddr_hash_node *);
+EXPORT void netaddr_hash_remove(struct netaddr_hash *, struct netaddr_hash_node *);
+EXPORT struct netaddr_hash_node *netaddr_hash_find(struct netaddr_hash *, const struct netaddr *key);
+EXPORT uint32_t netaddr_hash_calculate(const struct netaddr *);
+
+/**
+ * @param hash pointer to hash index
+ * @return true if the index is empty, false otherwise
+ */
+static INLINE bool
+netaddr_hash_is_empty(const struct netaddr_hash *hash) {
+  return hash->count == 0;
+}
+
+/**
+ * Find an element in a hash index
+ * @param hash pointer to hash index
+ * @param key pointer to key
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_member name of the netaddr_hash_node element inside the
+ *    larger struct
+ * @return pointer to element, NULL if no element was found
+ */
+#define netaddr_hash_find_element(hash, key, element, node_member)                                                     \
+  container_of_if_notnull(netaddr_hash_find(hash, key), typeof(*(element)), node_member)
+
+#endif /* NETADDR_HASH_H_ */
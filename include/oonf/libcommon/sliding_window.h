@@ -0,0 +1,133 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef SLIDING_WINDOW_H_
+#define SLIDING_WINDOW_H_
+
+#include <oonf/oonf.h>
+
+/**
+ * Ringbuffer of the last samples of a measurement with a running sum
+ * and optional order statistics. The current sample can be modified
+ * until the window is advanced to the next slot. The storage is
+ * provided by the user, so windows can be embedded into class
+ * extensions without extra allocations.
+ */
+struct sliding_window {
+  /*! ringbuffer of samples, size elements */
+  int64_t *_samples;
+
+  /*! samples in ascending order, NULL if no order statistics are necessary */
+  int64_t *_sorted;
+
+  /*! number of samples in the window */
+  size_t size;
+
+  /*! index of the current sample */
+  size_t _current;
+
+  /*! sum of all samples in the window */
+  int64_t sum;
+};
+
+EXPORT void sliding_window_init(struct sliding_window *, int64_t *samples, int64_t *sorted, size_t size);
+EXPORT void sliding_window_fill(struct sliding_window *, int64_t value);
+EXPORT void sliding_window_set(struct sliding_window *, int64_t value);
+EXPORT size_t sliding_window_count_le(const struct sliding_window *, int64_t value);
+
+/**
+ * @param window sliding window
+ * @return current sample of the window
+ */
+static INLINE int64_t
+sliding_window_get(const struct sliding_window *window) {
+  return window->_samples[window->_current];
+}
+
+/**
+ * Add a value to the current sample of the window
+ * @param window sliding window
+ * @param value value to add
+ */
+static INLINE void
+sliding_window_add(struct sliding_window *window, int64_t value) {
+  sliding_window_set(window, window->_samples[window->_current] + value);
+}
+
+/**
+ * Move the window forward by one sample. The new current sample
+ * keeps the value of the oldest sample until it is overwritten.
+ * @param window sliding window
+ */
+static INLINE void
+sliding_window_advance(struct sliding_window *window) {
+  window->_current++;
+  if (window->_current >= window->size) {
+    window->_current = 0;
+  }
+}
+
+/**
+ * @param window sliding window
+ * @return sum of all samples in the window
+ */
+static INLINE int64_t
+sliding_window_get_sum(const struct sliding_window *window) {
+  return window->sum;
+}
+
+/**
+ * Get a sample by its rank, window must have been initialized
+ * with order statistics
+ * @param window sliding window
+ * @param rank index of the sample in ascending order
+ * @return sample value
+ */
+static INLINE int64_t
+sliding_window_get_ranked(const struct sliding_window *window, size_t rank) {
+  return window->_sorted[rank];
+}
+
+#endif /* SLIDING_WINDOW_H_ */
@@ -0,0 +1,156 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#ifndef TIMING_WHEEL_H_
+#define TIMING_WHEEL_H_
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/container_of.h>
+#include <oonf/libcommon/list.h>
+
+/*! number of bits of the key handled by each level of the wheel */
+#define TIMING_WHEEL_LEVEL_BITS 6
+
+/*! number of slots of each level of the wheel */
+#define TIMING_WHEEL_SLOTS (1 << TIMING_WHEEL_LEVEL_BITS)
+
+/*! number of levels necessary to cover a 64 bit key */
+#define TIMING_WHEEL_LEVELS ((64 + TIMING_WHEEL_LEVEL_BITS - 1) / TIMING_WHEEL_LEVEL_BITS)
+
+/*! level value of a node in the expired list of the wheel */
+#define TIMING_WHEEL_EXPIRED 0xff
+
+/**
+ * A node of a hierarchical timing wheel. It must be contained in all
+ * larger structs that should be put into a wheel.
+ */
+struct timing_wheel_node {
+  /*! hook into slot list (or list of expired nodes) */
+  struct list_entity _node;
+
+  /*! absolute tick when the node expires */
+  uint64_t key;
+
+  /*! level of the wheel the node is stored in */
+  uint8_t _level;
+
+  /*! slot of the level the node is stored in */
+  uint8_t _slot;
+};
+
+/**
+ * Hierarchical timing wheel, an O(1) (insert and remove) priority queue
+ * for nodes with an absolute uint64_t tick as the key.
+ *
+ * Each level of the wheel handles TIMING_WHEEL_LEVEL_BITS of the key.
+ * A node is stored at the highest level in which its key differs from
+ * the current time of the wheel, nodes of higher levels are cascaded
+ * down when the wheel time reaches their slot.
+ */
+struct timing_wheel {
+  /*! current time (tick) of the wheel */
+  uint64_t now;
+
+  /*! number of nodes in the wheel, including the expired ones */
+  uint32_t count;
+
+  /*! list of expired nodes, sorted by key */
+  struct list_entity expired;
+
+  /*! bitmap of non-empty slots for each level */
+  uint64_t _used[TIMING_WHEEL_LEVELS];
+
+  /*! slot lists for each level */
+  struct list_entity _slots[TIMING_WHEEL_LEVELS][TIMING_WHEEL_SLOTS];
+};
+
+EXPORT void timing_wheel_init(struct timing_wheel *, uint64_t now);
+EXPORT void timing_wheel_insert(struct timing_wheel *, struct timing_wheel_node *);
+EXPORT void timing_wheel_remove(struct timing_wheel *, struct timing_wheel_node *);
+EXPORT void timing_wheel_advance(struct timing_wheel *, uint64_t now);
+EXPORT uint64_t timing_wheel_get_next(const struct timing_wheel *);
+EXPORT void timing_wheel_walk(
+  struct timing_wheel *, void (*cb)(struct timing_wheel_node *, void *data), void *data);
+
+/**
+ * @param wheel pointer to timing wheel
+ * @return true if the wheel is empty, false otherwise
+ */
+static INLINE bool
+timing_wheel_is_empty(const struct timing_wheel *wheel) {
+  return wheel->count == 0;
+}
+
+/**
+ * @param wheel pointer to timing wheel
+ * @return true if the wheel has expired nodes, false otherwise
+ */
+static INLINE bool
+timing_wheel_has_expired(const struct timing_wheel *wheel) {
+  return !list_is_empty(&wheel->expired);
+}
+
+/**
+ * @param node pointer to timing wheel node
+ * @return true if node is currently in a wheel, false otherwise
+ */
+static INLINE bool
+timing_wheel_is_node_added(const struct timing_wheel_node *node) {
+  return list_is_node_added(&node->_node);
+}
+
+/**
+ * @param wheel pointer to timing wheel
+ * @param element pointer to a node element
+ *    (don't need to be initialized)
+ * @param node_member name of the timing_wheel_node element inside the
+ *    larger struct
+ * @return pointer to the first expired element (with the lowest key),
+ *    wheel must have expired nodes
+ */
+#define timing_wheel_first_expired(wheel, element, node_member)                                                        \
+  container_of((wheel)->expired.next, typeof(*(element)), node_member._node)
+
+#endif /* TIMING_WHEEL_H_ */
@@ -366,6 +366,13 @@ struct oonf_log_handler_entry {
 
   /*! custom data for user */
   void *custom;
+
+  /**
+   * true if the handler can be called from the background thread
+   * of the asynchronous logging mode, false if it must be called
+   * synchronously from the event loop
+   */
+  bool threadsafe;
 };
 
 /**
@@ -411,6 +418,12 @@ EXPORT const char *oonf_log_get_walltime(struct oonf_walltime_str *);
 EXPORT void oonf_log(enum oonf_log_severity, enum oonf_log_source, const char *, int, const void *, size_t,
   const char *, ...) __attribute__((format(printf, 7, 8)));
 
+EXPORT void oonf_log_async_setup(size_t buffer_size);
+EXPORT int oonf_log_async_start(void);
+EXPORT void oonf_log_async_stop(void);
+EXPORT void oonf_log_async_flush(void);
+EXPORT uint64_t oonf_log_async_get_dropped(void);
+
 EXPORT void oonf_log_stderr(struct oonf_log_handler_entry *, struct oonf_log_parameters *);
 EXPORT void oonf_log_syslog(struct oonf_log_handler_entry *, struct oonf_log_parameters *);
 EXPORT void oonf_log_file(struct oonf_log_handler_entry *, struct oonf_log_parameters *);
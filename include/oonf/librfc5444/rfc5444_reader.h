@@ -62,13 +62,13 @@ enum rfc5444_reader_tlvblock_context_type
   RFC5444_CONTEXT_ADDRESS
 };
 
+/*! default size of a memory chunk of the reader arena */
+#define RFC5444_READER_ARENA_CHUNK 4096
+
 /**
  * This struct temporary holds the content of a decoded TLV.
  */
 struct rfc5444_reader_tlvblock_entry {
-  /*! tree of TLVs */
-  struct avl_node node;
-
   /*! tlv type */
   uint8_t type;
 
@@ -115,6 +115,55 @@ struct rfc5444_reader_tlvblock_entry {
   struct bitmap256 int_drop_tlv;
 };
 
+/**
+ * Parsed TLV block, an array of TLV entries sorted by
+ * type and type extension
+ */
+struct rfc5444_reader_tlvblock {
+  /*! array of TLV entries, NULL if block is empty */
+  struct rfc5444_reader_tlvblock_entry *entries;
+
+  /*! number of TLV entries in array */
+  uint16_t count;
+};
+
+/**
+ * Memory chunk of the reader arena
+ */
+struct rfc5444_reader_arena_chunk {
+  /*! next chunk of arena, NULL if last one */
+  struct rfc5444_reader_arena_chunk *next;
+
+  /*! number of usable bytes in chunk */
+  size_t size;
+
+  /*! number of bytes already handed out */
+  size_t used;
+};
+
+/**
+ * Bump allocator for all temporary data of a parsed packet. All
+ * memory is handed back at once at the end of
+ * rfc5444_reader_handle_packet(), the chunks are kept for the
+ * next packet.
+ */
+struct rfc5444_reader_arena {
+  /*! first memory chunk */
+  struct rfc5444_reader_arena_chunk *_first;
+
+  /*! chunk currently used for allocation */
+  struct rfc5444_reader_arena_chunk *_current;
+
+  /*! size of the single chunk that replaces all chunks at the next reset */
+  size_t _next_size;
+
+  /*! number of chunks allocated from the system */
+  uint64_t chunk_allocations;
+
+  /*! number of allocations served by the arena */
+  uint64_t allocations;
+};
+
 /**
  * common context for packet, message and address TLV block
  */
@@ -216,7 +265,7 @@ struct rfc5444_reader_addrblock_entry {
   struct list_entity list_node;
 
   /*! corresponding tlv block */
-  struct avl_tree tlvblock;
+  struct rfc5444_reader_tlvblock tlvblock;
 
   /*! number of addresses */
   uint8_t num_addr;
@@ -386,29 +435,8 @@ struct rfc5444_reader {
    */
   void (*forward_message)(struct rfc5444_reader_tlvblock_context *context, const uint8_t *buffer, size_t length);
 
-  /**
-   * Callback to allocate a tlvblock entry
-   * @return tlvblock entry, NULL if out of memory
-   */
-  struct rfc5444_reader_tlvblock_entry *(*malloc_tlvblock_entry)(void);
-
-  /**
-   * Callback to allocate an addressblock entry
-   * @return addressblock entry, NULL if out of memory
-   */
-  struct rfc5444_reader_addrblock_entry *(*malloc_addrblock_entry)(void);
-
-  /**
-   * Free a tlvblock entry
-   * @param entry tlvblock entry to free
-   */
-  void (*free_tlvblock_entry)(struct rfc5444_reader_tlvblock_entry *entry);
-
-  /**
-   * Free an addressblock entry
-   * @param entry addressblock entry to free
-   */
-  void (*free_addrblock_entry)(struct rfc5444_reader_addrblock_entry *entry);
+  /*! memory for address blocks and TLV blocks of the current packet */
+  struct rfc5444_reader_arena arena;
 };
 
 EXPORT void rfc5444_reader_init(struct rfc5444_reader *);
@@ -303,6 +303,32 @@ struct rfc5444_writer_target {
   size_t _bin_msgs_size;
 };
 
+/**
+ * This INTERNAL struct stores the wire image of an unfragmented
+ * message between two content changes. The image is stored before
+ * running the post-processors, so signatures are recalculated for
+ * every copy.
+ */
+struct rfc5444_writer_msgcache {
+  /*! hook into list of cached images of a message */
+  struct list_entity _node;
+
+  /*! target of a target specific message, NULL otherwise */
+  struct rfc5444_writer_target *target;
+
+  /*! address length of the cached message */
+  uint8_t addr_len;
+
+  /*! content generation the image was created for */
+  uint32_t generation;
+
+  /*! number of bytes of the wire image */
+  size_t size;
+
+  /*! wire image of the message */
+  uint8_t data[RFC5444_MAX_MESSAGE_SIZE];
+};
+
 /**
  * This struct is allocated for each message type that can
  * be generated by the writer.
@@ -397,6 +423,30 @@ struct rfc5444_writer_message {
   /*! number of bytes necessary for addressblocks including tlvs */
   size_t _bin_addr_size;
 
+  /**
+   * true if unfragmented messages should be reused as long as
+   * the content_generation does not change. Only the message
+   * header (hopcount, hoplimit and sequence number) is updated
+   * for a cached message and the message content providers
+   * are not called.
+   */
+  bool cache_enabled;
+
+  /**
+   * content generation of the message, must be changed by the user
+   * every time the content of the message changes
+   */
+  uint32_t content_generation;
+
+  /*! number of messages generated from the cache */
+  uint32_t cache_hits;
+
+  /*! number of messages generated by the content providers */
+  uint32_t cache_misses;
+
+  /*! list of cached message images */
+  struct list_entity _cache_head;
+
   /*! custom user data */
   void *user;
 };
@@ -655,6 +705,7 @@ EXPORT void rfc5444_writer_unregister_forward_handler(
 EXPORT struct rfc5444_writer_message *rfc5444_writer_register_message(
   struct rfc5444_writer *writer, uint8_t msgid, bool if_specific);
 EXPORT void rfc5444_writer_unregister_message(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg);
+EXPORT void rfc5444_writer_clear_message_cache(struct rfc5444_writer_message *msg);
 
 EXPORT void rfc5444_writer_register_pkthandler(struct rfc5444_writer *writer, struct rfc5444_writer_pkthandler *pkt);
 EXPORT void rfc5444_writer_unregister_pkthandler(struct rfc5444_writer *writer, struct rfc5444_writer_pkthandler *pkt);
@@ -689,6 +740,7 @@ EXPORT void rfc5444_writer_cleanup(struct rfc5444_writer *writer);
 /* internal functions that are not exported to the user */
 void _rfc5444_writer_free_addresses(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg);
 void _rfc5444_writer_begin_packet(struct rfc5444_writer *writer, struct rfc5444_writer_target *target);
+void _rfc5444_writer_clear_target_cache(struct rfc5444_writer *writer, struct rfc5444_writer_target *target);
 
 /**
  * creates a message of a certain ID for a single target
@@ -86,6 +86,9 @@ EXPORT void nhdp_set_originator(const struct netaddr *);
 EXPORT void nhdp_reset_originator(int af_type);
 EXPORT const struct netaddr *nhdp_get_originator(int af_type);
 
+EXPORT void nhdp_content_changed(void);
+EXPORT uint32_t nhdp_get_content_generation(void);
+
 EXPORT bool nhdp_flooding_selector(
   struct rfc5444_writer *writer, struct rfc5444_writer_target *rfc5444_target, void *ptr);
 EXPORT bool nhdp_forwarding_selector(
@@ -55,6 +55,7 @@ struct nhdp_laddr;
 #include <oonf/oonf.h>
 #include <oonf/libcommon/list.h>
 #include <oonf/libcommon/netaddr.h>
+#include <oonf/libcommon/netaddr_hash.h>
 #include <oonf/base/oonf_rfc5444.h>
 #include <oonf/base/oonf_timer.h>
 
@@ -266,6 +267,9 @@ struct nhdp_laddr {
 
   /*! member entry for interface tree of link addresses */
   struct avl_node _if_node;
+
+  /*! member entry for interface hash index of link addresses */
+  struct netaddr_hash_node _if_hash_node;
 };
 
 /**
@@ -361,6 +365,9 @@ struct nhdp_naddr {
   /*! member entry for global neighbor address tree */
   struct avl_node _global_node;
 
+  /*! member entry for global neighbor address hash index */
+  struct netaddr_hash_node _global_hash_node;
+
   /**
    * temporary variables for NHDP Hello processing
    * true if address is part of the local interface
@@ -380,6 +387,7 @@ void nhdp_db_cleanup(void);
 EXPORT struct nhdp_neighbor *nhdp_db_neighbor_add(void);
 EXPORT void nhdp_db_neighbor_remove(struct nhdp_neighbor *);
 EXPORT void nhdp_db_neighbor_set_unsymmetric(struct nhdp_neighbor *neigh);
+EXPORT void nhdp_db_neighbor_changed(struct nhdp_neighbor *neigh);
 EXPORT void nhdp_db_neighbor_join(struct nhdp_neighbor *, struct nhdp_neighbor *);
 EXPORT struct nhdp_naddr *nhdp_db_neighbor_addr_add(struct nhdp_neighbor *, const struct netaddr *);
 EXPORT void nhdp_db_neighbor_addr_remove(struct nhdp_naddr *);
@@ -397,6 +405,7 @@ EXPORT void nhdp_db_link_addr_remove(struct nhdp_laddr *);
 EXPORT void nhdp_db_link_addr_move(struct nhdp_link *, struct nhdp_laddr *);
 EXPORT struct nhdp_l2hop *nhdp_db_link_2hop_add(struct nhdp_link *, const struct netaddr *);
 EXPORT void nhdp_db_link_2hop_remove(struct nhdp_l2hop *);
+EXPORT void nhdp_db_link_2hop_changed(struct nhdp_l2hop *);
 EXPORT void nhdp_db_link_connect_dualstack(struct nhdp_link *ipv4, struct nhdp_link *ipv6);
 EXPORT void nhdp_db_link_disconnect_dualstack(struct nhdp_link *lnk);
 
@@ -408,6 +417,7 @@ EXPORT const char *nhdp_db_link_status_to_string(struct nhdp_link *);
 EXPORT struct list_entity *nhdp_db_get_neigh_list(void);
 EXPORT struct list_entity *nhdp_db_get_link_list(void);
 EXPORT struct avl_tree *nhdp_db_get_naddr_tree(void);
+EXPORT struct netaddr_hash *nhdp_db_get_naddr_hash(void);
 EXPORT struct avl_tree *nhdp_db_get_neigh_originator_tree(void);
 
 /**
@@ -417,7 +427,7 @@ EXPORT struct avl_tree *nhdp_db_get_neigh_originator_tree(void);
 static INLINE struct nhdp_naddr *
 nhdp_db_neighbor_addr_get(const struct netaddr *addr) {
   struct nhdp_naddr *naddr;
-  return avl_find_element(nhdp_db_get_naddr_tree(), addr, naddr, _global_node);
+  return netaddr_hash_find_element(nhdp_db_get_naddr_hash(), addr, naddr, _global_hash_node);
 }
 
 /**
@@ -500,6 +510,9 @@ nhdp_db_link_2hop_set_vtime(struct nhdp_l2hop *l2hop, uint64_t vtime) {
  */
 static INLINE void
 nhdp_db_neighbor_addr_set_lost(struct nhdp_naddr *naddr, uint64_t vtime) {
+  if (!oonf_timer_is_active(&naddr->_lost_vtime)) {
+    nhdp_content_changed();
+  }
   oonf_timer_set(&naddr->_lost_vtime, vtime);
 }
 
@@ -509,6 +522,9 @@ nhdp_db_neighbor_addr_set_lost(struct nhdp_naddr *naddr, uint64_t vtime) {
  */
 static INLINE void
 nhdp_db_neighbor_addr_not_lost(struct nhdp_naddr *naddr) {
+  if (oonf_timer_is_active(&naddr->_lost_vtime)) {
+    nhdp_content_changed();
+  }
   oonf_timer_stop(&naddr->_lost_vtime);
 }
 
@@ -55,6 +55,7 @@ struct nhdp_interface_domaindata;
 #include <oonf/libcommon/list.h>
 #include <oonf/libcommon/netaddr.h>
 #include <oonf/libcommon/netaddr_acl.h>
+#include <oonf/libcommon/netaddr_hash.h>
 #include <oonf/base/oonf_rfc5444.h>
 #include <oonf/base/oonf_timer.h>
 #include <oonf/base/os_interface.h>
@@ -144,6 +145,9 @@ struct nhdp_interface {
   /*! tree of addresses of links (nhdp_laddr objects) */
   struct avl_tree _link_addresses;
 
+  /*! hash index of addresses of links for fast lookups */
+  struct netaddr_hash _link_address_hash;
+
   /*! tree of originator addresses of links (nhdp_link objects) */
   struct avl_tree _link_originators;
 
@@ -220,6 +224,15 @@ nhdp_interface_get_name(const struct nhdp_interface *interf) {
   return interf->_node.key;
 }
 
+/**
+ * @param interf nhdp interface
+ * @return hash index of the link addresses of the interface
+ */
+static INLINE const struct netaddr_hash *
+nhdp_interface_get_link_addr_hash(const struct nhdp_interface *interf) {
+  return &interf->_link_address_hash;
+}
+
 /**
  * @param interf nhdp interface
  * @param addr network address
@@ -291,7 +304,10 @@ nhdp_interface_remove_l2hop(struct nhdp_l2hop *twohop) {
  */
 static INLINE void
 nhdp_interface_add_laddr(struct nhdp_laddr *laddr) {
-  avl_insert(&laddr->link->local_if->_link_addresses, &laddr->_if_node);
+  if (!avl_insert(&laddr->link->local_if->_link_addresses, &laddr->_if_node)) {
+    laddr->_if_hash_node.key = &laddr->link_addr;
+    netaddr_hash_insert(&laddr->link->local_if->_link_address_hash, &laddr->_if_hash_node);
+  }
 }
 
 /**
@@ -301,6 +317,7 @@ nhdp_interface_add_laddr(struct nhdp_laddr *laddr) {
 static INLINE void
 nhdp_interface_remove_laddr(struct nhdp_laddr *laddr) {
   avl_remove(&laddr->link->local_if->_link_addresses, &laddr->_if_node);
+  netaddr_hash_remove(&laddr->link->local_if->_link_address_hash, &laddr->_if_hash_node);
 }
 
 /**
@@ -309,10 +326,10 @@ nhdp_interface_remove_laddr(struct nhdp_laddr *laddr) {
  * @return link address object fitting the network address, NULL if not found
  */
 static INLINE struct nhdp_laddr *
-nhdp_interface_get_link_addr(const struct nhdp_interface *interf, const struct netaddr *addr) {
+nhdp_interface_get_link_addr(struct nhdp_interface *interf, const struct netaddr *addr) {
   struct nhdp_laddr *laddr;
 
-  return avl_find_element(&interf->_link_addresses, addr, laddr, _if_node);
+  return netaddr_hash_find_element(&interf->_link_address_hash, addr, laddr, _if_hash_node);
 }
 
 /**
@@ -47,6 +47,7 @@
 #define OLSRV2_ROUTING_H_
 
 #include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/heap.h>
 #include <oonf/oonf.h>
 #include <oonf/libcommon/list.h>
 #include <oonf/libcommon/netaddr.h>
@@ -67,8 +68,8 @@ enum
  * representation of a node in the dijkstra tree
  */
 struct olsrv2_dijkstra_node {
-  /*! hook into the working list of the dijkstra */
-  struct avl_node _node;
+  /*! hook into the working queue of the dijkstra, key is the path cost */
+  struct heap_node _node;
 
   /*! total path cost */
   uint32_t path_cost;
@@ -85,6 +86,9 @@ struct olsrv2_dijkstra_node {
   /*! pointer to nhpd neighbor that represents the first hop */
   struct nhdp_neighbor *first_hop;
 
+  /*! parent in the shortest path tree, NULL for one-hop neighbors */
+  struct olsrv2_dijkstra_node *parent;
+
   /**
    * address of the last originator in the routing tree before
    * the destination
@@ -99,6 +103,12 @@ struct olsrv2_dijkstra_node {
 
   /*! true if node already has been processed */
   bool done;
+
+  /*! true if the outgoing edges of the node changed since the last dijkstra run */
+  bool changed;
+
+  /*! state of node during incremental shortest path tree repair */
+  uint8_t _repair;
 };
 
 /**
@@ -165,6 +175,26 @@ struct olsrv2_routing_domain {
   bool source_specific;
 };
 
+/**
+ * Statistics of the shortest path calculation
+ */
+struct olsrv2_routing_statistics {
+  /*! number of full dijkstra runs */
+  uint32_t full_runs;
+
+  /*! number of incremental shortest path tree repairs */
+  uint32_t incremental_runs;
+
+  /*! number of incremental repairs replaced by a full run because of too many changes */
+  uint32_t fallbacks;
+
+  /*! number of nodes taken from the working queue during incremental repairs */
+  uint64_t nodes_repaired;
+
+  /*! number of nodes incremental repairs did not have to process compared to full runs */
+  uint64_t nodes_saved;
+};
+
 /**
  * A filter that can modify or drop the result of the Dijkstra algorithm
  */
@@ -187,8 +217,12 @@ void olsrv2_routing_initiate_shutdown(void);
 void olsrv2_routing_cleanup(void);
 
 void olsrv2_routing_dijkstra_node_init(struct olsrv2_dijkstra_node *, const struct netaddr *originator);
+void olsrv2_routing_dijkstra_node_changed(struct olsrv2_dijkstra_node *);
+void olsrv2_routing_dijkstra_invalidate(void);
+void olsrv2_routing_set_incremental_limit(int32_t percent);
 
 EXPORT uint16_t olsrv2_routing_get_ansn(void);
+EXPORT uint32_t olsrv2_routing_get_topology_generation(struct nhdp_domain *domain);
 EXPORT void olsrv2_routing_force_ansn_increment(uint16_t increment);
 
 EXPORT void olsrv2_routing_set_domain_parameter(struct nhdp_domain *domain, struct olsrv2_routing_domain *parameter);
@@ -203,6 +237,7 @@ EXPORT const struct olsrv2_routing_domain *olsrv2_routing_get_parameters(struct
 
 EXPORT struct avl_tree *olsrv2_routing_get_tree(struct nhdp_domain *domain);
 EXPORT struct list_entity *olsrv2_routing_get_filter_list(void);
+EXPORT const struct olsrv2_routing_statistics *olsrv2_routing_get_statistics(void);
 
 /**
  * Add a routing filter to the dijkstra processing list
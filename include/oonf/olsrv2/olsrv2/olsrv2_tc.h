@@ -49,6 +49,7 @@
 #include <oonf/libcommon/avl.h>
 #include <oonf/oonf.h>
 #include <oonf/libcommon/netaddr.h>
+#include <oonf/libcommon/netaddr_hash.h>
 
 #include <oonf/base/oonf_timer.h>
 
@@ -138,6 +139,9 @@ struct olsrv2_tc_node {
 
   /*! node for tree of tc_nodes */
   struct avl_node _originator_node;
+
+  /*! node for hash index of tc_nodes */
+  struct netaddr_hash_node _originator_hash_node;
 };
 
 /**
@@ -165,6 +169,9 @@ struct olsrv2_tc_edge {
    */
   bool virtual;
 
+  /*! true if the costs changed since the last change event */
+  bool _changed;
+
   /*! node for tree of source node */
   struct avl_node _node;
 };
@@ -189,6 +196,9 @@ struct olsrv2_tc_attachment {
   /*! answer set number which set this edge */
   uint16_t ansn;
 
+  /*! true if the costs or distances changed since the last change event */
+  bool _changed;
+
   /*! node for tree of source node */
   struct avl_node _src_node;
 
@@ -228,6 +238,7 @@ EXPORT void olsrv2_tc_endpoint_remove(struct olsrv2_tc_attachment *);
 void olsrv2_tc_trigger_change(struct olsrv2_tc_node *);
 
 EXPORT struct avl_tree *olsrv2_tc_get_tree(void);
+EXPORT struct netaddr_hash *olsrv2_tc_get_hash(void);
 EXPORT struct avl_tree *olsrv2_tc_get_endpoint_tree(void);
 
 /**
@@ -238,7 +249,7 @@ static INLINE struct olsrv2_tc_node *
 olsrv2_tc_node_get(struct netaddr *originator) {
   struct olsrv2_tc_node *node;
 
-  return avl_find_element(olsrv2_tc_get_tree(), originator, node, _originator_node);
+  return netaddr_hash_find_element(olsrv2_tc_get_hash(), originator, node, _originator_hash_node);
 }
 
 /**
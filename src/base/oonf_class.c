@@ -43,10 +43,14 @@
  * @file
  */
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include <oonf/libcommon/avl.h>
 #include <oonf/libcommon/avl_comp.h>
+#include <oonf/libconfig/cfg_schema.h>
 #include <oonf/libcore/oonf_logging.h>
 #include <oonf/libcore/oonf_subsystem.h>
 
@@ -55,13 +59,49 @@
 /* Definitions */
 #define LOG_CLASS (_oonf_class_subsystem.logging)
 
+/**
+ * Header of a slab. A slab is a block of _slab_size bytes aligned to its
+ * own size, so the header of an object can be found by masking the
+ * object pointer. The objects follow the header. Slabs are mapped
+ * directly from the kernel, so they do not fragment the heap and
+ * their pages are returned to the system when they are released.
+ */
+struct _class_slab {
+  /*! hook into partial or empty slab list of class */
+  struct list_entity _node;
+
+  /*! list of released objects within the slab */
+  struct list_entity _free_objects;
+
+  /*! number of objects currently in use */
+  uint32_t used;
+
+  /*! number of objects that have been handed out at least once */
+  uint32_t carved;
+};
+
+/**
+ * Configuration of class subsystem
+ */
+struct _class_config {
+  /*! number of empty slabs a class keeps before releasing them */
+  int32_t keep_empty_slabs;
+};
+
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
 
+static void *_slab_malloc(struct oonf_class *);
+static void _slab_free(struct oonf_class *, void *);
+static void _slab_release(struct oonf_class *, struct _class_slab *);
+static void _release_empty_slabs(struct oonf_class *, uint32_t keep);
+static void *_map_slab(size_t size);
+static void _calculate_slab_size(struct oonf_class *);
 static void _free_freelist(struct oonf_class *);
 static size_t _roundup(size_t);
 static const char *_cb_to_keystring(struct oonf_objectkey_str *, struct oonf_class *, void *);
+static void _cb_config_changed(void);
 
 /* list of memory cookies */
 static struct avl_tree _classes_tree;
@@ -73,11 +113,29 @@ static const char *OONF_CLASS_EVENT_NAME[] = {
   [OONF_OBJECT_CHANGED] = "changed",
 };
 
+/* configuration */
+static struct _class_config _config;
+
+static struct cfg_schema_entry _class_entries[] = {
+  CFG_MAP_INT32_MINMAX(_class_config, keep_empty_slabs, "keep_empty_slabs", "1",
+    "Number of empty slabs each memory class keeps for reuse before returning them to the system", 0, 0, 1024),
+};
+
+static struct cfg_schema_section _class_section = {
+  .type = OONF_CLASS_SUBSYSTEM,
+  .mode = CFG_SSMODE_UNNAMED,
+  .help = "Settings for the memory class allocator",
+  .cb_delta_handler = _cb_config_changed,
+  .entries = _class_entries,
+  .entry_count = ARRAYSIZE(_class_entries),
+};
+
 /* subsystem definition */
 static struct oonf_subsystem _oonf_class_subsystem = {
   .name = OONF_CLASS_SUBSYSTEM,
   .init = _init,
   .cleanup = _cleanup,
+  .cfg_section = &_class_section,
 };
 DECLARE_OONF_PLUGIN(_oonf_class_subsystem);
 
@@ -88,6 +146,7 @@ DECLARE_OONF_PLUGIN(_oonf_class_subsystem);
 static int
 _init(void) {
   avl_init(&_classes_tree, avl_comp_strcasecmp, false);
+  _config.keep_empty_slabs = 1;
   return 0;
 }
 
@@ -114,6 +173,7 @@ void
 oonf_class_add(struct oonf_class *ci) {
   /* round up size to make block extendable */
   ci->total_size = _roundup(ci->size);
+  _calculate_slab_size(ci);
 
   /* hook into tree */
   ci->_node.key = ci->name;
@@ -126,13 +186,17 @@ oonf_class_add(struct oonf_class *ci) {
 
   /* Init list heads */
   list_init_head(&ci->_free_list);
+  list_init_head(&ci->_partial_slabs);
+  list_init_head(&ci->_empty_slabs);
   list_init_head(&ci->_extensions);
 
   OONF_DEBUG(LOG_CLASS, "Class %s added: %" PRINTF_SIZE_T_SPECIFIER " bytes\n", ci->name, ci->total_size);
 }
 
 /**
- * Delete a memcookie and all memory in the free list
+ * Delete a memcookie and all memory in the free list. Objects still
+ * in use stay valid, their slabs are returned to the system when
+ * the last of their objects is freed.
  * @param ci pointer to memcookie
  */
 void
@@ -142,7 +206,7 @@ oonf_class_remove(struct oonf_class *ci) {
   /* remove memcookie from tree */
   avl_remove(&_classes_tree, &ci->_node);
 
-  /* remove all free memory blocks */
+  /* remove all free memory blocks and empty slabs */
   _free_freelist(ci);
 
   /* remove all listeners */
@@ -167,6 +231,10 @@ oonf_class_malloc(struct oonf_class *ci) {
   bool reuse = false;
 #endif
 
+  if (ci->_slab_size) {
+    return _slab_malloc(ci);
+  }
+
   /*
    * Check first if we have reusable memory.
    */
@@ -220,6 +288,11 @@ oonf_class_free(struct oonf_class *ci, void *ptr) {
   bool reuse = false;
 #endif
 
+  if (ci->_slab_size) {
+    _slab_free(ci, ptr);
+    return;
+  }
+
   /*
    * Rather than freeing the memory right away, try to reuse at a later
    * point. Keep at least ten percent of the active used blocks or at least
@@ -285,6 +358,7 @@ oonf_class_extension_add(struct oonf_class_extension *ext) {
 
     /* calculate new size */
     c->total_size = _roundup(c->total_size + ext->size);
+    _calculate_slab_size(c);
 
     OONF_DEBUG(LOG_CLASS,
       "Class %s extended: %" PRINTF_SIZE_T_SPECIFIER " bytes,"
@@ -334,6 +408,11 @@ oonf_class_event(struct oonf_class *c, void *ptr, enum oonf_class_event evt) {
       OONF_DEBUG(LOG_CLASS, "Fire listener %s", ext->ext_name);
       ext->cb_change(ptr);
     }
+
+    if (ext->cb_event != NULL) {
+      OONF_DEBUG(LOG_CLASS, "Fire generic listener %s", ext->ext_name);
+      ext->cb_event(ext, ptr, evt);
+    }
   }
   OONF_DEBUG(LOG_CLASS, "Fire event finished");
 }
@@ -357,6 +436,213 @@ oonf_class_get_event_name(enum oonf_class_event event) {
   return OONF_CLASS_EVENT_NAME[event];
 }
 
+/**
+ * Allocate an object out of the slabs of a class
+ * @param ci pointer to class
+ * @return pointer to object, NULL if out of memory
+ */
+static void *
+_slab_malloc(struct oonf_class *ci) {
+  struct _class_slab *slab;
+  struct list_entity *entity;
+  uint8_t *ptr;
+
+  if (list_is_empty(&ci->_partial_slabs)) {
+    if (!list_is_empty(&ci->_empty_slabs)) {
+      /* reuse an empty slab */
+      slab = list_first_element(&ci->_empty_slabs, slab, _node);
+      list_remove(&slab->_node);
+      ci->_slab_empty--;
+    }
+    else {
+      /* get a new slab from the system */
+      slab = _map_slab(ci->_slab_size);
+      if (slab == NULL) {
+        OONF_WARN(LOG_CLASS, "Out of memory for: %s", ci->name);
+        return NULL;
+      }
+
+      list_init_head(&slab->_free_objects);
+      slab->used = 0;
+      slab->carved = 0;
+
+      ci->_slab_count++;
+      ci->_slab_allocated++;
+      ci->_free_list_size += ci->_slab_capacity;
+    }
+    list_add_tail(&ci->_partial_slabs, &slab->_node);
+  }
+  slab = list_first_element(&ci->_partial_slabs, slab, _node);
+
+  if (!list_is_empty(&slab->_free_objects)) {
+    /* reuse the most recently released object of the slab */
+    entity = slab->_free_objects.next;
+    list_remove(entity);
+    ptr = (uint8_t *)entity;
+    ci->_recycled++;
+  }
+  else {
+    /* carve a new object out of the unused end of the slab */
+    ptr = ((uint8_t *)slab) + _roundup(sizeof(*slab)) + (size_t)slab->carved * ci->total_size;
+    slab->carved++;
+    ci->_allocated++;
+  }
+
+  slab->used++;
+  if (slab->used == ci->_slab_capacity) {
+    /* slab is full, take it out of the partial list */
+    list_remove(&slab->_node);
+  }
+
+  memset(ptr, 0, ci->total_size);
+
+  ci->_free_list_size--;
+  ci->_current_usage++;
+
+  OONF_DEBUG(LOG_CLASS, "MEMORY: alloc %s, %" PRINTF_SIZE_T_SPECIFIER " bytes from slab %p\n", ci->name,
+    ci->total_size, (void *)slab);
+  return ptr;
+}
+
+/**
+ * Return an object to its slab
+ * @param ci pointer to class
+ * @param ptr pointer to object
+ */
+static void
+_slab_free(struct oonf_class *ci, void *ptr) {
+  struct _class_slab *slab;
+  uint32_t free_objects;
+
+  slab = (struct _class_slab *)((uintptr_t)ptr & ~((uintptr_t)ci->_slab_size - 1));
+
+  if (slab->used == ci->_slab_capacity) {
+    /* slab was full, objects will be taken from it again */
+    list_add_head(&ci->_partial_slabs, &slab->_node);
+  }
+
+  /* prefer the most recently used object (still hot in cache) */
+  list_add_head(&slab->_free_objects, (struct list_entity *)ptr);
+  slab->used--;
+
+  ci->_free_list_size++;
+  ci->_current_usage--;
+
+  OONF_DEBUG(LOG_CLASS, "MEMORY: free %s, %" PRINTF_SIZE_T_SPECIFIER " bytes to slab %p\n", ci->name, ci->size,
+    (void *)slab);
+
+  if (slab->used > 0) {
+    return;
+  }
+
+  list_remove(&slab->_node);
+
+  /* keep the slab if the class would run short of free objects otherwise */
+  free_objects = ci->_free_list_size - ci->_slab_capacity;
+  if (avl_is_node_added(&ci->_node)
+      && (ci->_slab_empty < (uint32_t)_config.keep_empty_slabs || free_objects < ci->min_free_count)) {
+    list_add_tail(&ci->_empty_slabs, &slab->_node);
+    ci->_slab_empty++;
+    return;
+  }
+  _slab_release(ci, slab);
+}
+
+/**
+ * Return an empty slab to the system
+ * @param ci pointer to class
+ * @param slab pointer to slab
+ */
+static void
+_slab_release(struct oonf_class *ci, struct _class_slab *slab) {
+  OONF_DEBUG(LOG_CLASS, "MEMORY: release slab %p of %s\n", (void *)slab, ci->name);
+
+  ci->_free_list_size -= ci->_slab_capacity;
+  ci->_slab_count--;
+  ci->_slab_released++;
+  munmap(slab, ci->_slab_size);
+}
+
+/**
+ * Release empty slabs of a class
+ * @param ci pointer to class
+ * @param keep number of empty slabs the class should keep
+ */
+static void
+_release_empty_slabs(struct oonf_class *ci, uint32_t keep) {
+  struct _class_slab *slab;
+
+  while (ci->_slab_empty > keep) {
+    slab = list_first_element(&ci->_empty_slabs, slab, _node);
+    list_remove(&slab->_node);
+    ci->_slab_empty--;
+
+    _slab_release(ci, slab);
+  }
+}
+
+/**
+ * Map a block of memory aligned to its own size
+ * @param size size of block, a power of two
+ * @return pointer to memory block, NULL if out of memory
+ */
+static void *
+_map_slab(size_t size) {
+  static size_t page_size = 0;
+  uint8_t *ptr, *aligned;
+  size_t head;
+
+  if (page_size == 0) {
+    page_size = (size_t)sysconf(_SC_PAGESIZE);
+  }
+
+  if (size <= page_size) {
+    /* pages are aligned to blocks up to page size */
+    ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return ptr == MAP_FAILED ? NULL : ptr;
+  }
+
+  /* map twice the size and cut the aligned block out of it */
+  ptr = mmap(NULL, size * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) {
+    return NULL;
+  }
+
+  aligned = (uint8_t *)(((uintptr_t)ptr + size - 1) & ~((uintptr_t)size - 1));
+  head = aligned - ptr;
+  if (head > 0) {
+    munmap(ptr, head);
+  }
+  munmap(aligned + size, size - head);
+  return aligned;
+}
+
+/**
+ * Calculate the slab size of a class from the size of its objects.
+ * Classes with very large objects allocate them one by one.
+ * @param ci pointer to class
+ */
+static void
+_calculate_slab_size(struct oonf_class *ci) {
+  size_t header, slab_size;
+
+  header = _roundup(sizeof(struct _class_slab));
+
+  slab_size = OONF_CLASS_SLAB_MIN_SIZE;
+  while (slab_size < header + ci->total_size * OONF_CLASS_SLAB_MIN_OBJECTS && slab_size < OONF_CLASS_SLAB_MAX_SIZE) {
+    slab_size *= 2;
+  }
+
+  if (slab_size < header + ci->total_size * OONF_CLASS_SLAB_MIN_OBJECTS) {
+    ci->_slab_size = 0;
+    ci->_slab_capacity = 0;
+  }
+  else {
+    ci->_slab_size = slab_size;
+    ci->_slab_capacity = (slab_size - header) / ci->total_size;
+  }
+}
+
 /**
  * @param size memory size in byte
  * @return rounded up size to sizeof(struct list_entity)
@@ -371,10 +657,17 @@ _roundup(size_t size) {
 
 /**
  * Free all objects in the free_list of a memory cookie
+ * and return all empty slabs to the system
  * @param ci pointer to memory cookie
  */
 static void
 _free_freelist(struct oonf_class *ci) {
+  if (ci->_slab_size) {
+    /* objects of slabs in use stay valid */
+    _release_empty_slabs(ci, 0);
+    return;
+  }
+
   while (!list_is_empty(&ci->_free_list)) {
     struct list_entity *item;
     item = ci->_free_list.next;
@@ -398,3 +691,21 @@ _cb_to_keystring(struct oonf_objectkey_str *buf, struct oonf_class *class, void
 
   return buf->buf;
 }
+
+/**
+ * Handler for configuration changes
+ */
+static void
+_cb_config_changed(void) {
+  struct oonf_class *c;
+
+  if (cfg_schema_tobin(&_config, _class_section.post, _class_entries, ARRAYSIZE(_class_entries))) {
+    OONF_WARN(LOG_CLASS, "Cannot convert " OONF_CLASS_SUBSYSTEM " configuration.");
+    return;
+  }
+
+  /* apply new policy to existing slabs */
+  avl_for_each_element(&_classes_tree, c, _node) {
+    _release_empty_slabs(c, (uint32_t)_config.keep_empty_slabs);
+  }
+}
@@ -43,13 +43,13 @@
  * @file
  */
 
-#include <oonf/libcommon/avl.h>
-#include <oonf/libcommon/avl_comp.h>
+#include <stdlib.h>
+
 #include <oonf/oonf.h>
 #include <oonf/libcommon/netaddr.h>
 #include <oonf/libcore/oonf_subsystem.h>
 #include <oonf/librfc5444/rfc5444.h>
-#include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_clock.h>
 #include <oonf/base/oonf_timer.h>
 
 #include <oonf/base/oonf_duplicate_set.h>
@@ -63,19 +63,18 @@ static void _cleanup(void);
 
 static enum oonf_duplicate_result _test(
   struct oonf_duplicate_set *, struct oonf_duplicate_entry *, uint64_t seqno, bool set);
-static int _avl_cmp_dupkey(const void *, const void *);
-
-static void _cb_vtime(struct oonf_timer_instance *);
-static void _remove_duplicate_entry(struct oonf_duplicate_entry *entry);
-
-static struct oonf_timer_class _vtime_info = {
-  .name = "Valdity time for duplicate set",
-  .callback = _cb_vtime,
-};
-
-static struct oonf_class _dupset_class = {
-  .name = "Duplicate set",
-  .size = sizeof(struct oonf_duplicate_entry),
+static uint32_t _hash_dupkey(const struct oonf_duplicate_entry_key *);
+static struct oonf_duplicate_entry *_find_slot(
+  struct oonf_duplicate_set *, const struct oonf_duplicate_entry_key *, uint32_t hash);
+static int _resize(struct oonf_duplicate_set *, uint32_t size);
+static void _remove_slot(struct oonf_duplicate_set *, uint32_t idx);
+
+static void _cb_sweep(struct oonf_timer_instance *);
+
+static struct oonf_timer_class _sweep_info = {
+  .name = "Validity time sweep for duplicate set",
+  .callback = _cb_sweep,
+  .periodic = true,
 };
 
 /* dupset result names */
@@ -90,7 +89,7 @@ static const char *OONF_DUPSET_RESULT_STR[] = {
 
 /* subsystem definition */
 static const char *_dependencies[] = {
-  OONF_CLASS_SUBSYSTEM,
+  OONF_CLOCK_SUBSYSTEM,
   OONF_TIMER_SUBSYSTEM,
 };
 
@@ -116,8 +115,7 @@ static const int64_t _mask_values[] = {
  */
 static int
 _init(void) {
-  oonf_class_add(&_dupset_class);
-  oonf_timer_add(&_vtime_info);
+  oonf_timer_add(&_sweep_info);
   return 0;
 }
 
@@ -126,8 +124,7 @@ _init(void) {
  */
 static void
 _cleanup(void) {
-  oonf_timer_remove(&_vtime_info);
-  oonf_class_remove(&_dupset_class);
+  oonf_timer_remove(&_sweep_info);
 }
 
 /**
@@ -138,7 +135,7 @@ _cleanup(void) {
 void
 oonf_duplicate_set_add(struct oonf_duplicate_set *set, enum oonf_dupset_type type) {
   memset(set, 0, sizeof(*set));
-  avl_init(&set->_tree, _avl_cmp_dupkey, false);
+  set->_sweep.class = &_sweep_info;
 
   if (type != OONF_DUPSET_64BIT) {
     set->_mask = _mask_values[type];
@@ -153,11 +150,12 @@ oonf_duplicate_set_add(struct oonf_duplicate_set *set, enum oonf_dupset_type typ
  */
 void
 oonf_duplicate_set_remove(struct oonf_duplicate_set *set) {
-  struct oonf_duplicate_entry *entry, *it;
+  oonf_timer_stop(&set->_sweep);
 
-  avl_for_each_element_safe(&set->_tree, entry, _node, it) {
-    _remove_duplicate_entry(entry);
-  }
+  free(set->_table);
+  set->_table = NULL;
+  set->_size = 0;
+  set->_count = 0;
 }
 
 /**
@@ -180,6 +178,7 @@ oonf_duplicate_entry_add(
   struct oonf_duplicate_entry *entry;
   struct oonf_duplicate_entry_key key;
   enum oonf_duplicate_result result;
+  uint32_t hash;
 
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str nbuf;
@@ -188,30 +187,34 @@ oonf_duplicate_entry_add(
   /* generate combined key */
   memcpy(&key.addr, originator, sizeof(*originator));
   key.msg_type = msg_type;
+  hash = _hash_dupkey(&key);
 
-  entry = avl_find_element(&set->_tree, &key, entry, _node);
-  if (!entry) {
-    entry = oonf_class_malloc(&_dupset_class);
-    if (entry == NULL) {
+  /* keep the load factor of the hash table below 50% */
+  if ((set->_count + 1) * 2 > set->_size) {
+    if (_resize(set, set->_size ? set->_size * 2 : OONF_DUPSET_MINIMUM_SIZE) && set->_count + 1 >= set->_size) {
+      /* no free slot left */
       return OONF_DUPSET_TOO_OLD;
     }
+  }
+
+  entry = _find_slot(set, &key, hash);
+  if (!entry->_used || oonf_clock_is_past(entry->_vtime)) {
+    if (!entry->_used) {
+      /* set key and link entry to set */
+      memcpy(&entry->key, &key, sizeof(key));
+      entry->_hash = hash;
+      entry->_used = true;
+      set->_count++;
+    }
 
-    /* initialize history and current sequence number */
+    /* (re)initialize history and current sequence number */
     entry->current = seqno;
     entry->history = 1;
+    entry->too_old_count = 0;
 
-    /* initialize backpointer */
-    entry->set = set;
-
-    /* initialize vtime */
-    entry->_vtime.class = &_vtime_info;
-
-    oonf_timer_start(&entry->_vtime, vtime);
-
-    /* set key and link entry to set */
-    memcpy(&entry->key, &key, sizeof(key));
-    entry->_node.key = &entry->key;
-    avl_insert(&set->_tree, &entry->_node);
+    if (!oonf_timer_is_active(&set->_sweep)) {
+      oonf_timer_start(&set->_sweep, OONF_DUPSET_SWEEP_INTERVAL);
+    }
 
     result = OONF_DUPSET_FIRST;
   }
@@ -222,8 +225,8 @@ oonf_duplicate_entry_add(
     netaddr_to_string(&nbuf, originator), seqno, OONF_DUPSET_RESULT_STR[result]);
 
   if (oonf_duplicate_is_new(result)) {
-    /* reset validity timer */
-    oonf_timer_set(&entry->_vtime, vtime);
+    /* reset validity time */
+    entry->_vtime = oonf_clock_get_absolute(vtime);
   }
   return result;
 }
@@ -254,8 +257,12 @@ oonf_duplicate_test(struct oonf_duplicate_set *set, uint8_t msg_type, struct net
   memcpy(&key.addr, originator, sizeof(*originator));
   key.msg_type = msg_type;
 
-  entry = avl_find_element(&set->_tree, &key, entry, _node);
-  if (!entry) {
+  entry = NULL;
+  if (set->_size) {
+    entry = _find_slot(set, &key, _hash_dupkey(&key));
+  }
+  if (!entry || !entry->_used || oonf_clock_is_past(entry->_vtime)) {
+    /* timed out entries are treated like they are already removed */
     result = OONF_DUPSET_FIRST;
   }
   else {
@@ -366,51 +373,152 @@ oonf_duplicate_get_result_str(enum oonf_duplicate_result result) {
 }
 
 /**
- * Comparator for duplicate entry keys
- * @param p1 key1
- * @param p2 key2
- * @return <0 if p1<p2, 0 if p1==p2, >0 if p1>p2
+ * Calculate the hash of a duplicate entry key (FNV-1a)
+ * @param key duplicate entry key
+ * @return hash value
+ */
+static uint32_t
+_hash_dupkey(const struct oonf_duplicate_entry_key *key) {
+  const uint8_t *ptr;
+  uint32_t hash;
+  size_t i;
+
+  hash = 2166136261u;
+
+  ptr = (const uint8_t *)&key->addr;
+  for (i = 0; i < sizeof(key->addr); i++) {
+    hash = (hash ^ ptr[i]) * 16777619u;
+  }
+  return (hash ^ key->msg_type) * 16777619u;
+}
+
+/**
+ * Look for the hash table slot of a key
+ * @param set duplicate set, must have a hash table with a free slot
+ * @param key duplicate entry key
+ * @param hash hash of the key
+ * @return slot containing the key, first unused slot if the key
+ *   is not in the table
+ */
+static struct oonf_duplicate_entry *
+_find_slot(struct oonf_duplicate_set *set, const struct oonf_duplicate_entry_key *key, uint32_t hash) {
+  struct oonf_duplicate_entry *entry;
+  uint32_t idx;
+
+  for (idx = hash & (set->_size - 1);; idx = (idx + 1) & (set->_size - 1)) {
+    entry = &set->_table[idx];
+    if (!entry->_used) {
+      return entry;
+    }
+    if (entry->_hash == hash && entry->key.msg_type == key->msg_type && netaddr_cmp(&entry->key.addr, &key->addr) == 0) {
+      return entry;
+    }
+  }
+}
+
+/**
+ * Move all entries of a duplicate set into a new hash table,
+ * timed out entries are dropped.
+ * @param set duplicate set
+ * @param size new number of slots, must be a power of 2 and
+ *   larger than the number of entries
+ * @return -1 if an out of memory error happened, 0 otherwise
  */
 static int
-_avl_cmp_dupkey(const void *p1, const void *p2) {
-  const struct oonf_duplicate_entry_key *k1, *k2;
+_resize(struct oonf_duplicate_set *set, uint32_t size) {
+  struct oonf_duplicate_entry *old_table, *entry;
+  uint32_t i, old_size;
+
+  old_table = set->_table;
+  old_size = set->_size;
+
+  set->_table = calloc(size, sizeof(struct oonf_duplicate_entry));
+  if (set->_table == NULL) {
+    OONF_WARN(LOG_DUPLICATE_SET, "Could not allocate duplicate set with %u entries", size);
+    set->_table = old_table;
+    return -1;
+  }
+  set->_size = size;
+  set->_count = 0;
+
+  for (i = 0; i < old_size; i++) {
+    if (old_table[i]._used && !oonf_clock_is_past(old_table[i]._vtime)) {
+      entry = _find_slot(set, &old_table[i].key, old_table[i]._hash);
+      memcpy(entry, &old_table[i], sizeof(*entry));
+      set->_count++;
+    }
+  }
+
+  free(old_table);
+  return 0;
+}
+
+/**
+ * Remove an entry from the hash table and shift the following entries
+ * of its probe sequence back, so no tombstones are necessary.
+ * @param set duplicate set
+ * @param idx index of slot to remove
+ */
+static void
+_remove_slot(struct oonf_duplicate_set *set, uint32_t idx) {
+  uint32_t mask, next, home;
 
-  k1 = p1;
-  k2 = p2;
+  mask = set->_size - 1;
+  next = idx;
 
-  if (k1->msg_type != k2->msg_type) {
-    return (int)(k1->msg_type) - (int)(k2->msg_type);
+  while (true) {
+    next = (next + 1) & mask;
+    if (!set->_table[next]._used) {
+      break;
+    }
+
+    /* move the entry into the hole if its home slot is not between hole and entry */
+    home = set->_table[next]._hash & mask;
+    if (((next - home) & mask) >= ((next - idx) & mask)) {
+      memcpy(&set->_table[idx], &set->_table[next], sizeof(struct oonf_duplicate_entry));
+      idx = next;
+    }
   }
 
-  return avl_comp_netaddr(&k1->addr, &k2->addr);
+  memset(&set->_table[idx], 0, sizeof(struct oonf_duplicate_entry));
+  set->_count--;
 }
 
 /**
- * Callback fired when duplicate entry times out
+ * Callback for removing all timed out entries of a duplicate set
  * @param ptr timer instance that fired
  */
 static void
-_cb_vtime(struct oonf_timer_instance *ptr) {
+_cb_sweep(struct oonf_timer_instance *ptr) {
+  struct oonf_duplicate_set *set;
   struct oonf_duplicate_entry *entry;
+  uint32_t i;
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str nbuf;
 #endif
 
-  entry = container_of(ptr, struct oonf_duplicate_entry, _vtime);
-  OONF_DEBUG(LOG_DUPLICATE_SET, "Duplicate entry timed out: %s/%u", netaddr_to_string(&nbuf, &entry->key.addr),
-    entry->key.msg_type);
+  set = container_of(ptr, struct oonf_duplicate_set, _sweep);
 
-  _remove_duplicate_entry(entry);
-}
+  i = 0;
+  while (i < set->_size) {
+    entry = &set->_table[i];
+    if (entry->_used && oonf_clock_is_past(entry->_vtime)) {
+      OONF_DEBUG(LOG_DUPLICATE_SET, "Duplicate entry timed out: %s/%u", netaddr_to_string(&nbuf, &entry->key.addr),
+        entry->key.msg_type);
 
-/**
- * Remove a duplicate entry
- * @param entry duplicate entry
- */
-static void
-_remove_duplicate_entry(struct oonf_duplicate_entry *entry) {
-  oonf_timer_stop(&entry->_vtime);
-  avl_remove(&entry->set->_tree, &entry->_node);
+      /* another entry might be shifted into this slot, check it again */
+      _remove_slot(set, i);
+    }
+    else {
+      i++;
+    }
+  }
 
-  oonf_class_free(&_dupset_class, entry);
+  if (set->_count == 0) {
+    oonf_duplicate_set_remove(set);
+  }
+  else if (set->_size > OONF_DUPSET_MINIMUM_SIZE && set->_count * 8 < set->_size) {
+    /* shrink table, keeps the current one if out of memory */
+    _resize(set, set->_size / 2);
+  }
 }
@@ -61,6 +61,7 @@
 #include <oonf/libcore/oonf_logging.h>
 #include <oonf/libcore/oonf_subsystem.h>
 #include <oonf/libcore/os_core.h>
+#include <oonf/base/oonf_class.h>
 #include <oonf/base/oonf_stream_socket.h>
 #include <oonf/base/oonf_telnet.h>
 
@@ -96,8 +97,11 @@ static const char HTTP_POST[] = "POST";
 
 static const char HTTP_CONTENT_LENGTH[] = "Content-Length";
 static const char HTTP_CONTENT_TYPE[] = "Content-Type";
+static const char HTTP_ETAG[] = "ETag";
+static const char HTTP_IF_NONE_MATCH[] = "If-None-Match";
 
 static const char HTTP_RESPONSE_200[] = "OK";
+static const char HTTP_RESPONSE_304[] = "Not Modified";
 static const char HTTP_RESPONSE_400[] = "Bad Request";
 static const char HTTP_RESPONSE_401[] = "Unauthorized";
 static const char HTTP_RESPONSE_403[] = "Forbidden";
@@ -119,13 +123,15 @@ static void _cb_config_changed(void);
 static enum oonf_stream_session_state _cb_receive_data(struct oonf_stream_session *session);
 static void _cb_create_error(struct oonf_stream_session *session, enum oonf_stream_errors error);
 static void _cb_cleanup_session(struct oonf_stream_session *);
+static enum oonf_stream_session_state _cb_buffer_underrun(struct oonf_stream_session *);
 
 static bool _auth_okay(struct oonf_http_handler *handler, struct oonf_http_session *session);
 static void _create_http_error(struct oonf_stream_session *session, enum oonf_http_result error);
 static struct oonf_http_handler *_get_site_handler(const char *uri);
 static const char *_get_headertype_string(enum oonf_http_result type);
-static void _create_http_header(
-  struct oonf_stream_session *session, enum oonf_http_result code, const char *content_type, size_t content_length);
+static void _create_http_header(struct oonf_stream_session *session, enum oonf_http_result code,
+  const char *content_type, const char *etag, bool weak_etag, size_t content_length);
+static bool _is_etag_matching(struct oonf_http_session *header, const char *etag);
 static int _parse_http_header(char *header_data, size_t header_len, struct oonf_http_session *header);
 static size_t _parse_query_string(char *s, char **name, char **value, size_t count);
 static void _decode_uri(char *src);
@@ -155,16 +161,23 @@ static struct cfg_schema_section _http_section = { .type = OONF_HTTP_SUBSYSTEM,
 /* tree of http sites */
 static struct avl_tree _http_site_tree;
 
-/* http session handling */
+/* http session handling, sessions can run continous telnet commands */
+static struct oonf_class _http_memcookie = {
+  .name = "http session",
+  .size = sizeof(struct oonf_telnet_session),
+};
+
 static struct oonf_stream_managed _http_managed_socket = {
   .config =
     {
       .session_timeout = 120000, /* 120 seconds */
       .maximum_input_buffer = 65536,
       .allowed_sessions = 10,
+      .memcookie = &_http_memcookie,
       .receive_data = _cb_receive_data,
       .create_error = _cb_create_error,
       .cleanup_session = _cb_cleanup_session,
+      .buffer_underrun = _cb_buffer_underrun,
     },
 };
 
@@ -191,6 +204,7 @@ static struct oonf_http_handler _file_handler = {
 
 /* subsystem definition */
 static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
   OONF_STREAM_SUBSYSTEM,
   OONF_TELNET_SUBSYSTEM,
 };
@@ -211,6 +225,7 @@ DECLARE_OONF_PLUGIN(_oonf_http_subsystem);
  */
 static int
 _init(void) {
+  oonf_class_add(&_http_memcookie);
   oonf_stream_add_managed(&_http_managed_socket);
   avl_init(&_http_site_tree, avl_comp_strcasecmp, false);
 
@@ -235,6 +250,7 @@ _cleanup(void) {
   oonf_http_remove(&_file_handler);
   oonf_stream_remove_managed(&_http_managed_socket, true);
   oonf_stream_free_managed_config(&_config.smc);
+  oonf_class_remove(&_http_memcookie);
 }
 
 /**
@@ -297,6 +313,12 @@ _cb_receive_data(struct oonf_stream_session *session) {
   char *ptr;
   size_t len;
 
+  if (((struct oonf_telnet_session *)session)->data.stop_handler) {
+    /* continous output is running, ignore further input */
+    abuf_clear(&session->in);
+    return session->state;
+  }
+
   /* search for end of http header */
   if ((first_header = strstr(abuf_getptr(&session->in), "\r\n\r\n"))) {
     first_header += 4;
@@ -378,6 +400,7 @@ _cb_receive_data(struct oonf_stream_session *session) {
 
   header.decoded_request_uri = uri;
   header.remote = &session->remote_address;
+  header.stream = session;
 
   handler = _get_site_handler(uri);
   if (handler == NULL) {
@@ -389,7 +412,7 @@ _cb_receive_data(struct oonf_stream_session *session) {
   if (handler->content) {
     /* static content */
     abuf_memcpy(&session->out, handler->content, handler->content_size);
-    _create_http_header(session, HTTP_200_OK, NULL, abuf_getlen(&session->out));
+    _create_http_header(session, HTTP_200_OK, NULL, NULL, false, abuf_getlen(&session->out));
   }
   else {
     /* custom handler */
@@ -415,19 +438,38 @@ _cb_receive_data(struct oonf_stream_session *session) {
       result = HTTP_500_INTERNAL_SERVER_ERROR;
     }
 
-    if (result == HTTP_START_FILE_TRANSFER) {
+    if ((result == HTTP_200_OK || result == HTTP_START_STREAM) && header.etag != NULL
+        && _is_etag_matching(&header, header.etag)) {
+      /* client has the current version of the content, do not send it again */
+      if (result == HTTP_START_STREAM) {
+        oonf_telnet_stop(&((struct oonf_telnet_session *)session)->data, false);
+      }
+      abuf_setlen(&session->out, len);
+      _create_http_header(
+        session, HTTP_304_NOT_MODIFIED, header.content_type, header.etag, result == HTTP_START_STREAM, 0);
+    }
+    else if (result == HTTP_START_FILE_TRANSFER) {
       os_fd_init(&session->copy_fd, header.transfer_fd);
       session->copy_total_size = header.transfer_length;
       session->copy_bytes_sent = 0;
 
-      _create_http_header(session, HTTP_200_OK, header.content_type, header.transfer_length);
+      _create_http_header(session, HTTP_200_OK, header.content_type, NULL, false, header.transfer_length);
+    }
+    else if (result == HTTP_START_STREAM) {
+      /* keep session open, the body ends when the connection is closed */
+      _create_http_header(session, HTTP_200_OK, header.content_type, header.etag, true, 0);
+      abuf_clear(&session->in);
+
+      /* a subscription might be quiet for a long time, do not time it out */
+      oonf_stream_set_timeout(session, 0);
+      return STREAM_SESSION_ACTIVE;
     }
     else if (result != HTTP_200_OK) {
       /* create error message */
       _create_http_error(session, result);
     }
     else {
-      _create_http_header(session, HTTP_200_OK, header.content_type, abuf_getlen(&session->out));
+      _create_http_header(session, HTTP_200_OK, header.content_type, header.etag, false, abuf_getlen(&session->out));
     }
   }
   return STREAM_SESSION_SEND_AND_QUIT;
@@ -439,7 +481,33 @@ _cb_receive_data(struct oonf_stream_session *session) {
  */
 static void
 _cb_cleanup_session(struct oonf_stream_session *session) {
+  struct oonf_telnet_session *telnet_session;
+
   os_fd_close(&session->copy_fd);
+
+  telnet_session = (struct oonf_telnet_session *)session;
+  if (telnet_session->data.out) {
+    /* stop continous telnet command */
+    oonf_telnet_cleanup_session(telnet_session);
+  }
+}
+
+/**
+ * Generate the next part of a streamed telnet command output
+ * @param session stream session with empty output buffer
+ * @return state of tcp session
+ */
+static enum oonf_stream_session_state
+_cb_buffer_underrun(struct oonf_stream_session *session) {
+  struct oonf_telnet_session *telnet_session;
+
+  telnet_session = (struct oonf_telnet_session *)session;
+  if (telnet_session->data.underrun_handler != NULL && telnet_session->data.underrun_handler(&telnet_session->data)) {
+    /* output is complete, closing the connection ends the http body */
+    oonf_telnet_stop(&telnet_session->data, false);
+    return STREAM_SESSION_SEND_AND_QUIT;
+  }
+  return session->state;
 }
 
 /**
@@ -493,7 +561,7 @@ _create_http_error(struct oonf_stream_session *session, enum oonf_http_result er
     "<html><head><title>%s %s http server</title></head>"
     "<body><h1>HTTP error %d: %s</h1></body></html>",
     oonf_log_get_appdata()->app_name, oonf_log_get_libdata()->version, error, _get_headertype_string(error));
-  _create_http_header(session, error, NULL, abuf_getlen(&session->out));
+  _create_http_header(session, error, NULL, NULL, false, abuf_getlen(&session->out));
 }
 
 /**
@@ -546,6 +614,8 @@ _get_headertype_string(enum oonf_http_result type) {
   switch (type) {
     case HTTP_200_OK:
       return HTTP_RESPONSE_200;
+    case HTTP_304_NOT_MODIFIED:
+      return HTTP_RESPONSE_304;
     case HTTP_400_BAD_REQ:
       return HTTP_RESPONSE_400;
     case HTTP_401_UNAUTHORIZED:
@@ -573,12 +643,15 @@ _get_headertype_string(enum oonf_http_result type) {
  * @param session pointer to tcp session
  * @param code http result code
  * @param content_type explicit content type or NULL for
- * @param content_length length of content, 0 for no content length
  *   plain html
+ * @param etag entity tag of content, NULL if none
+ * @param weak_etag true if the entity tag is weak, because the content
+ *   is streamed and might change before it is complete
+ * @param content_length length of content, 0 for no content length
  */
 static void
-_create_http_header(
-  struct oonf_stream_session *session, enum oonf_http_result code, const char *content_type, size_t content_length) {
+_create_http_header(struct oonf_stream_session *session, enum oonf_http_result code, const char *content_type,
+  const char *etag, bool weak_etag, size_t content_length) {
   struct autobuf buf;
   struct timeval currtime;
 
@@ -610,6 +683,11 @@ _create_http_header(
     abuf_appendf(&buf, "Content-length: %zu\r\n", content_length);
   }
 
+  /* Entity tag */
+  if (etag != NULL) {
+    abuf_appendf(&buf, "%s: %s\"%s\"\r\n", HTTP_ETAG, weak_etag ? "W/" : "", etag);
+  }
+
   if (code == HTTP_401_UNAUTHORIZED) {
     abuf_appendf(&buf, "WWW-Authenticate: Basic realm=\"%s\"\r\n", "RealmName");
   }
@@ -629,6 +707,45 @@ _create_http_header(
   abuf_free(&buf);
 }
 
+/**
+ * Check if the If-None-Match header of a request contains an entity tag
+ * @param header http session
+ * @param etag entity tag without quotes
+ * @return true if the client already has the content with this tag
+ */
+static bool
+_is_etag_matching(struct oonf_http_session *header, const char *etag) {
+  const char *ptr;
+  size_t len;
+
+  ptr = oonf_http_lookup_header(header, HTTP_IF_NONE_MATCH);
+  if (ptr == NULL) {
+    return false;
+  }
+
+  len = strlen(etag);
+  while (ptr != NULL) {
+    /* skip separators */
+    while (*ptr == ' ' || *ptr == ',') {
+      ptr++;
+    }
+    if (*ptr == '*') {
+      return true;
+    }
+
+    /* weak comparison, ignore prefix of weak tags */
+    if (strncmp(ptr, "W/", 2) == 0) {
+      ptr += 2;
+    }
+    if (*ptr == '"' && strncmp(ptr + 1, etag, len) == 0 && ptr[len + 1] == '"') {
+      return true;
+    }
+
+    ptr = strchr(ptr, ',');
+  }
+  return false;
+}
+
 /**
  * Parse a HTTP header
  * @param header_data pointer to header data
@@ -877,6 +994,7 @@ _decode_uri(char *src) {
 static enum oonf_http_result
 _cb_telnet_handler(struct autobuf *out, struct oonf_http_session *session) {
   static char EOL = 0;
+  struct oonf_telnet_session *telnet;
   enum oonf_telnet_result result;
   char buffer[1024];
   char *ptr1, *ptr2, *ptr3;
@@ -900,12 +1018,25 @@ _cb_telnet_handler(struct autobuf *out, struct oonf_http_session *session) {
       ptr3 = &EOL;
     }
 
-    result = oonf_telnet_execute(ptr1, ptr3, out, session->remote);
+    if (ptr1 == buffer && ptr2 == NULL) {
+      /* single command, allow continous output */
+      telnet = (struct oonf_telnet_session *)session->stream;
+      result = oonf_telnet_execute_continous(ptr1, ptr3, telnet);
+      if (telnet->data.output_version[0]) {
+        session->etag = telnet->data.output_version;
+      }
+    }
+    else {
+      result = oonf_telnet_execute(ptr1, ptr3, out, session->remote);
+    }
     switch (result) {
       case TELNET_RESULT_ACTIVE:
       case TELNET_RESULT_QUIT:
         break;
 
+      case TELNET_RESULT_CONTINOUS:
+        return HTTP_START_STREAM;
+
       case _TELNET_RESULT_UNKNOWN_COMMAND:
         return HTTP_404_NOT_FOUND;
 
@@ -47,6 +47,7 @@
 #include <oonf/libcommon/avl_comp.h>
 #include <oonf/oonf.h>
 #include <oonf/libcommon/json.h>
+#include <oonf/libcommon/lpm_trie.h>
 #include <oonf/libcommon/netaddr.h>
 #include <oonf/libconfig/cfg_schema.h>
 #include <oonf/libconfig/cfg_validate.h>
@@ -191,6 +192,9 @@ static struct avl_tree _local_peer_ips_tree;
 
 static struct avl_tree _lid_tree;
 
+/* global longest prefix match trie of all layer2 neighbor addresses */
+static struct lpm_trie _neighbor_ip_trie;
+
 static uint32_t _lid_originator_count;
 
 /**
@@ -210,6 +214,7 @@ _init(void) {
   avl_init(&_oonf_originator_tree, avl_comp_strcasecmp, false);
   avl_init(&_local_peer_ips_tree, avl_comp_netaddr, true);
   avl_init(&_lid_tree, avl_comp_netaddr, false);
+  lpm_trie_init(&_neighbor_ip_trie);
 
   _lid_originator_count = 0;
   return 0;
@@ -230,6 +235,7 @@ _cleanup(void) {
     avl_remove(&_lid_tree, &lid->_node);
     oonf_class_free(&_lid_class, lid);
   }
+  lpm_trie_free(&_neighbor_ip_trie);
 
   oonf_class_remove(&_lid_class);
   oonf_class_remove(&_l2neigh_addr_class);
@@ -732,32 +738,16 @@ oonf_layer2_net_remove_ip(struct oonf_layer2_peer_address *ip, const struct oonf
 }
 
 /**
- * Look for the best matching prefix in all layer2 neighbor addresses
+ * Look for the longest prefix in all layer2 neighbor addresses
  * that contains a specific address
  * @param addr ip address to look for
  * @return layer2 neighbor address object, NULL if no match was found
  */
 struct oonf_layer2_neighbor_address *
 oonf_layer2_net_get_best_neighbor_match(const struct netaddr *addr) {
-  struct oonf_layer2_neighbor_address *best_match, *l2addr;
-  struct oonf_layer2_neigh *l2neigh;
-  struct oonf_layer2_net *l2net;
-  int prefix_length;
-
-  prefix_length = 256;
-  best_match = NULL;
+  struct oonf_layer2_neighbor_address *l2addr;
 
-  avl_for_each_element(&_oonf_layer2_net_tree, l2net, _node) {
-    avl_for_each_element(&l2net->neighbors, l2neigh, _node) {
-      avl_for_each_element(&l2neigh->remote_neighbor_ips, l2addr, _neigh_node) {
-        if (netaddr_is_in_subnet(&l2addr->ip, addr) && netaddr_get_prefix_length(&l2addr->ip) < prefix_length) {
-          best_match = l2addr;
-          prefix_length = netaddr_get_prefix_length(&l2addr->ip);
-        }
-      }
-    }
-  }
-  return best_match;
+  return lpm_trie_find_best_element(&_neighbor_ip_trie, addr, l2addr, _lpm_node);
 }
 
 /**
@@ -1044,6 +1034,13 @@ oonf_layer2_neigh_add_ip(
   /* set back reference */
   l2addr->l2neigh = l2neigh;
 
+  /* add to longest prefix match trie */
+  l2addr->_lpm_node.key = &l2addr->ip;
+  if (lpm_trie_insert(&_neighbor_ip_trie, &l2addr->_lpm_node)) {
+    oonf_class_free(&_l2neigh_addr_class, l2addr);
+    return NULL;
+  }
+
   /* add to tree */
   l2addr->_neigh_node.key = &l2addr->ip;
   avl_insert(&l2neigh->remote_neighbor_ips, &l2addr->_neigh_node);
@@ -1073,6 +1070,7 @@ oonf_layer2_neigh_remove_ip(struct oonf_layer2_neighbor_address *ip, const struc
 
   avl_remove(&ip->l2neigh->remote_neighbor_ips, &ip->_neigh_node);
   avl_remove(&ip->l2neigh->network->remote_neighbor_ips, &ip->_net_node);
+  lpm_trie_remove(&_neighbor_ip_trie, &ip->_lpm_node);
   oonf_class_free(&_l2neigh_addr_class, ip);
   return 0;
 }
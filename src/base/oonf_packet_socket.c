@@ -44,6 +44,7 @@
  */
 
 #include <errno.h>
+#include <stdlib.h>
 
 #include <oonf/libcommon/autobuf.h>
 #include <oonf/oonf.h>
@@ -67,6 +68,8 @@ static void _cleanup(void);
 static void _handle_errno1(struct oonf_packet_socket *pktsocket, union netaddr_socket *remote);
 
 static void _packet_add(struct oonf_packet_socket *pktsocket, union netaddr_socket *local, struct os_interface *os_if);
+static void _update_rx_buffers(struct oonf_packet_socket *pktsocket);
+static void _free_rx_buffers(struct oonf_packet_socket *pktsocket);
 static int _apply_managed(struct oonf_packet_managed *managed);
 static int _apply_managed_socketpair(int af_type, struct oonf_packet_managed *managed, struct os_interface *os_if,
   bool *changed, struct oonf_packet_socket *sock, struct oonf_packet_socket *mc_sock, struct netaddr *mc_ip);
@@ -75,6 +78,12 @@ static int _apply_managed_socket(struct oonf_packet_managed *managed, struct oon
 static void _cb_packet_event_unicast(struct oonf_socket_entry *);
 static void _cb_packet_event_multicast(struct oonf_socket_entry *);
 static void _cb_packet_event(struct oonf_socket_entry *, bool mc);
+static void _cb_packet_flush(struct oonf_socket_entry *);
+static void _send_queue(struct oonf_packet_socket *pktsocket);
+static void _receive_single(struct oonf_packet_socket *pktsocket, bool multicast);
+static void _receive_batch(struct oonf_packet_socket *pktsocket, bool multicast);
+static void _handle_incoming(
+  struct oonf_packet_socket *pktsocket, union netaddr_socket *from, uint8_t *buf, ssize_t length, bool multicast);
 static int _cb_interface_listener(struct os_interface_listener *l);
 
 /* subsystem definition */
@@ -169,6 +178,8 @@ _packet_add(struct oonf_packet_socket *pktsocket, union netaddr_socket *local, s
   pktsocket->os_if = interf;
   pktsocket->scheduler_entry.name = pktsocket->socket_name;
   pktsocket->scheduler_entry.process = _cb_packet_event_unicast;
+  pktsocket->scheduler_entry.flush = _cb_packet_flush;
+  pktsocket->_tx_coalesce = false;
 
   abuf_init(&pktsocket->out);
   list_add_tail(&_packet_sockets, &pktsocket->node);
@@ -184,6 +195,7 @@ _packet_add(struct oonf_packet_socket *pktsocket, union netaddr_socket *local, s
     pktsocket->config.input_buffer = _input_buffer;
     pktsocket->config.input_buffer_length = sizeof(_input_buffer);
   }
+  _update_rx_buffers(pktsocket);
 
   oonf_socket_add(&pktsocket->scheduler_entry);
   oonf_socket_set_read(&pktsocket->scheduler_entry, true);
@@ -202,6 +214,7 @@ oonf_packet_remove(struct oonf_packet_socket *pktsocket, bool force __attribute_
     oonf_socket_remove(&pktsocket->scheduler_entry);
     os_fd_close(&pktsocket->scheduler_entry.fd);
     abuf_free(&pktsocket->out);
+    _free_rx_buffers(pktsocket);
 
     list_remove(&pktsocket->node);
   }
@@ -209,7 +222,8 @@ oonf_packet_remove(struct oonf_packet_socket *pktsocket, bool force __attribute_
 
 /**
  * Send a data packet through a packet socket. The transmission might not
- * be happen synchronously if the socket would block.
+ * be happen synchronously if the socket would block or if the socket
+ * already sent a packet during the current scheduler iteration.
  * @param pktsocket pointer to packet socket
  * @param remote ip/address to send packet to
  * @param data pointer to data to be sent
@@ -221,7 +235,7 @@ oonf_packet_send(struct oonf_packet_socket *pktsocket, union netaddr_socket *rem
   int result;
   struct netaddr_str buf;
 
-  if (abuf_getlen(&pktsocket->out) == 0) {
+  if (abuf_getlen(&pktsocket->out) == 0 && !pktsocket->_tx_coalesce) {
     /* no backlog of outgoing packets, try to send directly */
     result = os_fd_sendto(&pktsocket->scheduler_entry.fd, data, length, remote, pktsocket->config.dont_route);
     if (result > 0) {
@@ -229,6 +243,12 @@ oonf_packet_send(struct oonf_packet_socket *pktsocket, union netaddr_socket *rem
       OONF_DEBUG(LOG_PACKET, "Sent %d bytes to %s %s", result, netaddr_socket_to_string(&buf, remote),
         pktsocket->os_if != NULL ? pktsocket->os_if->name : "");
       oonf_socket_register_direct_send(&pktsocket->scheduler_entry);
+
+      if (pktsocket->config.output_batch > 1) {
+        /* queue further packets of this scheduler iteration */
+        pktsocket->_tx_coalesce = true;
+        oonf_socket_register_flush(&pktsocket->scheduler_entry);
+      }
       return 0;
     }
 
@@ -252,6 +272,11 @@ oonf_packet_send(struct oonf_packet_socket *pktsocket, union netaddr_socket *rem
   /* append data */
   abuf_memcpy(&pktsocket->out, data, length);
 
+  if (pktsocket->_tx_coalesce) {
+    /* queue will be sent at the end of the scheduler iteration */
+    return 0;
+  }
+
   /* activate outgoing socket scheduler */
   oonf_socket_set_write(&pktsocket->scheduler_entry, true);
   return 0;
@@ -677,6 +702,13 @@ _apply_managed_socket(struct oonf_packet_managed *managed, struct oonf_packet_so
   if (list_is_node_added(&packet->node)) {
     if (data == packet->os_if && memcmp(&sock, &packet->local_socket, sizeof(sock)) == 0 &&
         protocol == packet->protocol) {
+      if (packet->config.input_batch != (size_t)managed->_managed_config.rx_batch) {
+        /* only the receive batch size changed, no need for a new socket */
+        packet->config.input_batch = managed->_managed_config.rx_batch;
+        _update_rx_buffers(packet);
+      }
+      packet->config.output_batch = managed->_managed_config.tx_batch;
+
       /* nothing changed */
       return 1;
     }
@@ -701,6 +733,8 @@ _apply_managed_socket(struct oonf_packet_managed *managed, struct oonf_packet_so
   if (packet->config.user == NULL) {
     packet->config.user = managed;
   }
+  packet->config.input_batch = managed->_managed_config.rx_batch;
+  packet->config.output_batch = managed->_managed_config.tx_batch;
 
   /* create new socket */
   if (protocol) {
@@ -751,98 +785,292 @@ _cb_packet_event_multicast(struct oonf_socket_entry *entry) {
  *   false otherwise
  */
 static void
-_cb_packet_event(struct oonf_socket_entry *entry, bool multicast __attribute__((unused))) {
+_cb_packet_event(struct oonf_socket_entry *entry, bool multicast) {
   struct oonf_packet_socket *pktsocket;
-  union netaddr_socket sock;
-  uint16_t length;
-  char *pkt;
-  ssize_t result;
-  struct netaddr_str netbuf;
-
-#ifdef OONF_LOG_DEBUG_INFO
-  const char *interf = "";
-#endif
 
   pktsocket = container_of(entry, typeof(*pktsocket), scheduler_entry);
 
-#ifdef OONF_LOG_DEBUG_INFO
-  if (pktsocket->os_if) {
-    interf = pktsocket->os_if->name;
-  }
-#endif
-
   if (oonf_socket_is_read(entry)) {
-    uint8_t *buf;
-
-    /* clear recvfrom memory */
-    memset(&sock, 0, sizeof(sock));
-
-    /* handle incoming data */
-    buf = pktsocket->config.input_buffer;
-
-    result = os_fd_recvfrom(&entry->fd, buf, pktsocket->config.input_buffer_length - 1, &sock, pktsocket->os_if);
-    if (result > 0 && pktsocket->config.receive_data != NULL) {
-      /* handle raw socket */
-      if (pktsocket->protocol) {
-        buf = os_fd_skip_rawsocket_prefix(buf, &result, pktsocket->local_socket.std.sa_family);
-        if (!buf) {
-          OONF_WARN(LOG_PACKET, "Error while skipping IP header for socket %s:",
-            netaddr_socket_to_string(&netbuf, &pktsocket->local_socket));
-          return;
-        }
-      }
-      /* null terminate it */
-      buf[result] = 0;
-
-      /* received valid packet */
-      OONF_DEBUG(LOG_PACKET, "Received %" PRINTF_SSIZE_T_SPECIFIER " bytes from %s %s (%s)", result,
-        netaddr_socket_to_string(&netbuf, &sock), interf, multicast ? "multicast" : "unicast");
-      pktsocket->config.receive_data(pktsocket, &sock, buf, result);
+    if (pktsocket->_rx_buffers) {
+      _receive_batch(pktsocket, multicast);
     }
-    else if (result < 0 && (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) {
-      OONF_WARN(LOG_PACKET, "Cannot read packet from socket %s: %s (%d)",
-        netaddr_socket_to_string(&netbuf, &pktsocket->local_socket), strerror(errno), errno);
+    else {
+      _receive_single(pktsocket, multicast);
     }
   }
 
-  if (oonf_socket_is_write(entry) && abuf_getlen(&pktsocket->out) > 0) {
-    /* handle outgoing data */
-    pkt = abuf_getptr(&pktsocket->out);
+  if (oonf_socket_is_write(entry)) {
+    _send_queue(pktsocket);
+  }
+}
 
-    /* copy remote socket */
-    memcpy(&sock, pkt, sizeof(sock));
-    pkt += sizeof(sock);
+/**
+ * Callback to send all packets queued during a scheduler iteration
+ * @param entry socket entry
+ */
+static void
+_cb_packet_flush(struct oonf_socket_entry *entry) {
+  struct oonf_packet_socket *pktsocket;
 
-    /* copy length */
-    memcpy(&length, pkt, 2);
-    pkt += 2;
+  pktsocket = container_of(entry, typeof(*pktsocket), scheduler_entry);
+  pktsocket->_tx_coalesce = false;
 
-    /* try to send packet */
-    result = os_fd_sendto(&entry->fd, pkt, length, &sock, pktsocket->config.dont_route);
+  if (abuf_getlen(&pktsocket->out) > 0) {
+    _send_queue(pktsocket);
+  }
+}
+
+/**
+ * Send the queued outgoing packets of a socket, multiple ones
+ * with a single system call if possible.
+ * @param pktsocket packet socket
+ */
+static void
+_send_queue(struct oonf_packet_socket *pktsocket) {
+  struct os_fd_datagram dgrams[OS_FD_MAX_BATCH];
+  size_t batch, count, offset, i;
+  uint16_t length;
+  uint8_t *pkt;
+  int result;
+  struct netaddr_str netbuf;
+
+  batch = pktsocket->config.output_batch;
+  if (batch < 1) {
+    batch = 1;
+  }
+  if (batch > OS_FD_MAX_BATCH) {
+    batch = OS_FD_MAX_BATCH;
+  }
+
+  while (abuf_getlen(&pktsocket->out) > 0) {
+    pkt = (uint8_t *)abuf_getptr(&pktsocket->out);
+
+    /* collect queued packets: remote socket, length and data */
+    count = 0;
+    offset = 0;
+    while (count < batch && offset < abuf_getlen(&pktsocket->out)) {
+      memcpy(&dgrams[count].remote, pkt + offset, sizeof(dgrams[count].remote));
+      offset += sizeof(dgrams[count].remote);
+
+      memcpy(&length, pkt + offset, 2);
+      offset += 2;
+
+      dgrams[count].buf = pkt + offset;
+      dgrams[count].buflen = length;
+      dgrams[count].length = length;
+      offset += length;
+      count++;
+    }
+
+    /* try to send packets, segmentation offload only works for UDP */
+    result = os_fd_sendto_batch(
+      &pktsocket->scheduler_entry.fd, dgrams, count, pktsocket->config.dont_route, pktsocket->protocol == 0);
     if (result < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
       /* try again later */
-      OONF_DEBUG(
-        LOG_PACKET, "Sending to %s %s could block, try again later", netaddr_socket_to_string(&netbuf, &sock), interf);
+      OONF_DEBUG(LOG_PACKET, "Sending to %s %s could block, try again later",
+        netaddr_socket_to_string(&netbuf, &dgrams[0].remote), pktsocket->os_if ? pktsocket->os_if->name : "");
+      oonf_socket_set_write(&pktsocket->scheduler_entry, true);
       return;
     }
 
     if (result < 0) {
-      /* display error message */
-      OONF_WARN(LOG_PACKET, "Cannot send UDP packet to %s: %s (%d)", netaddr_socket_to_string(&netbuf, &sock),
-        strerror(errno), errno);
+      /* display error message and drop the first packet */
+      OONF_WARN(LOG_PACKET, "Cannot send UDP packet to %s: %s (%d)",
+        netaddr_socket_to_string(&netbuf, &dgrams[0].remote), strerror(errno), errno);
+      result = 1;
     }
     else {
-      OONF_DEBUG(LOG_PACKET, "Sent %" PRINTF_SSIZE_T_SPECIFIER " bytes to %s %s", result,
-        netaddr_socket_to_string(&netbuf, &sock), interf);
+      OONF_DEBUG(LOG_PACKET, "Sent %d queued packets (of %" PRINTF_SIZE_T_SPECIFIER ") to %s", result, count,
+        pktsocket->os_if ? pktsocket->os_if->name : "");
     }
+
     /* remove data from outgoing buffer (both for success and for final error */
-    abuf_pull(&pktsocket->out, sizeof(sock) + 2 + length);
+    offset = 0;
+    for (i = 0; i < (size_t)result; i++) {
+      offset += sizeof(dgrams[i].remote) + 2 + dgrams[i].length;
+    }
+    abuf_pull(&pktsocket->out, offset);
+  }
+
+  /* nothing left to send, disable outgoing events */
+  oonf_socket_set_write(&pktsocket->scheduler_entry, false);
+}
+
+/**
+ * (Re)allocate the receive buffers for batched receiving
+ * according to the socket configuration
+ * @param pktsocket packet socket
+ */
+static void
+_update_rx_buffers(struct oonf_packet_socket *pktsocket) {
+  size_t batch;
+
+  _free_rx_buffers(pktsocket);
+
+  batch = pktsocket->config.input_batch;
+  if (batch > OS_FD_MAX_BATCH) {
+    batch = OS_FD_MAX_BATCH;
+  }
+  if (batch <= 1) {
+    /* use the input buffer of the configuration */
+    return;
   }
 
-  if (abuf_getlen(&pktsocket->out) == 0) {
-    /* nothing left to send, disable outgoing events */
-    oonf_socket_set_write(&pktsocket->scheduler_entry, false);
+  pktsocket->_rx_buffers = calloc(batch, pktsocket->config.input_buffer_length);
+  if (pktsocket->_rx_buffers == NULL) {
+    OONF_WARN(LOG_PACKET, "Not enough memory for %" PRINTF_SIZE_T_SPECIFIER " receive buffers of socket %s",
+      batch, pktsocket->socket_name);
+    return;
   }
+  pktsocket->_rx_batch = batch;
+}
+
+/**
+ * Release the receive buffers of a packet socket. Buffers used by
+ * a running batch receive are freed by _receive_batch() after the
+ * receive callback has returned.
+ * @param pktsocket packet socket
+ */
+static void
+_free_rx_buffers(struct oonf_packet_socket *pktsocket) {
+  if (pktsocket->_rx_busy) {
+    pktsocket->_rx_busy = false;
+  }
+  else {
+    free(pktsocket->_rx_buffers);
+  }
+  pktsocket->_rx_buffers = NULL;
+  pktsocket->_rx_batch = 0;
+}
+
+/**
+ * Receive a single datagram from a packet socket
+ * @param pktsocket packet socket
+ * @param multicast true if the multicast socket fired the event,
+ *   false otherwise
+ */
+static void
+_receive_single(struct oonf_packet_socket *pktsocket, bool multicast) {
+  union netaddr_socket sock;
+  struct netaddr_str netbuf;
+  ssize_t result;
+
+  /* clear recvfrom memory */
+  memset(&sock, 0, sizeof(sock));
+
+  result = os_fd_recvfrom(&pktsocket->scheduler_entry.fd, pktsocket->config.input_buffer,
+    pktsocket->config.input_buffer_length - 1, &sock, pktsocket->os_if);
+  if (result > 0) {
+    oonf_socket_register_recv_packets(&pktsocket->scheduler_entry, 1);
+    _handle_incoming(pktsocket, &sock, pktsocket->config.input_buffer, result, multicast);
+  }
+  else if (result < 0 && (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK)) {
+    OONF_WARN(LOG_PACKET, "Cannot read packet from socket %s: %s (%d)",
+      netaddr_socket_to_string(&netbuf, &pktsocket->local_socket), strerror(errno), errno);
+  }
+}
+
+/**
+ * Receive up to the configured batch size of datagrams from a
+ * packet socket with a single system call
+ * @param pktsocket packet socket
+ * @param multicast true if the multicast socket fired the event,
+ *   false otherwise
+ */
+static void
+_receive_batch(struct oonf_packet_socket *pktsocket, bool multicast) {
+  struct os_fd_datagram dgrams[OS_FD_MAX_BATCH];
+  struct netaddr_str netbuf;
+  uint8_t *buffers;
+  size_t i;
+  int result;
+
+  buffers = pktsocket->_rx_buffers;
+  for (i = 0; i < pktsocket->_rx_batch; i++) {
+    memset(&dgrams[i].remote, 0, sizeof(dgrams[i].remote));
+    dgrams[i].buf = buffers + i * pktsocket->config.input_buffer_length;
+
+    /* keep space for null termination */
+    dgrams[i].buflen = pktsocket->config.input_buffer_length - 1;
+    dgrams[i].length = 0;
+  }
+
+  result = os_fd_recvfrom_batch(&pktsocket->scheduler_entry.fd, dgrams, pktsocket->_rx_batch, pktsocket->os_if);
+  if (result < 0 && errno == ENOSYS) {
+    OONF_WARN(LOG_PACKET, "Batched receive not supported by kernel, disable it for socket %s",
+      netaddr_socket_to_string(&netbuf, &pktsocket->local_socket));
+
+    pktsocket->config.input_batch = 0;
+    _update_rx_buffers(pktsocket);
+    _receive_single(pktsocket, multicast);
+    return;
+  }
+  if (result < 0) {
+    if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) {
+      OONF_WARN(LOG_PACKET, "Cannot read packets from socket %s: %s (%d)",
+        netaddr_socket_to_string(&netbuf, &pktsocket->local_socket), strerror(errno), errno);
+    }
+    return;
+  }
+
+  OONF_DEBUG(LOG_PACKET, "Received %d packets with one call from socket %s", result,
+    netaddr_socket_to_string(&netbuf, &pktsocket->local_socket));
+  oonf_socket_register_recv_packets(&pktsocket->scheduler_entry, result);
+
+  pktsocket->_rx_busy = true;
+  for (i = 0; i < (size_t)result; i++) {
+    _handle_incoming(pktsocket, &dgrams[i].remote, dgrams[i].buf, dgrams[i].length, multicast);
+
+    if (!pktsocket->_rx_busy) {
+      /* socket was removed or reconfigured by the receive callback */
+      free(buffers);
+      return;
+    }
+  }
+  pktsocket->_rx_busy = false;
+}
+
+/**
+ * Hand a received datagram to the receive callback of a packet socket
+ * @param pktsocket packet socket
+ * @param from source of datagram
+ * @param buf pointer to datagram, must have space for an additional
+ *   terminating zero byte
+ * @param length length of datagram
+ * @param multicast true if datagram was received by a multicast socket
+ */
+static void
+_handle_incoming(struct oonf_packet_socket *pktsocket, union netaddr_socket *from, uint8_t *buf, ssize_t length,
+  bool multicast __attribute__((unused))) {
+  struct netaddr_str netbuf;
+#ifdef OONF_LOG_DEBUG_INFO
+  const char *interf = "";
+
+  if (pktsocket->os_if) {
+    interf = pktsocket->os_if->name;
+  }
+#endif
+
+  if (pktsocket->config.receive_data == NULL) {
+    return;
+  }
+
+  /* handle raw socket */
+  if (pktsocket->protocol) {
+    buf = os_fd_skip_rawsocket_prefix(buf, &length, pktsocket->local_socket.std.sa_family);
+    if (!buf) {
+      OONF_WARN(LOG_PACKET, "Error while skipping IP header for socket %s:",
+        netaddr_socket_to_string(&netbuf, &pktsocket->local_socket));
+      return;
+    }
+  }
+  /* null terminate it */
+  buf[length] = 0;
+
+  /* received valid packet */
+  OONF_DEBUG(LOG_PACKET, "Received %" PRINTF_SSIZE_T_SPECIFIER " bytes from %s %s (%s)", length,
+    netaddr_socket_to_string(&netbuf, from), interf, multicast ? "multicast" : "unicast");
+  pktsocket->config.receive_data(pktsocket, from, buf, length);
 }
 
 /**
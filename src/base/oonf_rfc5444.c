@@ -106,12 +106,8 @@ static bool _cb_single_target_selector(struct rfc5444_writer *, struct rfc5444_w
 static bool _cb_filtered_targets_selector(
   struct rfc5444_writer *writer, struct rfc5444_writer_target *rfc5444_target, void *ptr);
 
-static struct rfc5444_reader_addrblock_entry *_alloc_addrblock_entry(void);
-static struct rfc5444_reader_tlvblock_entry *_alloc_tlvblock_entry(void);
 static struct rfc5444_writer_address *_alloc_address_entry(void);
 static struct rfc5444_writer_addrtlv *_alloc_addrtlv_entry(void);
-static void _free_addrblock_entry(struct rfc5444_reader_addrblock_entry *addrblock);
-static void _free_tlvblock_entry(struct rfc5444_reader_tlvblock_entry *tlvblock);
 static void _free_address_entry(struct rfc5444_writer_address *);
 static void _free_addrtlv_entry(struct rfc5444_writer_addrtlv *);
 
@@ -138,18 +134,6 @@ static struct oonf_class _target_memcookie = {
   .size = sizeof(struct oonf_rfc5444_target),
 };
 
-static struct oonf_class _tlvblock_memcookie = {
-  .name = "RFC5444 TLVblock",
-  .size = sizeof(struct rfc5444_reader_tlvblock_entry),
-  .min_free_count = 32,
-};
-
-static struct oonf_class _addrblock_memcookie = {
-  .name = "RFC5444 Addrblock",
-  .size = sizeof(struct rfc5444_reader_addrblock_entry),
-  .min_free_count = 32,
-};
-
 static struct oonf_class _address_memcookie = {
   .name = "RFC5444 Address",
   .size = sizeof(struct rfc5444_writer_address),
@@ -201,6 +185,12 @@ static struct cfg_schema_entry _interface_entries[] = {
     _rfc5444_if_config, sock.rawip, "rawip", "false", "True if a raw IP socket should be used, false to use UDP"),
   CFG_MAP_INT32_MINMAX(
     _rfc5444_if_config, sock.ttl_multicast, "multicast_ttl", "1", "TTL value of outgoing multicast traffic", 0, 1, 255),
+  CFG_MAP_INT32_MINMAX(_rfc5444_if_config, sock.rx_batch, "rx_batch", "16",
+    "Maximum number of packets read from a socket with a single system call, 1 to disable batching", 0, 1,
+    OS_FD_MAX_BATCH),
+  CFG_MAP_INT32_MINMAX(_rfc5444_if_config, sock.tx_batch, "tx_batch", "16",
+    "Maximum number of packets sent to a socket with a single system call, 1 to disable batching", 0, 1,
+    OS_FD_MAX_BATCH),
   CFG_MAP_CLOCK(_rfc5444_if_config, aggregation_interval, "aggregation_interval", "0.100",
     "Interval in seconds for message aggregation"),
 
@@ -218,10 +208,6 @@ static struct cfg_schema_section _interface_section = {
 /* rfc5444 handling */
 static const struct rfc5444_reader _reader_template = {
   .forward_message = _cb_forward_message,
-  .malloc_addrblock_entry = _alloc_addrblock_entry,
-  .malloc_tlvblock_entry = _alloc_tlvblock_entry,
-  .free_addrblock_entry = _free_addrblock_entry,
-  .free_tlvblock_entry = _free_tlvblock_entry,
 };
 static const struct rfc5444_writer _writer_template = {
   .malloc_address_entry = _alloc_address_entry,
@@ -236,12 +222,7 @@ static const struct rfc5444_writer _writer_template = {
 static struct autobuf _printer_buffer;
 static struct rfc5444_print_session _printer_session;
 
-static struct rfc5444_reader _printer = {
-  .malloc_addrblock_entry = _alloc_addrblock_entry,
-  .malloc_tlvblock_entry = _alloc_tlvblock_entry,
-  .free_addrblock_entry = _free_addrblock_entry,
-  .free_tlvblock_entry = _free_tlvblock_entry,
-};
+static struct rfc5444_reader _printer;
 
 /* configuration for RFC5444 socket */
 static uint8_t _incoming_buffer[RFC5444_MAX_PACKET_SIZE];
@@ -295,14 +276,12 @@ _init(void) {
 
   oonf_class_add(&_protocol_memcookie);
   oonf_class_add(&_target_memcookie);
-  oonf_class_add(&_addrblock_memcookie);
-  oonf_class_add(&_tlvblock_memcookie);
   oonf_class_add(&_address_memcookie);
   oonf_class_add(&_addrtlv_memcookie);
 
   oonf_timer_add(&_aggregation_timer);
 
-  _rfc5444_protocol = oonf_rfc5444_add_protocol("rfc5444_iana", true);
+  _rfc5444_protocol = oonf_rfc5444_add_protocol(RFC5444_PROTOCOL, true);
   if (_rfc5444_protocol == NULL) {
     _cleanup();
     return -1;
@@ -370,8 +349,6 @@ _cleanup(void) {
   oonf_class_remove(&_protocol_memcookie);
   oonf_class_remove(&_interface_memcookie);
   oonf_class_remove(&_target_memcookie);
-  oonf_class_remove(&_tlvblock_memcookie);
-  oonf_class_remove(&_addrblock_memcookie);
   oonf_class_remove(&_address_memcookie);
   oonf_class_remove(&_addrtlv_memcookie);
   return;
@@ -1260,24 +1237,6 @@ _cb_filtered_targets_selector(struct rfc5444_writer *writer, struct rfc5444_writ
   return true;
 }
 
-/**
- * Internal memory allocation function for addrblock
- * @return pointer to cleared addrblock
- */
-static struct rfc5444_reader_addrblock_entry *
-_alloc_addrblock_entry(void) {
-  return oonf_class_malloc(&_addrblock_memcookie);
-}
-
-/**
- * Internal memory allocation function for rfc5444_reader_tlvblock_entry
- * @return pointer to cleared rfc5444_reader_tlvblock_entry
- */
-static struct rfc5444_reader_tlvblock_entry *
-_alloc_tlvblock_entry(void) {
-  return oonf_class_malloc(&_tlvblock_memcookie);
-}
-
 /**
  * Internal memory allocation function for rfc5444_writer_address
  * @return pointer to cleared rfc5444_writer_address
@@ -1296,24 +1255,6 @@ _alloc_addrtlv_entry(void) {
   return oonf_class_malloc(&_addrtlv_memcookie);
 }
 
-/**
- * Free an addrblock entry
- * @param addrblock addressblock to be freed
- */
-static void
-_free_addrblock_entry(struct rfc5444_reader_addrblock_entry *addrblock) {
-  oonf_class_free(&_addrblock_memcookie, addrblock);
-}
-
-/**
- * Free a tlvblock entry
- * @param tlvblock tlvblock to be freed
- */
-static void
-_free_tlvblock_entry(struct rfc5444_reader_tlvblock_entry *tlvblock) {
-  oonf_class_free(&_tlvblock_memcookie, tlvblock);
-}
-
 /**
  * Free an address
  * @param address address to be freed
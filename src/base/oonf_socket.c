@@ -69,6 +69,7 @@ static void _initiate_shutdown(void);
 
 static bool _shall_end_scheduler(void);
 static int _handle_scheduling(void);
+static void _flush_sockets(void);
 
 /* time until the scheduler should run */
 static uint64_t _scheduler_time_limit;
@@ -76,6 +77,9 @@ static uint64_t _scheduler_time_limit;
 /* List of all active sockets in scheduler */
 static struct list_entity _socket_head;
 
+/* List of all sockets with queued data waiting for a flush */
+static struct list_entity _flush_head;
+
 /* socket event scheduler */
 struct os_fd_select _socket_events;
 
@@ -106,6 +110,7 @@ _init(void) {
   }
 
   list_init_head(&_socket_head);
+  list_init_head(&_flush_head);
   os_fd_event_add(&_socket_events);
 
   _scheduler_time_limit = ~0ull;
@@ -122,6 +127,9 @@ _cleanup(void) {
 
   list_for_each_element_safe(&_socket_head, entry, _node, iterator) {
     list_remove(&entry->_node);
+    if (list_is_node_added(&entry->_flush_node)) {
+      list_remove(&entry->_flush_node);
+    }
     os_fd_close(&entry->fd);
   }
 
@@ -160,6 +168,9 @@ oonf_socket_remove(struct oonf_socket_entry *entry) {
     list_remove(&entry->_node);
     os_fd_event_socket_remove(&_socket_events, &entry->fd);
   }
+  if (list_is_node_added(&entry->_flush_node)) {
+    list_remove(&entry->_flush_node);
+  }
 }
 
 /**
@@ -188,6 +199,33 @@ oonf_socket_set_write(struct oonf_socket_entry *entry, bool event_write) {
   os_fd_event_socket_write(&_socket_events, &entry->fd, event_write);
 }
 
+/**
+ * Request a call of the flush callback of a socket at the end
+ * of the current scheduler iteration
+ * @param entry socket entry
+ */
+void
+oonf_socket_register_flush(struct oonf_socket_entry *entry) {
+  if (entry->flush != NULL && !list_is_node_added(&entry->_flush_node)) {
+    list_add_tail(&_flush_head, &entry->_flush_node);
+  }
+}
+
+/**
+ * Call the flush callback of all sockets with queued data
+ */
+static void
+_flush_sockets(void) {
+  struct oonf_socket_entry *entry;
+
+  while (!list_is_empty(&_flush_head)) {
+    entry = list_first_element(&_flush_head, entry, _flush_node);
+    list_remove(&entry->_flush_node);
+
+    entry->flush(entry);
+  }
+}
+
 /**
  * @return true if scheduler should stop
  */
@@ -220,6 +258,9 @@ _handle_scheduling(void) {
 
     oonf_timer_walk();
 
+    /* send everything queued by timer and socket callbacks */
+    _flush_sockets();
+
     if (_shall_end_scheduler()) {
       return 0;
     }
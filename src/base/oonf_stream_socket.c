@@ -306,9 +306,10 @@ connect_to_error:
 }
 
 /**
- * Reset the session timeout of a TCP session
+ * Reset the session timeout of a TCP session. A timeout of 0
+ * disables the timeout of the session until it is set again.
  * @param con pointer to stream session
- * @param timeout timeout in milliseconds
+ * @param timeout timeout in milliseconds, 0 to disable
  */
 void
 oonf_stream_set_timeout(struct oonf_stream_session *con, uint64_t timeout) {
@@ -767,7 +768,7 @@ _cb_parse_connection(struct oonf_socket_entry *entry) {
         }
         session->state = STREAM_SESSION_SEND_AND_QUIT;
       }
-      else {
+      else if (oonf_timer_is_active(&session->timeout)) {
         /* got new input block, reset timeout */
         oonf_stream_set_timeout(session, s_sock->config.session_timeout);
       }
@@ -804,7 +805,9 @@ _cb_parse_connection(struct oonf_socket_entry *entry) {
       if (len > 0) {
         OONF_DEBUG(LOG_STREAM, "  send returned %d\n", len);
         abuf_pull(&session->out, len);
-        oonf_stream_set_timeout(session, s_sock->config.session_timeout);
+        if (oonf_timer_is_active(&session->timeout)) {
+          oonf_stream_set_timeout(session, s_sock->config.session_timeout);
+        }
       }
       else if (len < 0 && errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) {
         OONF_WARN(LOG_STREAM, "Error while writing to communication stream with %s: %s (%d)\n",
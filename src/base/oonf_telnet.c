@@ -80,6 +80,7 @@ static int _cb_telnet_init(struct oonf_stream_session *);
 static void _cb_telnet_cleanup(struct oonf_stream_session *);
 static void _cb_telnet_create_error(struct oonf_stream_session *, enum oonf_stream_errors);
 static enum oonf_stream_session_state _cb_telnet_receive_data(struct oonf_stream_session *);
+static enum oonf_stream_session_state _cb_telnet_buffer_underrun(struct oonf_stream_session *);
 static enum oonf_telnet_result _telnet_handle_command(struct oonf_telnet_data *);
 static struct oonf_telnet_command *_check_telnet_command_acl(
   struct oonf_telnet_data *data, struct oonf_telnet_command *cmd);
@@ -160,6 +161,7 @@ static struct oonf_stream_managed _telnet_managed = {
       .init_session = _cb_telnet_init,
       .cleanup_session = _cb_telnet_cleanup,
       .receive_data = _cb_telnet_receive_data,
+      .buffer_underrun = _cb_telnet_buffer_underrun,
       .create_error = _cb_telnet_create_error,
     },
 };
@@ -272,6 +274,57 @@ oonf_telnet_execute(const char *cmd, const char *para, struct autobuf *out, stru
   return abuf_has_failed(session.data.out) ? TELNET_RESULT_INTERNAL_ERROR : result;
 }
 
+/**
+ * Execute a telnet command on a stream session of another service.
+ * If the command results in continous output, the session keeps
+ * the command running until oonf_telnet_cleanup_session() is called.
+ * @param cmd pointer to name of command
+ * @param para pointer to parameter string
+ * @param session telnet session, the stream part must be initialized
+ * @return result of telnet command
+ */
+enum oonf_telnet_result
+oonf_telnet_execute_continous(const char *cmd, const char *para, struct oonf_telnet_session *session)
+{
+  enum oonf_telnet_result result;
+
+  _cb_telnet_init(&session->session);
+  session->data.allow_streaming = true;
+  session->data.command = cmd;
+  session->data.parameter = para;
+
+  result = _telnet_handle_command(&session->data);
+  if (abuf_has_failed(session->data.out)) {
+    result = TELNET_RESULT_INTERNAL_ERROR;
+  }
+  if (result != TELNET_RESULT_CONTINOUS) {
+    oonf_telnet_cleanup_session(session);
+  }
+  return result;
+}
+
+/**
+ * Stop the continous output of a telnet session and call all its
+ * cleanup handlers.
+ * @param session telnet session
+ */
+void
+oonf_telnet_cleanup_session(struct oonf_telnet_session *session) {
+  struct oonf_telnet_cleanup *handler, *it;
+
+  /* stop continuous commands */
+  oonf_telnet_stop(&session->data, false);
+
+  /* call all cleanup handlers */
+  list_for_each_element_safe(&session->data.cleanup_list, handler, node, it) {
+    /* remove from list first */
+    oonf_telnet_remove_cleanup(handler);
+
+    /* after this command the handler pointer might not be valid anymore */
+    handler->cleanup_handler(handler);
+  }
+}
+
 /**
  * AVL tree comparator for first word in case insensitive strings.
  * @param ptr1 pointer to string 1
@@ -282,19 +335,17 @@ static int
 _avl_comp_strcmdword(const void *ptr1, const void *ptr2) {
   const char *txt1 = ptr1;
   const char *txt2 = ptr2;
-  int diff;
 
-  do {
-    diff = (int)(*txt1) - (int)(*txt2);
-    if (diff != 0 || *txt1 == ' ' || *txt2 == ' ') {
-      break;
-    }
-  } while (*txt1++ != 0 && *txt2++ != 0);
+  /* do not step over the terminating zero of equal words */
+  while (*txt1 == *txt2 && *txt1 != 0 && *txt1 != ' ') {
+    txt1++;
+    txt2++;
+  }
 
-  if ((*txt1 == ' ' && *txt2 == 0) || (*txt1 == 0 && *txt2 == ' ')) {
-    diff = 0;
+  if ((*txt1 == ' ' || *txt1 == 0) && (*txt2 == ' ' || *txt2 == 0)) {
+    return 0;
   }
-  return diff;
+  return (int)(*txt1) - (int)(*txt2);
 }
 
 /**
@@ -311,6 +362,9 @@ _cb_telnet_init(struct oonf_stream_session *session) {
 
   telnet_session->data.show_echo = true;
   telnet_session->data.stop_handler = NULL;
+  telnet_session->data.underrun_handler = NULL;
+  telnet_session->data.allow_streaming = false;
+  telnet_session->data.output_version[0] = 0;
   telnet_session->data.timeout_value = 120000;
   telnet_session->data.out = &telnet_session->session.out;
   telnet_session->data.remote = &telnet_session->session.remote_address;
@@ -326,23 +380,8 @@ _cb_telnet_init(struct oonf_stream_session *session) {
  */
 static void
 _cb_telnet_cleanup(struct oonf_stream_session *session) {
-  struct oonf_telnet_session *telnet_session;
-  struct oonf_telnet_cleanup *handler, *it;
-
   /* get telnet session pointer */
-  telnet_session = (struct oonf_telnet_session *)session;
-
-  /* stop continuous commands */
-  oonf_telnet_stop(&telnet_session->data, false);
-
-  /* call all cleanup handlers */
-  list_for_each_element_safe(&telnet_session->data.cleanup_list, handler, node, it) {
-    /* remove from list first */
-    oonf_telnet_remove_cleanup(handler);
-
-    /* after this command the handler pointer might not be valid anymore */
-    handler->cleanup_handler(handler);
-  }
+  oonf_telnet_cleanup_session((struct oonf_telnet_session *)session);
 }
 
 /**
@@ -381,6 +420,7 @@ _call_stop_handler(struct oonf_telnet_data *data) {
      */
     stop_handler = data->stop_handler;
     data->stop_handler = NULL;
+    data->underrun_handler = NULL;
 
     /* call stop handler */
     stop_handler(data);
@@ -448,6 +488,7 @@ _cb_telnet_receive_data(struct oonf_stream_session *session) {
 
       /* if we are doing continous output, stop it ! */
       _call_stop_handler(&telnet_session->data);
+      telnet_session->data.show_echo = true;
 
       if (strlen(cmd) != 0) {
         OONF_DEBUG(LOG_TELNET, "Processing telnet command: '%s' '%s'", cmd, para);
@@ -462,6 +503,10 @@ _cb_telnet_receive_data(struct oonf_stream_session *session) {
           telnet_session->data.parameter = para;
         }
 
+        /* command chains are sent in one piece */
+        telnet_session->data.allow_streaming = !chainCommands;
+        telnet_session->data.output_version[0] = 0;
+
         cmd_result = _telnet_handle_command(&telnet_session->data);
         if (abuf_has_failed(telnet_session->data.out)) {
           cmd_result = TELNET_RESULT_INTERNAL_ERROR;
@@ -513,7 +558,28 @@ _cb_telnet_receive_data(struct oonf_stream_session *session) {
     abuf_puts(&session->out, "> ");
   }
 
-  return STREAM_SESSION_ACTIVE;
+  /* keep the state if the remote side has already closed the stream */
+  return session->state;
+}
+
+/**
+ * Handler for an empty output buffer of a telnet session
+ * @param session pointer to TCP session
+ * @return TCP session state
+ */
+static enum oonf_stream_session_state
+_cb_telnet_buffer_underrun(struct oonf_stream_session *session) {
+  struct oonf_telnet_session *telnet_session;
+
+  /* get telnet session pointer */
+  telnet_session = (struct oonf_telnet_session *)session;
+
+  if (telnet_session->data.underrun_handler != NULL && telnet_session->data.underrun_handler(&telnet_session->data)) {
+    /* streamed command is finished, end it like a normal command */
+    abuf_puts(&session->out, "\n");
+    oonf_telnet_stop(&telnet_session->data, true);
+  }
+  return session->state;
 }
 
 /**
@@ -726,6 +792,9 @@ _cb_telnet_repeat(struct oonf_telnet_data *data) {
     data->stop_data[2] = ptr;
   }
 
+  /* repeated commands must generate their output in one piece */
+  data->allow_streaming = false;
+
   /* start command the first time */
   data->command = data->stop_data[1];
   data->parameter = data->stop_data[2];
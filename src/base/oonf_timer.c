@@ -49,6 +49,7 @@
 
 #include <oonf/libcommon/avl.h>
 #include <oonf/oonf.h>
+#include <oonf/libcommon/timing_wheel.h>
 #include <oonf/libcore/oonf_logging.h>
 #include <oonf/libcore/oonf_subsystem.h>
 #include <oonf/libcore/os_core.h>
@@ -65,10 +66,21 @@ static int _init(void);
 static void _cleanup(void);
 
 static void _calc_clock(struct oonf_timer_instance *timer, uint64_t rel_time);
+static void _queue_add(struct oonf_timer_instance *timer);
+static void _queue_remove(struct oonf_timer_instance *timer);
+static struct oonf_timer_instance *_queue_get_due(void);
+
+#ifdef OONF_TIMER_WHEEL
+static void _cb_remove_class_timer(struct timing_wheel_node *node, void *data);
+
+/* hierarchical timing wheel of all timers, one tick is one timeslice */
+static struct timing_wheel _timer_wheel;
+#else
 static int _avlcomp_timer(const void *p1, const void *p2);
 
 /* tree of all timers */
 static struct avl_tree _timer_tree;
+#endif
 
 /* true if scheduler is active */
 static bool _scheduling_now;
@@ -98,7 +110,11 @@ int
 _init(void) {
   OONF_INFO(LOG_TIMER, "Initializing timer scheduler.\n");
 
+#ifdef OONF_TIMER_WHEEL
+  timing_wheel_init(&_timer_wheel, oonf_clock_getNow() / OONF_TIMER_SLICE);
+#else
   avl_init(&_timer_tree, _avlcomp_timer, true);
+#endif
   _scheduling_now = false;
 
   list_init_head(&_timer_info_list);
@@ -134,18 +150,24 @@ oonf_timer_add(struct oonf_timer_class *ti) {
  */
 void
 oonf_timer_remove(struct oonf_timer_class *info) {
+#ifndef OONF_TIMER_WHEEL
   struct oonf_timer_instance *timer, *iterator;
+#endif
 
   if (!list_is_node_added(&info->_node)) {
     /* only free node if its hooked to the timer core */
     return;
   }
 
+#ifdef OONF_TIMER_WHEEL
+  timing_wheel_walk(&_timer_wheel, _cb_remove_class_timer, info);
+#else
   avl_for_each_element_safe(&_timer_tree, timer, _node, iterator) {
     if (timer->class == info) {
       oonf_timer_stop(timer);
     }
   }
+#endif
 
   list_remove(&info->_node);
 }
@@ -163,11 +185,10 @@ oonf_timer_start_ext(struct oonf_timer_instance *timer, uint64_t first, uint64_t
 #endif
 
   if (timer->_clock) {
-    avl_remove(&_timer_tree, &timer->_node);
+    _queue_remove(timer);
     timer->class->_stat_changes++;
   }
   else {
-    timer->_node.key = timer;
     timer->class->_stat_usage++;
   }
 
@@ -187,8 +208,8 @@ oonf_timer_start_ext(struct oonf_timer_instance *timer, uint64_t first, uint64_t
   /* Singleshot or periodical timer ? */
   timer->_period = timer->class->periodic ? interval : 0;
 
-  /* insert into tree */
-  avl_insert(&_timer_tree, &timer->_node);
+  /* insert into timer queue */
+  _queue_add(timer);
 
   OONF_DEBUG(LOG_TIMER, "TIMER: start timer '%s' firing in %s (%" PRIu64 ")\n", timer->class->name,
     oonf_clock_toClockString(&timebuf1, first), timer->_clock);
@@ -206,8 +227,8 @@ oonf_timer_stop(struct oonf_timer_instance *timer) {
 
   OONF_DEBUG(LOG_TIMER, "TIMER: stop %s\n", timer->class->name);
 
-  /* remove timer from tree */
-  avl_remove(&_timer_tree, &timer->_node);
+  /* remove timer from timer queue */
+  _queue_remove(timer);
   timer->_clock = 0;
   timer->_random = 0;
   timer->class->_stat_usage--;
@@ -250,13 +271,11 @@ oonf_timer_walk(void) {
 
   _scheduling_now = true;
 
-  while (!avl_is_empty(&_timer_tree)) {
-    timer = avl_first_element(&_timer_tree, timer, _node);
-
-    if (timer->_clock > oonf_clock_getNow()) {
-      break;
-    }
+#ifdef OONF_TIMER_WHEEL
+  timing_wheel_advance(&_timer_wheel, oonf_clock_getNow() / OONF_TIMER_SLICE);
+#endif
 
+  while ((timer = _queue_get_due()) != NULL) {
     OONF_DEBUG(LOG_TIMER, "TIMER: fire '%s' at clocktick %" PRIu64 "\n", timer->class->name, timer->_clock);
 
     /*
@@ -309,6 +328,20 @@ oonf_timer_walk(void) {
  */
 uint64_t
 oonf_timer_getNextEvent(void) {
+#ifdef OONF_TIMER_WHEEL
+  uint64_t next;
+
+  /*
+   * this might be earlier than the real next event if the next timer
+   * is still in a higher level of the wheel, the scheduler will cascade
+   * the wheel at this time and ask again
+   */
+  next = timing_wheel_get_next(&_timer_wheel);
+  if (next == UINT64_MAX) {
+    return UINT64_MAX;
+  }
+  return next * OONF_TIMER_SLICE;
+#else
   struct oonf_timer_instance *first;
 
   if (avl_is_empty(&_timer_tree)) {
@@ -317,6 +350,7 @@ oonf_timer_getNextEvent(void) {
 
   first = avl_first_element(&_timer_tree, first, _node);
   return first->_clock;
+#endif
 }
 
 /**
@@ -358,6 +392,91 @@ _calc_clock(struct oonf_timer_instance *timer, uint64_t rel_time) {
   timer->_clock -= (timer->_clock % OONF_TIMER_SLICE);
 }
 
+#ifdef OONF_TIMER_WHEEL
+/**
+ * Add a timer to the timing wheel
+ * @param timer timer instance with initialized clock
+ */
+static void
+_queue_add(struct oonf_timer_instance *timer) {
+  timer->_wheel_node.key = timer->_clock / OONF_TIMER_SLICE;
+  timing_wheel_insert(&_timer_wheel, &timer->_wheel_node);
+}
+
+/**
+ * Remove a timer from the timing wheel
+ * @param timer timer instance
+ */
+static void
+_queue_remove(struct oonf_timer_instance *timer) {
+  timing_wheel_remove(&_timer_wheel, &timer->_wheel_node);
+}
+
+/**
+ * @return next timer which is due to fire, NULL if no timer is due
+ */
+static struct oonf_timer_instance *
+_queue_get_due(void) {
+  struct oonf_timer_instance *timer;
+
+  if (!timing_wheel_has_expired(&_timer_wheel)) {
+    return NULL;
+  }
+  return timing_wheel_first_expired(&_timer_wheel, timer, _wheel_node);
+}
+
+/**
+ * Callback for walking the timing wheel to stop all timers of a class
+ * @param node timing wheel node of timer
+ * @param data pointer to timer class
+ */
+static void
+_cb_remove_class_timer(struct timing_wheel_node *node, void *data) {
+  struct oonf_timer_instance *timer;
+
+  timer = container_of(node, struct oonf_timer_instance, _wheel_node);
+  if (timer->class == data) {
+    oonf_timer_stop(timer);
+  }
+}
+#else
+/**
+ * Add a timer to the timer tree
+ * @param timer timer instance with initialized clock
+ */
+static void
+_queue_add(struct oonf_timer_instance *timer) {
+  timer->_node.key = timer;
+  avl_insert(&_timer_tree, &timer->_node);
+}
+
+/**
+ * Remove a timer from the timer tree
+ * @param timer timer instance
+ */
+static void
+_queue_remove(struct oonf_timer_instance *timer) {
+  avl_remove(&_timer_tree, &timer->_node);
+}
+
+/**
+ * @return next timer which is due to fire, NULL if no timer is due
+ */
+static struct oonf_timer_instance *
+_queue_get_due(void) {
+  struct oonf_timer_instance *timer;
+
+  if (avl_is_empty(&_timer_tree)) {
+    return NULL;
+  }
+
+  timer = avl_first_element(&_timer_tree, timer, _node);
+  if (timer->_clock > oonf_clock_getNow()) {
+    return NULL;
+  }
+  return timer;
+}
+
 /**
  * Custom AVL comparator for two timer entries.
  * @param p1 first timer entry
@@ -379,3 +498,4 @@ _avlcomp_timer(const void *p1, const void *p2) {
   }
   return 0;
 }
+#endif
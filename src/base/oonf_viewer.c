@@ -48,16 +48,79 @@
 #include <oonf/oonf.h>
 #include <oonf/libcommon/json.h>
 #include <oonf/libcommon/template.h>
+#include <oonf/libcore/oonf_logging.h>
 #include <oonf/libcore/oonf_subsystem.h>
-#include <oonf/base/oonf_telnet.h> /* compile-time dependency */
+#include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_telnet.h>
 
 /* Definitions */
 #define LOG_VIEWER _oonf_viewer_subsystem.logging
 
+/**
+ * Listener for the class events of a viewer template
+ */
+struct _viewer_listener {
+  /*! class extension to receive events */
+  struct oonf_class_extension ext;
+
+  /*! viewer template of the listener */
+  struct oonf_viewer_template *template;
+
+  /*! list of subscribers of this template */
+  struct list_entity subscribers;
+
+  /*! node for global list of listeners */
+  struct list_entity _node;
+};
+
+/**
+ * Subscription of a telnet session to one or more viewer templates
+ */
+struct _viewer_subscription {
+  /*! telnet session of subscription */
+  struct oonf_telnet_data *telnet;
+
+  /*! true if isonumbers should be raw */
+  bool raw;
+
+  /*! number of changes dropped because of a full output buffer */
+  uint64_t dropped;
+
+  /*! list of subscribed templates */
+  struct list_entity subscribers;
+};
+
+/**
+ * Subscription to a single viewer template
+ */
+struct _viewer_subscriber {
+  /*! subscription this subscriber belongs to */
+  struct _viewer_subscription *subscription;
+
+  /*! listener of the subscribed template */
+  struct _viewer_listener *listener;
+
+  /*! node for list of subscribers of a listener */
+  struct list_entity _listener_node;
+
+  /*! node for list of subscribers of a subscription */
+  struct list_entity _subscription_node;
+};
+
 /* static function prototypes */
 static int _init(void);
 static void _cleanup(void);
 
+static enum oonf_telnet_result _telnet_subscribe(
+  struct oonf_telnet_data *con, const char *cmd, const char *param, struct oonf_viewer_template *templates, size_t count);
+static int _add_subscriber(struct _viewer_subscription *subscription, struct oonf_viewer_template *template);
+static void _remove_subscription(struct _viewer_subscription *subscription);
+static void _print_event(
+  struct _viewer_subscription *subscription, struct oonf_viewer_template *template, const char *event, void *ptr);
+static void _print_event_line(struct oonf_viewer_template *template);
+static void _cb_subscription_stophandler(struct oonf_telnet_data *data);
+static void _cb_class_event(struct oonf_class_extension *ext, void *ptr, enum oonf_class_event evt);
+
 /* Template call help text for telnet */
 static const char _telnet_help[] = "\n"
                                    "Use '" OONF_VIEWER_JSON_FORMAT "' as the first parameter"
@@ -70,22 +133,56 @@ static const char _telnet_help[] = "\n"
                                    "Use '" OONF_VIEWER_RAW_FORMAT "' as the first parameter to"
                                    " generate a headline for the table without isoprefixes for numbers.\n"
                                    "You can also add a custom template (text with keys inside)"
-                                   " as the last parameter instead.\n";
+                                   " as the last parameter instead.\n"
+                                   "Use '" OONF_VIEWER_SUBSCRIBE_FORMAT "' (or '" OONF_VIEWER_SUBSCRIBE_RAW_FORMAT "')"
+                                   " followed by one or more subcommands to get their current content"
+                                   " and all later changes as one JSON object per line.\n";
 
 /* subsystem definition */
+static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
+  OONF_TELNET_SUBSYSTEM,
+};
+
 static struct oonf_subsystem _oonf_viewer_subsystem = {
   .name = OONF_VIEWER_SUBSYSTEM,
+  .dependencies = _dependencies,
+  .dependencies_count = ARRAYSIZE(_dependencies),
   .init = _init,
   .cleanup = _cleanup,
 };
 DECLARE_OONF_PLUGIN(_oonf_viewer_subsystem);
 
+/* memory for subscriptions */
+static struct oonf_class _listener_class = {
+  .name = "viewer listener",
+  .size = sizeof(struct _viewer_listener),
+};
+
+static struct oonf_class _subscription_class = {
+  .name = "viewer subscription",
+  .size = sizeof(struct _viewer_subscription),
+};
+
+static struct oonf_class _subscriber_class = {
+  .name = "viewer subscriber",
+  .size = sizeof(struct _viewer_subscriber),
+};
+
+/* list of templates with subscribers */
+static struct list_entity _listener_list;
+
 /**
  * Initialize telnet subsystem
  * @return always returns 0
  */
 static int
 _init(void) {
+  oonf_class_add(&_listener_class);
+  oonf_class_add(&_subscription_class);
+  oonf_class_add(&_subscriber_class);
+
+  list_init_head(&_listener_list);
   return 0;
 }
 
@@ -93,7 +190,21 @@ _init(void) {
  * Cleanup all allocated data of telnet subsystem
  */
 static void
-_cleanup(void) {}
+_cleanup(void) {
+  struct _viewer_listener *listener;
+  struct _viewer_subscriber *subscriber;
+
+  /* stop all subscriptions */
+  while (!list_is_empty(&_listener_list)) {
+    listener = list_first_element(&_listener_list, listener, _node);
+    subscriber = list_first_element(&listener->subscribers, subscriber, _listener_node);
+    oonf_telnet_stop(subscriber->subscription->telnet, false);
+  }
+
+  oonf_class_remove(&_subscriber_class);
+  oonf_class_remove(&_subscription_class);
+  oonf_class_remove(&_listener_class);
+}
 
 /**
  * Prepare a viewer template for output. The create_json and
@@ -142,7 +253,11 @@ oonf_viewer_output_prepare(struct oonf_viewer_template *template, struct abuf_te
  */
 void
 oonf_viewer_output_print_line(struct oonf_viewer_template *template) {
-  if (!template->create_json) {
+  if (template->_event) {
+    /* single line JSON for subscriptions */
+    _print_event_line(template);
+  }
+  else if (!template->create_json) {
     abuf_add_template(template->out, template->_storage, false);
     abuf_puts(template->out, "\n");
   }
@@ -323,6 +438,29 @@ oonf_viewer_telnet_handler(struct autobuf *out, struct abuf_template_storage *st
   return TELNET_RESULT_ACTIVE;
 }
 
+/**
+ * Handles a telnet command for a viewer including error handling and
+ * subscriptions to later changes of the output
+ * @param con telnet session data
+ * @param storage template storage object
+ * @param cmd telnet command
+ * @param templates template viewer array
+ * @param count number of template viewer entries
+ * @return telnet return code
+ */
+enum oonf_telnet_result
+oonf_viewer_telnet_session_handler(struct oonf_telnet_data *con, struct abuf_template_storage *storage,
+  const char *cmd, struct oonf_viewer_template *templates, size_t count)
+{
+  const char *next;
+
+  if ((next = str_hasnextword(con->parameter, OONF_VIEWER_SUBSCRIBE_FORMAT))
+      || (next = str_hasnextword(con->parameter, OONF_VIEWER_SUBSCRIBE_RAW_FORMAT))) {
+    return _telnet_subscribe(con, cmd, next, templates, count);
+  }
+  return oonf_viewer_telnet_handler(con->out, storage, cmd, con->parameter, templates, count);
+}
+
 /**
  * Handles a telnet help command for a viewer including error handling
  * @param out output buffer
@@ -347,3 +485,249 @@ oonf_viewer_telnet_help(
 
   return TELNET_RESULT_ACTIVE;
 }
+
+/**
+ * Subscribe a telnet session to the changes of one or more viewer templates.
+ * The current content of the templates is printed immediately.
+ * @param con telnet session data
+ * @param cmd telnet command
+ * @param param list of subcommands
+ * @param templates template viewer array
+ * @param count number of template viewer entries
+ * @return telnet return code
+ */
+static enum oonf_telnet_result
+_telnet_subscribe(
+  struct oonf_telnet_data *con, const char *cmd, const char *param, struct oonf_viewer_template *templates, size_t count)
+{
+  struct _viewer_subscription *subscription;
+  struct _viewer_subscriber *subscriber;
+  const char *next;
+  size_t i;
+
+  if (con->stop_handler) {
+    abuf_puts(con->out, "Error, you cannot stack continous output commands\n");
+    return TELNET_RESULT_ACTIVE;
+  }
+  if (param == NULL || *param == 0) {
+    abuf_appendf(con->out, "Error, '%s %s' needs at least one subcommand\n", cmd, OONF_VIEWER_SUBSCRIBE_FORMAT);
+    return TELNET_RESULT_ACTIVE;
+  }
+
+  subscription = oonf_class_malloc(&_subscription_class);
+  if (subscription == NULL) {
+    return TELNET_RESULT_INTERNAL_ERROR;
+  }
+
+  subscription->telnet = con;
+  subscription->raw = str_hasnextword(con->parameter, OONF_VIEWER_SUBSCRIBE_RAW_FORMAT) != NULL;
+  list_init_head(&subscription->subscribers);
+
+  while (*param) {
+    next = NULL;
+    for (i = 0; i < count && next == NULL; i++) {
+      next = str_hasnextword(param, templates[i].json_name);
+    }
+
+    if (next == NULL || templates[i - 1].class_name == NULL) {
+      abuf_appendf(con->out, "Error, subcommand '%.*s' of '%s' cannot be subscribed\n", (int)strcspn(param, " "),
+        param, cmd);
+      _remove_subscription(subscription);
+      return TELNET_RESULT_ACTIVE;
+    }
+    if (_add_subscriber(subscription, &templates[i - 1])) {
+      _remove_subscription(subscription);
+      return TELNET_RESULT_INTERNAL_ERROR;
+    }
+    param = next;
+  }
+
+  con->stop_handler = _cb_subscription_stophandler;
+  con->stop_data[0] = subscription;
+
+  /* print current state of all subscribed templates */
+  list_for_each_element(&subscription->subscribers, subscriber, _subscription_node) {
+    _print_event(subscription, subscriber->listener->template, "current", NULL);
+  }
+  return TELNET_RESULT_CONTINOUS;
+}
+
+/**
+ * Add a viewer template to a subscription
+ * @param subscription viewer subscription
+ * @param template viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_add_subscriber(struct _viewer_subscription *subscription, struct oonf_viewer_template *template) {
+  struct _viewer_subscriber *subscriber;
+  struct _viewer_listener *listener;
+  bool found = false;
+
+  list_for_each_element(&_listener_list, listener, _node) {
+    if (listener->template == template) {
+      found = true;
+      break;
+    }
+  }
+
+  if (!found) {
+    listener = oonf_class_malloc(&_listener_class);
+    if (listener == NULL) {
+      return -1;
+    }
+
+    listener->template = template;
+    listener->ext.ext_name = "viewer subscription";
+    listener->ext.class_name = template->class_name;
+    listener->ext.cb_event = _cb_class_event;
+    if (oonf_class_extension_add(&listener->ext)) {
+      oonf_class_free(&_listener_class, listener);
+      return -1;
+    }
+
+    list_init_head(&listener->subscribers);
+    list_add_tail(&_listener_list, &listener->_node);
+  }
+
+  subscriber = oonf_class_malloc(&_subscriber_class);
+  if (subscriber == NULL) {
+    if (list_is_empty(&listener->subscribers)) {
+      /* do not keep a new class listener without subscribers */
+      oonf_class_extension_remove(&listener->ext);
+      list_remove(&listener->_node);
+      oonf_class_free(&_listener_class, listener);
+    }
+    return -1;
+  }
+
+  subscriber->subscription = subscription;
+  subscriber->listener = listener;
+  list_add_tail(&listener->subscribers, &subscriber->_listener_node);
+  list_add_tail(&subscription->subscribers, &subscriber->_subscription_node);
+
+  OONF_DEBUG(LOG_VIEWER, "Subscribed to '%s' (%s)", template->json_name, template->class_name);
+  return 0;
+}
+
+/**
+ * Remove a subscription and all its subscribers. Class listeners
+ * without subscribers are removed too.
+ * @param subscription viewer subscription
+ */
+static void
+_remove_subscription(struct _viewer_subscription *subscription) {
+  struct _viewer_subscriber *subscriber, *it;
+  struct _viewer_listener *listener;
+
+  list_for_each_element_safe(&subscription->subscribers, subscriber, _subscription_node, it) {
+    listener = subscriber->listener;
+
+    list_remove(&subscriber->_listener_node);
+    list_remove(&subscriber->_subscription_node);
+    oonf_class_free(&_subscriber_class, subscriber);
+
+    if (list_is_empty(&listener->subscribers)) {
+      oonf_class_extension_remove(&listener->ext);
+      list_remove(&listener->_node);
+      oonf_class_free(&_listener_class, listener);
+    }
+  }
+  oonf_class_free(&_subscription_class, subscription);
+}
+
+/**
+ * Print the output of a viewer template for a subscription
+ * as newline delimited JSON.
+ * @param subscription viewer subscription
+ * @param template viewer template
+ * @param event name of event
+ * @param ptr class object that triggered the event,
+ *     NULL to print the whole template
+ */
+static void
+_print_event(
+  struct _viewer_subscription *subscription, struct oonf_viewer_template *template, const char *event, void *ptr) {
+  struct autobuf *out;
+
+  out = subscription->telnet->out;
+  if (abuf_getlen(out) > OONF_VIEWER_SUBSCRIPTION_BACKLOG) {
+    /* client does not read fast enough */
+    subscription->dropped++;
+    return;
+  }
+
+  if (subscription->dropped > 0) {
+    abuf_appendf(out, "{\"event\":\"overflow\",\"dropped\":%" PRIu64 "}\n", subscription->dropped);
+    subscription->dropped = 0;
+  }
+
+  template->out = out;
+  template->create_json = true;
+  template->create_raw = subscription->raw;
+  template->create_only_data = true;
+  template->_event = event;
+
+  if (ptr) {
+    template->cb_object(template, ptr);
+  }
+  else {
+    template->cb_function(template);
+  }
+
+  template->_event = NULL;
+}
+
+/**
+ * Print a single output line of a subscription
+ * @param template viewer template
+ */
+static void
+_print_event_line(struct oonf_viewer_template *template) {
+  struct json_session session;
+  size_t i, j;
+
+  abuf_appendf(template->out, "{\"event\":\"%s\",\"%s\":{", template->_event, template->json_name);
+
+  json_init_session(&session, template->out);
+  for (i = 0; i < template->data_size; i++) {
+    for (j = 0; j < template->data[i].count; j++) {
+      if (template->data[i].data[j].value) {
+        json_print(&session, template->data[i].data[j].key, template->data[i].data[j].string,
+          template->data[i].data[j].value);
+      }
+    }
+  }
+  abuf_puts(template->out, "}}\n");
+}
+
+/**
+ * Stop handler for subscriptions
+ * @param data pointer to telnet data
+ */
+static void
+_cb_subscription_stophandler(struct oonf_telnet_data *data) {
+  _remove_subscription(data->stop_data[0]);
+
+  data->stop_handler = NULL;
+  data->stop_data[0] = NULL;
+}
+
+/**
+ * Callback for events of a class with subscribers
+ * @param ext class extension of listener
+ * @param ptr class object
+ * @param evt type of event
+ */
+static void
+_cb_class_event(struct oonf_class_extension *ext, void *ptr, enum oonf_class_event evt) {
+  struct _viewer_listener *listener;
+  struct _viewer_subscriber *subscriber;
+
+  listener = container_of(ext, struct _viewer_listener, ext);
+
+  list_for_each_element(&listener->subscribers, subscriber, _listener_node) {
+    _print_event(subscriber->subscription, listener->template, oonf_class_get_event_name(evt), ptr);
+    oonf_telnet_flush_session(subscriber->subscription->telnet);
+  }
+}
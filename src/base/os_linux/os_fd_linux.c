@@ -43,9 +43,13 @@
  * @file
  */
 
+/*! activate GNU sources for recvmmsg() and sendmmsg() */
+#define _GNU_SOURCE
+
 #include <errno.h>
 #include <net/if.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 #include <sys/ioctl.h>
 
 #include <oonf/oonf.h>
@@ -58,10 +62,22 @@
 /* Defintions */
 #define LOG_OS_SOCKET _oonf_os_fd_subsystem.logging
 
+/*! maximum number of UDP segments the kernel accepts for a single GSO send */
+#define GSO_MAX_SEGMENTS 64
+
+/*! maximum payload of a single GSO send */
+#define GSO_MAX_PAYLOAD 65000
+
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
 
+static bool _can_add_segment(const struct os_fd_datagram *first, const struct os_fd_datagram *last,
+  const struct os_fd_datagram *dgram, size_t segments);
+
+/* true if the kernel rejected an UDP segmentation offload send */
+static bool _gso_unsupported = false;
+
 /* subsystem definition */
 static const char *_dependencies[] = {
   OONF_CLOCK_SUBSYSTEM,
@@ -162,3 +178,166 @@ os_fd_linux_skip_rawsocket_prefix(uint8_t *ptr, ssize_t *len, int af_type) {
   *len -= header_size;
   return ptr + header_size;
 }
+
+/**
+ * Receive multiple datagrams from an UDP socket with recvmmsg()
+ * @param sockfd filedescriptor of UDP socket
+ * @param dgrams array of datagram buffers
+ * @param count number of datagram buffers
+ * @return number of received datagrams, -1 if an error happened
+ */
+int
+os_fd_linux_recvfrom_batch(struct os_fd *sockfd, struct os_fd_datagram *dgrams, size_t count) {
+  struct mmsghdr msgs[OS_FD_MAX_BATCH];
+  struct iovec iov[OS_FD_MAX_BATCH];
+  size_t i;
+  int result;
+
+  if (count > OS_FD_MAX_BATCH) {
+    count = OS_FD_MAX_BATCH;
+  }
+
+  memset(msgs, 0, sizeof(*msgs) * count);
+  for (i = 0; i < count; i++) {
+    iov[i].iov_base = dgrams[i].buf;
+    iov[i].iov_len = dgrams[i].buflen;
+
+    msgs[i].msg_hdr.msg_iov = &iov[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_name = &dgrams[i].remote;
+    msgs[i].msg_hdr.msg_namelen = sizeof(dgrams[i].remote);
+  }
+
+  result = recvmmsg(sockfd->fd, msgs, count, MSG_DONTWAIT, NULL);
+  for (i = 0; result > 0 && i < (size_t)result; i++) {
+    dgrams[i].length = msgs[i].msg_len;
+  }
+  return result;
+}
+
+/**
+ * Send multiple datagrams through an UDP socket with sendmmsg().
+ * Consecutive datagrams to the same destination are combined into
+ * a single UDP segmentation offload (GSO) send if possible.
+ * @param sockfd filedescriptor of UDP socket
+ * @param dgrams array of outgoing datagrams
+ * @param count number of datagrams
+ * @param dont_route true to suppress routing of data
+ * @param gso true to allow UDP segmentation offload
+ * @return number of sent datagrams, -1 if an error happened
+ */
+int
+os_fd_linux_sendto_batch(
+  struct os_fd *sockfd, const struct os_fd_datagram *dgrams, size_t count, bool dont_route, bool gso) {
+  struct mmsghdr msgs[OS_FD_MAX_BATCH];
+  struct iovec iov[OS_FD_MAX_BATCH];
+  size_t segments[OS_FD_MAX_BATCH];
+#ifdef UDP_SEGMENT
+  union {
+    char buf[CMSG_SPACE(sizeof(uint16_t))];
+    struct cmsghdr align;
+  } control[OS_FD_MAX_BATCH];
+  struct cmsghdr *cmsg;
+  bool gso_used = false;
+#endif
+  size_t i, first, msg_count, sent;
+  int result;
+
+  if (count > OS_FD_MAX_BATCH) {
+    count = OS_FD_MAX_BATCH;
+  }
+
+#ifndef UDP_SEGMENT
+  gso = false;
+#endif
+  if (_gso_unsupported) {
+    gso = false;
+  }
+
+  memset(msgs, 0, sizeof(*msgs) * count);
+  msg_count = 0;
+  first = 0;
+  for (i = 0; i < count; i++) {
+    iov[i].iov_base = dgrams[i].buf;
+    iov[i].iov_len = dgrams[i].length;
+
+    if (gso && msg_count > 0
+        && _can_add_segment(&dgrams[first], &dgrams[i - 1], &dgrams[i], segments[msg_count - 1])) {
+      /* append datagram as an additional segment to the last message */
+      msgs[msg_count - 1].msg_hdr.msg_iovlen++;
+      segments[msg_count - 1]++;
+      continue;
+    }
+
+    first = i;
+    msgs[msg_count].msg_hdr.msg_iov = &iov[i];
+    msgs[msg_count].msg_hdr.msg_iovlen = 1;
+    msgs[msg_count].msg_hdr.msg_name = (void *)&dgrams[i].remote;
+    msgs[msg_count].msg_hdr.msg_namelen = sizeof(dgrams[i].remote);
+    segments[msg_count] = 1;
+    msg_count++;
+  }
+
+#ifdef UDP_SEGMENT
+  for (i = 0; i < msg_count; i++) {
+    if (segments[i] < 2) {
+      continue;
+    }
+
+    /* all segments have the size of the first one, except for the last */
+    msgs[i].msg_hdr.msg_control = control[i].buf;
+    msgs[i].msg_hdr.msg_controllen = sizeof(control[i].buf);
+
+    cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr);
+    cmsg->cmsg_level = IPPROTO_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    *((uint16_t *)CMSG_DATA(cmsg)) = msgs[i].msg_hdr.msg_iov[0].iov_len;
+    gso_used = true;
+  }
+#endif
+
+  result = sendmmsg(sockfd->fd, msgs, msg_count, dont_route ? MSG_DONTROUTE : 0);
+#ifdef UDP_SEGMENT
+  if (result < 0 && gso_used && (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT)) {
+    OONF_INFO(LOG_OS_SOCKET, "UDP segmentation offload not available: %s (%d)", strerror(errno), errno);
+    _gso_unsupported = true;
+    return os_fd_linux_sendto_batch(sockfd, dgrams, count, dont_route, false);
+  }
+#endif
+  if (result < 0) {
+    return -1;
+  }
+
+  /* convert number of messages into number of datagrams */
+  sent = 0;
+  for (i = 0; i < (size_t)result; i++) {
+    sent += segments[i];
+  }
+  return (int)sent;
+}
+
+/**
+ * Check if a datagram can be appended to an UDP segmentation offload
+ * message. The kernel splits the message into segments of the size of
+ * the first one, so only the last segment might be shorter.
+ * @param first first datagram of message
+ * @param last last datagram of message
+ * @param dgram datagram to be appended
+ * @param segments number of segments of message
+ * @return true if datagram can be appended to message
+ */
+static bool
+_can_add_segment(const struct os_fd_datagram *first, const struct os_fd_datagram *last,
+  const struct os_fd_datagram *dgram, size_t segments) {
+  if (segments >= GSO_MAX_SEGMENTS) {
+    return false;
+  }
+  if (last->length != first->length || dgram->length > first->length || dgram->length == 0) {
+    return false;
+  }
+  if ((segments + 1) * first->length > GSO_MAX_PAYLOAD) {
+    return false;
+  }
+  return netaddr_socket_cmp(&first->remote, &dgram->remote) == 0;
+}
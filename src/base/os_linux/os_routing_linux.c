@@ -55,6 +55,8 @@
 #include <oonf/libcommon/avl_comp.h>
 #include <oonf/oonf.h>
 #include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_timer.h>
 #include <oonf/base/os_system.h>
 
 #include <oonf/base/os_linux/os_routing_linux.h>
@@ -63,6 +65,9 @@
 /* Definitions */
 #define LOG_OS_ROUTING _oonf_os_routing_subsystem.logging
 
+/*! time in milliseconds until a failed dump of the route mirror is repeated */
+#define MIRROR_RETRY_INTERVAL 5000
+
 /**
  * Array to translate between OONF route types and internal kernel types
  */
@@ -74,11 +79,31 @@ struct route_type_translation {
   uint8_t os_linux;
 };
 
+/**
+ * Copy of a kernel route in the route mirror
+ */
+struct _mirror_entry {
+  /*! parameters of the kernel route */
+  struct os_route_parameter p;
+
+  /*! hook into tree of mirrored routes, sorted by kernel identity */
+  struct avl_node _identity_node;
+
+  /*! hook into index of mirrored routes, sorted by table, protocol and prefix */
+  struct avl_node _index_node;
+};
+
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
 
+static int _routing_send(struct os_route *route, bool set, bool del_similar);
 static int _routing_set(struct nlmsghdr *msg, struct os_route *route, unsigned char rt_scope);
+static int _avl_comp_route_identity(const void *, const void *);
+static int _avl_comp_param_identity(const void *, const void *);
+static int _avl_comp_param_index(const void *, const void *);
+static void _tx_send(struct os_route *route);
+static void _tx_remove(struct os_route *route);
 
 static void _routing_finished(struct os_route *route, int error);
 static void _cb_rtnetlink_message(struct nlmsghdr *);
@@ -86,8 +111,21 @@ static void _cb_rtnetlink_error(uint32_t seq, int err);
 static void _cb_rtnetlink_done(uint32_t seq);
 static void _cb_rtnetlink_timeout(void);
 
+static bool _match_routes(struct os_route *filter, struct os_route *route);
+static void _mirror_update(const struct os_route *route, bool set);
+static void _mirror_notify(const struct os_route_parameter *old, const struct os_route_parameter *new);
+static void _mirror_refresh(const struct os_route_parameter *param);
+static void _mirror_deliver(struct os_route_mirror_subscriber *subscriber, const struct os_route_parameter *param);
+static void _mirror_clear(void);
+static void _mirror_seed(void);
+static void _cb_mirror_query(struct os_route *filter, struct os_route *route);
+static void _cb_mirror_query_finished(struct os_route *route, int error);
+static void _cb_mirror_retry(struct oonf_timer_instance *);
+
 /* subsystem definition */
 static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
+  OONF_TIMER_SUBSYSTEM,
   OONF_OS_SYSTEM_SUBSYSTEM,
 };
 
@@ -121,6 +159,30 @@ static struct os_system_netlink _rtnetlink_socket = {
 static struct avl_tree _rtnetlink_feedback;
 static struct list_entity _rtnetlink_listener;
 
+/* route transaction handling */
+static uint32_t _tx_level;
+static struct avl_tree _tx_tree;
+static struct list_entity _tx_pending;
+static struct list_entity _tx_superseded;
+
+/* kernel route mirror */
+static struct oonf_class _mirror_class = {
+  .name = "os route mirror",
+  .size = sizeof(struct _mirror_entry),
+};
+static struct avl_tree _mirror_tree;
+static struct avl_tree _mirror_index;
+static struct list_entity _mirror_subscribers;
+static struct os_route _mirror_query;
+
+static struct oonf_timer_class _mirror_retry_class = {
+  .name = "os route mirror retry",
+  .callback = _cb_mirror_retry,
+};
+static struct oonf_timer_instance _mirror_retry = {
+  .class = &_mirror_retry_class,
+};
+
 /* default wildcard route */
 static const struct os_route_parameter OS_ROUTE_WILDCARD = { .family = AF_UNSPEC,
   .src_ip = { ._type = AF_UNSPEC },
@@ -155,6 +217,20 @@ _init(void) {
   avl_init(&_rtnetlink_feedback, avl_comp_uint32, false);
   list_init_head(&_rtnetlink_listener);
 
+  avl_init(&_tx_tree, _avl_comp_route_identity, false);
+  list_init_head(&_tx_pending);
+  list_init_head(&_tx_superseded);
+
+  oonf_class_add(&_mirror_class);
+  avl_init(&_mirror_tree, _avl_comp_param_identity, false);
+  avl_init(&_mirror_index, _avl_comp_param_index, false);
+  list_init_head(&_mirror_subscribers);
+
+  os_routing_linux_init_wildcard_route(&_mirror_query);
+  _mirror_query.cb_get = _cb_mirror_query;
+  _mirror_query.cb_finished = _cb_mirror_query_finished;
+  oonf_timer_add(&_mirror_retry_class);
+
   _is_kernel_3_11_0_or_better = os_system_linux_is_minimal_kernel(3, 11, 0);
   return 0;
 }
@@ -166,10 +242,21 @@ static void
 _cleanup(void) {
   struct os_route *rt, *rt_it;
 
+  list_for_each_element_safe(&_tx_pending, rt, _internal._tx_list_node, rt_it) {
+    _tx_remove(rt);
+  }
+  list_for_each_element_safe(&_tx_superseded, rt, _internal._tx_list_node, rt_it) {
+    _tx_remove(rt);
+  }
   avl_for_each_element_safe(&_rtnetlink_feedback, rt, _internal._node, rt_it) {
     _routing_finished(rt, 1);
   }
 
+  oonf_timer_stop(&_mirror_retry);
+  oonf_timer_remove(&_mirror_retry_class);
+  _mirror_clear();
+  oonf_class_remove(&_mirror_class);
+
   os_system_linux_netlink_remove(&_rtnetlink_socket);
 }
 
@@ -192,7 +279,11 @@ os_routing_linux_supports_source_specific(int af_family) {
 /**
  * Update an entry of the kernel routing table. This call will only trigger
  * the change, the real change will be done as soon as the netlink socket is
- * writable.
+ * writable. Inside a transaction the change is only recorded. A later
+ * change of the same route object replaces the earlier one. A change of
+ * another route object for the same kernel route supersedes the earlier
+ * one, which is finished with an error on commit if it wanted the
+ * opposite operation.
  * @param route data of route to be set/removed
  * @param set true if route should be set, false if it should be removed
  * @param del_similar true if similar routes that block this one should be
@@ -201,6 +292,115 @@ os_routing_linux_supports_source_specific(int af_family) {
  */
 int
 os_routing_linux_set(struct os_route *route, bool set, bool del_similar) {
+  struct os_route *pending;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct os_route_str rbuf;
+#endif
+
+  if (_tx_level == 0) {
+    return _routing_send(route, set, del_similar);
+  }
+
+  OONF_ASSERT(!avl_is_node_added(&route->_internal._node), LOG_OS_ROUTING, "route %s is already in feedback list!",
+    os_routing_to_string(&rbuf, &route->p));
+
+  route->_internal._tx_set = set;
+  route->_internal._tx_del_similar = del_similar;
+
+  if (list_is_node_added(&route->_internal._tx_list_node)) {
+    if (avl_is_node_added(&route->_internal._tx_node)) {
+      /* the latest change of a route object wins */
+      OONF_DEBUG(LOG_OS_ROUTING, "Coalesce route change: %s%s", set ? "" : "remove ",
+        os_routing_to_string(&rbuf, &route->p));
+      return 0;
+    }
+
+    /* route object was superseded by another one, make it pending again */
+    list_remove(&route->_internal._tx_list_node);
+  }
+
+  pending = avl_find_element(&_tx_tree, route, pending, _internal._tx_node);
+  if (pending) {
+    /* another route object changes the same kernel route, the newer change wins */
+    OONF_DEBUG(LOG_OS_ROUTING, "Route change supersedes earlier change: %s%s", set ? "" : "remove ",
+      os_routing_to_string(&rbuf, &route->p));
+
+    avl_remove(&_tx_tree, &pending->_internal._tx_node);
+    list_remove(&pending->_internal._tx_list_node);
+    list_add_tail(&_tx_superseded, &pending->_internal._tx_list_node);
+  }
+
+  route->_internal._tx_node.key = route;
+  avl_insert(&_tx_tree, &route->_internal._tx_node);
+  list_add_tail(&_tx_pending, &route->_internal._tx_list_node);
+  return 0;
+}
+
+/**
+ * Start a route transaction. Until the transaction is committed all
+ * route changes are collected and changes for the same kernel route
+ * are collapsed into one. Transactions can be nested.
+ */
+void
+os_routing_linux_transaction_begin(void) {
+  _tx_level++;
+}
+
+/**
+ * Commit a route transaction and send all collected route changes
+ * to the kernel in a single burst.
+ */
+void
+os_routing_linux_transaction_commit(void) {
+  struct os_route *route, *winner, *rt_it;
+
+  if (_tx_level == 0) {
+    return;
+  }
+  _tx_level--;
+  if (_tx_level > 0) {
+    /* nested transaction */
+    return;
+  }
+
+  /*
+   * the kernel state of superseded route changes is handled by the newer change
+   * of the same kernel route, which is only a success if both want the same
+   */
+  list_for_each_element_safe(&_tx_superseded, route, _internal._tx_list_node, rt_it) {
+    list_remove(&route->_internal._tx_list_node);
+
+    winner = avl_find_element(&_tx_tree, route, winner, _internal._tx_node);
+    if (winner == NULL) {
+      /* the newer change has been interrupted, send this one */
+      _tx_send(route);
+    }
+    else if (route->cb_finished) {
+      route->cb_finished(route, route->_internal._tx_set == winner->_internal._tx_set ? 0 : -1);
+    }
+  }
+
+  list_for_each_element_safe(&_tx_pending, route, _internal._tx_list_node, rt_it) {
+    avl_remove(&_tx_tree, &route->_internal._tx_node);
+    list_remove(&route->_internal._tx_list_node);
+
+    _tx_send(route);
+  }
+
+  /* send all route changes right now instead of waiting for the next socket event */
+  os_system_linux_netlink_flush(&_rtnetlink_socket);
+}
+
+/**
+ * Send a route change to the kernel
+ * @param route data of route to be set/removed
+ * @param set true if route should be set, false if it should be removed
+ * @param del_similar true if similar routes that block this one should be
+ *   removed.
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_routing_send(struct os_route *route, bool set, bool del_similar) {
   uint8_t buffer[UIO_MAXIOV];
   struct nlmsghdr *msg;
   unsigned char scope;
@@ -308,13 +508,57 @@ os_routing_linux_query(struct os_route *route) {
   return 0;
 }
 
+/**
+ * @return statistics of the netlink socket used to program routes
+ */
+const struct os_system_netlink_statistics *
+os_routing_linux_get_statistics(void) {
+  return &_rtnetlink_socket.stats;
+}
+
+/**
+ * Send the recorded route change of a transaction to the kernel
+ * @param route pointer to os_route
+ */
+static void
+_tx_send(struct os_route *route) {
+  struct os_route_str rbuf;
+
+  if (_routing_send(route, route->_internal._tx_set, route->_internal._tx_del_similar)) {
+    OONF_WARN(LOG_OS_ROUTING, "Could not %s route %s", route->_internal._tx_set ? "set" : "remove",
+      os_routing_to_string(&rbuf, &route->p));
+    if (route->cb_finished) {
+      route->cb_finished(route, -1);
+    }
+  }
+}
+
+/**
+ * Drop a route change of the current transaction before it was sent
+ * @param route pointer to os_route
+ */
+static void
+_tx_remove(struct os_route *route) {
+  if (avl_is_node_added(&route->_internal._tx_node)) {
+    avl_remove(&_tx_tree, &route->_internal._tx_node);
+  }
+  list_remove(&route->_internal._tx_list_node);
+
+  if (route->cb_finished) {
+    route->cb_finished(route, -1);
+  }
+}
+
 /**
  * Stop processing of a routing command
  * @param route pointer to os_route
  */
 void
 os_routing_linux_interrupt(struct os_route *route) {
-  if (os_routing_linux_is_in_progress(route)) {
+  if (list_is_node_added(&route->_internal._tx_list_node)) {
+    _tx_remove(route);
+  }
+  else if (os_routing_linux_is_in_progress(route)) {
     _routing_finished(route, -1);
   }
 }
@@ -326,7 +570,7 @@ os_routing_linux_interrupt(struct os_route *route) {
  */
 bool
 os_routing_linux_is_in_progress(struct os_route *route) {
-  return avl_is_node_added(&route->_internal._node);
+  return avl_is_node_added(&route->_internal._node) || list_is_node_added(&route->_internal._tx_list_node);
 }
 
 /**
@@ -347,6 +591,99 @@ os_routing_linux_listener_remove(struct os_route_listener *listener) {
   list_remove(&listener->_internal._node);
 }
 
+/**
+ * Subscribe to the kernel route mirror. The first subscriber seeds the
+ * mirror with a dump of the kernel routing tables, later subscribers
+ * get all matching routes of the mirror immediately. Calling this for
+ * a subscriber that is already registered reports all matching routes again.
+ * @param subscriber route mirror subscriber
+ */
+void
+os_routing_linux_mirror_add(struct os_route_mirror_subscriber *subscriber) {
+  if (list_is_node_added(&subscriber->_internal._node)) {
+    os_routing_linux_mirror_replay(subscriber);
+    return;
+  }
+
+  list_add_tail(&_mirror_subscribers, &subscriber->_internal._node);
+  if (!os_routing_linux_is_in_progress(&_mirror_query) && avl_is_empty(&_mirror_tree)) {
+    /* seed the mirror, all later changes are reported by netlink multicast */
+    _mirror_seed();
+    return;
+  }
+
+  /* routes still missing in the mirror will be reported by the running dump */
+  os_routing_linux_mirror_replay(subscriber);
+}
+
+/**
+ * Unsubscribe from the kernel route mirror. The mirror is cleared
+ * when the last subscriber is removed.
+ * @param subscriber route mirror subscriber
+ */
+void
+os_routing_linux_mirror_remove(struct os_route_mirror_subscriber *subscriber) {
+  if (!list_is_node_added(&subscriber->_internal._node)) {
+    return;
+  }
+
+  list_remove(&subscriber->_internal._node);
+  if (list_is_empty(&_mirror_subscribers)) {
+    oonf_timer_stop(&_mirror_retry);
+    os_routing_linux_interrupt(&_mirror_query);
+    _mirror_clear();
+  }
+}
+
+/**
+ * Report all mirrored routes matching the filter of a subscriber
+ * without querying the kernel.
+ * @param subscriber route mirror subscriber
+ */
+void
+os_routing_linux_mirror_replay(struct os_route_mirror_subscriber *subscriber) {
+  struct _mirror_entry *entry, *first;
+  struct os_route_parameter start;
+  unsigned char table, protocol;
+
+  if (avl_is_empty(&_mirror_index)) {
+    return;
+  }
+
+  table = subscriber->filter.p.table;
+  protocol = subscriber->filter.p.protocol;
+  if (table == RT_TABLE_UNSPEC) {
+    avl_for_each_element(&_mirror_index, entry, _index_node) {
+      _mirror_deliver(subscriber, &entry->p);
+    }
+    return;
+  }
+
+  /* only walk through the index range of the table (and protocol) */
+  memset(&start, 0, sizeof(start));
+  start.table = table;
+  start.protocol = protocol;
+
+  first = avl_find_ge_element(&_mirror_index, &start, first, _index_node);
+  if (first == NULL) {
+    return;
+  }
+  avl_for_element_to_last(&_mirror_index, first, entry, _index_node) {
+    if (entry->p.table != table || (protocol != RTPROT_UNSPEC && entry->p.protocol != protocol)) {
+      break;
+    }
+    _mirror_deliver(subscriber, &entry->p);
+  }
+}
+
+/**
+ * @return number of kernel routes in the route mirror
+ */
+size_t
+os_routing_linux_mirror_get_size(void) {
+  return _mirror_tree.count;
+}
+
 /**
  * Initializes a route with default values. Will zero all
  * other fields in the struct.
@@ -633,6 +970,11 @@ _cb_rtnetlink_message(struct nlmsghdr *msg) {
 
   OONF_DEBUG(LOG_OS_ROUTING, "Content: %s", os_routing_to_string(&rbuf, &rt.p));
 
+  if (!list_is_empty(&_mirror_subscribers)) {
+    /* keep the mirror current, no matter which request (if any) triggered the message */
+    _mirror_update(&rt, msg->nlmsg_type == RTM_NEWROUTE);
+  }
+
   /*
    * sometimes netlink messages from the kernel have a (random?) sequence number, so
    * we deliver everything with seq==0 and with an unregistered sequence number
@@ -714,3 +1056,266 @@ _cb_rtnetlink_done(uint32_t seq) {
     _routing_finished(route, 0);
   }
 }
+
+/**
+ * AVL comparator for the kernel identity of a route. Two routes
+ * with the same identity overwrite each other in the kernel.
+ * @param k1 pointer to first os_route
+ * @param k2 pointer to second os_route
+ * @return <0, 0 or >0 if first route is smaller, equal or larger
+ */
+static int
+_avl_comp_route_identity(const void *k1, const void *k2) {
+  const struct os_route *rt1 = k1;
+  const struct os_route *rt2 = k2;
+
+  return _avl_comp_param_identity(&rt1->p, &rt2->p);
+}
+
+/**
+ * AVL comparator for the kernel identity of route parameters
+ * @param k1 pointer to first os_route_parameter
+ * @param k2 pointer to second os_route_parameter
+ * @return <0, 0 or >0 if first route is smaller, equal or larger
+ */
+static int
+_avl_comp_param_identity(const void *k1, const void *k2) {
+  const struct os_route_parameter *p1 = k1;
+  const struct os_route_parameter *p2 = k2;
+
+  if (p1->table != p2->table) {
+    return p1->table < p2->table ? -1 : 1;
+  }
+  if (p1->metric != p2->metric) {
+    return p1->metric < p2->metric ? -1 : 1;
+  }
+  return os_routing_avl_cmp_route_key(&p1->key, &p2->key);
+}
+
+/**
+ * AVL comparator for the index of the route mirror. Routes are
+ * sorted by table and protocol first to allow range lookups.
+ * @param k1 pointer to first os_route_parameter
+ * @param k2 pointer to second os_route_parameter
+ * @return <0, 0 or >0 if first route is smaller, equal or larger
+ */
+static int
+_avl_comp_param_index(const void *k1, const void *k2) {
+  const struct os_route_parameter *p1 = k1;
+  const struct os_route_parameter *p2 = k2;
+  int result;
+
+  if (p1->table != p2->table) {
+    return p1->table < p2->table ? -1 : 1;
+  }
+  if (p1->protocol != p2->protocol) {
+    return p1->protocol < p2->protocol ? -1 : 1;
+  }
+  result = os_routing_avl_cmp_route_key(&p1->key, &p2->key);
+  if (result) {
+    return result;
+  }
+  if (p1->metric != p2->metric) {
+    /* unsigned, so a zeroed range start sorts first */
+    return (unsigned)p1->metric < (unsigned)p2->metric ? -1 : 1;
+  }
+  return 0;
+}
+
+/**
+ * Apply a kernel route change to the route mirror and
+ * inform the subscribers about real changes (and refreshes)
+ * @param route changed kernel route
+ * @param set true if route has been set/changed, false if removed
+ */
+static void
+_mirror_update(const struct os_route *route, bool set) {
+  struct _mirror_entry *entry;
+  struct os_route_parameter old;
+
+  entry = avl_find_element(&_mirror_tree, &route->p, entry, _identity_node);
+  if (!set) {
+    if (entry) {
+      avl_remove(&_mirror_tree, &entry->_identity_node);
+      avl_remove(&_mirror_index, &entry->_index_node);
+
+      _mirror_notify(&entry->p, NULL);
+      oonf_class_free(&_mirror_class, entry);
+    }
+    return;
+  }
+
+  if (entry) {
+    /* both were generated by _routing_parse_nlmsg(), so the padding is identical */
+    if (memcmp(&entry->p, &route->p, sizeof(entry->p)) == 0) {
+      /* kernel repeated a known route */
+      _mirror_refresh(&entry->p);
+      return;
+    }
+
+    memcpy(&old, &entry->p, sizeof(old));
+
+    /* the protocol might have changed, so reinsert into the index */
+    avl_remove(&_mirror_index, &entry->_index_node);
+    memcpy(&entry->p, &route->p, sizeof(entry->p));
+    avl_insert(&_mirror_index, &entry->_index_node);
+
+    _mirror_notify(&old, &entry->p);
+    return;
+  }
+
+  entry = oonf_class_malloc(&_mirror_class);
+  if (entry == NULL) {
+    OONF_WARN(LOG_OS_ROUTING, "Out of memory for route mirror");
+    return;
+  }
+
+  memcpy(&entry->p, &route->p, sizeof(entry->p));
+  entry->_identity_node.key = &entry->p;
+  entry->_index_node.key = &entry->p;
+  avl_insert(&_mirror_tree, &entry->_identity_node);
+  avl_insert(&_mirror_index, &entry->_index_node);
+
+  _mirror_notify(NULL, &entry->p);
+}
+
+/**
+ * Inform the subscribers of the route mirror about a route change
+ * @param old parameters of the route before the change, NULL if new route
+ * @param new parameters of the route after the change, NULL if route was removed
+ */
+static void
+_mirror_notify(const struct os_route_parameter *old, const struct os_route_parameter *new) {
+  struct os_route_mirror_subscriber *subscriber, *sub_it;
+  struct os_route old_rt, new_rt;
+  bool old_match, new_match;
+
+  memset(&old_rt, 0, sizeof(old_rt));
+  memset(&new_rt, 0, sizeof(new_rt));
+  if (old) {
+    memcpy(&old_rt.p, old, sizeof(old_rt.p));
+  }
+  if (new) {
+    memcpy(&new_rt.p, new, sizeof(new_rt.p));
+  }
+
+  list_for_each_element_safe(&_mirror_subscribers, subscriber, _internal._node, sub_it) {
+    old_match = old != NULL && _match_routes(&subscriber->filter, &old_rt);
+    new_match = new != NULL && _match_routes(&subscriber->filter, &new_rt);
+
+    if (old_match && !new_match) {
+      /* route moved out of the filter of the subscriber */
+      subscriber->cb_get(subscriber, &old_rt, false);
+    }
+    if (new_match) {
+      subscriber->cb_get(subscriber, &new_rt, true);
+    }
+  }
+}
+
+/**
+ * Inform the subscribers that want refreshes about a repeated
+ * kernel announcement of an unchanged route
+ * @param param parameters of the route
+ */
+static void
+_mirror_refresh(const struct os_route_parameter *param) {
+  struct os_route_mirror_subscriber *subscriber, *sub_it;
+  struct os_route rt;
+
+  /* a subscriber might clear the mirror in its callback */
+  memset(&rt, 0, sizeof(rt));
+  memcpy(&rt.p, param, sizeof(rt.p));
+
+  list_for_each_element_safe(&_mirror_subscribers, subscriber, _internal._node, sub_it) {
+    if (subscriber->want_refresh && _match_routes(&subscriber->filter, &rt)) {
+      subscriber->cb_get(subscriber, &rt, true);
+    }
+  }
+}
+
+/**
+ * Report a mirrored route to a subscriber if it matches its filter
+ * @param subscriber route mirror subscriber
+ * @param param parameters of mirrored route
+ */
+static void
+_mirror_deliver(struct os_route_mirror_subscriber *subscriber, const struct os_route_parameter *param) {
+  struct os_route rt;
+
+  memset(&rt, 0, sizeof(rt));
+  memcpy(&rt.p, param, sizeof(rt.p));
+
+  if (_match_routes(&subscriber->filter, &rt)) {
+    subscriber->cb_get(subscriber, &rt, true);
+  }
+}
+
+/**
+ * Remove all routes from the route mirror
+ */
+static void
+_mirror_clear(void) {
+  struct _mirror_entry *entry, *entry_it;
+
+  avl_for_each_element_safe(&_mirror_tree, entry, _identity_node, entry_it) {
+    avl_remove(&_mirror_tree, &entry->_identity_node);
+    avl_remove(&_mirror_index, &entry->_index_node);
+    oonf_class_free(&_mirror_class, entry);
+  }
+}
+
+/**
+ * Dummy cb_get callback for the mirror query, the routes
+ * are added to the mirror for all incoming route messages
+ * @param filter mirror query
+ * @param route route found by the query
+ */
+static void
+_cb_mirror_query(struct os_route *filter __attribute__((unused)), struct os_route *route __attribute__((unused))) {}
+
+/**
+ * Callback for finished mirror query
+ * @param route mirror query
+ * @param error error code
+ */
+static void
+_cb_mirror_query_finished(struct os_route *route __attribute__((unused)), int error) {
+  if (list_is_empty(&_mirror_subscribers)) {
+    /* query was interrupted because nobody needs the mirror anymore */
+    return;
+  }
+  if (error) {
+    OONF_WARN(LOG_OS_ROUTING, "Query of kernel routing tables for route mirror failed: %d", error);
+
+    /* routes missing from the aborted dump are only reported by another dump */
+    oonf_timer_set(&_mirror_retry, MIRROR_RETRY_INTERVAL);
+  }
+  else {
+    OONF_INFO(LOG_OS_ROUTING, "Route mirror seeded with %u routes", _mirror_tree.count);
+  }
+}
+
+/**
+ * Start a dump of the kernel routing tables to seed the route mirror,
+ * schedule a retry if the dump cannot be started.
+ */
+static void
+_mirror_seed(void) {
+  if (os_routing_linux_query(&_mirror_query)) {
+    OONF_WARN(LOG_OS_ROUTING, "Could not query kernel routing tables for route mirror");
+    oonf_timer_set(&_mirror_retry, MIRROR_RETRY_INTERVAL);
+  }
+}
+
+/**
+ * Timer callback to repeat a failed seed of the route mirror
+ * @param ptr timer instance that fired
+ */
+static void
+_cb_mirror_retry(struct oonf_timer_instance *ptr __attribute__((unused))) {
+  if (list_is_empty(&_mirror_subscribers) || os_routing_linux_is_in_progress(&_mirror_query)) {
+    return;
+  }
+  _mirror_seed();
+}
@@ -63,6 +63,7 @@
 
 #include <oonf/oonf.h>
 #include <oonf/libcommon/string.h>
+#include <oonf/libconfig/cfg_schema.h>
 #include <oonf/libcore/oonf_subsystem.h>
 #include <oonf/base/oonf_socket.h>
 
@@ -79,6 +80,17 @@
 /* Definitions */
 #define LOG_OS_SYSTEM _oonf_os_system_subsystem.logging
 
+/**
+ * Configuration of the os_system subsystem
+ */
+struct _os_system_config {
+  /*! maximum number of netlink messages in transit to the kernel */
+  int32_t netlink_window_messages;
+
+  /*! maximum number of netlink bytes in transit to the kernel */
+  int32_t netlink_window_bytes;
+};
+
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
@@ -88,6 +100,10 @@ static void _netlink_handler(struct oonf_socket_entry *entry);
 static void _enqueue_netlink_buffer(struct os_system_netlink *nl);
 static void _handle_nl_err(struct os_system_netlink *, struct nlmsghdr *);
 static void _flush_netlink_buffer(struct os_system_netlink *nl);
+static void _netlink_job_finished(struct os_system_netlink *nl, uint32_t seq);
+static bool _window_has_room(struct os_system_netlink *nl, struct os_system_netlink_buffer *buffer);
+static void _fail_netlink_buffer(struct os_system_netlink *nl, struct os_system_netlink_buffer *buffer, int err);
+static void _cb_config_changed(void);
 
 /* static buffers for receiving/sending a netlink message */
 static struct sockaddr_nl _netlink_nladdr = { .nl_family = AF_NETLINK };
@@ -111,6 +127,25 @@ static struct oonf_timer_class _netlink_timer = {
   .callback = _cb_handle_netlink_timeout,
 };
 
+/* configuration */
+static struct _os_system_config _config;
+
+static struct cfg_schema_entry _os_system_entries[] = {
+  CFG_MAP_INT32_MINMAX(_os_system_config, netlink_window_messages, "netlink_window_messages", "256",
+    "Maximum number of netlink messages in transit to the kernel before waiting for feedback", 0, 1, 65535),
+  CFG_MAP_INT32_MINMAX(_os_system_config, netlink_window_bytes, "netlink_window_bytes", "65536",
+    "Maximum number of netlink bytes in transit to the kernel before waiting for feedback", 0, 4096, 1048576),
+};
+
+static struct cfg_schema_section _os_system_section = {
+  .type = OONF_OS_SYSTEM_SUBSYSTEM,
+  .mode = CFG_SSMODE_UNNAMED,
+  .help = "Settings for the operation system interface",
+  .cb_delta_handler = _cb_config_changed,
+  .entries = _os_system_entries,
+  .entry_count = ARRAYSIZE(_os_system_entries),
+};
+
 /* subsystem definition */
 static const char *_dependencies[] = {
   OONF_SOCKET_SUBSYSTEM,
@@ -122,6 +157,7 @@ static struct oonf_subsystem _oonf_os_system_subsystem = {
   .dependencies_count = ARRAYSIZE(_dependencies),
   .init = _init,
   .cleanup = _cleanup,
+  .cfg_section = &_os_system_section,
 };
 DECLARE_OONF_PLUGIN(_oonf_os_system_subsystem);
 
@@ -151,6 +187,9 @@ _init(void) {
     OONF_INFO(LOG_OS_SYSTEM, "Node is not IPv6 capable");
   }
 
+  _config.netlink_window_messages = OS_SYSTEM_NETLINK_WINDOW_MESSAGES;
+  _config.netlink_window_bytes = OS_SYSTEM_NETLINK_WINDOW_BYTES;
+
   oonf_timer_add(&_netlink_timer);
   return 0;
 }
@@ -306,6 +345,7 @@ os_system_linux_netlink_add(struct os_system_netlink *nl, int protocol) {
   nl->timeout.class = &_netlink_timer;
 
   list_init_head(&nl->buffered);
+  list_init_head(&nl->_in_transit);
   return 0;
 
 os_add_netlink_fail:
@@ -325,8 +365,20 @@ os_add_netlink_fail:
  */
 void
 os_system_linux_netlink_remove(struct os_system_netlink *nl) {
+  struct os_system_netlink_buffer *buffer, *buf_it;
+
   if (os_fd_is_initialized(&nl->socket.fd)) {
     oonf_socket_remove(&nl->socket);
+    oonf_timer_stop(&nl->timeout);
+
+    list_for_each_element_safe(&nl->buffered, buffer, _node, buf_it) {
+      list_remove(&buffer->_node);
+      free(buffer);
+    }
+    list_for_each_element_safe(&nl->_in_transit, buffer, _node, buf_it) {
+      list_remove(&buffer->_node);
+      free(buffer);
+    }
 
     os_fd_close(&nl->socket.fd);
     free(nl->in);
@@ -364,6 +416,8 @@ _enqueue_netlink_buffer(struct os_system_netlink *nl) {
  */
 int
 os_system_linux_netlink_send(struct os_system_netlink *nl, struct nlmsghdr *nl_hdr) {
+  struct os_system_netlink_buffer *bufptr;
+
   _seq_used = (_seq_used + 1) & INT32_MAX;
   OONF_DEBUG(
     nl->used_by->logging, "Prepare to send netlink '%s' message %u (%u bytes)", nl->name, _seq_used, nl_hdr->nlmsg_len);
@@ -378,15 +432,32 @@ os_system_linux_netlink_send(struct os_system_netlink *nl, struct nlmsghdr *nl_h
 
   OONF_DEBUG_HEX(nl->used_by->logging, nl_hdr, nl_hdr->nlmsg_len, "Content of netlink '%s' message:", nl->name);
 
+  /* remember range of sequence numbers in buffer */
+  bufptr = (struct os_system_netlink_buffer *)abuf_getptr(&nl->out);
+  if (nl->out_messages == 0) {
+    bufptr->_first_seq = _seq_used;
+  }
+  bufptr->_last_seq = _seq_used;
+
   nl->out_messages++;
 
   /* trigger write */
-  if (nl->msg_in_transit == 0) {
+  if (list_is_empty(&nl->buffered) || _window_has_room(nl, list_first_element(&nl->buffered, bufptr, _node))) {
     oonf_socket_set_write(&nl->socket, true);
   }
   return _seq_used;
 }
 
+/**
+ * Send all queued netlink messages of a handler that fit into the
+ * netlink window right now instead of waiting for the next socket event
+ * @param nl pointer to netlink handler
+ */
+void
+os_system_linux_netlink_flush(struct os_system_netlink *nl) {
+  _flush_netlink_buffer(nl);
+}
+
 /**
  * Join a list of multicast groups for a netlink socket
  * @param nl pointer to netlink handler
@@ -472,16 +543,84 @@ static void
 _cb_handle_netlink_timeout(struct oonf_timer_instance *ptr) {
   struct os_system_netlink *nl;
 
+  struct os_system_netlink_buffer *buffer, *buf_it;
+
   nl = container_of(ptr, struct os_system_netlink, timeout);
 
+  OONF_WARN(nl->used_by->logging, "netlink '%s' timeout: %d messages did not get feedback", nl->name,
+    nl->msg_in_transit);
+  nl->stats.timeouts++;
+
   if (nl->cb_timeout) {
     nl->cb_timeout();
   }
+
+  /* forget about all buffers still waiting for feedback */
+  list_for_each_element_safe(&nl->_in_transit, buffer, _node, buf_it) {
+    list_remove(&buffer->_node);
+    free(buffer);
+  }
   nl->msg_in_transit = 0;
+  nl->bytes_in_transit = 0;
+
+  if (!list_is_empty(&nl->buffered) || nl->out_messages > 0) {
+    oonf_socket_set_write(&nl->socket, true);
+  }
 }
 
 /**
- * Send all netlink messages in the outgoing queue to the kernel
+ * Check if a buffer fits into the netlink window of a handler.
+ * A handler without messages in transit can always send.
+ * @param nl pointer to netlink handler
+ * @param buffer netlink buffer to be sent
+ * @return true if buffer can be sent
+ */
+static bool
+_window_has_room(struct os_system_netlink *nl, struct os_system_netlink_buffer *buffer) {
+  if (nl->msg_in_transit == 0) {
+    return true;
+  }
+  return nl->msg_in_transit + buffer->messages <= (uint32_t)_config.netlink_window_messages &&
+         nl->bytes_in_transit + buffer->total <= (uint32_t)_config.netlink_window_bytes;
+}
+
+/**
+ * Check if a sequence number belongs to a netlink buffer
+ * @param buffer netlink buffer
+ * @param seq sequence number
+ * @return true if sequence number was used by a message of the buffer
+ */
+static bool
+_is_seq_in_buffer(struct os_system_netlink_buffer *buffer, uint32_t seq) {
+  /* sequence numbers are 31 bit wide and might wrap around */
+  return ((seq - buffer->_first_seq) & INT32_MAX) <= ((buffer->_last_seq - buffer->_first_seq) & INT32_MAX);
+}
+
+/**
+ * Report an error for every message of a netlink buffer
+ * @param nl pointer to netlink handler
+ * @param buffer netlink buffer that could not be sent
+ * @param err error code
+ */
+static void
+_fail_netlink_buffer(struct os_system_netlink *nl, struct os_system_netlink_buffer *buffer, int err) {
+  struct nlmsghdr *nh;
+  size_t len;
+
+  nl->stats.messages_failed += buffer->messages;
+  if (!nl->cb_error) {
+    return;
+  }
+
+  len = buffer->total;
+  for (nh = (struct nlmsghdr *)((char *)(buffer) + sizeof(*buffer)); NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len)) {
+    nl->cb_error(nh->nlmsg_seq, err);
+  }
+}
+
+/**
+ * Send netlink buffers of the outgoing queue to the kernel
+ * as long as they fit into the netlink window
  * @param nl pointer to netlink handler
  */
 static void
@@ -490,78 +629,111 @@ _flush_netlink_buffer(struct os_system_netlink *nl) {
   ssize_t ret;
   int err;
 
-  if (nl->msg_in_transit > 0) {
-    oonf_socket_set_write(&nl->socket, false);
-    return;
-  }
-
-  if (list_is_empty(&nl->buffered)) {
-    if (abuf_getlen(&nl->out) > sizeof(struct os_system_netlink_buffer)) {
+  while (true) {
+    if (list_is_empty(&nl->buffered)) {
+      if (abuf_getlen(&nl->out) <= sizeof(struct os_system_netlink_buffer)) {
+        break;
+      }
       _enqueue_netlink_buffer(nl);
     }
-    else {
-      oonf_socket_set_write(&nl->socket, false);
-      return;
-    }
-  }
 
-  /* get first buffer */
-  buffer = list_first_element(&nl->buffered, buffer, _node);
+    /* get first buffer */
+    buffer = list_first_element(&nl->buffered, buffer, _node);
+    if (!_window_has_room(nl, buffer)) {
+      OONF_DEBUG(nl->used_by->logging, "netlink '%s': window full (%d messages, %u bytes in transit)", nl->name,
+        nl->msg_in_transit, nl->bytes_in_transit);
+      break;
+    }
 
-  /* send outgoing message */
-  _netlink_send_iov[0].iov_base = (char *)(buffer) + sizeof(*buffer);
-  _netlink_send_iov[0].iov_len = buffer->total;
+    /* send outgoing message */
+    _netlink_send_iov[0].iov_base = (char *)(buffer) + sizeof(*buffer);
+    _netlink_send_iov[0].iov_len = buffer->total;
 
-  if ((ret = sendmsg(os_fd_get_fd(&nl->socket.fd), &_netlink_send_msg, MSG_DONTWAIT)) <= 0) {
-    err = errno;
+    if ((ret = sendmsg(os_fd_get_fd(&nl->socket.fd), &_netlink_send_msg, MSG_DONTWAIT)) <= 0) {
+      err = errno;
 #if EAGAIN == EWOULDBLOCK
-    if (err != EAGAIN) {
+      if (err == EAGAIN) {
 #else
-    if (err != EAGAIN && err != EWOULDBLOCK) {
+      if (err == EAGAIN || err == EWOULDBLOCK) {
 #endif
+        /* try again when socket is writable */
+        oonf_socket_set_write(&nl->socket, true);
+        return;
+      }
+
       OONF_WARN(nl->used_by->logging,
-        "Cannot send data (%" PRINTF_SIZE_T_SPECIFIER " bytes)"
+        "Cannot send data (%u bytes)"
         " to netlink socket %s: %s (%d)",
-        abuf_getlen(&nl->out), nl->name, strerror(err), err);
+        buffer->total, nl->name, strerror(err), err);
 
-      /* remove netlink message from internal queue */
-      nl->cb_error(nl->in->nlmsg_seq, err);
+      /* remove netlink messages from internal queue */
+      list_remove(&buffer->_node);
+      _fail_netlink_buffer(nl, buffer, err);
+      free(buffer);
+      continue;
     }
-  }
-  else {
+
+    /* keep buffer until the kernel acknowledged all messages */
+    list_remove(&buffer->_node);
+    list_add_tail(&nl->_in_transit, &buffer->_node);
+    buffer->_pending = buffer->messages;
+
     nl->msg_in_transit += buffer->messages;
+    nl->bytes_in_transit += buffer->total;
 
-    OONF_DEBUG(nl->used_by->logging, "netlink %s: Sent %u bytes (%u messages in transit)", nl->name, buffer->total,
-      nl->msg_in_transit);
+    nl->stats.buffers_sent++;
+    nl->stats.messages_sent += buffer->messages;
+    nl->stats.bytes_sent += buffer->total;
+    if ((uint32_t)nl->msg_in_transit > nl->stats.max_in_transit) {
+      nl->stats.max_in_transit = nl->msg_in_transit;
+    }
+
+    OONF_DEBUG(nl->used_by->logging, "netlink %s: Sent %u bytes (%d messages, %u bytes in transit)", nl->name,
+      buffer->total, nl->msg_in_transit, nl->bytes_in_transit);
 
     /* start feedback timer */
     oonf_timer_set(&nl->timeout, OS_SYSTEM_NETLINK_TIMEOUT);
   }
 
-  list_remove(&buffer->_node);
-  free(buffer);
-
-  oonf_socket_set_write(&nl->socket, !list_is_empty(&nl->buffered));
+  oonf_socket_set_write(&nl->socket, false);
 }
 
 /**
- * Cleanup netlink handler because all outstanding jobs
- * are finished
+ * Account the kernel feedback for a netlink message and release
+ * its buffer when all messages of the buffer are finished
  * @param nl pointer to os_system_netlink handler
+ * @param seq sequence number of the finished message
  */
 static void
-_netlink_job_finished(struct os_system_netlink *nl) {
-  if (nl->msg_in_transit > 0) {
-    nl->msg_in_transit--;
+_netlink_job_finished(struct os_system_netlink *nl, uint32_t seq) {
+  struct os_system_netlink_buffer *buffer;
+
+  list_for_each_element(&nl->_in_transit, buffer, _node) {
+    if (!_is_seq_in_buffer(buffer, seq)) {
+      continue;
+    }
+
+    if (buffer->_pending > 0) {
+      buffer->_pending--;
+      nl->msg_in_transit--;
+    }
+    if (buffer->_pending == 0) {
+      nl->bytes_in_transit -= buffer->total;
+      list_remove(&buffer->_node);
+      free(buffer);
+    }
+    break;
   }
+
   if (nl->msg_in_transit == 0) {
     oonf_timer_stop(&nl->timeout);
-
-    if (!list_is_empty(&nl->buffered) || nl->out_messages > 0) {
-      oonf_socket_set_write(&nl->socket, true);
-    }
   }
-  OONF_DEBUG(nl->used_by->logging, "netlink '%s' finished: %d still in transit", nl->name, nl->msg_in_transit);
+  if ((!list_is_empty(&nl->buffered) && _window_has_room(nl, list_first_element(&nl->buffered, buffer, _node))) ||
+      (list_is_empty(&nl->buffered) && nl->out_messages > 0)) {
+    oonf_socket_set_write(&nl->socket, true);
+  }
+  OONF_DEBUG(nl->used_by->logging, "netlink '%s' seq %u finished: %d still in transit", nl->name, seq,
+    nl->msg_in_transit);
 }
 
 /**
@@ -658,11 +830,16 @@ netlink_rcv_retry:
       current_seq = nh->nlmsg_seq;
     }
 
-    if (current_seq != nh->nlmsg_seq && trigger_is_done) {
-      if (nl->cb_done) {
-        nl->cb_done(current_seq);
+    if (current_seq != nh->nlmsg_seq) {
+      if (trigger_is_done) {
+        nl->stats.messages_done++;
+        if (nl->cb_done) {
+          nl->cb_done(current_seq);
+        }
+        _netlink_job_finished(nl, current_seq);
+        trigger_is_done = false;
       }
-      trigger_is_done = false;
+      current_seq = nh->nlmsg_seq;
     }
 
     switch (nh->nlmsg_type) {
@@ -689,11 +866,11 @@ netlink_rcv_retry:
   }
 
   if (trigger_is_done) {
-    oonf_timer_stop(&nl->timeout);
+    nl->stats.messages_done++;
     if (nl->cb_done) {
       nl->cb_done(current_seq);
     }
-    _netlink_job_finished(nl);
+    _netlink_job_finished(nl, current_seq);
   }
 
   /* reset timeout if necessary */
@@ -717,15 +894,28 @@ _handle_nl_err(struct os_system_netlink *nl, struct nlmsghdr *nh) {
     nh->nlmsg_len, strerror(-err->error), -err->error);
 
   if (err->error) {
+    nl->stats.messages_failed++;
     if (nl->cb_error) {
       nl->cb_error(err->msg.nlmsg_seq, -err->error);
     }
   }
   else {
+    nl->stats.messages_done++;
     if (nl->cb_done) {
       nl->cb_done(err->msg.nlmsg_seq);
     }
   }
 
-  _netlink_job_finished(nl);
+  _netlink_job_finished(nl, err->msg.nlmsg_seq);
+}
+
+/**
+ * Handler for configuration changes
+ */
+static void
+_cb_config_changed(void) {
+  if (cfg_schema_tobin(&_config, _os_system_section.post, _os_system_entries, ARRAYSIZE(_os_system_entries))) {
+    OONF_WARN(LOG_OS_SYSTEM, "Cannot convert " OONF_OS_SYSTEM_SUBSYSTEM " configuration.");
+    return;
+  }
 }
@@ -43,13 +43,22 @@
  * @file
  */
 
+#include <stdlib.h>
+
 #include <oonf/libcommon/avl.h>
 #include <oonf/libcommon/avl_comp.h>
+#include <oonf/libcommon/autobuf.h>
+#include <oonf/libcommon/container_of.h>
+#include <oonf/libcommon/list.h>
+#include <oonf/crypto/rfc5444_signature/worker_pool.h>
 #include <oonf/oonf.h>
+#include <oonf/libconfig/cfg_schema.h>
 #include <oonf/libcore/oonf_subsystem.h>
 #include <oonf/crypto/rfc7182_provider/rfc7182_provider.h>
 #include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_clock.h>
 #include <oonf/base/oonf_rfc5444.h>
+#include <oonf/base/oonf_telnet.h>
 #include <oonf/librfc5444/rfc5444_reader.h>
 #include <oonf/librfc5444/rfc5444_writer.h>
 
@@ -57,14 +66,168 @@
 
 #define LOG_RFC5444_SIG _rfc5444_sig_subsystem.logging
 
+/*! number of TLVs whose unsigned data can be buffered for one batch */
+#define VERIFY_BUFFER_COUNT 4
+
+/*! maximum number of signatures checked in one batch */
+#define VERIFY_JOB_COUNT 16
+
+/*! maximum number of verification results remembered for one packet */
+#define VERIFY_RESULT_COUNT 64
+
+/**
+ * Configuration of rfc5444 signature plugin
+ */
+struct _sig_config {
+  /*! number of threads used for signature verification */
+  int32_t workers;
+
+  /*! maximum number of verified messages in cache, 0 to disable it */
+  int32_t cache_size;
+
+  /*! time a verified message stays in cache */
+  uint64_t cache_vtime;
+};
+
+/**
+ * Key of verification cache, identifies a flooded message
+ */
+struct _verify_cache_key {
+  /*! originator address of message */
+  struct netaddr originator;
+
+  /*! message sequence number */
+  uint16_t seqno;
+
+  /*! message type */
+  uint8_t msg_type;
+};
+
+/**
+ * Message which signature has been verified successfully. A copy
+ * with the same signature value, unsigned data and key material
+ * does not need to be verified again.
+ */
+struct _verify_cache_entry {
+  /*! key of cache entry */
+  struct _verify_cache_key key;
+
+  /*! signature which has been verified */
+  struct rfc5444_signature *sig;
+
+  /*! absolute time when the entry will be dropped */
+  uint64_t vtime;
+
+  /*! verified signature value, stored behind the entry */
+  uint8_t *icv;
+
+  /*! length of signature value */
+  size_t icv_length;
+
+  /*! unsigned data, stored behind the entry */
+  uint8_t *data;
+
+  /*! length of unsigned data */
+  size_t data_length;
+
+  /*! key material used for verification, stored behind the entry */
+  uint8_t *crypt_key;
+
+  /*! length of key material */
+  size_t crypt_key_length;
+
+  /*! node for cache tree */
+  struct avl_node _node;
+
+  /*! hook into list of entries, oldest first */
+  struct list_entity _fifo;
+};
+
+/**
+ * Verification of a single signature TLV against a registered signature
+ */
+struct _verify_job {
+  /*! job for the worker pool */
+  struct worker_job job;
+
+  /*! signature to be checked */
+  struct rfc5444_signature *sig;
+
+  /*! key of verification cache for the message of the TLV */
+  struct _verify_cache_key cache_key;
+
+  /*! true if the result can be stored in the verification cache */
+  bool cacheable;
+
+  /*! received signature value */
+  const uint8_t *icv;
+
+  /*! length of received signature value */
+  size_t icv_length;
+
+  /*! unsigned data (including TLV prefix and source address) */
+  const uint8_t *data;
+
+  /*! length of unsigned data */
+  size_t data_length;
+
+  /*! key material for signature */
+  const void *key;
+
+  /*! length of key material */
+  size_t key_length;
+
+  /*! result of verification */
+  enum rfc7182_validation result;
+
+  /*! true if the result was already known and the job does not need to run */
+  bool known;
+
+  /*! true if the result was taken from the verification cache */
+  bool cached;
+};
+
+/**
+ * Verification result of a signature TLV of the current packet
+ */
+struct _verify_result {
+  /*! signature which was checked */
+  struct rfc5444_signature *sig;
+
+  /*! signature value inside the packet buffer, identifies the TLV */
+  const uint8_t *icv;
+
+  /*! result of verification */
+  enum rfc7182_validation result;
+};
+
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
+static enum rfc5444_result _cb_packet_start(struct rfc5444_reader_tlvblock_context *context);
+static enum rfc5444_result _cb_packet_end(struct rfc5444_reader_tlvblock_context *context, bool dropped);
 static enum rfc5444_result _cb_signature_tlv(struct rfc5444_reader_tlvblock_context *context);
 static int _cb_add_signature(struct rfc5444_writer_postprocessor *processor, struct rfc5444_writer_target *target,
   struct rfc5444_writer_message *msg, uint8_t *data, size_t *data_size);
 
 static size_t _remove_signature_data(uint8_t *dst, const struct rfc5444_reader_tlvblock_context *context);
+static void _precheck_tlvblock(struct rfc5444_reader_tlvblock_context *context, int msg_type, uint8_t icv_type,
+  const uint8_t *ptr, const uint8_t *end);
+static bool _add_verify_jobs(struct rfc5444_reader_tlvblock_context *context, int msg_type, uint8_t type_ext,
+  const uint8_t *value, size_t length);
+static void _cb_verify_signature(struct worker_job *);
+static void _run_verify_jobs(void);
+static bool _get_packet_result(struct _verify_job *job);
+
+static bool _is_cacheable(struct rfc5444_reader_tlvblock_context *context);
+static void _get_cache_key(struct _verify_cache_key *key, struct rfc5444_reader_tlvblock_context *context);
+static bool _lookup_cache(struct _verify_job *job);
+static void _add_cache(struct _verify_job *job);
+static void _remove_cache(struct _verify_cache_entry *entry);
+static void _flush_cache(struct rfc5444_signature *sig);
+static int _avl_comp_verify_cache(const void *, const void *);
+
+static enum oonf_telnet_result _cb_telnet_sigcache(struct oonf_telnet_data *con);
 
 static void _cb_hash_added(void *ptr);
 static void _cb_hash_removed(void *ptr);
@@ -78,11 +241,36 @@ static enum rfc5444_sigid_check _cb_sigid_okay(struct rfc5444_signature *sig, co
 
 static bool _cb_is_matching_signature(struct rfc5444_writer_postprocessor *processor, int msg_type);
 
+static void _cb_config_changed(void);
+
+/* configuration */
+static struct cfg_schema_entry _sig_entries[] = {
+  CFG_MAP_INT32_MINMAX(_sig_config, workers, "workers", "1",
+    "Number of threads verifying incoming signatures, 1 verifies them in the main thread."
+    " More than one thread requires thread-safe hash and crypto providers.",
+    0, 1, 64),
+  CFG_MAP_INT32_MINMAX(_sig_config, cache_size, "cache_size", "256",
+    "Number of verified messages remembered to skip verification of identical flooded copies, 0 disables the cache.",
+    0, 0, 65535),
+  CFG_MAP_CLOCK_MIN(_sig_config, cache_vtime, "cache_vtime", "10",
+    "Time a verified message is remembered by the verification cache", 100),
+};
+
+static struct cfg_schema_section _sig_section = {
+  .type = OONF_RFC5444_SIG_SUBSYSTEM,
+  .mode = CFG_SSMODE_UNNAMED,
+  .cb_delta_handler = _cb_config_changed,
+  .entries = _sig_entries,
+  .entry_count = ARRAYSIZE(_sig_entries),
+};
+
 /* plugin declaration */
 static const char *_dependencies[] = {
   OONF_CLASS_SUBSYSTEM,
+  OONF_CLOCK_SUBSYSTEM,
   OONF_RFC5444_SUBSYSTEM,
   OONF_RFC7182_PROVIDER_SUBSYSTEM,
+  OONF_TELNET_SUBSYSTEM,
 };
 static struct oonf_subsystem _rfc5444_sig_subsystem = {
   .name = OONF_RFC5444_SIG_SUBSYSTEM,
@@ -93,9 +281,13 @@ static struct oonf_subsystem _rfc5444_sig_subsystem = {
 
   .init = _init,
   .cleanup = _cleanup,
+
+  .cfg_section = &_sig_section,
 };
 DECLARE_OONF_PLUGIN(_rfc5444_sig_subsystem);
 
+static struct _sig_config _config;
+
 /* tlvblock consumer for signature TLVs */
 static struct rfc5444_reader_tlvblock_consumer _signature_msg_consumer = {
   .order = RFC5444_VALIDATOR_PRIORITY,
@@ -106,6 +298,8 @@ static struct rfc5444_reader_tlvblock_consumer _signature_msg_consumer = {
 
 static struct rfc5444_reader_tlvblock_consumer _signature_pkt_consumer = {
   .order = RFC5444_VALIDATOR_PRIORITY,
+  .start_callback = _cb_packet_start,
+  .end_callback = _cb_packet_end,
   .block_callback = _cb_signature_tlv,
 };
 
@@ -126,6 +320,31 @@ static struct avl_tree _sig_tree;
 static uint8_t _static_message_buffer[RFC5444_MAX_PACKET_SIZE];
 static uint8_t _crypt_buffer[RFC5444_MAX_PACKET_SIZE];
 
+/* unsigned data and jobs for signature verification */
+static uint8_t _verify_buffer[VERIFY_BUFFER_COUNT][RFC5444_MAX_PACKET_SIZE];
+static size_t _verify_buffer_count;
+static struct _verify_job _verify_jobs[VERIFY_JOB_COUNT];
+static struct worker_job *_verify_job_ptrs[VERIFY_JOB_COUNT];
+static size_t _verify_job_count;
+
+/* results of the signatures of the current packet, checked before parsing its messages */
+static struct _verify_result _packet_results[VERIFY_RESULT_COUNT];
+static size_t _packet_result_count;
+static bool _prechecking;
+
+/* threads for signature verification */
+static struct worker_pool _worker_pool;
+
+/* cache of verified messages */
+static struct avl_tree _verify_cache;
+static struct list_entity _verify_cache_fifo;
+static size_t _verify_cache_count;
+static uint64_t _verify_cache_hits, _verify_cache_misses;
+
+/* telnet command to show verification cache statistics */
+static struct oonf_telnet_command _telnet_cmd =
+  TELNET_CMD("sigcache", _cb_telnet_sigcache, "Shows statistics of the signature verification cache");
+
 /* listeners for crypto and hash algorithms */
 static struct oonf_class_extension _hash_listener = {
   .ext_name = "rfc5444 signatures",
@@ -146,11 +365,24 @@ static struct oonf_class_extension _crypt_listener = {
  */
 static int
 _init(void) {
+  size_t i;
+
   _protocol = oonf_rfc5444_add_protocol(RFC5444_PROTOCOL, true);
   if (_protocol == NULL) {
     return -1;
   }
 
+  avl_init(&_verify_cache, _avl_comp_verify_cache, true);
+  list_init_head(&_verify_cache_fifo);
+  oonf_telnet_add(&_telnet_cmd);
+
+  /* start with verification in the main thread */
+  worker_pool_init(&_worker_pool, 1);
+  for (i = 0; i < VERIFY_JOB_COUNT; i++) {
+    _verify_jobs[i].job.run = _cb_verify_signature;
+    _verify_job_ptrs[i] = &_verify_jobs[i].job;
+  }
+
   rfc5444_reader_add_message_consumer(&_protocol->reader, &_signature_msg_consumer, &_msg_signature_tlv, 1);
   rfc5444_reader_add_packet_consumer(&_protocol->reader, &_signature_pkt_consumer, &_pkt_signature_tlv, 1);
   avl_init(&_sig_tree, _avl_cmp_signatures, true);
@@ -177,6 +409,11 @@ _cleanup(void) {
 
   oonf_class_extension_remove(&_hash_listener);
   oonf_class_extension_remove(&_crypt_listener);
+
+  worker_pool_remove(&_worker_pool);
+
+  _flush_cache(NULL);
+  oonf_telnet_remove(&_telnet_cmd);
 }
 
 /**
@@ -214,10 +451,210 @@ rfc5444_sig_add(struct rfc5444_signature *sig) {
  */
 void
 rfc5444_sig_remove(struct rfc5444_signature *sig) {
+  _flush_cache(sig);
   rfc5444_writer_unregister_postprocessor(&_protocol->writer, &sig->_postprocessor);
   avl_remove(&_sig_tree, &sig->_node);
 }
 
+/**
+ * Callback for the start of a packet. Collects the signature TLVs of the
+ * packet and all its messages and verifies them as one batch before the
+ * messages are parsed, so a worker pool can check the signatures of
+ * different messages in parallel.
+ * @param context rfc5444 packet context
+ * @return always RFC5444_OKAY
+ */
+static enum rfc5444_result
+_cb_packet_start(struct rfc5444_reader_tlvblock_context *context) {
+  struct rfc5444_reader_tlvblock_context msg_context;
+  const uint8_t *ptr, *end, *msg_end;
+  size_t header_length;
+  uint8_t flags;
+  uint16_t size;
+
+  _packet_result_count = 0;
+  if (avl_is_empty(&_sig_tree)) {
+    return RFC5444_OKAY;
+  }
+
+  _prechecking = true;
+  _verify_buffer_count = 0;
+  _verify_job_count = 0;
+
+  ptr = context->pkt_buffer;
+  end = context->pkt_buffer + context->pkt_size;
+
+  /* skip packet header */
+  ptr += context->has_pktseqno ? 3 : 1;
+  if (context->pkt_flags & RFC5444_PKT_FLAG_TLV) {
+    if (ptr + 2 > end || ptr + 2 + 256 * ptr[0] + ptr[1] > end) {
+      _prechecking = false;
+      return RFC5444_OKAY;
+    }
+    _precheck_tlvblock(context, RFC5444_WRITER_PKT_POSTPROCESSOR, RFC7182_PKTTLV_ICV, ptr, end);
+    ptr += 2 + 256 * ptr[0] + ptr[1];
+  }
+
+  /* parse message headers the same way as the rfc5444 reader */
+  while (ptr + 4 <= end) {
+    memset(&msg_context, 0, sizeof(msg_context));
+    msg_context.type = RFC5444_CONTEXT_MESSAGE;
+    msg_context.msg_type = ptr[0];
+    flags = ptr[1];
+    size = 256 * ptr[2] + ptr[3];
+
+    msg_context.addr_len = (flags & RFC5444_MSG_FLAG_ADDRLENMASK) + 1;
+    msg_context.msg_flags = (flags & ~RFC5444_MSG_FLAG_ADDRLENMASK);
+    msg_context.has_origaddr = (flags & RFC5444_MSG_FLAG_ORIGINATOR) != 0;
+    msg_context.has_hoplimit = (flags & RFC5444_MSG_FLAG_HOPLIMIT) != 0;
+    msg_context.has_hopcount = (flags & RFC5444_MSG_FLAG_HOPCOUNT) != 0;
+    msg_context.has_seqno = (flags & RFC5444_MSG_FLAG_SEQNO) != 0;
+
+    /* message header and tlvblock length */
+    header_length = 4 + 2;
+    if (msg_context.has_origaddr) {
+      header_length += msg_context.addr_len;
+    }
+    if (msg_context.has_hoplimit) {
+      header_length++;
+    }
+    if (msg_context.has_hopcount) {
+      header_length++;
+    }
+    if (msg_context.has_seqno) {
+      header_length += 2;
+    }
+
+    msg_end = ptr + size;
+    if (msg_end > end || size < header_length) {
+      /* broken message, the reader will complain about it */
+      break;
+    }
+
+    msg_context.msg_buffer = ptr;
+    msg_context.msg_size = size;
+
+    ptr += 4;
+    if (msg_context.has_origaddr) {
+      netaddr_from_binary(&msg_context.orig_addr, ptr, msg_context.addr_len, 0);
+      ptr += msg_context.addr_len;
+    }
+    if (msg_context.has_hoplimit) {
+      msg_context.hoplimit = *ptr++;
+    }
+    if (msg_context.has_hopcount) {
+      msg_context.hopcount = *ptr++;
+    }
+    if (msg_context.has_seqno) {
+      msg_context.seqno = 256 * ptr[0] + ptr[1];
+      ptr += 2;
+    }
+
+    _precheck_tlvblock(&msg_context, msg_context.msg_type, RFC7182_MSGTLV_ICV, ptr, msg_end);
+    ptr = msg_end;
+  }
+
+  /* check remaining signatures */
+  _run_verify_jobs();
+
+  _prechecking = false;
+  return RFC5444_OKAY;
+}
+
+/**
+ * Callback for the end of a packet, forgets the results of its signatures
+ * @param context rfc5444 packet context
+ * @param dropped true if packet was dropped
+ * @return always RFC5444_OKAY
+ */
+static enum rfc5444_result
+_cb_packet_end(struct rfc5444_reader_tlvblock_context *context __attribute__((unused)),
+  bool dropped __attribute__((unused))) {
+  _packet_result_count = 0;
+  return RFC5444_OKAY;
+}
+
+/**
+ * Collect the signature TLVs of a TLV block for verification
+ * @param context rfc5444 packet or message context
+ * @param msg_type message type, RFC5444_WRITER_PKT_POSTPROCESSOR for packet
+ * @param icv_type TLV type of signature TLV
+ * @param ptr pointer to start of TLV block
+ * @param end end of packet/message
+ */
+static void
+_precheck_tlvblock(struct rfc5444_reader_tlvblock_context *context, int msg_type, uint8_t icv_type,
+  const uint8_t *ptr, const uint8_t *end) {
+  const uint8_t *block_start, *block_end, *tlv;
+  uint8_t type_ext;
+  uint16_t value_length;
+  size_t tlvlen;
+  bool collect;
+
+  if (ptr + 2 > end) {
+    return;
+  }
+  block_start = ptr + 2;
+  block_end = block_start + 256 * ptr[0] + ptr[1];
+  if (block_end > end) {
+    return;
+  }
+
+  /*
+   * validate the whole TLV block first, the unsigned data is generated
+   * from it, then collect the signature TLVs in a second pass
+   */
+  for (collect = false;; collect = true) {
+    for (tlv = block_start; tlv < block_end; tlv += tlvlen + value_length) {
+      if (tlv + 2 > block_end) {
+        return;
+      }
+
+      /* calculate length of TLV like _remove_signature_data() */
+      tlvlen = 2;
+      type_ext = 0;
+      if (tlv[1] & RFC5444_TLV_FLAG_TYPEEXT) {
+        if (tlv + 3 > block_end) {
+          return;
+        }
+        type_ext = tlv[2];
+        tlvlen++;
+      }
+
+      value_length = 0;
+      if (tlv[1] & RFC5444_TLV_FLAG_VALUE) {
+        if (tlv[1] & RFC5444_TLV_FLAG_EXTVALUE) {
+          if (tlv + tlvlen + 2 > block_end) {
+            return;
+          }
+          value_length = 256 * tlv[tlvlen] + tlv[tlvlen + 1];
+          tlvlen += 2;
+        }
+        else {
+          if (tlv + tlvlen + 1 > block_end) {
+            return;
+          }
+          value_length = tlv[tlvlen];
+          tlvlen++;
+        }
+      }
+      if (tlv + tlvlen + value_length > block_end) {
+        return;
+      }
+
+      if (collect && tlv[0] == icv_type && value_length > 0 &&
+          _add_verify_jobs(context, msg_type, type_ext, tlv + tlvlen, value_length)) {
+        /* signature will drop the message anyways */
+        return;
+      }
+    }
+
+    if (collect) {
+      return;
+    }
+  }
+}
+
 /**
  * Callback for checking both message and packet signature TLVs
  * @param context rfc5444 TLV context
@@ -227,19 +664,10 @@ static enum rfc5444_result
 _cb_signature_tlv(struct rfc5444_reader_tlvblock_context *context) {
   struct rfc5444_reader_tlvblock_consumer_entry *sig_tlv;
   struct rfc5444_reader_tlvblock_entry *tlv;
-  struct rfc5444_signature *sig, *sigstart;
-  struct rfc5444_signature_key sigkey;
-  enum rfc5444_sigid_check check;
+  struct rfc5444_signature *sig;
   enum rfc5444_result drop_value;
   int msg_type;
-  uint8_t key_id_len;
-  uint8_t *static_data;
-  size_t static_length, key_length;
-  const void *key;
   bool sig_to_verify;
-#ifdef OONF_LOG_DEBUG_INFO
-  struct netaddr_str nbuf;
-#endif
 
   if (context->type == RFC5444_CONTEXT_PACKET) {
     msg_type = RFC5444_WRITER_PKT_POSTPROCESSOR;
@@ -270,97 +698,441 @@ _cb_signature_tlv(struct rfc5444_reader_tlvblock_context *context) {
 
   OONF_DEBUG(LOG_RFC5444_SIG, "Start checking signature for message type %d", msg_type);
 
+  /*
+   * collect all signatures to check first, most of them have already
+   * been verified at the start of the packet. Results are applied in
+   * the order of the TLVs.
+   */
+  _verify_buffer_count = 0;
+  _verify_job_count = 0;
   for (tlv = sig_tlv->tlv; tlv; tlv = tlv->next_entry) {
-    if (tlv->type_ext != RFC7182_ICV_EXT_CRYPTHASH && tlv->type_ext != RFC7182_ICV_EXT_SRCSPEC_CRYPTHASH) {
-      /* unknown subtype, just ignore */
-      OONF_INFO(LOG_RFC5444_SIG, "Signature with unknown ext-type: %u", tlv->type_ext);
-      continue;
+    if (_add_verify_jobs(context, msg_type, tlv->type_ext, tlv->single_value, tlv->length)) {
+      OONF_INFO(LOG_RFC5444_SIG, "Dropped %s because of wrong key-id",
+        msg_type == RFC5444_WRITER_PKT_POSTPROCESSOR ? "packet" : "message");
+      return drop_value;
     }
-    if (tlv->length < 4) {
-      /* not enough bytes for valid signature */
-      OONF_INFO(LOG_RFC5444_SIG, "Signature tlv too short: %u bytes", tlv->length);
-      continue;
+  }
+
+  /* check remaining signatures */
+  _run_verify_jobs();
+
+  /* check if mandatory signatures are missing or failed*/
+  avl_for_each_element(&_sig_tree, sig, _node) {
+    if (!sig->verified && sig->_must_be_verified) {
+      OONF_INFO(LOG_RFC5444_SIG, "Dropped %s because bad/missing signature",
+        msg_type == RFC5444_WRITER_PKT_POSTPROCESSOR ? "packet" : "message");
+      return drop_value;
+    }
+  }
+
+  OONF_INFO(
+    LOG_RFC5444_SIG, "%s signature valid!", msg_type == RFC5444_WRITER_PKT_POSTPROCESSOR ? "packet" : "message");
+  return RFC5444_OKAY;
+}
+
+/**
+ * Create verification jobs for all registered signatures matching
+ * a signature TLV. Runs the collected jobs if the job array or the
+ * buffers for unsigned data are full.
+ * @param context rfc5444 packet or message context
+ * @param msg_type message type, RFC5444_WRITER_PKT_POSTPROCESSOR for packet
+ * @param type_ext type extension of signature TLV
+ * @param value value of signature TLV
+ * @param length length of signature TLV value
+ * @return true if a signature wants to drop the packet/message because of its key-id
+ */
+static bool
+_add_verify_jobs(struct rfc5444_reader_tlvblock_context *context, int msg_type, uint8_t type_ext,
+  const uint8_t *value, size_t length) {
+  struct rfc5444_signature *sig, *sigstart;
+  struct rfc5444_signature_key sigkey;
+  enum rfc5444_sigid_check check;
+  struct _verify_job *job;
+  uint8_t key_id_len;
+  uint8_t *buffer, *static_data;
+  size_t static_length, unsigned_length;
+  bool buffer_used;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct netaddr_str nbuf;
+#endif
+
+  if (type_ext != RFC7182_ICV_EXT_CRYPTHASH && type_ext != RFC7182_ICV_EXT_SRCSPEC_CRYPTHASH) {
+    /* unknown subtype, just ignore */
+    if (!_prechecking) {
+      OONF_INFO(LOG_RFC5444_SIG, "Signature with unknown ext-type: %u", type_ext);
+    }
+    return false;
+  }
+  if (length < 4) {
+    /* not enough bytes for valid signature */
+    if (!_prechecking) {
+      OONF_INFO(LOG_RFC5444_SIG, "Signature tlv too short: %" PRINTF_SIZE_T_SPECIFIER " bytes", length);
+    }
+    return false;
+  }
+
+  sigkey.hash_function = value[0];
+  sigkey.crypt_function = value[1];
+  key_id_len = value[2];
+
+  if (length <= 3u + key_id_len) {
+    /* not enough bytes for valid signature */
+    if (!_prechecking) {
+      OONF_INFO_HEX(LOG_RFC5444_SIG, value, length, "Signature tlv %u/%u too short: %" PRINTF_SIZE_T_SPECIFIER " bytes",
+        value[0], value[1], length);
     }
+    return false;
+  }
+
+  if (_verify_buffer_count == VERIFY_BUFFER_COUNT) {
+    /* all buffers in use, check collected signatures */
+    _run_verify_jobs();
+  }
+  buffer = _verify_buffer[_verify_buffer_count];
+  buffer_used = false;
 
-    sigkey.hash_function = tlv->single_value[0];
-    sigkey.crypt_function = tlv->single_value[1];
-    key_id_len = tlv->single_value[2];
+  /* assemble static message buffer */
+  if (type_ext == RFC7182_ICV_EXT_SRCSPEC_CRYPTHASH) {
+    OONF_DEBUG(LOG_RFC5444_SIG, "incoming src IP: %s", netaddr_to_string(&nbuf, _protocol->input.src_address));
+
+    /* copy source address into buffer */
+    netaddr_to_binary(buffer, _protocol->input.src_address, RFC5444_MAX_PACKET_SIZE);
+    static_length = netaddr_get_binlength(_protocol->input.src_address);
+  }
+  else {
+    static_length = 0;
+  }
+  memcpy(&buffer[static_length], value, 3 + key_id_len);
+  static_length += 3 + key_id_len;
+
+  static_data = &buffer[static_length];
+  unsigned_length = _remove_signature_data(static_data, context);
+  if (unsigned_length == 0) {
+    /* malformed data, message stays unverified */
+    if (!_prechecking) {
+      OONF_INFO(LOG_RFC5444_SIG, "Malformed TLV block, cannot remove signature");
+    }
+    return false;
+  }
+  static_length += unsigned_length;
 
-    if (tlv->length <= 3 + key_id_len) {
-      /* not enouOONF_LOG_DEBUG_INFOgh bytes for valid signature */
-      OONF_INFO_HEX(LOG_RFC5444_SIG, tlv->single_value, tlv->length, "Signature tlv %u/%u too short: %u bytes",
-        tlv->single_value[0], tlv->single_value[1], tlv->length);
+  /* loop over all possible signatures */
+  avl_for_each_elements_with_key(&_sig_tree, sig, _node, sigstart, &sigkey) {
+    if (!sig->is_matching_signature(sig, msg_type)) {
+      /* signature doesn't apply to this message type */
       continue;
     }
 
-    /* assemble static message buffer */
-    if (tlv->type_ext == RFC7182_ICV_EXT_SRCSPEC_CRYPTHASH) {
-      OONF_DEBUG(LOG_RFC5444_SIG, "incoming src IP: %s", netaddr_to_string(&nbuf, _protocol->input_address));
+    if ((type_ext == RFC7182_ICV_EXT_SRCSPEC_CRYPTHASH) != sig->source_specific) {
+      if (!_prechecking) {
+        OONF_INFO(LOG_RFC5444_SIG, "Signature extension %u does not match", type_ext);
+      }
+      continue;
+    }
 
-      /* copy source address into buffer */
-      netaddr_to_binary(_static_message_buffer, _protocol->input_address, sizeof(_static_message_buffer));
-      static_length = netaddr_get_binlength(_protocol->input_address);
+    /* see how signature want to handle the incoming key id */
+    check = sig->verify_id(sig, &value[3], key_id_len);
+    if (check == RFC5444_SIGID_IGNORE) {
+      /* signature wants to ignore this TLV */
+      continue;
     }
-    else {
-      static_length = 0;
+    if (check == RFC5444_SIGID_DROP) {
+      /* signature wants us to drop this context */
+      return true;
     }
-    memcpy(&_static_message_buffer[static_length], tlv->single_value, 3 + key_id_len);
-    static_length += 3 + key_id_len;
 
-    static_data = &_static_message_buffer[static_length];
-    static_length += _remove_signature_data(static_data, context);
+    /* remember source IP */
+    sig->source = _protocol->input.src_address;
 
-    /* loop over all possible signatures */
-    avl_for_each_elements_with_key(&_sig_tree, sig, _node, sigstart, &sigkey) {
-      if (!sig->is_matching_signature(sig, msg_type)) {
-        /* signature doesn't apply to this message type */
-        continue;
+    if (_verify_job_count == VERIFY_JOB_COUNT) {
+      /* job array full, check collected signatures, the current buffer stays in use */
+      _run_verify_jobs();
+      if (buffer != _verify_buffer[0]) {
+        memcpy(_verify_buffer[0], buffer, static_length);
+        buffer = _verify_buffer[0];
       }
+    }
 
-      if ((tlv->type_ext == RFC7182_ICV_EXT_SRCSPEC_CRYPTHASH) != sig->source_specific) {
-        OONF_INFO(LOG_RFC5444_SIG, "Signature extension %u does not match", tlv->type_ext);
-        continue;
-      }
+    /* remember signature for verification */
+    job = &_verify_jobs[_verify_job_count++];
+    job->sig = sig;
+    job->icv = &value[3 + key_id_len];
+    job->icv_length = length - 3 - key_id_len;
+    job->data = buffer;
+    job->data_length = static_length;
+    job->key = sig->getCryptoKey(sig, &job->key_length);
+
+    job->cacheable = _is_cacheable(context);
+    if (job->cacheable) {
+      _get_cache_key(&job->cache_key, context);
+    }
+
+    job->cached = false;
+    job->known = _get_packet_result(job);
+    if (!job->known && _lookup_cache(job)) {
+      job->result = RFC7182_VALIDATION_OKAY;
+      job->known = true;
+      job->cached = true;
+    }
+    buffer_used = true;
+  }
 
-      /* see how signature want to handle the incoming key id */
-      check = sig->verify_id(sig, &tlv->single_value[3], key_id_len);
-      if (check == RFC5444_SIGID_IGNORE) {
-        /* signature wants to ignore this TLV */
-        continue;
+  if (buffer_used) {
+    _verify_buffer_count++;
+  }
+  return false;
+}
+
+/**
+ * Worker callback to check a single signature
+ * @param ptr pointer to worker job
+ */
+static void
+_cb_verify_signature(struct worker_job *ptr) {
+  struct _verify_job *job;
+  struct rfc5444_signature *sig;
+
+  job = container_of(ptr, struct _verify_job, job);
+  if (job->known) {
+    /* signature has already been verified */
+    return;
+  }
+
+  sig = job->sig;
+  job->result = sig->crypt->validate(
+    sig->crypt, sig->hash, job->icv, job->icv_length, job->data, job->data_length, job->key, job->key_length);
+}
+
+/**
+ * Verify the collected batch of signatures and store the results in
+ * the order they were collected. While the signatures of a packet are
+ * prechecked the results are remembered for the TLV callbacks, otherwise
+ * they are applied to the signatures.
+ */
+static void
+_run_verify_jobs(void) {
+  struct rfc5444_signature *sig;
+  struct _verify_job *job;
+  size_t i;
+
+  worker_pool_run(&_worker_pool, _verify_job_ptrs, _verify_job_count);
+
+  for (i = 0; i < _verify_job_count; i++) {
+    job = &_verify_jobs[i];
+    sig = job->sig;
+
+    if (!job->known) {
+      /* workers do not log, report failures in the main thread */
+      if (job->result != RFC7182_VALIDATION_OKAY) {
+        OONF_INFO(LOG_RFC5444_SIG, "Signature hash=%d/crypt=%d failed: %s", sig->key.hash_function,
+          sig->key.crypt_function, rfc7182_get_validation_string(job->result));
       }
-      if (check == RFC5444_SIGID_DROP) {
-        /* signature wants us to drop this context */
-        OONF_INFO(LOG_RFC5444_SIG, "Dropped message because of wrong key-id");
-        return drop_value;
+      else {
+        _add_cache(job);
       }
+    }
+
+    if (_prechecking) {
+      if (_packet_result_count < VERIFY_RESULT_COUNT) {
+        _packet_results[_packet_result_count].sig = sig;
+        _packet_results[_packet_result_count].icv = job->icv;
+        _packet_results[_packet_result_count].result = job->result;
+        _packet_result_count++;
+      }
+      continue;
+    }
 
-      /* remember source IP */
-      sig->source = _protocol->input_address;
+    sig->verified = job->result == RFC7182_VALIDATION_OKAY;
 
-      /* check signature */
-      key = sig->getCryptoKey(sig, &key_length);
-      sig->verified = sig->crypt->validate(sig->crypt, sig->hash, &tlv->single_value[3 + key_id_len],
-        tlv->length - 3 - key_id_len, _static_message_buffer, static_length, key, key_length);
+    OONF_DEBUG(LOG_RFC5444_SIG, "Checked signature hash=%d/crypt=%d: %s%s", sig->key.hash_function,
+      sig->key.crypt_function, sig->verified ? "check" : "bad",
+      job->cached ? " (cached)" : (job->known ? " (prechecked)" : ""));
+  }
+
+  _verify_buffer_count = 0;
+  _verify_job_count = 0;
+}
 
-      OONF_DEBUG(LOG_RFC5444_SIG, "Checked signature hash=%d/crypt=%d: %s", sig->key.hash_function,
-        sig->key.crypt_function, sig->verified ? "check" : "bad");
+/**
+ * Look for the result of a signature TLV that has already been
+ * checked at the start of the current packet
+ * @param job verification job
+ * @return true if the result was found and copied into the job
+ */
+static bool
+_get_packet_result(struct _verify_job *job) {
+  size_t i;
+
+  if (_prechecking) {
+    return false;
+  }
+
+  for (i = 0; i < _packet_result_count; i++) {
+    if (_packet_results[i].sig == job->sig && _packet_results[i].icv == job->icv) {
+      job->result = _packet_results[i].result;
+      return true;
     }
   }
+  return false;
+}
 
-  /* check if mandatory signatures are missing or failed*/
-  avl_for_each_element(&_sig_tree, sig, _node) {
-    if (!sig->verified && sig->_must_be_verified) {
-      OONF_INFO(LOG_RFC5444_SIG, "Dropped %s because bad/missing signature",
-        msg_type == RFC5444_WRITER_PKT_POSTPROCESSOR ? "packet" : "message");
-      return drop_value;
+/**
+ * @param context rfc5444 context
+ * @return true if verification results of the context can be cached
+ */
+static bool
+_is_cacheable(struct rfc5444_reader_tlvblock_context *context) {
+  return _config.cache_size > 0 && context->type == RFC5444_CONTEXT_MESSAGE && context->has_origaddr &&
+         context->has_seqno;
+}
+
+/**
+ * Fill key of verification cache
+ * @param key pointer to key
+ * @param context rfc5444 message context
+ */
+static void
+_get_cache_key(struct _verify_cache_key *key, struct rfc5444_reader_tlvblock_context *context) {
+  /* key is compared with memcmp, so clear padding */
+  memset(key, 0, sizeof(*key));
+  memcpy(&key->originator, &context->orig_addr, sizeof(key->originator));
+  key->seqno = context->seqno;
+  key->msg_type = context->msg_type;
+}
+
+/**
+ * Look for a byte-identical message which has already been verified
+ * with the same signature and key material
+ * @param job verification job
+ * @return true if the signature of the job is known to be valid
+ */
+static bool
+_lookup_cache(struct _verify_job *job) {
+  struct _verify_cache_entry *entry, *it;
+
+  if (!job->cacheable) {
+    return false;
+  }
+
+  /* drop outdated entries, the oldest ones are at the start of the list */
+  list_for_each_element_safe(&_verify_cache_fifo, entry, _fifo, it) {
+    if (!oonf_clock_is_past(entry->vtime)) {
+      break;
+    }
+    _remove_cache(entry);
+  }
+
+  avl_for_each_elements_with_key(&_verify_cache, entry, _node, it, &job->cache_key) {
+    if (entry->sig == job->sig && entry->icv_length == job->icv_length && entry->data_length == job->data_length &&
+        entry->crypt_key_length == job->key_length && memcmp(entry->icv, job->icv, job->icv_length) == 0 &&
+        memcmp(entry->data, job->data, job->data_length) == 0 &&
+        memcmp(entry->crypt_key, job->key, job->key_length) == 0) {
+      _verify_cache_hits++;
+      return true;
     }
   }
 
-  if (sig_to_verify) {
-    OONF_INFO(
-      LOG_RFC5444_SIG, "%s signature valid!", msg_type == RFC5444_WRITER_PKT_POSTPROCESSOR ? "packet" : "message");
+  _verify_cache_misses++;
+  return false;
+}
+
+/**
+ * Remember a successfully verified signature
+ * @param job verification job
+ */
+static void
+_add_cache(struct _verify_job *job) {
+  struct _verify_cache_entry *entry;
+
+  if (!job->cacheable) {
+    return;
   }
-  return RFC5444_OKAY;
+
+  if (_verify_cache_count >= (size_t)_config.cache_size) {
+    /* remove oldest entry */
+    entry = list_first_element(&_verify_cache_fifo, entry, _fifo);
+    _remove_cache(entry);
+  }
+
+  /* allocate entry and storage for signature, data and key in one block */
+  entry = calloc(1, sizeof(*entry) + job->icv_length + job->data_length + job->key_length);
+  if (!entry) {
+    return;
+  }
+
+  memcpy(&entry->key, &job->cache_key, sizeof(entry->key));
+  entry->sig = job->sig;
+  entry->vtime = oonf_clock_get_absolute(_config.cache_vtime);
+
+  entry->icv = (uint8_t *)(entry + 1);
+  entry->icv_length = job->icv_length;
+  memcpy(entry->icv, job->icv, job->icv_length);
+
+  entry->data = entry->icv + job->icv_length;
+  entry->data_length = job->data_length;
+  memcpy(entry->data, job->data, job->data_length);
+
+  entry->crypt_key = entry->data + job->data_length;
+  entry->crypt_key_length = job->key_length;
+  memcpy(entry->crypt_key, job->key, job->key_length);
+
+  entry->_node.key = &entry->key;
+  avl_insert(&_verify_cache, &entry->_node);
+  list_add_tail(&_verify_cache_fifo, &entry->_fifo);
+  _verify_cache_count++;
+}
+
+/**
+ * Remove an entry from the verification cache
+ * @param entry cache entry
+ */
+static void
+_remove_cache(struct _verify_cache_entry *entry) {
+  avl_remove(&_verify_cache, &entry->_node);
+  list_remove(&entry->_fifo);
+  _verify_cache_count--;
+  free(entry);
+}
+
+/**
+ * Remove entries from the verification cache
+ * @param sig remove only entries of this signature, NULL for all entries
+ */
+static void
+_flush_cache(struct rfc5444_signature *sig) {
+  struct _verify_cache_entry *entry, *it;
+
+  list_for_each_element_safe(&_verify_cache_fifo, entry, _fifo, it) {
+    if (sig == NULL || entry->sig == sig) {
+      _remove_cache(entry);
+    }
+  }
+}
+
+/**
+ * AVL comparator for verification cache keys
+ * @param p1
+ * @param p2
+ * @return
+ */
+static int
+_avl_comp_verify_cache(const void *p1, const void *p2) {
+  return memcmp(p1, p2, sizeof(struct _verify_cache_key));
+}
+
+/**
+ * Telnet command to show statistics of the verification cache
+ * @param con telnet connection
+ * @return always TELNET_RESULT_ACTIVE
+ */
+static enum oonf_telnet_result
+_cb_telnet_sigcache(struct oonf_telnet_data *con) {
+  abuf_appendf(con->out,
+    "entries: %" PRINTF_SIZE_T_SPECIFIER "\n"
+    "hits: %" PRIu64 "\n"
+    "misses: %" PRIu64 "\n",
+    _verify_cache_count, _verify_cache_hits, _verify_cache_misses);
+  return TELNET_RESULT_ACTIVE;
 }
 
 /**
@@ -566,18 +1338,42 @@ _cb_add_signature(struct rfc5444_writer_postprocessor *processor, struct rfc5444
   return 0;
 }
 
+/**
+ * Callback for configuration changes
+ */
+static void
+_cb_config_changed(void) {
+  if (cfg_schema_tobin(&_config, _sig_section.post, _sig_entries, ARRAYSIZE(_sig_entries))) {
+    OONF_WARN(LOG_RFC5444_SIG, "Cannot convert configuration for " OONF_RFC5444_SIG_SUBSYSTEM);
+    return;
+  }
+
+  /* cache size or validity might have changed */
+  _flush_cache(NULL);
+
+  if ((size_t)_config.workers == _worker_pool.threads) {
+    return;
+  }
+
+  worker_pool_remove(&_worker_pool);
+  if (worker_pool_init(&_worker_pool, _config.workers)) {
+    OONF_WARN(LOG_RFC5444_SIG, "Could not start %d signature worker threads, verify in main thread", _config.workers);
+    worker_pool_init(&_worker_pool, 1);
+  }
+}
+
 /**
  * Remove signature TLVs from a message/packet
  * @param dst pointer to destination buffer for unsigned message/packet
  * @param context rfc5444 context
- * @return size of unsigned data
+ * @return size of unsigned data, 0 if the TLV block is malformed
  */
 static size_t
 _remove_signature_data(uint8_t *dst, const struct rfc5444_reader_tlvblock_context *context) {
-  const uint8_t *src_ptr, *src_end;
+  const uint8_t *src_ptr, *src_end, *block_end;
   uint8_t *dst_ptr, *tlvblock;
-  uint16_t len, hoplimit, hopcount;
-  uint16_t blocklen, tlvlen;
+  uint16_t len, hoplimit, hopcount, blocklen;
+  size_t tlvlen;
 
   hoplimit = 0;
   hopcount = 0;
@@ -618,6 +1414,11 @@ _remove_signature_data(uint8_t *dst, const struct rfc5444_reader_tlvblock_contex
   }
   dst_ptr = dst;
 
+  /* the reader only checks TLVs against the end of the message/packet */
+  if (src_ptr + len + 2 > src_end) {
+    return 0;
+  }
+
   /* copy pakcet/message header */
   memcpy(dst_ptr, src_ptr, len);
 
@@ -641,9 +1442,17 @@ _remove_signature_data(uint8_t *dst, const struct rfc5444_reader_tlvblock_contex
   src_ptr += 2;
   dst_ptr += 2;
 
+  block_end = src_ptr + blocklen;
+  if (block_end > src_end) {
+    return 0;
+  }
+
   /* loop over message tlvs */
-  len = blocklen;
-  while (len > 0) {
+  while (src_ptr < block_end) {
+    if (src_ptr + 2 > block_end) {
+      return 0;
+    }
+
     /* calculate length of TLV */
     tlvlen = 2;
     if (src_ptr[1] & RFC5444_TLV_FLAG_TYPEEXT) {
@@ -654,13 +1463,23 @@ _remove_signature_data(uint8_t *dst, const struct rfc5444_reader_tlvblock_contex
       /* TLV has a value field */
       if (src_ptr[1] & RFC5444_TLV_FLAG_EXTVALUE) {
         /* 2-byte value */
+        if (src_ptr + tlvlen + 2 > block_end) {
+          return 0;
+        }
         tlvlen += (256 * src_ptr[tlvlen]) + src_ptr[tlvlen + 1] + 2;
       }
       else {
         /* 1-byte value */
+        if (src_ptr + tlvlen + 1 > block_end) {
+          return 0;
+        }
         tlvlen += src_ptr[tlvlen] + 1;
       }
     }
+    if (src_ptr + tlvlen > block_end) {
+      /* TLV runs over the end of its block */
+      return 0;
+    }
 
     if (src_ptr[0] != RFC7182_MSGTLV_ICV) {
       /* copy TLV if not signature TLV */
@@ -671,7 +1490,6 @@ _remove_signature_data(uint8_t *dst, const struct rfc5444_reader_tlvblock_contex
       /* reduce blocklength */
       blocklen -= tlvlen;
     }
-    len -= tlvlen;
     src_ptr += tlvlen;
   }
 
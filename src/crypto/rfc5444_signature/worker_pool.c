@@ -0,0 +1,197 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <oonf/oonf.h>
+#include <oonf/crypto/rfc5444_signature/worker_pool.h>
+
+static void *_worker_thread(void *ptr);
+
+/**
+ * Initialize a worker pool and start its threads
+ * @param pool worker pool
+ * @param threads number of threads executing a batch including the
+ *    caller of worker_pool_run(), 0 or 1 execute all jobs inline
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+worker_pool_init(struct worker_pool *pool, size_t threads) {
+  memset(pool, 0, sizeof(*pool));
+
+  pool->threads = threads > 0 ? threads : 1;
+  if (pool->threads == 1) {
+    return 0;
+  }
+
+  pool->_workers = calloc(pool->threads - 1, sizeof(pthread_t));
+  if (pool->_workers == NULL) {
+    return -1;
+  }
+
+  pthread_mutex_init(&pool->_mutex, NULL);
+  pthread_cond_init(&pool->_work, NULL);
+  pthread_cond_init(&pool->_done, NULL);
+
+  for (pool->_started = 0; pool->_started < pool->threads - 1; pool->_started++) {
+    if (pthread_create(&pool->_workers[pool->_started], NULL, _worker_thread, pool)) {
+      worker_pool_remove(pool);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Stop the threads of a worker pool and free its resources
+ * @param pool worker pool
+ */
+void
+worker_pool_remove(struct worker_pool *pool) {
+  size_t i;
+
+  if (pool->_workers == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&pool->_mutex);
+  pool->_shutdown = true;
+  pthread_cond_broadcast(&pool->_work);
+  pthread_mutex_unlock(&pool->_mutex);
+
+  for (i = 0; i < pool->_started; i++) {
+    pthread_join(pool->_workers[i], NULL);
+  }
+
+  pthread_cond_destroy(&pool->_done);
+  pthread_cond_destroy(&pool->_work);
+  pthread_mutex_destroy(&pool->_mutex);
+
+  free(pool->_workers);
+  pool->_workers = NULL;
+  pool->_started = 0;
+}
+
+/**
+ * Execute a batch of jobs and wait until all of them are finished.
+ * The calling thread executes jobs too.
+ * @param pool worker pool
+ * @param jobs array of pointers to jobs
+ * @param count number of jobs
+ */
+void
+worker_pool_run(struct worker_pool *pool, struct worker_job **jobs, size_t count) {
+  struct worker_job *job;
+  size_t i;
+
+  if (pool->_started == 0 || count <= 1) {
+    for (i = 0; i < count; i++) {
+      jobs[i]->run(jobs[i]);
+    }
+    return;
+  }
+
+  pthread_mutex_lock(&pool->_mutex);
+  pool->_jobs = jobs;
+  pool->_job_count = count;
+  pool->_next_job = 0;
+  pool->_finished = 0;
+  pthread_cond_broadcast(&pool->_work);
+
+  while (pool->_next_job < pool->_job_count) {
+    job = pool->_jobs[pool->_next_job++];
+
+    pthread_mutex_unlock(&pool->_mutex);
+    job->run(job);
+    pthread_mutex_lock(&pool->_mutex);
+
+    pool->_finished++;
+  }
+
+  /* wait for jobs still running in the worker threads */
+  while (pool->_finished < pool->_job_count) {
+    pthread_cond_wait(&pool->_done, &pool->_mutex);
+  }
+
+  pool->_jobs = NULL;
+  pool->_job_count = 0;
+  pool->_next_job = 0;
+  pthread_mutex_unlock(&pool->_mutex);
+}
+
+/**
+ * Main loop of a worker thread
+ * @param ptr pointer to worker pool
+ * @return always NULL
+ */
+static void *
+_worker_thread(void *ptr) {
+  struct worker_pool *pool = ptr;
+  struct worker_job *job;
+
+  pthread_mutex_lock(&pool->_mutex);
+  while (true) {
+    while (!pool->_shutdown && pool->_next_job >= pool->_job_count) {
+      pthread_cond_wait(&pool->_work, &pool->_mutex);
+    }
+    if (pool->_shutdown) {
+      break;
+    }
+
+    job = pool->_jobs[pool->_next_job++];
+
+    pthread_mutex_unlock(&pool->_mutex);
+    job->run(job);
+    pthread_mutex_lock(&pool->_mutex);
+
+    pool->_finished++;
+    if (pool->_finished == pool->_job_count) {
+      pthread_cond_signal(&pool->_done);
+    }
+  }
+  pthread_mutex_unlock(&pool->_mutex);
+  return NULL;
+}
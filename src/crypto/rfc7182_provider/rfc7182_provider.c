@@ -61,7 +61,7 @@ static int _cb_identity_hash(struct rfc7182_hash *hash, void *dst, size_t *dst_l
 static int _cb_identity_crypt(struct rfc7182_crypt *crypt, void *dst, size_t *dst_len, const void *src, size_t src_len,
   const void *key, size_t key_len);
 
-static bool _cb_validate_by_sign(struct rfc7182_crypt *, struct rfc7182_hash *, const void *encrypted,
+static enum rfc7182_validation _cb_validate_by_sign(struct rfc7182_crypt *, struct rfc7182_hash *, const void *encrypted,
   size_t encrypted_length, const void *src, size_t src_len, const void *key, size_t key_len);
 static int _cb_sign_by_crypthash(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, void *dst, size_t *dst_len,
   const void *src, size_t src_len, const void *key, size_t key_len);
@@ -106,8 +106,8 @@ static struct oonf_class _crypt_class = {
   .size = sizeof(struct rfc7182_crypt),
 };
 
-/* static buffer for crypto calculation */
-static uint8_t _crypt_buffer[1500];
+/* size of temporary buffers for crypto calculation */
+#define RFC7182_CRYPT_BUFFER_SIZE 1500
 
 /**
  * Constructor of subsystem
@@ -201,7 +201,7 @@ rfc7182_add_crypt(struct rfc7182_crypt *crypt) {
   /* hook crypt function into crypt tree */
   avl_insert(&_crypt_functions, &crypt->_node);
 
-  oonf_class_event(&_hash_class, crypt, OONF_OBJECT_ADDED);
+  oonf_class_event(&_crypt_class, crypt, OONF_OBJECT_ADDED);
 }
 
 /**
@@ -223,6 +223,25 @@ rfc7182_get_crypt_tree(void) {
   return &_crypt_functions;
 }
 
+/**
+ * @param result result of signature validation
+ * @return human readable description of result
+ */
+const char *
+rfc7182_get_validation_string(enum rfc7182_validation result) {
+  static const char *strings[] = {
+    [RFC7182_VALIDATION_OKAY] = "okay",
+    [RFC7182_VALIDATION_SIGN_FAILED] = "signature generation failed",
+    [RFC7182_VALIDATION_WRONG_LENGTH] = "wrong signature length",
+    [RFC7182_VALIDATION_MISMATCH] = "signature mismatch",
+  };
+
+  if ((size_t)result >= ARRAYSIZE(strings)) {
+    return "unknown";
+  }
+  return strings[result];
+}
+
 /**
  * 'Identity' hash function as defined in RFC7182
  * @param sig rfc5444 signature
@@ -263,6 +282,7 @@ _cb_identity_crypt(struct rfc7182_crypt *crypt __attribute((unused)), void *dst,
 /**
  * Callback to check a signature by generating a local signature
  * with the 'crypto' callback and then comparing both.
+ * This might run in a worker thread, so it does not log.
  * @param crypt this crypto definition
  * @param hash the definition of the hash
  * @param encrypted pointer to encrypted signature
@@ -271,54 +291,56 @@ _cb_identity_crypt(struct rfc7182_crypt *crypt __attribute((unused)), void *dst,
  * @param src_len length of original data
  * @param key key material for signature
  * @param key_len length of key material
- * @return true if signature matches, false otherwise
+ * @return result of validation
  */
-static bool
+static enum rfc7182_validation
 _cb_validate_by_sign(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, const void *encrypted,
   size_t encrypted_length, const void *src, size_t src_len, const void *key, size_t key_len) {
+  /* use the stack, this callback might run in a worker thread */
+  uint8_t crypt_buffer[RFC7182_CRYPT_BUFFER_SIZE];
   size_t crypt_length;
-  int result;
 
   /* run encryption function */
-  crypt_length = sizeof(_crypt_buffer);
-  if (crypt->sign(crypt, hash, _crypt_buffer, &crypt_length, src, src_len, key, key_len)) {
-    OONF_INFO(LOG_RFC7182_PROVIDER, "Crypto-error when checking signature");
-    return -1;
+  crypt_length = sizeof(crypt_buffer);
+  if (crypt->sign(crypt, hash, crypt_buffer, &crypt_length, src, src_len, key, key_len)) {
+    return RFC7182_VALIDATION_SIGN_FAILED;
   }
 
   /* compare length of both signatures */
   if (crypt_length != encrypted_length) {
-    OONF_INFO(LOG_RFC7182_PROVIDER,
-      "signature has wrong length: "
-      "%" PRINTF_SIZE_T_SPECIFIER " != %" PRINTF_SIZE_T_SPECIFIER,
-      crypt_length, encrypted_length);
-    return -1;
+    return RFC7182_VALIDATION_WRONG_LENGTH;
   }
 
   /* binary compare both signatures */
-  result = memcmp(encrypted, _crypt_buffer, crypt_length);
-  if (result) {
-    OONF_INFO_HEX(LOG_RFC7182_PROVIDER, encrypted, crypt_length, "Received signature:");
-    OONF_INFO_HEX(LOG_RFC7182_PROVIDER, _crypt_buffer, crypt_length, "Expected signature:");
+  if (memcmp(encrypted, crypt_buffer, crypt_length)) {
+    return RFC7182_VALIDATION_MISMATCH;
   }
-  return result == 0;
+  return RFC7182_VALIDATION_OKAY;
 }
 
+/**
+ * Default signature generation, hashes the data and encrypts the hash.
+ * This might run in a worker thread, so it does not log.
+ * @param crypt this crypto definition
+ * @param hash the definition of the hash
+ * @param dst output buffer for signature
+ * @param dst_len pointer to length of output buffer,
+ *   will be set to signature length afterwards
+ * @param src unsigned original data
+ * @param src_len length of original data
+ * @param key key material for signature
+ * @param key_len length of key material
+ * @return -1 if an error happened, 0 otherwise
+ */
 static int
 _cb_sign_by_crypthash(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash, void *dst, size_t *dst_len,
   const void *src, size_t src_len, const void *key, size_t key_len) {
+  uint8_t hash_buffer[RFC7182_CRYPT_BUFFER_SIZE];
   size_t hashed_length;
 
-  hashed_length = sizeof(_crypt_buffer);
-  if (hash->hash(hash, _crypt_buffer, &hashed_length, src, src_len)) {
-    OONF_WARN(LOG_RFC7182_PROVIDER, "Could not generate hash %u", hash->type);
-    return -1;
-  }
-
-  if (crypt->encrypt(crypt, dst, dst_len, _crypt_buffer, hashed_length, key, key_len)) {
-    OONF_WARN(LOG_RFC7182_PROVIDER, "Could not generate crypt %u", crypt->type);
+  hashed_length = sizeof(hash_buffer);
+  if (hash->hash(hash, hash_buffer, &hashed_length, src, src_len)) {
     return -1;
   }
-
-  return 0;
+  return crypt->encrypt(crypt, dst, dst_len, hash_buffer, hashed_length, key, key_len) ? -1 : 0;
 }
@@ -0,0 +1,252 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/avl_comp.h>
+#include <oonf/oonf.h>
+#include <oonf/libcore/oonf_logging.h>
+
+#include <oonf/generic/dlep/dlep_session.h>
+
+/**
+ * internal constants of DLEP parser
+ */
+enum
+{
+  /*! size increase step for DLEP value storage */
+  PARSER_VALUE_STEP = 128,
+};
+
+/**
+ * Initialize the TLV parser of a session
+ * @param parser dlep session parser
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+dlep_parser_init(struct dlep_session_parser *parser) {
+  avl_init(&parser->allowed_tlvs, avl_comp_uint16, false);
+  memset(parser->tlv_table, 0, sizeof(parser->tlv_table));
+  parser->_generation = 0;
+
+  /* preallocate value storage, so typical signals never need a realloc */
+  parser->values = calloc(PARSER_VALUE_STEP, sizeof(struct dlep_parser_value));
+  if (!parser->values) {
+    parser->value_max_count = 0;
+    return -1;
+  }
+  parser->value_max_count = PARSER_VALUE_STEP;
+  return 0;
+}
+
+/**
+ * Free the resources of the TLV parser of a session. The allowed TLVs
+ * must have been removed before.
+ * @param parser dlep session parser
+ */
+void
+dlep_parser_cleanup(struct dlep_session_parser *parser) {
+  size_t i;
+
+  for (i = 0; i < DLEP_PARSER_TLV_PAGE_COUNT; i++) {
+    free(parser->tlv_table[i]);
+    parser->tlv_table[i] = NULL;
+  }
+
+  free(parser->values);
+  parser->values = NULL;
+  parser->value_max_count = 0;
+}
+
+/**
+ * Add a TLV to the allowed TLVs of a parser
+ * @param parser dlep session parser
+ * @param tlv initialized dlep parser TLV
+ * @return -1 if out of memory, 0 otherwise
+ */
+int
+dlep_parser_add_tlv(struct dlep_session_parser *parser, struct dlep_parser_tlv *tlv) {
+  struct dlep_parser_tlv_page **page;
+
+  page = &parser->tlv_table[tlv->id >> DLEP_PARSER_TLV_PAGE_BITS];
+  if (*page == NULL) {
+    *page = calloc(1, sizeof(**page));
+    if (*page == NULL) {
+      return -1;
+    }
+  }
+  (*page)->tlvs[tlv->id & (DLEP_PARSER_TLV_PAGE_SIZE - 1)] = tlv;
+
+  tlv->_node.key = &tlv->id;
+  tlv->_generation = 0;
+  avl_insert(&parser->allowed_tlvs, &tlv->_node);
+  return 0;
+}
+
+/**
+ * Remove a TLV from the allowed TLVs of a parser
+ * @param parser dlep session parser
+ * @param tlv dlep parser TLV
+ */
+void
+dlep_parser_remove_tlv(struct dlep_session_parser *parser, struct dlep_parser_tlv *tlv) {
+  struct dlep_parser_tlv_page *page;
+
+  page = parser->tlv_table[tlv->id >> DLEP_PARSER_TLV_PAGE_BITS];
+  if (page) {
+    page->tlvs[tlv->id & (DLEP_PARSER_TLV_PAGE_SIZE - 1)] = NULL;
+  }
+  avl_remove(&parser->allowed_tlvs, &tlv->_node);
+}
+
+/**
+ * parse a stream of DLEP tlvs
+ * @param parser dlep session parser
+ * @param log_source logging source for parser errors
+ * @param buffer TLV buffer
+ * @param length buffer size
+ * @return DLEP parser status
+ */
+enum dlep_parser_error
+dlep_parser_parse_tlvstream(
+  struct dlep_session_parser *parser, enum oonf_log_source log_source, const uint8_t *buffer, size_t length) {
+  struct dlep_parser_tlv *tlv;
+  struct dlep_parser_value *value;
+  uint16_t tlv_type;
+  uint16_t tlv_length;
+  size_t tlv_count, idx;
+
+  parser->tlv_ptr = buffer;
+  tlv_count = 0;
+  idx = 0;
+
+  /* start a new generation, this invalidates the values of all TLVs */
+  parser->_generation++;
+  if (parser->_generation == 0) {
+    /* generation counter wrapped around, clear all old generations */
+    avl_for_each_element(&parser->allowed_tlvs, tlv, _node) {
+      tlv->_generation = 0;
+    }
+    parser->_generation = 1;
+  }
+
+  while (idx < length) {
+    if (length - idx < 4) {
+      /* too short for a TLV, end parsing */
+      return DLEP_NEW_PARSER_INCOMPLETE_TLV_HEADER;
+    }
+
+    /* copy header */
+    memcpy(&tlv_type, &buffer[idx], sizeof(tlv_type));
+    idx += sizeof(tlv_type);
+    tlv_type = ntohs(tlv_type);
+
+    memcpy(&tlv_length, &buffer[idx], sizeof(tlv_length));
+    idx += sizeof(tlv_length);
+    tlv_length = ntohs(tlv_length);
+
+    if (idx + tlv_length > length) {
+      OONF_WARN(log_source,
+        "TLV %u incomplete: "
+        "%" PRINTF_SIZE_T_SPECIFIER " > %" PRINTF_SIZE_T_SPECIFIER,
+        tlv_type, idx + tlv_length, length);
+      return DLEP_NEW_PARSER_INCOMPLETE_TLV;
+    }
+
+    /* check if tlv is supported */
+    tlv = dlep_parser_get_tlv(parser, tlv_type);
+    if (!tlv) {
+      OONF_INFO(log_source, "Unsupported TLV %u", tlv_type);
+      return DLEP_NEW_PARSER_UNSUPPORTED_TLV;
+    }
+
+    /* check length */
+    if (tlv->length_max < tlv_length || tlv->length_min > tlv_length) {
+      OONF_WARN(log_source,
+        "TLV %u has wrong size,"
+        " %d is not between %u and %u",
+        tlv_type, tlv_length, tlv->length_min, tlv->length_max);
+      return DLEP_NEW_PARSER_ILLEGAL_TLV_LENGTH;
+    }
+
+    /* check if we need to allocate more space for value pointers */
+    if (parser->value_max_count == tlv_count) {
+      /* allocate more */
+      value = realloc(parser->values, sizeof(*value) * (tlv_count + PARSER_VALUE_STEP));
+      if (!value) {
+        return DLEP_NEW_PARSER_OUT_OF_MEMORY;
+      }
+      parser->value_max_count += PARSER_VALUE_STEP;
+      parser->values = value;
+    }
+
+    OONF_DEBUG_HEX(log_source, &buffer[idx], tlv_length, "Received TLV %u", tlv_type);
+
+    /* remember tlv value */
+    value = &parser->values[tlv_count];
+    value->tlv_next = -1;
+    value->index = idx;
+    value->length = tlv_length;
+
+    if (tlv->_generation != parser->_generation) {
+      /* first tlv of this type in signal */
+      tlv->_generation = parser->_generation;
+      tlv->tlv_first = tlv_count;
+    }
+    else {
+      /* one more */
+      value = &parser->values[tlv->tlv_last];
+      value->tlv_next = tlv_count;
+    }
+    tlv->tlv_last = tlv_count;
+    tlv_count++;
+
+    idx += tlv_length;
+  }
+
+  return DLEP_NEW_PARSER_OKAY;
+}
@@ -55,17 +55,7 @@
 #include <oonf/generic/dlep/dlep_session.h>
 #include <oonf/generic/dlep/dlep_writer.h>
 
-/**
- * internal constants of DLEP session
- */
-enum
-{
-  /*! size increase step for DLEP value storage */
-  SESSION_VALUE_STEP = 128,
-};
-
 static int _update_allowed_tlvs(struct dlep_session *session);
-static enum dlep_parser_error _parse_tlvstream(struct dlep_session *session, const uint8_t *buffer, size_t length);
 static enum dlep_parser_error _check_mandatory(
   struct dlep_session *session, struct dlep_extension *ext, int32_t signal_type);
 static enum dlep_parser_error _check_duplicate(
@@ -127,7 +117,12 @@ dlep_session_add(struct dlep_session *session, const char *l2_ifname, const stru
 
   parser = &session->parser;
 
-  avl_init(&parser->allowed_tlvs, avl_comp_uint16, false);
+  /* initialize the parser first, the error path below needs its TLV tree */
+  if (dlep_parser_init(parser)) {
+    OONF_WARN(log_source, "Cannot allocate values buffer for %s", l2_ifname);
+    return -1;
+  }
+
   avl_init(&session->local_neighbor_tree, oonf_layer2_avlcmp_neigh_key, false);
 
   session->log_source = log_source;
@@ -148,13 +143,6 @@ dlep_session_add(struct dlep_session *session, const char *l2_ifname, const stru
     return -1;
   }
 
-  parser->values = calloc(SESSION_VALUE_STEP, sizeof(struct dlep_parser_value));
-  if (!parser->values) {
-    OONF_WARN(session->log_source, "Cannot allocate values buffer for %s", l2_ifname);
-    dlep_session_remove(session);
-    return -1;
-  }
-
   /* generate full list of extensions */
   avl_for_each_element(dlep_extension_get_tree(), ext, _node) {
     OONF_DEBUG(session->log_source, "Add extension %d to session", ext->id);
@@ -193,7 +181,7 @@ dlep_session_remove(struct dlep_session *session) {
 
   parser = &session->parser;
   avl_for_each_element_safe(&parser->allowed_tlvs, tlv, _node, tlv_it) {
-    avl_remove(&parser->allowed_tlvs, &tlv->_node);
+    dlep_parser_remove_tlv(parser, tlv);
     oonf_class_free(&_tlv_class, tlv);
   }
 
@@ -202,8 +190,7 @@ dlep_session_remove(struct dlep_session *session) {
 
   parser->extension_count = 0;
 
-  free(parser->values);
-  parser->values = NULL;
+  dlep_parser_cleanup(parser);
 
   session->_peer_state = DLEP_PEER_NOT_CONNECTED;
 }
@@ -739,7 +726,7 @@ _update_allowed_tlvs(struct dlep_session *session) {
   /* remove all existing allowed tlvs that are not supported anymore */
   avl_for_each_element_safe(&parser->allowed_tlvs, tlv, _node, tlv_it) {
     if (tlv->remove) {
-      avl_remove(&parser->allowed_tlvs, &tlv->_node);
+      dlep_parser_remove_tlv(parser, tlv);
       oonf_class_free(&_tlv_class, tlv);
     }
   }
@@ -805,7 +792,7 @@ _process_tlvs(struct dlep_session *session, int32_t signal_type, uint16_t signal
   struct dlep_extension *ext;
 
   /* start at the beginning of the tlvs */
-  if ((result = _parse_tlvstream(session, tlvs, signal_length))) {
+  if ((result = dlep_parser_parse_tlvstream(&session->parser, session->log_source, tlvs, signal_length))) {
     OONF_DEBUG(session->log_source, "parse_tlvstream result: %d", result);
     return result;
   }
@@ -849,108 +836,6 @@ _cb_destination_timeout(struct oonf_timer_instance *ptr) {
   }
 }
 
-/**
- * parse a stream of DLEP tlvs
- * @param session dlep session
- * @param buffer TLV buffer
- * @param length buffer size
- * @return DLEP parser status
- */
-static enum dlep_parser_error
-_parse_tlvstream(struct dlep_session *session, const uint8_t *buffer, size_t length) {
-  struct dlep_session_parser *parser;
-  struct dlep_parser_tlv *tlv;
-  struct dlep_parser_value *value;
-  uint16_t tlv_type;
-  uint16_t tlv_length;
-  size_t tlv_count, idx;
-
-  parser = &session->parser;
-  parser->tlv_ptr = buffer;
-  tlv_count = 0;
-  idx = 0;
-
-  avl_for_each_element(&parser->allowed_tlvs, tlv, _node) {
-    tlv->tlv_first = -1;
-    tlv->tlv_last = -1;
-  }
-
-  while (idx < length) {
-    if (length - idx < 4) {
-      /* too short for a TLV, end parsing */
-      return DLEP_NEW_PARSER_INCOMPLETE_TLV_HEADER;
-    }
-
-    /* copy header */
-    memcpy(&tlv_type, &buffer[idx], sizeof(tlv_type));
-    idx += sizeof(tlv_type);
-    tlv_type = ntohs(tlv_type);
-
-    memcpy(&tlv_length, &buffer[idx], sizeof(tlv_length));
-    idx += sizeof(tlv_length);
-    tlv_length = ntohs(tlv_length);
-
-    if (idx + tlv_length > length) {
-      OONF_WARN(session->log_source,
-        "TLV %u incomplete: "
-        "%" PRINTF_SIZE_T_SPECIFIER " > %" PRINTF_SIZE_T_SPECIFIER,
-        tlv_type, idx + tlv_length, length);
-      return DLEP_NEW_PARSER_INCOMPLETE_TLV;
-    }
-
-    /* check if tlv is supported */
-    tlv = dlep_parser_get_tlv(parser, tlv_type);
-    if (!tlv) {
-      OONF_INFO(session->log_source, "Unsupported TLV %u", tlv_type);
-      return DLEP_NEW_PARSER_UNSUPPORTED_TLV;
-    }
-
-    /* check length */
-    if (tlv->length_max < tlv_length || tlv->length_min > tlv_length) {
-      OONF_WARN(session->log_source,
-        "TLV %u has wrong size,"
-        " %d is not between %u and %u",
-        tlv_type, tlv_length, tlv->length_min, tlv->length_max);
-      return DLEP_NEW_PARSER_ILLEGAL_TLV_LENGTH;
-    }
-
-    /* check if we need to allocate more space for value pointers */
-    if (parser->value_max_count == tlv_count) {
-      /* allocate more */
-      value = realloc(parser->values, sizeof(*value) * (tlv_count + SESSION_VALUE_STEP));
-      if (!value) {
-        return DLEP_NEW_PARSER_OUT_OF_MEMORY;
-      }
-      parser->value_max_count += SESSION_VALUE_STEP;
-      parser->values = value;
-    }
-
-    OONF_DEBUG_HEX(session->log_source, &buffer[idx], tlv_length, "Received TLV %u", tlv_type);
-
-    /* remember tlv value */
-    value = &parser->values[tlv_count];
-    value->tlv_next = -1;
-    value->index = idx;
-    value->length = tlv_length;
-
-    if (tlv->tlv_last == -1) {
-      /* first tlv */
-      tlv->tlv_first = tlv_count;
-    }
-    else {
-      /* one more */
-      value = &parser->values[tlv->tlv_last];
-      value->tlv_next = tlv_count;
-    }
-    tlv->tlv_last = tlv_count;
-    tlv_count++;
-
-    idx += tlv_length;
-  }
-
-  return DLEP_NEW_PARSER_OKAY;
-}
-
 /**
  * Check if all mandatory TLVs were found
  * @param session dlep session
@@ -989,7 +874,7 @@ _check_mandatory(struct dlep_session *session, struct dlep_extension *ext, int32
       return DLEP_NEW_PARSER_INTERNAL_ERROR;
     }
 
-    if (tlv->tlv_first == -1) {
+    if (!dlep_parser_has_tlv_value(parser, tlv)) {
       OONF_WARN(session->log_source,
         "Missing mandatory TLV"
         " %u in extension %d",
@@ -1031,8 +916,8 @@ _check_duplicate(struct dlep_session *session, struct dlep_extension *ext, int32
   }
 
   for (t = 0; t < extsig->supported_tlv_count; t++) {
-    tlv = avl_find_element(&parser->allowed_tlvs, &extsig->supported_tlvs[t], tlv, _node);
-    if (tlv == NULL || tlv->tlv_first == tlv->tlv_last) {
+    tlv = dlep_parser_get_tlv(parser, extsig->supported_tlvs[t]);
+    if (tlv == NULL || !dlep_parser_has_tlv_value(parser, tlv) || tlv->tlv_first == tlv->tlv_last) {
       continue;
     }
 
@@ -1103,10 +988,12 @@ _add_session_tlv(struct dlep_session_parser *parser, uint16_t id) {
   }
 
   tlv->id = id;
-  tlv->_node.key = &tlv->id;
   tlv->tlv_first = -1;
   tlv->tlv_last = -1;
 
-  avl_insert(&parser->allowed_tlvs, &tlv->_node);
+  if (dlep_parser_add_tlv(parser, tlv)) {
+    oonf_class_free(&_tlv_class, tlv);
+    return NULL;
+  }
   return tlv;
 }
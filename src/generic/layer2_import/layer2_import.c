@@ -108,6 +108,9 @@ struct _import_entry {
   /*! layer2 interface name for all imported entries, might be empty string */
   char fixed_l2if_name[IF_NAMESIZE];
 
+  /*! subscription for kernel routes matching table, protocol, metric and type */
+  struct os_route_mirror_subscriber mirror;
+
   /*! tree of all configured lan import */
   struct avl_node _node;
 };
@@ -120,10 +123,8 @@ static void _cleanup(void);
 static struct _import_entry *_get_import(const char *name);
 static void _remove_import(struct _import_entry *);
 
-static void _cb_query(struct os_route *filter, struct os_route *route);
-static void _cb_query_finished(struct os_route *, int error);
-
-static void _cb_rt_event(const struct os_route *, bool);
+static void _cb_mirror_event(struct os_route_mirror_subscriber *, const struct os_route *, bool);
+static void _import_route(struct _import_entry *import, const struct os_route *route, bool set);
 static void _cb_reload_routes(struct oonf_timer_instance *);
 
 static void _cb_lan_cfg_changed(void);
@@ -248,17 +249,9 @@ static struct oonf_timer_instance _route_reload_instance = {
   .class = &_route_reload,
 };
 
-/* callback filter for dijkstra */
-static struct os_route_listener _routing_listener = {
-  .cb_get = _cb_rt_event,
-};
-
 /* tree of lan importers */
 static struct avl_tree _import_tree;
 
-/* wildcard route for first query */
-static struct os_route _unicast_query;
-
 /**
  * Initialize plugin
  * @return always returns 0 (cannot fail)
@@ -269,20 +262,17 @@ _init(void) {
 
   oonf_class_add(&_import_class);
   oonf_timer_add(&_route_reload);
-  os_routing_listener_add(&_routing_listener);
-
-  /* initialize wildcard query */
-  os_routing_init_wildcard_route(&_unicast_query);
-  _unicast_query.cb_get = _cb_query;
-  _unicast_query.cb_finished = _cb_query_finished;
-  _unicast_query.p.type = OS_ROUTE_UNDEFINED;
   return 0;
 }
 
 static void
 _initiate_shutdown(void) {
+  struct _import_entry *import;
+
   /* we are not interested in listening to all the routing cleanup */
-  os_routing_listener_remove(&_routing_listener);
+  avl_for_each_element(&_import_tree, import, _node) {
+    os_routing_mirror_remove(&import->mirror);
+  }
 }
 
 /**
@@ -300,24 +290,6 @@ _cleanup(void) {
   oonf_class_remove(&_import_class);
 }
 
-/**
- * Wrapper for cb_get for wildcard query
- * @param filter unused filter
- * @param route route found by wildcard query
- */
-static void
-_cb_query(struct os_route *filter __attribute__((unused)), struct os_route *route) {
-  _cb_rt_event(route, true);
-}
-
-/**
- * Dummy cb_finished callback for wildcard query
- * @param route route that was finished
- * @param error error code
- */
-static void
-_cb_query_finished(struct os_route *route __attribute__((unused)), int error __attribute__((unused))) {}
-
 /**
 * Remove old IP entries going to the same destination but different gateway
 * and remember (if available) the one with the same gateway
@@ -359,13 +331,37 @@ _remove_old_entries(struct oonf_layer2_net *l2net, struct _import_entry *import,
 }
 
 /**
- * Callback for route listener
+ * Callback for kernel route mirror
+ * @param subscriber route mirror subscriber of import
  * @param route routing data
  * @param set true if route was set, false otherwise
  */
 static void
-_cb_rt_event(const struct os_route *route, bool set) {
+_cb_mirror_event(struct os_route_mirror_subscriber *subscriber, const struct os_route *route, bool set) {
   struct _import_entry *import;
+
+  if (netaddr_is_in_subnet(&NETADDR_IPV4_MULTICAST, &route->p.key.dst) ||
+      netaddr_is_in_subnet(&NETADDR_IPV4_LINKLOCAL, &route->p.key.dst) ||
+      netaddr_is_in_subnet(&NETADDR_IPV4_LOOPBACK_NET, &route->p.key.dst) ||
+      netaddr_is_in_subnet(&NETADDR_IPV6_MULTICAST, &route->p.key.dst) ||
+      netaddr_is_in_subnet(&NETADDR_IPV6_LINKLOCAL, &route->p.key.dst) ||
+      netaddr_is_in_subnet(&NETADDR_IPV6_LOOPBACK, &route->p.key.dst)) {
+    /* ignore multicast, linklocal and loopback */
+    return;
+  }
+
+  import = container_of(subscriber, struct _import_entry, mirror);
+  _import_route(import, route, set);
+}
+
+/**
+ * Apply a kernel route change to one import
+ * @param import import entry
+ * @param route routing data
+ * @param set true if route was set, false otherwise
+ */
+static void
+_import_route(struct _import_entry *import, const struct os_route *route, bool set) {
   char ifname[IF_NAMESIZE];
   struct oonf_layer2_net *l2net;
   struct oonf_layer2_neigh *l2neigh;
@@ -379,149 +375,138 @@ _cb_rt_event(const struct os_route *route, bool set) {
   struct os_route_str rbuf;
 #endif
 
-  if (netaddr_is_in_subnet(&NETADDR_IPV4_MULTICAST, &route->p.key.dst) ||
-      netaddr_is_in_subnet(&NETADDR_IPV4_LINKLOCAL, &route->p.key.dst) ||
-      netaddr_is_in_subnet(&NETADDR_IPV4_LOOPBACK_NET, &route->p.key.dst) ||
-      netaddr_is_in_subnet(&NETADDR_IPV6_MULTICAST, &route->p.key.dst) ||
-      netaddr_is_in_subnet(&NETADDR_IPV6_LINKLOCAL, &route->p.key.dst) ||
-      netaddr_is_in_subnet(&NETADDR_IPV6_LOOPBACK, &route->p.key.dst)) {
-    /* ignore multicast, linklocal and loopback */
-    return;
-  }
-  OONF_DEBUG(
-    LOG_L2_IMPORT, "Received route event (%s): %s", set ? "set" : "remove", os_routing_to_string(&rbuf, &route->p));
+  OONF_DEBUG(LOG_L2_IMPORT, "Received route event (%s) for import %s: %s", set ? "set" : "remove", import->name,
+    os_routing_to_string(&rbuf, &route->p));
 
   /* get interface name for route */
+  ifname[0] = 0;
   if (route->p.if_index) {
     if_indextoname(route->p.if_index, ifname);
   }
-  avl_for_each_element(&_import_tree, import, _node) {
-    OONF_DEBUG(LOG_L2_IMPORT, "Check for import: %s", import->name);
-
-    if (import->rttype != route->p.type) {
-      OONF_DEBUG(LOG_L2_IMPORT, "Bad routing type %u (filter was %d)",
-                 route->p.type, import->rttype);
-      return;
-    }
 
-    /* check prefix length */
-    if (import->prefix_length != -1 && import->prefix_length != netaddr_get_prefix_length(&route->p.key.dst)) {
-      OONF_DEBUG(LOG_L2_IMPORT, "Bad prefix length %u (filter was %d)",
-                 netaddr_get_prefix_length(&route->p.key.dst), import->prefix_length);
-      continue;
-    }
+  if (import->rttype != route->p.type) {
+    OONF_DEBUG(LOG_L2_IMPORT, "Bad routing type %u (filter was %d)",
+               route->p.type, import->rttype);
+    return;
+  }
 
-    /* check if destination matches */
-    if (!netaddr_acl_check_accept(&import->filter, &route->p.key.dst)) {
-      OONF_DEBUG(LOG_L2_IMPORT, "Bad prefix %s", netaddr_to_string(&nbuf, &route->p.key.dst));
-      continue;
-    }
+  /* check prefix length */
+  if (import->prefix_length != -1 && import->prefix_length != netaddr_get_prefix_length(&route->p.key.dst)) {
+    OONF_DEBUG(LOG_L2_IMPORT, "Bad prefix length %u (filter was %d)",
+               netaddr_get_prefix_length(&route->p.key.dst), import->prefix_length);
+    return;
+  }
 
-    /* check routing table */
-    if (import->table != -1 && import->table != route->p.table) {
-      OONF_DEBUG(LOG_L2_IMPORT, "Bad routing table %u (filter was %d)", route->p.table, import->table);
-      continue;
-    }
+  /* check if destination matches */
+  if (!netaddr_acl_check_accept(&import->filter, &route->p.key.dst)) {
+    OONF_DEBUG(LOG_L2_IMPORT, "Bad prefix %s", netaddr_to_string(&nbuf, &route->p.key.dst));
+    return;
+  }
 
-    /* check protocol only for setting routes, its not reported for removing ones */
-    if (set && import->protocol != -1 && import->protocol != route->p.protocol) {
-      OONF_DEBUG(LOG_L2_IMPORT, "Bad protocol %u (filter was %d)", route->p.protocol, import->protocol);
-      continue;
-    }
+  /* check routing table */
+  if (import->table != -1 && import->table != route->p.table) {
+    OONF_DEBUG(LOG_L2_IMPORT, "Bad routing table %u (filter was %d)", route->p.table, import->table);
+    return;
+  }
 
-    /* check metric */
-    if (import->distance != -1 && import->distance != route->p.metric) {
-      OONF_DEBUG(LOG_L2_IMPORT, "Bad distance %u (filter was %d)", route->p.metric, import->distance);
-      continue;
-    }
+  /* check protocol only for setting routes, its not reported for removing ones */
+  if (set && import->protocol != -1 && import->protocol != route->p.protocol) {
+    OONF_DEBUG(LOG_L2_IMPORT, "Bad protocol %u (filter was %d)", route->p.protocol, import->protocol);
+    return;
+  }
 
-    /* check interface name */
-    if (import->ifname[0]) {
-      if (!route->p.if_index) {
-        OONF_DEBUG(LOG_L2_IMPORT, "No interface set (filter was '%s')", import->ifname);
-        continue;
-      }
-      if (strcmp(import->ifname, ifname) != 0) {
-        OONF_DEBUG(LOG_L2_IMPORT, "Bad interface '%s' (filter was '%s')", ifname, import->ifname);
-        continue;
-      }
-    }
+  /* check metric */
+  if (import->distance != -1 && import->distance != route->p.metric) {
+    OONF_DEBUG(LOG_L2_IMPORT, "Bad distance %u (filter was %d)", route->p.metric, import->distance);
+    return;
+  }
 
-    /* see if user wants to overwrite layer2 network name */
-    if (import->fixed_l2if_name[0]) {
-      l2ifname = import->fixed_l2if_name;
+  /* check interface name */
+  if (import->ifname[0]) {
+    if (!route->p.if_index) {
+      OONF_DEBUG(LOG_L2_IMPORT, "No interface set (filter was '%s')", import->ifname);
+      return;
     }
-    else {
-      l2ifname = ifname;
+    if (strcmp(import->ifname, ifname) != 0) {
+      OONF_DEBUG(LOG_L2_IMPORT, "Bad interface '%s' (filter was '%s')", ifname, import->ifname);
+      return;
     }
+  }
+
+  /* see if user wants to overwrite layer2 network name */
+  if (import->fixed_l2if_name[0]) {
+    l2ifname = import->fixed_l2if_name;
+  }
+  else {
+    l2ifname = ifname;
+  }
+
+  OONF_DEBUG(LOG_L2_IMPORT, "Write imported route to l2 interface %s (%s)", l2ifname, import->fixed_l2if_name);
+  /* get layer2 network */
+  if (set) {
+    l2net = oonf_layer2_net_add(l2ifname);
+  }
+  else {
+    l2net = oonf_layer2_net_get(l2ifname);
+  }
+  if (!l2net) {
+    OONF_DEBUG(LOG_L2_IMPORT, "No l2 network '%s' found", l2ifname);
+    return;
+  }
 
-    OONF_DEBUG(LOG_L2_IMPORT, "Write imported route to l2 interface %s (%s)", l2ifname, import->fixed_l2if_name);
-    /* get layer2 network */
-    if (set) {
-      l2net = oonf_layer2_net_add(l2ifname);
+  mac = NULL;
+  macifname = "";
+  if (import->fixed_mac_if[0]) {
+    if (import->fixed_if_listener.data) {
+      mac = &import->fixed_if_listener.data->mac;
+      macifname = import->fixed_if_listener.data->name;
     }
-    else {
-      l2net = oonf_layer2_net_get(l2ifname);
+  }
+  else {
+    mac = &l2net->if_listener.data->mac;
+    macifname = l2net->if_listener.data->name;
+  }
+  if (netaddr_is_unspec(mac)) {
+    OONF_DEBUG(LOG_L2_IMPORT, "Wait for interface (%s) data to be initialized", macifname);
+    if (!oonf_timer_is_active(&_route_reload_instance)) {
+      oonf_timer_set(&_route_reload_instance, 1000);
     }
-    if (!l2net) {
-      OONF_DEBUG(LOG_L2_IMPORT, "No l2 network '%s' found", l2ifname);
+    return;
+  }
+
+  dst = &route->p.key.dst;
+  gw = &route->p.gw;
+
+  l2neigh_ip = _remove_old_entries(l2net, import, gw, dst);
+  l2neigh = NULL;
+  /* get layer2 neighbor */
+  if (set && !l2neigh_ip) {
+    /* generate l2 key including LID */
+    if (oonf_layer2_neigh_generate_lid(&nb_key, &import->l2origin, mac)) {
+      OONF_WARN(LOG_L2_IMPORT, "Could not generate LID for MAC %s (if %s)",
+          netaddr_to_string(&nbuf, mac), macifname);
       return;
     }
 
-    mac = NULL;
-    macifname = "";
-    if (import->fixed_mac_if[0]) {
-      if (import->fixed_if_listener.data) {
-        mac = &import->fixed_if_listener.data->mac;
-        macifname = import->fixed_if_listener.data->name;
-      }
-    }
-    else {
-      mac = &l2net->if_listener.data->mac;
-      macifname = l2net->if_listener.data->name;
-    }
-    if (netaddr_is_unspec(mac)) {
-      OONF_DEBUG(LOG_L2_IMPORT, "Wait for interface (%s) data to be initialized", macifname);
-      if (!oonf_timer_is_active(&_route_reload_instance)) {
-        oonf_timer_set(&_route_reload_instance, 1000);
-      }
+    l2neigh = oonf_layer2_neigh_add_lid(l2net, &nb_key);
+    if (!l2neigh) {
+      OONF_DEBUG(LOG_L2_IMPORT, "No l2 neighbor found");
       return;
     }
 
-    dst = &route->p.key.dst;
-    gw = &route->p.gw;
-
-    l2neigh_ip = _remove_old_entries(l2net, import, gw, dst);
-    l2neigh = NULL;
-    /* get layer2 neighbor */
-    if (set && !l2neigh_ip) {
-      /* generate l2 key including LID */
-      if (oonf_layer2_neigh_generate_lid(&nb_key, &import->l2origin, mac)) {
-        OONF_WARN(LOG_L2_IMPORT, "Could not generate LID for MAC %s (if %s)",
-            netaddr_to_string(&nbuf, mac), macifname);
-        continue;
-      }
-
-      l2neigh = oonf_layer2_neigh_add_lid(l2net, &nb_key);
-      if (!l2neigh) {
-        OONF_DEBUG(LOG_L2_IMPORT, "No l2 neighbor found");
-        return;
-      }
-
-      OONF_DEBUG(LOG_L2_IMPORT, "Import layer2 neighbor...");
+    OONF_DEBUG(LOG_L2_IMPORT, "Import layer2 neighbor...");
 
-      /* make sure next hop is initialized */
-      oonf_layer2_neigh_set_nexthop(l2neigh, gw);
-      if (!oonf_layer2_neigh_get_remote_ip(l2neigh, dst)) {
-        oonf_layer2_neigh_add_ip(l2neigh, &import->l2origin, dst);
-      }
-      oonf_layer2_neigh_commit(l2neigh);
-    }
-    else if (!set && l2neigh_ip) {
-      l2neigh = l2neigh_ip->l2neigh;
-      oonf_layer2_neigh_remove_ip(l2neigh_ip, &import->l2origin);
-      oonf_layer2_neigh_commit(l2neigh);
+    /* make sure next hop is initialized */
+    oonf_layer2_neigh_set_nexthop(l2neigh, gw);
+    if (!oonf_layer2_neigh_get_remote_ip(l2neigh, dst)) {
+      oonf_layer2_neigh_add_ip(l2neigh, &import->l2origin, dst);
     }
+    oonf_layer2_neigh_commit(l2neigh);
+  }
+  else if (!set && l2neigh_ip) {
+    l2neigh = l2neigh_ip->l2neigh;
+    oonf_layer2_neigh_remove_ip(l2neigh_ip, &import->l2origin);
+    oonf_layer2_neigh_commit(l2neigh);
   }
 }
 
@@ -560,6 +545,10 @@ _get_import(const char *name) {
   /* initialize l2 fixed interface listener */
   import->fixed_if_listener.name = import->fixed_mac_if;
 
+  /* initialize route mirror subscription */
+  os_routing_init_wildcard_route(&import->mirror.filter);
+  import->mirror.cb_get = _cb_mirror_event;
+
   return import;
 }
 
@@ -569,6 +558,7 @@ _get_import(const char *name) {
  */
 static void
 _remove_import(struct _import_entry *import) {
+  os_routing_mirror_remove(&import->mirror);
   oonf_layer2_origin_remove(&import->l2origin);
   avl_remove(&_import_tree, &import->_node);
   netaddr_acl_remove(&import->filter);
@@ -581,9 +571,11 @@ _remove_import(struct _import_entry *import) {
  */
 static void
 _cb_reload_routes(struct oonf_timer_instance *timer __attribute__((unused))) {
-  /* trigger wildcard query */
-  if (!os_routing_is_in_progress(&_unicast_query)) {
-    os_routing_query(&_unicast_query);
+  struct _import_entry *import;
+
+  /* get routes from the route mirror, no need to query the kernel again */
+  avl_for_each_element(&_import_tree, import, _node) {
+    os_routing_mirror_replay(&import->mirror);
   }
 }
 
@@ -652,7 +644,12 @@ _cb_cfg_changed(struct cfg_schema_section *section, char *section_name) {
     os_interface_add(&import->fixed_if_listener);
   }
 
-  if (!oonf_timer_is_active(&_route_reload_instance)) {
-    oonf_timer_set(&_route_reload_instance, 1000);
-  }
+  /* let the route mirror do the cheap part of the filtering */
+  import->mirror.filter.p.type = import->rttype;
+  import->mirror.filter.p.table = import->table > 0 ? import->table : RT_TABLE_UNSPEC;
+  import->mirror.filter.p.protocol = import->protocol > 0 ? import->protocol : RTPROT_UNSPEC;
+  import->mirror.filter.p.metric = import->distance;
+
+  /* subscribe or get all matching routes again */
+  os_routing_mirror_add(&import->mirror);
 }
@@ -82,8 +82,10 @@ static void _initialize_neigh_values(struct oonf_layer2_neigh *neigh);
 static void _initialize_neigh_ip_values(struct oonf_layer2_neighbor_address *neigh_addr);
 
 static int _cb_create_text_interface(struct oonf_viewer_template *);
+static int _cb_create_text_interface_object(struct oonf_viewer_template *, void *);
 static int _cb_create_text_interface_ip(struct oonf_viewer_template *);
 static int _cb_create_text_neighbor(struct oonf_viewer_template *);
+static int _cb_create_text_neighbor_object(struct oonf_viewer_template *, void *);
 static int _cb_create_text_neighbor_ip(struct oonf_viewer_template *);
 static int _cb_create_text_default(struct oonf_viewer_template *);
 static int _cb_create_text_dst(struct oonf_viewer_template *);
@@ -293,6 +295,8 @@ static struct oonf_viewer_template _templates[] = {
     .data_size = ARRAYSIZE(_td_if),
     .json_name = "interface",
     .cb_function = _cb_create_text_interface,
+    .class_name = LAYER2_CLASS_NETWORK,
+    .cb_object = _cb_create_text_interface_object,
   },
   {
     .data = _td_if_ips,
@@ -305,6 +309,8 @@ static struct oonf_viewer_template _templates[] = {
     .data_size = ARRAYSIZE(_td_neigh),
     .json_name = "neighbor",
     .cb_function = _cb_create_text_neighbor,
+    .class_name = LAYER2_CLASS_NEIGHBOR,
+    .cb_object = _cb_create_text_neighbor_object,
   },
   {
     .data = _td_neigh_ips,
@@ -419,8 +425,8 @@ _cleanup(void) {
  */
 static enum oonf_telnet_result
 _cb_layer2info(struct oonf_telnet_data *con) {
-  return oonf_viewer_telnet_handler(
-    con->out, &_template_storage, OONF_LAYER2INFO_SUBSYSTEM, con->parameter, _templates, ARRAYSIZE(_templates));
+  return oonf_viewer_telnet_session_handler(
+    con, &_template_storage, OONF_LAYER2INFO_SUBSYSTEM, _templates, ARRAYSIZE(_templates));
 }
 
 /**
@@ -589,16 +595,30 @@ _cb_create_text_interface(struct oonf_viewer_template *template) {
   struct oonf_layer2_net *net;
 
   avl_for_each_element(oonf_layer2_get_net_tree(), net, _node) {
-    _initialize_if_values(net);
-    _initialize_if_data_values(template, net->data);
-    _initialize_if_origin_values(net->data);
-
-    /* generate template output */
-    oonf_viewer_output_print_line(template);
+    _cb_create_text_interface_object(template, net);
   }
   return 0;
 }
 
+/**
+ * Display a single layer2 interface
+ * @param template oonf viewer template
+ * @param ptr layer2 interface
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_interface_object(struct oonf_viewer_template *template, void *ptr) {
+  struct oonf_layer2_net *net = ptr;
+
+  _initialize_if_values(net);
+  _initialize_if_data_values(template, net->data);
+  _initialize_if_origin_values(net->data);
+
+  /* generate template output */
+  oonf_viewer_output_print_line(template);
+  return 0;
+}
+
 /**
  * Callback to generate text/json description of all layer2 interface ips
  * @param template viewer template
@@ -633,20 +653,33 @@ _cb_create_text_neighbor(struct oonf_viewer_template *template) {
   struct oonf_layer2_net *net;
 
   avl_for_each_element(oonf_layer2_get_net_tree(), net, _node) {
-    _initialize_if_values(net);
-
     avl_for_each_element(&net->neighbors, neigh, _node) {
-      _initialize_neigh_values(neigh);
-      _initialize_neigh_data_values(template, neigh->data);
-      _initialize_neigh_origin_values(neigh->data);
-
-      /* generate template output */
-      oonf_viewer_output_print_line(template);
+      _cb_create_text_neighbor_object(template, neigh);
     }
   }
   return 0;
 }
 
+/**
+ * Display a single layer2 neighbor
+ * @param template oonf viewer template
+ * @param ptr layer2 neighbor
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_neighbor_object(struct oonf_viewer_template *template, void *ptr) {
+  struct oonf_layer2_neigh *neigh = ptr;
+
+  _initialize_if_values(neigh->network);
+  _initialize_neigh_values(neigh);
+  _initialize_neigh_data_values(template, neigh->data);
+  _initialize_neigh_origin_values(neigh->data);
+
+  /* generate template output */
+  oonf_viewer_output_print_line(template);
+  return 0;
+}
+
 /**
  * Callback to generate text/json description of all layer2 neighbor ips
  * @param template viewer template
@@ -58,6 +58,7 @@
 #include <oonf/base/oonf_telnet.h>
 #include <oonf/base/oonf_viewer.h>
 #include <oonf/base/os_interface.h>
+#include <oonf/base/os_routing.h>
 
 #include <oonf/generic/systeminfo/systeminfo.h>
 
@@ -77,6 +78,7 @@ static void _initialize_memory_values(struct oonf_viewer_template *template, str
 static void _initialize_timer_values(struct oonf_viewer_template *template, struct oonf_timer_class *tc);
 static void _initialize_socket_values(struct oonf_viewer_template *template, struct oonf_socket_entry *sock);
 static void _initialize_logging_values(struct oonf_viewer_template *template, enum oonf_log_source source);
+static void _initialize_routing_values(struct oonf_viewer_template *template);
 static void _initialize_interface_key_values(struct oonf_viewer_template *template, struct os_interface *);
 static void _initialize_interface_data_values(struct oonf_viewer_template *template, struct os_interface *);
 static void _initialize_ifaddr_data_values(struct oonf_viewer_template *template, struct os_interface_ip *);
@@ -87,6 +89,7 @@ static int _cb_create_text_memory(struct oonf_viewer_template *);
 static int _cb_create_text_timer(struct oonf_viewer_template *);
 static int _cb_create_text_socket(struct oonf_viewer_template *);
 static int _cb_create_text_logging(struct oonf_viewer_template *);
+static int _cb_create_text_routing(struct oonf_viewer_template *);
 static int _cb_create_text_interface(struct oonf_viewer_template *);
 static int _cb_create_text_ifaddr(struct oonf_viewer_template *);
 static int _cb_create_text_ifpeer(struct oonf_viewer_template *);
@@ -124,6 +127,21 @@ static int _cb_create_text_ifpeer(struct oonf_viewer_template *);
 /*! template key for recycled memory blocks */
 #define KEY_MEMORY_RECYCLED "memory_recycled"
 
+/*! template key for slab size of memory class */
+#define KEY_MEMORY_SLAB_SIZE "memory_slab_size"
+
+/*! template key for number of slabs of memory class */
+#define KEY_MEMORY_SLABS "memory_slabs"
+
+/*! template key for number of empty slabs of memory class */
+#define KEY_MEMORY_SLAB_EMPTY "memory_slab_empty"
+
+/*! template key for total slab allocations */
+#define KEY_MEMORY_SLAB_ALLOC "memory_slab_alloc"
+
+/*! template key for slabs returned to the system */
+#define KEY_MEMORY_SLAB_RELEASED "memory_slab_released"
+
 /*! template key for timer usage */
 #define KEY_TIMER_USAGE "timer_usage"
 
@@ -139,6 +157,12 @@ static int _cb_create_text_ifpeer(struct oonf_viewer_template *);
 /*! template key for socket receive events */
 #define KEY_SOCKET_RECV "socket_recv"
 
+/*! template key for number of datagrams received by a socket */
+#define KEY_SOCKET_RECV_PACKETS "socket_recv_packets"
+
+/*! template key for average number of datagrams received per receive event */
+#define KEY_SOCKET_RECV_BATCH "socket_recv_batch"
+
 /*! template key for socket send events */
 #define KEY_SOCKET_SEND "socket_send"
 
@@ -151,6 +175,27 @@ static int _cb_create_text_ifpeer(struct oonf_viewer_template *);
 /*! template key for number of warnings per logging source */
 #define KEY_LOG_WARNINGS "log_warnings"
 
+/*! template key for number of netlink buffers sent to program kernel routes */
+#define KEY_ROUTING_BUFFERS "routing_buffers"
+
+/*! template key for number of netlink messages sent to program kernel routes */
+#define KEY_ROUTING_MESSAGES "routing_messages"
+
+/*! template key for number of netlink bytes sent to program kernel routes */
+#define KEY_ROUTING_BYTES "routing_bytes"
+
+/*! template key for number of routing messages processed by the kernel */
+#define KEY_ROUTING_DONE "routing_done"
+
+/*! template key for number of failed routing messages */
+#define KEY_ROUTING_FAILED "routing_failed"
+
+/*! template key for number of routing feedback timeouts */
+#define KEY_ROUTING_TIMEOUTS "routing_timeouts"
+
+/*! template key for maximum number of routing messages in transit */
+#define KEY_ROUTING_MAX_IN_TRANSIT "routing_max_in_transit"
+
 #define KEY_IF_NAME "if_name"
 #define KEY_IF_INDEX "if_index"
 #define KEY_IF_BASEIDX "if_baseidx"
@@ -188,6 +233,11 @@ static struct isonumber_str _value_memory_usage;
 static struct isonumber_str _value_memory_freelist;
 static struct isonumber_str _value_memory_alloc;
 static struct isonumber_str _value_memory_recycled;
+static struct isonumber_str _value_memory_slab_size;
+static struct isonumber_str _value_memory_slabs;
+static struct isonumber_str _value_memory_slab_empty;
+static struct isonumber_str _value_memory_slab_alloc;
+static struct isonumber_str _value_memory_slab_released;
 
 static struct isonumber_str _value_timer_usage;
 static struct isonumber_str _value_timer_change;
@@ -195,12 +245,22 @@ static struct isonumber_str _value_timer_fire;
 static struct isonumber_str _value_timer_long;
 
 static struct isonumber_str _value_socket_recv;
+static struct isonumber_str _value_socket_recv_packets;
+static struct isonumber_str _value_socket_recv_batch;
 static struct isonumber_str _value_socket_send;
 static struct isonumber_str _value_socket_long;
 
 static char _value_log_source[64];
 static struct isonumber_str _value_log_warnings;
 
+static struct isonumber_str _value_routing_buffers;
+static struct isonumber_str _value_routing_messages;
+static struct isonumber_str _value_routing_bytes;
+static struct isonumber_str _value_routing_done;
+static struct isonumber_str _value_routing_failed;
+static struct isonumber_str _value_routing_timeouts;
+static struct isonumber_str _value_routing_max_in_transit;
+
 static char _value_if_name[IF_NAMESIZE];
 static char _value_if_index[21];
 static char _value_if_baseidx[21];
@@ -236,6 +296,11 @@ static struct abuf_template_data_entry _tde_memory_key[] = {
   { KEY_MEMORY_FREELIST, _value_memory_freelist.buf, false },
   { KEY_MEMORY_ALLOC, _value_memory_alloc.buf, false },
   { KEY_MEMORY_RECYCLED, _value_memory_recycled.buf, false },
+  { KEY_MEMORY_SLAB_SIZE, _value_memory_slab_size.buf, false },
+  { KEY_MEMORY_SLABS, _value_memory_slabs.buf, false },
+  { KEY_MEMORY_SLAB_EMPTY, _value_memory_slab_empty.buf, false },
+  { KEY_MEMORY_SLAB_ALLOC, _value_memory_slab_alloc.buf, false },
+  { KEY_MEMORY_SLAB_RELEASED, _value_memory_slab_released.buf, false },
 };
 static struct abuf_template_data_entry _tde_timer_key[] = {
   { KEY_STATISTICS_NAME, _value_stat_name, true },
@@ -247,6 +312,8 @@ static struct abuf_template_data_entry _tde_timer_key[] = {
 static struct abuf_template_data_entry _tde_socket_key[] = {
   { KEY_STATISTICS_NAME, _value_stat_name, true },
   { KEY_SOCKET_RECV, _value_socket_recv.buf, false },
+  { KEY_SOCKET_RECV_PACKETS, _value_socket_recv_packets.buf, false },
+  { KEY_SOCKET_RECV_BATCH, _value_socket_recv_batch.buf, false },
   { KEY_SOCKET_SEND, _value_socket_send.buf, false },
   { KEY_SOCKET_LONG, _value_socket_long.buf, false },
 };
@@ -254,6 +321,15 @@ static struct abuf_template_data_entry _tde_logging_key[] = {
   { KEY_LOG_SOURCE, _value_log_source, true },
   { KEY_LOG_WARNINGS, _value_log_warnings.buf, false },
 };
+static struct abuf_template_data_entry _tde_routing_key[] = {
+  { KEY_ROUTING_BUFFERS, _value_routing_buffers.buf, false },
+  { KEY_ROUTING_MESSAGES, _value_routing_messages.buf, false },
+  { KEY_ROUTING_BYTES, _value_routing_bytes.buf, false },
+  { KEY_ROUTING_DONE, _value_routing_done.buf, false },
+  { KEY_ROUTING_FAILED, _value_routing_failed.buf, false },
+  { KEY_ROUTING_TIMEOUTS, _value_routing_timeouts.buf, false },
+  { KEY_ROUTING_MAX_IN_TRANSIT, _value_routing_max_in_transit.buf, false },
+};
 static struct abuf_template_data_entry _tde_if_key[] = {
   { KEY_IF_NAME, _value_if_name, true },
   { KEY_IF_INDEX, _value_if_index, false },
@@ -301,6 +377,9 @@ static struct abuf_template_data _td_socket[] = {
 static struct abuf_template_data _td_logging[] = {
   { _tde_logging_key, ARRAYSIZE(_tde_logging_key) },
 };
+static struct abuf_template_data _td_routing[] = {
+  { _tde_routing_key, ARRAYSIZE(_tde_routing_key) },
+};
 static struct abuf_template_data _td_if[] = {
   { _tde_if_key, ARRAYSIZE(_tde_if_key) },
   { _tde_if_data, ARRAYSIZE(_tde_if_data) },
@@ -348,6 +427,12 @@ static struct oonf_viewer_template _templates[] = {
     .json_name = "logging",
     .cb_function = _cb_create_text_logging,
   },
+  {
+    .data = _td_routing,
+    .data_size = ARRAYSIZE(_td_routing),
+    .json_name = "routing",
+    .cb_function = _cb_create_text_routing,
+  },
   {
     .data = _td_if,
     .data_size = ARRAYSIZE(_td_if),
@@ -437,7 +522,7 @@ _cb_systeminfo_help(struct oonf_telnet_data *con) {
 static void
 _initialize_time_values(struct oonf_viewer_template *template) {
   oonf_log_get_walltime(&_value_system_time);
-  isonumber_from_u64(&_value_internal_time, oonf_clock_getNow(), "", 3, template->create_raw);
+  isonumber_from_u64(&_value_internal_time, oonf_clock_getNow(), "", 1000, template->create_raw);
 }
 
 /**
@@ -456,10 +541,15 @@ static void
 _initialize_memory_values(struct oonf_viewer_template *template, struct oonf_class *cl) {
   strscpy(_value_stat_name, cl->name, sizeof(_value_stat_name));
 
-  isonumber_from_u64(&_value_memory_usage, oonf_class_get_usage(cl), "", 0, template->create_raw);
-  isonumber_from_u64(&_value_memory_freelist, oonf_class_get_free(cl), "", 0, template->create_raw);
-  isonumber_from_u64(&_value_memory_alloc, oonf_class_get_allocations(cl), "", 0, template->create_raw);
-  isonumber_from_u64(&_value_memory_recycled, oonf_class_get_recycled(cl), "", 0, template->create_raw);
+  isonumber_from_u64(&_value_memory_usage, oonf_class_get_usage(cl), "", 1, template->create_raw);
+  isonumber_from_u64(&_value_memory_freelist, oonf_class_get_free(cl), "", 1, template->create_raw);
+  isonumber_from_u64(&_value_memory_alloc, oonf_class_get_allocations(cl), "", 1, template->create_raw);
+  isonumber_from_u64(&_value_memory_recycled, oonf_class_get_recycled(cl), "", 1, template->create_raw);
+  isonumber_from_u64(&_value_memory_slab_size, oonf_class_get_slab_size(cl), "", 1, template->create_raw);
+  isonumber_from_u64(&_value_memory_slabs, oonf_class_get_slabs(cl), "", 1, template->create_raw);
+  isonumber_from_u64(&_value_memory_slab_empty, oonf_class_get_empty_slabs(cl), "", 1, template->create_raw);
+  isonumber_from_u64(&_value_memory_slab_alloc, oonf_class_get_slab_allocations(cl), "", 1, template->create_raw);
+  isonumber_from_u64(&_value_memory_slab_released, oonf_class_get_slab_releases(cl), "", 1, template->create_raw);
 }
 
 /**
@@ -469,10 +559,10 @@ static void
 _initialize_timer_values(struct oonf_viewer_template *template, struct oonf_timer_class *tc) {
   strscpy(_value_stat_name, tc->name, sizeof(_value_stat_name));
 
-  isonumber_from_u64(&_value_timer_usage, oonf_timer_get_usage(tc), "", 0, template->create_raw);
-  isonumber_from_u64(&_value_timer_change, oonf_timer_get_changes(tc), "", 0, template->create_raw);
-  isonumber_from_u64(&_value_timer_fire, oonf_timer_get_fired(tc), "", 0, template->create_raw);
-  isonumber_from_u64(&_value_timer_long, oonf_timer_get_long(tc), "", 0, template->create_raw);
+  isonumber_from_u64(&_value_timer_usage, oonf_timer_get_usage(tc), "", 1, template->create_raw);
+  isonumber_from_u64(&_value_timer_change, oonf_timer_get_changes(tc), "", 1, template->create_raw);
+  isonumber_from_u64(&_value_timer_fire, oonf_timer_get_fired(tc), "", 1, template->create_raw);
+  isonumber_from_u64(&_value_timer_long, oonf_timer_get_long(tc), "", 1, template->create_raw);
 }
 
 /**
@@ -480,11 +570,20 @@ _initialize_timer_values(struct oonf_viewer_template *template, struct oonf_time
  */
 static void
 _initialize_socket_values(struct oonf_viewer_template *template, struct oonf_socket_entry *sock) {
+  uint64_t batch = 0;
+
   strscpy(_value_stat_name, sock->name, sizeof(_value_stat_name));
 
-  isonumber_from_u64(&_value_socket_recv, oonf_socket_get_recv(sock), "", 0, template->create_raw);
-  isonumber_from_u64(&_value_socket_send, oonf_socket_get_send(sock), "", 0, template->create_raw);
-  isonumber_from_u64(&_value_socket_long, oonf_socket_get_long(sock), "", 0, template->create_raw);
+  if (oonf_socket_get_recv(sock) > 0) {
+    /* packets per receive event with three fractional digits */
+    batch = (uint64_t)oonf_socket_get_recv_packets(sock) * 1000 / oonf_socket_get_recv(sock);
+  }
+
+  isonumber_from_u64(&_value_socket_recv, oonf_socket_get_recv(sock), "", 1, template->create_raw);
+  isonumber_from_u64(&_value_socket_recv_packets, oonf_socket_get_recv_packets(sock), "", 1, template->create_raw);
+  isonumber_from_u64(&_value_socket_recv_batch, batch, "", 1000, template->create_raw);
+  isonumber_from_u64(&_value_socket_send, oonf_socket_get_send(sock), "", 1, template->create_raw);
+  isonumber_from_u64(&_value_socket_long, oonf_socket_get_long(sock), "", 1, template->create_raw);
 }
 
 /**
@@ -495,7 +594,26 @@ _initialize_socket_values(struct oonf_viewer_template *template, struct oonf_soc
 static void
 _initialize_logging_values(struct oonf_viewer_template *template, enum oonf_log_source source) {
   strscpy(_value_log_source, LOG_SOURCE_NAMES[source], sizeof(_value_log_source));
-  isonumber_from_u64(&_value_log_warnings, oonf_log_get_warning_count(source), "", 0, template->create_raw);
+  isonumber_from_u64(&_value_log_warnings, oonf_log_get_warning_count(source), "", 1, template->create_raw);
+}
+
+/**
+ * Initialize the value buffers for the kernel route programming statistics
+ * @param template viewer template
+ */
+static void
+_initialize_routing_values(struct oonf_viewer_template *template) {
+  const struct os_system_netlink_statistics *stats;
+
+  stats = os_routing_get_statistics();
+
+  isonumber_from_u64(&_value_routing_buffers, stats->buffers_sent, "", 1, template->create_raw);
+  isonumber_from_u64(&_value_routing_messages, stats->messages_sent, "", 1, template->create_raw);
+  isonumber_from_u64(&_value_routing_bytes, stats->bytes_sent, "", 1, template->create_raw);
+  isonumber_from_u64(&_value_routing_done, stats->messages_done, "", 1, template->create_raw);
+  isonumber_from_u64(&_value_routing_failed, stats->messages_failed, "", 1, template->create_raw);
+  isonumber_from_u64(&_value_routing_timeouts, stats->timeouts, "", 1, template->create_raw);
+  isonumber_from_u64(&_value_routing_max_in_transit, stats->max_in_transit, "", 1, template->create_raw);
 }
 
 /**
@@ -653,6 +771,20 @@ _cb_create_text_logging(struct oonf_viewer_template *template) {
   return 0;
 }
 
+/**
+ * Callback to generate text/json description of the kernel route programming
+ * @param template viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_routing(struct oonf_viewer_template *template) {
+  _initialize_routing_values(template);
+
+  /* generate template output */
+  oonf_viewer_output_print_line(template);
+  return 0;
+}
+
 /**
  * Callback to generate text/json description for interfaces
  * @param template viewer template
@@ -0,0 +1,307 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/heap.h>
+
+/*! initial number of node pointers allocated by a heap */
+#define HEAP_MIN_SIZE 32
+
+static bool _is_before(const struct heap_node *node1, const struct heap_node *node2);
+static void _set(struct heap *heap, uint32_t idx, struct heap_node *node);
+static void _sift_up(struct heap *heap, uint32_t idx);
+static void _sift_down(struct heap *heap, uint32_t idx);
+
+/**
+ * Initialize a new heap
+ * @param heap pointer to heap
+ */
+void
+heap_init(struct heap *heap) {
+  heap->_nodes = NULL;
+  heap->count = 0;
+  heap->_size = 0;
+  heap->_next_seq = 0;
+}
+
+/**
+ * Release the memory of a heap, all nodes are removed from it
+ * @param heap pointer to heap
+ */
+void
+heap_free(struct heap *heap) {
+  uint32_t i;
+
+  for (i = 0; i < heap->count; i++) {
+    heap->_nodes[i]->_index = 0;
+  }
+
+  free(heap->_nodes);
+  heap_init(heap);
+}
+
+/**
+ * Make sure the heap can store a number of nodes without
+ * allocating more memory
+ * @param heap pointer to heap
+ * @param size number of nodes
+ * @return -1 if out of memory, 0 otherwise
+ */
+int
+heap_reserve(struct heap *heap, uint32_t size) {
+  struct heap_node **nodes;
+  uint32_t new_size;
+
+  if (size <= heap->_size) {
+    return 0;
+  }
+
+  new_size = heap->_size < HEAP_MIN_SIZE ? HEAP_MIN_SIZE : heap->_size;
+  while (new_size < size) {
+    new_size *= 2;
+  }
+
+  nodes = realloc(heap->_nodes, sizeof(*nodes) * new_size);
+  if (!nodes) {
+    return -1;
+  }
+
+  heap->_nodes = nodes;
+  heap->_size = new_size;
+  return 0;
+}
+
+/**
+ * Add a node to a heap, the key of the node must already be set
+ * @param heap pointer to heap
+ * @param node pointer to heap node
+ * @return -1 if out of memory, 0 otherwise
+ */
+int
+heap_insert(struct heap *heap, struct heap_node *node) {
+  if (heap_reserve(heap, heap->count + 1)) {
+    return -1;
+  }
+
+  node->_seq = heap->_next_seq++;
+  _set(heap, heap->count, node);
+  heap->count++;
+
+  _sift_up(heap, heap->count - 1);
+  return 0;
+}
+
+/**
+ * Remove a node from a heap
+ * @param heap pointer to heap
+ * @param node pointer to heap node, nothing happens if it is not in the heap
+ */
+void
+heap_remove(struct heap *heap, struct heap_node *node) {
+  struct heap_node *last;
+  uint32_t idx;
+
+  if (node->_index == 0) {
+    return;
+  }
+
+  idx = node->_index - 1;
+  node->_index = 0;
+
+  heap->count--;
+  if (idx == heap->count) {
+    /* node was the last one in the array */
+    return;
+  }
+
+  /* move last node into the gap and restore heap order */
+  last = heap->_nodes[heap->count];
+  _set(heap, idx, last);
+
+  if (idx > 0 && _is_before(last, heap->_nodes[(idx - 1) / 2])) {
+    _sift_up(heap, idx);
+  }
+  else {
+    _sift_down(heap, idx);
+  }
+}
+
+/**
+ * Decrease the key of a node in the heap. A node with a new key
+ * is moved behind all nodes with the same key.
+ * @param heap pointer to heap
+ * @param node pointer to heap node
+ * @param key new key, must be smaller or equal than the current one
+ */
+void
+heap_decrease_key(struct heap *heap, struct heap_node *node, uint64_t key) {
+  if (key == node->key) {
+    return;
+  }
+
+  node->key = key;
+  node->_seq = heap->_next_seq++;
+  _sift_up(heap, node->_index - 1);
+}
+
+/**
+ * Change the key of a node in the heap. A node with a new key
+ * is moved behind all nodes with the same key.
+ * @param heap pointer to heap
+ * @param node pointer to heap node
+ * @param key new key
+ */
+void
+heap_set_key(struct heap *heap, struct heap_node *node, uint64_t key) {
+  uint64_t old_key;
+
+  old_key = node->key;
+  if (key == old_key) {
+    return;
+  }
+
+  node->key = key;
+  node->_seq = heap->_next_seq++;
+
+  if (key < old_key) {
+    _sift_up(heap, node->_index - 1);
+  }
+  else if (key > old_key) {
+    _sift_down(heap, node->_index - 1);
+  }
+}
+
+/**
+ * Remove the node with the lowest key from the heap
+ * @param heap pointer to heap
+ * @return pointer to removed node, NULL if heap was empty
+ */
+struct heap_node *
+heap_extract_min(struct heap *heap) {
+  struct heap_node *node;
+
+  if (heap->count == 0) {
+    return NULL;
+  }
+
+  node = heap->_nodes[0];
+  heap_remove(heap, node);
+  return node;
+}
+
+/**
+ * Compare the heap order of two nodes
+ * @param node1 pointer to first heap node
+ * @param node2 pointer to second heap node
+ * @return true if node1 leaves the heap before node2
+ */
+static bool
+_is_before(const struct heap_node *node1, const struct heap_node *node2) {
+  return node1->key < node2->key || (node1->key == node2->key && node1->_seq < node2->_seq);
+}
+
+/**
+ * Store a node at a position of the heap array
+ * @param heap pointer to heap
+ * @param idx array position
+ * @param node pointer to heap node
+ */
+static void
+_set(struct heap *heap, uint32_t idx, struct heap_node *node) {
+  heap->_nodes[idx] = node;
+  node->_index = idx + 1;
+}
+
+/**
+ * Move a node towards the root of the heap until its parent
+ * leaves the heap before it
+ * @param heap pointer to heap
+ * @param idx array position of node
+ */
+static void
+_sift_up(struct heap *heap, uint32_t idx) {
+  struct heap_node *node;
+  uint32_t parent;
+
+  node = heap->_nodes[idx];
+  while (idx > 0) {
+    parent = (idx - 1) / 2;
+    if (_is_before(heap->_nodes[parent], node)) {
+      break;
+    }
+
+    _set(heap, idx, heap->_nodes[parent]);
+    idx = parent;
+  }
+  _set(heap, idx, node);
+}
+
+/**
+ * Move a node towards the leaves of the heap until it
+ * leaves the heap before both children
+ * @param heap pointer to heap
+ * @param idx array position of node
+ */
+static void
+_sift_down(struct heap *heap, uint32_t idx) {
+  struct heap_node *node;
+  uint32_t child;
+
+  node = heap->_nodes[idx];
+  while ((child = 2 * idx + 1) < heap->count) {
+    if (child + 1 < heap->count && _is_before(heap->_nodes[child + 1], heap->_nodes[child])) {
+      child++;
+    }
+    if (_is_before(node, heap->_nodes[child])) {
+      break;
+    }
+
+    _set(heap, idx, heap->_nodes[child]);
+    idx = child;
+  }
+  _set(heap, idx, node);
+}
@@ -0,0 +1,439 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/list.h>
+#include <oonf/libcommon/lpm_trie.h>
+#include <oonf/libcommon/netaddr.h>
+
+static int _get_family_index(const struct netaddr *addr);
+static int _get_bit(const struct netaddr *addr, uint8_t idx);
+static uint8_t _get_common_prefix(const struct netaddr *addr1, const struct netaddr *addr2, uint8_t max_len);
+static struct _lpm_trie_vertex *_create_vertex(const struct netaddr *prefix, uint8_t prefix_len);
+static void _set_child(struct _lpm_trie_vertex *parent, struct _lpm_trie_vertex *child);
+static void _replace_vertex(
+  struct lpm_trie *trie, int idx, struct _lpm_trie_vertex *old, struct _lpm_trie_vertex *vertex);
+static void _add_node(struct lpm_trie *trie, struct _lpm_trie_vertex *vertex, struct lpm_trie_node *node);
+static void _free_vertex(struct _lpm_trie_vertex *vertex);
+
+/**
+ * Initialize a new longest prefix match trie
+ * @param trie pointer to trie
+ */
+void
+lpm_trie_init(struct lpm_trie *trie) {
+  memset(trie, 0, sizeof(*trie));
+}
+
+/**
+ * Release the memory of a trie, all nodes are removed from it
+ * @param trie pointer to trie
+ */
+void
+lpm_trie_free(struct lpm_trie *trie) {
+  int i;
+
+  for (i = 0; i < LPM_TRIE_FAMILY_COUNT; i++) {
+    if (trie->_root[i]) {
+      _free_vertex(trie->_root[i]);
+      trie->_root[i] = NULL;
+    }
+  }
+  trie->count = 0;
+}
+
+/**
+ * Add a node to a trie. Multiple nodes with the same key are allowed.
+ * @param trie pointer to trie
+ * @param node pointer to trie node, key must be initialized
+ * @return 0 if node was added, -1 if the address family is not
+ *   supported or an out of memory error happened
+ */
+int
+lpm_trie_insert(struct lpm_trie *trie, struct lpm_trie_node *node) {
+  struct _lpm_trie_vertex *vertex, *parent, *new_vertex, *branch;
+  uint8_t key_len, vertex_len, common;
+  int idx;
+
+  idx = _get_family_index(node->key);
+  if (idx < 0) {
+    return -1;
+  }
+  key_len = netaddr_get_prefix_length(node->key);
+
+  /* find the position of the key in the trie */
+  parent = NULL;
+  common = 0;
+  vertex = trie->_root[idx];
+  while (vertex) {
+    vertex_len = netaddr_get_prefix_length(&vertex->prefix);
+    common = _get_common_prefix(&vertex->prefix, node->key, vertex_len < key_len ? vertex_len : key_len);
+    if (common < vertex_len) {
+      /* key is not inside the prefix of this vertex */
+      break;
+    }
+    if (vertex_len == key_len) {
+      /* vertex for this key already exists */
+      _add_node(trie, vertex, node);
+      return 0;
+    }
+
+    parent = vertex;
+    vertex = vertex->child[_get_bit(node->key, vertex_len)];
+  }
+
+  new_vertex = _create_vertex(node->key, key_len);
+  if (new_vertex == NULL) {
+    return -1;
+  }
+
+  if (vertex == NULL) {
+    /* add as a new leaf */
+    if (parent) {
+      _set_child(parent, new_vertex);
+    }
+    else {
+      trie->_root[idx] = new_vertex;
+    }
+  }
+  else if (common == key_len) {
+    /* key is a prefix of the vertex, put it in front of it */
+    _replace_vertex(trie, idx, vertex, new_vertex);
+    _set_child(new_vertex, vertex);
+  }
+  else {
+    /* key and vertex diverge, branch at their common prefix */
+    branch = _create_vertex(node->key, common);
+    if (branch == NULL) {
+      free(new_vertex);
+      return -1;
+    }
+    _replace_vertex(trie, idx, vertex, branch);
+    _set_child(branch, vertex);
+    _set_child(branch, new_vertex);
+  }
+
+  _add_node(trie, new_vertex, node);
+  return 0;
+}
+
+/**
+ * Remove a node from a trie
+ * @param trie pointer to trie
+ * @param node pointer to trie node
+ */
+void
+lpm_trie_remove(struct lpm_trie *trie, struct lpm_trie_node *node) {
+  struct _lpm_trie_vertex *vertex, *parent, *child;
+  int idx;
+
+  vertex = node->_vertex;
+  if (vertex == NULL) {
+    return;
+  }
+
+  list_remove(&node->_node);
+  node->_vertex = NULL;
+  trie->count--;
+
+  idx = _get_family_index(&vertex->prefix);
+
+  /* remove vertices that are not necessary anymore */
+  while (vertex != NULL && list_is_empty(&vertex->nodes)) {
+    if (vertex->child[0] != NULL && vertex->child[1] != NULL) {
+      /* vertex is still necessary to branch between two subtries */
+      return;
+    }
+
+    parent = vertex->parent;
+    child = vertex->child[0] != NULL ? vertex->child[0] : vertex->child[1];
+
+    if (child != NULL) {
+      /* parent keeps the same number of children */
+      _replace_vertex(trie, idx, vertex, child);
+      free(vertex);
+      return;
+    }
+
+    if (parent != NULL) {
+      parent->child[parent->child[0] == vertex ? 0 : 1] = NULL;
+    }
+    else {
+      trie->_root[idx] = NULL;
+    }
+    free(vertex);
+
+    /* parent lost a child, check if it is still necessary */
+    vertex = parent;
+  }
+}
+
+/**
+ * Find the first node with exactly the key
+ * @param trie pointer to trie
+ * @param key pointer to key (address and prefix length)
+ * @return pointer to trie node, NULL if not found
+ */
+struct lpm_trie_node *
+lpm_trie_find(const struct lpm_trie *trie, const struct netaddr *key) {
+  struct _lpm_trie_vertex *vertex;
+  uint8_t key_len, vertex_len;
+  int idx;
+
+  idx = _get_family_index(key);
+  if (idx < 0) {
+    return NULL;
+  }
+  key_len = netaddr_get_prefix_length(key);
+
+  vertex = trie->_root[idx];
+  while (vertex) {
+    vertex_len = netaddr_get_prefix_length(&vertex->prefix);
+    if (vertex_len > key_len || _get_common_prefix(&vertex->prefix, key, vertex_len) < vertex_len) {
+      return NULL;
+    }
+    if (vertex_len == key_len) {
+      if (list_is_empty(&vertex->nodes)) {
+        return NULL;
+      }
+      return list_first_element(&vertex->nodes, (struct lpm_trie_node *)NULL, _node);
+    }
+    vertex = vertex->child[_get_bit(key, vertex_len)];
+  }
+  return NULL;
+}
+
+/**
+ * Find the node with the longest prefix that contains an address
+ * @param trie pointer to trie
+ * @param addr pointer to address, if the address has a prefix
+ *   length only prefixes containing the whole prefix are matching
+ * @return pointer to trie node, NULL if no prefix contains the address
+ */
+struct lpm_trie_node *
+lpm_trie_find_best(const struct lpm_trie *trie, const struct netaddr *addr) {
+  struct _lpm_trie_vertex *vertex, *best;
+  uint8_t addr_len, vertex_len;
+  int idx;
+
+  idx = _get_family_index(addr);
+  if (idx < 0) {
+    return NULL;
+  }
+  addr_len = netaddr_get_prefix_length(addr);
+
+  best = NULL;
+  vertex = trie->_root[idx];
+  while (vertex) {
+    vertex_len = netaddr_get_prefix_length(&vertex->prefix);
+    if (vertex_len > addr_len || _get_common_prefix(&vertex->prefix, addr, vertex_len) < vertex_len) {
+      break;
+    }
+    if (!list_is_empty(&vertex->nodes)) {
+      best = vertex;
+    }
+    if (vertex_len == addr_len) {
+      break;
+    }
+    vertex = vertex->child[_get_bit(addr, vertex_len)];
+  }
+
+  if (best == NULL) {
+    return NULL;
+  }
+  return list_first_element(&best->nodes, (struct lpm_trie_node *)NULL, _node);
+}
+
+/**
+ * @param addr pointer to address
+ * @return index of the root vertex for the address family,
+ *   -1 if the family is not supported
+ */
+static int
+_get_family_index(const struct netaddr *addr) {
+  switch (netaddr_get_address_family(addr)) {
+    case AF_INET:
+      return 0;
+    case AF_INET6:
+      return 1;
+    case AF_MAC48:
+      return 2;
+    case AF_EUI64:
+      return 3;
+    default:
+      return -1;
+  }
+}
+
+/**
+ * @param addr pointer to address
+ * @param idx index of bit, 0 is the most significant bit
+ * @return value of the bit (0 or 1)
+ */
+static int
+_get_bit(const struct netaddr *addr, uint8_t idx) {
+  const uint8_t *bin = netaddr_get_binptr(addr);
+
+  return (bin[idx >> 3] >> (7 - (idx & 7))) & 1;
+}
+
+/**
+ * @param addr1 pointer to first address
+ * @param addr2 pointer to second address
+ * @param max_len maximum number of bits to compare
+ * @return number of leading bits both addresses have in common
+ */
+static uint8_t
+_get_common_prefix(const struct netaddr *addr1, const struct netaddr *addr2, uint8_t max_len) {
+  const uint8_t *bin1, *bin2;
+  unsigned len, bytes;
+  uint8_t diff;
+
+  bin1 = netaddr_get_binptr(addr1);
+  bin2 = netaddr_get_binptr(addr2);
+
+  /* compare full bytes first */
+  bytes = 0;
+  while (bytes < (unsigned)(max_len >> 3) && bin1[bytes] == bin2[bytes]) {
+    bytes++;
+  }
+
+  len = bytes << 3;
+  if (len < max_len) {
+    diff = bin1[bytes] ^ bin2[bytes];
+    while (len < max_len && (diff & (0x80u >> (len & 7u))) == 0) {
+      len++;
+    }
+  }
+  return (uint8_t)len;
+}
+
+/**
+ * Allocate a new trie vertex
+ * @param prefix pointer to prefix
+ * @param prefix_len prefix length of the vertex
+ * @return pointer to vertex, NULL if out of memory
+ */
+static struct _lpm_trie_vertex *
+_create_vertex(const struct netaddr *prefix, uint8_t prefix_len) {
+  struct _lpm_trie_vertex *vertex;
+
+  vertex = calloc(1, sizeof(*vertex));
+  if (vertex == NULL) {
+    return NULL;
+  }
+
+  memcpy(&vertex->prefix, prefix, sizeof(*prefix));
+  netaddr_set_prefix_length(&vertex->prefix, prefix_len);
+  list_init_head(&vertex->nodes);
+  return vertex;
+}
+
+/**
+ * Hook a vertex into the subtrie of another one
+ * @param parent pointer to parent vertex
+ * @param child pointer to vertex with a longer prefix than the parent
+ */
+static void
+_set_child(struct _lpm_trie_vertex *parent, struct _lpm_trie_vertex *child) {
+  parent->child[_get_bit(&child->prefix, netaddr_get_prefix_length(&parent->prefix))] = child;
+  child->parent = parent;
+}
+
+/**
+ * Put a vertex at the position of another one in the trie
+ * @param trie pointer to trie
+ * @param idx family index of both vertices
+ * @param old pointer to vertex that is replaced
+ * @param vertex pointer to new vertex
+ */
+static void
+_replace_vertex(struct lpm_trie *trie, int idx, struct _lpm_trie_vertex *old, struct _lpm_trie_vertex *vertex) {
+  vertex->parent = old->parent;
+  if (old->parent == NULL) {
+    trie->_root[idx] = vertex;
+  }
+  else {
+    old->parent->child[old->parent->child[0] == old ? 0 : 1] = vertex;
+  }
+}
+
+/**
+ * Add a trie node to a vertex
+ * @param trie pointer to trie
+ * @param vertex pointer to vertex
+ * @param node pointer to trie node
+ */
+static void
+_add_node(struct lpm_trie *trie, struct _lpm_trie_vertex *vertex, struct lpm_trie_node *node) {
+  list_add_tail(&vertex->nodes, &node->_node);
+  node->_vertex = vertex;
+  trie->count++;
+}
+
+/**
+ * Free a vertex and its subtries, all nodes are removed from it
+ * @param vertex pointer to vertex
+ */
+static void
+_free_vertex(struct _lpm_trie_vertex *vertex) {
+  struct lpm_trie_node *node, *safe;
+
+  if (vertex->child[0]) {
+    _free_vertex(vertex->child[0]);
+  }
+  if (vertex->child[1]) {
+    _free_vertex(vertex->child[1]);
+  }
+
+  list_for_each_element_safe(&vertex->nodes, node, _node, safe) {
+    list_remove(&node->_node);
+    node->_vertex = NULL;
+  }
+  free(vertex);
+}
@@ -43,11 +43,77 @@
  * @file
  */
 
+#include <stdlib.h>
+
 #include <oonf/oonf.h>
+#include <oonf/libcommon/lpm_trie.h>
 #include <oonf/libcommon/netaddr.h>
 #include <oonf/libcommon/netaddr_acl.h>
 #include <oonf/libcommon/string.h>
 
+/*! minimum number of prefixes before an ACL is compiled automatically, smaller ones are faster linear */
+#define ACL_AUTOCOMPILE_PREFIXES 12
+
+/*! number of recent lookups remembered by a compiled ACL, must be a power of 2 */
+#define ACL_CACHE_SIZE 16
+
+enum _acl_match {
+  /*! address is contained in a prefix of the accept array */
+  ACL_MATCH_ACCEPT = 1 << 0,
+
+  /*! address is contained in a prefix of the reject array */
+  ACL_MATCH_REJECT = 1 << 1,
+
+  /*! cache slot contains a valid lookup */
+  ACL_MATCH_VALID = 1 << 2,
+};
+
+/**
+ * prefix of a compiled ACL
+ */
+struct _acl_prefix {
+  /*! prefix of the accept or reject array */
+  struct netaddr prefix;
+
+  /**
+   * accept/reject match of this prefix and all shorter
+   * prefixes containing it
+   */
+  uint8_t match;
+
+  /*! node for lookup trie */
+  struct lpm_trie_node _node;
+};
+
+/**
+ * recent lookup of a compiled ACL
+ */
+struct _acl_cache_entry {
+  /*! address that was looked up */
+  struct netaddr addr;
+
+  /*! result of the lookup */
+  uint8_t match;
+};
+
+/**
+ * immutable lookup structure of the accept and reject arrays
+ */
+struct _netaddr_acl_compiled {
+  /*! longest prefix match trie of all prefixes */
+  struct lpm_trie trie;
+
+  /*! array of all prefixes, sorted by prefix length */
+  struct _acl_prefix *prefixes;
+
+  /*! cache of recent lookups */
+  struct _acl_cache_entry cache[ACL_CACHE_SIZE];
+};
+
+static void _autocompile(struct netaddr_acl *);
+static void _free_compiled(struct netaddr_acl *);
+static int _cmp_prefix_length(const void *, const void *);
+static uint8_t _get_match(struct _netaddr_acl_compiled *, const struct netaddr *);
 static bool _is_in_array(const struct netaddr *, size_t, const struct netaddr *);
 
 /**
@@ -66,6 +132,7 @@ netaddr_acl_add(struct netaddr_acl *acl) {
  */
 void
 netaddr_acl_remove(struct netaddr_acl *acl) {
+  _free_compiled(acl);
   free(acl->accept);
   free(acl->reject);
 
@@ -143,6 +210,8 @@ netaddr_acl_from_strarray(struct netaddr_acl *acl, const struct const_strarray *
       acl->accept_count++;
     }
   }
+
+  _autocompile(acl);
   return 0;
 
 from_entry_error:
@@ -160,6 +229,7 @@ int
 netaddr_acl_copy(struct netaddr_acl *to, const struct netaddr_acl *from) {
   netaddr_acl_remove(to);
   memcpy(to, from, sizeof(*to));
+  to->_compiled = NULL;
 
   if (to->accept_count) {
     to->accept = calloc(to->accept_count, sizeof(struct netaddr));
@@ -176,6 +246,93 @@ netaddr_acl_copy(struct netaddr_acl *to, const struct netaddr_acl *from) {
     }
     memcpy(to->reject, from->reject, to->reject_count * sizeof(struct netaddr));
   }
+
+  if (from->_compiled) {
+    netaddr_acl_compile(to);
+  }
+  else {
+    _autocompile(to);
+  }
+  return 0;
+}
+
+/**
+ * Compile the accept and reject arrays of an ACL into a longest
+ * prefix match trie, which makes checks independent of the number
+ * of prefixes. Must be called again after the arrays are modified.
+ * netaddr_acl_from_strarray() and netaddr_acl_copy() compile
+ * large ACLs automatically.
+ * @param acl pointer to ACL
+ * @return -1 if an error happened (the ACL will use a linear check),
+ *   0 otherwise
+ */
+int
+netaddr_acl_compile(struct netaddr_acl *acl) {
+  struct _netaddr_acl_compiled *compiled;
+  struct _acl_prefix *prefix, *existing, *parent;
+  size_t i, count;
+
+  _free_compiled(acl);
+
+  count = acl->accept_count + acl->reject_count;
+  if (count == 0) {
+    /* nothing to compile */
+    return 0;
+  }
+
+  compiled = calloc(1, sizeof(*compiled));
+  if (compiled == NULL) {
+    return -1;
+  }
+  compiled->prefixes = calloc(count, sizeof(struct _acl_prefix));
+  if (compiled->prefixes == NULL) {
+    free(compiled);
+    return -1;
+  }
+  lpm_trie_init(&compiled->trie);
+
+  for (i = 0; i < acl->accept_count; i++) {
+    memcpy(&compiled->prefixes[i].prefix, &acl->accept[i], sizeof(struct netaddr));
+    compiled->prefixes[i].match = ACL_MATCH_ACCEPT;
+  }
+  for (i = 0; i < acl->reject_count; i++) {
+    memcpy(&compiled->prefixes[acl->accept_count + i].prefix, &acl->reject[i], sizeof(struct netaddr));
+    compiled->prefixes[acl->accept_count + i].match = ACL_MATCH_REJECT;
+  }
+
+  /*
+   * insert short prefixes first, so each prefix can inherit the
+   * matches of the longest prefix containing it (including all
+   * duplicates of that prefix)
+   */
+  qsort(compiled->prefixes, count, sizeof(struct _acl_prefix), _cmp_prefix_length);
+
+  for (i = 0; i < count; i++) {
+    prefix = &compiled->prefixes[i];
+    prefix->_node.key = &prefix->prefix;
+
+    existing = lpm_trie_find_element(&compiled->trie, &prefix->prefix, existing, _node);
+    if (existing) {
+      /* duplicate prefix */
+      existing->match |= prefix->match;
+      continue;
+    }
+
+    parent = lpm_trie_find_best_element(&compiled->trie, &prefix->prefix, parent, _node);
+    if (parent) {
+      prefix->match |= parent->match;
+    }
+
+    if (lpm_trie_insert(&compiled->trie, &prefix->_node)) {
+      /* out of memory or unsupported address family */
+      lpm_trie_free(&compiled->trie);
+      free(compiled->prefixes);
+      free(compiled);
+      return -1;
+    }
+  }
+
+  acl->_compiled = compiled;
   return 0;
 }
 
@@ -187,6 +344,23 @@ netaddr_acl_copy(struct netaddr_acl *to, const struct netaddr_acl *from) {
  */
 bool
 netaddr_acl_check_accept(const struct netaddr_acl *acl, const struct netaddr *addr) {
+  uint8_t match;
+
+  if (acl->_compiled) {
+    match = _get_match(acl->_compiled, addr);
+
+    if (acl->reject_first && (match & ACL_MATCH_REJECT) != 0) {
+      return false;
+    }
+    if ((match & ACL_MATCH_ACCEPT) != 0) {
+      return true;
+    }
+    if ((match & ACL_MATCH_REJECT) != 0) {
+      return false;
+    }
+    return acl->accept_default;
+  }
+
   if (acl->reject_first) {
     if (_is_in_array(acl->reject, acl->reject_count, addr)) {
       return false;
@@ -235,6 +409,96 @@ netaddr_acl_handle_keywords(struct netaddr_acl *acl, const char *cmd) {
   return 0;
 }
 
+/**
+ * Compile an ACL if it is large enough to benefit from it. If compilation
+ * fails the ACL will use the linear check.
+ * @param acl pointer to ACL
+ */
+static void
+_autocompile(struct netaddr_acl *acl) {
+  if (acl->accept_count + acl->reject_count >= ACL_AUTOCOMPILE_PREFIXES) {
+    netaddr_acl_compile(acl);
+  }
+}
+
+/**
+ * Free the compiled lookup structure of an ACL
+ * @param acl pointer to ACL
+ */
+static void
+_free_compiled(struct netaddr_acl *acl) {
+  if (acl->_compiled) {
+    lpm_trie_free(&acl->_compiled->trie);
+    free(acl->_compiled->prefixes);
+    free(acl->_compiled);
+    acl->_compiled = NULL;
+  }
+}
+
+/**
+ * qsort comparator for ACL prefixes, sorting them by prefix length
+ * @param p1 pointer to first ACL prefix
+ * @param p2 pointer to second ACL prefix
+ * @return -1, 0 or 1 like strcmp
+ */
+static int
+_cmp_prefix_length(const void *p1, const void *p2) {
+  const struct _acl_prefix *prefix1 = p1, *prefix2 = p2;
+  uint8_t len1, len2;
+
+  len1 = netaddr_get_prefix_length(&prefix1->prefix);
+  len2 = netaddr_get_prefix_length(&prefix2->prefix);
+
+  if (len1 < len2) {
+    return -1;
+  }
+  if (len1 > len2) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Lookup which arrays of a compiled ACL contain an address
+ * @param compiled pointer to compiled ACL
+ * @param addr pointer to address, its prefix length is ignored
+ * @return bitfield of ACL_MATCH_ACCEPT and ACL_MATCH_REJECT
+ */
+static uint8_t
+_get_match(struct _netaddr_acl_compiled *compiled, const struct netaddr *addr) {
+  struct _acl_cache_entry *entry;
+  struct _acl_prefix *prefix;
+  const uint8_t *bin;
+  uint32_t hash;
+  size_t i, len;
+
+  /* hash the address into a cache slot */
+  bin = netaddr_get_binptr(addr);
+  len = netaddr_get_binlength(addr);
+  hash = netaddr_get_address_family(addr);
+  for (i = 0; i < len; i++) {
+    hash = hash * 31 + bin[i];
+  }
+  entry = &compiled->cache[hash & (ACL_CACHE_SIZE - 1)];
+
+  if ((entry->match & ACL_MATCH_VALID) != 0
+      && netaddr_get_address_family(&entry->addr) == netaddr_get_address_family(addr)
+      && memcmp(netaddr_get_binptr(&entry->addr), bin, len) == 0) {
+    return entry->match;
+  }
+
+  /* lookup the full address, the prefix length of addr is ignored */
+  memcpy(&entry->addr, addr, sizeof(*addr));
+  netaddr_set_prefix_length(&entry->addr, netaddr_get_maxprefix(addr));
+
+  prefix = lpm_trie_find_best_element(&compiled->trie, &entry->addr, prefix, _node);
+  entry->match = ACL_MATCH_VALID;
+  if (prefix) {
+    entry->match |= prefix->match;
+  }
+  return entry->match;
+}
+
 /**
  * @param array pointer to array of addresses and networks
  * @param length length of array
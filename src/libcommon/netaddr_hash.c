@@ -0,0 +1,194 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcommon/netaddr_hash.h>
+
+static void _resize(struct netaddr_hash *, uint32_t size);
+
+/**
+ * Initialize a new hash index, this cannot fail because the
+ * first buckets are embedded into the index
+ * @param hash pointer to hash index
+ */
+void
+netaddr_hash_init(struct netaddr_hash *hash) {
+  memset(hash, 0, sizeof(*hash));
+  hash->_buckets = hash->_initial_buckets;
+  hash->_size = NETADDR_HASH_INITIAL_SIZE;
+}
+
+/**
+ * Release the memory of a hash index. All nodes must be
+ * removed or freed by the caller.
+ * @param hash pointer to hash index
+ */
+void
+netaddr_hash_free(struct netaddr_hash *hash) {
+  if (hash->_buckets != hash->_initial_buckets) {
+    free(hash->_buckets);
+  }
+  netaddr_hash_init(hash);
+}
+
+/**
+ * Add a node to a hash index, the key must be unique.
+ * If the index cannot grow because of missing memory, the
+ * node is added anyways with a longer chain.
+ * @param hash pointer to hash index
+ * @param node pointer to node, key must be initialized
+ */
+void
+netaddr_hash_insert(struct netaddr_hash *hash, struct netaddr_hash_node *node) {
+  struct netaddr_hash_node **bucket;
+
+  if (hash->count >= hash->_size) {
+    _resize(hash, hash->_size * 2);
+  }
+
+  node->_hash = netaddr_hash_calculate(node->key);
+
+  bucket = &hash->_buckets[node->_hash & (hash->_size - 1)];
+  node->_next = *bucket;
+  *bucket = node;
+  hash->count++;
+}
+
+/**
+ * Remove a node from a hash index
+ * @param hash pointer to hash index
+ * @param node pointer to node
+ */
+void
+netaddr_hash_remove(struct netaddr_hash *hash, struct netaddr_hash_node *node) {
+  struct netaddr_hash_node **ptr;
+
+  for (ptr = &hash->_buckets[node->_hash & (hash->_size - 1)]; *ptr; ptr = &(*ptr)->_next) {
+    if (*ptr == node) {
+      *ptr = node->_next;
+      node->_next = NULL;
+      hash->count--;
+      return;
+    }
+  }
+}
+
+/**
+ * Find the node of a key and update the lookup statistics of the index
+ * @param hash pointer to hash index
+ * @param key pointer to key
+ * @return pointer to node, NULL if not found
+ */
+struct netaddr_hash_node *
+netaddr_hash_find(struct netaddr_hash *hash, const struct netaddr *key) {
+  struct netaddr_hash_node *node;
+  uint32_t h;
+
+  hash->lookups++;
+
+  h = netaddr_hash_calculate(key);
+  for (node = hash->_buckets[h & (hash->_size - 1)]; node; node = node->_next) {
+    if (node->_hash == h && netaddr_cmp(node->key, key) == 0) {
+      hash->hits++;
+      return node;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Calculate the hash value of an address (FNV-1a), consistent
+ * with netaddr_cmp()
+ * @param addr pointer to address
+ * @return hash value
+ */
+uint32_t
+netaddr_hash_calculate(const struct netaddr *addr) {
+  const uint8_t *ptr;
+  uint32_t h;
+  size_t i;
+
+  h = 2166136261u;
+  ptr = (const uint8_t *)addr;
+  for (i = 0; i < sizeof(*addr); i++) {
+    h = (h ^ ptr[i]) * 16777619u;
+  }
+  return h;
+}
+
+/**
+ * Move all nodes of a hash index into a new bucket array
+ * @param hash pointer to hash index
+ * @param size new number of buckets, must be a power of 2
+ */
+static void
+_resize(struct netaddr_hash *hash, uint32_t size) {
+  struct netaddr_hash_node **buckets, *node, *next;
+  uint32_t i;
+
+  buckets = calloc(size, sizeof(struct netaddr_hash_node *));
+  if (buckets == NULL) {
+    /* keep the current buckets, chains get longer */
+    return;
+  }
+
+  for (i = 0; i < hash->_size; i++) {
+    for (node = hash->_buckets[i]; node; node = next) {
+      next = node->_next;
+      node->_next = buckets[node->_hash & (size - 1)];
+      buckets[node->_hash & (size - 1)] = node;
+    }
+  }
+
+  if (hash->_buckets != hash->_initial_buckets) {
+    free(hash->_buckets);
+  }
+  hash->_buckets = buckets;
+  hash->_size = size;
+}
@@ -0,0 +1,160 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <string.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/sliding_window.h>
+
+static size_t _upper_bound(const int64_t *sorted, size_t count, int64_t value);
+
+/**
+ * Initialize a sliding window with all samples set to zero
+ * @param window sliding window
+ * @param samples storage for samples, size elements
+ * @param sorted storage for order statistics, size elements,
+ *   NULL if no order statistics are necessary
+ * @param size number of samples in the window, must be larger than zero
+ */
+void
+sliding_window_init(struct sliding_window *window, int64_t *samples, int64_t *sorted, size_t size) {
+  window->_samples = samples;
+  window->_sorted = sorted;
+  window->size = size;
+
+  sliding_window_fill(window, 0);
+}
+
+/**
+ * Set all samples of a sliding window to the same value and move
+ * the current sample to the start of the ringbuffer
+ * @param window sliding window
+ * @param value new value of all samples
+ */
+void
+sliding_window_fill(struct sliding_window *window, int64_t value) {
+  size_t i;
+
+  for (i = 0; i < window->size; i++) {
+    window->_samples[i] = value;
+    if (window->_sorted) {
+      window->_sorted[i] = value;
+    }
+  }
+  window->_current = 0;
+  window->sum = value * (int64_t)window->size;
+}
+
+/**
+ * Overwrite the current sample of the window
+ * @param window sliding window
+ * @param value new value of the current sample
+ */
+void
+sliding_window_set(struct sliding_window *window, int64_t value) {
+  int64_t old;
+  size_t old_idx, new_idx;
+
+  old = window->_samples[window->_current];
+  if (old == value) {
+    return;
+  }
+
+  window->_samples[window->_current] = value;
+  window->sum += value - old;
+
+  if (!window->_sorted) {
+    return;
+  }
+
+  /* replace the old value with the new one and shift the elements between them */
+  old_idx = _upper_bound(window->_sorted, window->size, old) - 1;
+  if (value > old) {
+    new_idx = _upper_bound(window->_sorted, window->size, value) - 1;
+    memmove(&window->_sorted[old_idx], &window->_sorted[old_idx + 1], (new_idx - old_idx) * sizeof(int64_t));
+  }
+  else {
+    new_idx = _upper_bound(window->_sorted, window->size, value);
+    memmove(&window->_sorted[new_idx + 1], &window->_sorted[new_idx], (old_idx - new_idx) * sizeof(int64_t));
+  }
+  window->_sorted[new_idx] = value;
+}
+
+/**
+ * Count the samples of a window which are less or equal than a value,
+ * window must have been initialized with order statistics
+ * @param window sliding window
+ * @param value upper limit (inclusive)
+ * @return number of samples less or equal than value
+ */
+size_t
+sliding_window_count_le(const struct sliding_window *window, int64_t value) {
+  return _upper_bound(window->_sorted, window->size, value);
+}
+
+/**
+ * Binary search for the first element larger than a value
+ * @param sorted array of values in ascending order
+ * @param count number of elements in array
+ * @param value value to look for
+ * @return index of first element larger than value, count if none
+ */
+static size_t
+_upper_bound(const int64_t *sorted, size_t count, int64_t value) {
+  size_t low, high, middle;
+
+  low = 0;
+  high = count;
+  while (low < high) {
+    middle = low + (high - low) / 2;
+    if (sorted[middle] <= value) {
+      low = middle + 1;
+    }
+    else {
+      high = middle;
+    }
+  }
+  return low;
+}
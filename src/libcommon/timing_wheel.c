@@ -0,0 +1,268 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/list.h>
+#include <oonf/libcommon/timing_wheel.h>
+
+static void _insert(struct timing_wheel *wheel, struct timing_wheel_node *node);
+static void _insert_expired(struct timing_wheel *wheel, struct timing_wheel_node *node);
+static uint64_t _get_slot_start(uint64_t now, unsigned level, unsigned slot);
+
+/**
+ * Initialize a new timing wheel
+ * @param wheel pointer to timing wheel
+ * @param now current time (tick) of the wheel
+ */
+void
+timing_wheel_init(struct timing_wheel *wheel, uint64_t now) {
+  unsigned level, slot;
+
+  wheel->now = now;
+  wheel->count = 0;
+  list_init_head(&wheel->expired);
+
+  for (level = 0; level < TIMING_WHEEL_LEVELS; level++) {
+    wheel->_used[level] = 0;
+    for (slot = 0; slot < TIMING_WHEEL_SLOTS; slot++) {
+      list_init_head(&wheel->_slots[level][slot]);
+    }
+  }
+}
+
+/**
+ * Insert a node into a timing wheel. The key of the node must
+ * be initialized. A node with a key not larger than the current
+ * time of the wheel is put directly into the expired list.
+ * @param wheel pointer to timing wheel
+ * @param node pointer to node
+ */
+void
+timing_wheel_insert(struct timing_wheel *wheel, struct timing_wheel_node *node) {
+  _insert(wheel, node);
+  wheel->count++;
+}
+
+/**
+ * Remove a node from a timing wheel
+ * @param wheel pointer to timing wheel
+ * @param node pointer to node
+ */
+void
+timing_wheel_remove(struct timing_wheel *wheel, struct timing_wheel_node *node) {
+  if (!list_is_node_added(&node->_node)) {
+    return;
+  }
+
+  list_remove(&node->_node);
+  if (node->_level != TIMING_WHEEL_EXPIRED && list_is_empty(&wheel->_slots[node->_level][node->_slot])) {
+    wheel->_used[node->_level] &= ~(1ull << node->_slot);
+  }
+  wheel->count--;
+}
+
+/**
+ * Advance the time of a timing wheel. All nodes with a key not
+ * larger than the new time will be moved into the expired list,
+ * all other nodes of the passed slots cascade down to a lower level.
+ * @param wheel pointer to timing wheel
+ * @param now new time (tick) of the wheel
+ */
+void
+timing_wheel_advance(struct timing_wheel *wheel, uint64_t now) {
+  struct timing_wheel_node *node, *it;
+  struct list_entity pending;
+  unsigned level, slot;
+  uint64_t used;
+
+  if (now <= wheel->now) {
+    return;
+  }
+
+  list_init_head(&pending);
+  for (level = 0; level < TIMING_WHEEL_LEVELS; level++) {
+    used = wheel->_used[level];
+    while (used) {
+      slot = __builtin_ctzll(used);
+      if (_get_slot_start(wheel->now, level, slot) > now) {
+        /* slots are sorted by time, all further slots are in the future */
+        break;
+      }
+
+      list_merge(&pending, &wheel->_slots[level][slot]);
+      used &= ~(1ull << slot);
+    }
+    wheel->_used[level] = used;
+  }
+
+  wheel->now = now;
+
+  list_for_each_element_safe(&pending, node, _node, it) {
+    list_remove(&node->_node);
+    _insert(wheel, node);
+  }
+}
+
+/**
+ * Get the earliest time the wheel has to be advanced to. This is the
+ * exact key of the next node if it is stored in the lowest level,
+ * or the start of the next populated slot of a higher level (which
+ * is a lower bound for the keys of all nodes in this slot).
+ * @param wheel pointer to timing wheel
+ * @return time of next event, UINT64_MAX if wheel is empty
+ */
+uint64_t
+timing_wheel_get_next(const struct timing_wheel *wheel) {
+  const struct timing_wheel_node *node;
+  unsigned level;
+
+  if (!list_is_empty(&wheel->expired)) {
+    node = list_first_element(&wheel->expired, node, _node);
+    return node->key;
+  }
+
+  for (level = 0; level < TIMING_WHEEL_LEVELS; level++) {
+    if (wheel->_used[level]) {
+      return _get_slot_start(wheel->now, level, __builtin_ctzll(wheel->_used[level]));
+    }
+  }
+  return UINT64_MAX;
+}
+
+/**
+ * Call a callback for all nodes of a timing wheel (in no
+ * specific order). The callback is allowed to remove the node
+ * it was called for, but no other one.
+ * @param wheel pointer to timing wheel
+ * @param cb callback for each node
+ * @param data custom pointer for callback
+ */
+void
+timing_wheel_walk(struct timing_wheel *wheel, void (*cb)(struct timing_wheel_node *, void *data), void *data) {
+  struct timing_wheel_node *node, *it;
+  unsigned level, slot;
+
+  list_for_each_element_safe(&wheel->expired, node, _node, it) {
+    cb(node, data);
+  }
+
+  for (level = 0; level < TIMING_WHEEL_LEVELS; level++) {
+    for (slot = 0; slot < TIMING_WHEEL_SLOTS; slot++) {
+      if (wheel->_used[level] & (1ull << slot)) {
+        list_for_each_element_safe(&wheel->_slots[level][slot], node, _node, it) {
+          cb(node, data);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Put a node into the right slot of the wheel (or the expired list)
+ * without changing the node counter.
+ * @param wheel pointer to timing wheel
+ * @param node pointer to node
+ */
+static void
+_insert(struct timing_wheel *wheel, struct timing_wheel_node *node) {
+  unsigned level, slot;
+
+  if (node->key <= wheel->now) {
+    _insert_expired(wheel, node);
+    return;
+  }
+
+  /* store node in the highest level its key differs from the current time */
+  level = (63 - __builtin_clzll(node->key ^ wheel->now)) / TIMING_WHEEL_LEVEL_BITS;
+  slot = (node->key >> (level * TIMING_WHEEL_LEVEL_BITS)) & (TIMING_WHEEL_SLOTS - 1);
+
+  node->_level = level;
+  node->_slot = slot;
+
+  list_add_tail(&wheel->_slots[level][slot], &node->_node);
+  wheel->_used[level] |= 1ull << slot;
+}
+
+/**
+ * Add a node to the list of expired nodes, keeping the list sorted
+ * @param wheel pointer to timing wheel
+ * @param node pointer to node
+ */
+static void
+_insert_expired(struct timing_wheel *wheel, struct timing_wheel_node *node) {
+  struct timing_wheel_node *prev;
+
+  node->_level = TIMING_WHEEL_EXPIRED;
+  node->_slot = 0;
+
+  /* nodes normally expire in order, so search from the end of the list */
+  list_for_each_element_reverse(&wheel->expired, prev, _node) {
+    if (prev->key <= node->key) {
+      list_add_after(&prev->_node, &node->_node);
+      return;
+    }
+  }
+  list_add_head(&wheel->expired, &node->_node);
+}
+
+/**
+ * Calculate the first time represented by a slot of the wheel
+ * @param now current time of the wheel
+ * @param level level of the slot
+ * @param slot index of the slot
+ * @return time of the start of the slot
+ */
+static uint64_t
+_get_slot_start(uint64_t now, unsigned level, unsigned slot) {
+  unsigned shift;
+  uint64_t prefix = 0;
+
+  /* bits above this level are the same as the current time */
+  shift = (level + 1) * TIMING_WHEEL_LEVEL_BITS;
+  if (shift < 64) {
+    prefix = (now >> shift) << shift;
+  }
+  return prefix | ((uint64_t)slot << (level * TIMING_WHEEL_LEVEL_BITS));
+}
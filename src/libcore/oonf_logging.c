@@ -44,6 +44,7 @@
  */
 
 #include <assert.h>
+#include <pthread.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -57,6 +58,125 @@
 #include <oonf/libcore/oonf_logging.h>
 #include <oonf/libcore/os_core.h>
 
+/*! alignment of the records in the asynchronous logging ring buffer */
+#define LOG_ASYNC_ALIGN 8
+
+/*! maximum length of the text of an asynchronous logging record */
+#define LOG_ASYNC_MAX_TEXT 2048
+
+/*! minimum size of the asynchronous logging ring buffer, must hold multiple records of maximum length */
+#define LOG_ASYNC_MIN_BUFFER (8 * 1024)
+
+/*! maximum time in milliseconds until the logging thread checks the ring buffer */
+#define LOG_ASYNC_POLL_INTERVAL 100
+
+/**
+ * Header of a logging event in the ring buffer of the asynchronous
+ * logging mode. It is followed by the zero terminated text of the
+ * event and the binary data for the hexdump.
+ */
+struct _log_record {
+  /*! length of record including header and padding, 0 to skip until the end of the ring */
+  size_t length;
+
+  /*! walltime of the logging event */
+  struct timeval time;
+
+  /*! file where the logging event happened */
+  const char *file;
+
+  /*! line number where the logging event happened */
+  int line;
+
+  /*! severity of logging event */
+  enum oonf_log_severity severity;
+
+  /*! source of logging event */
+  enum oonf_log_source source;
+
+  /*! length of the text following the header */
+  size_t text_length;
+
+  /*! length of the hexdump data following the text */
+  size_t hex_length;
+};
+
+/**
+ * State of the asynchronous logging mode. The event loop is the
+ * only producer of records and writes them into the ring buffer
+ * without taking a lock, the logging thread is the only consumer.
+ */
+struct _log_async {
+  /*! ring buffer for logging records */
+  uint8_t *ring;
+
+  /*! size of the allocated ring buffer */
+  size_t size;
+
+  /*! configured size of the ring buffer, 0 for synchronous logging */
+  size_t configured_size;
+
+  /*! number of bytes ever written into the ring, only changed by producer */
+  size_t head;
+
+  /*! number of bytes ever consumed from the ring, only changed by consumer */
+  size_t tail;
+
+  /*! number of logging events that have been dropped */
+  uint64_t dropped;
+
+  /*! number of dropped logging events already reported by the logging thread */
+  uint64_t reported;
+
+  /*! true if the application allows the logging thread to run */
+  bool enabled;
+
+  /*! true if the logging thread is running */
+  bool running;
+
+  /*! true while the logging thread is waiting for records */
+  bool sleeping;
+
+  /*! true if the logging thread should flush the ring and stop */
+  bool shutdown;
+
+  /*! background thread for formatting and dispatching */
+  pthread_t thread;
+
+  /*! thread allowed to write into the ring buffer */
+  pthread_t producer;
+
+  /*! protects the handler list against the logging thread */
+  pthread_mutex_t mutex;
+
+  /*! signals the logging thread that new records are available */
+  pthread_cond_t work;
+
+  /*! signalled by the logging thread after it emptied the ring */
+  pthread_cond_t drained;
+
+  /*! output buffer of the logging thread */
+  struct autobuf buffer;
+};
+
+static void _updatemask(void);
+static const char *_get_walltime(struct oonf_walltime_str *buf, const struct timeval *tv);
+static void _finish_line(struct autobuf *out, const void *hexptr, size_t hexlen);
+static void _call_handlers(struct oonf_log_parameters *param, bool from_thread);
+static bool _is_async_handler(struct oonf_log_handler_entry *h);
+static void _get_handler_targets(
+  enum oonf_log_severity severity, enum oonf_log_source source, bool *sync_handlers, bool *async_handlers);
+static void _push_record(enum oonf_log_severity severity, enum oonf_log_source source, const char *file, int line,
+  const void *hexptr, size_t hexlen, const char *format, va_list ap) __attribute__((format(printf, 7, 0)));
+static void _dispatch_record(const struct _log_record *record, const char *text, const void *hexptr);
+static void _drain_ring(void);
+static void _flush_ring(void);
+static void *_cb_logging_thread(void *);
+static int _start_thread(void);
+static void _stop_thread(void);
+static void _lock_handlers(void);
+static void _unlock_handlers(void);
+
 static struct list_entity _handler_list;
 static struct autobuf _logbuffer;
 static const struct oonf_appdata *_appdata;
@@ -92,6 +212,12 @@ const char *LOG_SEVERITY_NAMES[LOG_SEVERITY_MAX + 1] = {
 
 static uint32_t _log_warnings[LOG_MAXIMUM_SOURCES];
 
+static struct _log_async _async = {
+  .mutex = PTHREAD_MUTEX_INITIALIZER,
+  .work = PTHREAD_COND_INITIALIZER,
+  .drained = PTHREAD_COND_INITIALIZER,
+};
+
 /**
  * Initialize logging system
  * @param data builddata defined by application
@@ -157,6 +283,9 @@ oonf_log_cleanup(void) {
   struct oonf_log_handler_entry *h, *iterator;
   enum oonf_log_source src;
 
+  /* write all queued logging events */
+  oonf_log_async_stop();
+
   /* remove all handlers */
   list_for_each_element_safe(&_handler_list, h, _node, iterator) {
     oonf_log_removehandler(h);
@@ -176,18 +305,24 @@ oonf_log_cleanup(void) {
  */
 void
 oonf_log_addhandler(struct oonf_log_handler_entry *h) {
+  _lock_handlers();
   list_add_tail(&_handler_list, &h->_node);
-  oonf_log_updatemask();
+  _updatemask();
+  _unlock_handlers();
 }
 
 /**
- * Unregister a logevent handler
+ * Unregister a logevent handler. All logging events queued for
+ * the logging thread are written before the handler is removed.
  * @param h pointer to handler entry
  */
 void
 oonf_log_removehandler(struct oonf_log_handler_entry *h) {
+  _lock_handlers();
+  _flush_ring();
   list_remove(&h->_node);
-  oonf_log_updatemask();
+  _updatemask();
+  _unlock_handlers();
 }
 
 /**
@@ -294,6 +429,88 @@ oonf_log_printversion(struct autobuf *abuf) {
  */
 void
 oonf_log_updatemask(void) {
+  _lock_handlers();
+  _updatemask();
+  _unlock_handlers();
+}
+
+/**
+ * Set the size of the ring buffer for asynchronous logging. The
+ * logging thread is restarted if the size changes while it is running.
+ * Sizes below 8 kilobyte are raised to 8 kilobyte. The text of each
+ * asynchronous logging event is truncated to 2048 characters.
+ * @param buffer_size size of ring buffer in bytes, 0 for synchronous logging
+ */
+void
+oonf_log_async_setup(size_t buffer_size) {
+  /* smaller rings cannot store a record of maximum length */
+  if (buffer_size > 0 && buffer_size < LOG_ASYNC_MIN_BUFFER) {
+    buffer_size = LOG_ASYNC_MIN_BUFFER;
+  }
+
+  /* keep all records aligned */
+  buffer_size -= buffer_size % LOG_ASYNC_ALIGN;
+  if (buffer_size == _async.configured_size) {
+    return;
+  }
+
+  _async.configured_size = buffer_size;
+  if (_async.enabled) {
+    _stop_thread();
+    _start_thread();
+  }
+}
+
+/**
+ * Allow the asynchronous logging mode. Must be called from the thread
+ * that generates the logging events after the application has forked
+ * into the background.
+ * @return -1 if the logging thread could not be started, 0 otherwise
+ */
+int
+oonf_log_async_start(void) {
+  _async.enabled = true;
+  return _start_thread();
+}
+
+/**
+ * Stop the asynchronous logging mode. All queued logging events are
+ * written before this function returns, all following events are
+ * handled synchronously.
+ */
+void
+oonf_log_async_stop(void) {
+  _async.enabled = false;
+  _stop_thread();
+}
+
+/**
+ * Write all queued logging events before this function returns.
+ * Must be called before code or data referenced by queued events
+ * (e.g. the file names of a plugin) is unloaded.
+ */
+void
+oonf_log_async_flush(void) {
+  _lock_handlers();
+  _flush_ring();
+  _unlock_handlers();
+}
+
+/**
+ * @return number of logging events dropped because the ring
+ *   buffer of the asynchronous logging was full
+ */
+uint64_t
+oonf_log_async_get_dropped(void) {
+  return __atomic_load_n(&_async.dropped, __ATOMIC_RELAXED);
+}
+
+/**
+ * Recalculate the combination of the logging masks, the handler
+ * list must be locked against the logging thread.
+ */
+static void
+_updatemask(void) {
   enum oonf_log_source src;
   struct oonf_log_handler_entry *h, *iterator;
   uint8_t mask;
@@ -337,19 +554,11 @@ oonf_log_updatemask(void) {
 const char *
 oonf_log_get_walltime(struct oonf_walltime_str *buf) {
   struct timeval now;
-  struct tm *tm;
 
   if (os_core_gettimeofday(&now)) {
     return NULL;
   }
-
-  tm = localtime(&now.tv_sec);
-  if (tm == NULL) {
-    return NULL;
-  }
-  snprintf(buf->buf, sizeof(buf->buf), "%02d:%02d:%02d.%03ld", tm->tm_hour % 24u, tm->tm_min % 60u, tm->tm_sec % 60u,
-    (now.tv_usec / 1000) % 1000u);
-  return buf->buf;
+  return _get_walltime(buf, &now);
 }
 
 /**
@@ -368,10 +577,9 @@ oonf_log_get_walltime(struct oonf_walltime_str *buf) {
 void
 oonf_log(enum oonf_log_severity severity, enum oonf_log_source source, const char *file, int line,
   const void *hexptr, size_t hexlen, const char *format, ...) {
-  struct oonf_log_handler_entry *h, *iterator;
   struct oonf_log_parameters param;
   struct oonf_walltime_str tbuf;
-  char *last;
+  bool sync_handlers, async_handlers;
   va_list ap;
   int p1 = 0, p2 = 0;
 
@@ -381,6 +589,18 @@ oonf_log(enum oonf_log_severity severity, enum oonf_log_source source, const cha
     _log_warnings[LOG_ALL]++;
   }
 
+  _get_handler_targets(severity, source, &sync_handlers, &async_handlers);
+
+  if (async_handlers) {
+    /* let the logging thread do the formatting */
+    va_start(ap, format);
+    _push_record(severity, source, file, line, hexptr, hexlen, format, ap);
+    va_end(ap);
+  }
+  if (!sync_handlers) {
+    return;
+  }
+
   va_start(ap, format);
 
   /* generate log string */
@@ -388,22 +608,7 @@ oonf_log(enum oonf_log_severity severity, enum oonf_log_source source, const cha
   p1 = abuf_puts(&_logbuffer, oonf_log_get_walltime(&tbuf));
   p2 = abuf_appendf(&_logbuffer, " %s(%s) %s %d: ", LOG_SEVERITY_NAMES[severity], LOG_SOURCE_NAMES[source], file, line);
   abuf_vappendf(&_logbuffer, format, ap);
-
-  last = &abuf_getptr(&_logbuffer)[abuf_getlen(&_logbuffer) - 1];
-  if (hexptr) {
-    /* append \n at the end of the line if necessary */
-    if (*last != '\n') {
-      abuf_puts(&_logbuffer, "\n");
-    }
-
-    abuf_hexdump(&_logbuffer, "", hexptr, hexlen);
-  }
-  else {
-    /* remove \n at the end of the line if necessary */
-    if (*last == '\n') {
-      *last = 0;
-    }
-  }
+  _finish_line(&_logbuffer, hexptr, hexlen);
 
   param.severity = severity;
   param.source = source;
@@ -413,18 +618,7 @@ oonf_log(enum oonf_log_severity severity, enum oonf_log_source source, const cha
   param.timeLength = p1;
   param.prefixLength = p2;
 
-  /* use stderr logger if nothing has been configured */
-  if (list_is_empty(&_handler_list)) {
-    oonf_log_stderr(NULL, &param);
-  }
-  else {
-    /* call all log handlers */
-    list_for_each_element_safe(&_handler_list, h, _node, iterator) {
-      if (oonf_log_mask_test(h->_processed_bitmask, source, severity)) {
-        h->handler(h, &param);
-      }
-    }
-  }
+  _call_handlers(&param, false);
   va_end(ap);
 }
 
@@ -436,7 +630,7 @@ oonf_log(enum oonf_log_severity severity, enum oonf_log_source source, const cha
  */
 void
 oonf_log_stderr(struct oonf_log_handler_entry *entry, struct oonf_log_parameters *param) {
-  bool *color = entry->custom;
+  bool *color = entry ? entry->custom : NULL;
 
   if (color && *color) {
     switch (param->severity) {
@@ -481,3 +675,428 @@ void
 oonf_log_syslog(struct oonf_log_handler_entry *entry __attribute__((unused)), struct oonf_log_parameters *param) {
   os_core_syslog(param->severity, param->buffer + param->timeLength);
 }
+
+/**
+ * Generate walltime string for a timestamp
+ * @param buf buffer to storage object for time string
+ * @param tv timestamp
+ * @return pointer to string containing the walltime
+ */
+static const char *
+_get_walltime(struct oonf_walltime_str *buf, const struct timeval *tv) {
+  struct tm tm;
+
+  /* use the reentrant variant, the logging thread calls this too */
+  if (localtime_r(&tv->tv_sec, &tm) == NULL) {
+    return NULL;
+  }
+  snprintf(buf->buf, sizeof(buf->buf), "%02d:%02d:%02d.%03ld", tm.tm_hour % 24u, tm.tm_min % 60u, tm.tm_sec % 60u,
+    (long)(tv->tv_usec / 1000) % 1000u);
+  return buf->buf;
+}
+
+/**
+ * Fix the line ending of a logging line and append the hexdump
+ * @param out buffer with logging line
+ * @param hexptr pointer to binary buffer that should be appended as a hexdump
+ * @param hexlen length of binary buffer to hexdump
+ */
+static void
+_finish_line(struct autobuf *out, const void *hexptr, size_t hexlen) {
+  char *last;
+
+  last = &abuf_getptr(out)[abuf_getlen(out) - 1];
+  if (hexptr) {
+    /* append \n at the end of the line if necessary */
+    if (*last != '\n') {
+      abuf_puts(out, "\n");
+    }
+
+    abuf_hexdump(out, "", hexptr, hexlen);
+  }
+  else {
+    /* remove \n at the end of the line if necessary */
+    if (*last == '\n') {
+      *last = 0;
+    }
+  }
+}
+
+/**
+ * Call all logging handlers interested in a logging event
+ * @param param logging parameter set
+ * @param from_thread true if called by the logging thread,
+ *   false if called synchronously
+ */
+static void
+_call_handlers(struct oonf_log_parameters *param, bool from_thread) {
+  struct oonf_log_handler_entry *h, *iterator;
+
+  /* use stderr logger if nothing has been configured */
+  if (list_is_empty(&_handler_list)) {
+    if (!from_thread) {
+      oonf_log_stderr(NULL, param);
+    }
+    return;
+  }
+
+  /* call all log handlers */
+  list_for_each_element_safe(&_handler_list, h, _node, iterator) {
+    if (_is_async_handler(h) == from_thread && oonf_log_mask_test(h->_processed_bitmask, param->source, param->severity)) {
+      h->handler(h, param);
+    }
+  }
+}
+
+/**
+ * @param h logging handler
+ * @return true if handler is called by the logging thread
+ */
+static bool
+_is_async_handler(struct oonf_log_handler_entry *h) {
+  return _async.running && h->threadsafe;
+}
+
+/**
+ * Check which kind of logging handlers are interested in a logging event
+ * @param severity severity of the logging event
+ * @param source source of the logging event
+ * @param sync_handlers set to true if handlers must be called synchronously
+ * @param async_handlers set to true if handlers are called by the logging thread
+ */
+static void
+_get_handler_targets(
+  enum oonf_log_severity severity, enum oonf_log_source source, bool *sync_handlers, bool *async_handlers) {
+  struct oonf_log_handler_entry *h;
+
+  if (!_async.running || list_is_empty(&_handler_list)) {
+    *sync_handlers = true;
+    *async_handlers = false;
+    return;
+  }
+
+  *sync_handlers = false;
+  *async_handlers = false;
+  list_for_each_element(&_handler_list, h, _node) {
+    if (oonf_log_mask_test(h->_processed_bitmask, source, severity)) {
+      if (h->threadsafe) {
+        *async_handlers = true;
+      }
+      else {
+        *sync_handlers = true;
+      }
+    }
+  }
+}
+
+/**
+ * Copy a logging event into the ring buffer of the logging thread.
+ * Only the text of the event is generated here, the rest of the
+ * formatting is done by the logging thread.
+ * @param severity severity of the log event
+ * @param source source of the log event
+ * @param file filename where the logging macro have been called
+ * @param line line number where the logging macro have been called
+ * @param hexptr pointer to binary buffer that should be appended as a hexdump
+ * @param hexlen length of binary buffer to hexdump
+ * @param format printf format string for log output
+ * @param ap variable arguments of format string
+ */
+static void
+_push_record(enum oonf_log_severity severity, enum oonf_log_source source, const char *file, int line,
+  const void *hexptr, size_t hexlen, const char *format, va_list ap) {
+  struct _log_record *record;
+  size_t head, used, pos, max_length, skip;
+  char *text;
+  int text_length;
+
+  if (!pthread_equal(pthread_self(), _async.producer)) {
+    /* the ring buffer has only a single producer */
+    __atomic_add_fetch(&_async.dropped, 1, __ATOMIC_RELAXED);
+    return;
+  }
+
+  if (hexptr == NULL) {
+    hexlen = 0;
+  }
+
+  head = _async.head;
+  used = head - __atomic_load_n(&_async.tail, __ATOMIC_ACQUIRE);
+  pos = head % _async.size;
+
+  /* reserve space for the longest possible record */
+  max_length = sizeof(*record) + LOG_ASYNC_MAX_TEXT + 1 + hexlen;
+  max_length += LOG_ASYNC_ALIGN - 1;
+  max_length -= max_length % LOG_ASYNC_ALIGN;
+
+  /* records are never split at the end of the ring */
+  skip = _async.size - pos < max_length ? _async.size - pos : 0;
+  if (_async.size - used < skip + max_length) {
+    __atomic_add_fetch(&_async.dropped, 1, __ATOMIC_RELAXED);
+    return;
+  }
+
+  if (skip) {
+    record = (struct _log_record *)&_async.ring[pos];
+    record->length = 0;
+    head += skip;
+    pos = 0;
+  }
+
+  record = (struct _log_record *)&_async.ring[pos];
+  text = (char *)(record + 1);
+
+  text_length = vsnprintf(text, LOG_ASYNC_MAX_TEXT + 1, format, ap);
+  if (text_length < 0) {
+    text_length = 0;
+    text[0] = 0;
+  }
+  else if (text_length > LOG_ASYNC_MAX_TEXT) {
+    text_length = LOG_ASYNC_MAX_TEXT;
+  }
+  if (hexlen) {
+    memcpy(text + text_length + 1, hexptr, hexlen);
+  }
+
+  record->length = sizeof(*record) + text_length + 1 + hexlen;
+  record->length += LOG_ASYNC_ALIGN - 1;
+  record->length -= record->length % LOG_ASYNC_ALIGN;
+
+  os_core_gettimeofday(&record->time);
+  record->file = file;
+  record->line = line;
+  record->severity = severity;
+  record->source = source;
+  record->text_length = text_length;
+  record->hex_length = hexlen;
+
+  /* publish record, then wake up the logging thread if necessary */
+  __atomic_store_n(&_async.head, head + record->length, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&_async.sleeping, __ATOMIC_SEQ_CST)) {
+    pthread_cond_signal(&_async.work);
+  }
+}
+
+/**
+ * Format a logging record and call the thread safe logging handlers.
+ * Called by the logging thread.
+ * @param record logging record
+ * @param text text of logging event
+ * @param hexptr binary data for hexdump, NULL if none
+ */
+static void
+_dispatch_record(const struct _log_record *record, const char *text, const void *hexptr) {
+  struct oonf_log_parameters param;
+  struct oonf_walltime_str tbuf;
+  int p1 = 0, p2 = 0;
+
+  abuf_clear(&_async.buffer);
+  p1 = abuf_puts(&_async.buffer, _get_walltime(&tbuf, &record->time));
+  p2 = abuf_appendf(&_async.buffer, " %s(%s) %s %d: ", LOG_SEVERITY_NAMES[record->severity],
+    LOG_SOURCE_NAMES[record->source], record->file, record->line);
+  abuf_memcpy(&_async.buffer, text, record->text_length);
+  _finish_line(&_async.buffer, hexptr, record->hex_length);
+
+  param.severity = record->severity;
+  param.source = record->source;
+  param.file = record->file;
+  param.line = record->line;
+  param.buffer = abuf_getptr(&_async.buffer);
+  param.timeLength = p1;
+  param.prefixLength = p2;
+
+  _call_handlers(&param, true);
+}
+
+/**
+ * Dispatch all records in the ring buffer and report dropped
+ * logging events. Called by the logging thread with the
+ * handler list locked.
+ */
+static void
+_drain_ring(void) {
+  struct _log_record *record, dropped_record;
+  size_t head, tail, pos;
+  uint64_t dropped;
+  char text[64];
+  const char *data;
+
+  tail = _async.tail;
+  while ((head = __atomic_load_n(&_async.head, __ATOMIC_ACQUIRE)) != tail) {
+    while (tail != head) {
+      pos = tail % _async.size;
+      record = (struct _log_record *)&_async.ring[pos];
+
+      if (record->length == 0) {
+        /* rest of the ring is unused */
+        tail += _async.size - pos;
+      }
+      else {
+        data = (const char *)(record + 1);
+        _dispatch_record(record, data, record->hex_length ? data + record->text_length + 1 : NULL);
+        tail += record->length;
+      }
+
+      /* free space for the producer as early as possible */
+      __atomic_store_n(&_async.tail, tail, __ATOMIC_RELEASE);
+    }
+  }
+
+  dropped = __atomic_load_n(&_async.dropped, __ATOMIC_RELAXED);
+  if (dropped != _async.reported) {
+    memset(&dropped_record, 0, sizeof(dropped_record));
+    os_core_gettimeofday(&dropped_record.time);
+    dropped_record.file = __FILE__;
+    dropped_record.line = __LINE__;
+    dropped_record.severity = LOG_SEVERITY_WARN;
+    dropped_record.source = LOG_LOGGING;
+    dropped_record.text_length = snprintf(text, sizeof(text), "Asynchronous logging dropped %" PRIu64 " events",
+      dropped - _async.reported);
+
+    _dispatch_record(&dropped_record, text, NULL);
+    _async.reported = dropped;
+  }
+}
+
+/**
+ * Wait until the logging thread has emptied the ring buffer,
+ * the handler list must be locked.
+ */
+static void
+_flush_ring(void) {
+  if (!_async.running) {
+    return;
+  }
+
+  while (__atomic_load_n(&_async.head, __ATOMIC_ACQUIRE) != _async.tail) {
+    pthread_cond_signal(&_async.work);
+    pthread_cond_wait(&_async.drained, &_async.mutex);
+  }
+}
+
+/**
+ * Main function of the logging thread
+ * @param ptr unused
+ * @return always NULL
+ */
+static void *
+_cb_logging_thread(void *ptr __attribute__((unused))) {
+  struct timespec timeout;
+
+  pthread_mutex_lock(&_async.mutex);
+  while (true) {
+    _drain_ring();
+    pthread_cond_broadcast(&_async.drained);
+
+    if (_async.shutdown) {
+      break;
+    }
+
+    /*
+     * the producer does not take the mutex to wake us up, so a signal
+     * might get lost. Limit the time a record can stay in the ring.
+     */
+    __atomic_store_n(&_async.sleeping, true, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&_async.head, __ATOMIC_SEQ_CST) == _async.tail) {
+      clock_gettime(CLOCK_REALTIME, &timeout);
+      if (timeout.tv_nsec < 1000000000l - LOG_ASYNC_POLL_INTERVAL * 1000000l) {
+        timeout.tv_nsec += LOG_ASYNC_POLL_INTERVAL * 1000000l;
+      }
+      else {
+        timeout.tv_sec++;
+        timeout.tv_nsec -= 1000000000l - LOG_ASYNC_POLL_INTERVAL * 1000000l;
+      }
+      pthread_cond_timedwait(&_async.work, &_async.mutex, &timeout);
+    }
+    __atomic_store_n(&_async.sleeping, false, __ATOMIC_SEQ_CST);
+  }
+  pthread_mutex_unlock(&_async.mutex);
+  return NULL;
+}
+
+/**
+ * Start the logging thread if a ring buffer is configured
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_start_thread(void) {
+  int result;
+
+  if (_async.running || _async.configured_size == 0) {
+    return 0;
+  }
+
+  _async.ring = malloc(_async.configured_size);
+  if (_async.ring == NULL) {
+    OONF_WARN(LOG_LOGGING, "Not enough memory for asynchronous logging buffer");
+    return -1;
+  }
+  if (abuf_init(&_async.buffer)) {
+    free(_async.ring);
+    _async.ring = NULL;
+    OONF_WARN(LOG_LOGGING, "Not enough memory for asynchronous logging buffer");
+    return -1;
+  }
+
+  _async.size = _async.configured_size;
+  _async.head = 0;
+  _async.tail = 0;
+  _async.reported = _async.dropped;
+  _async.sleeping = false;
+  _async.shutdown = false;
+  _async.producer = pthread_self();
+  _async.running = true;
+
+  result = pthread_create(&_async.thread, NULL, _cb_logging_thread, NULL);
+  if (result) {
+    _async.running = false;
+    free(_async.ring);
+    _async.ring = NULL;
+    abuf_free(&_async.buffer);
+    OONF_WARN(LOG_LOGGING, "Could not start logging thread: %s (%d)", strerror(result), result);
+    return -1;
+  }
+  return 0;
+}
+
+/**
+ * Write all queued logging events and stop the logging thread
+ */
+static void
+_stop_thread(void) {
+  if (!_async.running) {
+    return;
+  }
+
+  pthread_mutex_lock(&_async.mutex);
+  _async.shutdown = true;
+  pthread_cond_signal(&_async.work);
+  pthread_mutex_unlock(&_async.mutex);
+
+  pthread_join(_async.thread, NULL);
+
+  _async.running = false;
+  free(_async.ring);
+  _async.ring = NULL;
+  abuf_free(&_async.buffer);
+}
+
+/**
+ * Lock the handler list against the logging thread
+ */
+static void
+_lock_handlers(void) {
+  if (_async.running) {
+    pthread_mutex_lock(&_async.mutex);
+  }
+}
+
+/**
+ * Unlock the handler list
+ */
+static void
+_unlock_handlers(void) {
+  if (_async.running) {
+    pthread_mutex_unlock(&_async.mutex);
+  }
+}
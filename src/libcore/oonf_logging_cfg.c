@@ -78,6 +78,9 @@
 /*! configuration entry for activating stderr color logging */
 #define LOG_STDERR_COLOR_ENTRY "stderr_color"
 
+/*! configuration entry for the ring buffer size of asynchronous logging */
+#define LOG_ASYNC_BUFFER_ENTRY "async_buffer"
+
 /* prototype for configuration change handler */
 static void _cb_logcfg_apply(void);
 static void _apply_log_setting(
@@ -94,6 +97,12 @@ static struct cfg_schema_entry _logging_entries[] = {
   CFG_VALIDATE_BOOL(LOG_SYSLOG_ENTRY, "false", "Set to true to activate logging to syslog"),
   CFG_VALIDATE_STRING(LOG_FILE_ENTRY, "", "Set a filename to log to a file"),
   CFG_VALIDATE_BOOL(LOG_STDERR_COLOR_ENTRY, "false", "Use ANSI colors for stderr logging"),
+  CFG_VALIDATE_INT32_MINMAX(LOG_ASYNC_BUFFER_ENTRY, "0",
+    "Size of the ring buffer in kilobyte for asynchronous logging. Stderr, syslog and file output"
+    " will be formatted and written by a background thread. Set to 0 to log synchronously."
+    " Smaller sizes than 8 kilobyte are raised to 8 kilobyte, the text of each asynchronous"
+    " logging event is truncated after 2048 characters.",
+    0, false, 0, 65536),
 };
 
 static struct cfg_schema_section _logging_section = {
@@ -107,9 +116,13 @@ static struct cfg_schema_section _logging_section = {
 static uint8_t _logging_cfg[LOG_MAXIMUM_SOURCES];
 
 static bool _stderr_color = false;
-static struct oonf_log_handler_entry _stderr_handler = { .handler = oonf_log_stderr, .custom = &_stderr_color };
-static struct oonf_log_handler_entry _syslog_handler = { .handler = oonf_log_syslog };
-static struct oonf_log_handler_entry _file_handler = { .handler = oonf_log_file };
+static struct oonf_log_handler_entry _stderr_handler = {
+  .handler = oonf_log_stderr,
+  .custom = &_stderr_color,
+  .threadsafe = true,
+};
+static struct oonf_log_handler_entry _syslog_handler = { .handler = oonf_log_syslog, .threadsafe = true };
+static struct oonf_log_handler_entry _file_handler = { .handler = oonf_log_file, .threadsafe = true };
 
 /**
  * Initialize logging configuration
@@ -125,6 +138,9 @@ oonf_logcfg_init(void) {
  */
 void
 oonf_logcfg_cleanup(void) {
+  /* write all queued logging events */
+  oonf_log_async_stop();
+
   /* clean up former handlers */
   if (list_is_node_added(&_stderr_handler._node)) {
     oonf_log_removehandler(&_stderr_handler);
@@ -182,6 +198,9 @@ oonf_logcfg_apply(struct cfg_db *db) {
   ptr = cfg_db_get_entry_value(db, LOG_SECTION, NULL, LOG_STDERR_COLOR_ENTRY)->value;
   _stderr_color = cfg_get_bool(ptr);
 
+  ptr = cfg_db_get_entry_value(db, LOG_SECTION, NULL, LOG_ASYNC_BUFFER_ENTRY)->value;
+  oonf_log_async_setup((size_t)strtoul(ptr, NULL, 10) * 1024);
+
   /* and finally modify the logging handlers */
   /* log.file */
   if (activate_file && !list_is_node_added(&_file_handler._node)) {
@@ -189,8 +208,9 @@ oonf_logcfg_apply(struct cfg_db *db) {
 
     f = fopen(file_name, "w");
     if (f != NULL) {
-      oonf_log_addhandler(&_file_handler);
+      /* the logging thread might use the handler immediately */
       _file_handler.custom = f;
+      oonf_log_addhandler(&_file_handler);
     }
     else {
       file_errno = errno;
@@ -274,6 +274,9 @@ oonf_main(int argc, char **argv, const struct oonf_appdata *appdata) {
     }
   }
 
+  /* start logging thread now, it would not survive the fork */
+  oonf_log_async_start();
+
   /* activate mainloop */
   return_code = mainloop(argc, argv, appdata);
 
@@ -285,6 +288,9 @@ oonf_main(int argc, char **argv, const struct oonf_appdata *appdata) {
     ;
 
 oonf_cleanup:
+  /* write queued logging events while all plugins are still loaded */
+  oonf_log_async_stop();
+
   /* free plugins */
   oonf_cfg_unconfigure_subsystems();
   oonf_subsystem_cleanup();
@@ -310,6 +310,7 @@ oonf_subsystem_load(const char *libname) {
     /* plugin should be in the tree now */
     if ((plugin = oonf_subsystem_get(libname)) == NULL) {
       OONF_WARN(LOG_PLUGINS, "dynamic library loading failed: \"%s\"!\n", dlerror());
+      oonf_log_async_flush();
       dlclose(dlhandle);
       return NULL;
     }
@@ -492,6 +493,8 @@ _unload_plugin(struct oonf_subsystem *plugin, bool cleanup) {
 
   /* cleanup */
   if (plugin->_dlhandle) {
+    /* queued logging events might point to file names of the plugin */
+    oonf_log_async_flush();
     dlclose(plugin->_dlhandle);
   }
   return 0;
@@ -91,6 +91,17 @@ static void _write_addresses(
 static void _write_msgheader(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg);
 static uint8_t *_write_addresstlvs(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg,
   struct rfc5444_writer_address *first, struct rfc5444_writer_address *last, uint8_t *ptr);
+static void _flush_full_targets(
+  struct rfc5444_writer *writer, size_t msg_size, rfc5444_writer_targetselector useIf, void *param);
+static void _add_message_to_targets(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg,
+  size_t generic_size, rfc5444_writer_targetselector useIf, void *param);
+static struct rfc5444_writer_msgcache *_get_msgcache(
+  struct rfc5444_writer_message *msg, struct rfc5444_writer_target *target, uint8_t addr_len);
+static bool _is_msgcache_valid(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg,
+  struct rfc5444_writer_msgcache *cache, size_t max_msg_size);
+static void _store_msgcache(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg, size_t size);
+static void _send_cached_message(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg,
+  struct rfc5444_writer_msgcache *cache, rfc5444_writer_targetselector useIf, void *param);
 
 /*! temporary buffer for messages when going through a postprocessor */
 static uint8_t _msg_buffer[RFC5444_MAX_MESSAGE_SIZE];
@@ -119,6 +130,7 @@ rfc5444_writer_create_message(
   struct rfc5444_writer_address *first_processed, *last_processed;
   struct rfc5444_writer_tlvtype *tlvtype;
   struct rfc5444_writer_target *target;
+  struct rfc5444_writer_msgcache *cache;
   struct list_entity current_list;
 
   struct rfc5444_writer_postprocessor *processor;
@@ -232,6 +244,17 @@ rfc5444_writer_create_message(
     }
   }
 
+  /* reuse the cached message if its content did not change */
+  if (msg->cache_enabled) {
+    cache = _get_msgcache(msg, writer->msg_target, addr_len);
+    if (cache != NULL && _is_msgcache_valid(writer, msg, cache, max_msg_size)) {
+      _send_cached_message(writer, msg, cache, useIf, param);
+      writer->msg_addr_len = 0;
+      return RFC5444_OKAY;
+    }
+  }
+  msg->cache_misses++;
+
 #if WRITER_STATE_MACHINE == true
   writer->_state = RFC5444_WRITER_ADD_MSGTLV;
 #endif
@@ -1422,13 +1445,10 @@ _write_msgheader(struct rfc5444_writer *writer, struct rfc5444_writer_message *m
 static void
 _finalize_message_fragment(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg,
   struct list_entity *fragment_addrs, bool not_fragmented, rfc5444_writer_targetselector useIf, void *param) {
-  struct rfc5444_writer_postprocessor *processor;
   struct rfc5444_writer_content_provider *prv;
-  struct rfc5444_writer_target *target;
   struct rfc5444_writer_address *addr, *first, *last;
   uint8_t *ptr;
-  size_t msg_minsize, msg_size, generic_size;
-  bool error;
+  size_t msg_minsize, generic_size;
 
   /* reset optional tlv length */
   writer->_msg.set = 0;
@@ -1493,6 +1513,53 @@ _finalize_message_fragment(struct rfc5444_writer *writer, struct rfc5444_writer_
   msg_minsize = writer->_msg.header + writer->_msg.added;
 
   /* 1.) first flush all interfaces that have full buffers */
+  _flush_full_targets(writer, msg_minsize + writer->_msg.set + msg->_bin_addr_size, useIf, param);
+
+  /* 2.) generate message and do non-target specific post processors */
+
+  /* copy message header and message tlvs into packet buffer */
+  ptr = _msg_buffer;
+  memcpy(ptr, writer->_msg.buffer, msg_minsize + writer->_msg.set);
+
+  /* copy address blocks and address tlvs into packet buffer */
+  ptr += msg_minsize + writer->_msg.set;
+  memcpy(ptr, &writer->_msg.buffer[msg_minsize + writer->_msg.allocated], msg->_bin_addr_size);
+
+  /* remember position of first copy */
+  generic_size = msg_minsize + writer->_msg.set + msg->_bin_addr_size;
+
+  /* keep a copy of unfragmented messages for the next round */
+  if (msg->cache_enabled && not_fragmented) {
+    _store_msgcache(writer, msg, generic_size);
+  }
+
+  /* 3.) run post processors and add message to target buffers */
+  _add_message_to_targets(writer, msg, generic_size, useIf, param);
+
+  /* clear length value of message address size */
+  msg->_bin_addr_size = 0;
+
+  /* reset message tlv variables */
+  writer->_msg.set = 0;
+
+  /* clear message buffer */
+#if DEBUG_CLEANUP == true
+  memset(&writer->_msg.buffer[msg_minsize], 253, writer->_msg.max - msg_minsize);
+#endif
+}
+
+/**
+ * Flush all selected targets which do not have enough space left
+ * for the next message and start a new packet for them.
+ * @param writer pointer to writer context
+ * @param msg_size size of the next message
+ * @param useIf pointer to callback for selecting outgoing _targets
+ * @param param custom parameter for callback
+ */
+static void
+_flush_full_targets(struct rfc5444_writer *writer, size_t msg_size, rfc5444_writer_targetselector useIf, void *param) {
+  struct rfc5444_writer_target *target;
+
   list_for_each_element(&writer->_targets, target, _target_node) {
     /* do we need to handle this interface ? */
     if (!useIf(writer, target, param)) {
@@ -1500,8 +1567,7 @@ _finalize_message_fragment(struct rfc5444_writer *writer, struct rfc5444_writer_
     }
 
     /* calculate total size of packet and message, see if it fits into the current packet */
-    if (target->_pkt.header + target->_pkt.added + target->_pkt.set + target->_bin_msgs_size + writer->_msg.header +
-          writer->_msg.added + writer->_msg.set + msg->_bin_addr_size >
+    if (target->_pkt.header + target->_pkt.added + target->_pkt.set + target->_bin_msgs_size + msg_size >
         target->_pkt.max) {
       /* flush the old packet */
       rfc5444_writer_flush(writer, target, false);
@@ -1510,31 +1576,38 @@ _finalize_message_fragment(struct rfc5444_writer *writer, struct rfc5444_writer_
       _rfc5444_writer_begin_packet(writer, target);
     }
   }
+}
 
-  /* 2.) generate message and do non-target specific post processors */
-
-  /* copy message header and message tlvs into packet buffer */
-  ptr = _msg_buffer;
-  memcpy(ptr, writer->_msg.buffer, msg_minsize + writer->_msg.set);
-
-  /* copy address blocks and address tlvs into packet buffer */
-  ptr += msg_minsize + writer->_msg.set;
-  memcpy(ptr, &writer->_msg.buffer[msg_minsize + writer->_msg.allocated], msg->_bin_addr_size);
-
-  /* remember position of first copy */
-  generic_size = msg_minsize + writer->_msg.set + msg->_bin_addr_size;
+/**
+ * Run the post-processors over the message in the temporary
+ * message buffer and copy it into the packet buffers of all
+ * selected targets.
+ * @param writer pointer to writer context
+ * @param msg pointer to message object
+ * @param generic_size size of the message in the temporary buffer
+ * @param useIf pointer to callback for selecting outgoing _targets
+ * @param param custom parameter for callback
+ */
+static void
+_add_message_to_targets(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg, size_t generic_size,
+  rfc5444_writer_targetselector useIf, void *param) {
+  struct rfc5444_writer_postprocessor *processor;
+  struct rfc5444_writer_target *target;
+  uint8_t *ptr;
+  size_t msg_size;
+  bool error;
 
-  /* run processors */
+  /* run non-target specific processors */
   avl_for_each_element(&writer->_processors, processor, _node) {
     if (processor->is_matching_signature(processor, msg->type) && !processor->target_specific) {
-      if (processor->process(processor, target, msg, _msg_buffer, &generic_size)) {
+      if (processor->process(processor, NULL, msg, _msg_buffer, &generic_size)) {
         /* error, we have not modified the _bin_msgs_size, so we can just return */
         return;
       }
     }
   }
 
-  /* 3.) generate target specific messages and add them to the buffers */
+  /* generate target specific messages and add them to the buffers */
   list_for_each_element(&writer->_targets, target, _target_node) {
     /* do we need to handle this interface ? */
     if (!useIf(writer, target, param)) {
@@ -1567,15 +1640,146 @@ _finalize_message_fragment(struct rfc5444_writer *writer, struct rfc5444_writer_
       }
     }
   }
+}
 
-  /* clear length value of message address size */
-  msg->_bin_addr_size = 0;
+/**
+ * Get the cached image of a message
+ * @param msg pointer to message object
+ * @param target target of a target specific message, NULL otherwise
+ * @param addr_len address length of message
+ * @return cached message image, NULL if not found
+ */
+static struct rfc5444_writer_msgcache *
+_get_msgcache(struct rfc5444_writer_message *msg, struct rfc5444_writer_target *target, uint8_t addr_len) {
+  struct rfc5444_writer_msgcache *cache;
 
-  /* reset message tlv variables */
-  writer->_msg.set = 0;
+  list_for_each_element(&msg->_cache_head, cache, _node) {
+    if (cache->target == target && cache->addr_len == addr_len) {
+      return cache;
+    }
+  }
+  return NULL;
+}
 
-  /* clear message buffer */
-#if DEBUG_CLEANUP == true
-  memset(&writer->_msg.buffer[msg_minsize], 253, writer->_msg.max - msg_minsize);
+/**
+ * Check if a cached message image can be reused for the current message
+ * @param writer pointer to writer context
+ * @param msg pointer to message object, message header must be set
+ * @param cache cached message image
+ * @param max_msg_size maximum size of the current message
+ * @return true if the image matches the content generation
+ *   and the message header layout
+ */
+static bool
+_is_msgcache_valid(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg,
+  struct rfc5444_writer_msgcache *cache, size_t max_msg_size) {
+  uint8_t flags;
+
+  if (cache->generation != msg->content_generation || cache->size > max_msg_size) {
+    return false;
+  }
+
+  flags = writer->msg_addr_len - 1;
+  if (msg->has_origaddr) {
+    flags |= RFC5444_MSG_FLAG_ORIGINATOR;
+  }
+  if (msg->has_hoplimit) {
+    flags |= RFC5444_MSG_FLAG_HOPLIMIT;
+  }
+  if (msg->has_hopcount) {
+    flags |= RFC5444_MSG_FLAG_HOPCOUNT;
+  }
+  if (msg->has_seqno) {
+    flags |= RFC5444_MSG_FLAG_SEQNO;
+  }
+  if (cache->data[1] != flags) {
+    return false;
+  }
+
+  return !msg->has_origaddr || memcmp(&cache->data[4], msg->orig_addr, writer->msg_addr_len) == 0;
+}
+
+/**
+ * Store the message in the temporary buffer as the cached
+ * image of the message
+ * @param writer pointer to writer context
+ * @param msg pointer to message object
+ * @param size size of the message in the temporary buffer
+ */
+static void
+_store_msgcache(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg, size_t size) {
+  struct rfc5444_writer_msgcache *cache;
+
+  cache = _get_msgcache(msg, writer->msg_target, writer->msg_addr_len);
+  if (cache == NULL) {
+    cache = calloc(1, sizeof(*cache));
+    if (cache == NULL) {
+      /* no cache, the message will just be generated again */
+      return;
+    }
+
+    cache->target = writer->msg_target;
+    cache->addr_len = writer->msg_addr_len;
+    list_add_tail(&msg->_cache_head, &cache->_node);
+  }
+
+  cache->generation = msg->content_generation;
+  cache->size = size;
+  memcpy(cache->data, _msg_buffer, size);
+}
+
+/**
+ * Add a cached message to the packet buffers of all selected
+ * targets. Only the hoplimit, hopcount and sequence number of
+ * the image are updated, signatures and other post-processing
+ * is done again.
+ * @param writer pointer to writer context
+ * @param msg pointer to message object
+ * @param cache cached message image
+ * @param useIf pointer to callback for selecting outgoing _targets
+ * @param param custom parameter for callback
+ */
+static void
+_send_cached_message(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg,
+  struct rfc5444_writer_msgcache *cache, rfc5444_writer_targetselector useIf, void *param) {
+  uint8_t *ptr;
+
+#if WRITER_STATE_MACHINE == true
+  writer->_state = RFC5444_WRITER_FINISH_HEADER;
 #endif
+
+  /* let the message creator update the message header */
+  if (msg->finishMessageHeader) {
+    msg->finishMessageHeader(writer, msg, NULL, NULL, true);
+  }
+
+#if WRITER_STATE_MACHINE == true
+  writer->_state = RFC5444_WRITER_NONE;
+#endif
+
+  msg->cache_hits++;
+
+  _flush_full_targets(writer, cache->size, useIf, param);
+
+  memcpy(_msg_buffer, cache->data, cache->size);
+
+  /* skip type, flags, size and originator */
+  ptr = &_msg_buffer[4];
+  if (msg->has_origaddr) {
+    ptr += writer->msg_addr_len;
+  }
+
+  /* patch variable header fields */
+  if (msg->has_hoplimit) {
+    *ptr++ = msg->hoplimit;
+  }
+  if (msg->has_hopcount) {
+    *ptr++ = msg->hopcount;
+  }
+  if (msg->has_seqno) {
+    *ptr++ = msg->seqno >> 8;
+    *ptr++ = msg->seqno & 255;
+  }
+
+  _add_message_to_targets(writer, msg, cache->size, useIf, param);
 }
@@ -47,7 +47,6 @@
 #include <string.h>
 
 #include <oonf/libcommon/avl.h>
-#include <oonf/libcommon/avl_comp.h>
 #include <oonf/libcommon/bitmap256.h>
 #include <oonf/oonf.h>
 #include <oonf/librfc5444/rfc5444_api_config.h>
@@ -71,13 +70,12 @@ static int _compare_tlvtypes(
   struct rfc5444_reader_tlvblock_entry *tlv, struct rfc5444_reader_tlvblock_consumer_entry *entry);
 static uint8_t _rfc5444_get_u8(const uint8_t **ptr, const uint8_t *end, enum rfc5444_result *result);
 static uint16_t _rfc5444_get_u16(const uint8_t **ptr, const uint8_t *end, enum rfc5444_result *result);
-static void _free_tlvblock(struct rfc5444_reader *parser, struct avl_tree *entries);
 static int _parse_tlv(
   struct rfc5444_reader_tlvblock_entry *entry, const uint8_t **ptr, const uint8_t *eob, uint8_t addr_count);
-static int _parse_tlvblock(struct rfc5444_reader *parser, struct avl_tree *tlvblock, const uint8_t **ptr,
+static int _parse_tlvblock(struct rfc5444_reader *parser, struct rfc5444_reader_tlvblock *tlvblock, const uint8_t **ptr,
   const uint8_t *eob, uint8_t addr_count);
 static int _schedule_tlvblock(struct rfc5444_reader_tlvblock_consumer *consumer,
-  struct rfc5444_reader_tlvblock_context *context, struct avl_tree *entries, uint8_t idx);
+  struct rfc5444_reader_tlvblock_context *context, struct rfc5444_reader_tlvblock *entries, uint8_t idx);
 static int _parse_addrblock(struct rfc5444_reader_addrblock_entry *addr_entry,
   struct rfc5444_reader_tlvblock_context *tlv_context, const uint8_t **ptr, const uint8_t *eob);
 static int _handle_message(struct rfc5444_reader *parser, struct rfc5444_reader_tlvblock_context *tlv_context,
@@ -85,10 +83,9 @@ static int _handle_message(struct rfc5444_reader *parser, struct rfc5444_reader_
 static struct rfc5444_reader_tlvblock_consumer *_add_consumer(struct rfc5444_reader_tlvblock_consumer *,
   struct avl_tree *consumer_tree, struct rfc5444_reader_tlvblock_consumer_entry *entries, int entrycount);
 static void _free_consumer(struct avl_tree *consumer_tree, struct rfc5444_reader_tlvblock_consumer *consumer);
-static struct rfc5444_reader_addrblock_entry *_malloc_addrblock_entry(void);
-static struct rfc5444_reader_tlvblock_entry *_malloc_tlvblock_entry(void);
-static void _free_addrblock_entry(struct rfc5444_reader_addrblock_entry *entry);
-static void _free_tlvblock_entry(struct rfc5444_reader_tlvblock_entry *entry);
+static void *_arena_alloc(struct rfc5444_reader_arena *arena, size_t size);
+static void _arena_reset(struct rfc5444_reader_arena *arena);
+static void _arena_free(struct rfc5444_reader_arena *arena);
 
 static uint8_t rfc5444_get_pktversion(uint8_t v);
 
@@ -100,16 +97,7 @@ void
 rfc5444_reader_init(struct rfc5444_reader *context) {
   avl_init(&context->packet_consumer, _consumer_avl_comp, true);
   avl_init(&context->message_consumer, _consumer_avl_comp, true);
-
-  if (context->malloc_addrblock_entry == NULL)
-    context->malloc_addrblock_entry = _malloc_addrblock_entry;
-  if (context->malloc_tlvblock_entry == NULL)
-    context->malloc_tlvblock_entry = _malloc_tlvblock_entry;
-
-  if (context->free_addrblock_entry == NULL)
-    context->free_addrblock_entry = _free_addrblock_entry;
-  if (context->free_tlvblock_entry == NULL)
-    context->free_tlvblock_entry = _free_tlvblock_entry;
+  memset(&context->arena, 0, sizeof(context->arena));
 }
 
 /**
@@ -121,6 +109,7 @@ void
 rfc5444_reader_cleanup(struct rfc5444_reader *context) {
   memset(&context->packet_consumer, 0, sizeof(context->packet_consumer));
   memset(&context->message_consumer, 0, sizeof(context->message_consumer));
+  _arena_free(&context->arena);
 }
 
 /**
@@ -134,7 +123,7 @@ enum rfc5444_result
 rfc5444_reader_handle_packet(struct rfc5444_reader *parser, const uint8_t *buffer, size_t length)
 {
   struct rfc5444_reader_tlvblock_context context;
-  struct avl_tree entries;
+  struct rfc5444_reader_tlvblock entries;
   struct rfc5444_reader_tlvblock_consumer *consumer, *last_started;
   const uint8_t *ptr, *eob;
   bool has_tlv;
@@ -181,8 +170,8 @@ rfc5444_reader_handle_packet(struct rfc5444_reader *parser, const uint8_t *buffe
     return result;
   }
 
-  /* initialize avl_tree */
-  avl_init(&entries, avl_comp_uint32, true);
+  /* initialize tlvblock */
+  memset(&entries, 0, sizeof(entries));
   last_started = NULL;
 
   /* check for packet tlv */
@@ -192,8 +181,9 @@ rfc5444_reader_handle_packet(struct rfc5444_reader *parser, const uint8_t *buffe
     if (result != RFC5444_OKAY) {
       /*
        * error while parsing TLV block, do not jump to cleanup_parse packet because
-       * we have not allocated any resources at this point
+       * no consumer has been started at this point
        */
+      _arena_reset(&parser->arena);
       return result;
     }
   }
@@ -251,7 +241,9 @@ cleanup_parse_packet:
       }
     }
   }
-  _free_tlvblock(parser, &entries);
+
+  /* hand back all memory of this packet */
+  _arena_reset(&parser->arena);
 
   /* do not tell caller about packet drop */
 #if DISALLOW_CONSUMER_CONTEXT_DROP == false
@@ -419,19 +411,6 @@ _rfc5444_get_u16(const uint8_t **ptr, const uint8_t *end, enum rfc5444_result *e
   return ((uint16_t)_rfc5444_get_u8(ptr, end, error) << 8) | (uint16_t)_rfc5444_get_u8(ptr, end, error);
 }
 
-/**
- * free a list of linked tlv_block entries
- * @param entries avl_tree of tlv_block entries
- */
-static void
-_free_tlvblock(struct rfc5444_reader *parser, struct avl_tree *entries) {
-  struct rfc5444_reader_tlvblock_entry *tlv, *ptr;
-
-  avl_remove_all_elements(entries, tlv, node, ptr) {
-    parser->free_tlvblock_entry(tlv);
-  }
-}
-
 /**
  * parse a TLV into a rfc5444_reader_tlvblock_entry and advance the data stream pointer
  * @param entry pointer to rfc5444_reader_tlvblock_entry
@@ -446,7 +425,8 @@ _free_tlvblock(struct rfc5444_reader *parser, struct avl_tree *entries) {
 static enum rfc5444_result
 _parse_tlv(struct rfc5444_reader_tlvblock_entry *entry, const uint8_t **ptr, const uint8_t *eob, uint8_t addr_count) {
   enum rfc5444_result result = RFC5444_OKAY;
-  uint8_t masked, count;
+  uint8_t masked;
+  uint16_t count;
 
   /* get tlv type (without extension) and flags */
   entry->type = _rfc5444_get_u8(ptr, eob, &result);
@@ -483,7 +463,8 @@ _parse_tlv(struct rfc5444_reader_tlvblock_entry *entry, const uint8_t **ptr, con
   }
 
   /* consistency check for index fields */
-  if (addr_count > 0 && (entry->index1 >= addr_count || entry->index2 >= addr_count)) {
+  if (entry->index1 > entry->index2 ||
+      (addr_count > 0 && (entry->index1 >= addr_count || entry->index2 >= addr_count))) {
     *ptr = eob;
     return RFC5444_BAD_TLV_INDEX;
   }
@@ -546,8 +527,9 @@ _parse_tlv(struct rfc5444_reader_tlvblock_entry *entry, const uint8_t **ptr, con
 }
 
 /**
- * parse a TLV block into a list of linked tlvblock_entries.
- * @param tlvblock pointer to avl_tree to store generates tlvblock entries
+ * parse a TLV block into a sorted array of tlvblock_entries.
+ * @param parser pointer to parser context
+ * @param tlvblock pointer to tlvblock to store the generated entries
  * @param ptr pointer to pointer to begin of datastream, will be
  *   incremented to the first byte after the block if no error happened.
  *   Will be set to eob if an error happened.
@@ -556,12 +538,15 @@ _parse_tlv(struct rfc5444_reader_tlvblock_entry *entry, const uint8_t **ptr, con
  *   packet tlv * @return -1 if an error happened, 0 otherwise
  */
 static enum rfc5444_result
-_parse_tlvblock(struct rfc5444_reader *parser, struct avl_tree *tlvblock, const uint8_t **ptr, const uint8_t *eob,
-  uint8_t addr_count) {
+_parse_tlvblock(struct rfc5444_reader *parser, struct rfc5444_reader_tlvblock *tlvblock, const uint8_t **ptr,
+  const uint8_t *eob, uint8_t addr_count) {
   enum rfc5444_result result = RFC5444_OKAY;
-  struct rfc5444_reader_tlvblock_entry *tlv1 = NULL;
   struct rfc5444_reader_tlvblock_entry entry;
-  const uint8_t *end;
+  const uint8_t *end, *start;
+  uint16_t count, i;
+
+  tlvblock->entries = NULL;
+  tlvblock->count = 0;
 
   /* get length of TLV block */
   end = (*ptr) + 2;
@@ -576,33 +561,45 @@ _parse_tlvblock(struct rfc5444_reader *parser, struct avl_tree *tlvblock, const
   /* clear static buffer */
   memset(&entry, 0, sizeof(entry));
 
-  /* parse tlvs */
+  /* validate TLVs and count them to get the size of the array */
+  start = *ptr;
+  count = 0;
   while (*ptr < end) {
-    /* parse next TLV into static buffer */
     result = _parse_tlv(&entry, ptr, eob, addr_count);
     if (result != RFC5444_OKAY) {
       /* error while parsing TLV */
       goto cleanup_parse_tlvblock;
     }
+    count++;
+  }
 
-    /* get memory to store TLV block entry */
-    tlv1 = parser->malloc_tlvblock_entry();
-    if (tlv1 == NULL) {
-      /* not enough memory left ! */
-      result = RFC5444_OUT_OF_MEMORY;
-      goto cleanup_parse_tlvblock;
-    }
+  if (count == 0) {
+    return RFC5444_OKAY;
+  }
+
+  /* get memory to store TLV block entries */
+  tlvblock->entries = _arena_alloc(&parser->arena, sizeof(entry) * count);
+  if (tlvblock->entries == NULL) {
+    /* not enough memory left ! */
+    result = RFC5444_OUT_OF_MEMORY;
+    goto cleanup_parse_tlvblock;
+  }
 
-    /* copy TLV block entry into allocated memory */
-    memcpy(tlv1, &entry, sizeof(entry));
+  /* parse tlvs again and keep the array sorted, tlvs of the same type stay in packet order */
+  *ptr = start;
+  while (*ptr < end) {
+    _parse_tlv(&entry, ptr, eob, addr_count);
 
-    /* put into sorted list */
-    tlv1->node.key = &tlv1->_order;
-    avl_insert(tlvblock, &tlv1->node);
+    for (i = tlvblock->count; i > 0 && tlvblock->entries[i - 1]._order > entry._order; i--) {
+      memcpy(&tlvblock->entries[i], &tlvblock->entries[i - 1], sizeof(entry));
+    }
+    memcpy(&tlvblock->entries[i], &entry, sizeof(entry));
+    tlvblock->count++;
   }
 cleanup_parse_tlvblock:
   if (result != RFC5444_OKAY) {
-    _free_tlvblock(parser, tlvblock);
+    tlvblock->entries = NULL;
+    tlvblock->count = 0;
     *ptr = eob;
   }
   return result;
@@ -612,7 +609,7 @@ cleanup_parse_tlvblock:
  * Call callbacks for parsed TLV blocks
  * @param consumer pointer to first consumer for this message type
  * @param context pointer to context for tlv block
- * @param entries pointer avl_tree of tlv block entries
+ * @param entries pointer to tlv block
  * @param idx of current address inside the addressblock, 0 for message tlv block
  * @return RFC5444_TLV_DROP_ADDRESS if the current address should
  *   be dropped for later consumers, RFC5444_TLV_DROP_CONTEXT if
@@ -621,7 +618,7 @@ cleanup_parse_tlvblock:
  */
 static enum rfc5444_result
 _schedule_tlvblock(struct rfc5444_reader_tlvblock_consumer *consumer, struct rfc5444_reader_tlvblock_context *context,
-  struct avl_tree *entries, uint8_t idx) {
+  struct rfc5444_reader_tlvblock *entries, uint8_t idx) {
   struct rfc5444_reader_tlvblock_entry *tlv = NULL, *nexttlv = NULL;
   struct rfc5444_reader_tlvblock_consumer_entry *cons_entry;
   bool constraints_failed;
@@ -630,11 +627,11 @@ _schedule_tlvblock(struct rfc5444_reader_tlvblock_consumer *consumer, struct rfc
   constraints_failed = false;
 
   /* initialize tlv pointers, there must be TLVs */
-  if (avl_is_empty(entries)) {
+  if (entries->count == 0) {
     tlv = NULL;
   }
   else {
-    tlv = avl_first_element(entries, tlv, node);
+    tlv = &entries->entries[0];
   }
 
   /* initialize consumer pointer */
@@ -732,11 +729,11 @@ _schedule_tlvblock(struct rfc5444_reader_tlvblock_consumer *consumer, struct rfc
     }
     if (tlv != NULL && _compare_tlvtypes(tlv, cons_entry) <= 0) {
       /* advance tlv pointer */
-      if (avl_is_last(entries, &tlv->node)) {
+      if (tlv == &entries->entries[entries->count - 1]) {
         tlv = NULL;
       }
       else {
-        tlv = avl_next_element(tlv, node);
+        tlv++;
       }
     }
     if (_compare_tlvtypes(tlv, cons_entry) > 0) {
@@ -908,13 +905,13 @@ _parse_addrblock(struct rfc5444_reader_addrblock_entry *addr_entry, struct rfc54
  * Call start and tlvblock callbacks for message tlv consumer
  * @param consumer pointer to tlvblock consumer object
  * @param tlv_context current tlv context
- * @param tlv_entries pointer to tlventry avltree
+ * @param tlv_entries pointer to message tlv block
  * @return RFC5444_OKAY if no error happend, RFC5444_DROP_ if a
  *   context (message or packet) should be dropped
  */
 static enum rfc5444_result
 schedule_msgtlv_consumer(struct rfc5444_reader_tlvblock_consumer *consumer,
-  struct rfc5444_reader_tlvblock_context *tlv_context, struct avl_tree *tlv_entries) {
+  struct rfc5444_reader_tlvblock_context *tlv_context, struct rfc5444_reader_tlvblock *tlv_entries) {
   enum rfc5444_result result = RFC5444_OKAY;
   tlv_context->type = RFC5444_CONTEXT_MESSAGE;
 
@@ -1073,10 +1070,10 @@ schedule_end_message_cbs(struct rfc5444_reader_tlvblock_context *tlv_context,
 static enum rfc5444_result
 _handle_message(struct rfc5444_reader *parser, struct rfc5444_reader_tlvblock_context *tlv_context, const uint8_t **ptr,
   const uint8_t *eob) {
-  struct avl_tree tlv_entries;
+  struct rfc5444_reader_tlvblock tlv_entries;
   struct rfc5444_reader_tlvblock_consumer *consumer, *same_order[2];
   struct list_entity addr_head;
-  struct rfc5444_reader_addrblock_entry *addr, *safe;
+  struct rfc5444_reader_addrblock_entry *addr;
   const uint8_t *start, *end = NULL;
   uint8_t flags;
   uint16_t size;
@@ -1086,7 +1083,7 @@ _handle_message(struct rfc5444_reader *parser, struct rfc5444_reader_tlvblock_co
   /* initialize variables */
   result = RFC5444_OKAY;
   same_order[0] = same_order[1] = NULL;
-  avl_init(&tlv_entries, avl_comp_uint16, true);
+  memset(&tlv_entries, 0, sizeof(tlv_entries));
   list_init_head(&addr_head);
   tlv_context->_do_not_forward = false;
 
@@ -1151,25 +1148,20 @@ _handle_message(struct rfc5444_reader *parser, struct rfc5444_reader_tlvblock_co
   /* parse rest of message */
   while (*ptr < end) {
     /* get memory for storing the address block entry */
-    addr = parser->malloc_addrblock_entry();
+    addr = _arena_alloc(&parser->arena, sizeof(*addr));
     if (addr == NULL) {
       result = RFC5444_OUT_OF_MEMORY;
       goto cleanup_parse_message;
     }
 
-    /* initialize avl_tree */
-    avl_init(&addr->tlvblock, avl_comp_uint16, true);
-
     /* parse address block... */
     if ((result = _parse_addrblock(addr, tlv_context, ptr, end)) != RFC5444_OKAY) {
-      parser->free_addrblock_entry(addr);
       goto cleanup_parse_message;
     }
 
     /* ... and corresponding tlvblock */
     result = _parse_tlvblock(parser, &addr->tlvblock, ptr, end, addr->num_addr);
     if (result != RFC5444_OKAY) {
-      parser->free_addrblock_entry(addr);
       goto cleanup_parse_message;
     }
 
@@ -1259,14 +1251,7 @@ cleanup_parse_message:
     }
   }
 
-  /* free address tlvblocks */
-  list_for_each_element_safe(&addr_head, addr, list_node, safe) {
-    _free_tlvblock(parser, &addr->tlvblock);
-    parser->free_addrblock_entry(addr);
-  }
-
-  /* free message tlvblock */
-  _free_tlvblock(parser, &tlv_entries);
+  /* address and tlv blocks stay in the arena until the end of the packet */
   *ptr = end;
 #if DISALLOW_CONSUMER_CONTEXT_DROP == false
   if (result > RFC5444_OKAY && result != RFC5444_DROP_PACKET) {
@@ -1342,39 +1327,108 @@ _free_consumer(struct avl_tree *consumer_tree, struct rfc5444_reader_tlvblock_co
 }
 
 /**
- * Internal memory allocation function for addrblock
- * @return pointer to cleared addrblock
+ * Allocate cleared memory from the reader arena
+ * @param arena pointer to reader arena
+ * @param size number of bytes
+ * @return pointer to cleared memory, NULL if out of memory
  */
-static struct rfc5444_reader_addrblock_entry *
-_malloc_addrblock_entry(void) {
-  return calloc(1, sizeof(struct rfc5444_reader_addrblock_entry));
-}
+static void *
+_arena_alloc(struct rfc5444_reader_arena *arena, size_t size) {
+  struct rfc5444_reader_arena_chunk *chunk, *last;
+  size_t chunk_size;
+  uint8_t *ptr;
+
+  /* keep all allocations aligned */
+  size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+  last = NULL;
+  for (chunk = arena->_current; chunk != NULL; chunk = chunk->next) {
+    if (chunk->used + size <= chunk->size) {
+      break;
+    }
+    last = chunk;
+  }
 
-/**
- * Internal memory allocation function for rfc5444_reader_tlvblock_entry
- * @return pointer to cleared rfc5444_reader_tlvblock_entry
- */
-static struct rfc5444_reader_tlvblock_entry *
-_malloc_tlvblock_entry(void) {
-  return calloc(1, sizeof(struct rfc5444_reader_tlvblock_entry));
+  if (chunk == NULL) {
+    /* get a new chunk from the system */
+    chunk_size = arena->_next_size;
+    if (chunk_size < RFC5444_READER_ARENA_CHUNK) {
+      chunk_size = RFC5444_READER_ARENA_CHUNK;
+    }
+    if (chunk_size < size) {
+      chunk_size = size;
+    }
+
+    chunk = malloc(sizeof(*chunk) + chunk_size);
+    if (chunk == NULL) {
+      return NULL;
+    }
+    chunk->next = NULL;
+    chunk->size = chunk_size;
+    chunk->used = 0;
+
+    if (last) {
+      last->next = chunk;
+    }
+    else {
+      arena->_first = chunk;
+    }
+    arena->chunk_allocations++;
+  }
+
+  arena->_current = chunk;
+  arena->allocations++;
+
+  ptr = (uint8_t *)(chunk + 1) + chunk->used;
+  chunk->used += size;
+
+  memset(ptr, 0, size);
+  return ptr;
 }
 
 /**
- * Free an addressblock entry
- * @param entry addressblock entry
+ * Hand back all memory of the reader arena. If the last packet needed
+ * more than one chunk, the chunks are merged into a single larger one
+ * at the next allocation.
+ * @param arena pointer to reader arena
  */
 static void
-_free_addrblock_entry(struct rfc5444_reader_addrblock_entry *entry) {
-  free(entry);
+_arena_reset(struct rfc5444_reader_arena *arena) {
+  struct rfc5444_reader_arena_chunk *chunk;
+  size_t total;
+
+  if (arena->_first == NULL) {
+    return;
+  }
+
+  if (arena->_first->next != NULL) {
+    total = 0;
+    for (chunk = arena->_first; chunk != NULL; chunk = chunk->next) {
+      total += chunk->size;
+    }
+    _arena_free(arena);
+    arena->_next_size = total;
+    return;
+  }
+
+  arena->_first->used = 0;
+  arena->_current = arena->_first;
 }
 
 /**
- * Free an tlvblock entry
- * @param entry tlvblock entry
+ * Return all chunks of the reader arena to the system
+ * @param arena pointer to reader arena
  */
 static void
-_free_tlvblock_entry(struct rfc5444_reader_tlvblock_entry *entry) {
-  free(entry);
+_arena_free(struct rfc5444_reader_arena *arena) {
+  struct rfc5444_reader_arena_chunk *chunk;
+
+  while (arena->_first) {
+    chunk = arena->_first;
+    arena->_first = chunk->next;
+    free(chunk);
+  }
+  arena->_current = NULL;
 }
 
 /**
@@ -354,6 +354,9 @@ rfc5444_writer_register_msgcontentprovider(struct rfc5444_writer *writer, struct
   cpr->_provider_node.key = &cpr->priority;
 
   avl_insert(&msg->_provider_tree, &cpr->_provider_node);
+
+  /* message content will change */
+  rfc5444_writer_clear_message_cache(msg);
   return 0;
 }
 
@@ -381,6 +384,7 @@ rfc5444_writer_unregister_content_provider(struct rfc5444_writer *writer, struct
     rfc5444_writer_unregister_addrtlvtype(writer, &addrtlvs[i]);
   }
   avl_remove(&cpr->creator->_provider_tree, &cpr->_provider_node);
+  rfc5444_writer_clear_message_cache(cpr->creator);
   _lazy_free_message(writer, cpr->creator);
 }
 
@@ -438,8 +442,9 @@ rfc5444_writer_unregister_message(struct rfc5444_writer *writer, struct rfc5444_
     return;
   }
 
-  /* free addresses */
+  /* free addresses and cached message images */
   _rfc5444_writer_free_addresses(writer, msg);
+  rfc5444_writer_clear_message_cache(msg);
 
   /* mark message as unregistered */
   msg->_registered = false;
@@ -555,8 +560,7 @@ rfc5444_writer_register_target(struct rfc5444_writer *writer, struct rfc5444_wri
  * @param interf pointer to interface object
  */
 void
-rfc5444_writer_unregister_target(
-  struct rfc5444_writer *writer __attribute__((unused)), struct rfc5444_writer_target *interf) {
+rfc5444_writer_unregister_target(struct rfc5444_writer *writer, struct rfc5444_writer_target *interf) {
 #if WRITER_STATE_MACHINE == true
   assert(writer->_state == RFC5444_WRITER_NONE);
 #endif
@@ -565,6 +569,45 @@ rfc5444_writer_unregister_target(
   if (list_is_node_added(&interf->_target_node)) {
     list_remove(&interf->_target_node);
   }
+
+  /* remove cached messages for this interface */
+  _rfc5444_writer_clear_target_cache(writer, interf);
+}
+
+/**
+ * Remove all cached wire images of a message. The next call to
+ * rfc5444_writer_create_message() will call the content providers again.
+ * @param msg pointer to message object
+ */
+void
+rfc5444_writer_clear_message_cache(struct rfc5444_writer_message *msg) {
+  struct rfc5444_writer_msgcache *cache, *safe_cache;
+
+  list_for_each_element_safe(&msg->_cache_head, cache, _node, safe_cache) {
+    list_remove(&cache->_node);
+    free(cache);
+  }
+}
+
+/**
+ * Remove all cached wire images of target specific messages
+ * generated for a target
+ * @param writer pointer to writer context
+ * @param target pointer to target object
+ */
+void
+_rfc5444_writer_clear_target_cache(struct rfc5444_writer *writer, struct rfc5444_writer_target *target) {
+  struct rfc5444_writer_message *msg;
+  struct rfc5444_writer_msgcache *cache, *safe_cache;
+
+  avl_for_each_element(&writer->_msgcreators, msg, _msgcreator_node) {
+    list_for_each_element_safe(&msg->_cache_head, cache, _node, safe_cache) {
+      if (cache->target == target) {
+        list_remove(&cache->_node);
+        free(cache);
+      }
+    }
+  }
 }
 
 /**
@@ -601,6 +644,7 @@ _get_message(struct rfc5444_writer *writer, uint8_t msgid) {
   avl_init(&msg->_addr_tree, avl_comp_netaddr, false);
   list_init_head(&msg->_addr_head);
   list_init_head(&msg->_non_mandatory_addr_head);
+  list_init_head(&msg->_cache_head);
   return msg;
 }
 
@@ -689,6 +733,7 @@ static void
 _lazy_free_message(struct rfc5444_writer *writer, struct rfc5444_writer_message *msg) {
   if (!msg->_registered && list_is_empty(&msg->_addr_head) && list_is_empty(&msg->_msgspecific_tlvtype_head) &&
       avl_is_empty(&msg->_provider_tree)) {
+    rfc5444_writer_clear_message_cache(msg);
     avl_remove(&writer->_msgcreators, &msg->_msgcreator_node);
     free(msg);
   }
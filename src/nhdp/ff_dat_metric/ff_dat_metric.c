@@ -52,6 +52,7 @@
 #include <oonf/libcommon/autobuf.h>
 #include <oonf/oonf.h>
 #include <oonf/libcommon/isonumber.h>
+#include <oonf/libcommon/sliding_window.h>
 #include <oonf/libcore/oonf_cfg.h>
 #include <oonf/libcore/oonf_logging.h>
 #include <oonf/libcore/oonf_subsystem.h>
@@ -95,21 +96,6 @@ struct ff_dat_if_config {
   bool registered;
 };
 
-/**
- * a single history memory cell, stores the metric
- * data for a single update interval
- */
-struct link_datff_bucket {
-  /*! number of RFC5444 packets received in time interval */
-  uint32_t received;
-
-  /*! sum of received and lost RFC5444 packets in time interval */
-  uint32_t total;
-
-  /*! link speed in bit/s */
-  int64_t raw_speed;
-};
-
 /**
  * Additional data for a nhdp_link class for metric calculation
  */
@@ -123,9 +109,6 @@ struct link_datff_data {
   /*! number of missed hellos based on timeouts since last received packet */
   uint32_t missed_hellos;
 
-  /*! current position in history ringbuffer */
-  uint16_t activePtr;
-
   /*! last received packet sequence number */
   uint16_t last_seq_nr;
 
@@ -141,8 +124,26 @@ struct link_datff_data {
   /*! estimated number of neighbors of this link */
   uint32_t link_neigborhood;
 
-  /*! history ringbuffer */
-  struct link_datff_bucket buckets[DAT_SAMPLING_COUNT];
+  /*! number of RFC5444 packets received per sampling interval */
+  struct sliding_window received;
+
+  /*! sum of received and lost RFC5444 packets per sampling interval */
+  struct sliding_window total;
+
+  /*! link speed in bit/s per sampling interval, including order statistics */
+  struct sliding_window rx_speed;
+
+  /*! storage for received packet history */
+  int64_t _received_samples[DAT_SAMPLING_COUNT];
+
+  /*! storage for total packet history */
+  int64_t _total_samples[DAT_SAMPLING_COUNT];
+
+  /*! storage for link speed history */
+  int64_t _rx_speed_samples[DAT_SAMPLING_COUNT];
+
+  /*! storage for sorted link speed history */
+  int64_t _rx_speed_sorted[DAT_SAMPLING_COUNT];
 };
 
 /* prototypes */
@@ -340,9 +341,6 @@ static struct nhdp_domain_metric _datff_handler = {
 #endif
 };
 
-/* Temporary buffer to sort incoming link speed for median calculation */
-static int _rx_sort_array[DAT_SAMPLING_COUNT] = { 0 };
-
 /* ff_dat has multiple logging targets */
 enum oonf_log_source LOG_FF_DAT;
 enum oonf_log_source LOG_FF_DAT_RAW;
@@ -459,7 +457,6 @@ static void
 _cb_link_added(void *ptr) {
   struct link_datff_data *data;
   struct nhdp_link *lnk;
-  size_t i;
 
   lnk = ptr;
   data = oonf_class_get_extension(&_link_extenstion, lnk);
@@ -467,10 +464,10 @@ _cb_link_added(void *ptr) {
   memset(data, 0, sizeof(*data));
   // data->contains_data = false;
 
-  for (i = 0; i < ARRAYSIZE(data->buckets); i++) {
-    data->buckets[i].total = 1;
-    // data->buckets[i].scaled_speed = 0;
-  }
+  sliding_window_init(&data->received, data->_received_samples, NULL, DAT_SAMPLING_COUNT);
+  sliding_window_init(&data->total, data->_total_samples, NULL, DAT_SAMPLING_COUNT);
+  sliding_window_init(&data->rx_speed, data->_rx_speed_samples, data->_rx_speed_sorted, DAT_SAMPLING_COUNT);
+  sliding_window_fill(&data->total, 1);
 
   /* initialize 'hello lost' timer for link */
   data->hello_lost_timer.class = &_hello_lost_info;
@@ -554,52 +551,23 @@ _cb_nhdpif_removed(void *ptr) {
 }
 
 /**
- * Helper for sorting datarate array
- * @param p1 pointer to integer 1
- * @param p2 pointer to integer 2
- * @return <0, 0 >0 (standard comparator output)
- */
-static int
-_int_comparator(const void *p1, const void *p2) {
-  const int *i1 = (int *)p1;
-  const int *i2 = (int *)p2;
-
-  if (*i1 > *i2) {
-    return 1;
-  }
-  else if (*i1 < *i2) {
-    return -1;
-  }
-  return 0;
-}
-
-/**
- * Get the median of all recorded link speeds by sorting
+ * Get the median of all recorded (positive) link speeds
  * @param ldata linkdata
- * @return median linkspeed
+ * @return median linkspeed, -1 if no link speed was recorded
  */
 static int
 _get_median_rx_linkspeed(struct link_datff_data *ldata) {
-  int zero_count;
+  size_t zero_count;
   size_t window;
-  size_t i;
 
-  zero_count = 0;
-  for (i = 0; i < ARRAYSIZE(ldata->buckets); i++) {
-    _rx_sort_array[i] = ldata->buckets[i].raw_speed;
-    if (_rx_sort_array[i] <= 0) {
-      zero_count++;
-    }
-  }
+  zero_count = sliding_window_count_le(&ldata->rx_speed, 0);
 
-  window = ARRAYSIZE(ldata->buckets) - zero_count;
+  window = ldata->rx_speed.size - zero_count;
   if (window == 0) {
     return -1;
   }
 
-  qsort(_rx_sort_array, ARRAYSIZE(ldata->buckets), sizeof(int), _int_comparator);
-
-  return _rx_sort_array[zero_count + window / 2];
+  return sliding_window_get_ranked(&ldata->rx_speed, zero_count + window / 2);
 }
 
 /**
@@ -915,7 +883,7 @@ _cb_dat_sampling(struct oonf_timer_instance *ptr) {
   uint64_t mic_cost, throughput_cost, dat_metric;
   uint32_t metric_value;
   uint32_t missing_intervals;
-  size_t i;
+  int64_t raw_speed;
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str nbuf;
 #endif
@@ -932,31 +900,26 @@ _cb_dat_sampling(struct oonf_timer_instance *ptr) {
       continue;
     }
 
-    /* initialize counter */
-    total = 0;
-    received = 0;
-
-    /* calculate metric */
-    for (i = 0; i < ARRAYSIZE(ldata->buckets); i++) {
-      received += ldata->buckets[i].received;
-      total += ldata->buckets[i].total;
-    }
+    /* get packet counters of sampling window (buckets are 32 bit counters) */
+    received = (uint32_t)sliding_window_get_sum(&ldata->received);
+    total = (uint32_t)sliding_window_get_sum(&ldata->total);
 
     if (ldata->missed_hellos > 0) {
       missing_intervals = (ldata->missed_hellos * ldata->hello_interval) / lnk->local_if->refresh_interval;
-      if (missing_intervals > ARRAYSIZE(ldata->buckets)) {
+      if (missing_intervals > ldata->received.size) {
         received = 0;
       }
       else {
-        received = (received * (ARRAYSIZE(ldata->buckets) - missing_intervals)) / ARRAYSIZE(ldata->buckets);
+        received = (received * (ldata->received.size - missing_intervals)) / ldata->received.size;
       }
     }
 
-    /* update link speed */
-    ldata->buckets[ldata->activePtr].raw_speed = _get_raw_rx_linkspeed(lnk);
+    /* update link speed, median is calculated on integer values */
+    raw_speed = _get_raw_rx_linkspeed(lnk);
+    sliding_window_set(&ldata->rx_speed, (int)raw_speed);
 
     OONF_DEBUG(LOG_FF_DAT, "Query incoming linkspeed for link %s: %" PRId64, netaddr_to_string(&nbuf, &lnk->if_addr),
-      ldata->buckets[ldata->activePtr].raw_speed);
+      raw_speed);
 
     /* calculate cost components of metric */
     throughput_cost = _get_throughput_cost_factor(ifconfig, lnk, ldata, received, total);
@@ -977,12 +940,11 @@ _cb_dat_sampling(struct oonf_timer_instance *ptr) {
       received, total, metric_value);
 
     /* update rolling buffer */
-    ldata->activePtr++;
-    if (ldata->activePtr >= ARRAYSIZE(ldata->buckets)) {
-      ldata->activePtr = 0;
-    }
-    ldata->buckets[ldata->activePtr].received = 0;
-    ldata->buckets[ldata->activePtr].total = 0;
+    sliding_window_advance(&ldata->received);
+    sliding_window_advance(&ldata->total);
+    sliding_window_advance(&ldata->rx_speed);
+    sliding_window_set(&ldata->received, 0);
+    sliding_window_set(&ldata->total, 0);
   }
   oonf_timer_set(&ifconfig->_sampling_timer, nhdp_if->refresh_interval);
 }
@@ -1144,9 +1106,8 @@ _cb_process_packet(struct rfc5444_reader_tlvblock_context *context) {
 
   if (!ldata->contains_data) {
     ldata->contains_data = true;
-    ldata->activePtr = 0;
-    ldata->buckets[0].received = 1;
-    ldata->buckets[0].total = 1;
+    sliding_window_set(&ldata->received, 1);
+    sliding_window_set(&ldata->total, 1);
     ldata->last_seq_nr = context->pkt_seqno;
 
     return RFC5444_OKAY;
@@ -1159,8 +1120,8 @@ _cb_process_packet(struct rfc5444_reader_tlvblock_context *context) {
     total = ((uint32_t)(context->pkt_seqno) + 65536) - (uint32_t)(ldata->last_seq_nr);
   }
 
-  ldata->buckets[ldata->activePtr].received++;
-  ldata->buckets[ldata->activePtr].total += total;
+  sliding_window_set(&ldata->received, (uint32_t)(sliding_window_get(&ldata->received) + 1));
+  sliding_window_set(&ldata->total, (uint32_t)(sliding_window_get(&ldata->total) + total));
   ldata->last_seq_nr = context->pkt_seqno;
 
   _reset_missed_hello_timer(ldata);
@@ -1240,15 +1201,12 @@ _path_to_string(struct nhdp_metric_str *buf, uint32_t metric, uint8_t hopcount)
 static const char *
 _int_link_to_string(struct nhdp_metric_str *buf, struct nhdp_link *lnk) {
   struct link_datff_data *ldata;
-  int64_t received = 0, total = 0;
-  size_t i;
+  int64_t received, total;
 
   ldata = oonf_class_get_extension(&_link_extenstion, lnk);
 
-  for (i = 0; i < ARRAYSIZE(ldata->buckets); i++) {
-    received += ldata->buckets[i].received;
-    total += ldata->buckets[i].total;
-  }
+  received = sliding_window_get_sum(&ldata->received);
+  total = sliding_window_get_sum(&ldata->total);
 
   snprintf(buf->buf, sizeof(*buf),
     "p_recv=%" PRId64 ",p_total=%" PRId64 ","
@@ -66,6 +66,8 @@
 
 #include <oonf/nhdp/mpr/neighbor-graph-flooding.h>
 #include <oonf/nhdp/mpr/neighbor-graph-routing.h>
+#include <oonf/nhdp/mpr/selection-bitset.h>
+#include <oonf/nhdp/mpr/selection-incremental.h>
 #include <oonf/nhdp/mpr/selection-rfc7181.h>
 
 /* FIXME remove unneeded includes */
@@ -122,7 +124,11 @@ _early_cfg_init(void) {
  */
 static int
 _init(void) {
+  if (mpr_incremental_init()) {
+    return -1;
+  }
   if (nhdp_domain_mpr_add(&_mpr_handler)) {
+    mpr_incremental_cleanup();
     return -1;
   }
   return 0;
@@ -132,7 +138,9 @@ _init(void) {
  * Cleanup plugin
  */
 static void
-_cleanup(void) {}
+_cleanup(void) {
+  mpr_incremental_cleanup();
+}
 
 /**
  * Updates the current routing MPR selection in the NHDP database
@@ -199,7 +207,9 @@ _cb_update_flooding_mpr(struct nhdp_domain *domain) {
       nhdp_interface_get_name(flooding_data.current_interface));
 
     mpr_calculate_neighbor_graph_flooding(domain, &flooding_data);
-    mpr_calculate_mpr_rfc7181(domain, &flooding_data.neigh_graph);
+    if (mpr_calculate_mpr_bitset(domain, &flooding_data.neigh_graph)) {
+      mpr_calculate_mpr_rfc7181(domain, &flooding_data.neigh_graph);
+    }
     mpr_print_sets(domain, &flooding_data.neigh_graph);
 #ifndef NDEBUG
     _validate_mpr_set(domain, &flooding_data.neigh_graph);
@@ -220,17 +230,26 @@ _cb_update_routing_mpr(struct nhdp_domain *domain) {
     /* we are not the routing MPR for this domain */
     return;
   }
+  if (mpr_incremental_update_routing(domain)) {
+    /* only the changed part of the two-hop neighborhood was repaired */
+    return;
+  }
+
   OONF_DEBUG(LOG_MPR, "*** Calculate routing MPRs for domain %u ***", domain->index);
 
   memset(&routing_graph, 0, sizeof(routing_graph));
   mpr_calculate_neighbor_graph_routing(domain, &routing_graph);
-  mpr_calculate_mpr_rfc7181(domain, &routing_graph);
+  if (mpr_calculate_mpr_bitset(domain, &routing_graph)) {
+    mpr_calculate_mpr_rfc7181(domain, &routing_graph);
+  }
   mpr_print_sets(domain, &routing_graph);
 #ifndef NDEBUG
   _validate_mpr_set(domain, &routing_graph);
 #endif
   _update_nhdp_routing(domain, &routing_graph);
   mpr_clear_neighbor_graph(&routing_graph);
+
+  mpr_incremental_commit_routing(domain);
 }
 
 #ifndef NDEBUG
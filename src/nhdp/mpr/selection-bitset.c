@@ -0,0 +1,331 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * RFC7181 MPR selection on a dense copy of the neighbor graph.
+ *
+ * N1 and N2 members get consecutive indices (in the order of the
+ * AVL sets), all d(x,y) values are stored in a flat array and the
+ * two-hop nodes each N1 member covers with minimal cost are stored as
+ * bitsets. R(x,M) is the popcount of this bitset masked with the set
+ * of uncovered nodes, so the selection loop does not need to query
+ * the graph callbacks again. The result is identical to
+ * mpr_calculate_mpr_rfc7181().
+ */
+
+#include <stdlib.h>
+
+#include <oonf/libcommon/avl.h>
+#include <oonf/oonf.h>
+#include <oonf/libcore/oonf_logging.h>
+
+#include <oonf/nhdp/nhdp/nhdp.h>
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+
+#include <oonf/nhdp/mpr/mpr_internal.h>
+#include <oonf/nhdp/mpr/neighbor-graph.h>
+#include <oonf/nhdp/mpr/selection-bitset.h>
+
+/**
+ * Dense representation of a neighbor graph
+ */
+struct _bitset_graph {
+  /*! number of N1 members */
+  uint32_t n1_count;
+
+  /*! number of N2 members */
+  uint32_t n2_count;
+
+  /*! number of 64 bit words of a N2 bitset */
+  uint32_t words;
+
+  /*! N1 members by index */
+  struct n1_node **n1;
+
+  /*! N2 members (y) which can be reached with minimal cost through x, n1_count * words */
+  uint64_t *min_cover;
+
+  /*! N2 members which are part of N and not covered by a selected MPR */
+  uint64_t *uncovered;
+
+  /*! true if N1 member is part of the MPR set */
+  bool *mpr;
+
+  /*! true if N1 member was selected because of its coverage */
+  bool *selected;
+};
+
+static void _free_graph(struct _bitset_graph *bg);
+
+/**
+ * @param bitset pointer to bitset
+ * @param bit index of bit
+ */
+static INLINE void
+_bit_set(uint64_t *bitset, uint32_t bit) {
+  bitset[bit >> 6] |= 1ull << (bit & 63);
+}
+
+/**
+ * Remove all bits of a second bitset from a bitset
+ * @param bitset pointer to bitset
+ * @param remove bitset to remove
+ * @param words number of 64 bit words of the bitsets
+ */
+static INLINE void
+_bit_clear_all(uint64_t *bitset, const uint64_t *remove, uint32_t words) {
+  uint32_t i;
+
+  for (i = 0; i < words; i++) {
+    bitset[i] &= ~remove[i];
+  }
+}
+
+/**
+ * Count the common bits of two bitsets
+ * @param b1 first bitset
+ * @param b2 second bitset
+ * @param words number of 64 bit words of the bitsets
+ * @return number of bits set in both bitsets
+ */
+static INLINE uint32_t
+_bit_count_common(const uint64_t *b1, const uint64_t *b2, uint32_t words) {
+  uint32_t i, count;
+
+  count = 0;
+  for (i = 0; i < words; i++) {
+    count += __builtin_popcountll(b1[i] & b2[i]);
+  }
+  return count;
+}
+
+/**
+ * Allocate the dense graph and initialize the table offsets of the
+ * d(x,y) cache of the neighbor graph
+ * @param bg dense graph
+ * @param graph neighbor graph instance
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_init_graph(struct _bitset_graph *bg, struct neighbor_graph *graph) {
+  struct n1_node *n1;
+  struct addr_node *n2;
+  uint32_t i;
+
+  memset(bg, 0, sizeof(*bg));
+  bg->n1_count = graph->set_n1.count;
+  bg->n2_count = graph->set_n2.count;
+  bg->words = (bg->n2_count + 63) / 64;
+
+  graph->d_x_y_cache = calloc((size_t)bg->n1_count * bg->n2_count + 1, sizeof(uint32_t));
+  bg->n1 = calloc(bg->n1_count + 1, sizeof(struct n1_node *));
+  bg->min_cover = calloc((size_t)bg->n1_count * bg->words + 1, sizeof(uint64_t));
+  bg->uncovered = calloc(bg->words + 1, sizeof(uint64_t));
+  bg->mpr = calloc(bg->n1_count + 1, sizeof(bool));
+  bg->selected = calloc(bg->n1_count + 1, sizeof(bool));
+  if (!graph->d_x_y_cache || !bg->n1 || !bg->min_cover || !bg->uncovered || !bg->mpr || !bg->selected) {
+    free(graph->d_x_y_cache);
+    graph->d_x_y_cache = NULL;
+    _free_graph(bg);
+    return -1;
+  }
+
+  i = 0;
+  avl_for_each_element(&graph->set_n1, n1, _avl_node) {
+    n1->table_offset = i;
+    bg->n1[i] = n1;
+    i++;
+  }
+
+  i = 0;
+  avl_for_each_element(&graph->set_n2, n2, _avl_node) {
+    n2->table_offset = i;
+    i += bg->n1_count;
+  }
+  return 0;
+}
+
+/**
+ * Free the memory of a dense graph
+ * @param bg dense graph
+ */
+static void
+_free_graph(struct _bitset_graph *bg) {
+  free(bg->n1);
+  free(bg->min_cover);
+  free(bg->uncovered);
+  free(bg->mpr);
+  free(bg->selected);
+  memset(bg, 0, sizeof(*bg));
+}
+
+/**
+ * Calculate N, the minimal cost coverage of all N1 members and
+ * select the N1 members which are the only possible MPR for a
+ * member of N.
+ * @param domain NHDP domain
+ * @param bg dense graph
+ * @param graph neighbor graph instance
+ */
+static void
+_calculate_coverage(const struct nhdp_domain *domain, struct _bitset_graph *bg, struct neighbor_graph *graph) {
+  struct addr_node *y_node;
+  uint32_t *d_x_y;
+  uint32_t d1_y, min_d_z_y, possible_mprs, possible_mpr;
+  uint32_t x, y;
+  bool in_n;
+
+  y = 0;
+  avl_for_each_element(&graph->set_n2, y_node, _avl_node) {
+    d1_y = graph->methods->calculate_d1_x_of_n2_addr(domain, graph, y_node);
+    d_x_y = &graph->d_x_y_cache[y_node->table_offset];
+
+    /* y is part of N if it cannot be reached directly or a two-hop path is cheaper */
+    in_n = d1_y == RFC7181_METRIC_INFINITE;
+    min_d_z_y = RFC7181_METRIC_INFINITE_PATH;
+    for (x = 0; x < bg->n1_count; x++) {
+      d_x_y[x] = graph->methods->calculate_d_x_y(domain, graph, bg->n1[x], y_node);
+      if (d_x_y[x] < d1_y) {
+        in_n = true;
+      }
+      if (d_x_y[x] < min_d_z_y) {
+        min_d_z_y = d_x_y[x];
+      }
+    }
+
+    if (in_n) {
+      _bit_set(bg->uncovered, y);
+
+      possible_mprs = 0;
+      possible_mpr = 0;
+      for (x = 0; x < bg->n1_count; x++) {
+        if (d_x_y[x] == min_d_z_y) {
+          _bit_set(&bg->min_cover[x * bg->words], y);
+        }
+        if (graph->methods->calculate_d2_x_y(domain, bg->n1[x], y_node) <= RFC7181_METRIC_MAX) {
+          possible_mprs++;
+          possible_mpr = x;
+        }
+      }
+
+      OONF_ASSERT(possible_mprs > 0, LOG_MPR, "There should be at least one possible MPR");
+      if (possible_mprs == 1) {
+        /* only one possible MPR to cover this 2-hop neighbor */
+        bg->mpr[possible_mpr] = true;
+        bg->selected[possible_mpr] = true;
+      }
+    }
+    y++;
+  }
+}
+
+/**
+ * Calculate MPR set with a dense bitset representation of the graph
+ * @param domain NHDP domain
+ * @param graph neighbor graph instance
+ * @return -1 if an error happened (out of memory), 0 otherwise
+ */
+int
+mpr_calculate_mpr_bitset(const struct nhdp_domain *domain, struct neighbor_graph *graph) {
+  struct _bitset_graph bg;
+  struct n1_node *n1;
+  uint32_t x, best, r, best_r;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct netaddr_str buf1;
+#endif
+
+  OONF_DEBUG(LOG_MPR, "Calculate MPR set (bitset)");
+
+  if (_init_graph(&bg, graph)) {
+    OONF_WARN(LOG_MPR, "Not enough memory for bitset MPR calculation");
+    return -1;
+  }
+
+  _calculate_coverage(domain, &bg, graph);
+
+  for (x = 0; x < bg.n1_count; x++) {
+    if (graph->methods->get_willingness_n1(domain, bg.n1[x]) == RFC7181_WILLINGNESS_ALWAYS) {
+      bg.mpr[x] = true;
+    }
+    if (bg.selected[x]) {
+      _bit_clear_all(bg.uncovered, &bg.min_cover[x * bg.words], bg.words);
+    }
+  }
+
+  /* greedy selection by R(x,M), first node wins a tie */
+  while (true) {
+    best = 0;
+    best_r = 0;
+    for (x = 0; x < bg.n1_count; x++) {
+      if (bg.selected[x]) {
+        continue;
+      }
+      r = _bit_count_common(&bg.min_cover[x * bg.words], bg.uncovered, bg.words);
+      if (r > best_r) {
+        best_r = r;
+        best = x;
+      }
+    }
+
+    if (best_r == 0) {
+      break;
+    }
+
+    OONF_DEBUG(LOG_MPR, "Select %s, R(x,M) = %u", netaddr_to_string(&buf1, &bg.n1[best]->addr), best_r);
+    bg.mpr[best] = true;
+    bg.selected[best] = true;
+    _bit_clear_all(bg.uncovered, &bg.min_cover[best * bg.words], bg.words);
+  }
+
+  for (x = 0; x < bg.n1_count; x++) {
+    n1 = bg.n1[x];
+    n1->neigh->selection_is_mpr = bg.selected[x];
+    if (bg.mpr[x]) {
+      mpr_add_n1_node_to_set(&graph->set_mpr, n1->neigh, n1->link, n1->table_offset);
+    }
+  }
+
+  _free_graph(&bg);
+  return 0;
+}
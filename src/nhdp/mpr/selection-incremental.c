@@ -0,0 +1,956 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Persistent routing MPR state that allows repairing the MPR set
+ * for the part of the two-hop neighborhood that changed instead of
+ * running the full RFC7181 selection on every trigger.
+ *
+ * The N1 and N2 sets are maintained from NHDP neighbor, link, neighbor
+ * address and two-hop events. Changed neighbors are collected in a
+ * per-domain list, two-hop addresses whose cost might have changed in
+ * a second one. Only these parts of the neighborhood are checked for
+ * the MPR coverage property d(y,M) = d(y,N1) of RFC7181 section 18.3,
+ * missing MPRs are added and MPRs that are not necessary anymore
+ * (the optional optimization of RFC7181 section 18.4) are removed.
+ */
+
+#include <stdlib.h>
+
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/avl_comp.h>
+#include <oonf/libcommon/list.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/oonf.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/base/oonf_class.h>
+
+#include <oonf/nhdp/nhdp/nhdp.h>
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+
+#include <oonf/nhdp/mpr/mpr.h>
+#include <oonf/nhdp/mpr/mpr_internal.h>
+#include <oonf/nhdp/mpr/selection-incremental.h>
+
+/**
+ * Two-hop address of the persistent N2 set
+ */
+struct _incremental_n2 {
+  /*! two-hop address */
+  struct netaddr addr;
+
+  /*! list of two-hop tuples (_incremental_l2hop) pointing to this address */
+  struct list_entity l2hops;
+
+  /*! d1(y) of this address during the last update */
+  uint32_t d1[NHDP_MAXIMUM_DOMAINS];
+
+  /*! member of the list of changed two-hop addresses of a domain */
+  struct list_entity _affected_node[NHDP_MAXIMUM_DOMAINS];
+
+  /*! member of the global N2 tree */
+  struct avl_node _node;
+};
+
+/**
+ * MPR data of a neighbor for one domain
+ */
+struct _incremental_n1 {
+  /*! back pointer to NHDP neighbor */
+  struct nhdp_neighbor *neigh;
+
+  /*! d1(x) during the last update */
+  uint32_t d1;
+
+  /*! willingness during the last update */
+  uint8_t willingness;
+
+  /*! true if neighbor was part of N1 during the last update */
+  bool in_n1;
+
+  /*! true if neighbor is part of the MPR set */
+  bool mpr;
+
+  /*! member of the list of changed neighbors of a domain */
+  struct list_entity _dirty_node;
+};
+
+/**
+ * Extension of the NHDP neighbor
+ */
+struct _incremental_neighbor {
+  /*! per domain MPR data */
+  struct _incremental_n1 domain[NHDP_MAXIMUM_DOMAINS];
+
+  /*! true if the neighbor is in the process of being removed */
+  bool removed;
+};
+
+/**
+ * Extension of the NHDP two-hop tuple
+ */
+struct _incremental_l2hop {
+  /*! back pointer to NHDP two-hop tuple */
+  struct nhdp_l2hop *l2hop;
+
+  /*! N2 node of the two-hop address */
+  struct _incremental_n2 *n2;
+
+  /*! member of the two-hop tuple list of the N2 node */
+  struct list_entity _n2_node;
+};
+
+/**
+ * Incremental state of a NHDP domain
+ */
+struct _incremental_domain {
+  /*! list of two-hop addresses whose coverage must be checked */
+  struct list_entity affected;
+
+  /*! number of elements in the affected list */
+  uint32_t affected_count;
+
+  /*! list of neighbors (_incremental_n1) whose state must be checked */
+  struct list_entity dirty;
+
+  /*! number of repairs since the last full MPR calculation */
+  uint32_t repairs;
+
+  /*! true if the next update must run the full MPR calculation */
+  bool full_rebuild;
+};
+
+static void _cb_neighbor_added(void *);
+static void _cb_neighbor_changed(void *);
+static void _cb_neighbor_removed(void *);
+static void _cb_link_changed(void *);
+static void _cb_naddr_changed(void *);
+static void _cb_l2hop_added(void *);
+static void _cb_l2hop_changed(void *);
+static void _cb_l2hop_removed(void *);
+
+static struct oonf_class_extension _neighbor_extension = {
+  .ext_name = OONF_MPR_SUBSYSTEM,
+  .class_name = NHDP_CLASS_NEIGHBOR,
+  .size = sizeof(struct _incremental_neighbor),
+  .cb_add = _cb_neighbor_added,
+  .cb_change = _cb_neighbor_changed,
+  .cb_remove = _cb_neighbor_removed,
+};
+
+static struct oonf_class_extension _link_extension = {
+  .ext_name = OONF_MPR_SUBSYSTEM,
+  .class_name = NHDP_CLASS_LINK,
+  .cb_add = _cb_link_changed,
+  .cb_change = _cb_link_changed,
+  .cb_remove = _cb_link_changed,
+};
+
+static struct oonf_class_extension _naddr_extension = {
+  .ext_name = OONF_MPR_SUBSYSTEM,
+  .class_name = NHDP_CLASS_NEIGHBOR_ADDRESS,
+  .cb_add = _cb_naddr_changed,
+  .cb_change = _cb_naddr_changed,
+  .cb_remove = _cb_naddr_changed,
+};
+
+static struct oonf_class_extension _l2hop_extension = {
+  .ext_name = OONF_MPR_SUBSYSTEM,
+  .class_name = NHDP_CLASS_LINK_2HOP,
+  .size = sizeof(struct _incremental_l2hop),
+  .cb_add = _cb_l2hop_added,
+  .cb_change = _cb_l2hop_changed,
+  .cb_remove = _cb_l2hop_removed,
+};
+
+/* persistent N2 set */
+static struct avl_tree _n2_tree;
+
+/* per domain state */
+static struct _incremental_domain _domains[NHDP_MAXIMUM_DOMAINS];
+
+/**
+ * Initialize incremental MPR state
+ * @return -1 if an error happened, 0 otherwise
+ */
+int
+mpr_incremental_init(void) {
+  size_t i;
+
+  if (oonf_class_extension_add(&_neighbor_extension)) {
+    return -1;
+  }
+  if (oonf_class_extension_add(&_l2hop_extension)) {
+    oonf_class_extension_remove(&_neighbor_extension);
+    return -1;
+  }
+  if (oonf_class_extension_add(&_link_extension)) {
+    oonf_class_extension_remove(&_l2hop_extension);
+    oonf_class_extension_remove(&_neighbor_extension);
+    return -1;
+  }
+  if (oonf_class_extension_add(&_naddr_extension)) {
+    oonf_class_extension_remove(&_link_extension);
+    oonf_class_extension_remove(&_l2hop_extension);
+    oonf_class_extension_remove(&_neighbor_extension);
+    return -1;
+  }
+
+  avl_init(&_n2_tree, avl_comp_netaddr, false);
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    list_init_head(&_domains[i].affected);
+    list_init_head(&_domains[i].dirty);
+    _domains[i].affected_count = 0;
+    _domains[i].repairs = 0;
+    _domains[i].full_rebuild = true;
+  }
+  return 0;
+}
+
+/**
+ * Cleanup incremental MPR state
+ */
+void
+mpr_incremental_cleanup(void) {
+  struct _incremental_n2 *n2, *n2_it;
+  struct _incremental_l2hop *l2ext, *l2_it;
+  struct _incremental_n1 *n1, *n1_it;
+  size_t i;
+
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    list_for_each_element_safe(&_domains[i].dirty, n1, _dirty_node, n1_it) {
+      list_remove(&n1->_dirty_node);
+    }
+  }
+
+  avl_for_each_element_safe(&_n2_tree, n2, _node, n2_it) {
+    list_for_each_element_safe(&n2->l2hops, l2ext, _n2_node, l2_it) {
+      list_remove(&l2ext->_n2_node);
+      l2ext->n2 = NULL;
+    }
+    avl_remove(&_n2_tree, &n2->_node);
+    free(n2);
+  }
+
+  oonf_class_extension_remove(&_naddr_extension);
+  oonf_class_extension_remove(&_link_extension);
+  oonf_class_extension_remove(&_l2hop_extension);
+  oonf_class_extension_remove(&_neighbor_extension);
+}
+
+/**
+ * Add a two-hop address to the list of addresses to be checked
+ * @param n2 N2 node
+ * @param idx domain index
+ */
+static void
+_mark_affected(struct _incremental_n2 *n2, size_t idx) {
+  if (!list_is_node_added(&n2->_affected_node[idx])) {
+    list_add_tail(&_domains[idx].affected, &n2->_affected_node[idx]);
+    _domains[idx].affected_count++;
+  }
+}
+
+/**
+ * Add a two-hop address to the list of addresses to be checked
+ * of all domains
+ * @param n2 N2 node
+ */
+static void
+_mark_affected_all(struct _incremental_n2 *n2) {
+  size_t i;
+
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    _mark_affected(n2, i);
+  }
+}
+
+/**
+ * Remove a two-hop address from the list of addresses to be checked
+ * @param n2 N2 node
+ * @param idx domain index
+ */
+static void
+_unmark_affected(struct _incremental_n2 *n2, size_t idx) {
+  if (list_is_node_added(&n2->_affected_node[idx])) {
+    list_remove(&n2->_affected_node[idx]);
+    _domains[idx].affected_count--;
+  }
+}
+
+/**
+ * Add a neighbor to the list of neighbors to be checked
+ * @param neigh NHDP neighbor
+ * @param idx domain index
+ */
+static void
+_mark_dirty(struct nhdp_neighbor *neigh, size_t idx) {
+  struct _incremental_neighbor *next;
+
+  next = oonf_class_get_extension(&_neighbor_extension, neigh);
+  if (!next->removed && !list_is_node_added(&next->domain[idx]._dirty_node)) {
+    list_add_tail(&_domains[idx].dirty, &next->domain[idx]._dirty_node);
+  }
+}
+
+/**
+ * Add a neighbor to the list of neighbors to be checked of all domains
+ * @param neigh NHDP neighbor
+ */
+static void
+_mark_dirty_all(struct nhdp_neighbor *neigh) {
+  size_t i;
+
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    _mark_dirty(neigh, i);
+  }
+}
+
+/**
+ * Calculate d1(y) for a two-hop address
+ * @param idx domain index
+ * @param addr two-hop address
+ * @return metric distance, RFC7181_METRIC_INFINITE if y is no N1 address
+ */
+static uint32_t
+_get_d1_of_y(size_t idx, const struct netaddr *addr) {
+  struct _incremental_neighbor *next;
+  struct nhdp_naddr *naddr;
+
+  naddr = nhdp_db_neighbor_addr_get(addr);
+  if (!naddr) {
+    return RFC7181_METRIC_INFINITE;
+  }
+
+  next = oonf_class_get_extension(&_neighbor_extension, naddr->neigh);
+  if (!next->domain[idx].in_n1) {
+    return RFC7181_METRIC_INFINITE;
+  }
+  return next->domain[idx].d1;
+}
+
+/**
+ * Calculate d2(x,y) for a two-hop tuple
+ * @param domain NHDP domain
+ * @param l2hop NHDP two-hop tuple
+ * @return metric distance, RFC7181_METRIC_INFINITE if tuple is not usable
+ */
+static uint32_t
+_get_d2_x_y(const struct nhdp_domain *domain, struct nhdp_l2hop *l2hop) {
+  struct nhdp_l2hop_domaindata *l2hopdata;
+
+  l2hopdata = nhdp_domain_get_l2hopdata(domain, l2hop);
+  return l2hopdata->metric.in <= RFC7181_METRIC_MAX ? l2hopdata->metric.in : RFC7181_METRIC_INFINITE;
+}
+
+/**
+ * Mark all two-hop addresses whose cost depends on a neighbor
+ * @param neigh NHDP neighbor
+ * @param idx domain index
+ */
+static void
+_mark_affected_by_neighbor(struct nhdp_neighbor *neigh, size_t idx) {
+  struct _incremental_l2hop *l2ext;
+  struct _incremental_n2 *n2;
+  struct nhdp_l2hop *l2hop;
+  struct nhdp_naddr *naddr;
+  struct nhdp_link *lnk;
+
+  list_for_each_element(&neigh->_links, lnk, _neigh_node) {
+    avl_for_each_element(&lnk->_2hop, l2hop, _link_node) {
+      l2ext = oonf_class_get_extension(&_l2hop_extension, l2hop);
+      if (l2ext->n2) {
+        _mark_affected(l2ext->n2, idx);
+      }
+    }
+  }
+
+  /* d1(y) of the neighbors own addresses */
+  avl_for_each_element(&neigh->_neigh_addresses, naddr, _neigh_node) {
+    n2 = avl_find_element(&_n2_tree, &naddr->neigh_addr, n2, _node);
+    if (n2) {
+      _mark_affected(n2, idx);
+    }
+  }
+}
+
+/**
+ * Mark all neighbors that share a two-hop address with a neighbor
+ * as candidates for removal from the MPR set
+ * @param neigh NHDP neighbor
+ * @param idx domain index
+ */
+static void
+_mark_dirty_by_neighbor(struct nhdp_neighbor *neigh, size_t idx) {
+  struct _incremental_l2hop *l2ext, *other;
+  struct nhdp_l2hop *l2hop;
+  struct nhdp_link *lnk;
+
+  list_for_each_element(&neigh->_links, lnk, _neigh_node) {
+    avl_for_each_element(&lnk->_2hop, l2hop, _link_node) {
+      l2ext = oonf_class_get_extension(&_l2hop_extension, l2hop);
+      if (!l2ext->n2) {
+        continue;
+      }
+      list_for_each_element(&l2ext->n2->l2hops, other, _n2_node) {
+        _mark_dirty(other->l2hop->link->neigh, idx);
+      }
+    }
+  }
+}
+
+/**
+ * Update the N1 data of a neighbor from the NHDP database
+ * @param domain NHDP domain
+ * @param neigh NHDP neighbor
+ * @return true if the neighbor joined or left N1 or d1(x) changed
+ */
+static bool
+_update_n1(const struct nhdp_domain *domain, struct nhdp_neighbor *neigh) {
+  struct nhdp_neighbor_domaindata *neighdata;
+  struct _incremental_neighbor *next;
+  struct _incremental_n1 *n1;
+  uint32_t d1;
+  bool allowed, changed;
+
+  neighdata = nhdp_domain_get_neighbordata(domain, neigh);
+  next = oonf_class_get_extension(&_neighbor_extension, neigh);
+  n1 = &next->domain[domain->index];
+
+  /* neighbor tuple must be "allowed" according to section 18.4 */
+  allowed = neighdata->metric.in <= RFC7181_METRIC_MAX && neigh->symmetric > 0 &&
+            neighdata->willingness > RFC7181_WILLINGNESS_NEVER;
+  d1 = allowed ? neighdata->metric.in : RFC7181_METRIC_INFINITE;
+
+  changed = allowed != n1->in_n1 || d1 != n1->d1;
+  n1->in_n1 = allowed;
+  n1->d1 = d1;
+  n1->willingness = allowed ? neighdata->willingness : RFC7181_WILLINGNESS_NEVER;
+
+  if (!allowed) {
+    n1->mpr = false;
+  }
+  else if (n1->willingness == RFC7181_WILLINGNESS_ALWAYS) {
+    /* first property of section 18.3 */
+    n1->mpr = true;
+  }
+  return changed;
+}
+
+/**
+ * Update the N1 data of all changed neighbors and mark all two-hop
+ * addresses whose cost changed.
+ * @param domain NHDP domain
+ */
+static void
+_collect_changes(const struct nhdp_domain *domain) {
+  struct _incremental_n2 *n2;
+  struct _incremental_n1 *n1;
+  size_t idx;
+
+  idx = domain->index;
+
+  list_for_each_element(&_domains[idx].dirty, n1, _dirty_node) {
+    if (_update_n1(domain, n1->neigh)) {
+      _mark_affected_by_neighbor(n1->neigh, idx);
+    }
+  }
+
+  /* one-hop cost of two-hop addresses might have changed */
+  list_for_each_element(&_domains[idx].affected, n2, _affected_node[idx]) {
+    n2->d1[idx] = _get_d1_of_y(idx, &n2->addr);
+  }
+}
+
+/**
+ * Calculate d(y,N1) and d(y,M) for a two-hop address
+ * @param domain NHDP domain
+ * @param n2 two-hop address
+ * @param exclude neighbor that should not be considered part of M,
+ *   NULL to use the whole MPR set
+ * @param d_y_n1 pointer to d(y,N1) result
+ * @param d_y_mpr pointer to d(y,M) result
+ * @return neighbor with minimal d(x,y) and the highest willingness,
+ *   NULL if y cannot be reached through a two-hop path
+ */
+static struct nhdp_neighbor *
+_calculate_coverage(const struct nhdp_domain *domain, struct _incremental_n2 *n2, struct nhdp_neighbor *exclude,
+  uint32_t *d_y_n1, uint32_t *d_y_mpr) {
+  struct _incremental_neighbor *next;
+  struct _incremental_l2hop *l2ext;
+  struct _incremental_n1 *n1, *best;
+  struct nhdp_neighbor *neigh, *best_neigh;
+  uint32_t cost, d2;
+  size_t idx;
+
+  idx = domain->index;
+
+  /* two-hop paths can be longer than RFC7181_METRIC_INFINITE */
+  *d_y_n1 = n2->d1[idx] <= RFC7181_METRIC_MAX ? n2->d1[idx] : RFC7181_METRIC_INFINITE_PATH;
+  *d_y_mpr = *d_y_n1;
+  best = NULL;
+  best_neigh = NULL;
+
+  list_for_each_element(&n2->l2hops, l2ext, _n2_node) {
+    neigh = l2ext->l2hop->link->neigh;
+    next = oonf_class_get_extension(&_neighbor_extension, neigh);
+    n1 = &next->domain[idx];
+    d2 = _get_d2_x_y(domain, l2ext->l2hop);
+    if (!n1->in_n1 || d2 > RFC7181_METRIC_MAX) {
+      continue;
+    }
+
+    cost = n1->d1 + d2;
+    if (n1->mpr && neigh != exclude && cost < *d_y_mpr) {
+      *d_y_mpr = cost;
+    }
+    if (cost < *d_y_n1 || (cost == *d_y_n1 && best != NULL && n1->willingness > best->willingness)) {
+      *d_y_n1 = cost;
+      best = n1;
+      best_neigh = neigh;
+    }
+  }
+  return best_neigh;
+}
+
+/**
+ * Check the coverage of a two-hop address and add a neighbor to the
+ * MPR set if d(y,M) is larger than d(y,N1).
+ * @param domain NHDP domain
+ * @param n2 two-hop address
+ * @return true if a new MPR was selected
+ */
+static bool
+_repair_coverage(const struct nhdp_domain *domain, struct _incremental_n2 *n2) {
+  struct _incremental_neighbor *next;
+  struct nhdp_neighbor *best;
+  uint32_t d_y_n1, d_y_mpr;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct netaddr_str nbuf1, nbuf2;
+#endif
+
+  best = _calculate_coverage(domain, n2, NULL, &d_y_n1, &d_y_mpr);
+  if (d_y_mpr <= d_y_n1 || best == NULL) {
+    return false;
+  }
+
+  OONF_DEBUG(LOG_MPR, "Add %s to MPR set to cover %s (cost %u)", netaddr_to_string(&nbuf1, &best->originator),
+    netaddr_to_string(&nbuf2, &n2->addr), d_y_n1);
+
+  next = oonf_class_get_extension(&_neighbor_extension, best);
+  next->domain[domain->index].mpr = true;
+
+  /* the new MPR might make other MPRs unnecessary */
+  _mark_dirty_by_neighbor(best, domain->index);
+  return true;
+}
+
+/**
+ * Check if a MPR can be removed without violating the coverage
+ * of any of its two-hop addresses.
+ * @param domain NHDP domain
+ * @param neigh NHDP neighbor
+ * @return true if the neighbor is not necessary in the MPR set
+ */
+static bool
+_is_redundant(const struct nhdp_domain *domain, struct nhdp_neighbor *neigh) {
+  struct _incremental_l2hop *l2ext;
+  struct nhdp_l2hop *l2hop;
+  struct nhdp_link *lnk;
+  uint32_t d_y_n1, d_y_mpr;
+
+  list_for_each_element(&neigh->_links, lnk, _neigh_node) {
+    avl_for_each_element(&lnk->_2hop, l2hop, _link_node) {
+      l2ext = oonf_class_get_extension(&_l2hop_extension, l2hop);
+      if (!l2ext->n2) {
+        continue;
+      }
+
+      _calculate_coverage(domain, l2ext->n2, neigh, &d_y_n1, &d_y_mpr);
+      if (d_y_mpr > d_y_n1) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Remove all MPRs of the list of changed neighbors that are not
+ * necessary anymore (optional optimization of section 18.4)
+ * and clear the list.
+ * @param domain NHDP domain
+ * @return number of removed MPRs
+ */
+static uint32_t
+_remove_redundant_mprs(const struct nhdp_domain *domain) {
+  struct _incremental_n1 *n1, *n1_it;
+  uint32_t removed;
+  size_t idx;
+#ifdef OONF_LOG_DEBUG_INFO
+  struct netaddr_str nbuf;
+#endif
+
+  idx = domain->index;
+  removed = 0;
+
+  list_for_each_element_safe(&_domains[idx].dirty, n1, _dirty_node, n1_it) {
+    list_remove(&n1->_dirty_node);
+
+    if (n1->mpr && n1->willingness != RFC7181_WILLINGNESS_ALWAYS && _is_redundant(domain, n1->neigh)) {
+      OONF_DEBUG(LOG_MPR, "Remove %s from MPR set", netaddr_to_string(&nbuf, &n1->neigh->originator));
+      n1->mpr = false;
+      removed++;
+    }
+  }
+  return removed;
+}
+
+/**
+ * Copy the MPR set of the incremental state into the NHDP database
+ * @param domain NHDP domain
+ */
+static void
+_update_nhdp_routing(struct nhdp_domain *domain) {
+  struct nhdp_neighbor_domaindata *neighdata;
+  struct _incremental_neighbor *next;
+  struct nhdp_neighbor *neigh;
+  size_t idx;
+
+  idx = domain->index;
+  list_for_each_element(nhdp_db_get_neigh_list(), neigh, _global_node) {
+    neighdata = nhdp_domain_get_neighbordata(domain, neigh);
+    next = oonf_class_get_extension(&_neighbor_extension, neigh);
+
+    neighdata->neigh_is_mpr = next->domain[idx].in_n1 && next->domain[idx].mpr;
+  }
+}
+
+/**
+ * Update the routing MPR set of a domain by repairing the coverage
+ * of all two-hop addresses whose cost changed since the last update.
+ * @param domain NHDP domain
+ * @return true if the MPR set was updated, false if the full
+ *   MPR calculation has to be run
+ */
+bool
+mpr_incremental_update_routing(struct nhdp_domain *domain) {
+  struct _incremental_domain *state;
+  struct _incremental_l2hop *l2ext;
+  struct _incremental_n2 *n2, *n2_it;
+  uint32_t added, removed;
+  size_t idx;
+
+  idx = domain->index;
+  state = &_domains[idx];
+
+  _collect_changes(domain);
+
+  if (state->full_rebuild || state->repairs >= MPR_INCREMENTAL_MAX_REPAIRS ||
+      state->affected_count * MPR_INCREMENTAL_AFFECTED_FRACTION > _n2_tree.count) {
+    OONF_DEBUG(LOG_MPR, "Full MPR calculation for domain %u (%u of %u two-hop addresses changed, %u repairs)",
+      domain->index, state->affected_count, _n2_tree.count, state->repairs);
+    return false;
+  }
+
+  added = 0;
+  list_for_each_element_safe(&state->affected, n2, _affected_node[idx], n2_it) {
+    if (_repair_coverage(domain, n2)) {
+      added++;
+    }
+
+    /* MPRs of a changed two-hop address might not be necessary anymore */
+    list_for_each_element(&n2->l2hops, l2ext, _n2_node) {
+      _mark_dirty(l2ext->l2hop->link->neigh, idx);
+    }
+    _unmark_affected(n2, idx);
+  }
+
+  removed = _remove_redundant_mprs(domain);
+
+  if (added || removed) {
+    state->repairs++;
+  }
+  OONF_DEBUG(LOG_MPR, "Incremental MPR update for domain %u added %u and removed %u MPRs", domain->index, added,
+    removed);
+
+  _update_nhdp_routing(domain);
+  return true;
+}
+
+/**
+ * Attach a two-hop tuple to the N2 node of its address
+ * @param l2hop NHDP two-hop tuple
+ * @return N2 node, NULL if out of memory
+ */
+static struct _incremental_n2 *
+_attach_l2hop(struct nhdp_l2hop *l2hop) {
+  struct _incremental_l2hop *l2ext;
+  struct _incremental_n2 *n2;
+  size_t i;
+
+  l2ext = oonf_class_get_extension(&_l2hop_extension, l2hop);
+  l2ext->l2hop = l2hop;
+
+  n2 = avl_find_element(&_n2_tree, &l2hop->twohop_addr, n2, _node);
+  if (!n2) {
+    n2 = calloc(1, sizeof(*n2));
+    if (!n2) {
+      OONF_WARN(LOG_MPR, "No memory left for two-hop address");
+      for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+        _domains[i].full_rebuild = true;
+      }
+      return NULL;
+    }
+    memcpy(&n2->addr, &l2hop->twohop_addr, sizeof(n2->addr));
+    list_init_head(&n2->l2hops);
+    for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+      n2->d1[i] = RFC7181_METRIC_INFINITE;
+    }
+    n2->_node.key = &n2->addr;
+    avl_insert(&_n2_tree, &n2->_node);
+  }
+
+  l2ext->n2 = n2;
+  list_add_tail(&n2->l2hops, &l2ext->_n2_node);
+  return n2;
+}
+
+/**
+ * Store the result of a full routing MPR calculation in the
+ * incremental state.
+ * @param domain NHDP domain
+ */
+void
+mpr_incremental_commit_routing(struct nhdp_domain *domain) {
+  struct nhdp_neighbor_domaindata *neighdata;
+  struct _incremental_neighbor *next;
+  struct _incremental_l2hop *l2ext;
+  struct _incremental_domain *state;
+  struct _incremental_n2 *n2, *n2_it;
+  struct nhdp_neighbor *neigh;
+  struct nhdp_l2hop *l2hop;
+  struct nhdp_link *lnk;
+  size_t idx;
+
+  idx = domain->index;
+  state = &_domains[idx];
+  state->repairs = 0;
+  state->full_rebuild = false;
+
+  /* resynchronize the whole neighborhood with the NHDP database */
+  list_for_each_element(nhdp_db_get_neigh_list(), neigh, _global_node) {
+    neighdata = nhdp_domain_get_neighbordata(domain, neigh);
+    next = oonf_class_get_extension(&_neighbor_extension, neigh);
+
+    next->domain[idx].mpr = neighdata->neigh_is_mpr;
+    _update_n1(domain, neigh);
+    _mark_dirty(neigh, idx);
+
+    list_for_each_element(&neigh->_links, lnk, _neigh_node) {
+      avl_for_each_element(&lnk->_2hop, l2hop, _link_node) {
+        l2ext = oonf_class_get_extension(&_l2hop_extension, l2hop);
+        if (!l2ext->n2 && _attach_l2hop(l2hop) == NULL) {
+          /* try again during the next update */
+          state->full_rebuild = true;
+        }
+      }
+    }
+  }
+
+  list_for_each_element_safe(&state->affected, n2, _affected_node[idx], n2_it) {
+    _unmark_affected(n2, idx);
+  }
+
+  /*
+   * the full calculation uses the first link of a neighbor to a two-hop
+   * address, make sure the coverage also holds for the best link
+   */
+  avl_for_each_element(&_n2_tree, n2, _node) {
+    n2->d1[idx] = _get_d1_of_y(idx, &n2->addr);
+  }
+  avl_for_each_element(&_n2_tree, n2, _node) {
+    _repair_coverage(domain, n2);
+  }
+
+  /* the full calculation does not remove unnecessary MPRs */
+  _remove_redundant_mprs(domain);
+
+  _update_nhdp_routing(domain);
+}
+
+/**
+ * Callback for new NHDP neighbors
+ * @param ptr NHDP neighbor
+ */
+static void
+_cb_neighbor_added(void *ptr) {
+  struct _incremental_neighbor *next;
+  size_t i;
+
+  next = oonf_class_get_extension(&_neighbor_extension, ptr);
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    next->domain[i].neigh = ptr;
+    next->domain[i].d1 = RFC7181_METRIC_INFINITE;
+    next->domain[i].willingness = RFC7181_WILLINGNESS_NEVER;
+  }
+  _mark_dirty_all(ptr);
+}
+
+/**
+ * Callback for changed NHDP neighbors (metric, willingness or
+ * symmetric status)
+ * @param ptr NHDP neighbor
+ */
+static void
+_cb_neighbor_changed(void *ptr) {
+  _mark_dirty_all(ptr);
+}
+
+/**
+ * Callback for removed NHDP neighbors. The two-hop addresses depending
+ * on the neighbor are marked by the events of its links and addresses.
+ * @param ptr NHDP neighbor
+ */
+static void
+_cb_neighbor_removed(void *ptr) {
+  struct _incremental_neighbor *next;
+  size_t i;
+
+  next = oonf_class_get_extension(&_neighbor_extension, ptr);
+  for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+    if (list_is_node_added(&next->domain[i]._dirty_node)) {
+      list_remove(&next->domain[i]._dirty_node);
+    }
+  }
+  next->removed = true;
+}
+
+/**
+ * Callback for added, changed and removed NHDP links, which might
+ * change the symmetric status of the neighbor
+ * @param ptr NHDP link
+ */
+static void
+_cb_link_changed(void *ptr) {
+  struct nhdp_link *lnk = ptr;
+
+  _mark_dirty_all(lnk->neigh);
+}
+
+/**
+ * Callback for added, moved and removed NHDP neighbor addresses,
+ * which change d1(y) of the two-hop address
+ * @param ptr NHDP neighbor address
+ */
+static void
+_cb_naddr_changed(void *ptr) {
+  struct nhdp_naddr *naddr = ptr;
+  struct _incremental_n2 *n2;
+
+  n2 = avl_find_element(&_n2_tree, &naddr->neigh_addr, n2, _node);
+  if (n2) {
+    _mark_affected_all(n2);
+  }
+}
+
+/**
+ * Callback for new NHDP two-hop tuples
+ * @param ptr NHDP two-hop tuple
+ */
+static void
+_cb_l2hop_added(void *ptr) {
+  struct _incremental_n2 *n2;
+
+  n2 = _attach_l2hop(ptr);
+  if (n2) {
+    _mark_affected_all(n2);
+  }
+}
+
+/**
+ * Callback for changed metrics of NHDP two-hop tuples
+ * @param ptr NHDP two-hop tuple
+ */
+static void
+_cb_l2hop_changed(void *ptr) {
+  struct _incremental_l2hop *l2ext;
+
+  l2ext = oonf_class_get_extension(&_l2hop_extension, ptr);
+  if (l2ext->n2) {
+    _mark_affected_all(l2ext->n2);
+  }
+}
+
+/**
+ * Callback for removed NHDP two-hop tuples
+ * @param ptr NHDP two-hop tuple
+ */
+static void
+_cb_l2hop_removed(void *ptr) {
+  struct _incremental_l2hop *l2ext;
+  struct _incremental_n2 *n2;
+  size_t i;
+
+  l2ext = oonf_class_get_extension(&_l2hop_extension, ptr);
+  n2 = l2ext->n2;
+  if (!n2) {
+    return;
+  }
+
+  list_remove(&l2ext->_n2_node);
+  l2ext->n2 = NULL;
+
+  if (list_is_empty(&n2->l2hops)) {
+    for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
+      _unmark_affected(n2, i);
+    }
+    avl_remove(&_n2_tree, &n2->_node);
+    free(n2);
+  }
+  else {
+    /* path might have been covered by the removed tuple */
+    _mark_affected_all(n2);
+  }
+}
@@ -92,6 +92,9 @@ static void _cleanup(void);
 
 static bool _forwarding_selector(struct rfc5444_writer_target *rfc5444_target);
 
+static void _cb_content_changed(void *ptr);
+static void _cb_domain_content_changed(struct nhdp_domain *domain);
+
 static void _cb_cfg_domain_changed(void);
 static void _cb_cfg_interface_changed(void);
 static void _cb_cfg_nhdp_changed(void);
@@ -186,6 +189,67 @@ static struct oonf_rfc5444_protocol *_protocol;
 /* NHDP originator address, might be undefined */
 static struct netaddr _originator_v4, _originator_v6;
 
+/* generation counter of the NHDP data advertised in HELLO and TC messages */
+static uint32_t _content_generation;
+
+/* listeners for NHDP database changes */
+static struct oonf_class_extension _content_listeners[] = {
+  {
+    .ext_name = "nhdp content",
+    .class_name = NHDP_CLASS_INTERFACE,
+    .cb_add = _cb_content_changed,
+    .cb_change = _cb_content_changed,
+    .cb_remove = _cb_content_changed,
+  },
+  {
+    .ext_name = "nhdp content",
+    .class_name = NHDP_CLASS_INTERFACE_ADDRESS,
+    .cb_add = _cb_content_changed,
+    .cb_change = _cb_content_changed,
+    .cb_remove = _cb_content_changed,
+  },
+  {
+    .ext_name = "nhdp content",
+    .class_name = NHDP_CLASS_LINK,
+    .cb_add = _cb_content_changed,
+    .cb_change = _cb_content_changed,
+    .cb_remove = _cb_content_changed,
+  },
+  {
+    .ext_name = "nhdp content",
+    .class_name = NHDP_CLASS_LINK_ADDRESS,
+    .cb_add = _cb_content_changed,
+    .cb_change = _cb_content_changed,
+    .cb_remove = _cb_content_changed,
+  },
+  {
+    .ext_name = "nhdp content",
+    .class_name = NHDP_CLASS_NEIGHBOR,
+    .cb_add = _cb_content_changed,
+    .cb_change = _cb_content_changed,
+    .cb_remove = _cb_content_changed,
+  },
+  {
+    .ext_name = "nhdp content",
+    .class_name = NHDP_CLASS_NEIGHBOR_ADDRESS,
+    .cb_add = _cb_content_changed,
+    .cb_change = _cb_content_changed,
+    .cb_remove = _cb_content_changed,
+  },
+  {
+    .ext_name = "nhdp content",
+    .class_name = NHDP_CLASS_DOMAIN,
+    .cb_add = _cb_content_changed,
+    .cb_change = _cb_content_changed,
+    .cb_remove = _cb_content_changed,
+  },
+};
+
+static struct nhdp_domain_listener _content_domain_listener = {
+  .mpr_update = _cb_domain_content_changed,
+  .metric_update = _cb_domain_content_changed,
+};
+
 /* Additional logging sources, not static because used by other source files! */
 enum oonf_log_source LOG_NHDP;
 enum oonf_log_source LOG_NHDP_R;
@@ -207,6 +271,8 @@ _early_cfg_init(void) {
  */
 static int
 _init(void) {
+  size_t i;
+
   _protocol = oonf_rfc5444_get_default_protocol();
   if (nhdp_writer_init(_protocol)) {
     return -1;
@@ -217,6 +283,10 @@ _init(void) {
   nhdp_interfaces_init(_protocol);
   nhdp_domain_init(_protocol);
 
+  for (i = 0; i < ARRAYSIZE(_content_listeners); i++) {
+    oonf_class_extension_add(&_content_listeners[i]);
+  }
+  nhdp_domain_listener_add(&_content_domain_listener);
   return 0;
 }
 
@@ -234,6 +304,13 @@ _initiate_shutdown(void) {
  */
 static void
 _cleanup(void) {
+  size_t i;
+
+  nhdp_domain_listener_remove(&_content_domain_listener);
+  for (i = 0; i < ARRAYSIZE(_content_listeners); i++) {
+    oonf_class_extension_remove(&_content_listeners[i]);
+  }
+
   nhdp_db_cleanup();
   nhdp_interfaces_cleanup();
   nhdp_domain_cleanup();
@@ -256,6 +333,7 @@ nhdp_set_originator(const struct netaddr *addr) {
   else if (netaddr_get_address_family(addr) == AF_INET6) {
     memcpy(&_originator_v6, addr, sizeof(*addr));
   }
+  nhdp_content_changed();
 }
 
 /**
@@ -271,6 +349,25 @@ nhdp_reset_originator(int af_type) {
   else if (af_type == AF_INET6) {
     netaddr_invalidate(&_originator_v6);
   }
+  nhdp_content_changed();
+}
+
+/**
+ * Signal that data advertised by NHDP or OLSRv2 changed, which
+ * invalidates the cached HELLO and TC messages.
+ */
+void
+nhdp_content_changed(void) {
+  _content_generation++;
+}
+
+/**
+ * @return generation counter of the data advertised by NHDP,
+ *   changes every time nhdp_content_changed() is called
+ */
+uint32_t
+nhdp_get_content_generation(void) {
+  return _content_generation;
 }
 
 /**
@@ -382,6 +479,7 @@ _cb_cfg_domain_changed(void) {
   }
 
   nhdp_domain_configure(ext, param.metric_name, param.mpr_name, param.mpr_willingness);
+  nhdp_content_changed();
 }
 
 /**
@@ -433,6 +531,7 @@ _cb_cfg_interface_changed(void) {
 
   /* apply new settings to interface */
   nhdp_interface_apply_settings(nhdp_if);
+  nhdp_content_changed();
 }
 
 static void
@@ -444,6 +543,7 @@ _cb_cfg_nhdp_changed(void) {
   }
 
   nhdp_domain_set_flooding_mpr(param.flooding_mpr_name, param.mpr_willingness);
+  nhdp_content_changed();
 }
 
 /**
@@ -477,3 +577,21 @@ _cb_validate_domain_section(const char *section_name, struct cfg_named_section *
   }
   return 0;
 }
+
+/**
+ * Callback for NHDP database changes
+ * @param ptr changed object
+ */
+static void
+_cb_content_changed(void *ptr __attribute__((unused))) {
+  nhdp_content_changed();
+}
+
+/**
+ * Callback for NHDP domain MPR and metric changes
+ * @param domain changed domain, NULL for all domains
+ */
+static void
+_cb_domain_content_changed(struct nhdp_domain *domain __attribute__((unused))) {
+  nhdp_content_changed();
+}
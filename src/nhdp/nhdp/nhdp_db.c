@@ -130,6 +130,9 @@ static struct oonf_timer_class _l2hop_vtime_info = {
 /* global tree of neighbor addresses */
 static struct avl_tree _naddr_tree;
 
+/* global hash index of neighbor addresses for fast lookups */
+static struct netaddr_hash _naddr_hash;
+
 /* list of neighbors */
 static struct list_entity _neigh_list;
 
@@ -148,6 +151,7 @@ static uint32_t _neighbor_set_id = 0;
 void
 nhdp_db_init(void) {
   avl_init(&_naddr_tree, avl_comp_netaddr, false);
+  netaddr_hash_init(&_naddr_hash);
   list_init_head(&_neigh_list);
   avl_init(&_neigh_originator_tree, avl_comp_netaddr, false);
   list_init_head(&_link_list);
@@ -190,6 +194,8 @@ nhdp_db_cleanup(void) {
   oonf_class_remove(&_link_info);
   oonf_class_remove(&_naddr_info);
   oonf_class_remove(&_neigh_info);
+
+  netaddr_hash_free(&_naddr_hash);
 }
 
 /**
@@ -300,6 +306,16 @@ nhdp_db_neighbor_set_unsymmetric(struct nhdp_neighbor *neigh) {
   oonf_class_event(&_neigh_info, neigh, OONF_OBJECT_CHANGED);
 }
 
+/**
+ * Inform all listeners that the domain specific data (metric,
+ * MPR state or willingness) of a NHDP neighbor changed
+ * @param neigh nhdp neighbor
+ */
+void
+nhdp_db_neighbor_changed(struct nhdp_neighbor *neigh) {
+  oonf_class_event(&_neigh_info, neigh, OONF_OBJECT_CHANGED);
+}
+
 /**
  * Join the links and addresses of two NHDP neighbors
  * @param dst target neighbor which gets all the links and addresses
@@ -371,6 +387,7 @@ nhdp_db_neighbor_addr_add(struct nhdp_neighbor *neigh, const struct netaddr *add
   memcpy(&naddr->neigh_addr, addr, sizeof(naddr->neigh_addr));
   naddr->_neigh_node.key = &naddr->neigh_addr;
   naddr->_global_node.key = &naddr->neigh_addr;
+  naddr->_global_hash_node.key = &naddr->neigh_addr;
 
   /* initialize backward link */
   naddr->neigh = neigh;
@@ -379,7 +396,9 @@ nhdp_db_neighbor_addr_add(struct nhdp_neighbor *neigh, const struct netaddr *add
   naddr->_lost_vtime.class = &_naddr_vtime_info;
 
   /* add to trees */
-  avl_insert(&_naddr_tree, &naddr->_global_node);
+  if (!avl_insert(&_naddr_tree, &naddr->_global_node)) {
+    netaddr_hash_insert(&_naddr_hash, &naddr->_global_hash_node);
+  }
   avl_insert(&neigh->_neigh_addresses, &naddr->_neigh_node);
 
   /* trigger event */
@@ -399,6 +418,7 @@ nhdp_db_neighbor_addr_remove(struct nhdp_naddr *naddr) {
 
   /* remove from trees */
   avl_remove(&_naddr_tree, &naddr->_global_node);
+  netaddr_hash_remove(&_naddr_hash, &naddr->_global_hash_node);
   avl_remove(&naddr->neigh->_neigh_addresses, &naddr->_neigh_node);
 
   /* stop timer */
@@ -423,6 +443,9 @@ nhdp_db_neighbor_addr_move(struct nhdp_neighbor *neigh, struct nhdp_naddr *naddr
 
   /* set new backlink */
   naddr->neigh = neigh;
+
+  /* trigger event */
+  oonf_class_event(&_naddr_info, naddr, OONF_OBJECT_CHANGED);
 }
 
 /**
@@ -785,6 +808,16 @@ nhdp_db_link_2hop_remove(struct nhdp_l2hop *l2hop) {
   oonf_class_free(&_l2hop_info, l2hop);
 }
 
+/**
+ * Inform all listeners that the domain specific metrics
+ * of a NHDP two-hop address changed
+ * @param l2hop nhdp two-hop link address
+ */
+void
+nhdp_db_link_2hop_changed(struct nhdp_l2hop *l2hop) {
+  oonf_class_event(&_l2hop_info, l2hop, OONF_OBJECT_CHANGED);
+}
+
 /**
  * Connect two links as representations of the same node,
  * @param l_ipv4 ipv4 link
@@ -901,6 +934,14 @@ nhdp_db_get_naddr_tree(void) {
   return &_naddr_tree;
 }
 
+/**
+ * @return hash index of all neighbor addresses
+ */
+struct netaddr_hash *
+nhdp_db_get_naddr_hash(void) {
+  return &_naddr_hash;
+}
+
 /**
  * get global tree of nhdp originators
  * @return originator tree
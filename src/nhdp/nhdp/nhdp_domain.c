@@ -72,6 +72,8 @@ static void _cb_update_everyone_flooding_mpr(struct nhdp_domain *domain);
 static bool _recalculate_neighbor_metric(struct nhdp_domain *domain, struct nhdp_neighbor *neigh);
 static bool _recalculate_routing_mpr_set(struct nhdp_domain *domain);
 static bool _recalculate_flooding_mpr_set(void);
+static void _process_mpr_tlv(
+  uint8_t *mprtypes, size_t mprtypes_size, struct nhdp_link *lnk, struct rfc5444_reader_tlvblock_entry *tlv);
 
 static const char *_link_to_string(struct nhdp_metric_str *, uint32_t);
 static const char *_path_to_string(struct nhdp_metric_str *, uint32_t, uint8_t);
@@ -439,6 +441,8 @@ nhdp_domain_init_neighbor(struct nhdp_neighbor *neigh) {
  */
 void
 nhdp_domain_process_metric_linktlv(struct nhdp_domain *domain, struct nhdp_link *lnk, const uint8_t *value) {
+  struct nhdp_link_domaindata *linkdata;
+  struct nhdp_neighbor_domaindata *neighdata;
   struct rfc7181_metric_field metric_field;
   uint32_t metric;
 
@@ -446,10 +450,18 @@ nhdp_domain_process_metric_linktlv(struct nhdp_domain *domain, struct nhdp_link
   metric = rfc7181_metric_decode(&metric_field);
 
   if (rfc7181_metric_has_flag(&metric_field, RFC7181_LINKMETRIC_INCOMING_LINK)) {
-    nhdp_domain_get_linkdata(domain, lnk)->metric.out = metric;
+    linkdata = nhdp_domain_get_linkdata(domain, lnk);
+    if (linkdata->metric.out != metric) {
+      linkdata->metric.out = metric;
+      nhdp_content_changed();
+    }
   }
   if (rfc7181_metric_has_flag(&metric_field, RFC7181_LINKMETRIC_INCOMING_NEIGH)) {
-    nhdp_domain_get_neighbordata(domain, lnk->neigh)->metric.out = metric;
+    neighdata = nhdp_domain_get_neighbordata(domain, lnk->neigh);
+    if (neighdata->metric.out != metric) {
+      neighdata->metric.out = metric;
+      nhdp_content_changed();
+    }
   }
 }
 
@@ -629,6 +641,39 @@ nhdp_domain_process_mprtypes_tlv(uint8_t *mprtypes, size_t mprtypes_size, struct
  */
 void
 nhdp_domain_process_mpr_tlv(
+  uint8_t *mprtypes, size_t mprtypes_size, struct nhdp_link *lnk, struct rfc5444_reader_tlvblock_entry *tlv) {
+  struct nhdp_neighbor_domaindata *neighdata;
+  struct nhdp_domain *domain;
+  bool old_local_mpr[NHDP_MAXIMUM_DOMAINS];
+  bool changed;
+
+  list_for_each_element(&_domain_list, domain, _node) {
+    old_local_mpr[domain->index] = nhdp_domain_get_neighbordata(domain, lnk->neigh)->local_is_mpr;
+  }
+
+  _process_mpr_tlv(mprtypes, mprtypes_size, lnk, tlv);
+
+  /* the MPR selector set is advertised in TCs */
+  changed = false;
+  list_for_each_element(&_domain_list, domain, _node) {
+    neighdata = nhdp_domain_get_neighbordata(domain, lnk->neigh);
+    changed |= old_local_mpr[domain->index] != neighdata->local_is_mpr;
+  }
+  if (changed) {
+    nhdp_content_changed();
+    nhdp_db_neighbor_changed(lnk->neigh);
+  }
+}
+
+/**
+ * Set the MPR selector flags of a NHDP link from an incoming MPR tlv
+ * @param mprtypes list of extensions for MPR
+ * @param mprtypes_size length of mprtypes array
+ * @param lnk NHDP link
+ * @param tlv MPR tlv context, NULL if no tlv was received
+ */
+static void
+_process_mpr_tlv(
   uint8_t *mprtypes, size_t mprtypes_size, struct nhdp_link *lnk, struct rfc5444_reader_tlvblock_entry *tlv) {
   struct nhdp_domain *domain;
   struct nhdp_neighbor *neigh;
@@ -741,15 +786,22 @@ void
 nhdp_domain_store_willingness(struct nhdp_link *lnk) {
   struct nhdp_neighbor_domaindata *neighdata;
   struct nhdp_domain *domain;
+  bool changed;
 
   lnk->flooding_willingness = _flooding_domain._tmp_willingness;
   OONF_DEBUG(LOG_NHDP_R, "Set flooding willingness: %u", lnk->flooding_willingness);
 
+  changed = false;
   list_for_each_element(&_domain_list, domain, _node) {
     neighdata = nhdp_domain_get_neighbordata(domain, lnk->neigh);
+    changed |= neighdata->willingness != domain->_tmp_willingness;
     neighdata->willingness = domain->_tmp_willingness;
     OONF_DEBUG(LOG_NHDP_R, "Set routing willingness for domain %u: %u", domain->ext, neighdata->willingness);
   }
+
+  if (changed) {
+    nhdp_db_neighbor_changed(lnk->neigh);
+  }
 }
 
 /**
@@ -915,6 +967,11 @@ nhdp_domain_set_incoming_metric(struct nhdp_domain_metric *metric, struct nhdp_l
       linkdata->metric.in = new_metric;
     }
   }
+
+  if (changed) {
+    /* incoming link metrics are advertised in HELLOs */
+    nhdp_content_changed();
+  }
   return changed;
 }
 
@@ -979,6 +1036,7 @@ static bool
 _recalculate_routing_mpr_set(struct nhdp_domain *domain) {
   struct nhdp_neighbor_domaindata *neighdata;
   struct nhdp_neighbor *neigh;
+  bool changed;
 
   if (!domain->mpr->update_routing_mpr) {
     return false;
@@ -993,15 +1051,17 @@ _recalculate_routing_mpr_set(struct nhdp_domain *domain) {
   /* update MPR set */
   domain->mpr->update_routing_mpr(domain);
 
-  /* check for changes */
+  /* check for changes and inform listeners of every changed neighbor */
+  changed = false;
   list_for_each_element(nhdp_db_get_neigh_list(), neigh, _global_node) {
     neighdata = nhdp_domain_get_neighbordata(domain, neigh);
     if (neighdata->_neigh_was_mpr != neighdata->neigh_is_mpr) {
       OONF_DEBUG(LOG_NHDP, "Domain ext %u MPR set changed", domain->ext);
-      return true;
+      nhdp_db_neighbor_changed(neigh);
+      changed = true;
     }
   }
-  return false;
+  return changed;
 }
 
 /**
@@ -1018,6 +1078,7 @@ _recalculate_neighbor_metric(struct nhdp_domain *domain, struct nhdp_neighbor *n
   struct nhdp_l2hop *l2hop;
   struct nhdp_l2hop_domaindata *l2hopdata;
   struct nhdp_neighbor_domaindata *neighdata;
+  struct nhdp_metric old_metric;
   bool changed;
 #ifdef OONF_LOG_INFO
   struct netaddr_str nbuf;
@@ -1026,6 +1087,9 @@ _recalculate_neighbor_metric(struct nhdp_domain *domain, struct nhdp_neighbor *n
   neighdata = nhdp_domain_get_neighbordata(domain, neigh);
   changed = false;
 
+  /* remember old metric to detect changes */
+  old_metric = neighdata->metric;
+
   /* reset metric */
   neighdata->metric.in = RFC7181_METRIC_INFINITE;
   neighdata->metric.out = RFC7181_METRIC_INFINITE;
@@ -1078,6 +1142,9 @@ _recalculate_neighbor_metric(struct nhdp_domain *domain, struct nhdp_neighbor *n
     neighdata->best_out_link_metric = linkdata->metric.out;
   }
 
+  if (old_metric.in != neighdata->metric.in || old_metric.out != neighdata->metric.out) {
+    nhdp_db_neighbor_changed(neigh);
+  }
   return changed;
 }
 
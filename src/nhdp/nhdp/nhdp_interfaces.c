@@ -239,8 +239,9 @@ nhdp_interface_add(const char *name) {
     /* init link list */
     list_init_head(&interf->_links);
 
-    /* init link address tree */
+    /* init link address tree and its hash index */
     avl_init(&interf->_link_addresses, avl_comp_netaddr, false);
+    netaddr_hash_init(&interf->_link_address_hash);
 
     /*
      * init originator tree
@@ -308,6 +309,7 @@ nhdp_interface_remove(struct nhdp_interface *interf) {
   /* now clean up the rest */
   os_interface_remove(&interf->os_if_listener);
   oonf_rfc5444_remove_interface(interf->rfc5444_if.interface, &interf->rfc5444_if);
+  netaddr_hash_free(&interf->_link_address_hash);
   oonf_class_free(&_interface_info, interf);
 }
 
@@ -544,6 +546,9 @@ _cb_interface_event(struct oonf_rfc5444_interface_listener *ifl, bool changed __
 
   OONF_DEBUG(LOG_NHDP, "NHDP Interface change event: %s", ifl->interface->name);
 
+  /* mac address of interface might have changed */
+  nhdp_content_changed();
+
   interf = container_of(ifl, struct nhdp_interface, rfc5444_if);
 
   /* mark all old addresses */
@@ -773,14 +773,18 @@ _process_domainspecific_2hopdata(struct nhdp_l2hop *l2hop, struct netaddr *addr
   struct rfc5444_reader_tlvblock_entry *tlv;
   struct nhdp_domain *domain;
   struct nhdp_l2hop_domaindata *data;
+  struct nhdp_metric old_metric[NHDP_MAXIMUM_DOMAINS];
+  bool changed;
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str buf;
 #endif
 
   /* clear metric values that should be present in HELLO */
   list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    data = nhdp_domain_get_l2hopdata(domain, l2hop);
+    memcpy(&old_metric[domain->index], &data->metric, sizeof(data->metric));
+
     if (!domain->metric->no_default_handling) {
-      data = nhdp_domain_get_l2hopdata(domain, l2hop);
       data->metric.in = RFC7181_METRIC_INFINITE;
       data->metric.out = RFC7181_METRIC_INFINITE;
     }
@@ -800,6 +804,16 @@ _process_domainspecific_2hopdata(struct nhdp_l2hop *l2hop, struct netaddr *addr
 
     tlv = tlv->next_entry;
   }
+
+  /* inform listeners about changed two-hop metrics */
+  changed = false;
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    data = nhdp_domain_get_l2hopdata(domain, l2hop);
+    changed |= memcmp(&old_metric[domain->index], &data->metric, sizeof(data->metric)) != 0;
+  }
+  if (changed) {
+    nhdp_db_link_2hop_changed(l2hop);
+  }
 }
 
 /**
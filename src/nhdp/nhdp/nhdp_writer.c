@@ -115,6 +115,7 @@ nhdp_writer_init(struct oonf_rfc5444_protocol *p) {
   }
 
   _nhdp_message->addMessageHeader = _cb_addMessageHeader;
+  _nhdp_message->cache_enabled = true;
 
   if (rfc5444_writer_register_msgcontentprovider(
         &_protocol->writer, &_nhdp_msgcontent_provider, _nhdp_addrtlvs, ARRAYSIZE(_nhdp_addrtlvs))) {
@@ -165,6 +166,9 @@ nhdp_writer_send_hello(struct nhdp_interface *ninterf) {
 
   nhdp_domain_recalculate_mpr();
 
+  /* reuse the last Hello of this interface if nothing changed */
+  _nhdp_message->content_generation = nhdp_get_content_generation();
+
   /* store NHDP interface */
   _nhdp_if = ninterf;
 
@@ -189,7 +193,10 @@ nhdp_writer_send_hello(struct nhdp_interface *ninterf) {
  */
 void
 nhdp_writer_set_mac_TLV_state(bool active) {
-  _add_mac_tlv = active;
+  if (_add_mac_tlv != active) {
+    _add_mac_tlv = active;
+    nhdp_content_changed();
+  }
 }
 
 /**
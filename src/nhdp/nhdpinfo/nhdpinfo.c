@@ -80,14 +80,18 @@ static void _initialize_nhdp_link_address_values(struct nhdp_laddr *laddr);
 static void _initialize_nhdp_link_twohop_values(struct nhdp_l2hop *twohop);
 static void _initialize_nhdp_neighbor_values(struct nhdp_neighbor *neigh);
 static void _initialize_nhdp_neighbor_address_values(struct nhdp_naddr *naddr);
+static void _initialize_hash_values(const char *name, const struct netaddr_hash *hash);
 
 static int _cb_create_text_interface(struct oonf_viewer_template *);
 static int _cb_create_text_if_address(struct oonf_viewer_template *);
 static int _cb_create_text_link(struct oonf_viewer_template *);
+static int _cb_create_text_link_object(struct oonf_viewer_template *, void *);
 static int _cb_create_text_link_address(struct oonf_viewer_template *);
 static int _cb_create_text_link_twohop(struct oonf_viewer_template *);
 static int _cb_create_text_neighbor(struct oonf_viewer_template *);
+static int _cb_create_text_neighbor_object(struct oonf_viewer_template *, void *);
 static int _cb_create_text_neighbor_address(struct oonf_viewer_template *);
+static int _cb_create_text_hash(struct oonf_viewer_template *);
 
 /*
  * list of template keys and corresponding buffers for values.
@@ -194,6 +198,18 @@ static int _cb_create_text_neighbor_address(struct oonf_viewer_template *);
 /*! template key for validity time of lost neighbor address */
 #define KEY_NEIGHBOR_ADDRESS_VTIME "neighbor_address_lost_vtime"
 
+/*! template key for name of address hash index */
+#define KEY_HASH "hash"
+
+/*! template key for number of addresses in hash index */
+#define KEY_HASH_COUNT "hash_count"
+
+/*! template key for number of lookups in hash index */
+#define KEY_HASH_LOOKUPS "hash_lookups"
+
+/*! template key for number of successful lookups in hash index */
+#define KEY_HASH_HITS "hash_hits"
+
 /*! template key for NHDP domain */
 #define KEY_DOMAIN "domain"
 
@@ -269,6 +285,11 @@ static struct netaddr_str _value_neighbor_address;
 static char _value_neighbor_address_lost[TEMPLATE_JSON_BOOL_LENGTH];
 static struct isonumber_str _value_neighbor_address_lost_vtime;
 
+static char _value_hash[16];
+static char _value_hash_count[11];
+static char _value_hash_lookups[21];
+static char _value_hash_hits[21];
+
 static char _value_domain[4];
 static char _value_domain_metric[NHDP_DOMAIN_METRIC_MAXLEN];
 static struct nhdp_metric_str _value_domain_metric_in;
@@ -372,6 +393,13 @@ static struct abuf_template_data_entry _tde_neigh_addr[] = {
   { KEY_NEIGHBOR_ADDRESS_VTIME, _value_neighbor_address_lost_vtime.buf, false },
 };
 
+static struct abuf_template_data_entry _tde_hash[] = {
+  { KEY_HASH, _value_hash, true },
+  { KEY_HASH_COUNT, _value_hash_count, false },
+  { KEY_HASH_LOOKUPS, _value_hash_lookups, false },
+  { KEY_HASH_HITS, _value_hash_hits, false },
+};
+
 static struct abuf_template_storage _template_storage;
 
 /* Template Data objects (contain one or more Template Data Entries) */
@@ -411,6 +439,10 @@ static struct abuf_template_data _td_neigh_addr[] = {
   { _tde_neigh_key, ARRAYSIZE(_tde_neigh_key) },
   { _tde_neigh_addr, ARRAYSIZE(_tde_neigh_addr) },
 };
+static struct abuf_template_data _td_hash[] = {
+  { _tde_if_key, ARRAYSIZE(_tde_if_key) },
+  { _tde_hash, ARRAYSIZE(_tde_hash) },
+};
 
 /* OONF viewer templates (based on Template Data arrays) */
 static struct oonf_viewer_template _templates[] = { {
@@ -430,6 +462,10 @@ static struct oonf_viewer_template _templates[] = { {
     .data_size = ARRAYSIZE(_td_link),
     .json_name = "link",
     .cb_function = _cb_create_text_link,
+    .help = "Subscriptions to this subcommand only report link status changes,"
+            " subscribe to 'neighbor' to get metric and MPR changes.\n",
+    .class_name = NHDP_CLASS_LINK,
+    .cb_object = _cb_create_text_link_object,
   },
   {
     .data = _td_link_addr,
@@ -448,12 +484,21 @@ static struct oonf_viewer_template _templates[] = { {
     .data_size = ARRAYSIZE(_td_neigh),
     .json_name = "neighbor",
     .cb_function = _cb_create_text_neighbor,
+    .help = "Subscriptions to this subcommand report status, metric, MPR and willingness changes.\n",
+    .class_name = NHDP_CLASS_NEIGHBOR,
+    .cb_object = _cb_create_text_neighbor_object,
   },
   {
     .data = _td_neigh_addr,
     .data_size = ARRAYSIZE(_td_neigh_addr),
     .json_name = "neighbor_addr",
     .cb_function = _cb_create_text_neighbor_address,
+  },
+  {
+    .data = _td_hash,
+    .data_size = ARRAYSIZE(_td_hash),
+    .json_name = "hash",
+    .cb_function = _cb_create_text_hash,
   } };
 
 /* telnet command of this plugin */
@@ -504,8 +549,8 @@ _cleanup(void) {
  */
 static enum oonf_telnet_result
 _cb_nhdpinfo(struct oonf_telnet_data *con) {
-  return oonf_viewer_telnet_handler(
-    con->out, &_template_storage, OONF_NHDPINFO_SUBSYSTEM, con->parameter, _templates, ARRAYSIZE(_templates));
+  return oonf_viewer_telnet_session_handler(
+    con, &_template_storage, OONF_NHDPINFO_SUBSYSTEM, _templates, ARRAYSIZE(_templates));
 }
 
 /**
@@ -698,6 +743,19 @@ _initialize_nhdp_neighbor_address_values(struct nhdp_naddr *naddr) {
   oonf_clock_toIntervalString(&_value_neighbor_address_lost_vtime, oonf_timer_get_due(&naddr->_lost_vtime));
 }
 
+/**
+ * Initialize the value buffers for an address hash index
+ * @param name name of the index
+ * @param hash address hash index
+ */
+static void
+_initialize_hash_values(const char *name, const struct netaddr_hash *hash) {
+  strscpy(_value_hash, name, sizeof(_value_hash));
+  snprintf(_value_hash_count, sizeof(_value_hash_count), "%u", hash->count);
+  snprintf(_value_hash_lookups, sizeof(_value_hash_lookups), "%" PRIu64, hash->lookups);
+  snprintf(_value_hash_hits, sizeof(_value_hash_hits), "%" PRIu64, hash->hits);
+}
+
 /**
  * Displays the known data about each NHDP interface.
  * @param template oonf viewer template
@@ -750,24 +808,37 @@ static int
 _cb_create_text_link(struct oonf_viewer_template *template) {
   struct nhdp_interface *nhdp_if;
   struct nhdp_link *nlink;
-  struct nhdp_domain *domain;
 
   avl_for_each_element(nhdp_interface_get_tree(), nhdp_if, _node) {
-    /* fill output buffers for template engine */
-    _initialize_interface_values(nhdp_if);
-
     list_for_each_element(&nhdp_if->_links, nlink, _if_node) {
-      _initialize_nhdp_link_values(nlink);
-      _initialize_nhdp_neighbor_values(nlink->neigh);
+      _cb_create_text_link_object(template, nlink);
+    }
+  }
+  return 0;
+}
+
+/**
+ * Displays the data of a single NHDP link.
+ * @param template oonf viewer template
+ * @param ptr NHDP link
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_link_object(struct oonf_viewer_template *template, void *ptr) {
+  struct nhdp_link *nlink = ptr;
+  struct nhdp_domain *domain;
 
-      list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-        _initialize_nhdp_domain_metric_values(domain, &(nhdp_domain_get_linkdata(domain, nlink)->metric));
-        _initialize_nhdp_domain_metric_int_values(domain, nlink);
+  /* fill output buffers for template engine */
+  _initialize_interface_values(nlink->local_if);
+  _initialize_nhdp_link_values(nlink);
+  _initialize_nhdp_neighbor_values(nlink->neigh);
 
-        /* generate template output */
-        oonf_viewer_output_print_line(template);
-      }
-    }
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    _initialize_nhdp_domain_metric_values(domain, &(nhdp_domain_get_linkdata(domain, nlink)->metric));
+    _initialize_nhdp_domain_metric_int_values(domain, nlink);
+
+    /* generate template output */
+    oonf_viewer_output_print_line(template);
   }
   return 0;
 }
@@ -845,22 +916,36 @@ _cb_create_text_link_twohop(struct oonf_viewer_template *template) {
 static int
 _cb_create_text_neighbor(struct oonf_viewer_template *template) {
   struct nhdp_neighbor *neigh;
-  struct nhdp_domain *domain;
 
   list_for_each_element(nhdp_db_get_neigh_list(), neigh, _global_node) {
-    _initialize_nhdp_neighbor_values(neigh);
+    _cb_create_text_neighbor_object(template, neigh);
+  }
+  return 0;
+}
+
+/**
+ * Displays the data of a single NHDP neighbor.
+ * @param template oonf viewer template
+ * @param ptr NHDP neighbor
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_neighbor_object(struct oonf_viewer_template *template, void *ptr) {
+  struct nhdp_neighbor *neigh = ptr;
+  struct nhdp_domain *domain;
 
-    list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-      struct nhdp_neighbor_domaindata *data;
+  _initialize_nhdp_neighbor_values(neigh);
 
-      data = nhdp_domain_get_neighbordata(domain, neigh);
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    struct nhdp_neighbor_domaindata *data;
 
-      _initialize_nhdp_domain_metric_values(domain, &data->metric);
-      _initialize_nhdp_neighbor_mpr_values(domain, data);
+    data = nhdp_domain_get_neighbordata(domain, neigh);
 
-      /* generate template output */
-      oonf_viewer_output_print_line(template);
-    }
+    _initialize_nhdp_domain_metric_values(domain, &data->metric);
+    _initialize_nhdp_neighbor_mpr_values(domain, data);
+
+    /* generate template output */
+    oonf_viewer_output_print_line(template);
   }
   return 0;
 }
@@ -887,3 +972,27 @@ _cb_create_text_neighbor_address(struct oonf_viewer_template *template) {
   }
   return 0;
 }
+
+/**
+ * Displays the statistics of the NHDP address hash indexes.
+ * @param template oonf viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_hash(struct oonf_viewer_template *template) {
+  struct nhdp_interface *nhdp_if;
+
+  /* global index of neighbor addresses */
+  strscpy(_value_if, "-", sizeof(_value_if));
+  _initialize_hash_values("neighbor_addr", nhdp_db_get_naddr_hash());
+  oonf_viewer_output_print_line(template);
+
+  avl_for_each_element(nhdp_interface_get_tree(), nhdp_if, _node) {
+    strscpy(_value_if, nhdp_interface_get_name(nhdp_if), sizeof(_value_if));
+    _initialize_hash_values("link_addr", nhdp_interface_get_link_addr_hash(nhdp_if));
+
+    /* generate template output */
+    oonf_viewer_output_print_line(template);
+  }
+  return 0;
+}
@@ -103,6 +103,9 @@ struct _import_entry {
   /*! list of lan entries imported by this filter */
   struct avl_tree imported_lan_tree;
 
+  /*! subscription for kernel routes matching table, protocol and metric */
+  struct os_route_mirror_subscriber mirror;
+
   /*! tree of all configured lan import */
   struct avl_node _node;
 };
@@ -131,11 +134,9 @@ static struct _imported_lan *_add_lan(
   struct _import_entry *, struct os_route_key *key, uint32_t metric, uint8_t distance);
 static void _destroy_lan(struct _imported_lan *);
 
-static void _cb_query(struct os_route *filter, struct os_route *route);
-static void _cb_query_finished(struct os_route *, int error);
-
 static bool _is_allowed_to_import(const struct os_route *route);
-static void _cb_rt_event(const struct os_route *, bool);
+static void _cb_mirror_event(struct os_route_mirror_subscriber *, const struct os_route *, bool);
+static void _import_route(struct _import_entry *import, const struct os_route *route, bool set);
 
 static void _cb_metric_aging(struct oonf_timer_instance *entry);
 
@@ -222,11 +223,6 @@ static struct oonf_class _lan_import_class = {
   .size = sizeof(struct _imported_lan),
 };
 
-/* callback filter for dijkstra */
-static struct os_route_listener _routing_listener = {
-  .cb_get = _cb_rt_event,
-};
-
 /* tree of lan importers */
 static struct avl_tree _import_tree;
 
@@ -236,9 +232,6 @@ static struct oonf_timer_class _aging_timer_class = {
   .periodic = true,
 };
 
-/* wildcard route for first query */
-static struct os_route _unicast_query;
-
 /**
  * Initialize plugin
  * @return always returns 0 (cannot fail)
@@ -248,21 +241,18 @@ _init(void) {
   avl_init(&_import_tree, avl_comp_strcasecmp, false);
   oonf_class_add(&_import_class);
   oonf_class_add(&_lan_import_class);
-  os_routing_listener_add(&_routing_listener);
   oonf_timer_add(&_aging_timer_class);
-
-  /* initialize wildcard query */
-  os_routing_init_wildcard_route(&_unicast_query);
-  _unicast_query.cb_get = _cb_query;
-  _unicast_query.cb_finished = _cb_query_finished;
-  _unicast_query.p.type = OS_ROUTE_UNICAST;
   return 0;
 }
 
 static void
 _initiate_shutdown(void) {
+  struct _import_entry *import;
+
   /* we are not interested in listening to all the routing cleanup */
-  os_routing_listener_remove(&_routing_listener);
+  avl_for_each_element(&_import_tree, import, _node) {
+    os_routing_mirror_remove(&import->mirror);
+  }
 }
 
 /**
@@ -281,24 +271,6 @@ _cleanup(void) {
   oonf_class_remove(&_import_class);
 }
 
-/**
- * Wrapper for cb_get for wildcard query
- * @param filter unused filter
- * @param route route found by wildcard query
- */
-static void
-_cb_query(struct os_route *filter __attribute__((unused)), struct os_route *route) {
-  _cb_rt_event(route, true);
-}
-
-/**
- * Dummy cb_finished callback for wildcard query
- * @param route route that was finished
- * @param error error code
- */
-static void
-_cb_query_finished(struct os_route *route __attribute__((unused)), int error __attribute__((unused))) {}
-
 /**
  * Checks if importing the route is prevented because of safety issues
  * @param route route data
@@ -327,18 +299,14 @@ _is_allowed_to_import(const struct os_route *route) {
 }
 
 /**
- * Callback for route listener
+ * Callback for kernel route mirror
+ * @param subscriber route mirror subscriber of import
  * @param route routing data
  * @param set true if route was set, false otherwise
  */
 static void
-_cb_rt_event(const struct os_route *route, bool set) {
+_cb_mirror_event(struct os_route_mirror_subscriber *subscriber, const struct os_route *route, bool set) {
   struct _import_entry *import;
-  struct _imported_lan *lan;
-  char ifname[IF_NAMESIZE];
-  struct os_route_key ssprefix;
-  int metric;
-
 #ifdef OONF_LOG_DEBUG_INFO
   struct os_route_str rbuf;
 #endif
@@ -352,92 +320,103 @@ _cb_rt_event(const struct os_route *route, bool set) {
     /* ignore multicast, linklocal and loopback */
     return;
   }
-  if (route->p.type != OS_ROUTE_UNICAST) {
-    /* return all non-unicast type routes */
-    return;
-  }
 
-  OONF_DEBUG(
-    LOG_LAN_IMPORT, "Received route event (%s): %s", set ? "set" : "remove", os_routing_to_string(&rbuf, &route->p));
+  import = container_of(subscriber, struct _import_entry, mirror);
+
+  OONF_DEBUG(LOG_LAN_IMPORT, "Received route event (%s) for import %s: %s", set ? "set" : "remove", import->name,
+    os_routing_to_string(&rbuf, &route->p));
 
   if (!_is_allowed_to_import(route)) {
     return;
   }
 
+  _import_route(import, route, set);
+}
+
+/**
+ * Apply a kernel route change to one import
+ * @param import import entry
+ * @param route routing data
+ * @param set true if route was set, false otherwise
+ */
+static void
+_import_route(struct _import_entry *import, const struct os_route *route, bool set) {
+  struct _imported_lan *lan;
+  char ifname[IF_NAMESIZE];
+  struct os_route_key ssprefix;
+  int metric;
+
   /* get interface name for route */
+  ifname[0] = 0;
   if (route->p.if_index) {
     if_indextoname(route->p.if_index, ifname);
   }
 
-  avl_for_each_element(&_import_tree, import, _node) {
-    OONF_DEBUG(LOG_LAN_IMPORT, "Check for import: %s", import->name);
+  /* check prefix length */
+  if (import->prefix_length != -1 && import->prefix_length != netaddr_get_prefix_length(&route->p.key.dst)) {
+    OONF_DEBUG(LOG_LAN_IMPORT, "Bad prefix length");
+    return;
+  }
 
-    /* check prefix length */
-    if (import->prefix_length != -1 && import->prefix_length != netaddr_get_prefix_length(&route->p.key.dst)) {
-      OONF_DEBUG(LOG_LAN_IMPORT, "Bad prefix length");
-      continue;
-    }
+  /* check if destination matches */
+  if (!netaddr_acl_check_accept(&import->filter, &route->p.key.dst)) {
+    OONF_DEBUG(LOG_LAN_IMPORT, "Bad prefix");
+    return;
+  }
 
-    /* check if destination matches */
-    if (!netaddr_acl_check_accept(&import->filter, &route->p.key.dst)) {
-      OONF_DEBUG(LOG_LAN_IMPORT, "Bad prefix");
-      continue;
-    }
+  /* check routing table */
+  if (import->table != -1 && import->table != route->p.table) {
+    OONF_DEBUG(LOG_LAN_IMPORT, "Bad routing table");
+    return;
+  }
 
-    /* check routing table */
-    if (import->table != -1 && import->table != route->p.table) {
-      OONF_DEBUG(LOG_LAN_IMPORT, "Bad routing table");
-      continue;
-    }
+  /* check protocol */
+  if (import->protocol != -1 && import->protocol != route->p.protocol) {
+    OONF_DEBUG(LOG_LAN_IMPORT, "Bad protocol");
+    return;
+  }
 
-    /* check protocol */
-    if (import->protocol != -1 && import->protocol != route->p.protocol) {
-      OONF_DEBUG(LOG_LAN_IMPORT, "Bad protocol");
-      continue;
-    }
+  /* check metric */
+  if (import->distance != -1 && import->distance != route->p.metric) {
+    OONF_DEBUG(LOG_LAN_IMPORT, "Bad distance");
+    return;
+  }
 
-    /* check metric */
-    if (import->distance != -1 && import->distance != route->p.metric) {
-      OONF_DEBUG(LOG_LAN_IMPORT, "Bad distance");
-      continue;
+  /* check interface name */
+  if (import->ifname[0]) {
+    if (route->p.if_index == 0) {
+      OONF_DEBUG(LOG_LAN_IMPORT, "Route has no interface");
+      return;
     }
-
-    /* check interface name */
-    if (import->ifname[0]) {
-      if (route->p.if_index == 0) {
-        OONF_DEBUG(LOG_LAN_IMPORT, "Route has no interface");
-        continue;
-      }
-      if (strcmp(import->ifname, ifname) != 0) {
-        OONF_DEBUG(LOG_LAN_IMPORT, "Bad interface");
-        continue;
-      }
+    if (strcmp(import->ifname, ifname) != 0) {
+      OONF_DEBUG(LOG_LAN_IMPORT, "Bad interface");
+      return;
     }
+  }
 
-    memcpy(&ssprefix.dst, &route->p.key.dst, sizeof(struct netaddr));
-    memcpy(&ssprefix.src, &route->p.key.src, sizeof(struct netaddr));
+  memcpy(&ssprefix.dst, &route->p.key.dst, sizeof(struct netaddr));
+  memcpy(&ssprefix.src, &route->p.key.src, sizeof(struct netaddr));
 
-    if (set) {
-      metric = route->p.metric;
-      if (metric < 1) {
-        metric = 1;
-      }
-      if (metric > 255) {
-        metric = 255;
-      }
+  if (set) {
+    metric = route->p.metric;
+    if (metric < 1) {
+      metric = 1;
+    }
+    if (metric > 255) {
+      metric = 255;
+    }
 
-      OONF_DEBUG(LOG_LAN_IMPORT, "Add lan...");
-      lan = _add_lan(import, &ssprefix, import->routing_metric, metric);
-      if (lan && import->metric_aging) {
-        oonf_timer_set(&lan->_aging_timer, import->metric_aging);
-      }
+    OONF_DEBUG(LOG_LAN_IMPORT, "Add lan...");
+    lan = _add_lan(import, &ssprefix, import->routing_metric, metric);
+    if (lan && import->metric_aging) {
+      oonf_timer_set(&lan->_aging_timer, import->metric_aging);
     }
-    else {
-      OONF_DEBUG(LOG_LAN_IMPORT, "Remove lan...");
-      lan = avl_find_element(&import->imported_lan_tree, &ssprefix, lan, _node);
-      if (lan) {
-        _destroy_lan(lan);
-      }
+  }
+  else {
+    OONF_DEBUG(LOG_LAN_IMPORT, "Remove lan...");
+    lan = avl_find_element(&import->imported_lan_tree, &ssprefix, lan, _node);
+    if (lan) {
+      _destroy_lan(lan);
     }
   }
 }
@@ -468,6 +447,11 @@ _get_import(const char *name) {
 
   avl_init(&import->imported_lan_tree, os_routing_avl_cmp_route_key, false);
 
+  /* initialize route mirror subscription */
+  os_routing_init_wildcard_route(&import->mirror.filter);
+  import->mirror.filter.p.type = OS_ROUTE_UNICAST;
+  import->mirror.cb_get = _cb_mirror_event;
+
   return import;
 }
 
@@ -477,6 +461,7 @@ _get_import(const char *name) {
  */
 static void
 _destroy_import(struct _import_entry *import) {
+  os_routing_mirror_remove(&import->mirror);
   avl_remove(&_import_tree, &import->_node);
   netaddr_acl_remove(&import->filter);
   oonf_class_free(&_import_class, import);
@@ -610,8 +595,14 @@ _cb_cfg_changed(void) {
 
   cfg_get_phy_if(import->ifname, import->ifname);
 
-  /* trigger wildcard query */
-  if (!os_routing_is_in_progress(&_unicast_query)) {
-    os_routing_query(&_unicast_query);
-  }
+  /* let the route mirror do the cheap part of the filtering */
+  import->mirror.filter.p.table = import->table > 0 ? import->table : RT_TABLE_UNSPEC;
+  import->mirror.filter.p.protocol = import->protocol > 0 ? import->protocol : RTPROT_UNSPEC;
+  import->mirror.filter.p.metric = import->distance;
+
+  /* repeated announcements of a route reset its metric aging */
+  import->mirror.want_refresh = import->metric_aging != 0;
+
+  /* subscribe or get all matching routes again */
+  os_routing_mirror_add(&import->mirror);
 }
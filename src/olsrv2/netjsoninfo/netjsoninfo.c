@@ -43,12 +43,18 @@
  * @file
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <oonf/libcommon/autobuf.h>
 #include <oonf/oonf.h>
 #include <oonf/libcommon/json.h>
+#include <oonf/libcommon/list.h>
+#include <oonf/libcommon/netaddr_hash.h>
 
 #include <oonf/libcore/oonf_logging.h>
 #include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
 #include <oonf/base/oonf_clock.h>
 #include <oonf/base/oonf_telnet.h>
 
@@ -123,14 +129,124 @@ enum netjson_edge_type
   NETJSON_EDGE_ATTACHED,
 };
 
+/*! steps of the netjsoninfo output generator */
+enum _netjson_step
+{
+  /*! start of the output */
+  NETJSON_STEP_START,
+
+  /*! parse the next sub-command */
+  NETJSON_STEP_OBJECT,
+
+  /*! select cached snapshot of a topology or generate a new one */
+  NETJSON_STEP_TOPOLOGY,
+
+  /*! copy snapshot into output */
+  NETJSON_STEP_SNAPSHOT,
+
+  /*! domain object */
+  NETJSON_STEP_DOMAIN,
+
+  /*! end of the output */
+  NETJSON_STEP_END,
+
+  /*! output is complete */
+  NETJSON_STEP_DONE,
+};
+
+/*! version of the databases a netjson output is generated from */
+struct _netjson_version {
+  /*! IPv4 originator of the local router */
+  struct netaddr originator_v4;
+
+  /*! IPv6 originator of the local router */
+  struct netaddr originator_v6;
+
+  /*! fingerprint of the NHDP links */
+  uint32_t nhdp;
+
+  /*! topology generation of the routing domain(s) */
+  uint32_t routing;
+
+  /*! answer set number of the local router */
+  uint16_t ansn;
+};
+
+/*! serialized graph or route object of a single topology */
+struct _netjson_snapshot {
+  /*! json text of the object */
+  struct autobuf json;
+
+  /*! version of the databases the snapshot has been generated from */
+  struct _netjson_version version;
+
+  /*! number of references from the snapshot cache and cursors */
+  int refcount;
+};
+
+/**
+ * Position of a netjsoninfo command within its output. The cursor
+ * allows to generate large outputs in multiple parts, each time
+ * the telnet session has sent its output buffer.
+ */
+struct _netjson_cursor {
+  /*! json session writing into the telnet output buffer */
+  struct json_session session;
+
+  /*! snapshot of current topology, NULL if none */
+  struct _netjson_snapshot *snapshot;
+
+  /*! number of bytes of the snapshot already copied into the output buffer */
+  size_t offset;
+
+  /*! copy of the command parameters (without filter prefix) */
+  char *parameter;
+
+  /*! next sub-command to parse, NULL if there is none */
+  const char *next;
+
+  /*! true if the output is a single object without NetworkCollection */
+  bool filter;
+
+  /*! true if a sub-command could not be parsed */
+  bool error;
+
+  /*! true if the output can be suspended when the buffer is full */
+  bool streaming;
+
+  /*! current output step */
+  enum _netjson_step step;
+
+  /*! true if the current object is a routing tree, false for a graph */
+  bool route;
+
+  /*! domain id of the topology to print, NULL for all */
+  const char *topology_filter;
+
+  /*! current topology, combination of domain index and address family */
+  int topology;
+
+  /*! nhdp domain of current topology */
+  struct nhdp_domain *domain;
+
+  /*! address family of current topology */
+  int af_type;
+
+  /*! telnet data of a streamed output, NULL otherwise */
+  struct oonf_telnet_data *telnet;
+
+  /*! node for list of streamed outputs */
+  struct list_entity _node;
+};
+
 /* prototypes */
 static int _init(void);
 static void _cleanup(void);
 
+static void _next_topology(struct _netjson_cursor *cursor);
+static void _unref_snapshot(struct _netjson_snapshot *snapshot);
 static void _print_graph(struct json_session *session, struct nhdp_domain *domain, int af_type);
-static void _create_graph_json(struct json_session *session, const char *filter);
 static void _print_routing_tree(struct json_session *session, struct nhdp_domain *domain, int af_type);
-static void _create_route_json(struct json_session *session, const char *filter);
 static void _create_domain_json(struct json_session *session);
 static void _create_error_json(struct json_session *session, const char *message, const char *parameter);
 static enum oonf_telnet_result _cb_netjsoninfo(struct oonf_telnet_data *con);
@@ -152,8 +268,27 @@ static struct oonf_telnet_command _telnet_commands[] = {
     "> netjsoninfo filter route ipv4_0\n"),
 };
 
+/* memory class for netjsoninfo cursors */
+static struct oonf_class _cursor_class = {
+  .name = "netjsoninfo cursor",
+  .size = sizeof(struct _netjson_cursor),
+};
+
+/* list of streamed outputs */
+static struct list_entity _cursor_list;
+
+/* memory class for netjson snapshots */
+static struct oonf_class _snapshot_class = {
+  .name = "netjsoninfo snapshot",
+  .size = sizeof(struct _netjson_snapshot),
+};
+
+/* cached snapshots for graph/route, each domain and address family */
+static struct _netjson_snapshot *_snapshots[2][NHDP_MAXIMUM_DOMAINS][2];
+
 /* plugin declaration */
 static const char *_dependencies[] = {
+  OONF_CLASS_SUBSYSTEM,
   OONF_NHDP_SUBSYSTEM,
   OONF_OLSRV2_SUBSYSTEM,
   OONF_TELNET_SUBSYSTEM,
@@ -175,6 +310,9 @@ DECLARE_OONF_PLUGIN(olsrv2_netjsoninfo);
  */
 static int
 _init(void) {
+  oonf_class_add(&_cursor_class);
+  oonf_class_add(&_snapshot_class);
+  list_init_head(&_cursor_list);
   oonf_telnet_add(&_telnet_commands[0]);
   return 0;
 }
@@ -184,7 +322,29 @@ _init(void) {
  */
 static void
 _cleanup(void) {
+  struct _netjson_cursor *cursor, *it;
+  size_t i, j, k;
+
+  /* stop all streamed outputs */
+  list_for_each_element_safe(&_cursor_list, cursor, _node, it) {
+    oonf_telnet_stop(cursor->telnet, false);
+  }
+
+  /* free snapshot cache */
+  for (i = 0; i < ARRAYSIZE(_snapshots); i++) {
+    for (j = 0; j < ARRAYSIZE(_snapshots[i]); j++) {
+      for (k = 0; k < ARRAYSIZE(_snapshots[i][j]); k++) {
+        if (_snapshots[i][j][k]) {
+          _unref_snapshot(_snapshots[i][j][k]);
+          _snapshots[i][j][k] = NULL;
+        }
+      }
+    }
+  }
+
   oonf_telnet_remove(&_telnet_commands[0]);
+  oonf_class_remove(&_snapshot_class);
+  oonf_class_remove(&_cursor_class);
 }
 
 /**
@@ -566,7 +726,218 @@ _print_graph_edge(struct json_session *session, struct nhdp_domain *domain, cons
 }
 
 /**
- * Print the JSON graph object
+ * Calculate a fingerprint of the local NHDP links, their status and
+ * metrics. Not all metric changes trigger a routing update, but the
+ * NHDP database is small compared to the topology database.
+ * @return fingerprint of NHDP database
+ */
+static uint32_t
+_get_nhdp_fingerprint(void) {
+  struct nhdp_link *lnk;
+  struct nhdp_domain *domain;
+  uint32_t hash;
+
+  hash = 0;
+  list_for_each_element(nhdp_db_get_link_list(), lnk, _global_node) {
+    hash = hash * 31 + netaddr_hash_calculate(&lnk->if_addr);
+    hash = hash * 31 + lnk->status;
+
+    list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+      hash = hash * 31 + nhdp_domain_get_linkdata(domain, lnk)->metric.in;
+      hash = hash * 31 + nhdp_domain_get_linkdata(domain, lnk)->metric.out;
+    }
+  }
+  return hash;
+}
+
+/**
+ * Get the version of the databases the netjson output is based on
+ * @param version target buffer for version
+ * @param domain nhdp domain, NULL for all domains
+ */
+static void
+_get_version(struct _netjson_version *version, struct nhdp_domain *domain) {
+  struct nhdp_domain *d;
+
+  memset(version, 0, sizeof(*version));
+  memcpy(&version->originator_v4, olsrv2_originator_get(AF_INET), sizeof(struct netaddr));
+  memcpy(&version->originator_v6, olsrv2_originator_get(AF_INET6), sizeof(struct netaddr));
+  version->nhdp = _get_nhdp_fingerprint();
+  version->ansn = olsrv2_routing_get_ansn();
+
+  if (domain) {
+    version->routing = olsrv2_routing_get_topology_generation(domain);
+    return;
+  }
+
+  list_for_each_element(nhdp_domain_get_list(), d, _node) {
+    version->routing += olsrv2_routing_get_topology_generation(d);
+  }
+}
+
+/**
+ * @param cursor netjson cursor
+ * @return pointer to cache slot for the snapshot of the current topology
+ */
+static struct _netjson_snapshot **
+_get_snapshot_slot(struct _netjson_cursor *cursor) {
+  return &_snapshots[cursor->route ? 1 : 0][cursor->domain->index]
+                    [cursor->af_type == AF_INET ? 0 : 1];
+}
+
+/**
+ * Release a reference to a netjson snapshot
+ * @param snapshot netjson snapshot
+ */
+static void
+_unref_snapshot(struct _netjson_snapshot *snapshot) {
+  if (snapshot->refcount > 1) {
+    snapshot->refcount--;
+    return;
+  }
+  abuf_free(&snapshot->json);
+  oonf_class_free(&_snapshot_class, snapshot);
+}
+
+/**
+ * Create a new (empty) netjson snapshot
+ * @param version version of the databases the snapshot will be generated from
+ * @return new snapshot, NULL if out of memory
+ */
+static struct _netjson_snapshot *
+_create_snapshot(const struct _netjson_version *version) {
+  struct _netjson_snapshot *snapshot;
+
+  snapshot = oonf_class_malloc(&_snapshot_class);
+  if (snapshot == NULL) {
+    return NULL;
+  }
+  if (abuf_init(&snapshot->json)) {
+    oonf_class_free(&_snapshot_class, snapshot);
+    return NULL;
+  }
+
+  memcpy(&snapshot->version, version, sizeof(*version));
+  snapshot->refcount = 1;
+  return snapshot;
+}
+
+/**
+ * Put a completely generated snapshot into the cache, unless the
+ * topology changed while it was generated.
+ * @param cursor netjson cursor
+ */
+static void
+_finish_snapshot(struct _netjson_cursor *cursor) {
+  struct _netjson_snapshot **slot;
+  struct _netjson_version version;
+
+  _get_version(&version, cursor->domain);
+  if (abuf_has_failed(&cursor->snapshot->json)
+      || memcmp(&cursor->snapshot->version, &version, sizeof(version)) != 0) {
+    return;
+  }
+
+  slot = _get_snapshot_slot(cursor);
+  if (*slot) {
+    _unref_snapshot(*slot);
+  }
+  *slot = cursor->snapshot;
+  cursor->snapshot->refcount++;
+}
+
+/**
+ * Start the output of the current topology object, either from a
+ * cached snapshot or by generating a new one. The object is generated
+ * in one pass, so it is consistent even if the databases change while
+ * it is streamed to the client.
+ * @param cursor netjson cursor
+ */
+static void
+_start_topology(struct _netjson_cursor *cursor) {
+  struct _netjson_snapshot *snapshot;
+  struct _netjson_version version;
+  struct json_session object;
+
+  _get_version(&version, cursor->domain);
+
+  snapshot = *_get_snapshot_slot(cursor);
+  if (snapshot != NULL && memcmp(&snapshot->version, &version, sizeof(version)) == 0) {
+    /* topology did not change, use cached output */
+    snapshot->refcount++;
+    cursor->snapshot = snapshot;
+  }
+  else {
+    snapshot = _create_snapshot(&version);
+    if (snapshot == NULL) {
+      /* skip topology */
+      _next_topology(cursor);
+      return;
+    }
+
+    json_init_session(&object, &snapshot->json);
+    if (cursor->route) {
+      _print_routing_tree(&object, cursor->domain, cursor->af_type);
+    }
+    else {
+      _print_graph(&object, cursor->domain, cursor->af_type);
+    }
+
+    cursor->snapshot = snapshot;
+    _finish_snapshot(cursor);
+  }
+
+  cursor->offset = 0;
+  cursor->step = NETJSON_STEP_SNAPSHOT;
+
+  /* the snapshot does not know its position in the json session */
+  if (!cursor->session.empty) {
+    abuf_puts(cursor->session.out, ",");
+  }
+  cursor->session.empty = false;
+}
+
+/**
+ * Copy the generated part of the current snapshot into the output buffer,
+ * for streamed output not more than the remaining share of the buffer.
+ * @param cursor netjson cursor
+ * @return true if the whole snapshot has been copied
+ */
+static bool
+_copy_snapshot(struct _netjson_cursor *cursor) {
+  struct autobuf *json;
+  size_t len, used;
+
+  json = &cursor->snapshot->json;
+  len = abuf_getlen(json) - cursor->offset;
+
+  if (cursor->streaming) {
+    used = abuf_getlen(cursor->session.out);
+    if (used >= OONF_TELNET_STREAM_CHUNK) {
+      len = 0;
+    }
+    else if (len > OONF_TELNET_STREAM_CHUNK - used) {
+      len = OONF_TELNET_STREAM_CHUNK - used;
+    }
+  }
+
+  abuf_memcpy(cursor->session.out, abuf_getptr(json) + cursor->offset, len);
+  cursor->offset += len;
+  return cursor->offset == abuf_getlen(json);
+}
+
+/**
+ * Check if a streamed output has filled its share of the output buffer
+ * @param cursor netjson cursor
+ * @return true if the output should be suspended
+ */
+static bool
+_is_output_full(struct _netjson_cursor *cursor) {
+  return cursor->streaming && abuf_getlen(cursor->session.out) >= OONF_TELNET_STREAM_CHUNK;
+}
+
+/**
+ * Print the JSON graph object of a topology
  * @param session json session
  * @param domain NHDP domain
  * @param af_type address family type
@@ -589,9 +960,6 @@ _print_graph(struct json_session *session, struct nhdp_domain *domain, int af_ty
   bool outgoing;
 
   originator = olsrv2_originator_get(af_type);
-  if (netaddr_is_unspec(originator)) {
-    return;
-  }
 
   /* get "other" originator */
   other_af = _get_other_af_type(af_type);
@@ -737,27 +1105,7 @@ _print_graph(struct json_session *session, struct nhdp_domain *domain, int af_ty
 }
 
 /**
- * Print all JSON graph objects
- * @param session json session
- * @param filter domain filter
- */
-static void
-_create_graph_json(struct json_session *session, const char *filter) {
-  struct nhdp_domain *domain;
-  struct domain_id_str dbuf;
-
-  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-    if (filter == NULL || strcmp(_create_domain_id(&dbuf, domain, AF_INET), filter) == 0) {
-      _print_graph(session, domain, AF_INET);
-    }
-    if (filter == NULL || strcmp(_create_domain_id(&dbuf, domain, AF_INET6), filter) == 0) {
-      _print_graph(session, domain, AF_INET6);
-    }
-  }
-}
-
-/**
- * Print the JSON routing tree
+ * Print the JSON routing tree of a topology
  * @param session json session
  * @param domain NHDP domain
  * @param af_type address family
@@ -765,17 +1113,11 @@ _create_graph_json(struct json_session *session, const char *filter) {
 static void
 _print_routing_tree(struct json_session *session, struct nhdp_domain *domain, int af_type) {
   struct olsrv2_routing_entry *rtentry;
-  const struct netaddr *originator;
   char ibuf[IF_NAMESIZE];
   struct nhdp_metric_str mbuf;
   struct domain_id_str dbuf;
   struct _node_id_str idbuf;
 
-  originator = olsrv2_originator_get(af_type);
-  if (netaddr_get_address_family(originator) != af_type) {
-    return;
-  }
-
   json_start_object(session, NULL);
 
   _print_json_string(session, "type", "NetworkRoutes");
@@ -789,7 +1131,7 @@ _print_routing_tree(struct json_session *session, struct nhdp_domain *domain, in
   _print_json_string(session, "topology_id", _create_domain_id(&dbuf, domain, af_type));
 
   json_start_object(session, "properties");
-  _print_json_netaddr(session, "router_addr", originator);
+  _print_json_netaddr(session, "router_addr", olsrv2_originator_get(af_type));
   json_end_object(session);
 
   json_start_array(session, JSON_NAME_ROUTE);
@@ -835,26 +1177,6 @@ _print_routing_tree(struct json_session *session, struct nhdp_domain *domain, in
   json_end_object(session);
 }
 
-/**
- * Print all JSON routes
- * @param session json session
- * @param filter filter value to select domain
- */
-static void
-_create_route_json(struct json_session *session, const char *filter) {
-  struct nhdp_domain *domain;
-  struct domain_id_str dbuf;
-
-  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-    if (filter == NULL || strcmp(_create_domain_id(&dbuf, domain, AF_INET), filter) == 0) {
-      _print_routing_tree(session, domain, AF_INET);
-    }
-    if (filter == NULL || strcmp(_create_domain_id(&dbuf, domain, AF_INET6), filter) == 0) {
-      _print_routing_tree(session, domain, AF_INET6);
-    }
-  }
-}
-
 static void
 _create_domain_json(struct json_session *session) {
   const struct netaddr *originator_v4, *originator_v6;
@@ -927,90 +1249,248 @@ _create_error_json(struct json_session *session, const char *message, const char
   json_end_object(session);
 }
 
-static const char *
-_handle_netjson_object(struct json_session *session, const char *parameter, bool filter, bool *error) {
+/**
+ * Select the next topology (domain and address family) of the current
+ * graph/route object that matches its filter.
+ * @param cursor netjson cursor
+ */
+static void
+_next_topology(struct _netjson_cursor *cursor) {
+  struct nhdp_domain *domain;
+  struct domain_id_str dbuf;
+  int topology, af_type, i;
+
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    for (i = 0; i < 2; i++) {
+      topology = domain->index * 2 + i;
+      af_type = i == 0 ? AF_INET : AF_INET6;
+
+      if (topology <= cursor->topology) {
+        continue;
+      }
+      if (cursor->topology_filter != NULL
+          && strcmp(_create_domain_id(&dbuf, domain, af_type), cursor->topology_filter) != 0) {
+        continue;
+      }
+      if (netaddr_is_unspec(olsrv2_originator_get(af_type))) {
+        continue;
+      }
+
+      cursor->topology = topology;
+      cursor->domain = domain;
+      cursor->af_type = af_type;
+      cursor->step = NETJSON_STEP_TOPOLOGY;
+      return;
+    }
+  }
+
+  /* object is complete */
+  cursor->step = NETJSON_STEP_OBJECT;
+}
+
+/**
+ * Parse the next sub-command of the netjsoninfo parameters
+ * @param cursor netjson cursor
+ */
+static void
+_parse_next_object(struct _netjson_cursor *cursor) {
   const char *ptr;
 
-  if ((ptr = str_hasnextword(parameter, JSON_NAME_GRAPH))) {
-    _create_graph_json(session, filter ? ptr : NULL);
+  if (cursor->next == NULL || *cursor->next == 0) {
+    cursor->step = NETJSON_STEP_END;
+    return;
+  }
+
+  if ((ptr = str_hasnextword(cursor->next, JSON_NAME_GRAPH))) {
+    cursor->route = false;
   }
-  else if ((ptr = str_hasnextword(parameter, JSON_NAME_ROUTE))) {
-    _create_route_json(session, filter ? ptr : NULL);
+  else if ((ptr = str_hasnextword(cursor->next, JSON_NAME_ROUTE))) {
+    cursor->route = true;
   }
-  else if (!filter && (ptr = str_hasnextword(parameter, JSON_NAME_DOMAIN))) {
-    _create_domain_json(session);
+  else if (!cursor->filter && (ptr = str_hasnextword(cursor->next, JSON_NAME_DOMAIN))) {
+    cursor->next = ptr;
+    cursor->step = NETJSON_STEP_DOMAIN;
+    return;
   }
   else {
-    ptr = str_skipnextword(parameter);
-    *error = true;
+    cursor->next = cursor->filter ? NULL : str_skipnextword(cursor->next);
+    cursor->error = true;
+    return;
   }
-  return ptr;
+
+  /* the filter prefix only has a single object followed by the domain id */
+  cursor->topology_filter = cursor->filter ? ptr : NULL;
+  cursor->next = cursor->filter ? NULL : ptr;
+  cursor->topology = -1;
+  _next_topology(cursor);
 }
 
+/**
+ * Generate the output of a single step of the netjsoninfo command
+ * or a part of it if the output buffer is full.
+ * @param cursor netjson cursor
+ */
 static void
-_handle_filter(struct json_session *session, const char *parameter) {
-  bool error = false;
+_print_step(struct _netjson_cursor *cursor) {
+  struct json_session *session;
+
+  session = &cursor->session;
 
-  _handle_netjson_object(session, parameter, true, &error);
-  if (error) {
-    _create_error_json(session, "Could not parse sub-command for netjsoninfo", parameter);
+  switch (cursor->step) {
+    case NETJSON_STEP_START:
+      if (!cursor->filter) {
+        json_start_object(session, NULL);
+        _print_json_string(session, "type", "NetworkCollection");
+        json_start_array(session, "collection");
+      }
+      cursor->step = NETJSON_STEP_OBJECT;
+      break;
+    case NETJSON_STEP_OBJECT:
+      _parse_next_object(cursor);
+      break;
+    case NETJSON_STEP_TOPOLOGY:
+      _start_topology(cursor);
+      break;
+    case NETJSON_STEP_SNAPSHOT:
+      if (_copy_snapshot(cursor)) {
+        _unref_snapshot(cursor->snapshot);
+        cursor->snapshot = NULL;
+        _next_topology(cursor);
+      }
+      break;
+    case NETJSON_STEP_DOMAIN:
+      _create_domain_json(session);
+      cursor->step = NETJSON_STEP_OBJECT;
+      break;
+    case NETJSON_STEP_END:
+      if (cursor->error) {
+        _create_error_json(session, "Could not parse sub-command for netjsoninfo", cursor->parameter);
+      }
+      if (!cursor->filter) {
+        json_end_array(session);
+        json_end_object(session);
+      }
+      cursor->step = NETJSON_STEP_DONE;
+      break;
+    case NETJSON_STEP_DONE:
+    default:
+      break;
   }
 }
 
-static void
-_handle_collection(struct json_session *session, const char *parameter) {
-  const char *next;
-  bool error;
-
-  json_start_object(session, NULL);
-  _print_json_string(session, "type", "NetworkCollection");
-  json_start_array(session, "collection");
-
-  error = 0;
-  next = parameter;
-  while (next && *next) {
-    next = _handle_netjson_object(session, next, false, &error);
+/**
+ * Generate netjsoninfo output until the command is complete
+ * or the output buffer of a streamed command is full.
+ * @param cursor netjson cursor
+ * @return true if output is complete, false otherwise
+ */
+static bool
+_print_cursor(struct _netjson_cursor *cursor) {
+  while (cursor->step != NETJSON_STEP_DONE) {
+    if (abuf_has_failed(cursor->session.out)) {
+      /* output cannot be completed anymore */
+      return true;
+    }
+    if (_is_output_full(cursor)) {
+      return false;
+    }
+    _print_step(cursor);
   }
+  return true;
+}
 
-  if (error) {
-    _create_error_json(session, "Could not parse sub-command for netjsoninfo", parameter);
+/**
+ * Free a netjson cursor
+ * @param cursor netjson cursor
+ */
+static void
+_free_cursor(struct _netjson_cursor *cursor) {
+  if (cursor->telnet) {
+    list_remove(&cursor->_node);
   }
+  if (cursor->snapshot) {
+    _unref_snapshot(cursor->snapshot);
+  }
+  free(cursor->parameter);
+  oonf_class_free(&_cursor_class, cursor);
+}
 
-  json_end_array(session);
-  json_end_object(session);
+/**
+ * Stop handler for a streamed netjsoninfo output
+ * @param con telnet connection
+ */
+static void
+_cb_stop_streaming(struct oonf_telnet_data *con) {
+  _free_cursor(con->stop_data[0]);
+  con->stop_data[0] = NULL;
+}
+
+/**
+ * Generate the next part of a streamed netjsoninfo output
+ * @param con telnet connection
+ * @return true if output is complete, false otherwise
+ */
+static bool
+_cb_underrun_streaming(struct oonf_telnet_data *con) {
+  return _print_cursor(con->stop_data[0]);
 }
 
 /**
  * Callback for netjsoninfo telnet command
  * @param con telnet connection
- * @return active or internal_error
+ * @return active, continous or internal_error
  */
 static enum oonf_telnet_result
 _cb_netjsoninfo(struct oonf_telnet_data *con) {
-  struct json_session session;
-  struct autobuf out;
-  const char *ptr, *next;
+  struct _netjson_version version;
+  struct _netjson_cursor *cursor;
+  const char *parameter, *ptr;
+
+  parameter = con->parameter;
+  if (parameter == NULL || *parameter == 0) {
+    return TELNET_RESULT_ACTIVE;
+  }
+
+  /* the output only changes with the databases it is generated from */
+  _get_version(&version, NULL);
+  snprintf(con->output_version, sizeof(con->output_version), "%08x-%04x-%08x-%08x", version.nhdp, version.ansn,
+    version.routing, netaddr_hash_calculate(&version.originator_v4) ^ netaddr_hash_calculate(&version.originator_v6));
+
+  cursor = oonf_class_malloc(&_cursor_class);
+  if (cursor == NULL) {
+    return TELNET_RESULT_INTERNAL_ERROR;
+  }
+
+  if ((ptr = str_hasnextword(parameter, JSON_NAME_FILTER))) {
+    cursor->filter = true;
+    parameter = ptr;
+  }
 
-  if (abuf_init(&out)) {
+  /* the parameters will not stay valid while output is streamed */
+  cursor->parameter = strdup(parameter);
+  if (cursor->parameter == NULL) {
+    oonf_class_free(&_cursor_class, cursor);
     return TELNET_RESULT_INTERNAL_ERROR;
   }
 
-  json_init_session(&session, &out);
+  json_init_session(&cursor->session, con->out);
+  cursor->next = cursor->parameter;
+  cursor->streaming = con->allow_streaming;
+  cursor->step = NETJSON_STEP_START;
 
-  next = con->parameter;
-  if (next && *next) {
-    if ((ptr = str_hasnextword(next, JSON_NAME_FILTER))) {
-      _handle_filter(&session, ptr);
-    }
-    else {
-      _handle_collection(&session, next);
-    }
+  if (_print_cursor(cursor)) {
+    _free_cursor(cursor);
+    return TELNET_RESULT_ACTIVE;
   }
 
-  /* copy output into telnet buffer */
-  abuf_memcpy(con->out, abuf_getptr(&out), abuf_getlen(&out));
-  abuf_free(&out);
-  return TELNET_RESULT_ACTIVE;
+  /* continue output each time the session has sent its buffer */
+  cursor->telnet = con;
+  list_add_tail(&_cursor_list, &cursor->_node);
+
+  con->stop_handler = _cb_stop_streaming;
+  con->stop_data[0] = cursor;
+  con->underrun_handler = _cb_underrun_streaming;
+  return TELNET_RESULT_CONTINOUS;
 }
 
 /**
@@ -64,6 +64,7 @@
 #include <oonf/olsrv2/olsrv2/olsrv2_lan.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_originator.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_reader.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_routing.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_writer.h>
 
@@ -116,6 +117,9 @@ struct _config {
   /*! decides NHDP routable status */
   bool nhdp_routable;
 
+  /*! maximum percentage of changed tc nodes repaired by incremental dijkstra */
+  int32_t spf_incremental_limit;
+
   /*! IP filter for routable addresses */
   struct netaddr_acl routable_acl;
 
@@ -187,6 +191,10 @@ static struct cfg_schema_entry _olsrv2_entries[] = {
     "Decides if NHDP interface addresses"
     " are routed to other nodes. 'true' means the 'routable_acl' parameter"
     " will be matched to the addresses to decide."),
+  CFG_MAP_INT32_MINMAX(_config, spf_incremental_limit, "spf_incremental_limit", "25",
+    "Maximum percentage of changed and affected topology nodes that is repaired by an incremental"
+    " dijkstra run instead of a full one, 0 disables incremental runs.",
+    0, 0, 100),
   CFG_MAP_ACL_V46(_config, routable_acl, "routable_acl", OLSRV2_ROUTABLE_IPV4 OLSRV2_ROUTABLE_IPV6 ACL_DEFAULT_ACCEPT,
     "Filter to decide which addresses are considered routable"),
   CFG_MAP_ACL_V46(_config, originator_acl, "originator",
@@ -704,9 +712,15 @@ _cb_cfg_olsrv2_changed(void) {
     oonf_timer_set(&_tc_timer, _olsrv2_config.tc_interval);
   }
 
+  /* set limit for incremental dijkstra */
+  olsrv2_routing_set_incremental_limit(_olsrv2_config.spf_incremental_limit);
+
   /* check if we have to change the originators */
   _update_originator(AF_INET);
   _update_originator(AF_INET6);
+
+  /* TC intervals and routable filters might have changed */
+  olsrv2_writer_content_changed();
 }
 
 /**
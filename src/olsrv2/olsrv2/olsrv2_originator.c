@@ -57,6 +57,7 @@
 
 #include <oonf/olsrv2/olsrv2/olsrv2.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_originator.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_writer.h>
 
 /* prototypes */
 static struct olsrv2_originator_set_entry *_remember_removed_originator(struct netaddr *originator, uint64_t vtime);
@@ -220,6 +221,7 @@ _set_originator(int af_type, struct netaddr *setting, const struct netaddr *new_
   }
 
   memcpy(setting, new_originator, sizeof(*setting));
+  olsrv2_writer_content_changed();
 
   /* remove new_originator originator from set */
   entry = olsrv2_originator_get_entry(new_originator);
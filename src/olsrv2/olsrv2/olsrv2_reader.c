@@ -102,6 +102,9 @@ struct _olsrv2_data {
 
   /*! true if a change happened for this domain */
   bool changed[NHDP_MAXIMUM_DOMAINS];
+
+  /*! true if the outgoing edges of the node changed */
+  bool edges_changed;
 };
 
 /* Prototypes */
@@ -348,9 +351,11 @@ _cb_addresstlvs(struct rfc5444_reader_tlvblock_context *context __attribute__((u
   struct olsrv2_tc_attachment *end;
   uint32_t cost_in[NHDP_MAXIMUM_DOMAINS];
   uint32_t cost_out[NHDP_MAXIMUM_DOMAINS];
+  uint32_t cost_old[NHDP_MAXIMUM_DOMAINS];
   struct rfc7181_metric_field metric_value;
   size_t i;
   struct os_route_key ssprefix;
+  bool new_edge;
 
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str buf;
@@ -363,6 +368,7 @@ _cb_addresstlvs(struct rfc5444_reader_tlvblock_context *context __attribute__((u
   for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
     cost_in[i] = RFC7181_METRIC_INFINITE;
     cost_out[i] = RFC7181_METRIC_INFINITE;
+    cost_old[i] = RFC7181_METRIC_INFINITE;
   }
 
   OONF_DEBUG(LOG_OLSRV2_R, "Found address in tc: %s", netaddr_to_string(&buf, &context->addr));
@@ -393,6 +399,13 @@ _cb_addresstlvs(struct rfc5444_reader_tlvblock_context *context __attribute__((u
   if ((tlv = _olsrv2_address_tlvs[IDX_ADDRTLV_NBR_ADDR_TYPE].tlv)) {
     /* parse originator neighbor */
     if ((tlv->single_value[0] & RFC7181_NBR_ADDR_TYPE_ORIGINATOR) != 0) {
+      /* remember old edge state, adding the edge resets its costs */
+      edge = avl_find_element(&_current.node->_edges, &context->addr, edge, _node);
+      new_edge = edge == NULL || edge->virtual;
+      if (edge) {
+        memcpy(cost_old, edge->cost, sizeof(cost_old));
+      }
+
       edge = olsrv2_tc_edge_add(_current.node, &context->addr);
       if (edge) {
         OONF_DEBUG(LOG_OLSRV2_R, "Address is originator");
@@ -416,12 +429,22 @@ _cb_addresstlvs(struct rfc5444_reader_tlvblock_context *context __attribute__((u
             edge->inverse->cost[i] = RFC7181_METRIC_INFINITE;
           }
         }
+
+        if (new_edge || memcmp(cost_old, edge->cost, sizeof(cost_old)) != 0) {
+          /* shortest path tree must be repaired behind this node */
+          _current.edges_changed = true;
+
+          /* report new costs when the TC is finished */
+          edge->_changed = true;
+        }
       }
     }
     /* parse routable neighbor (which is not an originator) */
     else if ((tlv->single_value[0] & RFC7181_NBR_ADDR_TYPE_ROUTABLE) != 0) {
       end = olsrv2_tc_endpoint_add(_current.node, &ssprefix, true);
       if (end) {
+        memcpy(cost_old, end->cost, sizeof(cost_old));
+
         OONF_DEBUG(LOG_OLSRV2_R, "Address is routable, but not originator");
         end->ansn = _current.node->ansn;
         for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
@@ -434,6 +457,9 @@ _cb_addresstlvs(struct rfc5444_reader_tlvblock_context *context __attribute__((u
             end->cost[i] = RFC7181_METRIC_INFINITE;
           }
         }
+
+        /* report new costs when the TC is finished */
+        end->_changed |= memcmp(cost_old, end->cost, sizeof(cost_old)) != 0;
       }
     }
   }
@@ -449,6 +475,8 @@ _handle_gateways(struct rfc5444_reader_tlvblock_entry *tlv, struct os_route_key
   const struct netaddr *addr) {
   struct olsrv2_tc_attachment *end;
   struct nhdp_domain *domain;
+  uint32_t cost_old[NHDP_MAXIMUM_DOMAINS];
+  uint8_t distance_old[NHDP_MAXIMUM_DOMAINS];
   size_t i;
 
   /* check length */
@@ -488,6 +516,9 @@ _handle_gateways(struct rfc5444_reader_tlvblock_entry *tlv, struct os_route_key
 
   end->ansn = _current.node->ansn;
 
+  memcpy(cost_old, end->cost, sizeof(cost_old));
+  memcpy(distance_old, end->distance, sizeof(distance_old));
+
   if (_current.complete_tc) {
     /* clear unused metrics */
     for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
@@ -515,6 +546,10 @@ _handle_gateways(struct rfc5444_reader_tlvblock_entry *tlv, struct os_route_key
     OONF_DEBUG(
       LOG_OLSRV2_R, "Address is Attached Network (domain %u): dist=%u", domain->ext, end->distance[domain->index]);
   }
+
+  /* report new costs and distances when the TC is finished */
+  end->_changed |= memcmp(cost_old, end->cost, sizeof(cost_old)) != 0
+                   || memcmp(distance_old, end->distance, sizeof(distance_old)) != 0;
 }
 
 /**
@@ -568,6 +603,10 @@ _cb_messagetlvs_end(struct rfc5444_reader_tlvblock_context *context __attribute_
     }
   }
 
+  if (_current.edges_changed) {
+    olsrv2_routing_dijkstra_node_changed(&_current.node->target._dijkstra);
+  }
+
   olsrv2_tc_trigger_change(_current.node);
   _current.node = NULL;
 
@@ -47,6 +47,7 @@
 
 #include <oonf/libcommon/avl.h>
 #include <oonf/libcommon/avl_comp.h>
+#include <oonf/libcommon/heap.h>
 #include <oonf/oonf.h>
 #include <oonf/libcommon/list.h>
 #include <oonf/libcommon/netaddr.h>
@@ -67,23 +68,50 @@
 #include <oonf/olsrv2/olsrv2/olsrv2_originator.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_routing.h>
 #include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_writer.h>
+
+/*! state of a node during incremental shortest path tree repair */
+enum _spt_repair_state
+{
+  /*! state not yet known, depends on parent */
+  _SPT_UNKNOWN,
+
+  /*! path to node is still valid */
+  _SPT_CLEAN,
+
+  /*! path to node must be recalculated */
+  _SPT_AFFECTED,
+};
 
 /* Prototypes */
+static void _run_full_dijkstra(struct nhdp_domain *domain, bool splitv4, bool splitv6);
+static bool _run_incremental_dijkstra(struct nhdp_domain *domain);
 static void _run_dijkstra(struct nhdp_domain *domain, int af_family, bool use_non_ss, bool use_ss);
 static struct olsrv2_routing_entry *_add_entry(struct nhdp_domain *, struct os_route_key *prefix);
 static void _remove_entry(struct olsrv2_routing_entry *);
 static void _insert_into_working_tree(struct olsrv2_tc_target *target, struct nhdp_neighbor *neigh, uint32_t linkcost,
-  uint32_t path_cost, uint8_t path_hops, uint8_t distance, bool single_hop, const struct netaddr *last_originator);
+  uint32_t path_cost, uint8_t path_hops, uint8_t distance, bool single_hop, const struct netaddr *last_originator,
+  struct olsrv2_dijkstra_node *parent);
+static void _update_routing_entry(struct nhdp_domain *domain, struct os_route_key *dst_prefix,
+  const struct netaddr *dst_originator, struct nhdp_neighbor *first_hop, uint8_t distance, uint32_t pathcost,
+  uint8_t path_hops, bool single_hop, const struct netaddr *last_originator);
 static void _prepare_routes(struct nhdp_domain *);
 static void _prepare_nodes(void);
+static void _prepare_endpoints(void);
 static bool _check_ssnode_split(struct nhdp_domain *domain, int af_family);
+static bool _is_one_hop_link_worse(struct nhdp_domain *domain, struct olsrv2_tc_node *node);
+static bool _is_tree_edge_worse(struct nhdp_domain *domain, struct olsrv2_tc_node *node);
 static void _add_one_hop_nodes(struct nhdp_domain *domain, int family, bool, bool);
+static void _add_incoming_edges(struct nhdp_domain *domain, struct olsrv2_tc_node *tc_node);
+static void _add_outgoing_edges(struct nhdp_domain *domain, struct olsrv2_tc_node *tc_node, bool use_non_ss);
+static void _add_attachments(struct nhdp_domain *domain, struct olsrv2_tc_node *tc_node, bool use_non_ss, bool use_ss);
 static void _handle_working_queue(struct nhdp_domain *, bool, bool);
 static void _handle_nhdp_routes(struct nhdp_domain *);
 static void _add_route_to_kernel_queue(struct olsrv2_routing_entry *rtentry);
 static void _process_dijkstra_result(struct nhdp_domain *);
 static void _process_kernel_queue(void);
 
+static void _mark_domain_changed(struct nhdp_domain *);
 static void _cb_mpr_update(struct nhdp_domain *);
 static void _cb_metric_update(struct nhdp_domain *);
 static void _cb_trigger_dijkstra(struct oonf_timer_instance *);
@@ -118,18 +146,24 @@ static struct nhdp_domain_listener _nhdp_listener = {
 /* status variables for domain changes */
 static uint16_t _ansn;
 static bool _domain_changed[NHDP_MAXIMUM_DOMAINS];
+static uint32_t _topology_generation[NHDP_MAXIMUM_DOMAINS];
 static bool _update_ansn;
 
 /* global datastructures for routing */
 static struct avl_tree _routing_tree[NHDP_MAXIMUM_DOMAINS];
 static struct list_entity _routing_filter_list;
 
-static struct avl_tree _dijkstra_working_tree;
+static struct heap _dijkstra_working_queue;
 static struct list_entity _kernel_queue;
 
 static bool _initiate_shutdown = false;
 static bool _freeze_routes = false;
 
+/* state of incremental shortest path tree repair */
+static bool _spt_valid = false;
+static int32_t _incremental_limit = 25;
+static struct olsrv2_routing_statistics _statistics;
+
 /**
  * Initialize olsrv2 dijkstra and routing code
  */
@@ -153,7 +187,7 @@ olsrv2_routing_init(void) {
     avl_init(&_routing_tree[i], os_routing_avl_cmp_route_key, false);
   }
   list_init_head(&_routing_filter_list);
-  avl_init(&_dijkstra_working_tree, avl_comp_uint32, true);
+  heap_init(&_dijkstra_working_queue);
   list_init_head(&_kernel_queue);
 
   return 0;
@@ -212,6 +246,8 @@ olsrv2_routing_cleanup(void) {
     olsrv2_routing_filter_remove(filter);
   }
 
+  heap_free(&_dijkstra_working_queue);
+
   oonf_timer_remove(&_dijkstra_timer_info);
   oonf_class_remove(&_rtset_entry);
 }
@@ -224,6 +260,19 @@ olsrv2_routing_get_ansn(void) {
   return _ansn;
 }
 
+/**
+ * The generation counter changes each time the topology of a domain
+ * has been marked as changed and each time its routing tree has been
+ * recalculated. It allows to cache information derived from the
+ * topology and routing databases.
+ * @param domain nhdp domain
+ * @return current topology generation of the domain
+ */
+uint32_t
+olsrv2_routing_get_topology_generation(struct nhdp_domain *domain) {
+  return _topology_generation[domain->index];
+}
+
 /**
  * Force the answer set number to increase
  * @param increment amount of increase
@@ -231,6 +280,7 @@ olsrv2_routing_get_ansn(void) {
 void
 olsrv2_routing_force_ansn_increment(uint16_t increment) {
   _ansn += increment;
+  olsrv2_writer_content_changed();
 }
 
 /**
@@ -283,8 +333,11 @@ olsrv2_routing_get_parameters(struct nhdp_domain *domain) {
 void
 olsrv2_routing_domain_changed(struct nhdp_domain *domain, bool autoupdate_ansn) {
   _update_ansn |= autoupdate_ansn;
+  if (autoupdate_ansn) {
+    olsrv2_writer_content_changed();
+  }
   if (domain) {
-    _domain_changed[domain->index] = true;
+    _mark_domain_changed(domain);
 
     olsrv2_routing_trigger_update();
     return;
@@ -324,6 +377,7 @@ olsrv2_routing_force_update(bool skip_wait) {
   if (_update_ansn) {
     _ansn++;
     _update_ansn = false;
+    olsrv2_writer_content_changed();
     OONF_DEBUG(LOG_OLSRV2_ROUTING, "Update ANSN to %u", _ansn);
   }
 
@@ -337,29 +391,13 @@ olsrv2_routing_force_update(bool skip_wait) {
     }
     _domain_changed[domain->index] = false;
 
-    /* initialize dijkstra specific fields */
-    _prepare_routes(domain);
-    _prepare_nodes();
-
-    /* run IPv4 dijkstra (might be two times because of source-specific data) */
+    /* check if source-specific nodes need their own dijkstra run */
     splitv4 = _check_ssnode_split(domain, AF_INET);
-    _run_dijkstra(domain, AF_INET, true, !splitv4);
-
-    /* run IPv6 dijkstra (might be two times because of source-specific data) */
     splitv6 = _check_ssnode_split(domain, AF_INET6);
-    _run_dijkstra(domain, AF_INET6, true, !splitv6);
 
-    /* handle source-specific sub-topology if necessary */
-    if (splitv4 || splitv6) {
-      /* re-initialize dijkstra specific node fields */
-      _prepare_nodes();
-
-      if (splitv4) {
-        _run_dijkstra(domain, AF_INET, false, true);
-      }
-      if (splitv6) {
-        _run_dijkstra(domain, AF_INET6, false, true);
-      }
+    /* repair the last shortest path tree if possible, recalculate it otherwise */
+    if (splitv4 || splitv6 || !_run_incremental_dijkstra(domain)) {
+      _run_full_dijkstra(domain, splitv4, splitv6);
     }
 
     /* check if direct one-hop routes are quicker */
@@ -367,6 +405,9 @@ olsrv2_routing_force_update(bool skip_wait) {
 
     /* update kernel routes */
     _process_dijkstra_result(domain);
+
+    /* routing tree might have changed */
+    _topology_generation[domain->index]++;
   }
 
   _process_kernel_queue();
@@ -382,8 +423,41 @@ olsrv2_routing_force_update(bool skip_wait) {
  */
 void
 olsrv2_routing_dijkstra_node_init(struct olsrv2_dijkstra_node *dijkstra, const struct netaddr *originator) {
-  dijkstra->_node.key = &dijkstra->path_cost;
   dijkstra->originator = originator;
+  dijkstra->path_cost = RFC7181_METRIC_INFINITE_PATH;
+  dijkstra->path_hops = 255;
+}
+
+/**
+ * Mark the outgoing edges of a dijkstra node as changed, so the
+ * next incremental dijkstra run repairs the paths behind it.
+ * Should normally not be called by other parts of OLSRv2.
+ * @param dijkstra pointer to dijkstra node
+ */
+void
+olsrv2_routing_dijkstra_node_changed(struct olsrv2_dijkstra_node *dijkstra) {
+  dijkstra->changed = true;
+}
+
+/**
+ * Invalidate the current shortest path tree, the next dijkstra
+ * run will recalculate it completely. Must be called before a
+ * tc node or a nhdp neighbor referenced by the tree is removed.
+ * Should normally not be called by other parts of OLSRv2.
+ */
+void
+olsrv2_routing_dijkstra_invalidate(void) {
+  _spt_valid = false;
+}
+
+/**
+ * Set the maximum percentage of changed topology nodes that
+ * is repaired incrementally instead of a full dijkstra run
+ * @param percent percentage of tc nodes, 0 to disable incremental runs
+ */
+void
+olsrv2_routing_set_incremental_limit(int32_t percent) {
+  _incremental_limit = percent;
 }
 
 /**
@@ -448,6 +522,25 @@ olsrv2_routing_get_filter_list(void) {
   return &_routing_filter_list;
 }
 
+/**
+ * Get statistics of the shortest path calculation
+ * @return pointer to statistics
+ */
+const struct olsrv2_routing_statistics *
+olsrv2_routing_get_statistics(void) {
+  return &_statistics;
+}
+
+/**
+ * Mark a domain for the next dijkstra run
+ * @param domain nhdp domain
+ */
+static void
+_mark_domain_changed(struct nhdp_domain *domain) {
+  _domain_changed[domain->index] = true;
+  _topology_generation[domain->index]++;
+}
+
 /**
  * Callback triggered when an MPR-set changed
  * @param domain NHDP domain that changed
@@ -464,7 +557,7 @@ _cb_mpr_update(struct nhdp_domain *domain) {
   OONF_INFO(LOG_OLSRV2, "MPR update for domain %u", domain->index);
 
   _update_ansn = true;
-  _domain_changed[domain->index] = true;
+  _mark_domain_changed(domain);
   olsrv2_routing_trigger_update();
 }
 
@@ -484,10 +577,196 @@ _cb_metric_update(struct nhdp_domain *domain) {
   OONF_INFO(LOG_OLSRV2, "Metric update for domain %u", domain->index);
 
   _update_ansn = true;
-  _domain_changed[domain->index] = true;
+  _mark_domain_changed(domain);
   olsrv2_routing_trigger_update();
 }
 
+/**
+ * Calculate the complete shortest path tree of a domain
+ * @param domain nhdp domain
+ * @param splitv4 true if source-specific IPv4 nodes need their own run
+ * @param splitv6 true if source-specific IPv6 nodes need their own run
+ */
+static void
+_run_full_dijkstra(struct nhdp_domain *domain, bool splitv4, bool splitv6) {
+  /* initialize dijkstra specific fields */
+  _prepare_routes(domain);
+  _prepare_nodes();
+
+  /* run IPv4 dijkstra (might be two times because of source-specific data) */
+  _run_dijkstra(domain, AF_INET, true, !splitv4);
+
+  /* run IPv6 dijkstra (might be two times because of source-specific data) */
+  _run_dijkstra(domain, AF_INET6, true, !splitv6);
+
+  /* handle source-specific sub-topology if necessary */
+  if (splitv4 || splitv6) {
+    /* re-initialize dijkstra specific node fields */
+    _prepare_nodes();
+
+    if (splitv4) {
+      _run_dijkstra(domain, AF_INET, false, true);
+    }
+    if (splitv6) {
+      _run_dijkstra(domain, AF_INET6, false, true);
+    }
+  }
+
+  /* a single tree can only be repaired if all nodes were part of the same run */
+  _spt_valid = !splitv4 && !splitv6 && nhdp_domain_get_count() == 1;
+  _statistics.full_runs++;
+}
+
+/**
+ * Repair the shortest path tree of the last dijkstra run. Only the
+ * nodes whose path went through a changed node are recalculated, all
+ * other nodes keep their path unless the changes allow a shorter one.
+ * Only works for a single domain without a source-specific split.
+ * @param domain nhdp domain
+ * @return true if the tree was repaired, false if a full dijkstra run is necessary
+ */
+static bool
+_run_incremental_dijkstra(struct nhdp_domain *domain) {
+  struct olsrv2_tc_target *target;
+  struct olsrv2_tc_node *node;
+  struct olsrv2_dijkstra_node *dnode, *walk;
+  uint32_t node_count, changed_count, affected_count, reachable_count, processed_count;
+  enum _spt_repair_state state;
+
+  if (!_spt_valid || _incremental_limit == 0 || nhdp_domain_get_count() != 1) {
+    return false;
+  }
+
+  node_count = 0;
+  changed_count = 0;
+  affected_count = 0;
+  reachable_count = 0;
+  processed_count = 0;
+
+  /* classify nodes which can be decided without looking at their parents */
+  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+    dnode = &node->target._dijkstra;
+    if (dnode->local != olsrv2_originator_is_local(&node->target.prefix.dst)) {
+      /* originator changed, tree root is not valid anymore */
+      return false;
+    }
+
+    node_count++;
+    if (dnode->changed) {
+      changed_count++;
+    }
+
+    dnode->done = false;
+    if (dnode->path_cost == RFC7181_METRIC_INFINITE_PATH) {
+      dnode->_repair = _SPT_CLEAN;
+    }
+    else if (dnode->parent == NULL) {
+      dnode->_repair = _is_one_hop_link_worse(domain, node) ? _SPT_AFFECTED : _SPT_CLEAN;
+    }
+    else if (dnode->parent->changed && _is_tree_edge_worse(domain, node)) {
+      dnode->_repair = _SPT_AFFECTED;
+    }
+    else {
+      dnode->_repair = _SPT_UNKNOWN;
+    }
+  }
+
+  /* inherit state from the next ancestor with a known state */
+  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+    dnode = &node->target._dijkstra;
+    if (dnode->_repair == _SPT_UNKNOWN) {
+      for (walk = dnode->parent; walk->_repair == _SPT_UNKNOWN; walk = walk->parent)
+        ;
+      state = walk->_repair;
+
+      for (walk = dnode; walk->_repair == _SPT_UNKNOWN; walk = walk->parent) {
+        walk->_repair = state;
+      }
+    }
+    if (dnode->_repair == _SPT_AFFECTED) {
+      affected_count++;
+    }
+  }
+
+  if ((uint64_t)(affected_count + changed_count) * 100 > (uint64_t)node_count * (uint32_t)_incremental_limit) {
+    OONF_INFO(LOG_OLSRV2_ROUTING, "Too many changes for incremental dijkstra: %u changed, %u affected of %u nodes",
+      changed_count, affected_count, node_count);
+    _statistics.fallbacks++;
+    return false;
+  }
+
+  /* remove the paths of all affected nodes */
+  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+    dnode = &node->target._dijkstra;
+    if (dnode->_repair == _SPT_AFFECTED) {
+      dnode->path_cost = RFC7181_METRIC_INFINITE_PATH;
+      dnode->path_hops = 255;
+      dnode->first_hop = NULL;
+      dnode->parent = NULL;
+    }
+  }
+
+  /* seed working queue with the border between clean and affected nodes */
+  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+    dnode = &node->target._dijkstra;
+    if (dnode->_repair == _SPT_AFFECTED) {
+      _add_incoming_edges(domain, node);
+    }
+    else if (dnode->changed && dnode->path_cost != RFC7181_METRIC_INFINITE_PATH) {
+      /* changed edges might provide shorter paths */
+      _add_outgoing_edges(domain, node, true);
+    }
+  }
+
+  /* one-hop links might provide shorter paths */
+  _add_one_hop_nodes(domain, AF_INET, true, true);
+  _add_one_hop_nodes(domain, AF_INET6, true, true);
+
+  /* repair shortest path tree */
+  while (!heap_is_empty(&_dijkstra_working_queue)) {
+    target = heap_extract_min_element(&_dijkstra_working_queue, target, _dijkstra._node);
+    target->_dijkstra.done = true;
+    processed_count++;
+
+    if (target->type == OLSRV2_NODE_TARGET) {
+      _add_outgoing_edges(domain, container_of(target, struct olsrv2_tc_node, target), true);
+    }
+  }
+
+  /* recalculate routes of all reachable nodes and their attachments */
+  _prepare_routes(domain);
+  _prepare_endpoints();
+
+  avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
+    dnode = &node->target._dijkstra;
+    dnode->changed = false;
+
+    if (dnode->path_cost == RFC7181_METRIC_INFINITE_PATH) {
+      continue;
+    }
+    reachable_count++;
+
+    _update_routing_entry(domain, &node->target.prefix, dnode->originator, dnode->first_hop, dnode->distance,
+      dnode->path_cost, dnode->path_hops, dnode->single_hop, dnode->last_originator);
+    _add_attachments(domain, node, true, true);
+  }
+
+  /* handle attachments reachable through multiple nodes */
+  while (!heap_is_empty(&_dijkstra_working_queue)) {
+    _handle_working_queue(domain, true, true);
+  }
+
+  OONF_INFO(LOG_OLSRV2_ROUTING, "Incremental dijkstra on domain %d: %u changed, %u affected, %u of %u processed",
+    domain->index, changed_count, affected_count, processed_count, reachable_count);
+
+  _statistics.incremental_runs++;
+  _statistics.nodes_repaired += processed_count;
+  if (reachable_count > processed_count) {
+    _statistics.nodes_saved += reachable_count - processed_count;
+  }
+  return true;
+}
+
 /**
  * Run Dijkstra for a set domain, address family and
  * (non-)source-specific nodes
@@ -505,7 +784,7 @@ _run_dijkstra(struct nhdp_domain *domain, int af_family, bool use_non_ss, bool u
   _add_one_hop_nodes(domain, af_family, use_non_ss, use_ss);
 
   /* run dijkstra */
-  while (!avl_is_empty(&_dijkstra_working_tree)) {
+  while (!heap_is_empty(&_dijkstra_working_queue)) {
     _handle_working_queue(domain, use_non_ss, use_ss);
   }
 }
@@ -574,10 +853,12 @@ _remove_entry(struct olsrv2_routing_entry *entry) {
  * @param single_hop true if this is a single-hop route, false otherwise
  * @param last_originator address of the last originator before we reached the
  *   destination prefix
+ * @param parent dijkstra node in front of the target, NULL for one-hop neighbors
  */
 static void
 _insert_into_working_tree(struct olsrv2_tc_target *target, struct nhdp_neighbor *neigh, uint32_t link_cost,
-  uint32_t path_cost, uint8_t path_hops, uint8_t distance, bool single_hop, const struct netaddr *last_originator) {
+  uint32_t path_cost, uint8_t path_hops, uint8_t distance, bool single_hop, const struct netaddr *last_originator,
+  struct olsrv2_dijkstra_node *parent) {
   struct olsrv2_dijkstra_node *node;
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str nbuf1, nbuf2;
@@ -600,16 +881,9 @@ _insert_into_working_tree(struct olsrv2_tc_target *target, struct nhdp_neighbor
   path_cost += link_cost;
   path_hops += 1;
 
-  if (avl_is_node_added(&node->_node)) {
-    /* node already in dijkstra working queue */
-
-    if (node->path_cost <= path_cost) {
-      /* current path is shorter than new one */
-      return;
-    }
-
-    /* we found a better path, remove node from working queue */
-    avl_remove(&_dijkstra_working_tree, &node->_node);
+  if (node->path_cost <= path_cost) {
+    /* current path is shorter than new one */
+    return;
   }
 
   OONF_DEBUG(LOG_OLSRV2_ROUTING, "Add dst %s [%s] with pathcost %u to dijstra tree (0x%zx)",
@@ -622,9 +896,25 @@ _insert_into_working_tree(struct olsrv2_tc_target *target, struct nhdp_neighbor
   node->distance = distance;
   node->single_hop = single_hop;
   node->last_originator = last_originator;
+  node->parent = parent;
 
-  avl_insert(&_dijkstra_working_tree, &node->_node);
-  return;
+  if (heap_is_node_added(&node->_node)) {
+    /* we found a better path, move node forward in working queue */
+    heap_decrease_key(&_dijkstra_working_queue, &node->_node, path_cost);
+    return;
+  }
+
+  node->_node.key = path_cost;
+  if (heap_insert(&_dijkstra_working_queue, &node->_node)) {
+    OONF_WARN(LOG_OLSRV2_ROUTING, "Out of memory for dijkstra working queue");
+
+    /* node cannot be reached during this run */
+    node->path_cost = RFC7181_METRIC_INFINITE_PATH;
+    node->path_hops = 255;
+    node->first_hop = NULL;
+    node->parent = NULL;
+    _spt_valid = false;
+  }
 }
 
 /**
@@ -747,18 +1037,29 @@ _prepare_routes(struct nhdp_domain *domain) {
  */
 static void
 _prepare_nodes(void) {
-  struct olsrv2_tc_endpoint *end;
   struct olsrv2_tc_node *node;
 
   /* initialize private dijkstra data on nodes */
   avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
     node->target._dijkstra.first_hop = NULL;
+    node->target._dijkstra.parent = NULL;
     node->target._dijkstra.path_cost = RFC7181_METRIC_INFINITE_PATH;
     node->target._dijkstra.path_hops = 255;
     node->target._dijkstra.local = olsrv2_originator_is_local(&node->target.prefix.dst);
     node->target._dijkstra.done = false;
+    node->target._dijkstra.changed = false;
   }
 
+  _prepare_endpoints();
+}
+
+/**
+ * Initialize internal fields of endpoints for dijkstra calculation
+ */
+static void
+_prepare_endpoints(void) {
+  struct olsrv2_tc_endpoint *end;
+
   /* initialize private dijkstra data on endpoints */
   avl_for_each_element(olsrv2_tc_get_endpoint_tree(), end, _node) {
     end->target._dijkstra.first_hop = NULL;
@@ -804,6 +1105,51 @@ _check_ssnode_split(struct nhdp_domain *domain, int af_family) {
   return ssnode_count != 0 && ssnode_count != full_count && ssnode_prefix;
 }
 
+/**
+ * Check if the one-hop link used as the root of a path towards
+ * a tc node got lost or more expensive since the last dijkstra run.
+ * Cheaper links are handled by adding the one-hop nodes again.
+ * @param domain nhdp domain for dijkstra run
+ * @param node tc node reached over a single hop
+ * @return true if the path to the node is not valid anymore
+ */
+static bool
+_is_one_hop_link_worse(struct nhdp_domain *domain, struct olsrv2_tc_node *node) {
+  struct nhdp_neighbor *neigh;
+  struct nhdp_neighbor_domaindata *neigh_metric;
+
+  neigh = node->target._dijkstra.first_hop;
+  if (neigh == NULL || neigh->symmetric == 0 || olsrv2_tc_node_get(&neigh->originator) != node) {
+    return true;
+  }
+
+  neigh_metric = nhdp_domain_get_neighbordata(domain, neigh);
+  return neigh_metric->metric.in > RFC7181_METRIC_MAX || neigh_metric->metric.out > RFC7181_METRIC_MAX ||
+         neigh_metric->metric.out > node->target._dijkstra.path_cost;
+}
+
+/**
+ * Check if the edge from the parent in the shortest path tree
+ * towards a tc node got lost or more expensive since the last
+ * dijkstra run. Cheaper edges are handled by adding the outgoing
+ * edges of the changed parent again.
+ * @param domain nhdp domain for dijkstra run
+ * @param node tc node with a parent in the shortest path tree
+ * @return true if the path to the node is not valid anymore
+ */
+static bool
+_is_tree_edge_worse(struct nhdp_domain *domain, struct olsrv2_tc_node *node) {
+  struct olsrv2_tc_node *parent;
+  struct olsrv2_tc_edge *edge;
+
+  parent = container_of(node->target._dijkstra.parent, struct olsrv2_tc_node, target._dijkstra);
+  edge = avl_find_element(&parent->_edges, &node->target.prefix.dst, edge, _node);
+  if (edge == NULL || edge->virtual || edge->cost[domain->index] > RFC7181_METRIC_MAX) {
+    return true;
+  }
+  return parent->target._dijkstra.path_cost + edge->cost[domain->index] > node->target._dijkstra.path_cost;
+}
+
 /**
  * Add the single-hop TC neighbors to the dijkstra working list
  * @param domain nhdp domain for dijkstra run
@@ -847,7 +1193,109 @@ _add_one_hop_nodes(struct nhdp_domain *domain, int af_family, bool use_non_ss, b
 
     /* found node for neighbor, add to worker list */
     _insert_into_working_tree(
-      &node->target, neigh, neigh_metric->metric.out, 0, 0, 0, true, olsrv2_originator_get(af_family));
+      &node->target, neigh, neigh_metric->metric.out, 0, 0, 0, true, olsrv2_originator_get(af_family), NULL);
+  }
+}
+
+/**
+ * Add all nodes with an incoming edge from a node with a valid path
+ * to the dijkstra working list
+ * @param domain nhdp domain for dijkstra run
+ * @param tc_node pointer to tc node whose path has to be repaired
+ */
+static void
+_add_incoming_edges(struct nhdp_domain *domain, struct olsrv2_tc_node *tc_node) {
+  struct olsrv2_tc_edge *tc_edge, *in_edge;
+  struct olsrv2_dijkstra_node *src;
+
+  /* every incoming edge is the inverse of an outgoing one */
+  avl_for_each_element(&tc_node->_edges, tc_edge, _node) {
+    in_edge = tc_edge->inverse;
+    src = &in_edge->src->target._dijkstra;
+
+    if (in_edge->virtual || in_edge->cost[domain->index] > RFC7181_METRIC_MAX) {
+      continue;
+    }
+    if (src->local || src->_repair == _SPT_AFFECTED || src->path_cost == RFC7181_METRIC_INFINITE_PATH) {
+      /* source has no valid path (yet) */
+      continue;
+    }
+
+    _insert_into_working_tree(&tc_node->target, src->first_hop, in_edge->cost[domain->index], src->path_cost,
+      src->path_hops, 0, false, &in_edge->src->target.prefix.dst, src);
+  }
+}
+
+/**
+ * Add the neighbors of a tc node to the dijkstra working list
+ * @param domain nhdp domain for dijkstra run
+ * @param tc_node pointer to tc node
+ * @param use_non_ss include non-source-specific nodes into working list
+ */
+static void
+_add_outgoing_edges(struct nhdp_domain *domain, struct olsrv2_tc_node *tc_node, bool use_non_ss) {
+  struct olsrv2_tc_target *target;
+  struct olsrv2_tc_edge *tc_edge;
+
+  target = &tc_node->target;
+
+  /* iterate over edges */
+  avl_for_each_element(&tc_node->_edges, tc_edge, _node) {
+    if (!tc_edge->virtual && tc_edge->cost[domain->index] <= RFC7181_METRIC_MAX) {
+      if (!use_non_ss && !tc_node->source_specific) {
+        continue;
+      }
+
+      /* add new tc_node to working queue */
+      _insert_into_working_tree(&tc_edge->dst->target, target->_dijkstra.first_hop, tc_edge->cost[domain->index],
+        target->_dijkstra.path_cost, target->_dijkstra.path_hops, 0, false, &target->prefix.dst, &target->_dijkstra);
+    }
+  }
+}
+
+/**
+ * Add the attached networks of a tc node to the dijkstra working list
+ * or set their routes directly if they have no other way
+ * @param domain nhdp domain for dijkstra run
+ * @param tc_node pointer to tc node
+ * @param use_non_ss include non-source-specific nodes into working list
+ * @param use_ss include source-specific nodes into working list
+ */
+static void
+_add_attachments(struct nhdp_domain *domain, struct olsrv2_tc_node *tc_node, bool use_non_ss, bool use_ss) {
+  struct olsrv2_tc_target *target;
+  struct nhdp_neighbor *first_hop;
+  struct olsrv2_tc_attachment *tc_attached;
+  struct olsrv2_tc_endpoint *tc_endpoint;
+
+  target = &tc_node->target;
+  first_hop = target->_dijkstra.first_hop;
+
+  /* iterate over attached networks and addresses */
+  avl_for_each_element(&tc_node->_attached_networks, tc_attached, _src_node) {
+    if (tc_attached->cost[domain->index] <= RFC7181_METRIC_MAX) {
+      tc_endpoint = tc_attached->dst;
+
+      if (!(netaddr_get_prefix_length(&tc_endpoint->target.prefix.src) > 0 ? use_ss : use_non_ss)) {
+        /* filter out (non-)source-specific targets if necessary */
+        continue;
+      }
+      if (tc_endpoint->_attached_networks.count > 1) {
+        /* add attached network or address to working queue */
+        _insert_into_working_tree(&tc_attached->dst->target, first_hop, tc_attached->cost[domain->index],
+          target->_dijkstra.path_cost, target->_dijkstra.path_hops, tc_attached->distance[domain->index], false,
+          &target->prefix.dst, &target->_dijkstra);
+      }
+      else {
+        /* no other way to this endpoint */
+        tc_endpoint->target._dijkstra.done = true;
+
+        /* fill routing entry with dijkstra result */
+        _update_routing_entry(domain, &tc_endpoint->target.prefix, &tc_node->target.prefix.dst, first_hop,
+          tc_attached->distance[domain->index], target->_dijkstra.path_cost + tc_attached->cost[domain->index],
+          target->_dijkstra.path_hops + 1, false, &target->prefix.dst);
+      }
+    }
   }
 }
 
@@ -860,23 +1308,17 @@ _add_one_hop_nodes(struct nhdp_domain *domain, int af_family, bool use_non_ss, b
 static void
 _handle_working_queue(struct nhdp_domain *domain, bool use_non_ss, bool use_ss) {
   struct olsrv2_tc_target *target;
-  struct nhdp_neighbor *first_hop;
   struct olsrv2_tc_node *tc_node;
-  struct olsrv2_tc_edge *tc_edge;
-  struct olsrv2_tc_attachment *tc_attached;
-  struct olsrv2_tc_endpoint *tc_endpoint;
 
 #ifdef OONF_LOG_DEBUG_INFO
   struct netaddr_str nbuf1, nbuf2;
 #endif
 
-  /* get tc target */
-  target = avl_first_element(&_dijkstra_working_tree, target, _dijkstra._node);
+  /* get tc target and remove it from working queue */
+  target = heap_extract_min_element(&_dijkstra_working_queue, target, _dijkstra._node);
 
-  /* remove current node from working tree */
-  OONF_DEBUG(LOG_OLSRV2_ROUTING, "Remove node %s [%s] from dijkstra tree",
+  OONF_DEBUG(LOG_OLSRV2_ROUTING, "Remove node %s [%s] from dijkstra queue",
     netaddr_to_string(&nbuf1, &target->prefix.dst), netaddr_to_string(&nbuf2, &target->prefix.src));
-  avl_remove(&_dijkstra_working_tree, &target->_dijkstra._node);
 
   /* mark current node as done */
   target->_dijkstra.done = true;
@@ -889,51 +1331,11 @@ _handle_working_queue(struct nhdp_domain *domain, bool use_non_ss, bool use_ss)
   }
 
   if (target->type == OLSRV2_NODE_TARGET) {
-    /* get neighbor and its domain specific data */
-    first_hop = target->_dijkstra.first_hop;
-
     /* calculate pointer of olsrv2_tc_node */
     tc_node = container_of(target, struct olsrv2_tc_node, target);
 
-    /* iterate over edges */
-    avl_for_each_element(&tc_node->_edges, tc_edge, _node) {
-      if (!tc_edge->virtual && tc_edge->cost[domain->index] <= RFC7181_METRIC_MAX) {
-        if (!use_non_ss && !tc_node->source_specific) {
-          continue;
-        }
-
-        /* add new tc_node to working tree */
-        _insert_into_working_tree(&tc_edge->dst->target, first_hop, tc_edge->cost[domain->index],
-          target->_dijkstra.path_cost, target->_dijkstra.path_hops, 0, false, &target->prefix.dst);
-      }
-    }
-
-    /* iterate over attached networks and addresses */
-    avl_for_each_element(&tc_node->_attached_networks, tc_attached, _src_node) {
-      if (tc_attached->cost[domain->index] <= RFC7181_METRIC_MAX) {
-        tc_endpoint = tc_attached->dst;
-
-        if (!(netaddr_get_prefix_length(&tc_endpoint->target.prefix.src) > 0 ? use_ss : use_non_ss)) {
-          /* filter out (non-)source-specific targets if necessary */
-          continue;
-        }
-        if (tc_endpoint->_attached_networks.count > 1) {
-          /* add attached network or address to working tree */
-          _insert_into_working_tree(&tc_attached->dst->target, first_hop, tc_attached->cost[domain->index],
-            target->_dijkstra.path_cost, target->_dijkstra.path_hops, tc_attached->distance[domain->index], false,
-            &target->prefix.dst);
-        }
-        else {
-          /* no other way to this endpoint */
-          tc_endpoint->target._dijkstra.done = true;
-
-          /* fill routing entry with dijkstra result */
-          _update_routing_entry(domain, &tc_endpoint->target.prefix, &tc_node->target.prefix.dst, first_hop,
-            tc_attached->distance[domain->index], target->_dijkstra.path_cost + tc_attached->cost[domain->index],
-            target->_dijkstra.path_hops + 1, false, &target->prefix.dst);
-        }
-      }
-    }
+    _add_outgoing_edges(domain, tc_node, use_non_ss);
+    _add_attachments(domain, tc_node, use_non_ss, use_ss);
   }
 }
 
@@ -1100,12 +1502,15 @@ _process_dijkstra_result(struct nhdp_domain *domain) {
 
 /**
  * Process all entries in kernel processing queue and send them to the kernel
+ * as one route transaction
  */
 static void
 _process_kernel_queue(void) {
   struct olsrv2_routing_entry *rtentry, *rt_it;
   struct os_route_str rbuf;
 
+  os_routing_transaction_begin();
+
   list_for_each_element_safe(&_kernel_queue, rtentry, _working_node, rt_it) {
     /* remove from routing queue */
     list_remove(&rtentry->_working_node);
@@ -1130,6 +1535,8 @@ _process_kernel_queue(void) {
       }
     }
   }
+
+  os_routing_transaction_commit();
 }
 
 /**
@@ -103,6 +103,9 @@ static struct oonf_timer_class _validity_info = {
 static struct avl_tree _tc_tree;
 static struct avl_tree _tc_endpoint_tree;
 
+/* hash index of tc nodes for fast lookups */
+static struct netaddr_hash _tc_hash;
+
 /**
  * Initialize tc database
  */
@@ -116,6 +119,7 @@ olsrv2_tc_init(void) {
   oonf_class_extension_add(&_nhdp_neighbor_extension);
 
   avl_init(&_tc_tree, avl_comp_netaddr, false);
+  netaddr_hash_init(&_tc_hash);
   avl_init(&_tc_endpoint_tree, os_routing_avl_cmp_route_key, true);
 }
 
@@ -149,6 +153,8 @@ olsrv2_tc_cleanup(void) {
   oonf_class_remove(&_tc_attached_class);
   oonf_class_remove(&_tc_edge_class);
   oonf_class_remove(&_tc_node_class);
+
+  netaddr_hash_free(&_tc_hash);
 }
 
 /**
@@ -162,7 +168,7 @@ struct olsrv2_tc_node *
 olsrv2_tc_node_add(struct netaddr *originator, uint64_t vtime, uint16_t ansn) {
   struct olsrv2_tc_node *node;
 
-  node = avl_find_element(&_tc_tree, originator, node, _originator_node);
+  node = netaddr_hash_find_element(&_tc_hash, originator, node, _originator_hash_node);
   if (!node) {
     node = oonf_class_malloc(&_tc_node_class);
     if (node == NULL) {
@@ -172,6 +178,7 @@ olsrv2_tc_node_add(struct netaddr *originator, uint64_t vtime, uint16_t ansn) {
     /* copy key and attach it to node */
     os_routing_init_sourcespec_prefix(&node->target.prefix, originator);
     node->_originator_node.key = &node->target.prefix.dst;
+    node->_originator_hash_node.key = &node->target.prefix.dst;
 
     /* initialize node */
     avl_init(&node->_edges, avl_comp_netaddr, false);
@@ -185,8 +192,9 @@ olsrv2_tc_node_add(struct netaddr *originator, uint64_t vtime, uint16_t ansn) {
     node->target.type = OLSRV2_NODE_TARGET;
     olsrv2_routing_dijkstra_node_init(&node->target._dijkstra, &node->target.prefix.dst);
 
-    /* hook into global tree */
+    /* hook into global tree and hash index */
     avl_insert(&_tc_tree, &node->_originator_node);
+    netaddr_hash_insert(&_tc_hash, &node->_originator_hash_node);
 
     /* fire event */
     oonf_class_event(&_tc_node_class, node, OONF_OBJECT_ADDED);
@@ -229,7 +237,11 @@ olsrv2_tc_node_remove(struct olsrv2_tc_node *node) {
 
   /* remove from global tree and free memory if node is not needed anymore*/
   if (node->_edges.count == 0 && !node->direct_neighbor) {
+    /* shortest path tree might still point to this node */
+    olsrv2_routing_dijkstra_invalidate();
+
     avl_remove(&_tc_tree, &node->_originator_node);
+    netaddr_hash_remove(&_tc_hash, &node->_originator_hash_node);
     oonf_class_free(&_tc_node_class, node);
   }
 
@@ -251,15 +263,17 @@ olsrv2_tc_edge_add(struct olsrv2_tc_node *src, struct netaddr *addr) {
 
   edge = avl_find_element(&src->_edges, addr, edge, _node);
   if (edge != NULL) {
-    edge->virtual = false;
-
     /* cleanup metric data from other side of the edge */
     for (i = 0; i < NHDP_MAXIMUM_DOMAINS; i++) {
       edge->cost[i] = RFC7181_METRIC_INFINITE;
     }
 
-    /* fire event */
-    oonf_class_event(&_tc_edge_class, edge, OONF_OBJECT_ADDED);
+    if (edge->virtual) {
+      edge->virtual = false;
+
+      /* fire event */
+      oonf_class_event(&_tc_edge_class, edge, OONF_OBJECT_ADDED);
+    }
     return edge;
   }
 
@@ -277,7 +291,7 @@ olsrv2_tc_edge_add(struct olsrv2_tc_node *src, struct netaddr *addr) {
   }
 
   /* find or allocate destination node */
-  dst = avl_find_element(&_tc_tree, addr, dst, _originator_node);
+  dst = netaddr_hash_find_element(&_tc_hash, addr, dst, _originator_hash_node);
   if (dst == NULL) {
     /* create virtual node */
     dst = olsrv2_tc_node_add(addr, 0, 0);
@@ -428,12 +442,30 @@ olsrv2_tc_endpoint_remove(struct olsrv2_tc_attachment *net) {
 }
 
 /**
- * Inform everyone that a tc node changed
+ * Inform everyone that a tc node changed. Edges and attachments
+ * of the node with changed costs are reported too, so listeners
+ * see their final state after a TC has been processed.
  * @param node tc node
  */
 void
 olsrv2_tc_trigger_change(struct olsrv2_tc_node *node) {
+  struct olsrv2_tc_edge *edge;
+  struct olsrv2_tc_attachment *net;
+
   oonf_class_event(&_tc_node_class, node, OONF_OBJECT_CHANGED);
+
+  avl_for_each_element(&node->_edges, edge, _node) {
+    if (edge->_changed) {
+      edge->_changed = false;
+      oonf_class_event(&_tc_edge_class, edge, OONF_OBJECT_CHANGED);
+    }
+  }
+  avl_for_each_element(&node->_attached_networks, net, _src_node) {
+    if (net->_changed) {
+      net->_changed = false;
+      oonf_class_event(&_tc_attached_class, net, OONF_OBJECT_CHANGED);
+    }
+  }
 }
 
 /**
@@ -445,6 +477,15 @@ olsrv2_tc_get_tree(void) {
   return &_tc_tree;
 }
 
+/**
+ * Get hash index of olsrv2 tc nodes
+ * @return node hash index
+ */
+struct netaddr_hash *
+olsrv2_tc_get_hash(void) {
+  return &_tc_hash;
+}
+
 /**
  * Get tree of olsrv2 tc endpoints
  * @return endpoint tree
@@ -487,6 +528,9 @@ _remove_edge(struct olsrv2_tc_edge *edge, bool cleanup) {
   /* fire event */
   oonf_class_event(&_tc_edge_class, edge, OONF_OBJECT_REMOVED);
 
+  /* outgoing edges of source have changed */
+  olsrv2_routing_dijkstra_node_changed(&edge->src->target._dijkstra);
+
   if (!edge->inverse->virtual) {
     /* make this edge virtual */
     edge->virtual = true;
@@ -553,6 +597,9 @@ _cb_neighbor_remove(void *ptr) {
 
   neigh = ptr;
 
+  /* shortest path tree might still use this neighbor as first hop */
+  olsrv2_routing_dijkstra_invalidate();
+
   if (netaddr_is_unspec(&neigh->originator)) {
     return;
   }
@@ -124,6 +124,9 @@ static struct oonf_rfc5444_protocol *_protocol;
 static bool _cleanedup = false;
 static size_t _mprtypes_size;
 
+/* generation counter of OLSRv2 specific TC content */
+static uint32_t _tc_generation;
+
 /**
  * initialize olsrv2 writer
  * @param protocol rfc5444 protocol
@@ -141,6 +144,7 @@ olsrv2_writer_init(struct oonf_rfc5444_protocol *protocol) {
 
   _olsrv2_message->addMessageHeader = _cb_addMessageHeader;
   _olsrv2_message->finishMessageHeader = _cb_finishMessageHeader;
+  _olsrv2_message->cache_enabled = true;
   _olsrv2_message->forward_target_selector = nhdp_forwarding_selector;
 
   if (rfc5444_writer_register_msgcontentprovider(
@@ -176,10 +180,22 @@ olsrv2_writer_send_tc(void) {
     return;
   }
 
+  /* TCs only change with the NHDP neighborhood or OLSRv2 specific data */
+  _olsrv2_message->content_generation = nhdp_get_content_generation() + _tc_generation;
+
   _send_tc(AF_INET);
   _send_tc(AF_INET6);
 }
 
+/**
+ * Signal that OLSRv2 specific TC content (ANSN, attached networks,
+ * originator or configuration) changed, which invalidates the cached TCs.
+ */
+void
+olsrv2_writer_content_changed(void) {
+  _tc_generation++;
+}
+
 /**
  * Set a new forwarding selector for OLSRv2 TC messages
  * @param forward_target_selector pointer to forwarding selector
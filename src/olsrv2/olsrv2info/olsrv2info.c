@@ -83,14 +83,21 @@ static void _initialize_node_values(struct olsrv2_tc_node *);
 static void _initialize_attached_network_values(struct olsrv2_tc_attachment *edge);
 static void _initialize_edge_values(struct olsrv2_tc_edge *edge);
 static void _initialize_route_values(struct olsrv2_routing_entry *route);
+static void _initialize_spf_values(const struct olsrv2_routing_statistics *stats);
+static void _initialize_hash_values(const char *name, const struct netaddr_hash *hash);
 
 static int _cb_create_text_originator(struct oonf_viewer_template *);
 static int _cb_create_text_old_originator(struct oonf_viewer_template *);
 static int _cb_create_text_lan(struct oonf_viewer_template *);
 static int _cb_create_text_node(struct oonf_viewer_template *);
+static int _cb_create_text_node_object(struct oonf_viewer_template *, void *);
 static int _cb_create_text_attached_network(struct oonf_viewer_template *);
+static int _cb_create_text_attached_network_object(struct oonf_viewer_template *, void *);
 static int _cb_create_text_edge(struct oonf_viewer_template *);
+static int _cb_create_text_edge_object(struct oonf_viewer_template *, void *);
 static int _cb_create_text_route(struct oonf_viewer_template *);
+static int _cb_create_text_spf(struct oonf_viewer_template *);
+static int _cb_create_text_hash(struct oonf_viewer_template *);
 
 /*
  * list of template keys and corresponding buffers for values.
@@ -197,6 +204,33 @@ static int _cb_create_text_route(struct oonf_viewer_template *);
 /*! template key for the last hop before the route destination */
 #define KEY_ROUTE_LASTHOP "route_lasthop"
 
+/*! template key for number of full dijkstra runs */
+#define KEY_SPF_FULL "spf_full"
+
+/*! template key for number of incremental dijkstra runs */
+#define KEY_SPF_INCREMENTAL "spf_incremental"
+
+/*! template key for number of incremental runs replaced by full runs */
+#define KEY_SPF_FALLBACK "spf_fallback"
+
+/*! template key for number of nodes processed by incremental runs */
+#define KEY_SPF_REPAIRED "spf_repaired"
+
+/*! template key for number of nodes incremental runs did not process */
+#define KEY_SPF_SAVED "spf_saved"
+
+/*! template key for name of address hash index */
+#define KEY_HASH "hash"
+
+/*! template key for number of addresses in hash index */
+#define KEY_HASH_COUNT "hash_count"
+
+/*! template key for number of lookups in hash index */
+#define KEY_HASH_LOOKUPS "hash_lookups"
+
+/*! template key for number of successful lookups in hash index */
+#define KEY_HASH_HITS "hash_hits"
+
 /*
  * buffer space for values that will be assembled
  * into the output of the plugin
@@ -240,6 +274,17 @@ static char _value_route_if[IF_NAMESIZE];
 static char _value_route_ifindex[12];
 static struct netaddr_str _value_route_lasthop;
 
+static char _value_spf_full[12];
+static char _value_spf_incremental[12];
+static char _value_spf_fallback[12];
+static char _value_spf_repaired[21];
+static char _value_spf_saved[21];
+
+static char _value_hash[16];
+static char _value_hash_count[11];
+static char _value_hash_lookups[21];
+static char _value_hash_hits[21];
+
 /* definition of the template data entries for JSON and table output */
 static struct abuf_template_data_entry _tde_originator[] = {
   { KEY_ORIGINATOR, _value_originator.buf, true },
@@ -309,6 +354,21 @@ static struct abuf_template_data_entry _tde_route[] = {
   { KEY_ROUTE_LASTHOP, _value_route_lasthop.buf, true },
 };
 
+static struct abuf_template_data_entry _tde_spf[] = {
+  { KEY_SPF_FULL, _value_spf_full, false },
+  { KEY_SPF_INCREMENTAL, _value_spf_incremental, false },
+  { KEY_SPF_FALLBACK, _value_spf_fallback, false },
+  { KEY_SPF_REPAIRED, _value_spf_repaired, false },
+  { KEY_SPF_SAVED, _value_spf_saved, false },
+};
+
+static struct abuf_template_data_entry _tde_hash[] = {
+  { KEY_HASH, _value_hash, true },
+  { KEY_HASH_COUNT, _value_hash_count, false },
+  { KEY_HASH_LOOKUPS, _value_hash_lookups, false },
+  { KEY_HASH_HITS, _value_hash_hits, false },
+};
+
 static struct abuf_template_storage _template_storage;
 
 /* Template Data objects (contain one or more Template Data Entries) */
@@ -346,6 +406,12 @@ static struct abuf_template_data _td_route[] = {
   { _tde_domain_metric_out, ARRAYSIZE(_tde_domain_metric_out) },
   { _tde_domain_path_hops, ARRAYSIZE(_tde_domain_path_hops) },
 };
+static struct abuf_template_data _td_spf[] = {
+  { _tde_spf, ARRAYSIZE(_tde_spf) },
+};
+static struct abuf_template_data _td_hash[] = {
+  { _tde_hash, ARRAYSIZE(_tde_hash) },
+};
 
 /* OONF viewer templates (based on Template Data arrays) */
 static struct oonf_viewer_template _templates[] = { {
@@ -371,24 +437,42 @@ static struct oonf_viewer_template _templates[] = { {
     .data_size = ARRAYSIZE(_td_node),
     .json_name = "node",
     .cb_function = _cb_create_text_node,
+    .class_name = OLSRV2_CLASS_TC_NODE,
+    .cb_object = _cb_create_text_node_object,
   },
   {
     .data = _td_attached_net,
     .data_size = ARRAYSIZE(_td_attached_net),
     .json_name = "attached_network",
     .cb_function = _cb_create_text_attached_network,
+    .class_name = OLSRV2_CLASS_ATTACHED,
+    .cb_object = _cb_create_text_attached_network_object,
   },
   {
     .data = _td_edge,
     .data_size = ARRAYSIZE(_td_edge),
     .json_name = "edge",
     .cb_function = _cb_create_text_edge,
+    .class_name = OLSRV2_CLASS_TC_EDGE,
+    .cb_object = _cb_create_text_edge_object,
   },
   {
     .data = _td_route,
     .data_size = ARRAYSIZE(_td_route),
     .json_name = "route",
     .cb_function = _cb_create_text_route,
+  },
+  {
+    .data = _td_spf,
+    .data_size = ARRAYSIZE(_td_spf),
+    .json_name = "spf",
+    .cb_function = _cb_create_text_spf,
+  },
+  {
+    .data = _td_hash,
+    .data_size = ARRAYSIZE(_td_hash),
+    .json_name = "hash",
+    .cb_function = _cb_create_text_hash,
   } };
 
 /* telnet command of this plugin */
@@ -437,8 +521,8 @@ _cleanup(void) {
  */
 static enum oonf_telnet_result
 _cb_olsrv2info(struct oonf_telnet_data *con) {
-  return oonf_viewer_telnet_handler(
-    con->out, &_template_storage, OONF_OLSRV2INFO_SUBSYSTEM, con->parameter, _templates, ARRAYSIZE(_templates));
+  return oonf_viewer_telnet_session_handler(
+    con, &_template_storage, OONF_OLSRV2INFO_SUBSYSTEM, _templates, ARRAYSIZE(_templates));
 }
 
 /**
@@ -594,6 +678,32 @@ _initialize_route_values(struct olsrv2_routing_entry *route) {
   netaddr_to_string(&_value_route_lasthop, &route->last_originator);
 }
 
+/**
+ * Initialize the value buffers for the shortest path statistics
+ * @param stats pointer to routing statistics
+ */
+static void
+_initialize_spf_values(const struct olsrv2_routing_statistics *stats) {
+  snprintf(_value_spf_full, sizeof(_value_spf_full), "%u", stats->full_runs);
+  snprintf(_value_spf_incremental, sizeof(_value_spf_incremental), "%u", stats->incremental_runs);
+  snprintf(_value_spf_fallback, sizeof(_value_spf_fallback), "%u", stats->fallbacks);
+  snprintf(_value_spf_repaired, sizeof(_value_spf_repaired), "%" PRIu64, stats->nodes_repaired);
+  snprintf(_value_spf_saved, sizeof(_value_spf_saved), "%" PRIu64, stats->nodes_saved);
+}
+
+/**
+ * Initialize the value buffers for an address hash index
+ * @param name name of the index
+ * @param hash address hash index
+ */
+static void
+_initialize_hash_values(const char *name, const struct netaddr_hash *hash) {
+  strscpy(_value_hash, name, sizeof(_value_hash));
+  snprintf(_value_hash_count, sizeof(_value_hash_count), "%u", hash->count);
+  snprintf(_value_hash_lookups, sizeof(_value_hash_lookups), "%" PRIu64, hash->lookups);
+  snprintf(_value_hash_hits, sizeof(_value_hash_hits), "%" PRIu64, hash->hits);
+}
+
 /**
  * Displays the known data about each NHDP interface.
  * @param template oonf viewer template
@@ -666,13 +776,25 @@ _cb_create_text_node(struct oonf_viewer_template *template) {
   struct olsrv2_tc_node *node;
 
   avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
-    _initialize_node_values(node);
-
-    oonf_viewer_output_print_line(template);
+    _cb_create_text_node_object(template, node);
   }
   return 0;
 }
 
+/**
+ * Display a single OLSRv2 node
+ * @param template oonf viewer template
+ * @param ptr OLSRv2 node
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_node_object(struct oonf_viewer_template *template, void *ptr) {
+  _initialize_node_values(ptr);
+
+  oonf_viewer_output_print_line(template);
+  return 0;
+}
+
 /**
  * Display all known OLSRv2 attached networks
  * @param template oonf viewer template
@@ -682,26 +804,39 @@ static int
 _cb_create_text_attached_network(struct oonf_viewer_template *template) {
   struct olsrv2_tc_node *node;
   struct olsrv2_tc_attachment *attached;
-  struct nhdp_domain *domain;
 
   avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
-    _initialize_node_values(node);
-
-    if (olsrv2_tc_is_node_virtual(node)) {
-      continue;
+    avl_for_each_element(&node->_attached_networks, attached, _src_node) {
+      _cb_create_text_attached_network_object(template, attached);
     }
+  }
+  return 0;
+}
 
-    avl_for_each_element(&node->_attached_networks, attached, _src_node) {
-      _initialize_attached_network_values(attached);
+/**
+ * Display a single OLSRv2 attached network
+ * @param template oonf viewer template
+ * @param ptr OLSRv2 attached network
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_attached_network_object(struct oonf_viewer_template *template, void *ptr) {
+  struct olsrv2_tc_attachment *attached = ptr;
+  struct nhdp_domain *domain;
 
-      list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-        _initialize_domain_values(domain);
-        _initialize_domain_link_metric_values(domain, olsrv2_tc_attachment_get_metric(domain, attached));
-        _initialize_domain_distance(olsrv2_tc_attachment_get_distance(domain, attached));
+  if (olsrv2_tc_is_node_virtual(attached->src)) {
+    return 0;
+  }
 
-        oonf_viewer_output_print_line(template);
-      }
-    }
+  _initialize_node_values(attached->src);
+  _initialize_attached_network_values(attached);
+
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    _initialize_domain_values(domain);
+    _initialize_domain_link_metric_values(domain, olsrv2_tc_attachment_get_metric(domain, attached));
+    _initialize_domain_distance(olsrv2_tc_attachment_get_distance(domain, attached));
+
+    oonf_viewer_output_print_line(template);
   }
   return 0;
 }
@@ -715,31 +850,41 @@ static int
 _cb_create_text_edge(struct oonf_viewer_template *template) {
   struct olsrv2_tc_node *node;
   struct olsrv2_tc_edge *edge;
-  struct nhdp_domain *domain;
-  uint32_t metric;
 
   avl_for_each_element(olsrv2_tc_get_tree(), node, _originator_node) {
-    _initialize_node_values(node);
-
-    if (olsrv2_tc_is_node_virtual(node)) {
-      continue;
-    }
     avl_for_each_element(&node->_edges, edge, _node) {
-      if (edge->virtual) {
-        continue;
-      }
+      _cb_create_text_edge_object(template, edge);
+    }
+  }
+  return 0;
+}
 
-      _initialize_edge_values(edge);
+/**
+ * Display a single OLSRv2 edge
+ * @param template oonf viewer template
+ * @param ptr OLSRv2 edge
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_edge_object(struct oonf_viewer_template *template, void *ptr) {
+  struct olsrv2_tc_edge *edge = ptr;
+  struct nhdp_domain *domain;
+  uint32_t metric;
 
-      list_for_each_element(nhdp_domain_get_list(), domain, _node) {
-        metric = olsrv2_tc_edge_get_metric(domain, edge);
-        if (metric <= RFC7181_METRIC_MAX) {
-          _initialize_domain_values(domain);
-          _initialize_domain_link_metric_values(domain, metric);
+  if (edge->virtual || olsrv2_tc_is_node_virtual(edge->src)) {
+    return 0;
+  }
 
-          oonf_viewer_output_print_line(template);
-        }
-      }
+  _initialize_node_values(edge->src);
+  _initialize_edge_values(edge);
+
+  list_for_each_element(nhdp_domain_get_list(), domain, _node) {
+    metric = olsrv2_tc_edge_get_metric(domain, edge);
+    if (metric <= RFC7181_METRIC_MAX) {
+      _initialize_domain_values(domain);
+      _initialize_domain_link_metric_values(domain, metric);
+
+      oonf_viewer_output_print_line(template);
     }
   }
   return 0;
@@ -768,3 +913,27 @@ _cb_create_text_route(struct oonf_viewer_template *template) {
   }
   return 0;
 }
+
+/**
+ * Display the statistics of the OLSRv2 shortest path calculation
+ * @param template oonf viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_spf(struct oonf_viewer_template *template) {
+  _initialize_spf_values(olsrv2_routing_get_statistics());
+  oonf_viewer_output_print_line(template);
+  return 0;
+}
+
+/**
+ * Display the statistics of the OLSRv2 address hash indexes
+ * @param template oonf viewer template
+ * @return -1 if an error happened, 0 otherwise
+ */
+static int
+_cb_create_text_hash(struct oonf_viewer_template *template) {
+  _initialize_hash_values("tc_node", olsrv2_tc_get_hash());
+  oonf_viewer_output_print_line(template);
+  return 0;
+}
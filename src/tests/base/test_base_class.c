@@ -0,0 +1,344 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
+#include <oonf/cunit/cunit.h>
+
+#define MAX_OBJECTS 1024
+
+static struct oonf_appdata _appdata = {
+  .app_name = "test_base_class",
+};
+
+static struct oonf_class _small = {
+  .name = "small test class",
+  .size = 40,
+};
+
+static struct oonf_class _large = {
+  .name = "large test class",
+  .size = OONF_CLASS_SLAB_MAX_SIZE / 4,
+};
+
+static struct oonf_class_extension _extension = {
+  .ext_name = "test extension",
+  .class_name = "small test class",
+  .size = 24,
+};
+
+static void *_objects[MAX_OBJECTS];
+
+/**
+ * @param ci memory class
+ * @param ptr object of class
+ * @return start of slab the object was carved from
+ */
+static uintptr_t
+_get_slab(struct oonf_class *ci, void *ptr) {
+  return (uintptr_t)ptr & ~((uintptr_t)oonf_class_get_slab_size(ci) - 1);
+}
+
+/**
+ * Allocate a number of objects and mark their memory
+ * @param ci memory class
+ * @param count number of objects
+ */
+static void
+_alloc_objects(struct oonf_class *ci, size_t count) {
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    _objects[i] = oonf_class_malloc(ci);
+    memset(_objects[i], 0xaa, ci->size);
+  }
+}
+
+static void
+_free_objects(struct oonf_class *ci, size_t start, size_t count) {
+  size_t i;
+
+  for (i = start; i < start + count; i++) {
+    oonf_class_free(ci, _objects[i]);
+    _objects[i] = NULL;
+  }
+}
+
+static void
+clear_elements(void) {
+  _small.min_free_count = 0;
+  oonf_class_add(&_small);
+}
+
+static void
+test_carve_and_reuse(void) {
+  uint32_t capacity, allocations, recycled;
+  size_t i;
+  uint8_t *ptr;
+
+  START_TEST();
+
+  /* statistics are kept over the whole runtime */
+  allocations = oonf_class_get_allocations(&_small);
+  recycled = oonf_class_get_recycled(&_small);
+
+  CHECK_TRUE(oonf_class_get_slab_size(&_small) > 0, "small class does not use slabs");
+  capacity = _small._slab_capacity;
+  CHECK_TRUE(capacity >= OONF_CLASS_SLAB_MIN_OBJECTS, "slab has only space for %u objects", capacity);
+
+  _alloc_objects(&_small, capacity + 1);
+  CHECK_TRUE(oonf_class_get_slabs(&_small) == 2, "%u slabs for %u objects", oonf_class_get_slabs(&_small),
+    capacity + 1);
+  CHECK_TRUE(oonf_class_get_allocations(&_small) - allocations == capacity + 1, "%u objects carved",
+    oonf_class_get_allocations(&_small) - allocations);
+
+  /* objects of the first slab are consecutive and lie within the aligned slab */
+  for (i = 1; i < capacity; i++) {
+    CHECK_TRUE(_get_slab(&_small, _objects[i]) == _get_slab(&_small, _objects[0]), "object %" PRINTF_SIZE_T_SPECIFIER
+      " is not in the first slab", i);
+    CHECK_TRUE((uint8_t *)_objects[i] == (uint8_t *)_objects[i - 1] + _small.total_size,
+      "object %" PRINTF_SIZE_T_SPECIFIER " is not carved behind the previous one", i);
+  }
+  CHECK_TRUE(_get_slab(&_small, _objects[capacity]) != _get_slab(&_small, _objects[0]),
+    "object behind full slab is in the same slab");
+
+  /* released object is handed out again, cleared */
+  ptr = _objects[3];
+  oonf_class_free(&_small, ptr);
+  _objects[3] = oonf_class_malloc(&_small);
+  CHECK_TRUE(_objects[3] == ptr, "released object was not reused");
+  CHECK_TRUE(oonf_class_get_recycled(&_small) - recycled == 1, "%u objects recycled",
+    oonf_class_get_recycled(&_small) - recycled);
+  for (i = 0; i < _small.size; i++) {
+    CHECK_TRUE(ptr[i] == 0, "reused object not cleared at byte %" PRINTF_SIZE_T_SPECIFIER, i);
+  }
+  CHECK_TRUE(oonf_class_get_usage(&_small) == capacity + 1, "usage is %u", oonf_class_get_usage(&_small));
+
+  _free_objects(&_small, 0, capacity + 1);
+  CHECK_TRUE(oonf_class_get_usage(&_small) == 0, "usage is %u", oonf_class_get_usage(&_small));
+
+  oonf_class_remove(&_small);
+  CHECK_TRUE(oonf_class_get_slabs(&_small) == 0, "%u slabs after removal", oonf_class_get_slabs(&_small));
+
+  END_TEST();
+}
+
+static void
+test_empty_slabs(void) {
+  uint32_t capacity;
+
+  START_TEST();
+
+  capacity = _small._slab_capacity;
+  _alloc_objects(&_small, capacity * 3);
+  CHECK_TRUE(oonf_class_get_slabs(&_small) >= 3, "%u slabs", oonf_class_get_slabs(&_small));
+
+  /* class keeps one empty slab by default and returns the others */
+  _free_objects(&_small, 0, capacity * 3);
+  CHECK_TRUE(oonf_class_get_slabs(&_small) == 1, "%u slabs left", oonf_class_get_slabs(&_small));
+  CHECK_TRUE(oonf_class_get_empty_slabs(&_small) == 1, "%u empty slabs", oonf_class_get_empty_slabs(&_small));
+  CHECK_TRUE(oonf_class_get_slab_releases(&_small) == oonf_class_get_slab_allocations(&_small) - 1,
+    "%u slabs released of %u", oonf_class_get_slab_releases(&_small), oonf_class_get_slab_allocations(&_small));
+
+  /* empty slab is used again */
+  _alloc_objects(&_small, 1);
+  CHECK_TRUE(oonf_class_get_empty_slabs(&_small) == 0, "%u empty slabs", oonf_class_get_empty_slabs(&_small));
+  CHECK_TRUE(oonf_class_get_slabs(&_small) == 1, "%u slabs", oonf_class_get_slabs(&_small));
+  _free_objects(&_small, 0, 1);
+
+  oonf_class_remove(&_small);
+  CHECK_TRUE(oonf_class_get_slabs(&_small) == 0, "%u slabs after removal", oonf_class_get_slabs(&_small));
+
+  END_TEST();
+}
+
+static void
+test_min_free_count(void) {
+  uint32_t slabs;
+
+  START_TEST();
+
+  /* class must keep enough empty slabs for its minimum of free objects */
+  _small.min_free_count = MAX_OBJECTS / 2;
+
+  _alloc_objects(&_small, MAX_OBJECTS);
+  slabs = oonf_class_get_slabs(&_small);
+  _free_objects(&_small, 0, MAX_OBJECTS);
+
+  CHECK_TRUE(oonf_class_get_slabs(&_small) > 1, "only %u slabs kept", oonf_class_get_slabs(&_small));
+  CHECK_TRUE(oonf_class_get_slabs(&_small) < slabs, "all %u slabs kept", slabs);
+  CHECK_TRUE(oonf_class_get_free(&_small) >= _small.min_free_count, "only %u free objects",
+    oonf_class_get_free(&_small));
+
+  oonf_class_remove(&_small);
+
+  END_TEST();
+}
+
+static void
+test_large_objects(void) {
+  void *ptr;
+
+  START_TEST();
+
+  /* objects too large for slabs are allocated one by one */
+  oonf_class_add(&_large);
+  CHECK_TRUE(oonf_class_get_slab_size(&_large) == 0, "large class uses slabs");
+
+  _alloc_objects(&_large, 2);
+  CHECK_TRUE(oonf_class_get_slabs(&_large) == 0, "%u slabs for large class", oonf_class_get_slabs(&_large));
+  CHECK_TRUE(oonf_class_get_usage(&_large) == 2, "usage is %u", oonf_class_get_usage(&_large));
+
+  /* released object is kept on the free list for its minimum */
+  _large.min_free_count = 1;
+  ptr = _objects[1];
+  _free_objects(&_large, 1, 1);
+  CHECK_TRUE(oonf_class_get_free(&_large) == 1, "%u free objects", oonf_class_get_free(&_large));
+  _objects[1] = oonf_class_malloc(&_large);
+  CHECK_TRUE(_objects[1] == ptr, "free object was not reused");
+  CHECK_TRUE(oonf_class_get_recycled(&_large) == 1, "%u objects recycled", oonf_class_get_recycled(&_large));
+
+  _free_objects(&_large, 0, 2);
+  CHECK_TRUE(oonf_class_get_usage(&_large) == 0, "usage is %u", oonf_class_get_usage(&_large));
+  oonf_class_remove(&_large);
+
+  END_TEST();
+}
+
+static void
+test_remove_with_live_objects(void) {
+  uint32_t capacity;
+  uint8_t *ptr;
+  size_t i;
+
+  START_TEST();
+
+  capacity = _small._slab_capacity;
+  _alloc_objects(&_small, capacity * 3);
+
+  /* one object keeps the first slab in use */
+  _free_objects(&_small, 1, capacity * 3 - 1);
+  CHECK_TRUE(oonf_class_get_empty_slabs(&_small) == 1, "%u empty slabs", oonf_class_get_empty_slabs(&_small));
+
+  oonf_class_remove(&_small);
+  CHECK_TRUE(oonf_class_get_slabs(&_small) == 1, "%u slabs after removal", oonf_class_get_slabs(&_small));
+  CHECK_TRUE(oonf_class_get_empty_slabs(&_small) == 0, "%u empty slabs after removal",
+    oonf_class_get_empty_slabs(&_small));
+
+  /* live object stays valid */
+  ptr = _objects[0];
+  for (i = 0; i < _small.size; i++) {
+    CHECK_TRUE(ptr[i] == 0xaa, "live object changed at byte %" PRINTF_SIZE_T_SPECIFIER, i);
+  }
+
+  /* last object returns the slab of the removed class to the system */
+  _free_objects(&_small, 0, 1);
+  CHECK_TRUE(oonf_class_get_slabs(&_small) == 0, "%u slabs after last free", oonf_class_get_slabs(&_small));
+
+  END_TEST();
+}
+
+static void
+test_extension(void) {
+  size_t total_size;
+
+  START_TEST();
+
+  /* extension of an unused class increases the object size */
+  total_size = _small.total_size;
+  CHECK_TRUE(oonf_class_extension_add(&_extension) == 0, "could not extend unused class");
+  CHECK_TRUE(_small.total_size >= total_size + _extension.size, "class not extended");
+  CHECK_TRUE(oonf_class_get_slab_size(&_small) >= OONF_CLASS_SLAB_MIN_OBJECTS * _small.total_size,
+    "slab too small for extended objects");
+
+  _alloc_objects(&_small, 2);
+  CHECK_TRUE((uint8_t *)_objects[1] == (uint8_t *)_objects[0] + _small.total_size,
+    "extended objects are not carved with the extended size");
+  _free_objects(&_small, 0, 2);
+  oonf_class_extension_remove(&_extension);
+
+  /* class is in use and cannot be extended anymore */
+  CHECK_TRUE(oonf_class_extension_add(&_extension) != 0, "class extended after use");
+
+  oonf_class_remove(&_small);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  struct oonf_subsystem *class_subsystem;
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+
+  class_subsystem = oonf_subsystem_get(OONF_CLASS_SUBSYSTEM);
+  if (class_subsystem == NULL || class_subsystem->init()) {
+    oonf_log_cleanup();
+    return 1;
+  }
+
+  BEGIN_TESTING(clear_elements);
+
+  test_extension();
+  test_carve_and_reuse();
+  test_empty_slabs();
+  test_min_free_count();
+  test_large_objects();
+  test_remove_with_live_objects();
+
+  result = FINISH_TESTING();
+
+  class_subsystem->cleanup();
+  oonf_log_cleanup();
+  return result;
+}
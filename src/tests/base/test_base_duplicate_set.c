@@ -0,0 +1,284 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <string.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/base/oonf_clock.h>
+#include <oonf/base/oonf_timer.h>
+#include <oonf/base/oonf_duplicate_set.h>
+#include <oonf/cunit/cunit.h>
+
+#define MSG_TYPE 1
+#define VTIME 10000
+
+static struct oonf_duplicate_set _set;
+static uint64_t _now;
+
+/* clock and timer stubs, the test controls the time and fires the sweep */
+uint64_t
+oonf_clock_getNow(void) {
+  return _now;
+}
+
+void
+oonf_timer_add(struct oonf_timer_class *ti __attribute__((unused))) {}
+
+void
+oonf_timer_remove(struct oonf_timer_class *ti __attribute__((unused))) {}
+
+void
+oonf_timer_start_ext(struct oonf_timer_instance *timer, uint64_t first, uint64_t interval) {
+  timer->_clock = _now + first;
+  timer->_period = interval;
+}
+
+void
+oonf_timer_stop(struct oonf_timer_instance *timer) {
+  timer->_clock = 0;
+}
+
+static struct netaddr *
+_get_addr(uint32_t i) {
+  static struct netaddr addr;
+  uint8_t bin[4];
+
+  bin[0] = 10;
+  bin[1] = (i >> 16) & 255;
+  bin[2] = (i >> 8) & 255;
+  bin[3] = i & 255;
+
+  if (netaddr_from_binary(&addr, bin, sizeof(bin), AF_INET)) {
+    netaddr_invalidate(&addr);
+  }
+  return &addr;
+}
+
+static void
+_sweep(void) {
+  CHECK_TRUE(oonf_timer_is_active(&_set._sweep), "sweep timer is not running");
+  _set._sweep.class->callback(&_set._sweep);
+}
+
+static void
+clear_elements(void) {
+  _now = 1000;
+  oonf_duplicate_set_add(&_set, OONF_DUPSET_16BIT);
+}
+
+static void
+test_insert_lookup(void) {
+  enum oonf_duplicate_result result;
+  uint32_t i;
+
+  START_TEST();
+
+  for (i = 0; i < 3; i++) {
+    result = oonf_duplicate_entry_add(&_set, MSG_TYPE, _get_addr(i), 100, VTIME);
+    CHECK_TRUE(result == OONF_DUPSET_FIRST, "add %u: %s", i, oonf_duplicate_get_result_str(result));
+  }
+  CHECK_TRUE(_set._count == 3, "count is %u", _set._count);
+
+  result = oonf_duplicate_test(&_set, MSG_TYPE, _get_addr(1), 100);
+  CHECK_TRUE(result == OONF_DUPSET_CURRENT, "test current: %s", oonf_duplicate_get_result_str(result));
+
+  result = oonf_duplicate_test(&_set, MSG_TYPE, _get_addr(1), 101);
+  CHECK_TRUE(result == OONF_DUPSET_NEWEST, "test newer: %s", oonf_duplicate_get_result_str(result));
+
+  result = oonf_duplicate_test(&_set, MSG_TYPE + 1, _get_addr(1), 100);
+  CHECK_TRUE(result == OONF_DUPSET_FIRST, "test other type: %s", oonf_duplicate_get_result_str(result));
+
+  result = oonf_duplicate_test(&_set, MSG_TYPE, _get_addr(3), 100);
+  CHECK_TRUE(result == OONF_DUPSET_FIRST, "test unknown: %s", oonf_duplicate_get_result_str(result));
+
+  result = oonf_duplicate_entry_add(&_set, MSG_TYPE, _get_addr(1), 102, VTIME);
+  CHECK_TRUE(result == OONF_DUPSET_NEWEST, "add newer: %s", oonf_duplicate_get_result_str(result));
+
+  result = oonf_duplicate_entry_add(&_set, MSG_TYPE, _get_addr(1), 101, VTIME);
+  CHECK_TRUE(result == OONF_DUPSET_NEW, "add older: %s", oonf_duplicate_get_result_str(result));
+
+  result = oonf_duplicate_entry_add(&_set, MSG_TYPE, _get_addr(1), 101, VTIME);
+  CHECK_TRUE(result == OONF_DUPSET_DUPLICATE, "add again: %s", oonf_duplicate_get_result_str(result));
+
+  result = oonf_duplicate_entry_add(&_set, MSG_TYPE, _get_addr(1), 50, VTIME);
+  CHECK_TRUE(result == OONF_DUPSET_TOO_OLD, "add too old: %s", oonf_duplicate_get_result_str(result));
+
+  CHECK_TRUE(_set._count == 3, "count is %u", _set._count);
+
+  oonf_duplicate_set_remove(&_set);
+  END_TEST();
+}
+
+static void
+test_timeout_reuse(void) {
+  enum oonf_duplicate_result result;
+
+  START_TEST();
+
+  result = oonf_duplicate_entry_add(&_set, MSG_TYPE, _get_addr(1), 100, VTIME);
+  CHECK_TRUE(result == OONF_DUPSET_FIRST, "add: %s", oonf_duplicate_get_result_str(result));
+
+  _now += VTIME + 1;
+
+  /* timed out entries are treated as missing before the sweep removed them */
+  result = oonf_duplicate_test(&_set, MSG_TYPE, _get_addr(1), 100);
+  CHECK_TRUE(result == OONF_DUPSET_FIRST, "test timed out: %s", oonf_duplicate_get_result_str(result));
+
+  /* the slot of the timed out entry is reused for the same key */
+  result = oonf_duplicate_entry_add(&_set, MSG_TYPE, _get_addr(1), 20, VTIME);
+  CHECK_TRUE(result == OONF_DUPSET_FIRST, "add again: %s", oonf_duplicate_get_result_str(result));
+  CHECK_TRUE(_set._count == 1, "count is %u", _set._count);
+
+  result = oonf_duplicate_test(&_set, MSG_TYPE, _get_addr(1), 20);
+  CHECK_TRUE(result == OONF_DUPSET_CURRENT, "test reused: %s", oonf_duplicate_get_result_str(result));
+
+  oonf_duplicate_set_remove(&_set);
+  END_TEST();
+}
+
+static void
+test_resize(void) {
+  enum oonf_duplicate_result result;
+  uint32_t i;
+
+  START_TEST();
+
+  for (i = 0; i < 1000; i++) {
+    result = oonf_duplicate_entry_add(&_set, MSG_TYPE, _get_addr(i), i, VTIME);
+    CHECK_TRUE(result == OONF_DUPSET_FIRST, "add %u: %s", i, oonf_duplicate_get_result_str(result));
+  }
+
+  CHECK_TRUE(_set._count == 1000, "count is %u", _set._count);
+  CHECK_TRUE(_set._size >= 2000, "size is %u", _set._size);
+  CHECK_TRUE((_set._size & (_set._size - 1)) == 0, "size %u is not a power of 2", _set._size);
+
+  for (i = 0; i < 1000; i++) {
+    result = oonf_duplicate_test(&_set, MSG_TYPE, _get_addr(i), i);
+    CHECK_TRUE(result == OONF_DUPSET_CURRENT, "test %u: %s", i, oonf_duplicate_get_result_str(result));
+  }
+
+  oonf_duplicate_set_remove(&_set);
+  END_TEST();
+}
+
+static void
+test_sweep(void) {
+  enum oonf_duplicate_result result;
+  uint32_t i, size;
+
+  START_TEST();
+
+  /* every second entry times out early */
+  for (i = 0; i < 200; i++) {
+    oonf_duplicate_entry_add(&_set, MSG_TYPE, _get_addr(i), i, (i & 1) ? 3 * VTIME : VTIME);
+  }
+  size = _set._size;
+
+  _now += VTIME + 1;
+  _sweep();
+
+  CHECK_TRUE(_set._count == 100, "count after first sweep is %u", _set._count);
+  CHECK_TRUE(_set._size == size, "size changed from %u to %u", size, _set._size);
+
+  /* removal must not break the probe sequences of the remaining entries */
+  for (i = 0; i < 200; i++) {
+    result = oonf_duplicate_test(&_set, MSG_TYPE, _get_addr(i), i);
+    CHECK_TRUE(result == ((i & 1) ? OONF_DUPSET_CURRENT : OONF_DUPSET_FIRST), "test %u: %s", i,
+      oonf_duplicate_get_result_str(result));
+  }
+
+  oonf_duplicate_set_remove(&_set);
+  END_TEST();
+}
+
+static void
+test_shrink(void) {
+  enum oonf_duplicate_result result;
+  uint32_t i, size;
+
+  START_TEST();
+
+  /* only a few entries survive the first sweep */
+  for (i = 0; i < 200; i++) {
+    oonf_duplicate_entry_add(&_set, MSG_TYPE, _get_addr(i), i, (i % 20) == 0 ? 3 * VTIME : VTIME);
+  }
+  size = _set._size;
+
+  _now += VTIME + 1;
+  _sweep();
+
+  CHECK_TRUE(_set._count == 10, "count after first sweep is %u", _set._count);
+  CHECK_TRUE(_set._size == size / 2, "size changed from %u to %u", size, _set._size);
+
+  for (i = 0; i < 200; i += 20) {
+    result = oonf_duplicate_test(&_set, MSG_TYPE, _get_addr(i), i);
+    CHECK_TRUE(result == OONF_DUPSET_CURRENT, "test %u: %s", i, oonf_duplicate_get_result_str(result));
+  }
+
+  /* an empty set releases its table and stops the sweep */
+  _now += 2 * VTIME;
+  _sweep();
+
+  CHECK_TRUE(_set._count == 0, "count after last sweep is %u", _set._count);
+  CHECK_TRUE(_set._table == NULL, "table was not released");
+  CHECK_TRUE(!oonf_timer_is_active(&_set._sweep), "sweep timer still running");
+
+  oonf_duplicate_set_remove(&_set);
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  BEGIN_TESTING(clear_elements);
+
+  test_insert_lookup();
+  test_timeout_reuse();
+  test_resize();
+  test_sweep();
+  test_shrink();
+
+  return FINISH_TESTING();
+}
@@ -0,0 +1,395 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/autobuf.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_http.h>
+#include <oonf/base/oonf_stream_socket.h>
+#include <oonf/base/oonf_telnet.h>
+#include <oonf/base/oonf_timer.h>
+#include <oonf/cunit/cunit.h>
+
+#define VERSION "0815"
+
+static struct oonf_appdata _appdata = {
+  .app_name = "test_base_http",
+};
+
+static struct oonf_stream_managed *_http_managed;
+
+static enum oonf_http_result _cb_etag_site(struct autobuf *out, struct oonf_http_session *session);
+static enum oonf_telnet_result _cb_version(struct oonf_telnet_data *data);
+
+static struct oonf_http_handler _etag_site = {
+  .site = "/etag",
+  .content_handler = _cb_etag_site,
+  .acl =
+    {
+      .accept_default = true,
+    },
+};
+
+static struct oonf_telnet_command _telnet_cmds[] = {
+  TELNET_CMD("version", _cb_version, "Versioned test output"),
+};
+
+/* true if the telnet command should stream its output */
+static bool _stream;
+
+/* number of streamed parts still to send */
+static int _parts;
+
+/* true if the streamed output has been stopped */
+static bool _stopped;
+
+/* stream socket stubs, the test sends the output buffer itself */
+void
+oonf_stream_add_managed(struct oonf_stream_managed *managed) {
+  if (managed->config.memcookie != NULL && strcmp(managed->config.memcookie->name, "http session") == 0) {
+    _http_managed = managed;
+  }
+}
+
+int
+oonf_stream_apply_managed(
+  struct oonf_stream_managed *managed __attribute__((unused)), struct oonf_stream_managed_config *config
+  __attribute__((unused))) {
+  return 0;
+}
+
+void
+oonf_stream_remove_managed(struct oonf_stream_managed *managed __attribute__((unused)), bool force
+  __attribute__((unused))) {}
+
+void
+oonf_stream_free_managed_config(struct oonf_stream_managed_config *config __attribute__((unused))) {}
+
+void
+oonf_stream_flush(struct oonf_stream_session *con __attribute__((unused))) {}
+
+void
+oonf_stream_set_timeout(struct oonf_stream_session *con __attribute__((unused)), uint64_t timeout
+  __attribute__((unused))) {}
+
+/* timer stubs, timers never fire */
+void
+oonf_timer_add(struct oonf_timer_class *ti __attribute__((unused))) {}
+
+void
+oonf_timer_remove(struct oonf_timer_class *ti __attribute__((unused))) {}
+
+void
+oonf_timer_start_ext(struct oonf_timer_instance *timer, uint64_t first, uint64_t interval) {
+  timer->_clock = first;
+  timer->_period = interval;
+}
+
+void
+oonf_timer_stop(struct oonf_timer_instance *timer) {
+  timer->_clock = 0;
+}
+
+static enum oonf_http_result
+_cb_etag_site(struct autobuf *out, struct oonf_http_session *session) {
+  session->etag = VERSION;
+  abuf_puts(out, "content");
+  return HTTP_200_OK;
+}
+
+static void
+_cb_stop_version(struct oonf_telnet_data *data __attribute__((unused))) {
+  _stopped = true;
+}
+
+static bool
+_cb_underrun_version(struct oonf_telnet_data *data) {
+  abuf_puts(data->out, "part\n");
+  return --_parts == 0;
+}
+
+static enum oonf_telnet_result
+_cb_version(struct oonf_telnet_data *data) {
+  strscpy(data->output_version, VERSION, sizeof(data->output_version));
+  abuf_puts(data->out, "version\n");
+
+  if (!_stream || !data->allow_streaming) {
+    return TELNET_RESULT_ACTIVE;
+  }
+
+  data->stop_handler = _cb_stop_version;
+  data->underrun_handler = _cb_underrun_version;
+  return TELNET_RESULT_CONTINOUS;
+}
+
+/**
+ * Send a http request to the server
+ * @param request http request
+ * @param state pointer to state of http session after request
+ * @return new http session, must be freed with _free_session()
+ */
+static struct oonf_telnet_session *
+_request(const char *request, enum oonf_stream_session_state *state) {
+  struct oonf_telnet_session *session;
+
+  session = oonf_class_malloc(_http_managed->config.memcookie);
+  abuf_init(&session->session.in);
+  abuf_init(&session->session.out);
+  session->session.state = STREAM_SESSION_ACTIVE;
+
+  abuf_puts(&session->session.in, request);
+  *state = _http_managed->config.receive_data(&session->session);
+  return session;
+}
+
+static void
+_free_session(struct oonf_telnet_session *session) {
+  _http_managed->config.cleanup_session(&session->session);
+  abuf_free(&session->session.in);
+  abuf_free(&session->session.out);
+  oonf_class_free(_http_managed->config.memcookie, session);
+}
+
+/**
+ * @param session http session
+ * @return body of http response
+ */
+static const char *
+_get_body(struct oonf_telnet_session *session) {
+  const char *ptr;
+
+  ptr = strstr(abuf_getptr(&session->session.out), "\r\n\r\n");
+  return ptr ? ptr + 4 : "";
+}
+
+static bool
+_has_line(struct oonf_telnet_session *session, const char *line) {
+  return strstr(abuf_getptr(&session->session.out), line) != NULL;
+}
+
+static void
+clear_elements(void) {
+  _stream = false;
+  _parts = 0;
+  _stopped = false;
+}
+
+static void
+test_etag(void) {
+  struct oonf_telnet_session *session;
+  enum oonf_stream_session_state state;
+
+  START_TEST();
+
+  session = _request("GET /etag HTTP/1.1\r\n\r\n", &state);
+  CHECK_TRUE(state == STREAM_SESSION_SEND_AND_QUIT, "wrong state %d", state);
+  CHECK_TRUE(_has_line(session, "HTTP/1.0 200 OK\r\n"), "no 200 response");
+  CHECK_TRUE(_has_line(session, "\r\nETag: \"" VERSION "\"\r\n"), "no strong ETag");
+  CHECK_TRUE(_has_line(session, "\r\nContent-length: 7\r\n"), "no content length");
+  CHECK_TRUE(strcmp(_get_body(session), "content") == 0, "wrong body: %s", _get_body(session));
+  _free_session(session);
+
+  END_TEST();
+}
+
+static void
+test_if_none_match(void) {
+  static const char *MATCHING[] = {
+    "\"" VERSION "\"",
+    "W/\"" VERSION "\"",
+    "\"1234\", \"" VERSION "\"",
+    "\"1234\",W/\"" VERSION "\"",
+    "*",
+  };
+  static const char *NOT_MATCHING[] = {
+    "\"1234\"",
+    "\"081\"",
+    "\"08150\"",
+    VERSION,
+    "\"\"",
+  };
+  struct oonf_telnet_session *session;
+  enum oonf_stream_session_state state;
+  char request[256];
+  size_t i;
+
+  START_TEST();
+
+  for (i = 0; i < ARRAYSIZE(MATCHING); i++) {
+    snprintf(request, sizeof(request), "GET /etag HTTP/1.1\r\nIf-None-Match: %s\r\n\r\n", MATCHING[i]);
+    session = _request(request, &state);
+    CHECK_TRUE(_has_line(session, "HTTP/1.0 304 Not Modified\r\n"), "no 304 response for %s", MATCHING[i]);
+    CHECK_TRUE(_has_line(session, "\r\nETag: \"" VERSION "\"\r\n"), "no ETag in 304 response for %s", MATCHING[i]);
+    CHECK_TRUE(!_has_line(session, "Content-length"), "content length in 304 response for %s", MATCHING[i]);
+    CHECK_TRUE(*_get_body(session) == 0, "body in 304 response for %s", MATCHING[i]);
+    _free_session(session);
+  }
+
+  for (i = 0; i < ARRAYSIZE(NOT_MATCHING); i++) {
+    snprintf(request, sizeof(request), "GET /etag HTTP/1.1\r\nIf-None-Match: %s\r\n\r\n", NOT_MATCHING[i]);
+    session = _request(request, &state);
+    CHECK_TRUE(_has_line(session, "HTTP/1.0 200 OK\r\n"), "no 200 response for %s", NOT_MATCHING[i]);
+    CHECK_TRUE(strcmp(_get_body(session), "content") == 0, "wrong body for %s", NOT_MATCHING[i]);
+    _free_session(session);
+  }
+
+  END_TEST();
+}
+
+static void
+test_telnet_etag(void) {
+  struct oonf_telnet_session *session;
+  enum oonf_stream_session_state state;
+
+  START_TEST();
+
+  session = _request("GET /telnet/version HTTP/1.1\r\n\r\n", &state);
+  CHECK_TRUE(_has_line(session, "HTTP/1.0 200 OK\r\n"), "no 200 response");
+  CHECK_TRUE(_has_line(session, "\r\nETag: \"" VERSION "\"\r\n"), "no strong ETag");
+  CHECK_TRUE(strcmp(_get_body(session), "version\n") == 0, "wrong body: %s", _get_body(session));
+  _free_session(session);
+
+  session = _request("GET /telnet/version HTTP/1.1\r\nIf-None-Match: \"" VERSION "\"\r\n\r\n", &state);
+  CHECK_TRUE(_has_line(session, "HTTP/1.0 304 Not Modified\r\n"), "no 304 response");
+  CHECK_TRUE(*_get_body(session) == 0, "body in 304 response");
+  _free_session(session);
+
+  /* command chains have no version */
+  session = _request("GET /telnet/version/version HTTP/1.1\r\nIf-None-Match: *\r\n\r\n", &state);
+  CHECK_TRUE(_has_line(session, "HTTP/1.0 200 OK\r\n"), "no 200 response for command chain");
+  CHECK_TRUE(!_has_line(session, "ETag"), "ETag for command chain");
+  CHECK_TRUE(strcmp(_get_body(session), "version\nversion\n") == 0, "wrong body: %s", _get_body(session));
+  _free_session(session);
+
+  END_TEST();
+}
+
+static void
+test_stream_etag(void) {
+  struct oonf_telnet_session *session;
+  enum oonf_stream_session_state state;
+  int i;
+
+  START_TEST();
+
+  /* streamed output can change before it is complete, so its tag is weak */
+  _stream = true;
+  _parts = 3;
+  session = _request("GET /telnet/version HTTP/1.1\r\n\r\n", &state);
+  CHECK_TRUE(state == STREAM_SESSION_ACTIVE, "streamed response not active: %d", state);
+  CHECK_TRUE(_has_line(session, "HTTP/1.0 200 OK\r\n"), "no 200 response");
+  CHECK_TRUE(_has_line(session, "\r\nETag: W/\"" VERSION "\"\r\n"), "no weak ETag");
+  CHECK_TRUE(!_has_line(session, "Content-length"), "content length for streamed response");
+  CHECK_TRUE(strcmp(_get_body(session), "version\n") == 0, "wrong body: %s", _get_body(session));
+
+  for (i = 0; i < 3; i++) {
+    abuf_clear(&session->session.out);
+    state = _http_managed->config.buffer_underrun(&session->session);
+    CHECK_TRUE(strcmp(abuf_getptr(&session->session.out), "part\n") == 0, "wrong part %d: %s", i,
+      abuf_getptr(&session->session.out));
+  }
+  CHECK_TRUE(state == STREAM_SESSION_SEND_AND_QUIT, "streamed response not finished: %d", state);
+  CHECK_TRUE(_stopped, "stream not stopped at the end");
+  _free_session(session);
+
+  /* weak tag of the client matches, stream is stopped without output */
+  _stopped = false;
+  _parts = 3;
+  session = _request("GET /telnet/version HTTP/1.1\r\nIf-None-Match: W/\"" VERSION "\"\r\n\r\n", &state);
+  CHECK_TRUE(state == STREAM_SESSION_SEND_AND_QUIT, "304 response not finished: %d", state);
+  CHECK_TRUE(_has_line(session, "HTTP/1.0 304 Not Modified\r\n"), "no 304 response");
+  CHECK_TRUE(_has_line(session, "\r\nETag: W/\"" VERSION "\"\r\n"), "no weak ETag in 304 response");
+  CHECK_TRUE(*_get_body(session) == 0, "body in 304 response");
+  CHECK_TRUE(_stopped, "stream not stopped for 304 response");
+  CHECK_TRUE(session->data.underrun_handler == NULL, "underrun handler still set");
+  _free_session(session);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  struct oonf_subsystem *class_subsystem, *telnet, *http;
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+
+  class_subsystem = oonf_subsystem_get(OONF_CLASS_SUBSYSTEM);
+  telnet = oonf_subsystem_get(OONF_TELNET_SUBSYSTEM);
+  http = oonf_subsystem_get(OONF_HTTP_SUBSYSTEM);
+  if (class_subsystem == NULL || telnet == NULL || http == NULL || class_subsystem->init()) {
+    oonf_log_cleanup();
+    return 1;
+  }
+  telnet->init();
+  http->init();
+
+  oonf_http_add(&_etag_site);
+  oonf_telnet_add(&_telnet_cmds[0]);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_etag();
+  test_if_none_match();
+  test_telnet_etag();
+  test_stream_etag();
+
+  result = FINISH_TESTING();
+
+  oonf_telnet_remove(&_telnet_cmds[0]);
+  oonf_http_remove(&_etag_site);
+  http->cleanup();
+  telnet->cleanup();
+  class_subsystem->cleanup();
+  oonf_log_cleanup();
+  return result;
+}
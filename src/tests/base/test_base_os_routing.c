@@ -0,0 +1,627 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <linux/rtnetlink.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcore/oonf_appdata.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_timer.h>
+#include <oonf/base/os_routing.h>
+#include <oonf/cunit/cunit.h>
+
+#define MAX_MESSAGES 16
+
+static struct oonf_appdata _appdata = {
+  .app_name = "test_base_os_routing",
+};
+
+static struct os_system_netlink *_netlink;
+static int _msg_type[MAX_MESSAGES];
+static int _msg_count;
+
+static struct os_route _routes[2];
+static int _finished[2];
+static int _result[2];
+
+static struct oonf_timer_instance *_timer;
+
+/* subscriber of the route mirror that records the reported changes */
+struct _test_subscriber {
+  struct os_route_mirror_subscriber mirror;
+  int set_count;
+  int remove_count;
+  struct os_route last;
+};
+
+/* netlink stubs, the routing subsystem talks to these instead of the kernel */
+bool
+os_system_linux_is_minimal_kernel(int v1 __attribute__((unused)), int v2 __attribute__((unused)),
+  int v3 __attribute__((unused))) {
+  return true;
+}
+
+int
+os_system_linux_netlink_add(struct os_system_netlink *nl, int protocol __attribute__((unused))) {
+  _netlink = nl;
+  return 0;
+}
+
+int
+os_system_linux_netlink_add_mc(struct os_system_netlink *nl __attribute__((unused)),
+  const uint32_t *groups __attribute__((unused)), size_t groupcount __attribute__((unused))) {
+  return 0;
+}
+
+void
+os_system_linux_netlink_remove(struct os_system_netlink *nl __attribute__((unused))) {}
+
+void
+os_system_linux_netlink_flush(struct os_system_netlink *nl __attribute__((unused))) {}
+
+int
+os_system_linux_netlink_addreq(struct os_system_netlink *nl __attribute__((unused)),
+  struct nlmsghdr *n __attribute__((unused)), int type __attribute__((unused)),
+  const void *data __attribute__((unused)), int len __attribute__((unused))) {
+  return 0;
+}
+
+int
+os_system_linux_netlink_send(struct os_system_netlink *nl __attribute__((unused)), struct nlmsghdr *nl_hdr) {
+  if (_msg_count < MAX_MESSAGES) {
+    _msg_type[_msg_count] = nl_hdr->nlmsg_type;
+  }
+  _msg_count++;
+
+  /* sequence numbers start with 1 */
+  return _msg_count;
+}
+
+/* timer stubs, the test triggers the timer callbacks itself */
+void
+oonf_timer_add(struct oonf_timer_class *ti __attribute__((unused))) {}
+
+void
+oonf_timer_remove(struct oonf_timer_class *ti __attribute__((unused))) {}
+
+void
+oonf_timer_set_ext(struct oonf_timer_instance *timer, uint64_t first, uint64_t interval) {
+  if (first == 0) {
+    oonf_timer_stop(timer);
+    return;
+  }
+  oonf_timer_start_ext(timer, first, interval);
+}
+
+void
+oonf_timer_start_ext(struct oonf_timer_instance *timer, uint64_t first, uint64_t interval) {
+  timer->_clock = first;
+  timer->_period = interval;
+  _timer = timer;
+}
+
+void
+oonf_timer_stop(struct oonf_timer_instance *timer) {
+  timer->_clock = 0;
+}
+
+static void
+_cb_finished(struct os_route *route, int error) {
+  _finished[route - _routes]++;
+  _result[route - _routes] = error;
+}
+
+static void
+_init_route(struct os_route *route, uint32_t if_index) {
+  static const uint8_t dst[] = { 10, 0, 0, 0 };
+
+  memset(route, 0, sizeof(*route));
+
+  route->p.family = AF_INET;
+  route->p.type = OS_ROUTE_UNICAST;
+  route->p.table = RT_TABLE_MAIN;
+  route->p.protocol = RTPROT_STATIC;
+  route->p.metric = 1;
+  route->p.if_index = if_index;
+  netaddr_from_binary_prefix(&route->p.key.dst, dst, sizeof(dst), AF_INET, 24);
+
+  route->cb_finished = _cb_finished;
+}
+
+static void
+_cb_mirror(struct os_route_mirror_subscriber *mirror, const struct os_route *route, bool set) {
+  struct _test_subscriber *subscriber;
+
+  subscriber = container_of(mirror, struct _test_subscriber, mirror);
+  if (set) {
+    subscriber->set_count++;
+  }
+  else {
+    subscriber->remove_count++;
+  }
+  memcpy(&subscriber->last, route, sizeof(*route));
+}
+
+static void
+_init_subscriber(struct _test_subscriber *subscriber) {
+  memset(subscriber, 0, sizeof(*subscriber));
+  os_routing_init_wildcard_route(&subscriber->mirror.filter);
+  subscriber->mirror.cb_get = _cb_mirror;
+}
+
+static void
+_reset_subscriber(struct _test_subscriber *subscriber) {
+  subscriber->set_count = 0;
+  subscriber->remove_count = 0;
+}
+
+/* subscribe and let the seeding dump of the kernel tables finish */
+static void
+_subscribe_first(struct _test_subscriber *subscriber) {
+  os_routing_mirror_add(&subscriber->mirror);
+  _netlink->cb_done(_msg_count);
+}
+
+static void
+_add_attribute(struct nlmsghdr *msg, int type, const void *data, size_t len) {
+  struct rtattr *rta;
+
+  rta = (struct rtattr *)(((uint8_t *)msg) + NLMSG_ALIGN(msg->nlmsg_len));
+  rta->rta_type = type;
+  rta->rta_len = RTA_LENGTH(len);
+  memcpy(RTA_DATA(rta), data, len);
+  msg->nlmsg_len = NLMSG_ALIGN(msg->nlmsg_len) + RTA_ALIGN(rta->rta_len);
+}
+
+/* send a multicast route message of the kernel to the routing subsystem */
+static void
+_kernel_route(bool set, uint8_t table, uint8_t protocol, uint8_t dst, uint32_t metric, uint32_t if_index) {
+  uint32_t buffer[64];
+  struct nlmsghdr *msg;
+  struct rtmsg *rt_msg;
+  uint8_t prefix[4] = { 10, 0, 0, 0 };
+
+  memset(buffer, 0, sizeof(buffer));
+  msg = (struct nlmsghdr *)buffer;
+  msg->nlmsg_type = set ? RTM_NEWROUTE : RTM_DELROUTE;
+  msg->nlmsg_len = NLMSG_LENGTH(sizeof(*rt_msg));
+
+  rt_msg = NLMSG_DATA(msg);
+  rt_msg->rtm_family = AF_INET;
+  rt_msg->rtm_dst_len = 24;
+  rt_msg->rtm_table = table;
+  rt_msg->rtm_protocol = protocol;
+  rt_msg->rtm_type = RTN_UNICAST;
+
+  prefix[2] = dst;
+  _add_attribute(msg, RTA_DST, prefix, sizeof(prefix));
+  _add_attribute(msg, RTA_PRIORITY, &metric, sizeof(metric));
+  _add_attribute(msg, RTA_OIF, &if_index, sizeof(if_index));
+
+  _netlink->cb_message(msg);
+}
+
+static void
+clear_elements(void) {
+  _msg_count = 0;
+  memset(_finished, 0, sizeof(_finished));
+  memset(_result, 0, sizeof(_result));
+
+  /* both route objects change the same kernel route */
+  _init_route(&_routes[0], 1);
+  _init_route(&_routes[1], 2);
+}
+
+/* acknowledge all messages sent to the kernel */
+static void
+_ack_all(void) {
+  int seq;
+
+  for (seq = 1; seq <= _msg_count; seq++) {
+    _netlink->cb_done(seq);
+  }
+}
+
+static void
+test_tx_same_object(void) {
+  START_TEST();
+
+  os_routing_transaction_begin();
+  os_routing_set(&_routes[0], true, false);
+  os_routing_set(&_routes[0], false, false);
+  os_routing_transaction_commit();
+
+  CHECK_TRUE(_msg_count == 1, "%d messages sent", _msg_count);
+  CHECK_TRUE(_msg_type[0] == RTM_DELROUTE, "sent message type %d", _msg_type[0]);
+
+  _ack_all();
+  CHECK_TRUE(_finished[0] == 1, "route finished %d times", _finished[0]);
+  CHECK_TRUE(_result[0] == 0, "route result %d", _result[0]);
+
+  END_TEST();
+}
+
+static void
+test_tx_set_remove_other(void) {
+  START_TEST();
+
+  os_routing_transaction_begin();
+  os_routing_set(&_routes[0], true, false);
+  os_routing_set(&_routes[1], false, false);
+  os_routing_transaction_commit();
+
+  CHECK_TRUE(_msg_count == 1, "%d messages sent", _msg_count);
+  CHECK_TRUE(_msg_type[0] == RTM_DELROUTE, "sent message type %d", _msg_type[0]);
+
+  /* the kernel route will not be set, so the superseded change failed */
+  CHECK_TRUE(_finished[0] == 1, "superseded route finished %d times", _finished[0]);
+  CHECK_TRUE(_result[0] != 0, "superseded route result %d", _result[0]);
+
+  _ack_all();
+  CHECK_TRUE(_finished[1] == 1, "winning route finished %d times", _finished[1]);
+  CHECK_TRUE(_result[1] == 0, "winning route result %d", _result[1]);
+  CHECK_TRUE(_finished[0] == 1, "superseded route finished %d times", _finished[0]);
+
+  END_TEST();
+}
+
+static void
+test_tx_set_set_other(void) {
+  START_TEST();
+
+  os_routing_transaction_begin();
+  os_routing_set(&_routes[0], true, false);
+  os_routing_set(&_routes[1], true, false);
+  os_routing_transaction_commit();
+
+  CHECK_TRUE(_msg_count == 1, "%d messages sent", _msg_count);
+  CHECK_TRUE(_msg_type[0] == RTM_NEWROUTE, "sent message type %d", _msg_type[0]);
+
+  /* the kernel route is set by the newer change */
+  CHECK_TRUE(_finished[0] == 1, "superseded route finished %d times", _finished[0]);
+  CHECK_TRUE(_result[0] == 0, "superseded route result %d", _result[0]);
+
+  _ack_all();
+  CHECK_TRUE(_finished[1] == 1, "winning route finished %d times", _finished[1]);
+  CHECK_TRUE(_result[1] == 0, "winning route result %d", _result[1]);
+
+  END_TEST();
+}
+
+static void
+test_tx_interrupt_winner(void) {
+  START_TEST();
+
+  os_routing_transaction_begin();
+  os_routing_set(&_routes[0], true, false);
+  os_routing_set(&_routes[1], false, false);
+  os_routing_interrupt(&_routes[1]);
+  os_routing_transaction_commit();
+
+  CHECK_TRUE(_finished[1] == 1, "interrupted route finished %d times", _finished[1]);
+  CHECK_TRUE(_result[1] != 0, "interrupted route result %d", _result[1]);
+
+  /* without the newer change the superseded one goes to the kernel */
+  CHECK_TRUE(_msg_count == 1, "%d messages sent", _msg_count);
+  CHECK_TRUE(_msg_type[0] == RTM_NEWROUTE, "sent message type %d", _msg_type[0]);
+
+  _ack_all();
+  CHECK_TRUE(_finished[0] == 1, "superseded route finished %d times", _finished[0]);
+  CHECK_TRUE(_result[0] == 0, "superseded route result %d", _result[0]);
+
+  END_TEST();
+}
+
+static void
+test_mirror_retry(void) {
+  struct os_route_mirror_subscriber subscriber;
+
+  START_TEST();
+
+  memset(&subscriber, 0, sizeof(subscriber));
+  os_routing_init_wildcard_route(&subscriber.filter);
+
+  /* first subscriber starts the dump of the kernel routing tables */
+  os_routing_mirror_add(&subscriber);
+  CHECK_TRUE(_msg_count == 1, "%d messages sent", _msg_count);
+  CHECK_TRUE(_msg_type[0] == RTM_GETROUTE, "sent message type %d", _msg_type[0]);
+
+  /* a failed dump is repeated later */
+  _timer = NULL;
+  _netlink->cb_error(1, EBUSY);
+  CHECK_TRUE(_timer != NULL && oonf_timer_is_active(_timer), "no retry scheduled");
+
+  /* the last subscriber stops a pending retry */
+  os_routing_mirror_remove(&subscriber);
+  CHECK_TRUE(_timer != NULL && !oonf_timer_is_active(_timer), "retry still scheduled without subscribers");
+
+  /* fail the dump of the next subscriber again */
+  os_routing_mirror_add(&subscriber);
+  CHECK_TRUE(_msg_count == 2, "%d messages sent", _msg_count);
+  _netlink->cb_error(2, EBUSY);
+
+  if (_timer != NULL && oonf_timer_is_active(_timer)) {
+    /* fire the retry timer */
+    oonf_timer_stop(_timer);
+    _timer->class->callback(_timer);
+
+    CHECK_TRUE(_msg_count == 3, "%d messages sent", _msg_count);
+    CHECK_TRUE(_msg_type[2] == RTM_GETROUTE, "sent message type %d", _msg_type[2]);
+
+    /* a successful dump does not schedule another one */
+    _netlink->cb_done(3);
+    CHECK_TRUE(!oonf_timer_is_active(_timer), "retry scheduled after successful dump");
+  }
+  else {
+    CHECK_TRUE(false, "no retry scheduled for second subscriber");
+  }
+
+  os_routing_mirror_remove(&subscriber);
+
+  END_TEST();
+}
+
+static void
+test_mirror_update(void) {
+  struct _test_subscriber subscriber;
+
+  START_TEST();
+
+  _init_subscriber(&subscriber);
+  _subscribe_first(&subscriber);
+
+  /* new route */
+  _kernel_route(true, RT_TABLE_MAIN, RTPROT_STATIC, 1, 10, 1);
+  CHECK_TRUE(subscriber.set_count == 1, "new route reported %d times", subscriber.set_count);
+  CHECK_TRUE(os_routing_mirror_get_size() == 1, "mirror has %" PRINTF_SIZE_T_SPECIFIER " routes",
+    os_routing_mirror_get_size());
+
+  /* repeated announcement of an unchanged route */
+  _kernel_route(true, RT_TABLE_MAIN, RTPROT_STATIC, 1, 10, 1);
+  CHECK_TRUE(subscriber.set_count == 1, "unchanged route reported %d times", subscriber.set_count);
+
+  /* same kernel identity, different interface */
+  _kernel_route(true, RT_TABLE_MAIN, RTPROT_STATIC, 1, 10, 2);
+  CHECK_TRUE(subscriber.set_count == 2, "changed route reported %d times", subscriber.set_count);
+  CHECK_TRUE(subscriber.last.p.if_index == 2, "changed route has interface %u", subscriber.last.p.if_index);
+  CHECK_TRUE(os_routing_mirror_get_size() == 1, "mirror has %" PRINTF_SIZE_T_SPECIFIER " routes",
+    os_routing_mirror_get_size());
+
+  /* a different metric is a different kernel route */
+  _kernel_route(true, RT_TABLE_MAIN, RTPROT_STATIC, 1, 20, 1);
+  CHECK_TRUE(subscriber.set_count == 3, "second route reported %d times", subscriber.set_count);
+  CHECK_TRUE(os_routing_mirror_get_size() == 2, "mirror has %" PRINTF_SIZE_T_SPECIFIER " routes",
+    os_routing_mirror_get_size());
+
+  /* removal */
+  _kernel_route(false, RT_TABLE_MAIN, RTPROT_STATIC, 1, 10, 2);
+  CHECK_TRUE(subscriber.remove_count == 1, "removal reported %d times", subscriber.remove_count);
+  CHECK_TRUE(subscriber.last.p.metric == 10, "removed route has metric %d", subscriber.last.p.metric);
+  CHECK_TRUE(os_routing_mirror_get_size() == 1, "mirror has %" PRINTF_SIZE_T_SPECIFIER " routes",
+    os_routing_mirror_get_size());
+
+  /* removal of an unknown route */
+  _kernel_route(false, RT_TABLE_MAIN, RTPROT_STATIC, 1, 10, 2);
+  CHECK_TRUE(subscriber.remove_count == 1, "unknown removal reported %d times", subscriber.remove_count);
+
+  /* the last subscriber clears the mirror */
+  os_routing_mirror_remove(&subscriber.mirror);
+  CHECK_TRUE(os_routing_mirror_get_size() == 0, "mirror has %" PRINTF_SIZE_T_SPECIFIER " routes",
+    os_routing_mirror_get_size());
+
+  END_TEST();
+}
+
+static void
+test_mirror_refresh(void) {
+  struct _test_subscriber plain, refresh;
+
+  START_TEST();
+
+  _init_subscriber(&plain);
+  _init_subscriber(&refresh);
+  refresh.mirror.want_refresh = true;
+  refresh.mirror.filter.p.protocol = RTPROT_STATIC;
+
+  _subscribe_first(&plain);
+  os_routing_mirror_add(&refresh.mirror);
+
+  _kernel_route(true, RT_TABLE_MAIN, RTPROT_STATIC, 1, 10, 1);
+  _kernel_route(true, RT_TABLE_MAIN, RTPROT_BOOT, 2, 10, 1);
+  CHECK_TRUE(plain.set_count == 2, "plain subscriber got %d routes", plain.set_count);
+  CHECK_TRUE(refresh.set_count == 1, "refresh subscriber got %d routes", refresh.set_count);
+
+  /* only the subscriber that asked for it gets the unchanged routes */
+  _kernel_route(true, RT_TABLE_MAIN, RTPROT_STATIC, 1, 10, 1);
+  _kernel_route(true, RT_TABLE_MAIN, RTPROT_BOOT, 2, 10, 1);
+  CHECK_TRUE(plain.set_count == 2, "plain subscriber got %d refreshes", plain.set_count - 2);
+  CHECK_TRUE(refresh.set_count == 2, "refresh subscriber got %d refreshes", refresh.set_count - 1);
+
+  os_routing_mirror_remove(&refresh.mirror);
+  os_routing_mirror_remove(&plain.mirror);
+
+  END_TEST();
+}
+
+static void
+test_mirror_filter_move(void) {
+  struct _test_subscriber subscriber;
+
+  START_TEST();
+
+  _init_subscriber(&subscriber);
+  subscriber.mirror.filter.p.protocol = RTPROT_STATIC;
+  _subscribe_first(&subscriber);
+
+  _kernel_route(true, RT_TABLE_MAIN, RTPROT_STATIC, 1, 10, 1);
+  CHECK_TRUE(subscriber.set_count == 1, "matching route reported %d times", subscriber.set_count);
+
+  /* the protocol is not part of the kernel identity, the route moves out of the filter */
+  _kernel_route(true, RT_TABLE_MAIN, RTPROT_BOOT, 1, 10, 1);
+  CHECK_TRUE(subscriber.remove_count == 1, "move out of filter reported %d times as removal",
+    subscriber.remove_count);
+  CHECK_TRUE(subscriber.last.p.protocol == RTPROT_STATIC, "removal reported with protocol %u",
+    subscriber.last.p.protocol);
+  CHECK_TRUE(subscriber.set_count == 1, "route outside of filter reported");
+
+  /* changes outside of the filter are not reported */
+  _kernel_route(true, RT_TABLE_MAIN, RTPROT_BOOT, 1, 10, 2);
+  _kernel_route(false, RT_TABLE_MAIN, RTPROT_BOOT, 1, 10, 2);
+  CHECK_TRUE(subscriber.set_count == 1 && subscriber.remove_count == 1, "changes outside of filter reported");
+
+  /* back into the filter */
+  _kernel_route(true, RT_TABLE_MAIN, RTPROT_BOOT, 1, 10, 1);
+  _kernel_route(true, RT_TABLE_MAIN, RTPROT_STATIC, 1, 10, 1);
+  CHECK_TRUE(subscriber.set_count == 2, "move into filter reported %d times", subscriber.set_count - 1);
+
+  os_routing_mirror_remove(&subscriber.mirror);
+
+  END_TEST();
+}
+
+static void
+test_mirror_replay(void) {
+  struct _test_subscriber all, table, table_protocol;
+
+  START_TEST();
+
+  _init_subscriber(&all);
+  _init_subscriber(&table);
+  _init_subscriber(&table_protocol);
+  table.mirror.filter.p.table = 100;
+  table_protocol.mirror.filter.p.table = 100;
+  table_protocol.mirror.filter.p.protocol = RTPROT_STATIC;
+
+  _subscribe_first(&all);
+  _kernel_route(true, RT_TABLE_MAIN, RTPROT_STATIC, 1, 10, 1);
+  _kernel_route(true, 99, RTPROT_STATIC, 1, 10, 1);
+  _kernel_route(true, 100, RTPROT_BOOT, 4, 10, 1);
+  _kernel_route(true, 100, RTPROT_STATIC, 1, 10, 1);
+  _kernel_route(true, 100, RTPROT_STATIC, 2, 10, 1);
+  _kernel_route(true, 100, RTPROT_STATIC, 3, 5, 1);
+  _kernel_route(true, 100, RTPROT_KERNEL, 5, 10, 1);
+  _kernel_route(true, 101, RTPROT_STATIC, 1, 10, 1);
+  CHECK_TRUE(all.set_count == 8, "%d routes reported", all.set_count);
+
+  /* later subscribers get the matching part of the mirror immediately */
+  os_routing_mirror_add(&table.mirror);
+  CHECK_TRUE(table.set_count == 5, "table subscriber got %d routes", table.set_count);
+  os_routing_mirror_add(&table_protocol.mirror);
+  CHECK_TRUE(table_protocol.set_count == 3, "table/protocol subscriber got %d routes", table_protocol.set_count);
+  CHECK_TRUE(table_protocol.last.p.table == 100 && table_protocol.last.p.protocol == RTPROT_STATIC,
+    "table/protocol subscriber got route of table %u protocol %u", table_protocol.last.p.table,
+    table_protocol.last.p.protocol);
+
+  _reset_subscriber(&all);
+  _reset_subscriber(&table);
+  _reset_subscriber(&table_protocol);
+
+  /* replay and a second add report the same routes */
+  os_routing_mirror_replay(&all.mirror);
+  os_routing_mirror_replay(&table.mirror);
+  os_routing_mirror_add(&table_protocol.mirror);
+  CHECK_TRUE(all.set_count == 8, "replay reported %d routes", all.set_count);
+  CHECK_TRUE(table.set_count == 5, "table replay reported %d routes", table.set_count);
+  CHECK_TRUE(table_protocol.set_count == 3, "table/protocol replay reported %d routes", table_protocol.set_count);
+  CHECK_TRUE(all.remove_count + table.remove_count + table_protocol.remove_count == 0, "replay reported removals");
+
+  /* other filter fields still apply for a ranged replay */
+  _reset_subscriber(&table);
+  table.mirror.filter.p.metric = 5;
+  os_routing_mirror_replay(&table.mirror);
+  CHECK_TRUE(table.set_count == 1, "table/metric replay reported %d routes", table.set_count);
+
+  /* a table without routes */
+  _reset_subscriber(&table);
+  table.mirror.filter.p.table = 102;
+  table.mirror.filter.p.metric = -1;
+  os_routing_mirror_replay(&table.mirror);
+  CHECK_TRUE(table.set_count == 0, "empty table replay reported %d routes", table.set_count);
+
+  os_routing_mirror_remove(&table_protocol.mirror);
+  os_routing_mirror_remove(&table.mirror);
+  os_routing_mirror_remove(&all.mirror);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  struct oonf_subsystem *class_subsystem, *routing_subsystem;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+
+  class_subsystem = oonf_subsystem_get(OONF_CLASS_SUBSYSTEM);
+  routing_subsystem = oonf_subsystem_get(OONF_OS_ROUTING_SUBSYSTEM);
+  if (class_subsystem == NULL || routing_subsystem == NULL || class_subsystem->init() || routing_subsystem->init()) {
+    oonf_log_cleanup();
+    return 1;
+  }
+
+  BEGIN_TESTING(clear_elements);
+
+  test_tx_same_object();
+  test_tx_set_remove_other();
+  test_tx_set_set_other();
+  test_tx_interrupt_winner();
+  test_mirror_retry();
+  test_mirror_update();
+  test_mirror_refresh();
+  test_mirror_filter_move();
+  test_mirror_replay();
+
+  routing_subsystem->cleanup();
+  class_subsystem->cleanup();
+  oonf_log_cleanup();
+  return FINISH_TESTING();
+}
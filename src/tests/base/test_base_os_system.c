@@ -0,0 +1,511 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+/* must be first because of a problem with linux/rtnetlink.h */
+#include <sys/socket.h>
+
+#include <errno.h>
+#include <string.h>
+
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcore/oonf_appdata.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_socket.h>
+#include <oonf/base/oonf_timer.h>
+#include <oonf/base/os_system.h>
+#include <oonf/cunit/cunit.h>
+
+#define MAX_MESSAGES 32
+
+/* payload of a test message, three of them fit into a netlink buffer */
+#define PAYLOAD_SIZE 1200
+
+static struct oonf_appdata _appdata = {
+  .app_name = "test_base_os_system",
+};
+
+static struct oonf_subsystem _test_subsystem = {
+  .name = "test",
+};
+
+static void _cb_message(struct nlmsghdr *hdr);
+static void _cb_error(uint32_t seq, int error);
+static void _cb_done(uint32_t seq);
+
+static struct os_system_netlink _netlink = {
+  .name = "test",
+  .used_by = &_test_subsystem,
+  .cb_message = _cb_message,
+  .cb_error = _cb_error,
+  .cb_done = _cb_done,
+};
+
+/* state of the socket scheduler for the netlink socket */
+static bool _write_enabled;
+
+/* errno of the next sendmsg() calls, 0 to send */
+static int _send_errno;
+static int _send_errno_count;
+
+/* number of buffers and messages sent to the kernel */
+static int _sendmsg_calls;
+static int _sent_messages;
+
+/* data the kernel returns with the next recvmsg() */
+static uint8_t _rx[8192];
+static size_t _rx_len;
+
+/* sequence numbers of the messages in the order of the kernel feedback */
+static uint32_t _done[MAX_MESSAGES];
+static int _done_count;
+static uint32_t _error[MAX_MESSAGES];
+static int _error_code[MAX_MESSAGES];
+static int _error_count;
+static int _message_count;
+
+/* socket scheduler stubs, the test triggers the socket events itself */
+void
+oonf_socket_add(struct oonf_socket_entry *entry __attribute__((unused))) {}
+
+void
+oonf_socket_remove(struct oonf_socket_entry *entry __attribute__((unused))) {}
+
+void
+oonf_socket_set_read(struct oonf_socket_entry *entry __attribute__((unused)), bool event_read
+  __attribute__((unused))) {}
+
+void
+oonf_socket_set_write(struct oonf_socket_entry *entry __attribute__((unused)), bool event_write) {
+  _write_enabled = event_write;
+}
+
+/* timer stubs, the test never lets the netlink timeout fire */
+void
+oonf_timer_add(struct oonf_timer_class *ti __attribute__((unused))) {}
+
+void
+oonf_timer_remove(struct oonf_timer_class *ti __attribute__((unused))) {}
+
+void
+oonf_timer_set_ext(struct oonf_timer_instance *timer, uint64_t first, uint64_t interval) {
+  timer->_clock = first;
+  timer->_period = interval;
+}
+
+void
+oonf_timer_stop(struct oonf_timer_instance *timer) {
+  timer->_clock = 0;
+}
+
+/* kernel stubs, the netlink socket talks to the test instead of the kernel */
+ssize_t
+sendmsg(int fd __attribute__((unused)), const struct msghdr *msg, int flags __attribute__((unused))) {
+  struct nlmsghdr *nh;
+  size_t len;
+
+  if (_send_errno_count > 0) {
+    _send_errno_count--;
+    errno = _send_errno;
+    return -1;
+  }
+
+  _sendmsg_calls++;
+  len = msg->msg_iov[0].iov_len;
+  for (nh = msg->msg_iov[0].iov_base; NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len)) {
+    _sent_messages++;
+  }
+  return msg->msg_iov[0].iov_len;
+}
+
+ssize_t
+recvmsg(int fd __attribute__((unused)), struct msghdr *msg, int flags) {
+  size_t len, copy;
+
+  if (_rx_len == 0) {
+    errno = EAGAIN;
+    return -1;
+  }
+
+  len = _rx_len;
+  copy = len;
+  if (copy > msg->msg_iov[0].iov_len) {
+    copy = msg->msg_iov[0].iov_len;
+    msg->msg_flags |= MSG_TRUNC;
+  }
+  memcpy(msg->msg_iov[0].iov_base, _rx, copy);
+
+  if ((flags & MSG_PEEK) == 0) {
+    _rx_len = 0;
+  }
+  return len;
+}
+
+static void
+_cb_message(struct nlmsghdr *hdr __attribute__((unused))) {
+  _message_count++;
+}
+
+static void
+_cb_error(uint32_t seq, int error) {
+  if (_error_count < MAX_MESSAGES) {
+    _error[_error_count] = seq;
+    _error_code[_error_count] = error;
+    _error_count++;
+  }
+}
+
+static void
+_cb_done(uint32_t seq) {
+  if (_done_count < MAX_MESSAGES) {
+    _done[_done_count++] = seq;
+  }
+}
+
+/**
+ * Queue a test message with a payload for the kernel
+ * @return sequence number of message
+ */
+static uint32_t
+_send_message(void) {
+  union {
+    struct nlmsghdr hdr;
+    uint8_t buf[NLMSG_SPACE(PAYLOAD_SIZE)];
+  } msg;
+
+  memset(&msg, 0, sizeof(msg));
+  msg.hdr.nlmsg_len = NLMSG_LENGTH(PAYLOAD_SIZE);
+  msg.hdr.nlmsg_type = RTM_NEWROUTE;
+  msg.hdr.nlmsg_flags = NLM_F_REQUEST;
+
+  return os_system_linux_netlink_send(&_netlink, &msg.hdr);
+}
+
+/**
+ * Append a netlink message to the data returned by the next recvmsg()
+ * @param type netlink message type
+ * @param seq sequence number
+ * @param error error code for NLMSG_ERROR
+ */
+static void
+_add_reply(uint16_t type, uint32_t seq, int error) {
+  struct nlmsghdr *nh;
+  struct nlmsgerr *err;
+
+  nh = (struct nlmsghdr *)&_rx[_rx_len];
+  memset(nh, 0, NLMSG_SPACE(sizeof(*err)));
+
+  nh->nlmsg_type = type;
+  nh->nlmsg_seq = seq;
+  if (type == NLMSG_ERROR) {
+    nh->nlmsg_len = NLMSG_LENGTH(sizeof(*err));
+    err = NLMSG_DATA(nh);
+    err->error = -error;
+    err->msg.nlmsg_seq = seq;
+  }
+  else {
+    nh->nlmsg_len = NLMSG_LENGTH(4);
+  }
+  _rx_len += NLMSG_ALIGN(nh->nlmsg_len);
+}
+
+static void
+_trigger_write(void) {
+  _netlink.socket.fd.received_events = EPOLLOUT;
+  _netlink.socket.process(&_netlink.socket);
+  _netlink.socket.fd.received_events = 0;
+}
+
+static void
+_trigger_read(void) {
+  _netlink.socket.fd.received_events = EPOLLIN;
+  _netlink.socket.process(&_netlink.socket);
+  _netlink.socket.fd.received_events = 0;
+}
+
+/**
+ * @return number of buffers waiting for kernel feedback
+ */
+static size_t
+_get_in_transit_buffers(void) {
+  struct os_system_netlink_buffer *buffer;
+  size_t count = 0;
+
+  list_for_each_element(&_netlink._in_transit, buffer, _node) {
+    count++;
+  }
+  return count;
+}
+
+static void
+clear_elements(void) {
+  os_system_linux_netlink_remove(&_netlink);
+  memset(&_netlink.stats, 0, sizeof(_netlink.stats));
+  _netlink.out_messages = 0;
+  _netlink.msg_in_transit = 0;
+  _netlink.bytes_in_transit = 0;
+
+  _write_enabled = false;
+  _send_errno = 0;
+  _send_errno_count = 0;
+  _sendmsg_calls = 0;
+  _sent_messages = 0;
+  _rx_len = 0;
+  _done_count = 0;
+  _error_count = 0;
+  _message_count = 0;
+
+  if (os_system_linux_netlink_add(&_netlink, NETLINK_ROUTE)) {
+    abort();
+  }
+}
+
+static void
+test_out_of_order_feedback(void) {
+  struct os_system_netlink_buffer *buffer;
+  uint32_t seq[6];
+  int i;
+
+  START_TEST();
+
+  for (i = 0; i < 6; i++) {
+    seq[i] = _send_message();
+  }
+  CHECK_TRUE(_write_enabled, "no write event requested");
+
+  /* both buffers fit into the window */
+  _trigger_write();
+  CHECK_TRUE(_sendmsg_calls == 2, "%d buffers sent", _sendmsg_calls);
+  CHECK_TRUE(_sent_messages == 6, "%d messages sent", _sent_messages);
+  CHECK_TRUE(_netlink.msg_in_transit == 6, "%d messages in transit", _netlink.msg_in_transit);
+  CHECK_TRUE(_get_in_transit_buffers() == 2, "%" PRINTF_SIZE_T_SPECIFIER " buffers in transit",
+    _get_in_transit_buffers());
+  CHECK_TRUE(oonf_timer_is_active(&_netlink.timeout), "feedback timer not running");
+
+  /* feedback for the second buffer arrives first, one message of each buffer fails */
+  _add_reply(NLMSG_ERROR, seq[4], 0);
+  _add_reply(NLMSG_ERROR, seq[1], EEXIST);
+  _add_reply(NLMSG_ERROR, seq[5], 0);
+  _trigger_read();
+  CHECK_TRUE(_netlink.msg_in_transit == 3, "%d messages in transit", _netlink.msg_in_transit);
+  CHECK_TRUE(_get_in_transit_buffers() == 2, "%" PRINTF_SIZE_T_SPECIFIER " buffers in transit",
+    _get_in_transit_buffers());
+  CHECK_TRUE(_error_count == 1 && _error[0] == seq[1] && _error_code[0] == EEXIST, "wrong error feedback");
+  CHECK_TRUE(_done_count == 2 && _done[0] == seq[4] && _done[1] == seq[5], "wrong done feedback");
+
+  /* last feedback of the second buffer releases it before the first one */
+  _add_reply(NLMSG_ERROR, seq[3], ENOENT);
+  _trigger_read();
+  CHECK_TRUE(_netlink.msg_in_transit == 2, "%d messages in transit", _netlink.msg_in_transit);
+  CHECK_TRUE(_get_in_transit_buffers() == 1, "%" PRINTF_SIZE_T_SPECIFIER " buffers in transit",
+    _get_in_transit_buffers());
+  buffer = list_first_element(&_netlink._in_transit, buffer, _node);
+  CHECK_TRUE(_netlink.bytes_in_transit == buffer->total, "%u bytes in transit", _netlink.bytes_in_transit);
+
+  /* feedback for an unknown sequence number changes nothing */
+  _add_reply(NLMSG_ERROR, seq[4], 0);
+  _trigger_read();
+  CHECK_TRUE(_netlink.msg_in_transit == 2, "%d messages in transit", _netlink.msg_in_transit);
+
+  _add_reply(NLMSG_ERROR, seq[2], 0);
+  _add_reply(NLMSG_ERROR, seq[0], 0);
+  _trigger_read();
+  CHECK_TRUE(_netlink.msg_in_transit == 0, "%d messages in transit", _netlink.msg_in_transit);
+  CHECK_TRUE(_netlink.bytes_in_transit == 0, "%u bytes in transit", _netlink.bytes_in_transit);
+  CHECK_TRUE(_get_in_transit_buffers() == 0, "%" PRINTF_SIZE_T_SPECIFIER " buffers in transit",
+    _get_in_transit_buffers());
+  CHECK_TRUE(!oonf_timer_is_active(&_netlink.timeout), "feedback timer still running");
+
+  CHECK_TRUE(_netlink.stats.buffers_sent == 2, "%" PRIu64 " buffers counted", _netlink.stats.buffers_sent);
+  CHECK_TRUE(_netlink.stats.messages_done == 5, "%" PRIu64 " messages done", _netlink.stats.messages_done);
+  CHECK_TRUE(_netlink.stats.messages_failed == 2, "%" PRIu64 " messages failed", _netlink.stats.messages_failed);
+  CHECK_TRUE(_netlink.stats.max_in_transit == 6, "%u messages in transit at most", _netlink.stats.max_in_transit);
+
+  END_TEST();
+}
+
+static void
+test_send_eagain(void) {
+  uint32_t seq[3];
+  int i;
+
+  START_TEST();
+
+  for (i = 0; i < 3; i++) {
+    seq[i] = _send_message();
+  }
+
+  /* socket buffer full, the buffer is kept for the next write event */
+  _send_errno = EAGAIN;
+  _send_errno_count = 1;
+  _trigger_write();
+  CHECK_TRUE(_sendmsg_calls == 0, "%d buffers sent", _sendmsg_calls);
+  CHECK_TRUE(_write_enabled, "no write event requested after EAGAIN");
+  CHECK_TRUE(!list_is_empty(&_netlink.buffered), "buffer dropped after EAGAIN");
+  CHECK_TRUE(_netlink.msg_in_transit == 0, "%d messages in transit", _netlink.msg_in_transit);
+  CHECK_TRUE(_error_count == 0, "%d errors reported for EAGAIN", _error_count);
+
+  _trigger_write();
+  CHECK_TRUE(_sendmsg_calls == 1, "%d buffers sent", _sendmsg_calls);
+  CHECK_TRUE(_sent_messages == 3, "%d messages sent", _sent_messages);
+  CHECK_TRUE(!_write_enabled, "write event still requested");
+  CHECK_TRUE(list_is_empty(&_netlink.buffered), "buffer still queued");
+  CHECK_TRUE(_netlink.msg_in_transit == 3, "%d messages in transit", _netlink.msg_in_transit);
+
+  for (i = 0; i < 3; i++) {
+    _add_reply(NLMSG_ERROR, seq[i], 0);
+  }
+  _trigger_read();
+  CHECK_TRUE(_netlink.msg_in_transit == 0, "%d messages in transit", _netlink.msg_in_transit);
+  CHECK_TRUE(_done_count == 3, "%d messages done", _done_count);
+
+  END_TEST();
+}
+
+static void
+test_send_error(void) {
+  uint32_t seq[4];
+  int i;
+
+  START_TEST();
+
+  for (i = 0; i < 4; i++) {
+    seq[i] = _send_message();
+  }
+
+  /* first buffer cannot be sent, every message of it gets an error */
+  _send_errno = EINVAL;
+  _send_errno_count = 1;
+  _trigger_write();
+  CHECK_TRUE(_error_count == 3, "%d errors reported", _error_count);
+  CHECK_TRUE(_error[0] == seq[0] && _error[2] == seq[2], "errors for wrong messages");
+  CHECK_TRUE(_error_code[0] == EINVAL, "error code %d", _error_code[0]);
+  CHECK_TRUE(_netlink.stats.messages_failed == 3, "%" PRIu64 " messages failed", _netlink.stats.messages_failed);
+
+  /* second buffer is sent anyway */
+  CHECK_TRUE(_sendmsg_calls == 1, "%d buffers sent", _sendmsg_calls);
+  CHECK_TRUE(_netlink.msg_in_transit == 1, "%d messages in transit", _netlink.msg_in_transit);
+
+  _add_reply(NLMSG_ERROR, seq[3], 0);
+  _trigger_read();
+  CHECK_TRUE(_netlink.msg_in_transit == 0, "%d messages in transit", _netlink.msg_in_transit);
+
+  END_TEST();
+}
+
+static void
+test_dump_finished_mid_batch(void) {
+  uint32_t dump, route;
+
+  START_TEST();
+
+  dump = _send_message();
+  route = _send_message();
+  _trigger_write();
+  CHECK_TRUE(_netlink.msg_in_transit == 2, "%d messages in transit", _netlink.msg_in_transit);
+
+  /* dump ends in the middle of a receive batch, followed by the route feedback */
+  _add_reply(RTM_NEWROUTE, dump, 0);
+  _add_reply(RTM_NEWROUTE, dump, 0);
+  _add_reply(NLMSG_DONE, dump, 0);
+  _add_reply(NLMSG_ERROR, route, 0);
+  _trigger_read();
+  CHECK_TRUE(_message_count == 2, "%d dump messages", _message_count);
+  CHECK_TRUE(_done_count == 2, "%d messages done", _done_count);
+  CHECK_TRUE(_done[0] == dump && _done[1] == route, "wrong order of done feedback");
+  CHECK_TRUE(_netlink.msg_in_transit == 0, "%d messages in transit", _netlink.msg_in_transit);
+  CHECK_TRUE(_get_in_transit_buffers() == 0, "%" PRINTF_SIZE_T_SPECIFIER " buffers in transit",
+    _get_in_transit_buffers());
+
+  /* dump ends at the end of a receive batch */
+  dump = _send_message();
+  _trigger_write();
+  _add_reply(RTM_NEWROUTE, dump, 0);
+  _add_reply(NLMSG_DONE, dump, 0);
+  _trigger_read();
+  CHECK_TRUE(_done_count == 3 && _done[2] == dump, "dump not finished");
+  CHECK_TRUE(_netlink.msg_in_transit == 0, "%d messages in transit", _netlink.msg_in_transit);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  struct oonf_subsystem *os_system;
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+
+  os_system = oonf_subsystem_get(OONF_OS_SYSTEM_SUBSYSTEM);
+  if (os_system == NULL || os_system->init()) {
+    oonf_log_cleanup();
+    return 1;
+  }
+
+  if (os_system_linux_netlink_add(&_netlink, NETLINK_ROUTE)) {
+    os_system->cleanup();
+    oonf_log_cleanup();
+    return 1;
+  }
+
+  BEGIN_TESTING(clear_elements);
+
+  test_out_of_order_feedback();
+  test_send_eagain();
+  test_send_error();
+  test_dump_finished_mid_batch();
+
+  result = FINISH_TESTING();
+
+  os_system_linux_netlink_remove(&_netlink);
+  os_system->cleanup();
+  oonf_log_cleanup();
+  return result;
+}
@@ -0,0 +1,657 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_packet_socket.h>
+#include <oonf/base/oonf_socket.h>
+#include <oonf/base/os_fd.h>
+#include <oonf/base/os_interface.h>
+#include <oonf/cunit/cunit.h>
+
+#define BATCH 4
+#define MAX_DATAGRAMS 16
+
+static struct oonf_appdata _appdata = {
+  .app_name = "test_base_packet_socket",
+};
+
+static void _cb_receive(struct oonf_packet_socket *psock, union netaddr_socket *from, void *ptr, size_t length);
+
+static struct oonf_packet_socket _socket = {
+  .config =
+    {
+      .input_batch = BATCH,
+      .receive_data = _cb_receive,
+    },
+};
+
+static union netaddr_socket _local;
+
+/* other end of the socketpair used as the socket file descriptor */
+static int _peer_fd = -1;
+
+/* datagrams returned by the next batch receive */
+static const char *_queue[MAX_DATAGRAMS];
+static size_t _queue_count;
+
+/* number of batch receive calls, -1 if batch receive returns ENOSYS */
+static int _batch_calls;
+static bool _batch_enosys;
+
+/* datagrams handed to the receive callback */
+static char _received[MAX_DATAGRAMS][32];
+static size_t _received_count;
+
+/* action of the receive callback after a number of datagrams */
+static size_t _action_after;
+static bool _remove_in_callback;
+static bool _readd_in_callback;
+
+/* true to use a loopback UDP socket instead of the socketpair */
+static bool _use_udp;
+
+/* address of the loopback UDP peer socket */
+static union netaddr_socket _peer;
+
+/* state of the socket scheduler for the socket */
+static bool _write_enabled;
+static int _flush_registered;
+
+/* datagrams handed to the batch send, -1 if batch send returns EAGAIN */
+static char _sent[MAX_DATAGRAMS][32];
+static size_t _sent_count;
+static int _send_batch_calls;
+static size_t _send_batch_size;
+static bool _send_eagain;
+
+/* maximum number of datagrams the next batch send accepts */
+static size_t _send_limit;
+
+/* socket subsystem stubs, the test triggers the socket events itself */
+void
+oonf_socket_add(struct oonf_socket_entry *entry __attribute__((unused))) {}
+
+void
+oonf_socket_remove(struct oonf_socket_entry *entry __attribute__((unused))) {}
+
+void
+oonf_socket_set_read(struct oonf_socket_entry *entry __attribute__((unused)), bool event_read
+  __attribute__((unused))) {}
+
+void
+oonf_socket_set_write(struct oonf_socket_entry *entry __attribute__((unused)), bool event_write) {
+  _write_enabled = event_write;
+}
+
+void
+oonf_socket_register_flush(struct oonf_socket_entry *entry __attribute__((unused))) {
+  _flush_registered++;
+}
+
+uint64_t
+oonf_clock_getNow(void) {
+  return 0;
+}
+
+/**
+ * Create a nonblocking UDP socket bound to an ephemeral loopback port
+ * @param addr returns the bound address
+ * @return file descriptor, -1 if an error happened
+ */
+static int
+_get_udp_socket(union netaddr_socket *addr) {
+  socklen_t addrlen;
+  int fd;
+
+  fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  if (fd == -1) {
+    return -1;
+  }
+
+  memset(addr, 0, sizeof(*addr));
+  addr->v4.sin_family = AF_INET;
+  addr->v4.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addrlen = sizeof(addr->v4);
+  if (bind(fd, &addr->std, addrlen) || getsockname(fd, &addr->std, &addrlen)) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/* os_fd stubs, the socket is one end of a socketpair or a loopback UDP socket */
+int
+os_fd_generic_getsocket(struct os_fd *sock, const union netaddr_socket *bind_to __attribute__((unused)),
+  bool tcp __attribute__((unused)), size_t recvbuf __attribute__((unused)),
+  const struct os_interface *os_if __attribute__((unused)), enum oonf_log_source log_src __attribute__((unused))) {
+  union netaddr_socket local;
+  int fds[2];
+
+  if (_use_udp) {
+    fds[0] = _get_udp_socket(&local);
+    fds[1] = _get_udp_socket(&_peer);
+    if (fds[0] == -1 || fds[1] == -1) {
+      return -1;
+    }
+  }
+  else if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0, fds)) {
+    return -1;
+  }
+  os_fd_init(sock, fds[0]);
+  _peer_fd = fds[1];
+  return 0;
+}
+
+int
+os_fd_generic_getrawsocket(struct os_fd *sock __attribute__((unused)),
+  const union netaddr_socket *bind_to __attribute__((unused)), int protocol __attribute__((unused)),
+  size_t recvbuf __attribute__((unused)), const struct os_interface *os_if __attribute__((unused)),
+  enum oonf_log_source log_src __attribute__((unused))) {
+  return -1;
+}
+
+int
+os_fd_generic_join_mcast_recv(struct os_fd *sock __attribute__((unused)),
+  const struct netaddr *multicast __attribute__((unused)), const struct os_interface *os_if __attribute__((unused)),
+  enum oonf_log_source log_src __attribute__((unused))) {
+  return 0;
+}
+
+int
+os_fd_generic_join_mcast_send(struct os_fd *sock __attribute__((unused)),
+  const struct netaddr *multicast __attribute__((unused)), const struct os_interface *os_if __attribute__((unused)),
+  bool loop __attribute__((unused)), uint8_t ttl __attribute__((unused)), enum oonf_log_source log_src __attribute__((unused))) {
+  return 0;
+}
+
+int
+os_fd_generic_set_dscp(struct os_fd *sock __attribute__((unused)), int dscp __attribute__((unused)),
+  bool ipv6 __attribute__((unused))) {
+  return 0;
+}
+
+uint8_t *
+os_fd_linux_skip_rawsocket_prefix(uint8_t *ptr, ssize_t *len __attribute__((unused)), int af_type
+  __attribute__((unused))) {
+  return ptr;
+}
+
+int
+os_fd_linux_recvfrom_batch(struct os_fd *sockfd __attribute__((unused)), struct os_fd_datagram *dgrams, size_t count) {
+  size_t i;
+
+  _batch_calls++;
+  if (_batch_enosys) {
+    errno = ENOSYS;
+    return -1;
+  }
+  if (_queue_count == 0) {
+    errno = EAGAIN;
+    return -1;
+  }
+
+  for (i = 0; i < count && i < _queue_count; i++) {
+    memcpy(&dgrams[i].remote, &_local, sizeof(_local));
+    dgrams[i].length = strlen(_queue[i]);
+    memcpy(dgrams[i].buf, _queue[i], dgrams[i].length);
+  }
+
+  /* keep the rest for the next call */
+  memmove(&_queue[0], &_queue[i], (_queue_count - i) * sizeof(_queue[0]));
+  _queue_count -= i;
+  return i;
+}
+
+int
+os_fd_linux_sendto_batch(struct os_fd *sockfd __attribute__((unused)), const struct os_fd_datagram *dgrams,
+  size_t count, bool dont_route __attribute__((unused)), bool gso __attribute__((unused))) {
+  size_t i;
+
+  _send_batch_calls++;
+  _send_batch_size = count;
+  if (_send_eagain) {
+    errno = EAGAIN;
+    return -1;
+  }
+
+  if (count > _send_limit) {
+    count = _send_limit;
+  }
+  for (i = 0; i < count && _sent_count < MAX_DATAGRAMS; i++) {
+    if (netaddr_socket_cmp(&dgrams[i].remote, &_peer) != 0) {
+      continue;
+    }
+    memcpy(_sent[_sent_count], dgrams[i].buf, dgrams[i].length);
+    _sent[_sent_count][dgrams[i].length] = 0;
+    _sent_count++;
+  }
+  return count;
+}
+
+/* interface stubs, the test sockets are not bound to interfaces */
+struct os_interface *
+os_interface_linux_add(struct os_interface_listener *l __attribute__((unused))) {
+  return NULL;
+}
+
+void
+os_interface_linux_remove(struct os_interface_listener *l __attribute__((unused))) {}
+
+void
+os_interface_linux_trigger_handler(struct os_interface_listener *l __attribute__((unused))) {}
+
+const struct netaddr *
+os_interface_generic_get_bindaddress(int af_type __attribute__((unused)),
+  struct netaddr_acl *filter __attribute__((unused)), struct os_interface *os_if __attribute__((unused))) {
+  return NULL;
+}
+
+static void
+_cb_receive(struct oonf_packet_socket *psock, union netaddr_socket *from __attribute__((unused)), void *ptr,
+  size_t length) {
+  if (_received_count < MAX_DATAGRAMS) {
+    strscpy(_received[_received_count], ptr, sizeof(_received[0]));
+    _received[_received_count][length < sizeof(_received[0]) ? length : sizeof(_received[0]) - 1] = 0;
+    _received_count++;
+  }
+
+  if (_received_count != _action_after) {
+    return;
+  }
+  if (_remove_in_callback || _readd_in_callback) {
+    oonf_packet_remove(psock, true);
+    close(_peer_fd);
+    _peer_fd = -1;
+  }
+  if (_readd_in_callback) {
+    oonf_packet_add(psock, &_local, NULL);
+  }
+}
+
+/**
+ * Let the socket scheduler report a read event
+ */
+static void
+_trigger_read(void) {
+  _socket.scheduler_entry.fd.received_events = EPOLLIN;
+  _socket.scheduler_entry.process(&_socket.scheduler_entry);
+  _socket.scheduler_entry.fd.received_events = 0;
+}
+
+/**
+ * Let the socket scheduler report a write event
+ */
+static void
+_trigger_write(void) {
+  _socket.scheduler_entry.fd.received_events = EPOLLOUT;
+  _socket.scheduler_entry.process(&_socket.scheduler_entry);
+  _socket.scheduler_entry.fd.received_events = 0;
+}
+
+/**
+ * Let the socket scheduler call the flush callback at the end of its iteration
+ */
+static void
+_trigger_flush(void) {
+  _socket.scheduler_entry.flush(&_socket.scheduler_entry);
+}
+
+/**
+ * Read the next datagram directly sent to the peer socket
+ * @param buf buffer for datagram
+ * @return datagram or empty string if nothing was sent
+ */
+static const char *
+_recv_direct(char *buf) {
+  ssize_t len;
+
+  len = recv(_peer_fd, buf, 31, 0);
+  buf[len > 0 ? len : 0] = 0;
+  return buf;
+}
+
+static void
+_send(const char *data) {
+  CHECK_TRUE(oonf_packet_send(&_socket, &_peer, data, strlen(data)) == 0, "could not send %s", data);
+}
+
+static void
+_queue_datagrams(size_t count) {
+  static const char *DATAGRAMS[] = {
+    "one",
+    "two",
+    "three",
+    "four",
+    "five",
+    "six",
+  };
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    _queue[_queue_count++] = DATAGRAMS[i % ARRAYSIZE(DATAGRAMS)];
+  }
+}
+
+static void
+_add_socket(void) {
+  _socket.config.input_batch = BATCH;
+  _socket.config.input_buffer = NULL;
+  _socket.config.input_buffer_length = 0;
+  CHECK_TRUE(oonf_packet_add(&_socket, &_local, NULL) == 0, "could not add socket");
+}
+
+static void
+_add_udp_socket(size_t output_batch) {
+  _use_udp = true;
+  _socket.config.output_batch = output_batch;
+  _add_socket();
+}
+
+static void
+clear_elements(void) {
+  oonf_packet_remove(&_socket, true);
+  if (_peer_fd != -1) {
+    close(_peer_fd);
+    _peer_fd = -1;
+  }
+
+  _queue_count = 0;
+  _batch_calls = 0;
+  _batch_enosys = false;
+  _received_count = 0;
+  _action_after = 0;
+  _remove_in_callback = false;
+  _readd_in_callback = false;
+
+  _use_udp = false;
+  _socket.config.output_batch = 0;
+  _write_enabled = false;
+  _flush_registered = 0;
+  _sent_count = 0;
+  _send_batch_calls = 0;
+  _send_batch_size = 0;
+  _send_eagain = false;
+  _send_limit = MAX_DATAGRAMS;
+}
+
+static void
+test_batch_receive(void) {
+  START_TEST();
+
+  _add_socket();
+  CHECK_TRUE(_socket._rx_buffers != NULL, "no receive buffers for batch");
+  CHECK_TRUE(_socket._rx_batch == BATCH, "batch size is %" PRINTF_SIZE_T_SPECIFIER, _socket._rx_batch);
+
+  _queue_datagrams(6);
+  _trigger_read();
+  CHECK_TRUE(_batch_calls == 1, "%d batch calls", _batch_calls);
+  CHECK_TRUE(_received_count == BATCH, "%" PRINTF_SIZE_T_SPECIFIER " datagrams received", _received_count);
+  CHECK_TRUE(strcmp(_received[0], "one") == 0, "first datagram is %s", _received[0]);
+  CHECK_TRUE(strcmp(_received[3], "four") == 0, "fourth datagram is %s", _received[3]);
+
+  _trigger_read();
+  CHECK_TRUE(_batch_calls == 2, "%d batch calls", _batch_calls);
+  CHECK_TRUE(_received_count == 6, "%" PRINTF_SIZE_T_SPECIFIER " datagrams received", _received_count);
+  CHECK_TRUE(strcmp(_received[5], "six") == 0, "sixth datagram is %s", _received[5]);
+
+  /* nothing to read */
+  _trigger_read();
+  CHECK_TRUE(_received_count == 6, "%" PRINTF_SIZE_T_SPECIFIER " datagrams received", _received_count);
+  CHECK_TRUE(oonf_socket_get_recv_packets(&_socket.scheduler_entry) == 6, "%u packets counted",
+    oonf_socket_get_recv_packets(&_socket.scheduler_entry));
+
+  END_TEST();
+}
+
+static void
+test_batch_enosys(void) {
+  START_TEST();
+
+  _add_socket();
+  _batch_enosys = true;
+
+  /* kernel without batch receive, the datagram is read with recvfrom() */
+  CHECK_TRUE(send(_peer_fd, "single", 6, 0) == 6, "could not send datagram");
+  _trigger_read();
+  CHECK_TRUE(_batch_calls == 1, "%d batch calls", _batch_calls);
+  CHECK_TRUE(_socket._rx_buffers == NULL, "receive buffers not freed after ENOSYS");
+  CHECK_TRUE(_socket.config.input_batch == 0, "batch receive not disabled");
+  CHECK_TRUE(_received_count == 1, "%" PRINTF_SIZE_T_SPECIFIER " datagrams received", _received_count);
+  CHECK_TRUE(strcmp(_received[0], "single") == 0, "datagram is %s", _received[0]);
+
+  /* batch receive is not tried again */
+  CHECK_TRUE(send(_peer_fd, "again", 5, 0) == 5, "could not send datagram");
+  _trigger_read();
+  CHECK_TRUE(_batch_calls == 1, "%d batch calls", _batch_calls);
+  CHECK_TRUE(_received_count == 2, "%" PRINTF_SIZE_T_SPECIFIER " datagrams received", _received_count);
+  CHECK_TRUE(strcmp(_received[1], "again") == 0, "datagram is %s", _received[1]);
+
+  END_TEST();
+}
+
+static void
+test_remove_in_callback(void) {
+  START_TEST();
+
+  /* socket removed while handling the second datagram of a batch */
+  _add_socket();
+  _remove_in_callback = true;
+  _action_after = 2;
+
+  _queue_datagrams(BATCH);
+  _trigger_read();
+  CHECK_TRUE(_received_count == 2, "%" PRINTF_SIZE_T_SPECIFIER " datagrams received after removal", _received_count);
+  CHECK_TRUE(_socket._rx_buffers == NULL, "receive buffers still set");
+  CHECK_TRUE(!_socket._rx_busy, "receive buffers still busy");
+
+  END_TEST();
+}
+
+static void
+test_readd_in_callback(void) {
+  START_TEST();
+
+  /* socket removed and added again while handling a batch */
+  _add_socket();
+  _readd_in_callback = true;
+  _action_after = 1;
+
+  _queue_datagrams(BATCH + 2);
+  _trigger_read();
+  CHECK_TRUE(_received_count == 1, "%" PRINTF_SIZE_T_SPECIFIER " datagrams received after re-add", _received_count);
+  CHECK_TRUE(_socket._rx_buffers != NULL, "no receive buffers after re-add");
+  CHECK_TRUE(!_socket._rx_busy, "new receive buffers are busy");
+
+  /* rest of the old batch is dropped, the next datagrams use the new buffers */
+  _readd_in_callback = false;
+  _trigger_read();
+  CHECK_TRUE(_received_count == 3, "%" PRINTF_SIZE_T_SPECIFIER " datagrams received", _received_count);
+  CHECK_TRUE(strcmp(_received[1], "five") == 0, "second datagram is %s", _received[1]);
+  CHECK_TRUE(strcmp(_received[2], "six") == 0, "third datagram is %s", _received[2]);
+
+  END_TEST();
+}
+
+static void
+test_direct_send(void) {
+  char buf[32];
+
+  START_TEST();
+
+  _add_udp_socket(BATCH);
+
+  /* first datagram of a scheduler iteration is sent directly */
+  _send("one");
+  CHECK_TRUE(strcmp(_recv_direct(buf), "one") == 0, "directly sent datagram is '%s'", buf);
+  CHECK_TRUE(_flush_registered == 1, "flush registered %d times", _flush_registered);
+  CHECK_TRUE(oonf_socket_get_send(&_socket.scheduler_entry) == 1, "%u sends counted",
+    oonf_socket_get_send(&_socket.scheduler_entry));
+
+  /* the rest of the iteration is queued until the flush */
+  _send("two");
+  _send("three");
+  CHECK_TRUE(strcmp(_recv_direct(buf), "") == 0, "queued datagram '%s' sent directly", buf);
+  CHECK_TRUE(_send_batch_calls == 0, "%d batch sends before flush", _send_batch_calls);
+  CHECK_TRUE(!_write_enabled, "write event requested for coalesced datagrams");
+  CHECK_TRUE(_flush_registered == 1, "flush registered %d times", _flush_registered);
+
+  _trigger_flush();
+  CHECK_TRUE(_send_batch_calls == 1, "%d batch sends after flush", _send_batch_calls);
+  CHECK_TRUE(_sent_count == 2, "%" PRINTF_SIZE_T_SPECIFIER " datagrams flushed", _sent_count);
+  CHECK_TRUE(strcmp(_sent[0], "two") == 0, "first flushed datagram is %s", _sent[0]);
+  CHECK_TRUE(strcmp(_sent[1], "three") == 0, "second flushed datagram is %s", _sent[1]);
+  CHECK_TRUE(abuf_getlen(&_socket.out) == 0, "queue not empty after flush");
+  CHECK_TRUE(oonf_socket_get_send(&_socket.scheduler_entry) == 1, "flush counted as direct send");
+
+  /* next scheduler iteration starts with a direct send again */
+  _send("four");
+  CHECK_TRUE(strcmp(_recv_direct(buf), "four") == 0, "directly sent datagram is '%s'", buf);
+  CHECK_TRUE(_flush_registered == 2, "flush registered %d times", _flush_registered);
+
+  END_TEST();
+}
+
+static void
+test_no_coalescing(void) {
+  char buf[32];
+
+  START_TEST();
+
+  /* batch size 1 sends every datagram directly */
+  _add_udp_socket(1);
+
+  _send("one");
+  _send("two");
+  CHECK_TRUE(strcmp(_recv_direct(buf), "one") == 0, "first datagram is '%s'", buf);
+  CHECK_TRUE(strcmp(_recv_direct(buf), "two") == 0, "second datagram is '%s'", buf);
+  CHECK_TRUE(_flush_registered == 0, "flush registered %d times", _flush_registered);
+  CHECK_TRUE(abuf_getlen(&_socket.out) == 0, "datagrams queued");
+
+  END_TEST();
+}
+
+static void
+test_eagain_backlog(void) {
+  char buf[32];
+
+  START_TEST();
+
+  _add_udp_socket(2);
+
+  _send("one");
+  _send("two");
+  _send("three");
+  _send("four");
+  CHECK_TRUE(strcmp(_recv_direct(buf), "one") == 0, "directly sent datagram is '%s'", buf);
+
+  /* flush would block, the queue is kept for the write event */
+  _send_eagain = true;
+  _trigger_flush();
+  CHECK_TRUE(_send_batch_calls == 1, "%d batch sends", _send_batch_calls);
+  CHECK_TRUE(_send_batch_size == 2, "batch of %" PRINTF_SIZE_T_SPECIFIER " datagrams", _send_batch_size);
+  CHECK_TRUE(_write_enabled, "no write event requested after EAGAIN");
+  CHECK_TRUE(abuf_getlen(&_socket.out) > 0, "queue dropped after EAGAIN");
+
+  /* new datagrams are appended to the backlog instead of sent directly */
+  _send("five");
+  CHECK_TRUE(strcmp(_recv_direct(buf), "") == 0, "datagram '%s' bypassed the backlog", buf);
+  CHECK_TRUE(_flush_registered == 1, "flush registered %d times", _flush_registered);
+
+  /* the kernel only takes a single datagram of the next batch */
+  _send_eagain = false;
+  _send_limit = 1;
+  _trigger_write();
+  CHECK_TRUE(_sent_count == 4, "%" PRINTF_SIZE_T_SPECIFIER " datagrams sent from backlog", _sent_count);
+  CHECK_TRUE(strcmp(_sent[0], "two") == 0, "first backlog datagram is %s", _sent[0]);
+  CHECK_TRUE(strcmp(_sent[3], "five") == 0, "last backlog datagram is %s", _sent[3]);
+  CHECK_TRUE(abuf_getlen(&_socket.out) == 0, "backlog not empty");
+  CHECK_TRUE(!_write_enabled, "write event still requested for empty backlog");
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  struct oonf_subsystem *packet;
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+
+  packet = oonf_subsystem_get(OONF_PACKET_SUBSYSTEM);
+  if (packet == NULL || packet->init()) {
+    oonf_log_cleanup();
+    return 1;
+  }
+  netaddr_socket_init(&_local, &NETADDR_IPV4_ANY, 1234, 0);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_batch_receive();
+  test_batch_enosys();
+  test_remove_in_callback();
+  test_readd_in_callback();
+  test_direct_send();
+  test_no_coalescing();
+  test_eagain_backlog();
+
+  result = FINISH_TESTING();
+
+  clear_elements();
+  packet->cleanup();
+  oonf_log_cleanup();
+  return result;
+}
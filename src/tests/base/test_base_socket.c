@@ -0,0 +1,446 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+/*! activate GNU sources for sendmmsg() */
+#define _GNU_SOURCE
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/udp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/libcore/oonf_main.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_clock.h>
+#include <oonf/base/oonf_socket.h>
+#include <oonf/base/oonf_timer.h>
+#include <oonf/base/os_clock.h>
+#include <oonf/base/os_fd.h>
+#include <oonf/cunit/cunit.h>
+
+#define MAX_EVENTS 16
+#define MAX_MESSAGES 8
+
+static struct oonf_appdata _appdata = {
+  .app_name = "test_base_socket",
+};
+
+static void _cb_process(struct oonf_socket_entry *entry);
+static void _cb_flush(struct oonf_socket_entry *entry);
+
+static struct oonf_socket_entry _socket = {
+  .name = "test socket",
+  .process = _cb_process,
+  .flush = _cb_flush,
+};
+
+/* other end of the test socket */
+static int _peer_fd = -1;
+
+/* scheduler of the socket subsystem */
+static int (*_scheduler)(void);
+
+/* order of timer walks ('t'), socket events ('p') and flushes ('f') */
+static char _events[MAX_EVENTS + 1];
+static size_t _event_count;
+
+/* actions of the timer walk and the socket callback */
+static bool _flush_in_walk;
+static bool _remove_in_walk;
+static bool _flush_in_process;
+
+/* messages handed to sendmmsg() */
+static struct mmsghdr _msgs[MAX_MESSAGES];
+static unsigned int _msg_count;
+static int _sendmmsg_calls;
+
+/* true if sendmmsg() rejects UDP segmentation offload */
+static bool _reject_gso;
+
+/* main loop, clock and timer stubs, the test runs the scheduler itself */
+int
+oonf_main_set_scheduler(int (*scheduler)(void)) {
+  _scheduler = scheduler;
+  return 0;
+}
+
+bool
+oonf_main_shall_stop_scheduler(void) {
+  return false;
+}
+
+int
+oonf_clock_update(void) {
+  return 0;
+}
+
+uint64_t
+oonf_clock_getNow(void) {
+  return 1000;
+}
+
+int
+os_clock_linux_gettime64(uint64_t *t64) {
+  *t64 = 1000;
+  return 0;
+}
+
+void
+oonf_timer_walk(void) {
+  _events[_event_count++] = 't';
+
+  if (_flush_in_walk) {
+    /* two sends during the same iteration need a single flush */
+    oonf_socket_register_flush(&_socket);
+    oonf_socket_register_flush(&_socket);
+  }
+  if (_remove_in_walk) {
+    oonf_socket_remove(&_socket);
+  }
+}
+
+uint64_t
+oonf_timer_getNextEvent(void) {
+  /* do not wait for socket events */
+  return oonf_clock_getNow();
+}
+
+/* batch send stub, records the messages of the kernel call */
+int
+sendmmsg(int fd __attribute__((unused)), struct mmsghdr *msgs, unsigned int vlen, int flags __attribute__((unused))) {
+  unsigned int i;
+
+  _sendmmsg_calls++;
+  if (_reject_gso) {
+    for (i = 0; i < vlen; i++) {
+      if (msgs[i].msg_hdr.msg_controllen > 0) {
+        errno = EIO;
+        return -1;
+      }
+    }
+  }
+
+  _msg_count = vlen < MAX_MESSAGES ? vlen : MAX_MESSAGES;
+  memcpy(_msgs, msgs, sizeof(*msgs) * _msg_count);
+  return vlen;
+}
+
+static void
+_cb_process(struct oonf_socket_entry *entry) {
+  char buf[16];
+
+  _events[_event_count++] = 'p';
+
+  /* drain the socket, the scheduler would report the event again */
+  while (recv(os_fd_get_fd(&entry->fd), buf, sizeof(buf), MSG_DONTWAIT) > 0)
+    ;
+
+  if (_flush_in_process) {
+    oonf_socket_register_flush(entry);
+  }
+}
+
+static void
+_cb_flush(struct oonf_socket_entry *entry __attribute__((unused))) {
+  _events[_event_count++] = 'f';
+}
+
+/**
+ * Run a single call of the socket scheduler
+ * @return result of scheduler
+ */
+static int
+_run_scheduler(void) {
+  int result;
+
+  result = _scheduler();
+  _events[_event_count] = 0;
+  return result;
+}
+
+static void
+_add_socket(void) {
+  int fds[2];
+
+  CHECK_TRUE(socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0, fds) == 0, "socketpair failed");
+  os_fd_init(&_socket.fd, fds[0]);
+  _peer_fd = fds[1];
+
+  oonf_socket_add(&_socket);
+  oonf_socket_set_read(&_socket, true);
+}
+
+static void
+clear_elements(void) {
+  if (list_is_node_added(&_socket._node)) {
+    oonf_socket_remove(&_socket);
+  }
+  if (_peer_fd != -1) {
+    os_fd_close(&_socket.fd);
+    close(_peer_fd);
+    _peer_fd = -1;
+  }
+
+  _event_count = 0;
+  _events[0] = 0;
+  _flush_in_walk = false;
+  _remove_in_walk = false;
+  _flush_in_process = false;
+
+  memset(_msgs, 0, sizeof(_msgs));
+  _msg_count = 0;
+  _sendmmsg_calls = 0;
+}
+
+static void
+test_flush_after_timer_walk(void) {
+  START_TEST();
+
+  _add_socket();
+  _flush_in_walk = true;
+
+  /* data queued by timers is flushed before the scheduler waits */
+  CHECK_TRUE(_run_scheduler() == 0, "scheduler failed");
+  CHECK_TRUE(strcmp(_events, "tf") == 0, "events: %s", _events);
+
+  /* nothing queued, nothing flushed */
+  _event_count = 0;
+  _flush_in_walk = false;
+  CHECK_TRUE(_run_scheduler() == 0, "scheduler failed");
+  CHECK_TRUE(strcmp(_events, "t") == 0, "events: %s", _events);
+
+  END_TEST();
+}
+
+static void
+test_flush_after_socket_event(void) {
+  START_TEST();
+
+  _add_socket();
+  _flush_in_process = true;
+
+  /* data queued by a socket callback is flushed after the next timer walk */
+  CHECK_TRUE(send(_peer_fd, "x", 1, 0) == 1, "could not send datagram");
+  CHECK_TRUE(_run_scheduler() == 0, "scheduler failed");
+  CHECK_TRUE(strcmp(_events, "tptf") == 0, "events: %s", _events);
+
+  END_TEST();
+}
+
+static void
+test_flush_removed_socket(void) {
+  START_TEST();
+
+  /* a socket removed after requesting a flush is not flushed */
+  _add_socket();
+  _flush_in_walk = true;
+  _remove_in_walk = true;
+
+  CHECK_TRUE(_run_scheduler() == 0, "scheduler failed");
+  CHECK_TRUE(strcmp(_events, "t") == 0, "events: %s", _events);
+  CHECK_TRUE(!list_is_node_added(&_socket._flush_node), "removed socket still waits for flush");
+
+  END_TEST();
+}
+
+/**
+ * Fill an array of outgoing datagrams
+ * @param dgrams datagram array
+ * @param count number of datagrams
+ * @param length length of all datagrams except the last one
+ * @param last_length length of the last datagram
+ * @param remote destination of all datagrams
+ */
+static void
+_fill_datagrams(struct os_fd_datagram *dgrams, size_t count, size_t length, size_t last_length,
+  const union netaddr_socket *remote) {
+  static uint8_t buf[1500];
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    dgrams[i].buf = buf;
+    dgrams[i].buflen = sizeof(buf);
+    dgrams[i].length = i == count - 1 ? last_length : length;
+    memcpy(&dgrams[i].remote, remote, sizeof(*remote));
+  }
+}
+
+/**
+ * @param msg message handed to sendmmsg()
+ * @return segment size of UDP segmentation offload message, 0 if none
+ */
+static uint16_t
+_get_gso_size(struct mmsghdr *msg) {
+#ifdef UDP_SEGMENT
+  struct cmsghdr *cmsg;
+  uint16_t size;
+
+  if (msg->msg_hdr.msg_controllen == 0) {
+    return 0;
+  }
+
+  cmsg = CMSG_FIRSTHDR(&msg->msg_hdr);
+  if (cmsg == NULL || cmsg->cmsg_level != IPPROTO_UDP || cmsg->cmsg_type != UDP_SEGMENT) {
+    return 0;
+  }
+  memcpy(&size, CMSG_DATA(cmsg), sizeof(size));
+  return size;
+#else
+  return msg->msg_hdr.msg_controllen > 0 ? 1 : 0;
+#endif
+}
+
+static void
+test_sendto_batch(void) {
+  struct os_fd_datagram dgrams[6];
+  union netaddr_socket remote1, remote2;
+
+  START_TEST();
+
+  _add_socket();
+  netaddr_socket_init(&remote1, &NETADDR_IPV4_ANY, 1000, 0);
+  netaddr_socket_init(&remote2, &NETADDR_IPV4_ANY, 2000, 0);
+
+  /* no segmentation offload, one message per datagram */
+  _fill_datagrams(dgrams, 4, 100, 100, &remote1);
+  CHECK_TRUE(os_fd_sendto_batch(&_socket.fd, dgrams, 4, false, false) == 4, "not all datagrams sent");
+  CHECK_TRUE(_msg_count == 4, "%u messages", _msg_count);
+  CHECK_TRUE(_get_gso_size(&_msgs[0]) == 0, "segmentation offload used");
+
+#ifdef UDP_SEGMENT
+  /* equal datagrams to the same destination, the last one might be shorter */
+  _fill_datagrams(dgrams, 4, 100, 40, &remote1);
+  CHECK_TRUE(os_fd_sendto_batch(&_socket.fd, dgrams, 4, false, true) == 4, "not all datagrams sent");
+  CHECK_TRUE(_msg_count == 1, "%u messages", _msg_count);
+  CHECK_TRUE(_msgs[0].msg_hdr.msg_iovlen == 4, "%zu segments", (size_t)_msgs[0].msg_hdr.msg_iovlen);
+  CHECK_TRUE(_get_gso_size(&_msgs[0]) == 100, "segment size %u", _get_gso_size(&_msgs[0]));
+
+  /* a new destination or a larger datagram starts a new message */
+  _fill_datagrams(dgrams, 6, 100, 100, &remote1);
+  memcpy(&dgrams[2].remote, &remote2, sizeof(remote2));
+  dgrams[5].length = 200;
+  CHECK_TRUE(os_fd_sendto_batch(&_socket.fd, dgrams, 6, false, true) == 6, "not all datagrams sent");
+  CHECK_TRUE(_msg_count == 4, "%u messages", _msg_count);
+  CHECK_TRUE(_msgs[0].msg_hdr.msg_iovlen == 2, "first message has %zu segments",
+    (size_t)_msgs[0].msg_hdr.msg_iovlen);
+  CHECK_TRUE(_msgs[1].msg_hdr.msg_iovlen == 1, "second message has %zu segments",
+    (size_t)_msgs[1].msg_hdr.msg_iovlen);
+  CHECK_TRUE(_get_gso_size(&_msgs[1]) == 0, "single datagram uses segmentation offload");
+  CHECK_TRUE(_msgs[2].msg_hdr.msg_iovlen == 2, "third message has %zu segments",
+    (size_t)_msgs[2].msg_hdr.msg_iovlen);
+  CHECK_TRUE(_msgs[3].msg_hdr.msg_iovlen == 1, "fourth message has %zu segments",
+    (size_t)_msgs[3].msg_hdr.msg_iovlen);
+#endif
+
+  END_TEST();
+}
+
+static void
+test_sendto_batch_gso_rejected(void) {
+  struct os_fd_datagram dgrams[4];
+  union netaddr_socket remote;
+
+  START_TEST();
+
+  _add_socket();
+  netaddr_socket_init(&remote, &NETADDR_IPV4_ANY, 1000, 0);
+  _fill_datagrams(dgrams, 4, 100, 100, &remote);
+
+  /* kernel rejects segmentation offload, the batch is resent without it */
+  _reject_gso = true;
+  CHECK_TRUE(os_fd_sendto_batch(&_socket.fd, dgrams, 4, false, true) == 4, "not all datagrams sent");
+#ifdef UDP_SEGMENT
+  CHECK_TRUE(_sendmmsg_calls == 2, "%d sendmmsg calls", _sendmmsg_calls);
+#endif
+  CHECK_TRUE(_msg_count == 4, "%u messages", _msg_count);
+  CHECK_TRUE(_get_gso_size(&_msgs[0]) == 0, "segmentation offload used after rejection");
+
+  /* segmentation offload is not tried again */
+  _sendmmsg_calls = 0;
+  CHECK_TRUE(os_fd_sendto_batch(&_socket.fd, dgrams, 4, false, true) == 4, "not all datagrams sent");
+  CHECK_TRUE(_sendmmsg_calls == 1, "%d sendmmsg calls", _sendmmsg_calls);
+  CHECK_TRUE(_msg_count == 4, "%u messages", _msg_count);
+
+  _reject_gso = false;
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  struct oonf_subsystem *socket_subsystem;
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+
+  socket_subsystem = oonf_subsystem_get(OONF_SOCKET_SUBSYSTEM);
+  if (socket_subsystem == NULL || socket_subsystem->init() || _scheduler == NULL) {
+    oonf_log_cleanup();
+    return 1;
+  }
+
+  BEGIN_TESTING(clear_elements);
+
+  test_flush_after_timer_walk();
+  test_flush_after_socket_event();
+  test_flush_removed_socket();
+  test_sendto_batch();
+  test_sendto_batch_gso_rejected();
+
+  result = FINISH_TESTING();
+
+  clear_elements();
+  socket_subsystem->cleanup();
+  oonf_log_cleanup();
+  return result;
+}
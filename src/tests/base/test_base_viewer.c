@@ -0,0 +1,482 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/autobuf.h>
+#include <oonf/libcommon/list.h>
+#include <oonf/libcommon/template.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_stream_socket.h>
+#include <oonf/base/oonf_telnet.h>
+#include <oonf/base/oonf_timer.h>
+#include <oonf/base/oonf_viewer.h>
+#include <oonf/cunit/cunit.h>
+
+#define TEST_COMMAND "viewertest"
+
+/**
+ * class object shown by the viewer template
+ */
+struct _test_item {
+  /*! name of item */
+  char name[16];
+
+  /*! value of item */
+  int value;
+
+  /*! node for list of items */
+  struct list_entity _node;
+};
+
+static struct oonf_appdata _appdata = {
+  .app_name = "test_base_viewer",
+};
+
+static int _cb_create_item(struct oonf_viewer_template *template);
+static int _cb_create_item_object(struct oonf_viewer_template *template, void *ptr);
+static int _cb_create_static(struct oonf_viewer_template *template);
+static enum oonf_telnet_result _cb_viewertest(struct oonf_telnet_data *con);
+
+static struct oonf_stream_managed *_telnet_managed;
+
+static struct oonf_class _item_class = {
+  .name = "viewer test item",
+  .size = sizeof(struct _test_item),
+};
+
+static struct list_entity _item_list;
+
+static char _value_name[16];
+static char _value_value[12];
+
+static struct abuf_template_data_entry _tde_item[] = {
+  { "name", _value_name, true },
+  { "value", _value_value, false },
+};
+
+static struct abuf_template_data _td_item[] = {
+  { _tde_item, ARRAYSIZE(_tde_item) },
+};
+
+static struct oonf_viewer_template _templates[] = {
+  {
+    .data = _td_item,
+    .data_size = ARRAYSIZE(_td_item),
+    .json_name = "item",
+    .cb_function = _cb_create_item,
+    .class_name = "viewer test item",
+    .cb_object = _cb_create_item_object,
+  },
+  {
+    .data = _td_item,
+    .data_size = ARRAYSIZE(_td_item),
+    .json_name = "static",
+    .cb_function = _cb_create_static,
+  },
+};
+
+static struct abuf_template_storage _template_storage;
+
+static struct oonf_telnet_command _telnet_cmds[] = {
+  TELNET_CMD(TEST_COMMAND, _cb_viewertest, "Viewer test command"),
+};
+
+/* stream socket stubs, the test reads the output buffer itself */
+void
+oonf_stream_add_managed(struct oonf_stream_managed *managed) {
+  _telnet_managed = managed;
+}
+
+int
+oonf_stream_apply_managed(
+  struct oonf_stream_managed *managed __attribute__((unused)), struct oonf_stream_managed_config *config
+  __attribute__((unused))) {
+  return 0;
+}
+
+void
+oonf_stream_remove_managed(struct oonf_stream_managed *managed __attribute__((unused)), bool force
+  __attribute__((unused))) {}
+
+void
+oonf_stream_free_managed_config(struct oonf_stream_managed_config *config __attribute__((unused))) {}
+
+void
+oonf_stream_flush(struct oonf_stream_session *con __attribute__((unused))) {}
+
+void
+oonf_stream_set_timeout(struct oonf_stream_session *con __attribute__((unused)), uint64_t timeout
+  __attribute__((unused))) {}
+
+/* timer stubs, timers never fire */
+void
+oonf_timer_add(struct oonf_timer_class *ti __attribute__((unused))) {}
+
+void
+oonf_timer_remove(struct oonf_timer_class *ti __attribute__((unused))) {}
+
+void
+oonf_timer_start_ext(struct oonf_timer_instance *timer, uint64_t first, uint64_t interval) {
+  timer->_clock = first;
+  timer->_period = interval;
+}
+
+void
+oonf_timer_stop(struct oonf_timer_instance *timer) {
+  timer->_clock = 0;
+}
+
+static int
+_cb_create_item_object(struct oonf_viewer_template *template, void *ptr) {
+  struct _test_item *item = ptr;
+
+  strscpy(_value_name, item->name, sizeof(_value_name));
+  snprintf(_value_value, sizeof(_value_value), "%d", item->value);
+
+  oonf_viewer_output_print_line(template);
+  return 0;
+}
+
+static int
+_cb_create_item(struct oonf_viewer_template *template) {
+  struct _test_item *item;
+
+  list_for_each_element(&_item_list, item, _node) {
+    _cb_create_item_object(template, item);
+  }
+  return 0;
+}
+
+static int
+_cb_create_static(struct oonf_viewer_template *template) {
+  strscpy(_value_name, "static", sizeof(_value_name));
+  strscpy(_value_value, "0", sizeof(_value_value));
+  oonf_viewer_output_print_line(template);
+  return 0;
+}
+
+static enum oonf_telnet_result
+_cb_viewertest(struct oonf_telnet_data *con) {
+  return oonf_viewer_telnet_session_handler(con, &_template_storage, TEST_COMMAND, _templates, ARRAYSIZE(_templates));
+}
+
+static struct _test_item *
+_add_item(const char *name, int value) {
+  struct _test_item *item;
+
+  item = oonf_class_malloc(&_item_class);
+  strscpy(item->name, name, sizeof(item->name));
+  item->value = value;
+  list_add_tail(&_item_list, &item->_node);
+
+  oonf_class_event(&_item_class, item, OONF_OBJECT_ADDED);
+  return item;
+}
+
+static void
+_change_item(struct _test_item *item, int value) {
+  item->value = value;
+  oonf_class_event(&_item_class, item, OONF_OBJECT_CHANGED);
+}
+
+static void
+_remove_item(struct _test_item *item) {
+  oonf_class_event(&_item_class, item, OONF_OBJECT_REMOVED);
+  list_remove(&item->_node);
+  oonf_class_free(&_item_class, item);
+}
+
+/**
+ * Create a telnet session and send it a command
+ * @param session telnet session
+ * @param line command line
+ */
+static void
+_start_session(struct oonf_telnet_session *session, const char *line) {
+  memset(session, 0, sizeof(*session));
+  abuf_init(&session->session.in);
+  abuf_init(&session->session.out);
+  session->session.state = STREAM_SESSION_ACTIVE;
+
+  _telnet_managed->config.init_session(&session->session);
+
+  abuf_puts(&session->session.in, line);
+  _telnet_managed->config.receive_data(&session->session);
+}
+
+static void
+_free_session(struct oonf_telnet_session *session) {
+  _telnet_managed->config.cleanup_session(&session->session);
+  abuf_free(&session->session.in);
+  abuf_free(&session->session.out);
+}
+
+static uint32_t
+_get_usage(const char *name) {
+  struct oonf_class *c;
+
+  c = avl_find_element(oonf_class_get_tree(), name, c, _node);
+  return c ? oonf_class_get_usage(c) : 0;
+}
+
+static const char *
+_get_output(struct oonf_telnet_session *session) {
+  return abuf_getptr(&session->session.out);
+}
+
+static void
+clear_elements(void) {
+  struct _test_item *item, *it;
+
+  list_for_each_element_safe(&_item_list, item, _node, it) {
+    list_remove(&item->_node);
+    oonf_class_free(&_item_class, item);
+  }
+}
+
+static void
+test_subscribe_events(void) {
+  struct oonf_telnet_session session;
+  struct _test_item *item;
+
+  START_TEST();
+
+  _add_item("first", 1);
+
+  _start_session(&session, TEST_COMMAND " subscribe item\n");
+  CHECK_TRUE(session.data.stop_handler != NULL, "subscription is not continous");
+  CHECK_TRUE(strcmp(_get_output(&session), "{\"event\":\"current\",\"item\":{\"name\":\"first\",\"value\":1}}\n") == 0,
+    "unexpected current state: %s", _get_output(&session));
+
+  abuf_clear(&session.session.out);
+  item = _add_item("second", 2);
+  CHECK_TRUE(strcmp(_get_output(&session), "{\"event\":\"added\",\"item\":{\"name\":\"second\",\"value\":2}}\n") == 0,
+    "unexpected added event: %s", _get_output(&session));
+
+  abuf_clear(&session.session.out);
+  _change_item(item, 3);
+  CHECK_TRUE(strcmp(_get_output(&session), "{\"event\":\"changed\",\"item\":{\"name\":\"second\",\"value\":3}}\n") == 0,
+    "unexpected changed event: %s", _get_output(&session));
+
+  abuf_clear(&session.session.out);
+  _remove_item(item);
+  CHECK_TRUE(strcmp(_get_output(&session), "{\"event\":\"removed\",\"item\":{\"name\":\"second\",\"value\":3}}\n") == 0,
+    "unexpected removed event: %s", _get_output(&session));
+
+  _free_session(&session);
+
+  END_TEST();
+}
+
+static void
+test_subscribe_errors(void) {
+  struct oonf_telnet_session session;
+
+  START_TEST();
+
+  _start_session(&session, TEST_COMMAND " subscribe\n");
+  CHECK_TRUE(session.data.stop_handler == NULL, "subscription without subcommand");
+  CHECK_TRUE(strstr(_get_output(&session), "needs at least one subcommand") != NULL, "unexpected output: %s",
+    _get_output(&session));
+  _free_session(&session);
+
+  /* template without class cannot be subscribed */
+  _start_session(&session, TEST_COMMAND " subscribe item static\n");
+  CHECK_TRUE(session.data.stop_handler == NULL, "subscription of static template");
+  CHECK_TRUE(strstr(_get_output(&session), "subcommand 'static'") != NULL, "unexpected output: %s",
+    _get_output(&session));
+  CHECK_TRUE(_get_usage("viewer subscription") == 0, "subscription not freed");
+  CHECK_TRUE(_get_usage("viewer subscriber") == 0, "subscriber not freed");
+  CHECK_TRUE(_get_usage("viewer listener") == 0, "listener not freed");
+  _free_session(&session);
+
+  _start_session(&session, TEST_COMMAND " subscribe unknown\n");
+  CHECK_TRUE(session.data.stop_handler == NULL, "subscription of unknown template");
+  CHECK_TRUE(strstr(_get_output(&session), "subcommand 'unknown'") != NULL, "unexpected output: %s",
+    _get_output(&session));
+  _free_session(&session);
+
+  END_TEST();
+}
+
+static void
+test_subscribe_overflow(void) {
+  struct oonf_telnet_session session;
+  struct _test_item *item;
+  char line[256];
+  size_t len;
+  int i;
+
+  START_TEST();
+
+  item = _add_item("item", 0);
+  _start_session(&session, TEST_COMMAND " subscribe item\n");
+
+  /* client stops reading */
+  abuf_clear(&session.session.out);
+  while (abuf_getlen(&session.session.out) <= OONF_VIEWER_SUBSCRIPTION_BACKLOG) {
+    _change_item(item, 1);
+  }
+  len = abuf_getlen(&session.session.out);
+
+  /* further events are dropped */
+  for (i = 0; i < 3; i++) {
+    _change_item(item, 10 + i);
+  }
+  CHECK_TRUE(abuf_getlen(&session.session.out) == len, "events were not dropped");
+
+  /* client has read its buffer, the next event reports the dropped ones */
+  abuf_clear(&session.session.out);
+  _change_item(item, 20);
+  snprintf(line, sizeof(line),
+    "{\"event\":\"overflow\",\"dropped\":3}\n"
+    "{\"event\":\"changed\",\"item\":{\"name\":\"item\",\"value\":20}}\n");
+  CHECK_TRUE(strcmp(_get_output(&session), line) == 0, "unexpected output after overflow: %s", _get_output(&session));
+
+  /* overflow is only reported once */
+  abuf_clear(&session.session.out);
+  _change_item(item, 21);
+  CHECK_TRUE(strcmp(_get_output(&session), "{\"event\":\"changed\",\"item\":{\"name\":\"item\",\"value\":21}}\n") == 0,
+    "unexpected output: %s", _get_output(&session));
+
+  _free_session(&session);
+
+  END_TEST();
+}
+
+static void
+test_unsubscribe(void) {
+  struct oonf_telnet_session session1, session2;
+  struct oonf_subsystem *viewer;
+
+  START_TEST();
+
+  _start_session(&session1, TEST_COMMAND " subscribe item\n");
+  _start_session(&session2, TEST_COMMAND " subscriberaw item\n");
+  CHECK_TRUE(_get_usage("viewer subscription") == 2, "%u subscriptions", _get_usage("viewer subscription"));
+  CHECK_TRUE(_get_usage("viewer subscriber") == 2, "%u subscribers", _get_usage("viewer subscriber"));
+  CHECK_TRUE(_get_usage("viewer listener") == 1, "%u listeners", _get_usage("viewer listener"));
+
+  /* next command ends the first subscription */
+  abuf_puts(&session1.session.in, "echo done\n");
+  _telnet_managed->config.receive_data(&session1.session);
+  CHECK_TRUE(session1.data.stop_handler == NULL, "first subscription not stopped");
+  CHECK_TRUE(_get_usage("viewer subscription") == 1, "%u subscriptions", _get_usage("viewer subscription"));
+  CHECK_TRUE(_get_usage("viewer listener") == 1, "listener removed with remaining subscriber");
+
+  abuf_clear(&session1.session.out);
+  abuf_clear(&session2.session.out);
+  _add_item("item", 1);
+  CHECK_TRUE(abuf_getlen(&session1.session.out) == 0, "stopped subscription got event: %s", _get_output(&session1));
+  CHECK_TRUE(abuf_getlen(&session2.session.out) > 0, "remaining subscription got no event");
+
+  /* end of session ends the second one and removes the class listener */
+  _free_session(&session2);
+  CHECK_TRUE(_get_usage("viewer subscription") == 0, "%u subscriptions", _get_usage("viewer subscription"));
+  CHECK_TRUE(_get_usage("viewer subscriber") == 0, "%u subscribers", _get_usage("viewer subscriber"));
+  CHECK_TRUE(_get_usage("viewer listener") == 0, "%u listeners", _get_usage("viewer listener"));
+
+  abuf_clear(&session1.session.out);
+  _add_item("item", 2);
+  CHECK_TRUE(abuf_getlen(&session1.session.out) == 0, "event after unsubscribe: %s", _get_output(&session1));
+  _free_session(&session1);
+
+  /* unloading the viewer ends all subscriptions */
+  _start_session(&session1, TEST_COMMAND " subscribe item\n");
+  viewer = oonf_subsystem_get(OONF_VIEWER_SUBSYSTEM);
+  viewer->cleanup();
+  CHECK_TRUE(session1.data.stop_handler == NULL, "subscription not stopped by unload");
+  viewer->init();
+  CHECK_TRUE(_get_usage("viewer subscription") == 0, "%u subscriptions", _get_usage("viewer subscription"));
+  _free_session(&session1);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  struct oonf_subsystem *class_subsystem, *telnet, *viewer;
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+
+  class_subsystem = oonf_subsystem_get(OONF_CLASS_SUBSYSTEM);
+  telnet = oonf_subsystem_get(OONF_TELNET_SUBSYSTEM);
+  viewer = oonf_subsystem_get(OONF_VIEWER_SUBSYSTEM);
+  if (class_subsystem == NULL || telnet == NULL || viewer == NULL || class_subsystem->init()) {
+    oonf_log_cleanup();
+    return 1;
+  }
+  telnet->init();
+  viewer->init();
+
+  oonf_class_add(&_item_class);
+  list_init_head(&_item_list);
+  oonf_telnet_add(&_telnet_cmds[0]);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_subscribe_events();
+  test_subscribe_errors();
+  test_subscribe_overflow();
+  test_unsubscribe();
+
+  result = FINISH_TESTING();
+
+  oonf_telnet_remove(&_telnet_cmds[0]);
+  oonf_class_remove(&_item_class);
+  viewer->cleanup();
+  telnet->cleanup();
+  class_subsystem->cleanup();
+  oonf_log_cleanup();
+  return result;
+}
@@ -0,0 +1,326 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Microbenchmark for the verification throughput of RFC7182 HMAC-SHA256
+ * signatures with a worker pool of 1, 2 and 4 threads. Each batch
+ * models the signature candidates checked within one reader callback.
+ * The SHA256 implementation is a plain reference version to keep the
+ * benchmark independent from the crypto libraries.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/container_of.h>
+#include <oonf/crypto/rfc5444_signature/worker_pool.h>
+
+/* size of a signed packet */
+#define PACKET_SIZE 1280
+
+/* number of distinct packets in the workload */
+#define PACKET_COUNT 64
+
+struct bench_verify {
+  struct worker_job job;
+
+  const uint8_t *data;
+  uint8_t signature[32];
+  bool verified;
+};
+
+struct sha256_state {
+  uint32_t h[8];
+  uint8_t block[64];
+  size_t block_len;
+  uint64_t total_len;
+};
+
+static const uint32_t _k[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint8_t _key[] = "benchmark shared key";
+
+static uint8_t _packets[PACKET_COUNT][PACKET_SIZE];
+
+static uint32_t
+_ror(uint32_t x, int n) {
+  return (x >> n) | (x << (32 - n));
+}
+
+static void
+_sha256_block(struct sha256_state *s, const uint8_t *p) {
+  uint32_t w[64], a, b, c, d, e, f, g, h, t1, t2;
+  int i;
+
+  for (i = 0; i < 16; i++) {
+    w[i] = (uint32_t)p[4 * i] << 24 | (uint32_t)p[4 * i + 1] << 16 | (uint32_t)p[4 * i + 2] << 8 | p[4 * i + 3];
+  }
+  for (; i < 64; i++) {
+    w[i] = w[i - 16] + (_ror(w[i - 15], 7) ^ _ror(w[i - 15], 18) ^ (w[i - 15] >> 3)) + w[i - 7] +
+           (_ror(w[i - 2], 17) ^ _ror(w[i - 2], 19) ^ (w[i - 2] >> 10));
+  }
+
+  a = s->h[0];
+  b = s->h[1];
+  c = s->h[2];
+  d = s->h[3];
+  e = s->h[4];
+  f = s->h[5];
+  g = s->h[6];
+  h = s->h[7];
+  for (i = 0; i < 64; i++) {
+    t1 = h + (_ror(e, 6) ^ _ror(e, 11) ^ _ror(e, 25)) + ((e & f) ^ (~e & g)) + _k[i] + w[i];
+    t2 = (_ror(a, 2) ^ _ror(a, 13) ^ _ror(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  s->h[0] += a;
+  s->h[1] += b;
+  s->h[2] += c;
+  s->h[3] += d;
+  s->h[4] += e;
+  s->h[5] += f;
+  s->h[6] += g;
+  s->h[7] += h;
+}
+
+static void
+_sha256_init(struct sha256_state *s) {
+  static const uint32_t iv[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+  };
+
+  memcpy(s->h, iv, sizeof(iv));
+  s->block_len = 0;
+  s->total_len = 0;
+}
+
+static void
+_sha256_update(struct sha256_state *s, const uint8_t *data, size_t len) {
+  size_t chunk;
+
+  s->total_len += len;
+  while (len > 0) {
+    chunk = 64 - s->block_len;
+    if (chunk > len) {
+      chunk = len;
+    }
+    memcpy(&s->block[s->block_len], data, chunk);
+    s->block_len += chunk;
+    data += chunk;
+    len -= chunk;
+
+    if (s->block_len == 64) {
+      _sha256_block(s, s->block);
+      s->block_len = 0;
+    }
+  }
+}
+
+static void
+_sha256_final(struct sha256_state *s, uint8_t *digest) {
+  uint64_t bits = s->total_len * 8;
+  uint8_t pad = 0x80;
+  int i;
+
+  _sha256_update(s, &pad, 1);
+  pad = 0;
+  while (s->block_len != 56) {
+    _sha256_update(s, &pad, 1);
+  }
+  for (i = 0; i < 8; i++) {
+    s->block[56 + i] = bits >> (56 - 8 * i);
+  }
+  _sha256_block(s, s->block);
+
+  for (i = 0; i < 8; i++) {
+    digest[4 * i] = s->h[i] >> 24;
+    digest[4 * i + 1] = s->h[i] >> 16;
+    digest[4 * i + 2] = s->h[i] >> 8;
+    digest[4 * i + 3] = s->h[i];
+  }
+}
+
+static void
+_hmac_sha256(uint8_t *dst, const uint8_t *data, size_t len) {
+  struct sha256_state s;
+  uint8_t pad[64], inner[32];
+  size_t i;
+
+  memset(pad, 0, sizeof(pad));
+  memcpy(pad, _key, sizeof(_key));
+  for (i = 0; i < sizeof(pad); i++) {
+    pad[i] ^= 0x36;
+  }
+  _sha256_init(&s);
+  _sha256_update(&s, pad, sizeof(pad));
+  _sha256_update(&s, data, len);
+  _sha256_final(&s, inner);
+
+  for (i = 0; i < sizeof(pad); i++) {
+    pad[i] ^= 0x36 ^ 0x5c;
+  }
+  _sha256_init(&s);
+  _sha256_update(&s, pad, sizeof(pad));
+  _sha256_update(&s, inner, sizeof(inner));
+  _sha256_final(&s, dst);
+}
+
+static void
+_cb_verify(struct worker_job *job) {
+  struct bench_verify *v = container_of(job, struct bench_verify, job);
+  uint8_t digest[32];
+
+  _hmac_sha256(digest, v->data, PACKET_SIZE);
+  v->verified = memcmp(digest, v->signature, sizeof(digest)) == 0;
+}
+
+static uint64_t
+_get_usec(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static uint64_t
+_run(size_t threads, struct bench_verify *verify, struct worker_job **jobs, size_t count, size_t batch) {
+  struct worker_pool pool;
+  uint64_t start, end;
+  size_t i, n;
+
+  if (worker_pool_init(&pool, threads)) {
+    fprintf(stderr, "Could not start %" PRINTF_SIZE_T_SPECIFIER " threads\n", threads);
+    exit(1);
+  }
+
+  start = _get_usec();
+  for (i = 0; i < count; i += batch) {
+    n = count - i < batch ? count - i : batch;
+    worker_pool_run(&pool, &jobs[i], n);
+  }
+  end = _get_usec();
+
+  worker_pool_remove(&pool);
+
+  for (i = 0; i < count; i++) {
+    if (!verify[i].verified) {
+      fprintf(stderr, "Signature %" PRINTF_SIZE_T_SPECIFIER " did not verify\n", i);
+      exit(1);
+    }
+    verify[i].verified = false;
+  }
+  return end - start;
+}
+
+int
+main(int argc, char **argv) {
+  static const size_t threads[] = { 1, 2, 4 };
+  struct bench_verify *verify;
+  struct worker_job **jobs;
+  uint64_t usec, base;
+  size_t count, batch, i, j;
+
+  count = argc > 1 ? strtoul(argv[1], NULL, 10) : 20000;
+  batch = argc > 2 ? strtoul(argv[2], NULL, 10) : 8;
+  if (count == 0 || batch == 0) {
+    fprintf(stderr, "usage: %s [signatures] [batch size]\n", argv[0]);
+    return 1;
+  }
+
+  verify = calloc(count, sizeof(*verify));
+  jobs = calloc(count, sizeof(*jobs));
+  if (!verify || !jobs) {
+    fprintf(stderr, "Could not allocate %" PRINTF_SIZE_T_SPECIFIER " signatures\n", count);
+    return 1;
+  }
+
+  srand(1);
+  for (i = 0; i < PACKET_COUNT; i++) {
+    for (j = 0; j < PACKET_SIZE; j++) {
+      _packets[i][j] = rand();
+    }
+  }
+  for (i = 0; i < count; i++) {
+    verify[i].job.run = _cb_verify;
+    verify[i].data = _packets[i % PACKET_COUNT];
+    _hmac_sha256(verify[i].signature, verify[i].data, PACKET_SIZE);
+    jobs[i] = &verify[i].job;
+  }
+
+  printf("%" PRINTF_SIZE_T_SPECIFIER " HMAC-SHA256 signatures of %d bytes, batches of %" PRINTF_SIZE_T_SPECIFIER "\n",
+    count, PACKET_SIZE, batch);
+  printf("%8s %14s %14s %8s\n", "threads", "time [us]", "verify [1/s]", "speedup");
+
+  base = 0;
+  for (i = 0; i < ARRAYSIZE(threads); i++) {
+    usec = _run(threads[i], verify, jobs, count, batch);
+    if (i == 0) {
+      base = usec;
+    }
+    printf("%8" PRINTF_SIZE_T_SPECIFIER " %14" PRIu64 " %14.0f %7.2fx\n", threads[i], usec,
+      1000000.0 * count / (usec ? usec : 1), (double)base / (usec ? usec : 1));
+  }
+
+  free(jobs);
+  free(verify);
+  return 0;
+}
@@ -0,0 +1,393 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Microbenchmark comparing the indexed binary heap with the AVL tree
+ * previously used as the working queue of the OLSRv2 Dijkstra. Both
+ * queues run a full shortest path calculation over synthetic TC
+ * topologies (grid, random geometric and scale-free) with the same
+ * relaxation pattern as the OLSRv2 routing code.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/avl_comp.h>
+#include <oonf/libcommon/heap.h>
+
+struct bench_node {
+  uint32_t path_cost;
+  bool done;
+
+  /* outgoing edges (index into edge arrays) */
+  uint32_t edge_start;
+  uint32_t edge_count;
+
+  struct avl_node avl;
+  struct heap_node heap;
+};
+
+struct bench_topology {
+  const char *name;
+  void (*create)(size_t count);
+};
+
+/* number of SPF runs per topology, each from a different root */
+#define RUNS 20
+
+/* range of link costs, similar to the values of the ff_dat metric */
+#define COST_MIN 0x1000
+#define COST_MAX 0x10000
+
+static struct bench_node *_nodes;
+static size_t _node_count;
+
+/* temporary list of undirected links while creating a topology */
+static uint32_t (*_links)[2];
+static size_t _link_count, _link_size;
+
+/* directed edges in adjacency array format */
+static uint32_t *_edge_dst;
+static uint32_t *_edge_cost;
+
+static struct avl_tree _tree;
+static struct heap _heap;
+
+static uint64_t
+_get_usec(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static void
+_add_link(uint32_t n1, uint32_t n2) {
+  if (_link_count == _link_size) {
+    _link_size = _link_size ? _link_size * 2 : 1024;
+    _links = realloc(_links, sizeof(*_links) * _link_size);
+    if (!_links) {
+      fprintf(stderr, "Out of memory\n");
+      exit(1);
+    }
+  }
+  _links[_link_count][0] = n1;
+  _links[_link_count][1] = n2;
+  _link_count++;
+}
+
+static void
+_create_grid(size_t count) {
+  size_t width, i;
+
+  for (width = 1; (width + 1) * (width + 1) <= count; width++)
+    ;
+  for (i = 0; i < count; i++) {
+    if ((i + 1) % width != 0 && i + 1 < count) {
+      _add_link(i, i + 1);
+    }
+    if (i + width < count) {
+      _add_link(i, i + width);
+    }
+  }
+}
+
+static void
+_create_random_geometric(size_t count) {
+  double *x, *y, radius2, dx, dy;
+  size_t i, j;
+
+  x = calloc(count, sizeof(double));
+  y = calloc(count, sizeof(double));
+  if (!x || !y) {
+    fprintf(stderr, "Out of memory\n");
+    exit(1);
+  }
+
+  for (i = 0; i < count; i++) {
+    x[i] = rand() / (double)RAND_MAX;
+    y[i] = rand() / (double)RAND_MAX;
+  }
+
+  /* squared radius for an average degree of about 8 */
+  radius2 = 8.0 / (3.14159265 * count);
+
+  for (i = 0; i < count; i++) {
+    /* connect to previous node to keep the topology connected */
+    if (i > 0) {
+      _add_link(i - 1, i);
+    }
+    for (j = i + 2; j < count; j++) {
+      dx = x[i] - x[j];
+      dy = y[i] - y[j];
+      if (dx * dx + dy * dy < radius2) {
+        _add_link(i, j);
+      }
+    }
+  }
+  free(x);
+  free(y);
+}
+
+static void
+_create_scale_free(size_t count) {
+  size_t i, first, link;
+  int m;
+
+  /* Barabasi-Albert: each new node links to 2 nodes, chosen proportional to their degree */
+  _add_link(0, 1);
+  for (i = 2; i < count; i++) {
+    first = _link_count;
+    for (m = 0; m < 2; m++) {
+      link = rand() % first;
+      _add_link(i, _links[link][rand() % 2]);
+    }
+  }
+}
+
+static const struct bench_topology _topologies[] = {
+  { "grid", _create_grid },
+  { "geometric", _create_random_geometric },
+  { "scale-free", _create_scale_free },
+};
+
+static void
+_create_topology(const struct bench_topology *topo, size_t count) {
+  uint32_t *fill;
+  size_t i, j;
+
+  srand(1);
+  _link_count = 0;
+  topo->create(count);
+
+  memset(_nodes, 0, sizeof(*_nodes) * count);
+  _node_count = count;
+
+  for (i = 0; i < _link_count; i++) {
+    _nodes[_links[i][0]].edge_count++;
+    _nodes[_links[i][1]].edge_count++;
+  }
+  for (i = 1; i < count; i++) {
+    _nodes[i].edge_start = _nodes[i - 1].edge_start + _nodes[i - 1].edge_count;
+  }
+
+  free(_edge_dst);
+  free(_edge_cost);
+  _edge_dst = calloc(2 * _link_count + 1, sizeof(uint32_t));
+  _edge_cost = calloc(2 * _link_count + 1, sizeof(uint32_t));
+  fill = calloc(count, sizeof(uint32_t));
+  if (!_edge_dst || !_edge_cost || !fill) {
+    fprintf(stderr, "Out of memory\n");
+    exit(1);
+  }
+
+  /* every link becomes two directed edges with independent costs */
+  for (i = 0; i < _link_count; i++) {
+    for (j = 0; j < 2; j++) {
+      struct bench_node *src = &_nodes[_links[i][j]];
+      uint32_t idx = src->edge_start + fill[_links[i][j]]++;
+
+      _edge_dst[idx] = _links[i][1 - j];
+      _edge_cost[idx] = COST_MIN + rand() % (COST_MAX - COST_MIN);
+    }
+  }
+  free(fill);
+}
+
+static void
+_prepare_nodes(void) {
+  size_t i;
+
+  for (i = 0; i < _node_count; i++) {
+    _nodes[i].path_cost = UINT32_MAX;
+    _nodes[i].done = false;
+    _nodes[i].avl.key = &_nodes[i].path_cost;
+  }
+}
+
+static uint64_t
+_run_avl(uint32_t root) {
+  struct bench_node *node, *dst;
+  uint64_t sum;
+  uint32_t i, cost;
+
+  _prepare_nodes();
+  avl_init(&_tree, avl_comp_uint32, true);
+
+  _nodes[root].path_cost = 0;
+  avl_insert(&_tree, &_nodes[root].avl);
+
+  sum = 0;
+  while (!avl_is_empty(&_tree)) {
+    node = avl_first_element(&_tree, node, avl);
+    avl_remove(&_tree, &node->avl);
+    node->done = true;
+    sum += node->path_cost;
+
+    for (i = 0; i < node->edge_count; i++) {
+      dst = &_nodes[_edge_dst[node->edge_start + i]];
+      cost = node->path_cost + _edge_cost[node->edge_start + i];
+      if (dst->done || dst->path_cost <= cost) {
+        continue;
+      }
+
+      if (avl_is_node_added(&dst->avl)) {
+        avl_remove(&_tree, &dst->avl);
+      }
+      dst->path_cost = cost;
+      avl_insert(&_tree, &dst->avl);
+    }
+  }
+  return sum;
+}
+
+static uint64_t
+_run_heap(uint32_t root) {
+  struct bench_node *node, *dst;
+  uint64_t sum;
+  uint32_t i, cost;
+
+  _prepare_nodes();
+
+  _nodes[root].path_cost = 0;
+  _nodes[root].heap.key = 0;
+  heap_insert(&_heap, &_nodes[root].heap);
+
+  sum = 0;
+  while (!heap_is_empty(&_heap)) {
+    node = heap_extract_min_element(&_heap, node, heap);
+    node->done = true;
+    sum += node->path_cost;
+
+    for (i = 0; i < node->edge_count; i++) {
+      dst = &_nodes[_edge_dst[node->edge_start + i]];
+      cost = node->path_cost + _edge_cost[node->edge_start + i];
+      if (dst->done || dst->path_cost <= cost) {
+        continue;
+      }
+
+      dst->path_cost = cost;
+      if (heap_is_node_added(&dst->heap)) {
+        heap_decrease_key(&_heap, &dst->heap, cost);
+      }
+      else {
+        dst->heap.key = cost;
+        heap_insert(&_heap, &dst->heap);
+      }
+    }
+  }
+  return sum;
+}
+
+int
+main(int argc, char **argv) {
+  static const size_t default_counts[] = { 100, 1000, 10000 };
+  uint64_t avl_time, heap_time, avl_sum, heap_sum, start;
+  size_t count, max_count, t;
+  uint32_t root;
+  int i, n, run;
+
+  n = argc > 1 ? argc - 1 : (int)ARRAYSIZE(default_counts);
+
+  max_count = 0;
+  for (i = 0; i < n; i++) {
+    count = argc > 1 ? strtoul(argv[i + 1], NULL, 10) : default_counts[i];
+    if (count > max_count) {
+      max_count = count;
+    }
+  }
+
+  _nodes = calloc(max_count, sizeof(*_nodes));
+  if (!_nodes) {
+    fprintf(stderr, "Could not allocate %" PRINTF_SIZE_T_SPECIFIER " nodes\n", max_count);
+    return 1;
+  }
+  heap_init(&_heap);
+
+  printf("%-12s %8s %8s %14s %14s %8s\n", "topology", "nodes", "edges", "avl [us/spf]", "heap [us/spf]", "speedup");
+  for (t = 0; t < ARRAYSIZE(_topologies); t++) {
+    for (i = 0; i < n; i++) {
+      count = argc > 1 ? strtoul(argv[i + 1], NULL, 10) : default_counts[i];
+      if (count < 2) {
+        continue;
+      }
+
+      _create_topology(&_topologies[t], count);
+
+      avl_sum = heap_sum = 0;
+      start = _get_usec();
+      for (run = 0; run < RUNS; run++) {
+        root = (uint32_t)((uint64_t)run * count / RUNS);
+        avl_sum += _run_avl(root);
+      }
+      avl_time = _get_usec() - start;
+
+      start = _get_usec();
+      for (run = 0; run < RUNS; run++) {
+        root = (uint32_t)((uint64_t)run * count / RUNS);
+        heap_sum += _run_heap(root);
+      }
+      heap_time = _get_usec() - start;
+
+      if (avl_sum != heap_sum) {
+        fprintf(stderr, "Different path costs for %s/%" PRINTF_SIZE_T_SPECIFIER "\n", _topologies[t].name, count);
+        return 1;
+      }
+
+      printf("%-12s %8" PRINTF_SIZE_T_SPECIFIER " %8" PRINTF_SIZE_T_SPECIFIER " %14.1f %14.1f %7.2fx\n",
+        _topologies[t].name, count, 2 * _link_count, (double)avl_time / RUNS, (double)heap_time / RUNS,
+        heap_time ? (double)avl_time / heap_time : 0.0);
+    }
+  }
+
+  heap_free(&_heap);
+  free(_edge_dst);
+  free(_edge_cost);
+  free(_links);
+  free(_nodes);
+  return 0;
+}
@@ -0,0 +1,323 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Microbenchmark for the DLEP TLV parser. It parses destination update
+ * signals with a typical set of metric TLVs and looks up the TLVs
+ * like the mandatory/duplicate checks and the metric mapping of the
+ * extensions do. The direct-indexed TLV table of the session parser is
+ * compared with the AVL tree lookups the parser used before.
+ */
+
+#include <arpa/inet.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/avl.h>
+#include <oonf/generic/dlep/dlep_iana.h>
+#include <oonf/generic/dlep/dlep_session.h>
+
+/* TLVs of the base protocol, metric, lid and statistics extensions */
+static const uint16_t _allowed_tlvs[] = {
+  DLEP_STATUS_TLV,
+  DLEP_IPV4_CONPOINT_TLV,
+  DLEP_IPV6_CONPOINT_TLV,
+  DLEP_PEER_TYPE_TLV,
+  DLEP_HEARTBEAT_INTERVAL_TLV,
+  DLEP_EXTENSIONS_SUPPORTED_TLV,
+  DLEP_MAC_ADDRESS_TLV,
+  DLEP_IPV4_ADDRESS_TLV,
+  DLEP_IPV6_ADDRESS_TLV,
+  DLEP_IPV4_SUBNET_TLV,
+  DLEP_IPV6_SUBNET_TLV,
+  DLEP_MDRR_TLV,
+  DLEP_MDRT_TLV,
+  DLEP_CDRR_TLV,
+  DLEP_CDRT_TLV,
+  DLEP_LATENCY_TLV,
+  DLEP_RESOURCES_TLV,
+  DLEP_RLQR_TLV,
+  DLEP_RLQT_TLV,
+  DLEP_MTU_TLV,
+  DLEP_LID_TLV,
+  DLEP_LID_LENGTH_TLV,
+  DLEP_FREQUENCY_TLV,
+  DLEP_BANDWIDTH_TLV,
+  DLEP_NOISE_LEVEL_TLV,
+  DLEP_CHANNEL_ACTIVE_TLV,
+  DLEP_CHANNEL_BUSY_TLV,
+  DLEP_CHANNEL_RX_TLV,
+  DLEP_CHANNEL_TX_TLV,
+  DLEP_SIGNAL_RX_TLV,
+  DLEP_SIGNAL_TX_TLV,
+  DLEP_FRAMES_R_TLV,
+  DLEP_FRAMES_T_TLV,
+  DLEP_BYTES_R_TLV,
+  DLEP_BYTES_T_TLV,
+  DLEP_THROUGHPUT_T_TLV,
+  DLEP_FRAMES_RETRIES_TLV,
+  DLEP_FRAMES_FAILED_TLV,
+};
+
+/* content of a destination update signal: TLV type and length */
+static const uint16_t _signal_tlvs[][2] = {
+  { DLEP_MAC_ADDRESS_TLV, 6 },
+  { DLEP_MDRR_TLV, 8 },
+  { DLEP_MDRT_TLV, 8 },
+  { DLEP_CDRR_TLV, 8 },
+  { DLEP_CDRT_TLV, 8 },
+  { DLEP_LATENCY_TLV, 8 },
+  { DLEP_RESOURCES_TLV, 1 },
+  { DLEP_RLQR_TLV, 1 },
+  { DLEP_RLQT_TLV, 1 },
+  { DLEP_MTU_TLV, 2 },
+  { DLEP_SIGNAL_RX_TLV, 4 },
+  { DLEP_SIGNAL_TX_TLV, 4 },
+  { DLEP_FRAMES_R_TLV, 8 },
+  { DLEP_FRAMES_T_TLV, 8 },
+  { DLEP_BYTES_R_TLV, 8 },
+  { DLEP_BYTES_T_TLV, 8 },
+  { DLEP_FRAMES_RETRIES_TLV, 8 },
+  { DLEP_FRAMES_FAILED_TLV, 8 },
+  { DLEP_IPV4_ADDRESS_TLV, 5 },
+  { DLEP_IPV4_ADDRESS_TLV, 5 },
+};
+
+static struct dlep_session _session;
+static struct dlep_parser_tlv _tlvs[ARRAYSIZE(_allowed_tlvs)];
+static uint8_t _signal[1024];
+static size_t _signal_length;
+
+static uint64_t
+_get_usec(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static void
+_init_parser(void) {
+  size_t i;
+
+  if (dlep_parser_init(&_session.parser)) {
+    fprintf(stderr, "Could not initialize parser\n");
+    exit(1);
+  }
+
+  for (i = 0; i < ARRAYSIZE(_allowed_tlvs); i++) {
+    _tlvs[i].id = _allowed_tlvs[i];
+    _tlvs[i].length_min = 0;
+    _tlvs[i].length_max = 65535;
+    _tlvs[i].tlv_first = -1;
+    _tlvs[i].tlv_last = -1;
+    if (dlep_parser_add_tlv(&_session.parser, &_tlvs[i])) {
+      fprintf(stderr, "Could not add TLV %u\n", _allowed_tlvs[i]);
+      exit(1);
+    }
+  }
+}
+
+static void
+_init_signal(void) {
+  uint16_t tmp;
+  size_t i;
+
+  _signal_length = 0;
+  for (i = 0; i < ARRAYSIZE(_signal_tlvs); i++) {
+    tmp = htons(_signal_tlvs[i][0]);
+    memcpy(&_signal[_signal_length], &tmp, sizeof(tmp));
+    tmp = htons(_signal_tlvs[i][1]);
+    memcpy(&_signal[_signal_length + 2], &tmp, sizeof(tmp));
+    memset(&_signal[_signal_length + 4], (int)i, _signal_tlvs[i][1]);
+    _signal_length += 4 + _signal_tlvs[i][1];
+  }
+}
+
+/* AVL based parser loop, as used before the TLV table */
+static enum dlep_parser_error
+_parse_avl(struct dlep_session_parser *parser, const uint8_t *buffer, size_t length) {
+  struct dlep_parser_tlv *tlv;
+  struct dlep_parser_value *value;
+  uint16_t tlv_type, tlv_length;
+  size_t tlv_count, idx;
+
+  parser->tlv_ptr = buffer;
+  tlv_count = 0;
+  idx = 0;
+
+  avl_for_each_element(&parser->allowed_tlvs, tlv, _node) {
+    tlv->tlv_first = -1;
+    tlv->tlv_last = -1;
+  }
+
+  while (idx < length) {
+    if (length - idx < 4) {
+      return DLEP_NEW_PARSER_INCOMPLETE_TLV_HEADER;
+    }
+
+    memcpy(&tlv_type, &buffer[idx], sizeof(tlv_type));
+    idx += sizeof(tlv_type);
+    tlv_type = ntohs(tlv_type);
+
+    memcpy(&tlv_length, &buffer[idx], sizeof(tlv_length));
+    idx += sizeof(tlv_length);
+    tlv_length = ntohs(tlv_length);
+
+    if (idx + tlv_length > length) {
+      return DLEP_NEW_PARSER_INCOMPLETE_TLV;
+    }
+
+    tlv = avl_find_element(&parser->allowed_tlvs, &tlv_type, tlv, _node);
+    if (!tlv) {
+      return DLEP_NEW_PARSER_UNSUPPORTED_TLV;
+    }
+    if (tlv->length_max < tlv_length || tlv->length_min > tlv_length) {
+      return DLEP_NEW_PARSER_ILLEGAL_TLV_LENGTH;
+    }
+
+    value = &parser->values[tlv_count];
+    value->tlv_next = -1;
+    value->index = idx;
+    value->length = tlv_length;
+
+    if (tlv->tlv_last == -1) {
+      tlv->tlv_first = tlv_count;
+    }
+    else {
+      parser->values[tlv->tlv_last].tlv_next = tlv_count;
+    }
+    tlv->tlv_last = tlv_count;
+    tlv_count++;
+
+    idx += tlv_length;
+  }
+  return DLEP_NEW_PARSER_OKAY;
+}
+
+/* lookups of all TLVs of the extensions, AVL variant */
+static size_t
+_lookup_avl(struct dlep_session_parser *parser) {
+  struct dlep_parser_tlv *tlv;
+  size_t i, found;
+
+  found = 0;
+  for (i = 0; i < ARRAYSIZE(_allowed_tlvs); i++) {
+    tlv = avl_find_element(&parser->allowed_tlvs, &_allowed_tlvs[i], tlv, _node);
+    if (tlv && tlv->tlv_first != -1) {
+      found++;
+    }
+  }
+  return found;
+}
+
+/* lookups of all TLVs of the extensions, table variant */
+static size_t
+_lookup_table(struct dlep_session *session) {
+  struct dlep_parser_tlv *tlv;
+  size_t i, found;
+
+  found = 0;
+  for (i = 0; i < ARRAYSIZE(_allowed_tlvs); i++) {
+    tlv = dlep_parser_get_tlv(&session->parser, _allowed_tlvs[i]);
+    if (tlv && dlep_session_get_tlv_first_value(session, tlv)) {
+      found++;
+    }
+  }
+  return found;
+}
+
+int
+main(int argc, char **argv) {
+  uint64_t start, avl_time, table_time;
+  size_t count, i, avl_found, table_found;
+
+  count = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+
+  _init_parser();
+  _init_signal();
+
+  avl_found = 0;
+  start = _get_usec();
+  for (i = 0; i < count; i++) {
+    if (_parse_avl(&_session.parser, _signal, _signal_length)) {
+      fprintf(stderr, "AVL parser failed\n");
+      return 1;
+    }
+    avl_found += _lookup_avl(&_session.parser);
+  }
+  avl_time = _get_usec() - start;
+
+  table_found = 0;
+  start = _get_usec();
+  for (i = 0; i < count; i++) {
+    if (dlep_parser_parse_tlvstream(&_session.parser, LOG_MAIN, _signal, _signal_length)) {
+      fprintf(stderr, "Table parser failed\n");
+      return 1;
+    }
+    table_found += _lookup_table(&_session);
+  }
+  table_time = _get_usec() - start;
+
+  if (avl_found != table_found) {
+    fprintf(stderr, "Parsers found different TLVs: %" PRINTF_SIZE_T_SPECIFIER " != %" PRINTF_SIZE_T_SPECIFIER "\n",
+      avl_found, table_found);
+    return 1;
+  }
+
+  printf("%" PRINTF_SIZE_T_SPECIFIER " signals with %" PRINTF_SIZE_T_SPECIFIER " TLVs (%" PRINTF_SIZE_T_SPECIFIER
+         " bytes), %" PRINTF_SIZE_T_SPECIFIER " allowed TLVs\n",
+    count, ARRAYSIZE(_signal_tlvs), _signal_length, ARRAYSIZE(_allowed_tlvs));
+  printf("%14s %14s %8s\n", "avl [ns/sig]", "table [ns/sig]", "speedup");
+  printf("%14.1f %14.1f %7.2fx\n", 1000.0 * avl_time / count, 1000.0 * table_time / count,
+    (double)avl_time / (table_time ? table_time : 1));
+
+  for (i = 0; i < ARRAYSIZE(_tlvs); i++) {
+    dlep_parser_remove_tlv(&_session.parser, &_tlvs[i]);
+  }
+  dlep_parser_cleanup(&_session.parser);
+  return 0;
+}
@@ -0,0 +1,255 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Microbenchmark comparing the AVL based RFC7181 MPR selection with
+ * the dense bitset implementation. Each neighborhood has the given
+ * number of one-hop neighbors, twelve times as many two-hop neighbors
+ * and every two-hop neighbor is reachable through about six one-hop
+ * neighbors.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+#include <oonf/nhdp/mpr/neighbor-graph.h>
+#include <oonf/nhdp/mpr/selection-bitset.h>
+#include <oonf/nhdp/mpr/selection-rfc7181.h>
+
+/* number of two-hop neighbors per one-hop neighbor */
+#define N2_FACTOR 12
+
+/* average number of one-hop neighbors covering a two-hop neighbor */
+#define COVERAGE 6
+
+static struct nhdp_domain _domain;
+static struct nhdp_neighbor *_neighbors;
+static uint32_t *_d1_x;
+static uint32_t *_d2_x_y;
+static uint32_t _n1_count, _n2_count;
+
+static uint64_t
+_get_usec(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static uint32_t
+_get_n2_index(struct addr_node *y) {
+  const uint8_t *bin = netaddr_get_binptr(&y->addr);
+  return (bin[1] << 16) | (bin[2] << 8) | bin[3];
+}
+
+static uint32_t
+_calculate_d1_x_of_n2_addr(const struct nhdp_domain *d __attribute__((unused)),
+  struct neighbor_graph *graph __attribute__((unused)), struct addr_node *y __attribute__((unused))) {
+  return RFC7181_METRIC_INFINITE;
+}
+
+static uint32_t
+_calculate_d2_x_y(const struct nhdp_domain *d __attribute__((unused)), struct n1_node *x, struct addr_node *y) {
+  return _d2_x_y[(size_t)(x->neigh - _neighbors) * _n2_count + _get_n2_index(y)];
+}
+
+static uint32_t
+_calculate_d_x_y(const struct nhdp_domain *d, struct neighbor_graph *graph, struct n1_node *x, struct addr_node *y) {
+  uint32_t cost, *cache;
+
+  cache = &graph->d_x_y_cache[x->table_offset + y->table_offset];
+  if (*cache == 0) {
+    cost = _calculate_d2_x_y(d, x, y);
+    *cache = cost > RFC7181_METRIC_MAX ? RFC7181_METRIC_INFINITE_PATH : _d1_x[x->neigh - _neighbors] + cost;
+  }
+  return *cache;
+}
+
+static uint32_t
+_get_willingness_n1(const struct nhdp_domain *d __attribute__((unused)), struct n1_node *x __attribute__((unused))) {
+  return RFC7181_WILLINGNESS_DEFAULT;
+}
+
+static struct neighbor_graph_interface _methods = {
+  .calculate_d1_x_of_n2_addr = _calculate_d1_x_of_n2_addr,
+  .calculate_d_x_y = _calculate_d_x_y,
+  .calculate_d2_x_y = _calculate_d2_x_y,
+  .get_willingness_n1 = _get_willingness_n1,
+};
+
+static int
+_init_neighborhood(uint32_t n1_count) {
+  uint8_t bin[4];
+  uint32_t x, y, c;
+
+  _n1_count = n1_count;
+  _n2_count = n1_count * N2_FACTOR;
+
+  _neighbors = calloc(_n1_count, sizeof(*_neighbors));
+  _d1_x = calloc(_n1_count, sizeof(*_d1_x));
+  _d2_x_y = calloc((size_t)_n1_count * _n2_count, sizeof(*_d2_x_y));
+  if (!_neighbors || !_d1_x || !_d2_x_y) {
+    return -1;
+  }
+
+  for (x = 0; x < _n1_count; x++) {
+    bin[0] = 10;
+    bin[1] = 0;
+    bin[2] = x >> 8;
+    bin[3] = x & 255;
+    netaddr_from_binary(&_neighbors[x].originator, bin, 4, AF_INET);
+    _d1_x[x] = 1000 * (1 + rand() % 4);
+
+    for (y = 0; y < _n2_count; y++) {
+      _d2_x_y[(size_t)x * _n2_count + y] = RFC7181_METRIC_INFINITE;
+    }
+  }
+
+  for (y = 0; y < _n2_count; y++) {
+    for (c = 0; c < COVERAGE; c++) {
+      x = rand() % _n1_count;
+      _d2_x_y[(size_t)x * _n2_count + y] = 1000 * (1 + rand() % 4);
+    }
+  }
+  return 0;
+}
+
+static void
+_free_neighborhood(void) {
+  free(_neighbors);
+  free(_d1_x);
+  free(_d2_x_y);
+}
+
+static void
+_create_graph(struct neighbor_graph *graph) {
+  struct netaddr addr;
+  uint8_t bin[4];
+  uint32_t x, y;
+
+  memset(graph, 0, sizeof(*graph));
+  mpr_init_neighbor_graph(graph, &_methods);
+
+  for (x = 0; x < _n1_count; x++) {
+    /* reset temporary selection state */
+    _neighbors[x].selection_is_mpr = false;
+    mpr_add_n1_node_to_set(&graph->set_n1, &_neighbors[x], NULL, 0);
+  }
+  for (y = 0; y < _n2_count; y++) {
+    bin[0] = 11;
+    bin[1] = y >> 16;
+    bin[2] = y >> 8;
+    bin[3] = y & 255;
+    netaddr_from_binary(&addr, bin, 4, AF_INET);
+    mpr_add_addr_node_to_set(&graph->set_n2, addr, 0);
+  }
+}
+
+static uint64_t
+_run(bool bitset, size_t runs, uint32_t *mpr_count) {
+  struct neighbor_graph graph;
+  uint64_t start, total;
+  size_t i;
+
+  total = 0;
+  for (i = 0; i < runs; i++) {
+    _create_graph(&graph);
+
+    start = _get_usec();
+    if (!bitset || mpr_calculate_mpr_bitset(&_domain, &graph)) {
+      mpr_calculate_mpr_rfc7181(&_domain, &graph);
+    }
+    total += _get_usec() - start;
+
+    *mpr_count = graph.set_mpr.count;
+    mpr_clear_neighbor_graph(&graph);
+  }
+  return total / runs;
+}
+
+int
+main(int argc, char **argv) {
+  static const uint32_t default_counts[] = { 10, 40, 80 };
+  uint64_t avl_time, bitset_time;
+  uint32_t count, avl_mprs, bitset_mprs;
+  size_t runs;
+  int i, n;
+
+  n = argc > 1 ? argc - 1 : (int)ARRAYSIZE(default_counts);
+
+  srand(1);
+  printf("%6s %6s %6s %12s %15s %8s\n", "N1", "N2", "MPRs", "avl [usec]", "bitset [usec]", "speedup");
+  for (i = 0; i < n; i++) {
+    count = argc > 1 ? strtoul(argv[i + 1], NULL, 10) : default_counts[i];
+    if (count == 0) {
+      continue;
+    }
+
+    if (_init_neighborhood(count)) {
+      fprintf(stderr, "Could not allocate neighborhood with %u neighbors\n", count);
+      _free_neighborhood();
+      return 1;
+    }
+
+    runs = count > 40 ? 3 : 20;
+    avl_time = _run(false, runs, &avl_mprs);
+    bitset_time = _run(true, runs, &bitset_mprs);
+    _free_neighborhood();
+
+    if (avl_mprs != bitset_mprs) {
+      fprintf(stderr, "Result mismatch: avl selected %u MPRs, bitset %u\n", avl_mprs, bitset_mprs);
+      return 1;
+    }
+
+    printf("%6u %6u %6u %12" PRIu64 " %15" PRIu64 " %7.2fx\n", _n1_count, _n2_count, avl_mprs, avl_time, bitset_time,
+      bitset_time ? (double)avl_time / bitset_time : 0.0);
+  }
+  return 0;
+}
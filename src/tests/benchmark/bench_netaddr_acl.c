@@ -0,0 +1,170 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Microbenchmark comparing the linear ACL check with the compiled
+ * prefix trie. Each ACL contains the given number of random IPv4
+ * prefixes, half of them accepted and half rejected.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcommon/netaddr_acl.h>
+
+/* number of checked addresses per run */
+#define LOOKUPS 1000000
+
+/* number of distinct addresses checked */
+#define ADDRESSES 4096
+
+static struct netaddr _addresses[ADDRESSES];
+
+static uint64_t
+_get_usec(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static void
+_random_prefix(struct netaddr *prefix, uint8_t prefix_len) {
+  uint8_t bin[4];
+
+  bin[0] = 10;
+  bin[1] = rand() % 256;
+  bin[2] = rand() % 256;
+  bin[3] = rand() % 256;
+  netaddr_from_binary_prefix(prefix, bin, 4, AF_INET, prefix_len);
+}
+
+static int
+_init_acl(struct netaddr_acl *acl, size_t count) {
+  size_t i;
+
+  netaddr_acl_add(acl);
+  acl->accept = calloc(count, sizeof(struct netaddr));
+  acl->reject = calloc(count, sizeof(struct netaddr));
+  if (!acl->accept || !acl->reject) {
+    return -1;
+  }
+
+  for (i = 0; i < count; i++) {
+    if (i & 1) {
+      _random_prefix(&acl->reject[acl->reject_count++], 16 + rand() % 17);
+    }
+    else {
+      _random_prefix(&acl->accept[acl->accept_count++], 16 + rand() % 17);
+    }
+  }
+  return 0;
+}
+
+static uint64_t
+_run(const struct netaddr_acl *acl, size_t *accepted) {
+  uint64_t start;
+  size_t i;
+
+  *accepted = 0;
+  start = _get_usec();
+  for (i = 0; i < LOOKUPS; i++) {
+    if (netaddr_acl_check_accept(acl, &_addresses[i % ADDRESSES])) {
+      (*accepted)++;
+    }
+  }
+  return _get_usec() - start;
+}
+
+int
+main(int argc, char **argv) {
+  static const size_t default_counts[] = { 10, 100, 1000 };
+  struct netaddr_acl acl;
+  uint64_t linear_time, compiled_time;
+  size_t count, linear_accepted, compiled_accepted;
+  int i, n;
+
+  n = argc > 1 ? argc - 1 : (int)ARRAYSIZE(default_counts);
+
+  srand(1);
+  for (i = 0; i < ADDRESSES; i++) {
+    _random_prefix(&_addresses[i], 32);
+  }
+
+  printf("%10s %15s %17s %8s\n", "prefixes", "linear [ns/op]", "compiled [ns/op]", "speedup");
+  for (i = 0; i < n; i++) {
+    count = argc > 1 ? strtoul(argv[i + 1], NULL, 10) : default_counts[i];
+    if (count == 0) {
+      continue;
+    }
+
+    if (_init_acl(&acl, count)) {
+      fprintf(stderr, "Could not allocate ACL with %" PRINTF_SIZE_T_SPECIFIER " prefixes\n", count);
+      netaddr_acl_remove(&acl);
+      return 1;
+    }
+
+    linear_time = _run(&acl, &linear_accepted);
+    if (netaddr_acl_compile(&acl)) {
+      fprintf(stderr, "Could not compile ACL with %" PRINTF_SIZE_T_SPECIFIER " prefixes\n", count);
+      netaddr_acl_remove(&acl);
+      return 1;
+    }
+    compiled_time = _run(&acl, &compiled_accepted);
+    netaddr_acl_remove(&acl);
+
+    if (linear_accepted != compiled_accepted) {
+      fprintf(stderr, "Result mismatch: linear accepted %" PRINTF_SIZE_T_SPECIFIER ", compiled %" PRINTF_SIZE_T_SPECIFIER
+        "\n", linear_accepted, compiled_accepted);
+      return 1;
+    }
+
+    printf("%10" PRINTF_SIZE_T_SPECIFIER " %15.1f %17.1f %7.2fx\n", count, 1000.0 * linear_time / LOOKUPS,
+      1000.0 * compiled_time / LOOKUPS, (double)linear_time / compiled_time);
+  }
+  return 0;
+}
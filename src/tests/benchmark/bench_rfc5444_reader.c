@@ -0,0 +1,303 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Parse throughput of the RFC5444 reader. The benchmark feeds the
+ * interop2010 test packets and a synthetic TC-like packet with many
+ * address TLVs into a reader with packet, message and address
+ * consumers and reports packets per second, TLVs per packet and
+ * the allocations of the reader arena per packet.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/avl_comp.h>
+#include <oonf/librfc5444/rfc5444_reader.h>
+#include <oonf/tests/rfc5444/interop2010/test_rfc5444_interop.h>
+
+/* number of addresses in synthetic packet */
+#define SYNTHETIC_ADDRESSES 64
+
+/* default number of rounds over all packets */
+#define DEFAULT_ROUNDS 20000
+
+static enum rfc5444_result _cb_tlv(struct rfc5444_reader_tlvblock_entry *, struct rfc5444_reader_tlvblock_context *);
+static enum rfc5444_result _cb_block(struct rfc5444_reader_tlvblock_context *);
+
+static struct rfc5444_reader_tlvblock_consumer _packet_consumer = {
+  .tlv_callback = _cb_tlv,
+};
+
+static struct rfc5444_reader_tlvblock_consumer _msg_consumer = {
+  .default_msg_consumer = true,
+  .tlv_callback = _cb_tlv,
+};
+
+static struct rfc5444_reader_tlvblock_consumer _addr_consumer = {
+  .default_msg_consumer = true,
+  .addrblock_consumer = true,
+  .tlv_callback = _cb_tlv,
+};
+
+static struct rfc5444_reader_tlvblock_consumer_entry _tc_msg_entries[] = {
+  { .type = 1 },
+  { .type = 2 },
+};
+
+static struct rfc5444_reader_tlvblock_consumer _tc_msg_consumer = {
+  .order = 1,
+  .msg_id = 1,
+  .block_callback = _cb_block,
+};
+
+static struct rfc5444_reader_tlvblock_consumer_entry _tc_addr_entries[] = {
+  { .type = 4 },
+  { .type = 7, .mandatory = true, .min_length = 2, .match_length = true },
+};
+
+static struct rfc5444_reader_tlvblock_consumer _tc_addr_consumer = {
+  .order = 1,
+  .msg_id = 1,
+  .addrblock_consumer = true,
+  .block_callback = _cb_block,
+};
+
+static struct avl_tree _packet_tree;
+static struct rfc5444_reader _reader;
+
+static uint8_t _synthetic[1024];
+static struct test_packet _synthetic_packet = {
+  .test = "synthetic-tc",
+  .binary = _synthetic,
+};
+
+static uint64_t _tlv_count;
+static uint64_t _block_count;
+
+static uint64_t
+_get_usec(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static enum rfc5444_result
+_cb_tlv(struct rfc5444_reader_tlvblock_entry *tlv __attribute__((unused)),
+  struct rfc5444_reader_tlvblock_context *context __attribute__((unused))) {
+  _tlv_count++;
+  return RFC5444_OKAY;
+}
+
+static enum rfc5444_result
+_cb_block(struct rfc5444_reader_tlvblock_context *context __attribute__((unused))) {
+  _block_count++;
+  return RFC5444_OKAY;
+}
+
+/**
+ * Collect the interop2010 test packets
+ * @param p test packet
+ */
+void
+add_test(struct test_packet *p) {
+  if (_packet_tree.comp == NULL) {
+    avl_init(&_packet_tree, avl_comp_strcasecmp, false);
+  }
+
+  p->_node.key = p->test;
+  avl_insert(&_packet_tree, &p->_node);
+}
+
+static void
+_put_u16(uint8_t *ptr, size_t value) {
+  ptr[0] = (uint8_t)(value >> 8);
+  ptr[1] = (uint8_t)(value & 255);
+}
+
+/**
+ * Create a TC-like packet with one message, two message TLVs and
+ * one address block with a link metric TLV for every address and
+ * a multivalue TLV covering all addresses.
+ */
+static void
+_create_synthetic_packet(void) {
+  uint8_t *ptr, *msg, *tlvblock;
+  int i;
+
+  ptr = _synthetic;
+
+  /* packet header, version 0 without flags */
+  *ptr++ = 0;
+
+  /* message header with 4 byte addresses and message size */
+  msg = ptr;
+  *ptr++ = 1;
+  *ptr++ = 3;
+  ptr += 2;
+
+  /* message TLV block */
+  _put_u16(ptr, 8);
+  ptr += 2;
+  for (i = 1; i <= 2; i++) {
+    *ptr++ = i;
+    *ptr++ = RFC5444_TLV_FLAG_VALUE;
+    *ptr++ = 1;
+    *ptr++ = i;
+  }
+
+  /* address block with common 3 byte head */
+  *ptr++ = SYNTHETIC_ADDRESSES;
+  *ptr++ = RFC5444_ADDR_FLAG_HEAD;
+  *ptr++ = 3;
+  *ptr++ = 10;
+  *ptr++ = 0;
+  *ptr++ = 0;
+  for (i = 0; i < SYNTHETIC_ADDRESSES; i++) {
+    *ptr++ = i + 1;
+  }
+
+  /* address TLV block */
+  tlvblock = ptr;
+  ptr += 2;
+  for (i = 0; i < SYNTHETIC_ADDRESSES; i++) {
+    *ptr++ = 7;
+    *ptr++ = RFC5444_TLV_FLAG_SINGLE_IDX | RFC5444_TLV_FLAG_VALUE;
+    *ptr++ = i;
+    *ptr++ = 2;
+    *ptr++ = 0x10;
+    *ptr++ = i;
+  }
+  *ptr++ = 4;
+  *ptr++ = RFC5444_TLV_FLAG_VALUE | RFC5444_TLV_FLAG_MULTIVALUE;
+  *ptr++ = SYNTHETIC_ADDRESSES;
+  for (i = 0; i < SYNTHETIC_ADDRESSES; i++) {
+    *ptr++ = i & 3;
+  }
+  _put_u16(tlvblock, ptr - tlvblock - 2);
+
+  _put_u16(msg + 2, ptr - msg);
+  _synthetic_packet.binlen = ptr - _synthetic;
+}
+
+/**
+ * Parse a set of packets several times and print the results
+ * @param name name of packet set
+ * @param packets array of packets
+ * @param count number of packets
+ * @param rounds number of rounds over the packets
+ */
+static void
+_run(const char *name, struct test_packet **packets, size_t count, size_t rounds) {
+  uint64_t start, duration, allocations, chunks, total;
+  size_t r, i;
+
+  /* warm up the arena, a second round uses the merged chunk */
+  for (r = 0; r < 2; r++) {
+    for (i = 0; i < count; i++) {
+      rfc5444_reader_handle_packet(&_reader, packets[i]->binary, packets[i]->binlen);
+    }
+  }
+
+  _tlv_count = 0;
+  allocations = _reader.arena.allocations;
+  chunks = _reader.arena.chunk_allocations;
+
+  start = _get_usec();
+  for (r = 0; r < rounds; r++) {
+    for (i = 0; i < count; i++) {
+      rfc5444_reader_handle_packet(&_reader, packets[i]->binary, packets[i]->binlen);
+    }
+  }
+  duration = _get_usec() - start;
+
+  total = (uint64_t)rounds * count;
+  printf("%-14s %8" PRINTF_SIZE_T_SPECIFIER " %12.0f %10.1f %14.2f %14.4f\n", name, count,
+    duration ? (double)total * 1000000.0 / duration : 0.0, (double)_tlv_count / total,
+    (double)(_reader.arena.allocations - allocations) / total,
+    (double)(_reader.arena.chunk_allocations - chunks) / total);
+}
+
+int
+main(int argc, char **argv) {
+  struct test_packet **packets, *packet;
+  struct test_packet *synthetic[1];
+  size_t rounds, count;
+
+  rounds = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_ROUNDS;
+
+  _create_synthetic_packet();
+
+  rfc5444_reader_init(&_reader);
+  rfc5444_reader_add_packet_consumer(&_reader, &_packet_consumer, NULL, 0);
+  rfc5444_reader_add_message_consumer(&_reader, &_msg_consumer, NULL, 0);
+  rfc5444_reader_add_message_consumer(&_reader, &_addr_consumer, NULL, 0);
+  rfc5444_reader_add_message_consumer(&_reader, &_tc_msg_consumer, _tc_msg_entries, ARRAYSIZE(_tc_msg_entries));
+  rfc5444_reader_add_message_consumer(&_reader, &_tc_addr_consumer, _tc_addr_entries, ARRAYSIZE(_tc_addr_entries));
+
+  packets = calloc(_packet_tree.count, sizeof(*packets));
+  if (!packets) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  count = 0;
+  avl_for_each_element(&_packet_tree, packet, _node) {
+    packets[count++] = packet;
+  }
+  synthetic[0] = &_synthetic_packet;
+
+  printf("%-14s %8s %12s %10s %14s %14s\n", "packets", "count", "[packets/s]", "tlvs/pkt", "arena allocs/pkt",
+    "mallocs/pkt");
+  _run("interop2010", packets, count, rounds);
+  _run(_synthetic_packet.test, synthetic, 1, rounds);
+
+  rfc5444_reader_cleanup(&_reader);
+  free(packets);
+  return 0;
+}
@@ -0,0 +1,229 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ *
+ * Microbenchmark comparing the hierarchical timing wheel with the AVL
+ * tree previously used by the timer scheduler. The workload is modeled
+ * after the scheduler: many validity timers which are restarted long
+ * before they fire, plus a smaller share of timers firing each tick.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/timing_wheel.h>
+
+struct bench_timer {
+  uint64_t clock;
+  uint64_t period;
+  struct avl_node avl;
+  struct timing_wheel_node wheel;
+};
+
+/* number of simulated scheduler ticks (timeslices) */
+#define TICKS 600
+
+/* percentage of timers restarted in each tick */
+#define RESTART_PCT 5
+
+static struct bench_timer *_timers;
+static struct avl_tree _tree;
+static struct timing_wheel _wheel;
+
+static int
+_avlcomp_clock(const void *p1, const void *p2) {
+  const struct bench_timer *t1 = p1, *t2 = p2;
+
+  if (t1->clock > t2->clock) {
+    return 1;
+  }
+  if (t1->clock < t2->clock) {
+    return -1;
+  }
+  return 0;
+}
+
+static uint64_t
+_get_usec(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static void
+_init_timers(size_t count) {
+  size_t i;
+
+  srand(1);
+  for (i = 0; i < count; i++) {
+    memset(&_timers[i], 0, sizeof(_timers[i]));
+    /* validity times between 1 and 300 seconds (10 ticks per second) */
+    _timers[i].period = 10 + rand() % 3000;
+  }
+}
+
+static uint64_t
+_run_avl(size_t count, uint64_t *ops) {
+  struct bench_timer *t;
+  uint64_t start, now;
+  size_t i, j;
+
+  _init_timers(count);
+  avl_init(&_tree, _avlcomp_clock, true);
+
+  start = _get_usec();
+  for (i = 0; i < count; i++) {
+    _timers[i].clock = _timers[i].period;
+    _timers[i].avl.key = &_timers[i];
+    avl_insert(&_tree, &_timers[i].avl);
+  }
+  *ops = count;
+
+  for (now = 1; now <= TICKS; now++) {
+    for (j = 0; j < count * RESTART_PCT / 100; j++) {
+      t = &_timers[rand() % count];
+      avl_remove(&_tree, &t->avl);
+      t->clock = now + t->period;
+      avl_insert(&_tree, &t->avl);
+      (*ops)++;
+    }
+
+    while (!avl_is_empty(&_tree)) {
+      t = avl_first_element(&_tree, t, avl);
+      if (t->clock > now) {
+        break;
+      }
+      avl_remove(&_tree, &t->avl);
+      t->clock = now + t->period;
+      avl_insert(&_tree, &t->avl);
+      (*ops)++;
+    }
+  }
+  return _get_usec() - start;
+}
+
+static uint64_t
+_run_wheel(size_t count, uint64_t *ops) {
+  struct bench_timer *t;
+  uint64_t start, now;
+  size_t i, j;
+
+  _init_timers(count);
+  timing_wheel_init(&_wheel, 0);
+
+  start = _get_usec();
+  for (i = 0; i < count; i++) {
+    _timers[i].wheel.key = _timers[i].period;
+    timing_wheel_insert(&_wheel, &_timers[i].wheel);
+  }
+  *ops = count;
+
+  for (now = 1; now <= TICKS; now++) {
+    for (j = 0; j < count * RESTART_PCT / 100; j++) {
+      t = &_timers[rand() % count];
+      timing_wheel_remove(&_wheel, &t->wheel);
+      t->wheel.key = now + t->period;
+      timing_wheel_insert(&_wheel, &t->wheel);
+      (*ops)++;
+    }
+
+    timing_wheel_advance(&_wheel, now);
+    while (timing_wheel_has_expired(&_wheel)) {
+      t = timing_wheel_first_expired(&_wheel, t, wheel);
+      timing_wheel_remove(&_wheel, &t->wheel);
+      t->wheel.key = now + t->period;
+      timing_wheel_insert(&_wheel, &t->wheel);
+      (*ops)++;
+    }
+
+    /* the scheduler asks for the next event after each walk */
+    timing_wheel_get_next(&_wheel);
+  }
+  return _get_usec() - start;
+}
+
+int
+main(int argc, char **argv) {
+  static const size_t default_counts[] = { 10000, 100000, 1000000 };
+  uint64_t avl_ops, avl_time, wheel_ops, wheel_time;
+  size_t count, max_count;
+  int i, n;
+
+  n = argc > 1 ? argc - 1 : (int)ARRAYSIZE(default_counts);
+
+  max_count = 0;
+  for (i = 0; i < n; i++) {
+    count = argc > 1 ? strtoul(argv[i + 1], NULL, 10) : default_counts[i];
+    if (count > max_count) {
+      max_count = count;
+    }
+  }
+
+  _timers = calloc(max_count, sizeof(*_timers));
+  if (!_timers) {
+    fprintf(stderr, "Could not allocate %" PRINTF_SIZE_T_SPECIFIER " timers\n", max_count);
+    return 1;
+  }
+
+  printf("%10s %14s %14s %8s\n", "timers", "avl [ns/op]", "wheel [ns/op]", "speedup");
+  for (i = 0; i < n; i++) {
+    count = argc > 1 ? strtoul(argv[i + 1], NULL, 10) : default_counts[i];
+    if (count == 0) {
+      continue;
+    }
+
+    avl_time = _run_avl(count, &avl_ops);
+    wheel_time = _run_wheel(count, &wheel_ops);
+
+    printf("%10" PRINTF_SIZE_T_SPECIFIER " %14.1f %14.1f %7.2fx\n", count, 1000.0 * avl_time / avl_ops,
+      1000.0 * wheel_time / wheel_ops, (double)avl_time / wheel_time * wheel_ops / avl_ops);
+  }
+
+  free(_timers);
+  return 0;
+}
@@ -0,0 +1,285 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <oonf/libcommon/heap.h>
+#include <oonf/cunit/cunit.h>
+
+struct heap_element {
+  int id;
+  struct heap_node node;
+};
+
+#define COUNT 1000
+
+static struct heap heap;
+static struct heap_element elements[COUNT];
+
+static void clear_elements(void) {
+  int i;
+
+  heap_free(&heap);
+  memset(elements, 0, sizeof(elements));
+  for (i=0; i<COUNT; i++) {
+    elements[i].id = i;
+  }
+}
+
+/* check heap order and index consistency of the whole array */
+static void check_heap(void) {
+  uint32_t i;
+
+  for (i=0; i<heap.count; i++) {
+    CHECK_TRUE(heap._nodes[i]->_index == i + 1, "node %u has index %u", i, heap._nodes[i]->_index);
+    if (i > 0) {
+      CHECK_TRUE(heap._nodes[(i - 1) / 2]->key <= heap._nodes[i]->key,
+          "parent key %" PRIu64 " larger than child key %" PRIu64,
+          heap._nodes[(i - 1) / 2]->key, heap._nodes[i]->key);
+      CHECK_TRUE(heap._nodes[(i - 1) / 2]->key < heap._nodes[i]->key
+          || heap._nodes[(i - 1) / 2]->_seq < heap._nodes[i]->_seq,
+          "parent with equal key %" PRIu64 " inserted after child", heap._nodes[i]->key);
+    }
+  }
+}
+
+static void test_insert_extract(void) {
+  struct heap_element *e;
+  uint64_t last = 0;
+  int i;
+
+  START_TEST();
+
+  for (i=0; i<COUNT; i++) {
+    elements[i].node.key = (i * 7919) % COUNT;
+    CHECK_TRUE(heap_insert(&heap, &elements[i].node) == 0, "insert of node %d failed", i);
+  }
+  CHECK_TRUE(heap.count == COUNT, "heap count is %u", heap.count);
+  check_heap();
+
+  for (i=0; i<COUNT; i++) {
+    e = heap_extract_min_element(&heap, e, node);
+    CHECK_TRUE(e->node.key >= last, "key %" PRIu64 " extracted after %" PRIu64, e->node.key, last);
+    CHECK_TRUE(!heap_is_node_added(&e->node), "extracted node still added");
+    last = e->node.key;
+  }
+  CHECK_TRUE(heap_is_empty(&heap), "heap not empty");
+  CHECK_TRUE(heap_extract_min(&heap) == NULL, "empty heap returned a node");
+
+  END_TEST();
+}
+
+static void test_decrease_key(void) {
+  struct heap_element *e;
+
+  START_TEST();
+
+  elements[0].node.key = 10;
+  heap_insert(&heap, &elements[0].node);
+  elements[1].node.key = 20;
+  heap_insert(&heap, &elements[1].node);
+  elements[2].node.key = 30;
+  heap_insert(&heap, &elements[2].node);
+
+  heap_decrease_key(&heap, &elements[2].node, 5);
+  check_heap();
+
+  e = heap_first_element(&heap, e, node);
+  CHECK_TRUE(e->id == 2, "first element is %d", e->id);
+
+  heap_set_key(&heap, &elements[2].node, 25);
+  check_heap();
+
+  e = heap_extract_min_element(&heap, e, node);
+  CHECK_TRUE(e->id == 0, "first element is %d", e->id);
+  e = heap_extract_min_element(&heap, e, node);
+  CHECK_TRUE(e->id == 1, "second element is %d", e->id);
+  e = heap_extract_min_element(&heap, e, node);
+  CHECK_TRUE(e->id == 2, "third element is %d", e->id);
+
+  END_TEST();
+}
+
+static void test_equal_keys(void) {
+  static const int order[] = { 1, 2, 0, 3 };
+  struct heap_element *e;
+  int i, last;
+
+  START_TEST();
+
+  /* nodes with equal keys leave the heap in insertion order */
+  for (i=0; i<100; i++) {
+    elements[i].node.key = i % 2 == 0 ? 5 : 100 + i;
+    heap_insert(&heap, &elements[i].node);
+  }
+  heap_remove(&heap, &elements[10].node);
+  heap_remove(&heap, &elements[50].node);
+  check_heap();
+
+  last = -1;
+  while (!heap_is_empty(&heap) && heap_first(&heap)->key == 5) {
+    e = heap_extract_min_element(&heap, e, node);
+    CHECK_TRUE(e->id > last, "element %d extracted after %d", e->id, last);
+    last = e->id;
+  }
+  CHECK_TRUE(last == 98, "last element with equal key is %d", last);
+  heap_free(&heap);
+
+  /* a node that got a new key is queued behind nodes that already had it */
+  elements[0].node.key = 10;
+  heap_insert(&heap, &elements[0].node);
+  elements[1].node.key = 5;
+  heap_insert(&heap, &elements[1].node);
+  elements[2].node.key = 5;
+  heap_insert(&heap, &elements[2].node);
+  elements[3].node.key = 1;
+  heap_insert(&heap, &elements[3].node);
+
+  heap_decrease_key(&heap, &elements[0].node, 5);
+  heap_set_key(&heap, &elements[3].node, 5);
+
+  /* an unchanged key keeps the position */
+  heap_set_key(&heap, &elements[1].node, 5);
+  heap_decrease_key(&heap, &elements[2].node, 5);
+  check_heap();
+
+  for (i=0; i<4; i++) {
+    e = heap_extract_min_element(&heap, e, node);
+    CHECK_TRUE(e->id == order[i], "element %d extracted at position %d", e->id, i);
+  }
+
+  END_TEST();
+}
+
+static void test_remove(void) {
+  int i;
+
+  START_TEST();
+
+  for (i=0; i<10; i++) {
+    elements[i].node.key = 100 - i;
+    heap_insert(&heap, &elements[i].node);
+  }
+
+  heap_remove(&heap, &elements[9].node);
+  CHECK_TRUE(!heap_is_node_added(&elements[9].node), "node still added");
+  CHECK_TRUE(heap.count == 9, "heap count is %u", heap.count);
+  check_heap();
+
+  heap_remove(&heap, &elements[3].node);
+  heap_remove(&heap, &elements[3].node);
+  CHECK_TRUE(heap.count == 8, "heap count is %u after double remove", heap.count);
+  check_heap();
+
+  heap_free(&heap);
+  CHECK_TRUE(heap_is_empty(&heap), "heap not empty");
+  CHECK_TRUE(!heap_is_node_added(&elements[0].node), "node still added after free");
+
+  END_TEST();
+}
+
+static void test_random(void) {
+  struct heap_element *e;
+  uint64_t last;
+  int i, step;
+
+  START_TEST();
+
+  srand(42);
+  for (step=0; step<100; step++) {
+    for (i=0; i<COUNT; i++) {
+      switch (rand() % 8) {
+        case 0:
+          heap_remove(&heap, &elements[i].node);
+          break;
+        case 1:
+        case 2:
+          if (heap_is_node_added(&elements[i].node)) {
+            heap_set_key(&heap, &elements[i].node, rand() % 10000);
+          }
+          else {
+            elements[i].node.key = rand() % 10000;
+            heap_insert(&heap, &elements[i].node);
+          }
+          break;
+        case 3:
+          if (heap_is_node_added(&elements[i].node) && elements[i].node.key > 0) {
+            heap_decrease_key(&heap, &elements[i].node, rand() % elements[i].node.key);
+          }
+          break;
+        default:
+          break;
+      }
+    }
+    check_heap();
+
+    /* extract a few nodes in order */
+    last = 0;
+    for (i=0; i<10 && !heap_is_empty(&heap); i++) {
+      e = heap_extract_min_element(&heap, e, node);
+      CHECK_TRUE(e->node.key >= last, "key %" PRIu64 " extracted after %" PRIu64, e->node.key, last);
+      last = e->node.key;
+    }
+  }
+
+  END_TEST();
+}
+
+int main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  heap_init(&heap);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_insert_extract();
+  test_decrease_key();
+  test_equal_keys();
+  test_remove();
+  test_random();
+
+  heap_free(&heap);
+  return FINISH_TESTING();
+}
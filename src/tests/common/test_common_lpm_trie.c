@@ -0,0 +1,259 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <oonf/libcommon/lpm_trie.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/cunit/cunit.h>
+
+struct trie_element {
+  int id;
+  struct netaddr prefix;
+  struct lpm_trie_node node;
+};
+
+#define COUNT 500
+
+static struct lpm_trie trie;
+static struct trie_element elements[COUNT];
+
+static void clear_elements(void) {
+  int i;
+
+  lpm_trie_free(&trie);
+  memset(elements, 0, sizeof(elements));
+  for (i=0; i<COUNT; i++) {
+    elements[i].id = i;
+    elements[i].node.key = &elements[i].prefix;
+  }
+}
+
+static void set_prefix(struct trie_element *e, const char *prefix) {
+  if (netaddr_from_string(&e->prefix, prefix)) {
+    CHECK_TRUE(false, "could not parse prefix %s", prefix);
+  }
+}
+
+static struct trie_element *find_best(const char *addr) {
+  struct trie_element *e;
+  struct netaddr a;
+
+  if (netaddr_from_string(&a, addr)) {
+    return NULL;
+  }
+  return lpm_trie_find_best_element(&trie, &a, e, node);
+}
+
+/* linear scan for the longest matching prefix, used as reference */
+static struct trie_element *find_best_linear(const struct netaddr *addr, int count) {
+  struct trie_element *best = NULL;
+  int i;
+
+  for (i=0; i<count; i++) {
+    if (!lpm_trie_is_node_added(&elements[i].node)) {
+      continue;
+    }
+    if (!netaddr_is_in_subnet(&elements[i].prefix, addr)) {
+      continue;
+    }
+    if (best == NULL
+        || netaddr_get_prefix_length(&best->prefix) < netaddr_get_prefix_length(&elements[i].prefix)) {
+      best = &elements[i];
+    }
+  }
+  return best;
+}
+
+static void test_longest_match(void) {
+  struct trie_element *e;
+
+  START_TEST();
+
+  set_prefix(&elements[0], "10.0.0.0/8");
+  set_prefix(&elements[1], "10.1.0.0/16");
+  set_prefix(&elements[2], "10.1.2.3");
+  set_prefix(&elements[3], "fd00::/64");
+  set_prefix(&elements[4], "0.0.0.0/0");
+
+  CHECK_TRUE(lpm_trie_insert(&trie, &elements[0].node) == 0, "insert failed");
+  CHECK_TRUE(lpm_trie_insert(&trie, &elements[1].node) == 0, "insert failed");
+  CHECK_TRUE(lpm_trie_insert(&trie, &elements[2].node) == 0, "insert failed");
+  CHECK_TRUE(lpm_trie_insert(&trie, &elements[3].node) == 0, "insert failed");
+  CHECK_TRUE(trie.count == 4, "trie count is %u", trie.count);
+
+  e = find_best("10.1.2.3");
+  CHECK_TRUE(e != NULL && e->id == 2, "10.1.2.3 matched %d", e ? e->id : -1);
+  e = find_best("10.1.2.4");
+  CHECK_TRUE(e != NULL && e->id == 1, "10.1.2.4 matched %d", e ? e->id : -1);
+  e = find_best("10.2.0.1");
+  CHECK_TRUE(e != NULL && e->id == 0, "10.2.0.1 matched %d", e ? e->id : -1);
+  e = find_best("11.0.0.1");
+  CHECK_TRUE(e == NULL, "11.0.0.1 matched %d", e ? e->id : -1);
+  e = find_best("fd00::1");
+  CHECK_TRUE(e != NULL && e->id == 3, "fd00::1 matched %d", e ? e->id : -1);
+  e = find_best("fd00:0:0:1::1");
+  CHECK_TRUE(e == NULL, "fd00:0:0:1::1 matched %d", e ? e->id : -1);
+
+  /* prefixes only match if they contain the whole lookup prefix */
+  e = find_best("10.1.0.0/15");
+  CHECK_TRUE(e != NULL && e->id == 0, "10.1.0.0/15 matched %d", e ? e->id : -1);
+
+  CHECK_TRUE(lpm_trie_insert(&trie, &elements[4].node) == 0, "insert failed");
+  e = find_best("11.0.0.1");
+  CHECK_TRUE(e != NULL && e->id == 4, "11.0.0.1 matched %d", e ? e->id : -1);
+
+  END_TEST();
+}
+
+static void test_exact_and_duplicates(void) {
+  struct trie_element *e;
+
+  START_TEST();
+
+  set_prefix(&elements[0], "192.168.0.0/16");
+  set_prefix(&elements[1], "192.168.0.0/16");
+  set_prefix(&elements[2], "192.168.0.0/24");
+
+  lpm_trie_insert(&trie, &elements[0].node);
+  lpm_trie_insert(&trie, &elements[1].node);
+  lpm_trie_insert(&trie, &elements[2].node);
+  CHECK_TRUE(trie.count == 3, "trie count is %u", trie.count);
+
+  e = lpm_trie_find_element(&trie, &elements[0].prefix, e, node);
+  CHECK_TRUE(e != NULL && e->id == 0, "exact lookup returned %d", e ? e->id : -1);
+
+  lpm_trie_remove(&trie, &elements[0].node);
+  CHECK_TRUE(!lpm_trie_is_node_added(&elements[0].node), "node still added");
+  e = lpm_trie_find_element(&trie, &elements[0].prefix, e, node);
+  CHECK_TRUE(e != NULL && e->id == 1, "exact lookup after remove returned %d", e ? e->id : -1);
+
+  lpm_trie_remove(&trie, &elements[1].node);
+  lpm_trie_remove(&trie, &elements[1].node);
+  CHECK_TRUE(trie.count == 1, "trie count is %u after double remove", trie.count);
+  e = lpm_trie_find_element(&trie, &elements[0].prefix, e, node);
+  CHECK_TRUE(e == NULL, "exact lookup of removed prefix returned %d", e ? e->id : -1);
+
+  e = find_best("192.168.0.1");
+  CHECK_TRUE(e != NULL && e->id == 2, "192.168.0.1 matched %d", e ? e->id : -1);
+  e = find_best("192.168.1.1");
+  CHECK_TRUE(e == NULL, "192.168.1.1 matched %d", e ? e->id : -1);
+
+  lpm_trie_free(&trie);
+  CHECK_TRUE(lpm_trie_is_empty(&trie), "trie not empty");
+  CHECK_TRUE(!lpm_trie_is_node_added(&elements[2].node), "node still added after free");
+
+  END_TEST();
+}
+
+static void test_random(void) {
+  struct trie_element *e, *ref;
+  struct netaddr addr;
+  uint8_t bin[4];
+  int i, step;
+
+  START_TEST();
+
+  srand(42);
+  for (step=0; step<50; step++) {
+    for (i=0; i<COUNT; i++) {
+      switch (rand() % 4) {
+        case 0:
+          lpm_trie_remove(&trie, &elements[i].node);
+          break;
+        case 1:
+          if (!lpm_trie_is_node_added(&elements[i].node)) {
+            /* use a small address space to get lots of nested prefixes */
+            bin[0] = 10;
+            bin[1] = rand() % 4;
+            bin[2] = rand() % 256;
+            bin[3] = rand() % 256;
+            netaddr_from_binary_prefix(&elements[i].prefix, bin, 4, AF_INET, 8 + rand() % 25);
+            CHECK_TRUE(lpm_trie_insert(&trie, &elements[i].node) == 0, "insert of node %d failed", i);
+          }
+          break;
+        default:
+          break;
+      }
+    }
+
+    for (i=0; i<200; i++) {
+      bin[0] = 10;
+      bin[1] = rand() % 4;
+      bin[2] = rand() % 256;
+      bin[3] = rand() % 256;
+      netaddr_from_binary(&addr, bin, 4, AF_INET);
+
+      e = lpm_trie_find_best_element(&trie, &addr, e, node);
+      ref = find_best_linear(&addr, COUNT);
+      if (ref == NULL) {
+        CHECK_TRUE(e == NULL, "trie found a prefix, linear search did not");
+      }
+      else {
+        CHECK_TRUE(e != NULL
+            && netaddr_get_prefix_length(&e->prefix) == netaddr_get_prefix_length(&ref->prefix),
+            "trie found prefix length %d, linear search %d",
+            e ? netaddr_get_prefix_length(&e->prefix) : -1, netaddr_get_prefix_length(&ref->prefix));
+      }
+    }
+  }
+
+  END_TEST();
+}
+
+int main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  lpm_trie_init(&trie);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_longest_match();
+  test_exact_and_duplicates();
+  test_random();
+
+  lpm_trie_free(&trie);
+  return FINISH_TESTING();
+}
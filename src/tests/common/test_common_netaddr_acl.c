@@ -0,0 +1,245 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcommon/netaddr_acl.h>
+#include <oonf/libcommon/string.h>
+#include <oonf/cunit/cunit.h>
+
+/* initialize a const_strarray with a zero-byte separated string constant */
+#define ACL_VALUE(str) { str, sizeof(str) }
+
+static struct netaddr_acl acl, acl_source;
+
+static void clear_elements(void) {
+  netaddr_acl_remove(&acl);
+  netaddr_acl_remove(&acl_source);
+}
+
+static bool check(const char *str) {
+  struct netaddr addr;
+
+  if (netaddr_from_string(&addr, str)) {
+    CHECK_TRUE(false, "could not parse address %s", str);
+    return false;
+  }
+  return netaddr_acl_check_accept(&acl, &addr);
+}
+
+static void test_first_accept(void) {
+  static const char value[] = "10.0.0.0/8\0-10.1.0.0/16\0-192.168.0.0/16\0" "192.168.1.1\0" ACL_FIRST_ACCEPT;
+  struct const_strarray array = ACL_VALUE(value);
+
+  START_TEST();
+
+  CHECK_TRUE(netaddr_acl_from_strarray(&acl, &array) == 0, "could not parse ACL");
+  CHECK_TRUE(netaddr_acl_compile(&acl) == 0, "could not compile ACL");
+
+  CHECK_TRUE(check("10.0.0.1"), "10.0.0.1 rejected");
+  CHECK_TRUE(check("10.1.0.1"), "10.1.0.1 rejected");
+  CHECK_TRUE(check("192.168.1.1"), "192.168.1.1 rejected");
+  CHECK_TRUE(!check("192.168.1.2"), "192.168.1.2 accepted");
+  CHECK_TRUE(!check("11.0.0.1"), "11.0.0.1 accepted");
+  CHECK_TRUE(!check("fd00::1"), "fd00::1 accepted");
+
+  END_TEST();
+}
+
+static void test_first_reject(void) {
+  static const char value[] = "10.0.0.0/8\0-10.1.0.0/16\0-192.168.0.0/16\0" "192.168.1.1\0"
+    ACL_FIRST_REJECT "\0" ACL_DEFAULT_ACCEPT;
+  struct const_strarray array = ACL_VALUE(value);
+
+  START_TEST();
+
+  CHECK_TRUE(netaddr_acl_from_strarray(&acl, &array) == 0, "could not parse ACL");
+  CHECK_TRUE(netaddr_acl_compile(&acl) == 0, "could not compile ACL");
+
+  CHECK_TRUE(check("10.0.0.1"), "10.0.0.1 rejected");
+  CHECK_TRUE(!check("10.1.0.1"), "10.1.0.1 accepted");
+  CHECK_TRUE(!check("192.168.1.1"), "192.168.1.1 accepted");
+  CHECK_TRUE(check("11.0.0.1"), "11.0.0.1 rejected");
+  CHECK_TRUE(check("fd00::1"), "fd00::1 rejected");
+
+  /* keywords changed after compilation are used for the next check */
+  netaddr_acl_handle_keywords(&acl, ACL_FIRST_ACCEPT);
+  netaddr_acl_handle_keywords(&acl, ACL_DEFAULT_REJECT);
+  CHECK_TRUE(check("192.168.1.1"), "192.168.1.1 rejected after keyword change");
+  CHECK_TRUE(!check("11.0.0.1"), "11.0.0.1 accepted after keyword change");
+
+  END_TEST();
+}
+
+static void test_prefix_length_ignored(void) {
+  static const char value[] = "10.0.0.0/16\0-10.0.0.0/24\0" "fd00::/64\0" ACL_FIRST_REJECT;
+  struct const_strarray array = ACL_VALUE(value);
+
+  START_TEST();
+
+  CHECK_TRUE(netaddr_acl_from_strarray(&acl, &array) == 0, "could not parse ACL");
+  CHECK_TRUE(netaddr_acl_compile(&acl) == 0, "could not compile ACL");
+
+  /* prefixes are checked by their address, like netaddr_is_in_subnet() */
+  CHECK_TRUE(check("10.0.1.0/8"), "10.0.1.0/8 rejected");
+  CHECK_TRUE(!check("10.0.0.0/8"), "10.0.0.0/8 accepted");
+  CHECK_TRUE(check("fd00::/16"), "fd00::/16 rejected");
+  CHECK_TRUE(!check("fd01::/16"), "fd01::/16 accepted");
+
+  END_TEST();
+}
+
+static void test_copy(void) {
+  static const char value[] = "-10.0.0.0/8\0" ACL_DEFAULT_ACCEPT;
+  struct const_strarray array = ACL_VALUE(value);
+
+  START_TEST();
+
+  CHECK_TRUE(netaddr_acl_from_strarray(&acl_source, &array) == 0, "could not parse ACL");
+  CHECK_TRUE(netaddr_acl_compile(&acl_source) == 0, "could not compile ACL");
+  CHECK_TRUE(netaddr_acl_copy(&acl, &acl_source) == 0, "could not copy ACL");
+  CHECK_TRUE(acl._compiled != NULL && acl._compiled != acl_source._compiled, "copy shares compiled ACL");
+
+  netaddr_acl_remove(&acl_source);
+  CHECK_TRUE(!check("10.0.0.1"), "10.0.0.1 accepted");
+  CHECK_TRUE(check("11.0.0.1"), "11.0.0.1 rejected");
+
+  END_TEST();
+}
+
+/* reference implementation of the linear ACL check */
+static bool check_linear(const struct netaddr *addr) {
+  bool in_accept = false, in_reject = false;
+  size_t i;
+
+  for (i=0; i<acl.accept_count; i++) {
+    in_accept |= netaddr_is_in_subnet(&acl.accept[i], addr);
+  }
+  for (i=0; i<acl.reject_count; i++) {
+    in_reject |= netaddr_is_in_subnet(&acl.reject[i], addr);
+  }
+
+  if (acl.reject_first && in_reject) {
+    return false;
+  }
+  if (in_accept) {
+    return true;
+  }
+  if (in_reject) {
+    return false;
+  }
+  return acl.accept_default;
+}
+
+static void random_addr(uint8_t *bin) {
+  /* use a small address space to get lots of nested prefixes */
+  bin[0] = 10;
+  bin[1] = rand() % 4;
+  bin[2] = rand() % 256;
+  bin[3] = rand() % 256;
+}
+
+static void test_random(void) {
+  struct netaddr addr;
+  uint8_t bin[4];
+  int i, step;
+
+  START_TEST();
+
+  srand(42);
+  for (step=0; step<20; step++) {
+    netaddr_acl_remove(&acl);
+    acl.reject_first = (step & 1) != 0;
+    acl.accept_default = (step & 2) != 0;
+    acl.accept = calloc(50, sizeof(struct netaddr));
+    acl.reject = calloc(50, sizeof(struct netaddr));
+    CHECK_TRUE(acl.accept != NULL && acl.reject != NULL, "out of memory");
+    if (acl.accept == NULL || acl.reject == NULL) {
+      return;
+    }
+
+    for (i=0; i<50; i++) {
+      random_addr(bin);
+      netaddr_from_binary_prefix(&acl.accept[acl.accept_count++], bin, 4, AF_INET, 8 + rand() % 25);
+      random_addr(bin);
+      netaddr_from_binary_prefix(&acl.reject[acl.reject_count++], bin, 4, AF_INET, 8 + rand() % 25);
+    }
+
+    CHECK_TRUE(netaddr_acl_copy(&acl_source, &acl) == 0, "could not copy ACL");
+    CHECK_TRUE(acl_source._compiled != NULL, "large ACL was not compiled automatically");
+    CHECK_TRUE(netaddr_acl_compile(&acl) == 0, "could not compile ACL");
+
+    for (i=0; i<500; i++) {
+      random_addr(bin);
+      netaddr_from_binary(&addr, bin, 4, AF_INET);
+
+      /* check twice to test the lookup cache too */
+      CHECK_TRUE(netaddr_acl_check_accept(&acl, &addr) == check_linear(&addr), "compiled check differs");
+      CHECK_TRUE(netaddr_acl_check_accept(&acl, &addr) == check_linear(&addr), "cached check differs");
+    }
+  }
+
+  END_TEST();
+}
+
+int main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  netaddr_acl_add(&acl);
+  netaddr_acl_add(&acl_source);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_first_accept();
+  test_first_reject();
+  test_prefix_length_ignored();
+  test_copy();
+  test_random();
+
+  netaddr_acl_remove(&acl);
+  netaddr_acl_remove(&acl_source);
+  return FINISH_TESTING();
+}
@@ -0,0 +1,156 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcommon/netaddr_hash.h>
+#include <oonf/cunit/cunit.h>
+
+struct hash_element {
+  int id;
+  struct netaddr addr;
+  struct netaddr_hash_node node;
+};
+
+#define COUNT 1000
+
+static struct netaddr_hash hash;
+static struct hash_element elements[COUNT];
+
+static void clear_elements(void) {
+  uint8_t bin[4];
+  int i;
+
+  netaddr_hash_free(&hash);
+  memset(elements, 0, sizeof(elements));
+  for (i=0; i<COUNT; i++) {
+    bin[0] = 10;
+    bin[1] = 0;
+    bin[2] = i >> 8;
+    bin[3] = i & 255;
+
+    elements[i].id = i;
+    netaddr_from_binary(&elements[i].addr, bin, 4, AF_INET);
+    elements[i].node.key = &elements[i].addr;
+  }
+}
+
+static void test_insert_find(void) {
+  struct hash_element *e;
+  struct netaddr addr;
+  int i;
+
+  START_TEST();
+
+  for (i=0; i<COUNT; i++) {
+    netaddr_hash_insert(&hash, &elements[i].node);
+  }
+  CHECK_TRUE(hash.count == COUNT, "hash count is %u", hash.count);
+  CHECK_TRUE(hash._size >= COUNT, "hash did not grow, size is %u", hash._size);
+
+  for (i=0; i<COUNT; i++) {
+    memcpy(&addr, &elements[i].addr, sizeof(addr));
+    e = netaddr_hash_find_element(&hash, &addr, e, node);
+    CHECK_TRUE(e != NULL && e->id == i, "lookup of element %d returned %d", i, e ? e->id : -1);
+  }
+
+  /* same address with different prefix length is a different key */
+  netaddr_set_prefix_length(&addr, 24);
+  e = netaddr_hash_find_element(&hash, &addr, e, node);
+  CHECK_TRUE(e == NULL, "prefix lookup returned %d", e ? e->id : -1);
+
+  CHECK_TRUE(hash.lookups == COUNT + 1, "%" PRIu64 " lookups counted", hash.lookups);
+  CHECK_TRUE(hash.hits == COUNT, "%" PRIu64 " hits counted", hash.hits);
+
+  END_TEST();
+}
+
+static void test_remove(void) {
+  struct hash_element *e;
+  int i;
+
+  START_TEST();
+
+  for (i=0; i<COUNT; i++) {
+    netaddr_hash_insert(&hash, &elements[i].node);
+  }
+
+  for (i=0; i<COUNT; i+=2) {
+    netaddr_hash_remove(&hash, &elements[i].node);
+  }
+  CHECK_TRUE(hash.count == COUNT / 2, "hash count is %u", hash.count);
+
+  for (i=0; i<COUNT; i++) {
+    e = netaddr_hash_find_element(&hash, &elements[i].addr, e, node);
+    if (i & 1) {
+      CHECK_TRUE(e != NULL && e->id == i, "lookup of element %d returned %d", i, e ? e->id : -1);
+    }
+    else {
+      CHECK_TRUE(e == NULL, "lookup of removed element %d returned %d", i, e ? e->id : -1);
+    }
+  }
+
+  for (i=1; i<COUNT; i+=2) {
+    netaddr_hash_remove(&hash, &elements[i].node);
+  }
+  CHECK_TRUE(netaddr_hash_is_empty(&hash), "hash not empty");
+
+  END_TEST();
+}
+
+int main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  netaddr_hash_init(&hash);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_insert_find();
+  test_remove();
+
+  netaddr_hash_free(&hash);
+  return FINISH_TESTING();
+}
@@ -0,0 +1,385 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/sliding_window.h>
+#include <oonf/cunit/cunit.h>
+
+#define SAMPLING_COUNT 32
+
+/*
+ * Reference implementation of the DAT metric history, this is the
+ * bucket ringbuffer the sliding window replaced in ff_dat_metric.
+ */
+struct ref_bucket {
+  uint32_t received;
+  uint32_t total;
+  int64_t raw_speed;
+};
+
+struct ref_history {
+  struct ref_bucket buckets[SAMPLING_COUNT];
+  uint16_t activePtr;
+};
+
+/* history as stored by ff_dat_metric */
+struct dat_history {
+  struct sliding_window received;
+  struct sliding_window total;
+  struct sliding_window rx_speed;
+
+  int64_t _received_samples[SAMPLING_COUNT];
+  int64_t _total_samples[SAMPLING_COUNT];
+  int64_t _rx_speed_samples[SAMPLING_COUNT];
+  int64_t _rx_speed_sorted[SAMPLING_COUNT];
+};
+
+/*
+ * Recorded link speed samples of a wifi link (bit/s), including
+ * intervals without layer2 data (-1), a link with more than 2^31 bit/s
+ * and a link without any link speed data.
+ */
+static const int64_t recorded_speed_wifi[] = {
+  -1, -1, 54000000, 54000000, 48000000, 54000000, 36000000, 36000000, 24000000, 48000000,
+  54000000, 54000000, -1, 18000000, 12000000, 12000000, 24000000, 36000000, 48000000, 54000000,
+  54000000, 54000000, 54000000, 48000000, 48000000, 36000000, -1, -1, -1, 36000000,
+  48000000, 54000000, 54000000, 54000000, 54000000, 54000000, 54000000, 54000000, 54000000, 54000000,
+  6000000, 6000000, 9000000, 12000000, 12000000, 18000000, 24000000, 36000000, 48000000, 54000000,
+};
+static const int64_t recorded_speed_fast[] = {
+  1000000000, 1000000000, 2500000000ll, 2500000000ll, 5000000000ll, 10000000000ll, 2147483647, 2147483648ll,
+  1000000000, 100000000, 10000000, 0, 0, 4294967296ll, 4294967297ll, 1000000000, 1000000000, 1000000000,
+};
+static const int64_t recorded_speed_none[] = {
+  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+/* recorded packet sequence number gaps per sampling interval, 0 ends an interval */
+static const uint32_t recorded_packets[] = {
+  1, 1, 0, 1, 1, 0, 1, 2, 0, 1, 1, 0, 3, 0, 0, 0, 1, 1, 1, 1, 0, 1, 0, 65535, 1, 0,
+  1, 1, 0, 5, 1, 0, 1, 1, 0, 1, 1, 0, 1, 0, 1, 1, 1, 0, 2, 2, 0, 1, 1, 0, 0, 1, 1, 0,
+};
+
+static void
+ref_init(struct ref_history *ref) {
+  size_t i;
+
+  memset(ref, 0, sizeof(*ref));
+  for (i = 0; i < SAMPLING_COUNT; i++) {
+    ref->buckets[i].total = 1;
+  }
+}
+
+static int
+_int_comparator(const void *p1, const void *p2) {
+  const int *i1 = (int *)p1;
+  const int *i2 = (int *)p2;
+
+  if (*i1 > *i2) {
+    return 1;
+  }
+  else if (*i1 < *i2) {
+    return -1;
+  }
+  return 0;
+}
+
+static int
+ref_median(struct ref_history *ref) {
+  int sort_array[SAMPLING_COUNT];
+  int zero_count;
+  size_t window;
+  size_t i;
+
+  zero_count = 0;
+  for (i = 0; i < SAMPLING_COUNT; i++) {
+    sort_array[i] = ref->buckets[i].raw_speed;
+    if (sort_array[i] <= 0) {
+      zero_count++;
+    }
+  }
+
+  window = SAMPLING_COUNT - zero_count;
+  if (window == 0) {
+    return -1;
+  }
+
+  qsort(sort_array, SAMPLING_COUNT, sizeof(int), _int_comparator);
+  return sort_array[zero_count + window / 2];
+}
+
+static void
+ref_sample(struct ref_history *ref, int64_t speed, uint32_t *received, uint32_t *total, int *median) {
+  size_t i;
+
+  *received = 0;
+  *total = 0;
+  for (i = 0; i < SAMPLING_COUNT; i++) {
+    *received += ref->buckets[i].received;
+    *total += ref->buckets[i].total;
+  }
+
+  ref->buckets[ref->activePtr].raw_speed = speed;
+  *median = ref_median(ref);
+
+  ref->activePtr++;
+  if (ref->activePtr >= SAMPLING_COUNT) {
+    ref->activePtr = 0;
+  }
+  ref->buckets[ref->activePtr].received = 0;
+  ref->buckets[ref->activePtr].total = 0;
+}
+
+static void
+dat_init(struct dat_history *dat) {
+  memset(dat, 0, sizeof(*dat));
+  sliding_window_init(&dat->received, dat->_received_samples, NULL, SAMPLING_COUNT);
+  sliding_window_init(&dat->total, dat->_total_samples, NULL, SAMPLING_COUNT);
+  sliding_window_init(&dat->rx_speed, dat->_rx_speed_samples, dat->_rx_speed_sorted, SAMPLING_COUNT);
+  sliding_window_fill(&dat->total, 1);
+}
+
+static int
+dat_median(struct dat_history *dat) {
+  size_t zero_count, window;
+
+  zero_count = sliding_window_count_le(&dat->rx_speed, 0);
+  window = dat->rx_speed.size - zero_count;
+  if (window == 0) {
+    return -1;
+  }
+  return sliding_window_get_ranked(&dat->rx_speed, zero_count + window / 2);
+}
+
+static void
+dat_sample(struct dat_history *dat, int64_t speed, uint32_t *received, uint32_t *total, int *median) {
+  *received = (uint32_t)sliding_window_get_sum(&dat->received);
+  *total = (uint32_t)sliding_window_get_sum(&dat->total);
+
+  sliding_window_set(&dat->rx_speed, (int)speed);
+  *median = dat_median(dat);
+
+  sliding_window_advance(&dat->received);
+  sliding_window_advance(&dat->total);
+  sliding_window_advance(&dat->rx_speed);
+  sliding_window_set(&dat->received, 0);
+  sliding_window_set(&dat->total, 0);
+}
+
+/**
+ * Replay a recorded sequence of packets and link speeds through the
+ * reference implementation and the sliding windows
+ * @param speeds recorded link speeds, one per sampling interval
+ * @param speed_count number of link speeds
+ * @param packets recorded packet gaps, 0 ends a sampling interval
+ * @param packet_count number of packet gaps
+ * @param rounds number of times the sequences are replayed
+ */
+static void
+replay(const int64_t *speeds, size_t speed_count,
+    const uint32_t *packets, size_t packet_count, size_t rounds) {
+  struct ref_history ref;
+  struct dat_history dat;
+  uint32_t ref_received, ref_total, dat_received, dat_total;
+  int ref_median_value, dat_median_value;
+  size_t tick, pkt, ticks;
+
+  ref_init(&ref);
+  dat_init(&dat);
+
+  /* first packet of the link */
+  ref.buckets[0].received = 1;
+  ref.buckets[0].total = 1;
+  sliding_window_set(&dat.received, 1);
+  sliding_window_set(&dat.total, 1);
+
+  pkt = 0;
+  ticks = speed_count * rounds;
+  for (tick = 0; tick < ticks; tick++) {
+    /* received packets of this interval */
+    while (packets[pkt % packet_count] != 0) {
+      ref.buckets[ref.activePtr].received++;
+      ref.buckets[ref.activePtr].total += packets[pkt % packet_count];
+
+      sliding_window_set(&dat.received, (uint32_t)(sliding_window_get(&dat.received) + 1));
+      sliding_window_set(&dat.total, (uint32_t)(sliding_window_get(&dat.total) + packets[pkt % packet_count]));
+      pkt++;
+    }
+    pkt++;
+
+    ref_sample(&ref, speeds[tick % speed_count], &ref_received, &ref_total, &ref_median_value);
+    dat_sample(&dat, speeds[tick % speed_count], &dat_received, &dat_total, &dat_median_value);
+
+    CHECK_TRUE(ref_received == dat_received, "tick %" PRINTF_SIZE_T_SPECIFIER ": received %u != %u",
+        tick, ref_received, dat_received);
+    CHECK_TRUE(ref_total == dat_total, "tick %" PRINTF_SIZE_T_SPECIFIER ": total %u != %u",
+        tick, ref_total, dat_total);
+    CHECK_TRUE(ref_median_value == dat_median_value, "tick %" PRINTF_SIZE_T_SPECIFIER ": median %d != %d",
+        tick, ref_median_value, dat_median_value);
+  }
+}
+
+static void
+clear_elements(void) {
+  srand(1);
+}
+
+static void
+test_sum(void) {
+  struct sliding_window window;
+  int64_t samples[4];
+  int i;
+
+  START_TEST();
+
+  sliding_window_init(&window, samples, NULL, 4);
+  CHECK_TRUE(sliding_window_get_sum(&window) == 0, "initial sum is %" PRId64, sliding_window_get_sum(&window));
+
+  for (i = 1; i <= 10; i++) {
+    sliding_window_set(&window, i);
+    sliding_window_add(&window, 1);
+    sliding_window_advance(&window);
+  }
+
+  /* window contains 8, 9, 10 and 11 */
+  CHECK_TRUE(sliding_window_get_sum(&window) == 38, "sum is %" PRId64, sliding_window_get_sum(&window));
+  CHECK_TRUE(sliding_window_get(&window) == 8, "oldest sample is %" PRId64, sliding_window_get(&window));
+
+  sliding_window_fill(&window, 5);
+  CHECK_TRUE(sliding_window_get_sum(&window) == 20, "sum after fill is %" PRId64, sliding_window_get_sum(&window));
+
+  END_TEST();
+}
+
+static void
+test_order_statistics(void) {
+  struct sliding_window window;
+  int64_t samples[5], sorted[5];
+  size_t i;
+
+  START_TEST();
+
+  sliding_window_init(&window, samples, sorted, 5);
+
+  /* 3, -2, 7, 3, 0 */
+  sliding_window_set(&window, 3);
+  sliding_window_advance(&window);
+  sliding_window_set(&window, -2);
+  sliding_window_advance(&window);
+  sliding_window_set(&window, 7);
+  sliding_window_advance(&window);
+  sliding_window_set(&window, 3);
+  sliding_window_advance(&window);
+
+  CHECK_TRUE(sliding_window_count_le(&window, 0) == 2, "count_le(0) is %" PRINTF_SIZE_T_SPECIFIER,
+      sliding_window_count_le(&window, 0));
+  CHECK_TRUE(sliding_window_count_le(&window, 3) == 4, "count_le(3) is %" PRINTF_SIZE_T_SPECIFIER,
+      sliding_window_count_le(&window, 3));
+  CHECK_TRUE(sliding_window_count_le(&window, -3) == 0, "count_le(-3) is %" PRINTF_SIZE_T_SPECIFIER,
+      sliding_window_count_le(&window, -3));
+
+  /* overwrite first sample: 1, -2, 7, 3, 0 */
+  sliding_window_advance(&window);
+  sliding_window_set(&window, 1);
+
+  for (i = 1; i < 5; i++) {
+    CHECK_TRUE(sliding_window_get_ranked(&window, i - 1) <= sliding_window_get_ranked(&window, i),
+        "sorted order violated at %" PRINTF_SIZE_T_SPECIFIER, i);
+  }
+  CHECK_TRUE(sliding_window_get_ranked(&window, 0) == -2, "minimum is %" PRId64, sliding_window_get_ranked(&window, 0));
+  CHECK_TRUE(sliding_window_get_ranked(&window, 2) == 1, "median is %" PRId64, sliding_window_get_ranked(&window, 2));
+  CHECK_TRUE(sliding_window_get_ranked(&window, 4) == 7, "maximum is %" PRId64, sliding_window_get_ranked(&window, 4));
+
+  END_TEST();
+}
+
+static void
+test_recorded_sequences(void) {
+  START_TEST();
+
+  replay(recorded_speed_wifi, ARRAYSIZE(recorded_speed_wifi), recorded_packets, ARRAYSIZE(recorded_packets), 5);
+  replay(recorded_speed_fast, ARRAYSIZE(recorded_speed_fast), recorded_packets, ARRAYSIZE(recorded_packets), 5);
+  replay(recorded_speed_none, ARRAYSIZE(recorded_speed_none), recorded_packets, ARRAYSIZE(recorded_packets), 5);
+
+  END_TEST();
+}
+
+static void
+test_random_sequences(void) {
+  int64_t speeds[200];
+  uint32_t packets[1000];
+  size_t i;
+
+  START_TEST();
+
+  for (i = 0; i < ARRAYSIZE(speeds); i++) {
+    /* few distinct values to get many duplicates */
+    speeds[i] = (rand() % 10) == 0 ? -1 : (int64_t)(rand() % 8) * 6000000;
+  }
+  for (i = 0; i < ARRAYSIZE(packets); i++) {
+    packets[i] = (rand() % 4) == 0 ? 0 : 1 + rand() % 3;
+  }
+  packets[ARRAYSIZE(packets) - 1] = 0;
+
+  replay(speeds, ARRAYSIZE(speeds), packets, ARRAYSIZE(packets), 3);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  BEGIN_TESTING(clear_elements);
+
+  test_sum();
+  test_order_statistics();
+  test_recorded_sequences();
+  test_random_sequences();
+
+  return FINISH_TESTING();
+}
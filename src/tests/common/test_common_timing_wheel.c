@@ -0,0 +1,195 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <oonf/libcommon/timing_wheel.h>
+#include <oonf/cunit/cunit.h>
+
+struct wheel_element {
+  bool expired;
+  struct timing_wheel_node node;
+};
+
+#define COUNT 1000
+
+static struct timing_wheel wheel;
+static struct wheel_element elements[COUNT];
+
+static void clear_elements(void) {
+  memset(elements, 0, sizeof(elements));
+  timing_wheel_init(&wheel, 1000);
+}
+
+/* move the wheel forward and check that exactly the right nodes expired in order */
+static void check_advance(uint64_t now) {
+  struct wheel_element *e;
+  uint64_t last = 0;
+  int i, expected = 0, found = 0;
+
+  timing_wheel_advance(&wheel, now);
+
+  for (i=0; i<COUNT; i++) {
+    if (timing_wheel_is_node_added(&elements[i].node) && !elements[i].expired
+        && elements[i].node.key <= now) {
+      expected++;
+    }
+  }
+
+  while (timing_wheel_has_expired(&wheel)) {
+    e = timing_wheel_first_expired(&wheel, e, node);
+    CHECK_TRUE(e->node.key <= now, "node with key %" PRIu64 " expired at %" PRIu64, e->node.key, now);
+    CHECK_TRUE(e->node.key >= last, "node with key %" PRIu64 " expired after %" PRIu64, e->node.key, last);
+    last = e->node.key;
+
+    timing_wheel_remove(&wheel, &e->node);
+    e->expired = true;
+    found++;
+  }
+  CHECK_TRUE(found == expected, "%d nodes expired at %" PRIu64 ", expected %d", found, now, expected);
+
+  /* the next event must never be later than the earliest node */
+  for (i=0; i<COUNT; i++) {
+    if (timing_wheel_is_node_added(&elements[i].node)) {
+      CHECK_TRUE(timing_wheel_get_next(&wheel) <= elements[i].node.key,
+          "next event %" PRIu64 " later than node %" PRIu64, timing_wheel_get_next(&wheel), elements[i].node.key);
+    }
+  }
+}
+
+static void test_insert_expire(void) {
+  START_TEST();
+
+  elements[0].node.key = 1005;
+  timing_wheel_insert(&wheel, &elements[0].node);
+  elements[1].node.key = 1000 + 64 * 64 + 17;
+  timing_wheel_insert(&wheel, &elements[1].node);
+  elements[2].node.key = 999;
+  timing_wheel_insert(&wheel, &elements[2].node);
+
+  CHECK_TRUE(wheel.count == 3, "wheel count is %u", wheel.count);
+  CHECK_TRUE(timing_wheel_get_next(&wheel) == 999, "next event is %" PRIu64, timing_wheel_get_next(&wheel));
+
+  check_advance(1004);
+  CHECK_TRUE(elements[2].expired, "past node did not expire");
+  CHECK_TRUE(timing_wheel_get_next(&wheel) == 1005, "next event is %" PRIu64, timing_wheel_get_next(&wheel));
+
+  check_advance(1005);
+  CHECK_TRUE(elements[0].expired, "node did not expire");
+
+  check_advance(1000 + 64 * 64 + 16);
+  CHECK_TRUE(!elements[1].expired, "node expired too early");
+  CHECK_TRUE(timing_wheel_get_next(&wheel) == 1000 + 64 * 64 + 17, "next event is %" PRIu64,
+      timing_wheel_get_next(&wheel));
+
+  check_advance(1000 + 64 * 64 + 17);
+  CHECK_TRUE(elements[1].expired, "cascaded node did not expire");
+  CHECK_TRUE(timing_wheel_is_empty(&wheel), "wheel not empty");
+  CHECK_TRUE(timing_wheel_get_next(&wheel) == UINT64_MAX, "next event of empty wheel is %" PRIu64,
+      timing_wheel_get_next(&wheel));
+
+  END_TEST();
+}
+
+static void test_remove(void) {
+  START_TEST();
+
+  elements[0].node.key = 1100;
+  timing_wheel_insert(&wheel, &elements[0].node);
+  elements[1].node.key = 1100;
+  timing_wheel_insert(&wheel, &elements[1].node);
+
+  timing_wheel_remove(&wheel, &elements[0].node);
+  CHECK_TRUE(!timing_wheel_is_node_added(&elements[0].node), "node still added");
+  CHECK_TRUE(wheel.count == 1, "wheel count is %u", wheel.count);
+
+  timing_wheel_remove(&wheel, &elements[1].node);
+  CHECK_TRUE(timing_wheel_is_empty(&wheel), "wheel not empty");
+  CHECK_TRUE(timing_wheel_get_next(&wheel) == UINT64_MAX, "slot bitmap not cleared");
+
+  END_TEST();
+}
+
+static void test_random(void) {
+  uint64_t now = 1000;
+  int i, step;
+
+  START_TEST();
+
+  srand(42);
+  for (step=0; step<200; step++) {
+    for (i=0; i<COUNT; i++) {
+      if (rand() % 8 != 0) {
+        continue;
+      }
+
+      timing_wheel_remove(&wheel, &elements[i].node);
+      elements[i].expired = false;
+
+      if (rand() % 4 != 0) {
+        /* mix of short and very long timers */
+        elements[i].node.key = now + 1 + (rand() % 2 ? (uint64_t)(rand() % 100) : (uint64_t)rand() * 37);
+        timing_wheel_insert(&wheel, &elements[i].node);
+      }
+    }
+
+    now += 1 + (step % 10 == 0 ? rand() % 100000 : rand() % 50);
+    check_advance(now);
+  }
+
+  END_TEST();
+}
+
+int main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  BEGIN_TESTING(clear_elements);
+
+  test_insert_expire();
+  test_remove();
+  test_random();
+
+  return FINISH_TESTING();
+}
@@ -0,0 +1,319 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/string.h>
+#include <oonf/libcore/oonf_appdata.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/cunit/cunit.h>
+
+#define EVENT_COUNT 1000
+
+struct test_output {
+  int count;
+  int last_event;
+  bool ordered;
+  bool dropped_report;
+  char last_line[256];
+};
+
+static void _cb_log(struct oonf_log_handler_entry *, struct oonf_log_parameters *);
+
+static struct oonf_appdata _appdata = {
+  .app_name = "test_core_logging",
+};
+
+static struct test_output _async_output, _sync_output;
+
+static struct oonf_log_handler_entry _async_handler = {
+  .handler = _cb_log,
+  .custom = &_async_output,
+  .threadsafe = true,
+};
+
+static struct oonf_log_handler_entry _sync_handler = {
+  .handler = _cb_log,
+  .custom = &_sync_output,
+};
+
+static void
+_cb_log(struct oonf_log_handler_entry *entry, struct oonf_log_parameters *param) {
+  struct test_output *output = entry->custom;
+  int event;
+
+  if (strstr(param->buffer, "dropped") != NULL) {
+    output->dropped_report = true;
+    return;
+  }
+
+  if (sscanf(param->buffer + param->prefixLength, "event %d", &event) == 1) {
+    if (event <= output->last_event) {
+      output->ordered = false;
+    }
+    output->last_event = event;
+  }
+  output->count++;
+
+  /* remember line without the timestamp */
+  strscpy(output->last_line, param->buffer + param->timeLength, sizeof(output->last_line));
+}
+
+static void
+_clear_output(struct test_output *output) {
+  memset(output, 0, sizeof(*output));
+  output->last_event = -1;
+  output->ordered = true;
+}
+
+static void
+clear_elements(void) {
+  _clear_output(&_async_output);
+  _clear_output(&_sync_output);
+}
+
+static void
+_log_events(int count) {
+  int i;
+
+  for (i = 0; i < count; i++) {
+    oonf_log(LOG_SEVERITY_WARN, LOG_MAIN, __FILE__, __LINE__, NULL, 0, "event %d", i);
+  }
+}
+
+static void
+test_sync(void) {
+  START_TEST();
+
+  oonf_log_addhandler(&_async_handler);
+
+  /* without logging thread all handlers are called immediately */
+  _log_events(10);
+  CHECK_TRUE(_async_output.count == 10, "handler called %d times", _async_output.count);
+
+  oonf_log_removehandler(&_async_handler);
+
+  END_TEST();
+}
+
+static void
+test_async(void) {
+  uint64_t dropped;
+
+  START_TEST();
+
+  oonf_log_addhandler(&_async_handler);
+  oonf_log_addhandler(&_sync_handler);
+
+  oonf_log_async_setup(1024 * 1024);
+  CHECK_TRUE(oonf_log_async_start() == 0, "could not start logging thread");
+
+  dropped = oonf_log_async_get_dropped();
+  _log_events(EVENT_COUNT);
+
+  /* handlers which are not thread safe are still called synchronously */
+  CHECK_TRUE(_sync_output.count == EVENT_COUNT, "sync handler called %d times", _sync_output.count);
+
+  oonf_log_async_stop();
+
+  CHECK_TRUE(oonf_log_async_get_dropped() == dropped, "dropped %" PRIu64 " events", oonf_log_async_get_dropped() - dropped);
+  CHECK_TRUE(_async_output.count == EVENT_COUNT, "async handler called %d times", _async_output.count);
+  CHECK_TRUE(_async_output.ordered, "events were reordered");
+  CHECK_TRUE(strcmp(_async_output.last_line, _sync_output.last_line) == 0, "lines differ:\n%s\n%s",
+    _async_output.last_line, _sync_output.last_line);
+
+  oonf_log_removehandler(&_sync_handler);
+  oonf_log_removehandler(&_async_handler);
+
+  END_TEST();
+}
+
+static void
+test_hexdump(void) {
+  static const uint8_t data[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14 };
+  char sync_line[256];
+
+  START_TEST();
+
+  oonf_log_addhandler(&_async_handler);
+
+  oonf_log(LOG_SEVERITY_WARN, LOG_MAIN, "file.c", 42, data, sizeof(data), "hexdump %d", 1);
+  strscpy(sync_line, _async_output.last_line, sizeof(sync_line));
+
+  oonf_log_async_setup(64 * 1024);
+  CHECK_TRUE(oonf_log_async_start() == 0, "could not start logging thread");
+
+  oonf_log(LOG_SEVERITY_WARN, LOG_MAIN, "file.c", 42, data, sizeof(data), "hexdump %d", 1);
+  oonf_log_async_stop();
+
+  CHECK_TRUE(_async_output.count == 2, "handler called %d times", _async_output.count);
+  CHECK_TRUE(strcmp(_async_output.last_line, sync_line) == 0, "hexdump lines differ:\n%s\n%s",
+    _async_output.last_line, sync_line);
+
+  oonf_log_removehandler(&_async_handler);
+
+  END_TEST();
+}
+
+static void
+test_remove_flushes(void) {
+  START_TEST();
+
+  oonf_log_addhandler(&_async_handler);
+
+  oonf_log_async_setup(1024 * 1024);
+  CHECK_TRUE(oonf_log_async_start() == 0, "could not start logging thread");
+
+  _log_events(EVENT_COUNT);
+
+  /* all queued events must reach the handler before it is removed */
+  oonf_log_removehandler(&_async_handler);
+  CHECK_TRUE(_async_output.count == EVENT_COUNT, "handler called %d times", _async_output.count);
+
+  oonf_log_async_stop();
+
+  END_TEST();
+}
+
+static void
+test_flush(void) {
+  START_TEST();
+
+  oonf_log_addhandler(&_async_handler);
+
+  oonf_log_async_setup(1024 * 1024);
+  CHECK_TRUE(oonf_log_async_start() == 0, "could not start logging thread");
+
+  _log_events(EVENT_COUNT);
+
+  /* plugins are unloaded after a flush, no event may still be queued */
+  oonf_log_async_flush();
+  CHECK_TRUE(_async_output.count == EVENT_COUNT, "handler called %d times", _async_output.count);
+
+  oonf_log_async_stop();
+  CHECK_TRUE(_async_output.count == EVENT_COUNT, "handler called %d times after stop", _async_output.count);
+
+  oonf_log_removehandler(&_async_handler);
+
+  END_TEST();
+}
+
+static void
+test_overflow(void) {
+  uint64_t dropped;
+
+  START_TEST();
+
+  oonf_log_addhandler(&_async_handler);
+
+  /* only a few records fit into the ring */
+  oonf_log_async_setup(8 * 1024);
+  CHECK_TRUE(oonf_log_async_start() == 0, "could not start logging thread");
+
+  dropped = oonf_log_async_get_dropped();
+  _log_events(EVENT_COUNT);
+  oonf_log_async_stop();
+
+  dropped = oonf_log_async_get_dropped() - dropped;
+  CHECK_TRUE(_async_output.count + (int)dropped == EVENT_COUNT, "%d events written, %" PRIu64 " dropped",
+    _async_output.count, dropped);
+  CHECK_TRUE(_async_output.ordered, "events were reordered");
+  CHECK_TRUE(dropped == 0 || _async_output.dropped_report, "dropped events were not reported");
+
+  oonf_log_removehandler(&_async_handler);
+
+  END_TEST();
+}
+
+static void
+test_minimum_buffer(void) {
+  uint64_t dropped;
+
+  START_TEST();
+
+  oonf_log_addhandler(&_async_handler);
+
+  /* a ring of a single kilobyte cannot hold a record of maximum length */
+  oonf_log_async_setup(1024);
+  CHECK_TRUE(oonf_log_async_start() == 0, "could not start logging thread");
+
+  dropped = oonf_log_async_get_dropped();
+  _log_events(1);
+  oonf_log_async_stop();
+
+  CHECK_TRUE(oonf_log_async_get_dropped() == dropped, "dropped %" PRIu64 " events", oonf_log_async_get_dropped() - dropped);
+  CHECK_TRUE(_async_output.count == 1, "handler called %d times", _async_output.count);
+
+  oonf_log_removehandler(&_async_handler);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+
+  oonf_log_mask_set(_async_handler.user_bitmask, LOG_ALL, LOG_SEVERITY_WARN);
+  oonf_log_mask_set(_sync_handler.user_bitmask, LOG_ALL, LOG_SEVERITY_WARN);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_sync();
+  test_async();
+  test_hexdump();
+  test_remove_flushes();
+  test_flush();
+  test_overflow();
+  test_minimum_buffer();
+
+  oonf_log_cleanup();
+  return FINISH_TESTING();
+}
@@ -0,0 +1,588 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libconfig/cfg_db.h>
+#include <oonf/libconfig/cfg_schema.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_clock.h>
+#include <oonf/base/oonf_rfc5444.h>
+#include <oonf/base/oonf_telnet.h>
+#include <oonf/librfc5444/rfc5444_iana.h>
+#include <oonf/librfc5444/rfc5444_reader.h>
+#include <oonf/librfc5444/rfc5444_writer.h>
+#include <oonf/crypto/rfc7182_provider/rfc7182_provider.h>
+#include <oonf/crypto/rfc5444_signature/rfc5444_signature.h>
+#include <oonf/cunit/cunit.h>
+
+#define MSG_TYPE 1
+
+/* length of test signature value */
+#define ICV_LENGTH 4
+
+/* length of an unsigned test message */
+#define UNSIGNED_MSG_LENGTH 18
+
+/* length of a signed test message */
+#define SIGNED_MSG_LENGTH 29
+
+static struct oonf_appdata _appdata = {
+  .app_name = "test_crypto_rfc5444_signature",
+};
+
+/* test hash/crypto functions, they count how many signatures are verified */
+static int _cb_test_hash(struct rfc7182_hash *hash, void *dst, size_t *dst_len, const void *src, size_t src_len);
+static int _cb_test_encrypt(struct rfc7182_crypt *crypt, void *dst, size_t *dst_len, const void *src,
+  size_t src_len, const void *key, size_t key_len);
+static size_t _cb_test_signsize(struct rfc7182_crypt *crypt, struct rfc7182_hash *hash);
+
+static struct rfc7182_hash _test_hash = {
+  .type = RFC7182_ICV_HASH_SHA_256,
+  .hash = _cb_test_hash,
+  .hash_length = ICV_LENGTH,
+};
+
+static struct rfc7182_crypt _test_crypt = {
+  .type = RFC7182_ICV_CRYPT_HMAC,
+  .encrypt = _cb_test_encrypt,
+  .getSignSize = _cb_test_signsize,
+};
+
+/* message signature with a configurable key */
+static bool _cb_is_matching_signature(struct rfc5444_signature *sig, int msg_type);
+static const void *_cb_get_crypto_key(struct rfc5444_signature *sig, size_t *length);
+
+static struct rfc5444_signature _signature = {
+  .key =
+    {
+      .hash_function = RFC7182_ICV_HASH_SHA_256,
+      .crypt_function = RFC7182_ICV_CRYPT_HMAC,
+    },
+  .drop_if_invalid = true,
+  .is_matching_signature = _cb_is_matching_signature,
+  .getCryptoKey = _cb_get_crypto_key,
+};
+
+/* message consumer behind the signature check */
+static enum rfc5444_result _cb_test_message(struct rfc5444_reader_tlvblock_context *context);
+
+static struct rfc5444_reader_tlvblock_consumer _test_consumer = {
+  .order = RFC5444_MAIN_PARSER_PRIORITY,
+  .default_msg_consumer = true,
+  .block_callback = _cb_test_message,
+};
+
+static const uint8_t _originator[4] = { 10, 0, 0, 1 };
+static const char *_key;
+
+static struct oonf_rfc5444_protocol _protocol;
+static struct netaddr _src_address;
+static uint8_t _msg_buffer[RFC5444_MAX_PACKET_SIZE];
+static uint8_t _addrtlv_buffer[RFC5444_MAX_PACKET_SIZE];
+
+static struct oonf_subsystem *_sig_subsystem;
+static struct cfg_db *_db;
+
+static uint64_t _now;
+static int _hash_calls;
+static int _received;
+static int _hash_calls_at_first_message;
+
+/* stubs for the rfc5444, telnet and clock subsystem */
+struct oonf_rfc5444_protocol *
+oonf_rfc5444_add_protocol(const char *name __attribute__((unused)), bool fixed_local_port __attribute__((unused))) {
+  return &_protocol;
+}
+
+void
+oonf_rfc5444_remove_protocol(struct oonf_rfc5444_protocol *protocol __attribute__((unused))) {}
+
+const union netaddr_socket *
+oonf_rfc5444_target_get_local_socket(struct oonf_rfc5444_target *target __attribute__((unused))) {
+  return NULL;
+}
+
+int
+oonf_telnet_add(struct oonf_telnet_command *command __attribute__((unused))) {
+  return 0;
+}
+
+void
+oonf_telnet_remove(struct oonf_telnet_command *command __attribute__((unused))) {}
+
+uint64_t
+oonf_clock_getNow(void) {
+  return _now;
+}
+
+static uint32_t
+_fnv1a(const uint8_t *src, size_t src_len) {
+  uint32_t h = 2166136261u;
+  size_t i;
+
+  for (i = 0; i < src_len; i++) {
+    h = (h ^ src[i]) * 16777619u;
+  }
+  return h;
+}
+
+static void
+_xor_key(uint8_t *dst, const void *key, size_t key_len) {
+  const uint8_t *k = key;
+  size_t i;
+
+  for (i = 0; key_len > 0 && i < ICV_LENGTH; i++) {
+    dst[i] ^= k[i % key_len];
+  }
+}
+
+static int
+_cb_test_hash(struct rfc7182_hash *hash __attribute__((unused)), void *dst, size_t *dst_len, const void *src,
+  size_t src_len) {
+  uint32_t h;
+  uint8_t *d = dst;
+
+  __sync_fetch_and_add(&_hash_calls, 1);
+
+  h = _fnv1a(src, src_len);
+  d[0] = h >> 24;
+  d[1] = h >> 16;
+  d[2] = h >> 8;
+  d[3] = h;
+  *dst_len = ICV_LENGTH;
+  return 0;
+}
+
+static int
+_cb_test_encrypt(struct rfc7182_crypt *crypt __attribute__((unused)), void *dst, size_t *dst_len, const void *src,
+  size_t src_len, const void *key, size_t key_len) {
+  if (src_len != ICV_LENGTH) {
+    return -1;
+  }
+  memcpy(dst, src, ICV_LENGTH);
+  _xor_key(dst, key, key_len);
+  *dst_len = ICV_LENGTH;
+  return 0;
+}
+
+static size_t
+_cb_test_signsize(struct rfc7182_crypt *crypt __attribute__((unused)), struct rfc7182_hash *hash __attribute__((unused))) {
+  return ICV_LENGTH;
+}
+
+static bool
+_cb_is_matching_signature(struct rfc5444_signature *sig __attribute__((unused)), int msg_type) {
+  return msg_type == MSG_TYPE;
+}
+
+static const void *
+_cb_get_crypto_key(struct rfc5444_signature *sig __attribute__((unused)), size_t *length) {
+  *length = strlen(_key);
+  return _key;
+}
+
+static enum rfc5444_result
+_cb_test_message(struct rfc5444_reader_tlvblock_context *context __attribute__((unused))) {
+  if (_received++ == 0) {
+    _hash_calls_at_first_message = _hash_calls;
+  }
+  return RFC5444_OKAY;
+}
+
+/**
+ * Write a signed test message
+ * @param dst output buffer, SIGNED_MSG_LENGTH bytes
+ * @param seqno message sequence number
+ * @param hoplimit message hoplimit, not part of the signature
+ * @param payload value of the unsigned message TLV
+ * @param key key used for signing
+ * @param valid false to generate a bad signature
+ */
+static void
+_write_message(uint8_t *dst, uint16_t seqno, uint8_t hoplimit, uint8_t payload, const char *key, bool valid) {
+  uint8_t data[3 + UNSIGNED_MSG_LENGTH];
+  uint8_t *msg;
+  uint32_t h;
+
+  /* signature TLV prefix: hash, crypt, key-id length */
+  data[0] = RFC7182_ICV_HASH_SHA_256;
+  data[1] = RFC7182_ICV_CRYPT_HMAC;
+  data[2] = 0;
+
+  /* unsigned message with zero hoplimit/hopcount */
+  msg = &data[3];
+  msg[0] = MSG_TYPE;
+  msg[1] = RFC5444_MSG_FLAG_ORIGINATOR | RFC5444_MSG_FLAG_HOPLIMIT | RFC5444_MSG_FLAG_HOPCOUNT |
+           RFC5444_MSG_FLAG_SEQNO | (sizeof(_originator) - 1);
+  msg[2] = 0;
+  msg[3] = UNSIGNED_MSG_LENGTH;
+  memcpy(&msg[4], _originator, sizeof(_originator));
+  msg[8] = 0;
+  msg[9] = 0;
+  msg[10] = seqno >> 8;
+  msg[11] = seqno & 255;
+  msg[12] = 0;
+  msg[13] = 4;
+  msg[14] = 200;
+  msg[15] = RFC5444_TLV_FLAG_VALUE;
+  msg[16] = 1;
+  msg[17] = payload;
+
+  /* signed message, signature TLV is sorted in front of the payload TLV */
+  memcpy(dst, msg, 12);
+  dst[3] = SIGNED_MSG_LENGTH;
+  dst[8] = hoplimit;
+  dst[12] = 0;
+  dst[13] = 4 + 11;
+  dst[14] = RFC7182_MSGTLV_ICV;
+  dst[15] = RFC5444_TLV_FLAG_TYPEEXT | RFC5444_TLV_FLAG_VALUE;
+  dst[16] = RFC7182_ICV_EXT_CRYPTHASH;
+  dst[17] = 3 + ICV_LENGTH;
+  memcpy(&dst[18], data, 3);
+
+  h = _fnv1a(data, sizeof(data));
+  dst[21] = h >> 24;
+  dst[22] = h >> 16;
+  dst[23] = h >> 8;
+  dst[24] = h;
+  _xor_key(&dst[21], key, strlen(key));
+  if (!valid) {
+    dst[24] ^= 1;
+  }
+
+  memcpy(&dst[25], &msg[14], 4);
+}
+
+/**
+ * Feed a packet with a single test message into the reader
+ * @param seqno message sequence number
+ * @param hoplimit message hoplimit
+ * @param payload value of unsigned message TLV
+ * @param key key used for signing
+ * @param valid false to generate a bad signature
+ */
+static void
+_receive(uint16_t seqno, uint8_t hoplimit, uint8_t payload, const char *key, bool valid) {
+  uint8_t packet[1 + SIGNED_MSG_LENGTH];
+
+  packet[0] = 0;
+  _write_message(&packet[1], seqno, hoplimit, payload, key, valid);
+  rfc5444_reader_handle_packet(&_protocol.reader, packet, sizeof(packet));
+}
+
+/**
+ * Apply a configuration to the signature plugin
+ * @param workers number of worker threads, NULL for default
+ */
+static void
+_set_config(const char *workers) {
+  cfg_db_remove_sectiontype(_db, OONF_RFC5444_SIG_SUBSYSTEM);
+  if (workers) {
+    cfg_db_set_entry_ext(_db, OONF_RFC5444_SIG_SUBSYSTEM, NULL, "workers", workers, false, false);
+  }
+  _sig_subsystem->cfg_section->post = cfg_db_find_namedsection(_db, OONF_RFC5444_SIG_SUBSYSTEM, NULL);
+  _sig_subsystem->cfg_section->cb_delta_handler();
+}
+
+static void
+clear_elements(void) {
+  _key = "alpha";
+  _hash_calls = 0;
+  _received = 0;
+  _hash_calls_at_first_message = -1;
+
+  /* reset configuration, this flushes the verification cache */
+  _set_config(NULL);
+}
+
+static void
+test_signature(void) {
+  START_TEST();
+
+  _receive(1, 10, 1, "alpha", true);
+  CHECK_TRUE(_received == 1, "valid message was dropped");
+  CHECK_TRUE(_hash_calls == 1, "valid message verified %d times", _hash_calls);
+
+  _receive(2, 10, 1, "alpha", false);
+  CHECK_TRUE(_received == 1, "message with bad signature was not dropped");
+  CHECK_TRUE(_hash_calls == 2, "bad message verified %d times", _hash_calls - 1);
+
+  /* failed verifications are not cached */
+  _receive(2, 9, 1, "alpha", false);
+  CHECK_TRUE(_received == 1, "copy of message with bad signature was not dropped");
+  CHECK_TRUE(_hash_calls == 3, "copy of bad message verified %d times", _hash_calls - 2);
+
+  _receive(3, 10, 1, "bravo", true);
+  CHECK_TRUE(_received == 1, "message with wrong key was not dropped");
+
+  END_TEST();
+}
+
+static void
+test_cache_hit(void) {
+  START_TEST();
+
+  _receive(10, 10, 1, "alpha", true);
+  CHECK_TRUE(_received == 1 && _hash_calls == 1, "first copy: received=%d verified=%d", _received, _hash_calls);
+
+  /* flooded copy with a different hoplimit */
+  _receive(10, 9, 1, "alpha", true);
+  CHECK_TRUE(_received == 2, "cached copy was dropped");
+  CHECK_TRUE(_hash_calls == 1, "cached copy was verified again");
+
+  END_TEST();
+}
+
+static void
+test_cache_miss_data(void) {
+  START_TEST();
+
+  _receive(20, 10, 1, "alpha", true);
+  CHECK_TRUE(_received == 1 && _hash_calls == 1, "first message: received=%d verified=%d", _received, _hash_calls);
+
+  /* same originator and sequence number, but different content */
+  _receive(20, 10, 2, "alpha", true);
+  CHECK_TRUE(_received == 2, "changed message was dropped");
+  CHECK_TRUE(_hash_calls == 2, "changed message was not verified");
+
+  /* both versions of the message are cached */
+  _receive(20, 10, 1, "alpha", true);
+  CHECK_TRUE(_hash_calls == 2, "original message was not cached");
+
+  END_TEST();
+}
+
+static void
+test_cache_miss_key(void) {
+  START_TEST();
+
+  _receive(30, 10, 1, "alpha", true);
+  CHECK_TRUE(_received == 1 && _hash_calls == 1, "first message: received=%d verified=%d", _received, _hash_calls);
+
+  /* key changes, copy signed with the old key must be verified and dropped */
+  _key = "bravo";
+  _receive(30, 9, 1, "alpha", true);
+  CHECK_TRUE(_received == 1, "copy with old key was accepted from cache");
+  CHECK_TRUE(_hash_calls == 2, "copy with old key was not verified");
+
+  _receive(30, 9, 1, "bravo", true);
+  CHECK_TRUE(_received == 2, "copy with new key was dropped");
+  CHECK_TRUE(_hash_calls == 3, "copy with new key was not verified");
+
+  END_TEST();
+}
+
+static void
+test_cache_expiry(void) {
+  START_TEST();
+
+  _receive(40, 10, 1, "alpha", true);
+  CHECK_TRUE(_received == 1 && _hash_calls == 1, "first message: received=%d verified=%d", _received, _hash_calls);
+
+  /* default validity is 10 seconds */
+  _now += 5000;
+  _receive(40, 9, 1, "alpha", true);
+  CHECK_TRUE(_received == 2 && _hash_calls == 1, "copy before expiry: received=%d verified=%d", _received,
+    _hash_calls);
+
+  _now += 6000;
+  _receive(40, 8, 1, "alpha", true);
+  CHECK_TRUE(_received == 3 && _hash_calls == 2, "copy after expiry: received=%d verified=%d", _received,
+    _hash_calls);
+
+  END_TEST();
+}
+
+static void
+test_cache_flush_config(void) {
+  START_TEST();
+
+  _receive(50, 10, 1, "alpha", true);
+  CHECK_TRUE(_received == 1 && _hash_calls == 1, "first message: received=%d verified=%d", _received, _hash_calls);
+
+  _set_config(NULL);
+  _receive(50, 9, 1, "alpha", true);
+  CHECK_TRUE(_received == 2, "copy after config change was dropped");
+  CHECK_TRUE(_hash_calls == 2, "cache was not flushed by config change");
+
+  END_TEST();
+}
+
+static void
+test_packet_batch(const char *workers) {
+  uint8_t packet[1 + 5 * SIGNED_MSG_LENGTH];
+  int i;
+
+  START_TEST();
+
+  _set_config(workers);
+
+  packet[0] = 0;
+  for (i = 0; i < 5; i++) {
+    /* last message has a bad signature */
+    _write_message(&packet[1 + i * SIGNED_MSG_LENGTH], 60 + i, 10, 1, "alpha", i < 4);
+  }
+  rfc5444_reader_handle_packet(&_protocol.reader, packet, sizeof(packet));
+
+  CHECK_TRUE(_received == 4, "received %d of 4 valid messages", _received);
+  CHECK_TRUE(_hash_calls == 5, "verified %d of 5 signatures", _hash_calls);
+  CHECK_TRUE(_hash_calls_at_first_message == 5,
+    "only %d of 5 signatures verified before the first message was parsed", _hash_calls_at_first_message);
+
+  /* all messages are flooded again in a second packet */
+  for (i = 0; i < 5; i++) {
+    packet[1 + i * SIGNED_MSG_LENGTH + 8] = 9;
+  }
+  rfc5444_reader_handle_packet(&_protocol.reader, packet, sizeof(packet));
+
+  CHECK_TRUE(_received == 8, "received %d of 8 valid messages", _received);
+  CHECK_TRUE(_hash_calls == 6, "verified %d of 6 signatures", _hash_calls);
+
+  END_TEST();
+}
+
+static void
+test_broken_packets(void) {
+  uint8_t packet[1 + 3 * SIGNED_MSG_LENGTH];
+  uint8_t broken[sizeof(packet)];
+  size_t length;
+  int i, j;
+
+  START_TEST();
+
+  packet[0] = 0;
+  for (i = 0; i < 3; i++) {
+    _write_message(&packet[1 + i * SIGNED_MSG_LENGTH], 70 + i, 10, 1, "alpha", true);
+  }
+
+  /* the signatures are checked before the reader has validated the packet */
+  srand(1);
+  for (i = 0; i < 5000; i++) {
+    memcpy(broken, packet, sizeof(packet));
+    for (j = rand() % 4; j >= 0; j--) {
+      broken[rand() % sizeof(broken)] = rand();
+    }
+    length = 1 + rand() % sizeof(broken);
+
+    rfc5444_reader_handle_packet(&_protocol.reader, broken, length);
+  }
+
+  /* unmodified packet is still accepted */
+  _received = 0;
+  rfc5444_reader_handle_packet(&_protocol.reader, packet, sizeof(packet));
+  CHECK_TRUE(_received == 3, "received %d of 3 valid messages", _received);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  struct oonf_subsystem *class_subsystem, *provider_subsystem;
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+
+  class_subsystem = oonf_subsystem_get(OONF_CLASS_SUBSYSTEM);
+  provider_subsystem = oonf_subsystem_get(OONF_RFC7182_PROVIDER_SUBSYSTEM);
+  _sig_subsystem = oonf_subsystem_get(OONF_RFC5444_SIG_SUBSYSTEM);
+  if (class_subsystem == NULL || provider_subsystem == NULL || _sig_subsystem == NULL) {
+    oonf_log_cleanup();
+    return 1;
+  }
+
+  _protocol.writer.msg_buffer = _msg_buffer;
+  _protocol.writer.msg_size = sizeof(_msg_buffer);
+  _protocol.writer.addrtlv_buffer = _addrtlv_buffer;
+  _protocol.writer.addrtlv_size = sizeof(_addrtlv_buffer);
+  rfc5444_reader_init(&_protocol.reader);
+  rfc5444_writer_init(&_protocol.writer);
+
+  _protocol.input.src_address = &_src_address;
+
+  _db = cfg_db_add();
+  if (netaddr_from_string(&_src_address, "10.0.0.2") || _db == NULL || class_subsystem->init() || provider_subsystem->init() || _sig_subsystem->init()) {
+    oonf_log_cleanup();
+    return 1;
+  }
+
+  rfc7182_add_hash(&_test_hash);
+  rfc7182_add_crypt(&_test_crypt);
+  rfc5444_sig_add(&_signature);
+  rfc5444_reader_add_message_consumer(&_protocol.reader, &_test_consumer, NULL, 0);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_signature();
+  test_cache_hit();
+  test_cache_miss_data();
+  test_cache_miss_key();
+  test_cache_expiry();
+  test_cache_flush_config();
+  test_packet_batch(NULL);
+  test_packet_batch("4");
+  test_broken_packets();
+
+  result = FINISH_TESTING();
+
+  rfc5444_reader_remove_message_consumer(&_protocol.reader, &_test_consumer);
+  rfc5444_sig_remove(&_signature);
+
+  _sig_subsystem->cleanup();
+  provider_subsystem->cleanup();
+  class_subsystem->cleanup();
+
+  rfc5444_writer_cleanup(&_protocol.writer);
+  rfc5444_reader_cleanup(&_protocol.reader);
+  cfg_db_remove(_db);
+  oonf_log_cleanup();
+  return result;
+}
@@ -0,0 +1,189 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/container_of.h>
+#include <oonf/crypto/rfc5444_signature/worker_pool.h>
+#include <oonf/cunit/cunit.h>
+
+#define JOB_COUNT 1000
+
+struct test_job {
+  struct worker_job job;
+
+  uint32_t input;
+  uint32_t output;
+  int runs;
+};
+
+static struct test_job _test_jobs[JOB_COUNT];
+static struct worker_job *_job_ptrs[JOB_COUNT];
+
+static uint32_t
+_calculate(uint32_t value) {
+  int i;
+
+  /* some work to give the other threads a chance to run */
+  for (i = 0; i < 1000; i++) {
+    value = value * 1103515245u + 12345u;
+  }
+  return value;
+}
+
+static void
+_cb_run(struct worker_job *job) {
+  struct test_job *tj = container_of(job, struct test_job, job);
+
+  tj->output = _calculate(tj->input);
+  tj->runs++;
+}
+
+static void
+clear_elements(void) {
+  size_t i;
+
+  memset(_test_jobs, 0, sizeof(_test_jobs));
+  for (i = 0; i < JOB_COUNT; i++) {
+    _test_jobs[i].job.run = _cb_run;
+    _test_jobs[i].input = rand();
+    _job_ptrs[i] = &_test_jobs[i].job;
+  }
+}
+
+static void
+check_batch(size_t count, int runs) {
+  size_t i;
+
+  for (i = 0; i < count; i++) {
+    CHECK_TRUE(_test_jobs[i].runs == runs, "job %" PRINTF_SIZE_T_SPECIFIER " executed %d times instead of %d", i,
+      _test_jobs[i].runs, runs);
+    CHECK_TRUE(_test_jobs[i].output == _calculate(_test_jobs[i].input),
+      "job %" PRINTF_SIZE_T_SPECIFIER " has wrong result", i);
+  }
+  for (; i < JOB_COUNT; i++) {
+    CHECK_TRUE(_test_jobs[i].runs == 0, "job %" PRINTF_SIZE_T_SPECIFIER " outside of batch executed", i);
+  }
+}
+
+static void
+test_inline(void) {
+  struct worker_pool pool;
+
+  START_TEST();
+
+  CHECK_TRUE(worker_pool_init(&pool, 0) == 0, "could not initialize pool");
+  CHECK_TRUE(pool.threads == 1, "pool has %" PRINTF_SIZE_T_SPECIFIER " threads", pool.threads);
+
+  worker_pool_run(&pool, _job_ptrs, JOB_COUNT);
+  check_batch(JOB_COUNT, 1);
+
+  worker_pool_remove(&pool);
+
+  END_TEST();
+}
+
+static void
+test_threads(size_t threads) {
+  struct worker_pool pool;
+  int i;
+
+  START_TEST();
+
+  CHECK_TRUE(worker_pool_init(&pool, threads) == 0, "could not initialize pool");
+  CHECK_TRUE(pool.threads == threads, "pool has %" PRINTF_SIZE_T_SPECIFIER " threads", pool.threads);
+
+  worker_pool_run(&pool, _job_ptrs, 0);
+  check_batch(0, 0);
+
+  for (i = 1; i <= 20; i++) {
+    worker_pool_run(&pool, _job_ptrs, JOB_COUNT / 2);
+    check_batch(JOB_COUNT / 2, i);
+  }
+
+  worker_pool_remove(&pool);
+
+  END_TEST();
+}
+
+static void
+test_small_batches(void) {
+  struct worker_pool pool;
+  size_t count, i;
+
+  START_TEST();
+
+  CHECK_TRUE(worker_pool_init(&pool, 4) == 0, "could not initialize pool");
+
+  /* more threads than jobs, pool must not lose or repeat a job */
+  for (count = 1; count <= 8; count++) {
+    for (i = 0; i < 100; i++) {
+      worker_pool_run(&pool, _job_ptrs, count);
+    }
+  }
+  for (i = 0; i < 8; i++) {
+    CHECK_TRUE(_test_jobs[i].runs == (int)(100 * (8 - i)), "job %" PRINTF_SIZE_T_SPECIFIER " executed %d times", i,
+      _test_jobs[i].runs);
+  }
+
+  worker_pool_remove(&pool);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  BEGIN_TESTING(clear_elements);
+
+  test_inline();
+  test_threads(2);
+  test_threads(4);
+  test_small_batches();
+
+  return FINISH_TESTING();
+}
@@ -0,0 +1,484 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <arpa/inet.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/avl_comp.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_layer2.h>
+#include <oonf/base/oonf_stream_socket.h>
+#include <oonf/base/oonf_timer.h>
+#include <oonf/base/os_interface.h>
+#include <oonf/generic/dlep/dlep_extension.h>
+#include <oonf/generic/dlep/dlep_session.h>
+#include <oonf/generic/dlep/dlep_writer.h>
+#include <oonf/cunit/cunit.h>
+
+/* TLV ids of the test extension, spread over three TLV table pages */
+enum
+{
+  TLV_MANDATORY = 1,
+  TLV_DUPLICATE = 2,
+  TLV_SINGLE = 300,
+  TLV_LAST = 0xffff,
+};
+
+/* signal of the test extension */
+enum
+{
+  TEST_SIGNAL = 42,
+};
+
+static struct oonf_appdata _appdata = {
+  .app_name = "test_generic_dlep_parser",
+};
+
+static enum dlep_parser_error _cb_process_router(struct dlep_extension *ext, struct dlep_session *session);
+
+static const uint16_t _supported_tlvs[] = { TLV_MANDATORY, TLV_DUPLICATE, TLV_SINGLE, TLV_LAST };
+static const uint16_t _mandatory_tlvs[] = { TLV_MANDATORY };
+static const uint16_t _duplicate_tlvs[] = { TLV_DUPLICATE };
+
+static struct dlep_extension_signal _signals[] = {
+  {
+    .id = TEST_SIGNAL,
+    .supported_tlvs = _supported_tlvs,
+    .supported_tlv_count = ARRAYSIZE(_supported_tlvs),
+    .mandatory_tlvs = _mandatory_tlvs,
+    .mandatory_tlv_count = ARRAYSIZE(_mandatory_tlvs),
+    .duplicate_tlvs = _duplicate_tlvs,
+    .duplicate_tlv_count = ARRAYSIZE(_duplicate_tlvs),
+    .process_router = _cb_process_router,
+  },
+};
+
+static struct dlep_extension_tlv _tlvs[] = {
+  { TLV_MANDATORY, 1, 1 },
+  { TLV_DUPLICATE, 0, 4 },
+  { TLV_SINGLE, 2, 2 },
+  { TLV_LAST, 0, 0 },
+};
+
+static struct dlep_extension _extension = {
+  .id = 1,
+  .name = "test",
+  .signals = _signals,
+  .signal_count = ARRAYSIZE(_signals),
+  .tlvs = _tlvs,
+  .tlv_count = ARRAYSIZE(_tlvs),
+};
+
+static struct avl_tree _extension_tree;
+
+static struct dlep_session _session;
+static struct autobuf _out;
+
+/* signal that is handed to the session */
+static uint8_t _signal[2048];
+static size_t _signal_length;
+
+/* number of signals the extension processed and terminations sent */
+static int _processed;
+static int _terminations;
+
+/* TLVs with a value while the extension processed the last signal */
+static bool _had_value[ARRAYSIZE(_supported_tlvs)];
+
+/* number of values of the duplicate TLV in the last signal */
+static int _duplicate_count;
+
+/* extension database stubs, the test provides a single extension */
+struct avl_tree *
+dlep_extension_get_tree(void) {
+  return &_extension_tree;
+}
+
+/* writer stubs, only termination signals are generated by the session */
+void
+dlep_writer_start_signal(struct dlep_writer *writer __attribute__((unused)), uint16_t signal_type) {
+  if (signal_type == DLEP_SESSION_TERMINATION) {
+    _terminations++;
+  }
+}
+
+int
+dlep_writer_add_status(struct dlep_writer *writer __attribute__((unused)),
+  enum dlep_status status __attribute__((unused)), const char *text __attribute__((unused))) {
+  return 0;
+}
+
+int
+dlep_writer_finish_signal(
+  struct dlep_writer *writer __attribute__((unused)), enum oonf_log_source source __attribute__((unused))) {
+  return 0;
+}
+
+/* interface, timer and stream stubs */
+struct os_interface *
+os_interface_linux_add(struct os_interface_listener *listener __attribute__((unused))) {
+  static struct os_interface interf;
+
+  return &interf;
+}
+
+void
+os_interface_linux_remove(struct os_interface_listener *listener __attribute__((unused))) {}
+
+int
+oonf_layer2_avlcmp_neigh_key(const void *p1, const void *p2) {
+  return memcmp(p1, p2, sizeof(struct oonf_layer2_neigh_key));
+}
+
+const char *
+oonf_layer2_neigh_key_to_string(union oonf_layer2_neigh_key_str *buf,
+  const struct oonf_layer2_neigh_key *key __attribute__((unused)), bool show_mac __attribute__((unused))) {
+  buf->buf[0] = 0;
+  return buf->buf;
+}
+
+struct avl_tree *
+oonf_layer2_get_net_tree(void) {
+  static struct avl_tree tree = { .count = 0 };
+
+  return &tree;
+}
+
+void
+oonf_timer_add(struct oonf_timer_class *info __attribute__((unused))) {}
+
+void
+oonf_timer_stop(struct oonf_timer_instance *timer __attribute__((unused))) {}
+
+void
+oonf_stream_flush(struct oonf_stream_session *con __attribute__((unused))) {}
+
+static enum dlep_parser_error
+_cb_process_router(struct dlep_extension *ext __attribute__((unused)), struct dlep_session *session) {
+  struct dlep_parser_value *value;
+  size_t i;
+
+  _processed++;
+  for (i = 0; i < ARRAYSIZE(_supported_tlvs); i++) {
+    _had_value[i] = dlep_session_get_tlv_value(session, _supported_tlvs[i]) != NULL;
+  }
+
+  _duplicate_count = 0;
+  value = dlep_session_get_tlv_value(session, TLV_DUPLICATE);
+  while (value) {
+    _duplicate_count++;
+    value = dlep_session_get_next_tlv_value(session, value);
+  }
+  return DLEP_NEW_PARSER_OKAY;
+}
+
+static void
+_start_signal(void) {
+  _signal_length = 4;
+}
+
+static void
+_add_tlv(uint16_t type, uint16_t length) {
+  uint16_t value;
+
+  value = htons(type);
+  memcpy(&_signal[_signal_length], &value, sizeof(value));
+  value = htons(length);
+  memcpy(&_signal[_signal_length + 2], &value, sizeof(value));
+  memset(&_signal[_signal_length + 4], 0, length);
+  _signal_length += 4 + length;
+}
+
+static ssize_t
+_process_signal(void) {
+  uint16_t value;
+
+  value = htons(TEST_SIGNAL);
+  memcpy(&_signal[0], &value, sizeof(value));
+  value = htons(_signal_length - 4);
+  memcpy(&_signal[2], &value, sizeof(value));
+
+  _processed = 0;
+  _terminations = 0;
+  memset(_had_value, 0, sizeof(_had_value));
+  _session.restrict_signal = DLEP_ALL_SIGNALS;
+
+  return dlep_session_process_signal(&_session, _signal, _signal_length, false);
+}
+
+static void
+clear_elements(void) {
+  dlep_session_remove(&_session);
+  memset(&_session, 0, sizeof(_session));
+  if (dlep_session_add(&_session, "test0", NULL, NULL, &_out, false, NULL, LOG_MAIN)) {
+    abort();
+  }
+}
+
+static void
+test_mandatory(void) {
+  START_TEST();
+
+  _start_signal();
+  _add_tlv(TLV_MANDATORY, 1);
+  CHECK_TRUE(_process_signal() == (ssize_t)_signal_length, "signal not consumed");
+  CHECK_TRUE(_processed == 1, "signal with mandatory TLV was not processed");
+  CHECK_TRUE(_terminations == 0, "signal with mandatory TLV terminated session");
+
+  _start_signal();
+  _add_tlv(TLV_SINGLE, 2);
+  CHECK_TRUE(_process_signal() == (ssize_t)_signal_length, "signal not consumed");
+  CHECK_TRUE(_processed == 0, "signal without mandatory TLV was processed");
+  CHECK_TRUE(_terminations == 1, "signal without mandatory TLV did not terminate session");
+
+  END_TEST();
+}
+
+static void
+test_duplicate(void) {
+  int i;
+
+  START_TEST();
+
+  _start_signal();
+  _add_tlv(TLV_MANDATORY, 1);
+  _add_tlv(TLV_DUPLICATE, 4);
+  _add_tlv(TLV_SINGLE, 2);
+  _add_tlv(TLV_DUPLICATE, 0);
+  CHECK_TRUE(_process_signal() == (ssize_t)_signal_length, "signal not consumed");
+  CHECK_TRUE(_processed == 1, "signal with allowed duplicate was not processed");
+  CHECK_TRUE(_duplicate_count == 2, "got %d values of duplicate TLV", _duplicate_count);
+
+  _start_signal();
+  _add_tlv(TLV_MANDATORY, 1);
+  _add_tlv(TLV_SINGLE, 2);
+  _add_tlv(TLV_SINGLE, 2);
+  _process_signal();
+  CHECK_TRUE(_processed == 0, "signal with forbidden duplicate was processed");
+  CHECK_TRUE(_terminations == 1, "signal with forbidden duplicate did not terminate session");
+
+  /* more values than the preallocated value storage of the parser */
+  _start_signal();
+  _add_tlv(TLV_MANDATORY, 1);
+  for (i = 0; i < 300; i++) {
+    _add_tlv(TLV_DUPLICATE, 0);
+  }
+  _process_signal();
+  CHECK_TRUE(_processed == 1, "signal with many duplicates was not processed");
+  CHECK_TRUE(_duplicate_count == 300, "got %d values of duplicate TLV", _duplicate_count);
+
+  END_TEST();
+}
+
+static void
+test_generation(void) {
+  START_TEST();
+
+  _start_signal();
+  _add_tlv(TLV_MANDATORY, 1);
+  _add_tlv(TLV_SINGLE, 2);
+  _add_tlv(TLV_LAST, 0);
+  _process_signal();
+  CHECK_TRUE(_processed == 1, "first signal was not processed");
+  CHECK_TRUE(_had_value[2] && _had_value[3], "TLVs of first signal have no value");
+
+  /* values of the last signal must not leak into the next one */
+  _start_signal();
+  _add_tlv(TLV_MANDATORY, 1);
+  _process_signal();
+  CHECK_TRUE(_processed == 1, "second signal was not processed");
+  CHECK_TRUE(_had_value[0], "mandatory TLV of second signal has no value");
+  CHECK_TRUE(!_had_value[2] && !_had_value[3], "TLVs of first signal still have a value");
+
+  /* a TLV without value in this signal must not count as mandatory */
+  _start_signal();
+  _add_tlv(TLV_SINGLE, 2);
+  _process_signal();
+  CHECK_TRUE(_processed == 0, "mandatory TLV of earlier signal was accepted");
+
+  END_TEST();
+}
+
+static void
+test_generation_wraparound(void) {
+  START_TEST();
+
+  /* TLV_SINGLE gets a value in generation 1 */
+  _session.parser._generation = 0;
+  _start_signal();
+  _add_tlv(TLV_MANDATORY, 1);
+  _add_tlv(TLV_SINGLE, 2);
+  _process_signal();
+  CHECK_TRUE(_had_value[2], "TLV has no value in generation 1");
+
+  /* the counter wraps and starts again at generation 1 */
+  _session.parser._generation = UINT32_MAX;
+  _start_signal();
+  _add_tlv(TLV_MANDATORY, 1);
+  _process_signal();
+  CHECK_TRUE(_session.parser._generation == 1, "generation is %u after wraparound", _session.parser._generation);
+  CHECK_TRUE(_processed == 1, "signal after wraparound was not processed");
+  CHECK_TRUE(!_had_value[2], "TLV of old generation 1 has a value after wraparound");
+
+  END_TEST();
+}
+
+static void
+test_add_remove_pages(void) {
+  static const uint16_t ids[] = { 0, 255, 256, 511, 0xff00, 0xffff };
+  struct dlep_session_parser parser;
+  struct dlep_parser_tlv tlvs[ARRAYSIZE(ids)];
+  uint8_t buffer[4];
+  uint16_t value;
+  size_t i;
+
+  START_TEST();
+
+  memset(&parser, 0, sizeof(parser));
+  memset(tlvs, 0, sizeof(tlvs));
+  CHECK_TRUE(dlep_parser_init(&parser) == 0, "parser init failed");
+
+  for (i = 0; i < ARRAYSIZE(ids); i++) {
+    tlvs[i].id = ids[i];
+    tlvs[i].length_max = 0;
+    CHECK_TRUE(dlep_parser_add_tlv(&parser, &tlvs[i]) == 0, "cannot add TLV %u", ids[i]);
+  }
+  CHECK_TRUE(parser.allowed_tlvs.count == ARRAYSIZE(ids), "tree has %u TLVs", parser.allowed_tlvs.count);
+  CHECK_TRUE(parser.tlv_table[1] != NULL, "page of TLV 256 not allocated");
+  CHECK_TRUE(parser.tlv_table[2] == NULL, "unused page allocated");
+
+  for (i = 0; i < ARRAYSIZE(ids); i++) {
+    CHECK_TRUE(dlep_parser_get_tlv(&parser, ids[i]) == &tlvs[i], "lookup of TLV %u failed", ids[i]);
+  }
+  CHECK_TRUE(dlep_parser_get_tlv(&parser, 257) == NULL, "lookup of unknown TLV 257 succeeded");
+  CHECK_TRUE(dlep_parser_get_tlv(&parser, 1024) == NULL, "lookup of TLV 1024 on missing page succeeded");
+
+  /* remove the first TLV of a page, its neighbors stay */
+  dlep_parser_remove_tlv(&parser, &tlvs[2]);
+  CHECK_TRUE(dlep_parser_get_tlv(&parser, 256) == NULL, "removed TLV 256 still found");
+  CHECK_TRUE(dlep_parser_get_tlv(&parser, 255) == &tlvs[1], "TLV 255 lost");
+  CHECK_TRUE(dlep_parser_get_tlv(&parser, 511) == &tlvs[3], "TLV 511 lost");
+  CHECK_TRUE(parser.allowed_tlvs.count == ARRAYSIZE(ids) - 1, "tree has %u TLVs", parser.allowed_tlvs.count);
+
+  /* removed TLV is not accepted by the parser anymore */
+  value = htons(256);
+  memcpy(&buffer[0], &value, sizeof(value));
+  memset(&buffer[2], 0, 2);
+  CHECK_TRUE(dlep_parser_parse_tlvstream(&parser, LOG_MAIN, buffer, sizeof(buffer)) == DLEP_NEW_PARSER_UNSUPPORTED_TLV,
+    "removed TLV was parsed");
+
+  /* add it again, it must get a fresh generation */
+  tlvs[2]._generation = parser._generation;
+  CHECK_TRUE(dlep_parser_add_tlv(&parser, &tlvs[2]) == 0, "cannot add TLV 256 again");
+  CHECK_TRUE(!dlep_parser_has_tlv_value(&parser, &tlvs[2]), "re-added TLV has a value");
+  CHECK_TRUE(dlep_parser_parse_tlvstream(&parser, LOG_MAIN, buffer, sizeof(buffer)) == DLEP_NEW_PARSER_OKAY,
+    "re-added TLV was not parsed");
+  CHECK_TRUE(dlep_parser_has_tlv_value(&parser, &tlvs[2]), "re-added TLV has no value");
+
+  /* broken TLV streams */
+  CHECK_TRUE(dlep_parser_parse_tlvstream(&parser, LOG_MAIN, buffer, 3) == DLEP_NEW_PARSER_INCOMPLETE_TLV_HEADER,
+    "incomplete TLV header accepted");
+  buffer[3] = 1;
+  CHECK_TRUE(dlep_parser_parse_tlvstream(&parser, LOG_MAIN, buffer, sizeof(buffer)) == DLEP_NEW_PARSER_INCOMPLETE_TLV,
+    "incomplete TLV accepted");
+
+  for (i = 0; i < ARRAYSIZE(ids); i++) {
+    dlep_parser_remove_tlv(&parser, &tlvs[i]);
+  }
+  CHECK_TRUE(parser.allowed_tlvs.count == 0, "tree has %u TLVs", parser.allowed_tlvs.count);
+  dlep_parser_cleanup(&parser);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  struct oonf_subsystem *class_subsystem;
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+
+  class_subsystem = oonf_subsystem_get(OONF_CLASS_SUBSYSTEM);
+  if (class_subsystem == NULL || class_subsystem->init()) {
+    oonf_log_cleanup();
+    return 1;
+  }
+
+  avl_init(&_extension_tree, avl_comp_int32, false);
+  _extension._node.key = &_extension.id;
+  avl_insert(&_extension_tree, &_extension._node);
+
+  abuf_init(&_out);
+  dlep_session_init();
+
+  /* the session is removed before it is added the first time */
+  memset(&_session, 0, sizeof(_session));
+  if (dlep_session_add(&_session, "test0", NULL, NULL, &_out, false, NULL, LOG_MAIN)) {
+    return 1;
+  }
+
+  BEGIN_TESTING(clear_elements);
+
+  test_mandatory();
+  test_duplicate();
+  test_generation();
+  test_generation_wraparound();
+  test_add_remove_pages();
+
+  result = FINISH_TESTING();
+
+  dlep_session_remove(&_session);
+  abuf_free(&_out);
+  class_subsystem->cleanup();
+  oonf_log_cleanup();
+  return result;
+}
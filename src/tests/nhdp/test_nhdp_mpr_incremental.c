@@ -0,0 +1,595 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/avl_comp.h>
+#include <oonf/libcommon/list.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcommon/netaddr_hash.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+#include <oonf/nhdp/mpr/neighbor-graph.h>
+#include <oonf/nhdp/mpr/neighbor-graph-routing.h>
+#include <oonf/nhdp/mpr/selection-incremental.h>
+#include <oonf/nhdp/mpr/selection-rfc7181.h>
+#include <oonf/cunit/cunit.h>
+
+#define N1_COUNT 10
+#define N2_COUNT 30
+
+/* two-hop addresses are either pure two-hop addresses or addresses of other neighbors */
+#define Y_COUNT (N2_COUNT + N1_COUNT)
+
+static struct oonf_appdata _appdata = {
+  .app_name = "test_nhdp_mpr_incremental",
+};
+
+/* NHDP database classes, the incremental MPR state extends them */
+static struct oonf_class _neigh_class = {
+  .name = NHDP_CLASS_NEIGHBOR,
+  .size = sizeof(struct nhdp_neighbor),
+};
+
+static struct oonf_class _link_class = {
+  .name = NHDP_CLASS_LINK,
+  .size = sizeof(struct nhdp_link),
+};
+
+static struct oonf_class _naddr_class = {
+  .name = NHDP_CLASS_NEIGHBOR_ADDRESS,
+  .size = sizeof(struct nhdp_naddr),
+};
+
+static struct oonf_class _l2hop_class = {
+  .name = NHDP_CLASS_LINK_2HOP,
+  .size = sizeof(struct nhdp_l2hop),
+};
+
+static struct list_entity _neigh_list;
+static struct netaddr_hash _naddr_hash;
+
+static struct nhdp_domain _domain;
+
+static struct nhdp_neighbor *_neigh[N1_COUNT];
+static struct nhdp_link *_link[N1_COUNT];
+static struct nhdp_naddr *_naddr[N1_COUNT];
+static struct nhdp_l2hop *_l2hop[N1_COUNT][Y_COUNT];
+
+static uint32_t _incremental_updates, _full_updates;
+
+/* NHDP database stubs */
+struct list_entity *
+nhdp_db_get_neigh_list(void) {
+  return &_neigh_list;
+}
+
+struct netaddr_hash *
+nhdp_db_get_naddr_hash(void) {
+  return &_naddr_hash;
+}
+
+static void
+_get_y_addr(struct netaddr *addr, uint32_t y) {
+  uint8_t bin[4];
+
+  bin[0] = 10;
+  bin[1] = y < N2_COUNT ? 1 : 0;
+  bin[2] = 0;
+  bin[3] = y < N2_COUNT ? y : y - N2_COUNT + 1;
+  netaddr_from_binary(addr, bin, 4, AF_INET);
+}
+
+static void
+_add_neighbor(uint32_t x) {
+  struct nhdp_neighbor_domaindata *neighdata;
+  struct nhdp_neighbor *neigh;
+  struct nhdp_naddr *naddr;
+  struct nhdp_link *lnk;
+
+  neigh = oonf_class_malloc(&_neigh_class);
+  _get_y_addr(&neigh->originator, N2_COUNT + x);
+  list_init_head(&neigh->_links);
+  avl_init(&neigh->_neigh_addresses, avl_comp_netaddr, false);
+  neighdata = nhdp_domain_get_neighbordata(&_domain, neigh);
+  neighdata->metric.in = 1000;
+  neighdata->metric.out = 1000;
+  neighdata->willingness = RFC7181_WILLINGNESS_DEFAULT;
+  list_add_tail(&_neigh_list, &neigh->_global_node);
+  oonf_class_event(&_neigh_class, neigh, OONF_OBJECT_ADDED);
+
+  lnk = oonf_class_malloc(&_link_class);
+  lnk->neigh = neigh;
+  avl_init(&lnk->_2hop, avl_comp_netaddr, false);
+  list_add_tail(&neigh->_links, &lnk->_neigh_node);
+  neigh->symmetric = 1;
+  oonf_class_event(&_link_class, lnk, OONF_OBJECT_ADDED);
+
+  naddr = oonf_class_malloc(&_naddr_class);
+  memcpy(&naddr->neigh_addr, &neigh->originator, sizeof(naddr->neigh_addr));
+  naddr->neigh = neigh;
+  naddr->_neigh_node.key = &naddr->neigh_addr;
+  naddr->_global_hash_node.key = &naddr->neigh_addr;
+  avl_insert(&neigh->_neigh_addresses, &naddr->_neigh_node);
+  netaddr_hash_insert(&_naddr_hash, &naddr->_global_hash_node);
+  oonf_class_event(&_naddr_class, naddr, OONF_OBJECT_ADDED);
+
+  _neigh[x] = neigh;
+  _link[x] = lnk;
+  _naddr[x] = naddr;
+}
+
+static void
+_add_l2hop(uint32_t x, uint32_t y, uint32_t metric) {
+  struct nhdp_l2hop *l2hop;
+
+  l2hop = oonf_class_malloc(&_l2hop_class);
+  l2hop->link = _link[x];
+  _get_y_addr(&l2hop->twohop_addr, y);
+  l2hop->_link_node.key = &l2hop->twohop_addr;
+  nhdp_domain_get_l2hopdata(&_domain, l2hop)->metric.in = metric;
+  nhdp_domain_get_l2hopdata(&_domain, l2hop)->metric.out = metric;
+  avl_insert(&_link[x]->_2hop, &l2hop->_link_node);
+  oonf_class_event(&_l2hop_class, l2hop, OONF_OBJECT_ADDED);
+
+  _l2hop[x][y] = l2hop;
+}
+
+static void
+_remove_l2hop(uint32_t x, uint32_t y) {
+  struct nhdp_l2hop *l2hop = _l2hop[x][y];
+
+  oonf_class_event(&_l2hop_class, l2hop, OONF_OBJECT_REMOVED);
+  avl_remove(&_link[x]->_2hop, &l2hop->_link_node);
+  oonf_class_free(&_l2hop_class, l2hop);
+
+  _l2hop[x][y] = NULL;
+}
+
+static void
+_remove_neighbor(uint32_t x) {
+  uint32_t y;
+
+  oonf_class_event(&_neigh_class, _neigh[x], OONF_OBJECT_REMOVED);
+
+  oonf_class_event(&_link_class, _link[x], OONF_OBJECT_REMOVED);
+  for (y = 0; y < Y_COUNT; y++) {
+    if (_l2hop[x][y]) {
+      _remove_l2hop(x, y);
+    }
+  }
+  list_remove(&_link[x]->_neigh_node);
+  oonf_class_free(&_link_class, _link[x]);
+
+  oonf_class_event(&_naddr_class, _naddr[x], OONF_OBJECT_REMOVED);
+  netaddr_hash_remove(&_naddr_hash, &_naddr[x]->_global_hash_node);
+  avl_remove(&_neigh[x]->_neigh_addresses, &_naddr[x]->_neigh_node);
+  oonf_class_free(&_naddr_class, _naddr[x]);
+
+  list_remove(&_neigh[x]->_global_node);
+  oonf_class_free(&_neigh_class, _neigh[x]);
+}
+
+static bool
+_is_allowed(uint32_t x) {
+  struct nhdp_neighbor_domaindata *neighdata;
+
+  if (_neigh[x] == NULL) {
+    return false;
+  }
+  neighdata = nhdp_domain_get_neighbordata(&_domain, _neigh[x]);
+  return neighdata->metric.in <= RFC7181_METRIC_MAX && _neigh[x]->symmetric > 0 &&
+         neighdata->willingness > RFC7181_WILLINGNESS_NEVER;
+}
+
+static bool
+_is_mpr(uint32_t x) {
+  return _neigh[x] != NULL && nhdp_domain_get_neighbordata(&_domain, _neigh[x])->neigh_is_mpr;
+}
+
+/**
+ * @return random metric, including values that only work as one-hop metric
+ */
+static uint32_t
+_random_metric(void) {
+  switch (rand() % 10) {
+    case 0:
+      return RFC7181_METRIC_INFINITE;
+    case 1:
+      return RFC7181_METRIC_MAX;
+    default:
+      return 1000 * (1 + rand() % 4);
+  }
+}
+
+/**
+ * @param x neighbor index
+ * @param y two-hop address index
+ * @return d(x,y), RFC7181_METRIC_INFINITE_PATH if there is no usable path
+ */
+static uint32_t
+_get_d_x_y(uint32_t x, uint32_t y) {
+  uint32_t d2;
+
+  if (!_is_allowed(x) || _l2hop[x][y] == NULL) {
+    return RFC7181_METRIC_INFINITE_PATH;
+  }
+  d2 = nhdp_domain_get_l2hopdata(&_domain, _l2hop[x][y])->metric.in;
+  if (d2 > RFC7181_METRIC_MAX) {
+    return RFC7181_METRIC_INFINITE_PATH;
+  }
+  return nhdp_domain_get_neighbordata(&_domain, _neigh[x])->metric.in + d2;
+}
+
+/**
+ * @param y two-hop address index
+ * @param mpr_only true to calculate d(y,M), false for d(y,N1)
+ * @param exclude neighbor index that is not considered, N1_COUNT for none
+ * @return metric distance
+ */
+static uint32_t
+_get_d_y(uint32_t y, bool mpr_only, uint32_t exclude) {
+  uint32_t x, cost, d;
+
+  d = RFC7181_METRIC_INFINITE_PATH;
+  if (y >= N2_COUNT && _is_allowed(y - N2_COUNT)) {
+    d = nhdp_domain_get_neighbordata(&_domain, _neigh[y - N2_COUNT])->metric.in;
+  }
+
+  for (x = 0; x < N1_COUNT; x++) {
+    if (x == exclude || (mpr_only && !_is_mpr(x))) {
+      continue;
+    }
+    cost = _get_d_x_y(x, y);
+    if (cost < d) {
+      d = cost;
+    }
+  }
+  return d;
+}
+
+static bool
+_is_in_n2(uint32_t y) {
+  uint32_t x;
+
+  for (x = 0; x < N1_COUNT; x++) {
+    if (_get_d_x_y(x, y) != RFC7181_METRIC_INFINITE_PATH) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Run the MPR calculation the way the MPR plugin does
+ */
+static void
+_update_mpr(void) {
+  struct neighbor_graph graph;
+  struct n1_node *node;
+  uint32_t x;
+
+  if (mpr_incremental_update_routing(&_domain)) {
+    _incremental_updates++;
+    return;
+  }
+
+  _full_updates++;
+  memset(&graph, 0, sizeof(graph));
+  mpr_calculate_neighbor_graph_routing(&_domain, &graph);
+  mpr_calculate_mpr_rfc7181(&_domain, &graph);
+
+  for (x = 0; x < N1_COUNT; x++) {
+    if (_neigh[x] == NULL) {
+      continue;
+    }
+    node = avl_find_element(&graph.set_mpr, &_neigh[x]->originator, node, _avl_node);
+    nhdp_domain_get_neighbordata(&_domain, _neigh[x])->neigh_is_mpr = node != NULL;
+  }
+  mpr_clear_neighbor_graph(&graph);
+
+  mpr_incremental_commit_routing(&_domain);
+}
+
+/**
+ * Compare the incremental MPR set with the neighborhood seen by
+ * the RFC7181 selection and check the properties of section 18.3
+ * @return true if the MPR set is correct
+ */
+static bool
+_check_mpr_set(void) {
+  struct neighbor_graph graph;
+  struct addr_node *node_n2;
+  struct netaddr addr;
+  uint32_t x, y, n2_count, d_rfc, d_y_n1, d_y_mpr;
+  bool necessary, ok;
+
+  ok = true;
+
+  /* the RFC7181 selection must see the same N2 set and costs */
+  memset(&graph, 0, sizeof(graph));
+  mpr_calculate_neighbor_graph_routing(&_domain, &graph);
+  mpr_calculate_mpr_rfc7181(&_domain, &graph);
+
+  n2_count = 0;
+  for (y = 0; y < Y_COUNT; y++) {
+    if (!_is_in_n2(y)) {
+      continue;
+    }
+    n2_count++;
+
+    _get_y_addr(&addr, y);
+    node_n2 = avl_find_element(&graph.set_n2, &addr, node_n2, _avl_node);
+    d_y_n1 = _get_d_y(y, false, N1_COUNT);
+    d_y_mpr = _get_d_y(y, true, N1_COUNT);
+
+    CHECK_TRUE(node_n2 != NULL, "address %u missing in RFC7181 N2", y);
+    if (node_n2 == NULL) {
+      ok = false;
+      continue;
+    }
+
+    d_rfc = mpr_calculate_d_of_y_s(&_domain, &graph, node_n2, &graph.set_mpr);
+    CHECK_TRUE(d_rfc == d_y_n1, "RFC7181 d(y,M) of %u is %u, d(y,N1) is %u", y, d_rfc, d_y_n1);
+    CHECK_TRUE(d_y_mpr == d_y_n1, "incremental d(y,M) of %u is %u, d(y,N1) is %u", y, d_y_mpr, d_y_n1);
+    ok &= d_rfc == d_y_n1 && d_y_mpr == d_y_n1;
+  }
+  CHECK_TRUE(n2_count == graph.set_n2.count, "N2 has %u addresses, RFC7181 N2 has %u", n2_count, graph.set_n2.count);
+  ok &= n2_count == graph.set_n2.count;
+  mpr_clear_neighbor_graph(&graph);
+
+  for (x = 0; x < N1_COUNT; x++) {
+    if (!_is_mpr(x)) {
+      CHECK_TRUE(!_is_allowed(x) || nhdp_domain_get_neighbordata(&_domain, _neigh[x])->willingness !=
+                                      RFC7181_WILLINGNESS_ALWAYS, "neighbor %u with willingness always is no MPR", x);
+      continue;
+    }
+
+    CHECK_TRUE(_is_allowed(x), "neighbor %u outside of N1 is MPR", x);
+    ok &= _is_allowed(x);
+    if (nhdp_domain_get_neighbordata(&_domain, _neigh[x])->willingness == RFC7181_WILLINGNESS_ALWAYS) {
+      continue;
+    }
+
+    /* each MPR must be necessary for at least one two-hop address */
+    necessary = false;
+    for (y = 0; y < Y_COUNT && !necessary; y++) {
+      if (_get_d_x_y(x, y) != RFC7181_METRIC_INFINITE_PATH) {
+        necessary = _get_d_y(y, true, x) > _get_d_y(y, false, N1_COUNT);
+      }
+    }
+    CHECK_TRUE(necessary, "MPR %u is not necessary", x);
+    ok &= necessary;
+  }
+  return ok;
+}
+
+static void
+clear_elements(void) {
+  uint32_t x;
+
+  for (x = 0; x < N1_COUNT; x++) {
+    if (_neigh[x]) {
+      _remove_neighbor(x);
+    }
+  }
+  memset(_neigh, 0, sizeof(_neigh));
+  memset(_l2hop, 0, sizeof(_l2hop));
+
+  /* start with a full calculation */
+  _update_mpr();
+  _incremental_updates = 0;
+  _full_updates = 0;
+  srand(42);
+}
+
+static void
+test_remove_unnecessary_mpr(void) {
+  uint32_t y;
+
+  START_TEST();
+
+  /* neighbor 0 and 1 reach address 0, neighbor 2 reaches the rest */
+  _add_neighbor(0);
+  _add_neighbor(1);
+  _add_neighbor(2);
+  nhdp_domain_get_neighbordata(&_domain, _neigh[1])->metric.in = 2000;
+  _add_l2hop(0, 0, 1000);
+  _add_l2hop(1, 0, 1000);
+  for (y = 1; y < 8; y++) {
+    _add_l2hop(2, y, 1000);
+  }
+  _update_mpr();
+
+  CHECK_TRUE(_is_mpr(0) && !_is_mpr(1) && _is_mpr(2), "initial MPR set %d/%d/%d", _is_mpr(0), _is_mpr(1), _is_mpr(2));
+
+  /* neighbor 1 becomes the better path to address 0 */
+  nhdp_domain_get_neighbordata(&_domain, _neigh[1])->metric.in = 500;
+  oonf_class_event(&_neigh_class, _neigh[1], OONF_OBJECT_CHANGED);
+  _update_mpr();
+
+  CHECK_TRUE(_incremental_updates == 1, "%u incremental updates", _incremental_updates);
+  CHECK_TRUE(!_is_mpr(0) && _is_mpr(1) && _is_mpr(2), "repaired MPR set %d/%d/%d", _is_mpr(0), _is_mpr(1), _is_mpr(2));
+
+  /* a two-hop metric change moves the MPR back */
+  nhdp_domain_get_l2hopdata(&_domain, _l2hop[1][0])->metric.in = 5000;
+  oonf_class_event(&_l2hop_class, _l2hop[1][0], OONF_OBJECT_CHANGED);
+  _update_mpr();
+
+  CHECK_TRUE(_incremental_updates == 2, "%u incremental updates", _incremental_updates);
+  CHECK_TRUE(_is_mpr(0) && !_is_mpr(1) && _is_mpr(2), "repaired MPR set %d/%d/%d", _is_mpr(0), _is_mpr(1), _is_mpr(2));
+  _check_mpr_set();
+
+  END_TEST();
+}
+
+static void
+test_random_changes(void) {
+  struct nhdp_neighbor_domaindata *neighdata;
+  struct nhdp_l2hop_domaindata *l2hopdata;
+  uint32_t i, x, y;
+
+  START_TEST();
+
+  for (x = 0; x < N1_COUNT; x++) {
+    _add_neighbor(x);
+  }
+  for (x = 0; x < N1_COUNT; x++) {
+    for (y = 0; y < Y_COUNT; y++) {
+      if (y != N2_COUNT + x && rand() % 4 == 0) {
+        _add_l2hop(x, y, _random_metric());
+      }
+    }
+  }
+  _update_mpr();
+  CHECK_TRUE(_check_mpr_set(), "initial MPR set");
+
+  for (i = 0; i < 2000; i++) {
+    x = rand() % N1_COUNT;
+    y = rand() % Y_COUNT;
+    neighdata = nhdp_domain_get_neighbordata(&_domain, _neigh[x]);
+
+    switch (rand() % 6) {
+      case 0:
+        neighdata->metric.in = _random_metric();
+        oonf_class_event(&_neigh_class, _neigh[x], OONF_OBJECT_CHANGED);
+        break;
+      case 1:
+        neighdata->willingness = rand() % (RFC7181_WILLINGNESS_ALWAYS + 1);
+        oonf_class_event(&_neigh_class, _neigh[x], OONF_OBJECT_CHANGED);
+        break;
+      case 2:
+        _neigh[x]->symmetric = _neigh[x]->symmetric ? 0 : 1;
+        oonf_class_event(&_link_class, _link[x], OONF_OBJECT_CHANGED);
+        break;
+      case 3:
+        if (_l2hop[x][y]) {
+          l2hopdata = nhdp_domain_get_l2hopdata(&_domain, _l2hop[x][y]);
+          l2hopdata->metric.in = _random_metric();
+          oonf_class_event(&_l2hop_class, _l2hop[x][y], OONF_OBJECT_CHANGED);
+        }
+        break;
+      case 4:
+        if (!_l2hop[x][y] && y != N2_COUNT + x) {
+          _add_l2hop(x, y, _random_metric());
+        }
+        break;
+      default:
+        if (_l2hop[x][y]) {
+          _remove_l2hop(x, y);
+        }
+        break;
+    }
+
+    /* the MPR set is not recalculated after every change */
+    if (rand() % 2 == 0) {
+      continue;
+    }
+
+    _update_mpr();
+    if (!_check_mpr_set()) {
+      break;
+    }
+  }
+
+  CHECK_TRUE(_incremental_updates > _full_updates, "only %u of %u updates were incremental", _incremental_updates,
+    _incremental_updates + _full_updates);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  struct oonf_subsystem *class_subsystem;
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+
+  class_subsystem = oonf_subsystem_get(OONF_CLASS_SUBSYSTEM);
+  if (class_subsystem == NULL || class_subsystem->init()) {
+    oonf_log_cleanup();
+    return 1;
+  }
+
+  oonf_class_add(&_neigh_class);
+  oonf_class_add(&_link_class);
+  oonf_class_add(&_naddr_class);
+  oonf_class_add(&_l2hop_class);
+
+  list_init_head(&_neigh_list);
+  netaddr_hash_init(&_naddr_hash);
+  _domain.index = 0;
+
+  if (mpr_incremental_init()) {
+    return 1;
+  }
+
+  BEGIN_TESTING(clear_elements);
+
+  test_remove_unnecessary_mpr();
+  test_random_changes();
+
+  result = FINISH_TESTING();
+
+  clear_elements();
+  mpr_incremental_cleanup();
+  netaddr_hash_free(&_naddr_hash);
+
+  oonf_class_remove(&_l2hop_class);
+  oonf_class_remove(&_naddr_class);
+  oonf_class_remove(&_link_class);
+  oonf_class_remove(&_neigh_class);
+
+  class_subsystem->cleanup();
+  oonf_log_cleanup();
+  return result;
+}
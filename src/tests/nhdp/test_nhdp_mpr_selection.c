@@ -0,0 +1,282 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+#include <oonf/nhdp/mpr/neighbor-graph.h>
+#include <oonf/nhdp/mpr/selection-bitset.h>
+#include <oonf/nhdp/mpr/selection-rfc7181.h>
+#include <oonf/cunit/cunit.h>
+
+#define MAX_N1 48
+#define MAX_N2 300
+
+static struct nhdp_domain domain;
+static struct nhdp_neighbor neighbors[MAX_N1];
+
+static uint32_t d1_x[MAX_N1];
+static uint32_t willingness[MAX_N1];
+static uint32_t d2_x_y[MAX_N1][MAX_N2];
+static uint32_t d1_y[MAX_N2];
+
+static uint32_t
+_get_n1_index(struct n1_node *x) {
+  return x->neigh - neighbors;
+}
+
+static uint32_t
+_get_n2_index(struct addr_node *y) {
+  const uint8_t *bin = netaddr_get_binptr(&y->addr);
+  return (bin[2] << 8) | bin[3];
+}
+
+static bool
+_is_allowed_link_tuple(const struct nhdp_domain *d __attribute__((unused)),
+    struct nhdp_interface *current_interface __attribute__((unused)),
+    struct nhdp_link *lnk __attribute__((unused))) {
+  return true;
+}
+
+static uint32_t
+_calculate_d1_x_of_n2_addr(const struct nhdp_domain *d __attribute__((unused)),
+    struct neighbor_graph *graph __attribute__((unused)), struct addr_node *y) {
+  return d1_y[_get_n2_index(y)];
+}
+
+static uint32_t
+_calculate_d2_x_y(const struct nhdp_domain *d __attribute__((unused)), struct n1_node *x, struct addr_node *y) {
+  return d2_x_y[_get_n1_index(x)][_get_n2_index(y)];
+}
+
+static uint32_t
+_calculate_d_x_y(const struct nhdp_domain *d, struct neighbor_graph *graph,
+    struct n1_node *x, struct addr_node *y) {
+  uint32_t cost, *cache;
+
+  cache = &graph->d_x_y_cache[x->table_offset + y->table_offset];
+  if (*cache == 0) {
+    cost = _calculate_d2_x_y(d, x, y);
+    *cache = cost > RFC7181_METRIC_MAX ? RFC7181_METRIC_INFINITE_PATH : d1_x[_get_n1_index(x)] + cost;
+  }
+  return *cache;
+}
+
+static uint32_t
+_get_willingness_n1(const struct nhdp_domain *d __attribute__((unused)), struct n1_node *x) {
+  return willingness[_get_n1_index(x)];
+}
+
+static struct neighbor_graph_interface _methods = {
+  .is_allowed_link_tuple = _is_allowed_link_tuple,
+  .calculate_d1_x_of_n2_addr = _calculate_d1_x_of_n2_addr,
+  .calculate_d_x_y = _calculate_d_x_y,
+  .calculate_d2_x_y = _calculate_d2_x_y,
+  .get_willingness_n1 = _get_willingness_n1,
+};
+
+/**
+ * Create a random neighborhood. Metrics are taken from a small set
+ * of values to produce many ties between possible MPRs.
+ */
+static void
+_random_neighborhood(uint32_t n1_count, uint32_t n2_count, int link_percent) {
+  uint8_t bin[4];
+  uint32_t x, y;
+
+  memset(neighbors, 0, sizeof(neighbors));
+  for (x = 0; x < n1_count; x++) {
+    bin[0] = 10;
+    bin[1] = 0;
+    bin[2] = 0;
+    bin[3] = x + 1;
+    netaddr_from_binary(&neighbors[x].originator, bin, 4, AF_INET);
+
+    d1_x[x] = 1000 * (1 + rand() % 4);
+    willingness[x] = (rand() % 10) == 0 ? RFC7181_WILLINGNESS_ALWAYS : 1 + rand() % 6;
+  }
+
+  for (y = 0; y < n2_count; y++) {
+    /* some two-hop addresses are also one-hop neighbors */
+    d1_y[y] = (rand() % 8) == 0 ? 1000 * (1 + rand() % 8) : RFC7181_METRIC_INFINITE;
+
+    for (x = 0; x < n1_count; x++) {
+      d2_x_y[x][y] = (rand() % 100) < link_percent ? 1000 * (1 + rand() % 4) : RFC7181_METRIC_INFINITE;
+    }
+  }
+}
+
+static void
+_create_graph(struct neighbor_graph *graph, uint32_t n1_count, uint32_t n2_count) {
+  struct netaddr addr;
+  uint8_t bin[4];
+  uint32_t x, y;
+  bool reachable;
+
+  memset(graph, 0, sizeof(*graph));
+  mpr_init_neighbor_graph(graph, &_methods);
+
+  for (x = 0; x < n1_count; x++) {
+    /* reset temporary selection state */
+    neighbors[x].selection_is_mpr = false;
+    mpr_add_n1_node_to_set(&graph->set_n1, &neighbors[x], NULL, 0);
+  }
+  for (y = 0; y < n2_count; y++) {
+    reachable = false;
+    for (x = 0; x < n1_count; x++) {
+      reachable |= d2_x_y[x][y] <= RFC7181_METRIC_MAX;
+    }
+    if (!reachable) {
+      continue;
+    }
+
+    bin[0] = 10;
+    bin[1] = 1;
+    bin[2] = y >> 8;
+    bin[3] = y & 255;
+    netaddr_from_binary(&addr, bin, 4, AF_INET);
+    mpr_add_addr_node_to_set(&graph->set_n2, addr, 0);
+  }
+}
+
+static bool
+_compare_mpr_sets(uint32_t n1_count, uint32_t n2_count, int link_percent) {
+  struct neighbor_graph avl_graph, bitset_graph;
+  struct n1_node *n1_avl, *n1_bitset;
+  struct netaddr_str nbuf;
+  bool equal;
+
+  _random_neighborhood(n1_count, n2_count, link_percent);
+
+  _create_graph(&avl_graph, n1_count, n2_count);
+  mpr_calculate_mpr_rfc7181(&domain, &avl_graph);
+
+  _create_graph(&bitset_graph, n1_count, n2_count);
+  CHECK_TRUE(mpr_calculate_mpr_bitset(&domain, &bitset_graph) == 0, "bitset MPR calculation failed");
+
+  equal = avl_graph.set_mpr.count == bitset_graph.set_mpr.count;
+  CHECK_TRUE(equal, "MPR set size differs (n1=%u, n2=%u): avl=%u bitset=%u",
+      n1_count, n2_count, avl_graph.set_mpr.count, bitset_graph.set_mpr.count);
+
+  if (equal) {
+    n1_bitset = avl_first_element(&bitset_graph.set_mpr, n1_bitset, _avl_node);
+    avl_for_each_element(&avl_graph.set_mpr, n1_avl, _avl_node) {
+      if (netaddr_cmp(&n1_avl->addr, &n1_bitset->addr) != 0) {
+        equal = false;
+        CHECK_TRUE(equal, "MPR sets differ (n1=%u, n2=%u): avl %s",
+            n1_count, n2_count, netaddr_to_string(&nbuf, &n1_avl->addr));
+        break;
+      }
+      n1_bitset = avl_next_element(n1_bitset, _avl_node);
+    }
+  }
+
+  mpr_clear_neighbor_graph(&avl_graph);
+  mpr_clear_neighbor_graph(&bitset_graph);
+  return equal;
+}
+
+static void
+clear_elements(void) {
+  srand(42);
+}
+
+static void
+test_empty(void) {
+  START_TEST();
+
+  CHECK_TRUE(_compare_mpr_sets(0, 0, 0), "empty neighborhood");
+  CHECK_TRUE(_compare_mpr_sets(5, 0, 0), "neighborhood without two-hop neighbors");
+
+  END_TEST();
+}
+
+static void
+test_small_random(void) {
+  int i;
+
+  START_TEST();
+
+  for (i = 0; i < 500; i++) {
+    if (!_compare_mpr_sets(1 + rand() % 8, 1 + rand() % 20, 10 + rand() % 60)) {
+      break;
+    }
+  }
+
+  END_TEST();
+}
+
+static void
+test_dense_random(void) {
+  int i;
+
+  START_TEST();
+
+  for (i = 0; i < 20; i++) {
+    if (!_compare_mpr_sets(MAX_N1 / 2 + rand() % (MAX_N1 / 2), 64 + rand() % (MAX_N2 - 64), 2 + rand() % 20)) {
+      break;
+    }
+  }
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  domain.index = 0;
+
+  BEGIN_TESTING(clear_elements);
+
+  test_empty();
+  test_small_random();
+  test_dense_random();
+
+  return FINISH_TESTING();
+}
@@ -0,0 +1,756 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/autobuf.h>
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/avl_comp.h>
+#include <oonf/libcommon/list.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcommon/string.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_stream_socket.h>
+#include <oonf/base/oonf_telnet.h>
+#include <oonf/base/oonf_timer.h>
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_lan.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_originator.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_routing.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
+#include <oonf/olsrv2/netjsoninfo/netjsoninfo.h>
+#include <oonf/cunit/cunit.h>
+
+#define NODE_COUNT 200
+
+static struct oonf_appdata _appdata = {
+  .app_name = "test_olsrv2_netjsoninfo",
+};
+
+static struct oonf_stream_managed *_telnet_managed;
+
+static struct nhdp_domain_metric _metric = {
+  .name = "test metric",
+};
+static struct nhdp_domain_mpr _mpr = {
+  .name = "test mpr",
+};
+static struct nhdp_domain _domain;
+static struct list_entity _domain_list;
+static struct list_entity _link_list;
+static struct avl_tree _neigh_tree;
+static struct avl_tree _lan_tree;
+static struct avl_tree _tc_tree;
+static struct avl_tree _routing_tree;
+static struct netaddr _originator;
+
+static uint16_t _ansn;
+static uint32_t _generation;
+static bool _change_during_output;
+
+static struct olsrv2_tc_node *_node[NODE_COUNT];
+
+/* stream socket stubs, the test sends the output buffer itself */
+void
+oonf_stream_add_managed(struct oonf_stream_managed *managed) {
+  _telnet_managed = managed;
+}
+
+int
+oonf_stream_apply_managed(
+  struct oonf_stream_managed *managed __attribute__((unused)), struct oonf_stream_managed_config *config
+  __attribute__((unused))) {
+  return 0;
+}
+
+void
+oonf_stream_remove_managed(struct oonf_stream_managed *managed __attribute__((unused)), bool force
+  __attribute__((unused))) {}
+
+void
+oonf_stream_free_managed_config(struct oonf_stream_managed_config *config __attribute__((unused))) {}
+
+void
+oonf_stream_flush(struct oonf_stream_session *con __attribute__((unused))) {}
+
+void
+oonf_stream_set_timeout(struct oonf_stream_session *con __attribute__((unused)), uint64_t timeout
+  __attribute__((unused))) {}
+
+/* timer stubs, timers never fire */
+void
+oonf_timer_add(struct oonf_timer_class *ti __attribute__((unused))) {}
+
+void
+oonf_timer_remove(struct oonf_timer_class *ti __attribute__((unused))) {}
+
+void
+oonf_timer_start_ext(struct oonf_timer_instance *timer, uint64_t first, uint64_t interval) {
+  timer->_clock = first;
+  timer->_period = interval;
+}
+
+void
+oonf_timer_stop(struct oonf_timer_instance *timer) {
+  timer->_clock = 0;
+}
+
+/* NHDP stubs */
+struct list_entity *
+nhdp_domain_get_list(void) {
+  return &_domain_list;
+}
+
+struct list_entity *
+nhdp_db_get_link_list(void) {
+  return &_link_list;
+}
+
+struct avl_tree *
+nhdp_db_get_neigh_originator_tree(void) {
+  return &_neigh_tree;
+}
+
+/* OLSRv2 stubs */
+const struct netaddr *
+olsrv2_originator_get(int af_type) {
+  return af_type == AF_INET ? &_originator : &NETADDR_UNSPEC;
+}
+
+struct avl_tree *
+olsrv2_lan_get_tree(void) {
+  return &_lan_tree;
+}
+
+struct avl_tree *
+olsrv2_tc_get_tree(void) {
+  if (_change_during_output) {
+    /* topology changes while the output is generated */
+    _generation++;
+  }
+  return &_tc_tree;
+}
+
+struct avl_tree *
+olsrv2_routing_get_tree(struct nhdp_domain *domain __attribute__((unused))) {
+  return &_routing_tree;
+}
+
+uint16_t
+olsrv2_routing_get_ansn(void) {
+  return _ansn;
+}
+
+uint32_t
+olsrv2_routing_get_topology_generation(struct nhdp_domain *domain __attribute__((unused))) {
+  return _generation;
+}
+
+static const char *
+_cb_link_to_string(struct nhdp_metric_str *buf, uint32_t cost) {
+  snprintf(buf->buf, sizeof(*buf), "%u", cost);
+  return buf->buf;
+}
+
+static const char *
+_cb_path_to_string(struct nhdp_metric_str *buf, uint32_t cost, uint8_t hopcount) {
+  snprintf(buf->buf, sizeof(*buf), "%u/%u", cost, hopcount);
+  return buf->buf;
+}
+
+static void
+_get_addr(struct netaddr *addr, uint32_t i) {
+  uint8_t bin[4];
+
+  bin[0] = 10;
+  bin[1] = 2;
+  bin[2] = i >> 8;
+  bin[3] = i & 255;
+  netaddr_from_binary(addr, bin, 4, AF_INET);
+}
+
+static void
+_add_edge(struct olsrv2_tc_node *src, struct olsrv2_tc_node *dst, uint32_t cost) {
+  struct olsrv2_tc_edge *edge, *inverse;
+
+  edge = calloc(1, sizeof(*edge));
+  inverse = calloc(1, sizeof(*inverse));
+
+  edge->src = src;
+  edge->dst = dst;
+  edge->inverse = inverse;
+  edge->cost[0] = cost;
+  edge->_node.key = &dst->target.prefix.dst;
+  avl_insert(&src->_edges, &edge->_node);
+
+  inverse->src = dst;
+  inverse->dst = src;
+  inverse->inverse = edge;
+  inverse->cost[0] = cost;
+  inverse->_node.key = &src->target.prefix.dst;
+  avl_insert(&dst->_edges, &inverse->_node);
+}
+
+static void
+_add_nodes(void) {
+  uint32_t i;
+
+  for (i = 0; i < NODE_COUNT; i++) {
+    _node[i] = calloc(1, sizeof(*_node[i]));
+    _get_addr(&_node[i]->target.prefix.dst, i + 1);
+    _node[i]->_originator_node.key = &_node[i]->target.prefix.dst;
+    avl_init(&_node[i]->_edges, avl_comp_netaddr, false);
+    avl_init(&_node[i]->_attached_networks, os_routing_avl_cmp_route_key, false);
+    avl_insert(&_tc_tree, &_node[i]->_originator_node);
+  }
+  for (i = 1; i < NODE_COUNT; i++) {
+    _add_edge(_node[i - 1], _node[i], 1000 + i);
+  }
+  _generation++;
+}
+
+static void
+_remove_node(uint32_t i) {
+  struct olsrv2_tc_edge *edge, *it;
+
+  avl_for_each_element_safe(&_node[i]->_edges, edge, _node, it) {
+    avl_remove(&edge->dst->_edges, &edge->inverse->_node);
+    avl_remove(&_node[i]->_edges, &edge->_node);
+    free(edge->inverse);
+    free(edge);
+  }
+  avl_remove(&_tc_tree, &_node[i]->_originator_node);
+  free(_node[i]);
+  _node[i] = NULL;
+  _generation++;
+}
+
+static struct oonf_class *
+_get_class(const char *name) {
+  struct oonf_class *c;
+
+  return avl_find_element(oonf_class_get_tree(), name, c, _node);
+}
+
+/**
+ * @return number of snapshots generated so far
+ */
+static uint32_t
+_get_snapshot_count(void) {
+  struct oonf_class *c;
+
+  c = _get_class("netjsoninfo snapshot");
+  return oonf_class_get_allocations(c) + oonf_class_get_recycled(c);
+}
+
+/**
+ * Run a netjsoninfo command without streaming
+ * @param out output buffer
+ * @param parameter parameter of netjsoninfo command
+ */
+static void
+_execute(struct autobuf *out, const char *parameter) {
+  abuf_clear(out);
+  oonf_telnet_execute(OONF_NETJSONINFO_SUBSYSTEM, parameter, out, NULL);
+}
+
+/**
+ * Create a telnet session and send it a command
+ * @param session telnet session
+ * @param line command line
+ */
+static void
+_start_session(struct oonf_telnet_session *session, const char *line) {
+  memset(session, 0, sizeof(*session));
+  abuf_init(&session->session.in);
+  abuf_init(&session->session.out);
+  session->session.state = STREAM_SESSION_ACTIVE;
+
+  _telnet_managed->config.init_session(&session->session);
+
+  abuf_puts(&session->session.in, line);
+  _telnet_managed->config.receive_data(&session->session);
+}
+
+static void
+_free_session(struct oonf_telnet_session *session) {
+  _telnet_managed->config.cleanup_session(&session->session);
+  abuf_free(&session->session.in);
+  abuf_free(&session->session.out);
+}
+
+/**
+ * "Send" the output buffer of a telnet session
+ * @param session telnet session
+ * @param sent buffer for all data sent through the session
+ */
+static void
+_send(struct oonf_telnet_session *session, struct autobuf *sent) {
+  abuf_memcpy(sent, abuf_getptr(&session->session.out), abuf_getlen(&session->session.out));
+  abuf_clear(&session->session.out);
+}
+
+static void
+clear_elements(void) {
+  uint32_t i;
+
+  for (i = 0; i < NODE_COUNT; i++) {
+    if (_node[i]) {
+      _remove_node(i);
+    }
+  }
+  _change_during_output = false;
+}
+
+static void
+test_stream_chunks(void) {
+  struct oonf_telnet_session session;
+  struct autobuf reference, sent;
+  size_t len;
+  int parts;
+
+  START_TEST();
+
+  abuf_init(&reference);
+  abuf_init(&sent);
+  _add_nodes();
+
+  _execute(&reference, "graph");
+  abuf_puts(&reference, "\n> ");
+  CHECK_TRUE(abuf_getlen(&reference) > 4 * OONF_TELNET_STREAM_CHUNK, "graph has only %" PRINTF_SIZE_T_SPECIFIER " bytes",
+    abuf_getlen(&reference));
+
+  _start_session(&session, "netjsoninfo graph\n");
+  CHECK_TRUE(session.data.underrun_handler != NULL, "output is not streamed");
+  CHECK_TRUE(abuf_getlen(&session.session.out) <= OONF_TELNET_STREAM_CHUNK,
+    "first part has %" PRINTF_SIZE_T_SPECIFIER " bytes", abuf_getlen(&session.session.out));
+
+  parts = 1;
+  while (session.data.underrun_handler != NULL && parts < 100) {
+    _send(&session, &sent);
+    _telnet_managed->config.buffer_underrun(&session.session);
+    parts++;
+
+    len = abuf_getlen(&session.session.out);
+    if (session.data.underrun_handler != NULL) {
+      CHECK_TRUE(len <= OONF_TELNET_STREAM_CHUNK, "part %d has %" PRINTF_SIZE_T_SPECIFIER " bytes", parts, len);
+    }
+  }
+  _send(&session, &sent);
+
+  CHECK_TRUE(parts > 4, "output was sent in %d parts", parts);
+  CHECK_TRUE(session.data.stop_handler == NULL, "stop handler still set after output");
+  CHECK_TRUE(abuf_getlen(&sent) == abuf_getlen(&reference) &&
+               memcmp(abuf_getptr(&sent), abuf_getptr(&reference), abuf_getlen(&sent)) == 0,
+    "streamed output differs from normal output");
+  CHECK_TRUE(oonf_class_get_usage(_get_class("netjsoninfo cursor")) == 0, "cursor was not freed");
+
+  _free_session(&session);
+  abuf_free(&reference);
+  abuf_free(&sent);
+
+  END_TEST();
+}
+
+static void
+test_stream_resume_after_removal(void) {
+  struct oonf_telnet_session session;
+  struct autobuf reference, sent;
+  uint32_t i;
+  int parts;
+
+  START_TEST();
+
+  abuf_init(&reference);
+  abuf_init(&sent);
+  _add_nodes();
+
+  _execute(&reference, "graph");
+  abuf_puts(&reference, "\n> ");
+
+  /* make sure the output is not taken from the cache */
+  _ansn++;
+
+  _start_session(&session, "netjsoninfo graph\n");
+  CHECK_TRUE(session.data.underrun_handler != NULL, "output is not streamed");
+
+  /* remove the nodes the output would continue with */
+  for (i = 0; i < NODE_COUNT; i += 2) {
+    _remove_node(i);
+  }
+
+  parts = 1;
+  while (session.data.underrun_handler != NULL && parts < 100) {
+    _send(&session, &sent);
+    _telnet_managed->config.buffer_underrun(&session.session);
+    parts++;
+  }
+  _send(&session, &sent);
+
+  CHECK_TRUE(abuf_getlen(&sent) == abuf_getlen(&reference) &&
+               memcmp(abuf_getptr(&sent), abuf_getptr(&reference), abuf_getlen(&sent)) == 0,
+    "streamed output is not the topology at the start of the command");
+
+  /* the next command sees the new topology */
+  _execute(&sent, "graph");
+  CHECK_TRUE(abuf_getlen(&sent) < abuf_getlen(&reference), "output after removal is not smaller");
+  CHECK_TRUE(strstr(abuf_getptr(&sent), "\"id_10.2.0.1\"") == NULL, "output contains removed node");
+  CHECK_TRUE(strstr(abuf_getptr(&sent), "\"id_10.2.0.2\"") != NULL, "output misses remaining node");
+
+  _free_session(&session);
+  abuf_free(&reference);
+  abuf_free(&sent);
+
+  END_TEST();
+}
+
+static void
+test_stream_stop(void) {
+  struct oonf_telnet_session session;
+  struct autobuf out;
+
+  START_TEST();
+
+  abuf_init(&out);
+  _add_nodes();
+
+  /* session closes in the middle of the output */
+  _start_session(&session, "netjsoninfo graph\n");
+  CHECK_TRUE(session.data.stop_handler != NULL, "output is not streamed");
+  CHECK_TRUE(oonf_class_get_usage(_get_class("netjsoninfo cursor")) == 1, "no cursor allocated");
+
+  _free_session(&session);
+  CHECK_TRUE(oonf_class_get_usage(_get_class("netjsoninfo cursor")) == 0, "cursor not freed after session end");
+
+  /* next command stops the output */
+  _start_session(&session, "netjsoninfo graph\n");
+  abuf_clear(&session.session.out);
+  abuf_puts(&session.session.in, "echo done\n");
+  _telnet_managed->config.receive_data(&session.session);
+  CHECK_TRUE(oonf_class_get_usage(_get_class("netjsoninfo cursor")) == 0, "cursor not freed after next command");
+  CHECK_TRUE(session.data.underrun_handler == NULL, "underrun handler still set after next command");
+  CHECK_TRUE(strcmp(abuf_getptr(&session.session.out), "done\n\n> ") == 0, "unexpected output after next command: %s",
+    abuf_getptr(&session.session.out));
+  _free_session(&session);
+
+  /* command chains are not streamed */
+  _start_session(&session, "/netjsoninfo graph\n");
+  CHECK_TRUE(session.data.stop_handler == NULL, "command chain is streamed");
+  CHECK_TRUE(oonf_class_get_usage(_get_class("netjsoninfo cursor")) == 0, "cursor not freed after command chain");
+  _execute(&out, "graph");
+  CHECK_TRUE(strcmp(abuf_getptr(&session.session.out), abuf_getptr(&out)) == 0, "unexpected command chain output");
+  _free_session(&session);
+
+  abuf_free(&out);
+
+  END_TEST();
+}
+
+static void
+test_stream_small(void) {
+  struct oonf_telnet_session session;
+  struct autobuf out;
+
+  START_TEST();
+
+  abuf_init(&out);
+
+  /* output fits into a single chunk and finishes directly */
+  _start_session(&session, "netjsoninfo filter graph ipv4_0\n");
+  _execute(&out, "filter graph ipv4_0");
+  abuf_puts(&out, "\n> ");
+
+  CHECK_TRUE(session.data.stop_handler == NULL, "small output is streamed");
+  CHECK_TRUE(oonf_class_get_usage(_get_class("netjsoninfo cursor")) == 0, "cursor not freed after small output");
+  CHECK_TRUE(strcmp(abuf_getptr(&session.session.out), abuf_getptr(&out)) == 0, "unexpected output: %s",
+    abuf_getptr(&session.session.out));
+
+  _free_session(&session);
+  abuf_free(&out);
+
+  END_TEST();
+}
+
+static void
+test_stream_plugin_unload(void) {
+  struct oonf_telnet_session session;
+  struct oonf_subsystem *netjsoninfo;
+
+  START_TEST();
+
+  _add_nodes();
+  netjsoninfo = oonf_subsystem_get(OONF_NETJSONINFO_SUBSYSTEM);
+
+  /* plugin is removed while a command is streamed */
+  _start_session(&session, "netjsoninfo graph\n");
+  CHECK_TRUE(session.data.stop_handler != NULL, "output is not streamed");
+
+  netjsoninfo->cleanup();
+  CHECK_TRUE(session.data.stop_handler == NULL, "stop handler still set after unload");
+  CHECK_TRUE(session.data.underrun_handler == NULL, "underrun handler still set after unload");
+
+  _free_session(&session);
+  netjsoninfo->init();
+
+  END_TEST();
+}
+
+static void
+test_snapshot_cache(void) {
+  struct autobuf first, out;
+  uint32_t count;
+
+  START_TEST();
+
+  abuf_init(&first);
+  abuf_init(&out);
+  _add_nodes();
+
+  _execute(&first, "filter graph ipv4_0");
+  count = _get_snapshot_count();
+
+  /* unchanged topology is copied from the cache */
+  _execute(&out, "filter graph ipv4_0");
+  CHECK_TRUE(_get_snapshot_count() == count, "unchanged graph was generated again");
+  CHECK_TRUE(strcmp(abuf_getptr(&first), abuf_getptr(&out)) == 0, "cached graph differs");
+
+  /* routing tree has its own cache slot */
+  _execute(&out, "filter route ipv4_0");
+  CHECK_TRUE(_get_snapshot_count() == count + 1, "routing tree was not generated");
+  _execute(&out, "filter graph ipv4_0");
+  CHECK_TRUE(_get_snapshot_count() == count + 1, "routing tree replaced cached graph");
+
+  /* every database change invalidates the cache */
+  _ansn++;
+  _execute(&out, "filter graph ipv4_0");
+  CHECK_TRUE(_get_snapshot_count() == count + 2, "graph was not generated after ANSN change");
+  CHECK_TRUE(strcmp(abuf_getptr(&first), abuf_getptr(&out)) == 0, "regenerated graph differs");
+
+  _generation++;
+  _execute(&out, "filter graph ipv4_0");
+  CHECK_TRUE(_get_snapshot_count() == count + 3, "graph was not generated after routing change");
+
+  _execute(&out, "filter graph ipv4_0");
+  CHECK_TRUE(_get_snapshot_count() == count + 3, "graph was generated again without change");
+
+  abuf_free(&first);
+  abuf_free(&out);
+
+  END_TEST();
+}
+
+static void
+test_snapshot_nhdp_fingerprint(void) {
+  struct nhdp_link lnk;
+  struct autobuf out;
+  uint32_t count;
+
+  START_TEST();
+
+  abuf_init(&out);
+  _add_nodes();
+
+  memset(&lnk, 0, sizeof(lnk));
+  _get_addr(&lnk.if_addr, 1000);
+  lnk.status = NHDP_LINK_HEARD;
+
+  _execute(&out, "filter graph ipv4_0");
+  count = _get_snapshot_count();
+
+  list_add_tail(&_link_list, &lnk._global_node);
+  _execute(&out, "filter graph ipv4_0");
+  CHECK_TRUE(_get_snapshot_count() == count + 1, "graph was not generated after new link");
+
+  lnk.status = NHDP_LINK_SYMMETRIC;
+  _execute(&out, "filter graph ipv4_0");
+  CHECK_TRUE(_get_snapshot_count() == count + 2, "graph was not generated after link status change");
+
+  nhdp_domain_get_linkdata(&_domain, &lnk)->metric.in = 1234;
+  _execute(&out, "filter graph ipv4_0");
+  CHECK_TRUE(_get_snapshot_count() == count + 3, "graph was not generated after metric change");
+
+  _execute(&out, "filter graph ipv4_0");
+  CHECK_TRUE(_get_snapshot_count() == count + 3, "graph was generated again without change");
+
+  list_remove(&lnk._global_node);
+  _execute(&out, "filter graph ipv4_0");
+  CHECK_TRUE(_get_snapshot_count() == count + 4, "graph was not generated after link removal");
+
+  abuf_free(&out);
+
+  END_TEST();
+}
+
+static void
+test_snapshot_changed_during_output(void) {
+  struct autobuf out;
+  uint32_t count, usage;
+
+  START_TEST();
+
+  abuf_init(&out);
+  _add_nodes();
+
+  _execute(&out, "filter graph ipv4_0");
+  count = _get_snapshot_count();
+  usage = oonf_class_get_usage(_get_class("netjsoninfo snapshot"));
+
+  /* snapshots generated while the topology changes are not cached */
+  _change_during_output = true;
+  _ansn++;
+  _execute(&out, "filter graph ipv4_0");
+  _execute(&out, "filter graph ipv4_0");
+  CHECK_TRUE(_get_snapshot_count() == count + 2, "graph of a changing topology was cached");
+  CHECK_TRUE(oonf_class_get_usage(_get_class("netjsoninfo snapshot")) == usage, "uncached snapshot was not freed");
+
+  _change_during_output = false;
+  _execute(&out, "filter graph ipv4_0");
+  _execute(&out, "filter graph ipv4_0");
+  CHECK_TRUE(_get_snapshot_count() == count + 3, "graph of a stable topology was not cached");
+  CHECK_TRUE(oonf_class_get_usage(_get_class("netjsoninfo snapshot")) == usage, "old snapshot was not replaced");
+
+  abuf_free(&out);
+
+  END_TEST();
+}
+
+static void
+test_output_version(void) {
+  struct oonf_telnet_session session;
+  char version[sizeof(session.data.output_version)];
+
+  START_TEST();
+
+  _add_nodes();
+
+  _start_session(&session, "netjsoninfo filter graph ipv4_0\n");
+  CHECK_TRUE(session.data.output_version[0] != 0, "no output version");
+  strscpy(version, session.data.output_version, sizeof(version));
+
+  /* version stays the same for the same databases */
+  abuf_puts(&session.session.in, "netjsoninfo filter graph ipv4_0\n");
+  _telnet_managed->config.receive_data(&session.session);
+  CHECK_TRUE(strcmp(version, session.data.output_version) == 0, "version changed without database change");
+
+  _generation++;
+  abuf_puts(&session.session.in, "netjsoninfo filter graph ipv4_0\n");
+  _telnet_managed->config.receive_data(&session.session);
+  CHECK_TRUE(strcmp(version, session.data.output_version) != 0, "version did not change with routing");
+  strscpy(version, session.data.output_version, sizeof(version));
+
+  _ansn++;
+  abuf_puts(&session.session.in, "netjsoninfo filter graph ipv4_0\n");
+  _telnet_managed->config.receive_data(&session.session);
+  CHECK_TRUE(strcmp(version, session.data.output_version) != 0, "version did not change with ANSN");
+
+  /* other commands have no version */
+  abuf_puts(&session.session.in, "echo test\n");
+  _telnet_managed->config.receive_data(&session.session);
+  CHECK_TRUE(session.data.output_version[0] == 0, "echo has an output version");
+
+  _free_session(&session);
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  struct oonf_subsystem *class_subsystem, *telnet, *netjsoninfo;
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+
+  class_subsystem = oonf_subsystem_get(OONF_CLASS_SUBSYSTEM);
+  telnet = oonf_subsystem_get(OONF_TELNET_SUBSYSTEM);
+  netjsoninfo = oonf_subsystem_get(OONF_NETJSONINFO_SUBSYSTEM);
+  if (class_subsystem == NULL || telnet == NULL || netjsoninfo == NULL || class_subsystem->init()) {
+    oonf_log_cleanup();
+    return 1;
+  }
+  telnet->init();
+  netjsoninfo->init();
+
+  _metric.link_to_string = _cb_link_to_string;
+  _metric.path_to_string = _cb_path_to_string;
+  _domain.metric = &_metric;
+  _domain.mpr = &_mpr;
+  list_init_head(&_domain_list);
+  list_add_tail(&_domain_list, &_domain._node);
+
+  list_init_head(&_link_list);
+  avl_init(&_neigh_tree, avl_comp_netaddr, false);
+  avl_init(&_lan_tree, os_routing_avl_cmp_route_key, false);
+  avl_init(&_tc_tree, avl_comp_netaddr, false);
+  avl_init(&_routing_tree, os_routing_avl_cmp_route_key, false);
+  _get_addr(&_originator, 0);
+
+  BEGIN_TESTING(clear_elements);
+
+  test_stream_small();
+  test_stream_chunks();
+  test_stream_resume_after_removal();
+  test_stream_stop();
+  test_stream_plugin_unload();
+  test_snapshot_cache();
+  test_snapshot_nhdp_fingerprint();
+  test_snapshot_changed_during_output();
+  test_output_version();
+
+  result = FINISH_TESTING();
+
+  clear_elements();
+  netjsoninfo->cleanup();
+  telnet->cleanup();
+  class_subsystem->cleanup();
+  oonf_log_cleanup();
+  return result;
+}
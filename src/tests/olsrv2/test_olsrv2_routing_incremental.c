@@ -0,0 +1,563 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <oonf/oonf.h>
+#include <oonf/libcommon/avl.h>
+#include <oonf/libcommon/avl_comp.h>
+#include <oonf/libcommon/list.h>
+#include <oonf/libcommon/netaddr.h>
+#include <oonf/libcore/oonf_logging.h>
+#include <oonf/libcore/oonf_subsystem.h>
+#include <oonf/base/oonf_class.h>
+#include <oonf/base/oonf_timer.h>
+#include <oonf/base/os_routing.h>
+#include <oonf/nhdp/nhdp/nhdp_db.h>
+#include <oonf/nhdp/nhdp/nhdp_domain.h>
+#include <oonf/nhdp/nhdp/nhdp_interfaces.h>
+#include <oonf/olsrv2/olsrv2/olsrv2.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_lan.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_originator.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_routing.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_tc.h>
+#include <oonf/olsrv2/olsrv2/olsrv2_writer.h>
+#include <oonf/cunit/cunit.h>
+
+#define NODE_COUNT 40
+#define NEIGH_COUNT 6
+#define EDGES_PER_NODE 3
+
+static struct oonf_appdata _appdata = {
+  .app_name = "test_olsrv2_routing_incremental",
+};
+
+/* NHDP neighbor class, the tc database extends it */
+static struct oonf_class _neigh_class = {
+  .name = NHDP_CLASS_NEIGHBOR,
+  .size = sizeof(struct nhdp_neighbor),
+};
+
+static struct nhdp_domain _domain;
+static size_t _domain_count;
+static struct list_entity _domain_list;
+static struct list_entity _neigh_list;
+static struct avl_tree _if_addr_tree;
+static struct avl_tree _lan_tree;
+static struct netaddr _originator;
+
+static struct olsrv2_tc_node *_node[NODE_COUNT];
+static struct nhdp_neighbor *_neigh[NEIGH_COUNT];
+static struct nhdp_link _link[NEIGH_COUNT];
+
+/* NHDP stubs */
+void
+nhdp_domain_listener_add(struct nhdp_domain_listener *listener __attribute__((unused))) {}
+
+void
+nhdp_domain_listener_remove(struct nhdp_domain_listener *listener __attribute__((unused))) {}
+
+struct list_entity *
+nhdp_domain_get_list(void) {
+  return &_domain_list;
+}
+
+size_t
+nhdp_domain_get_count(void) {
+  return _domain_count;
+}
+
+struct list_entity *
+nhdp_db_get_neigh_list(void) {
+  return &_neigh_list;
+}
+
+struct avl_tree *
+nhdp_interface_get_address_tree(void) {
+  return &_if_addr_tree;
+}
+
+/* OLSRv2 stubs */
+const struct netaddr *
+olsrv2_originator_get(int af_type) {
+  return af_type == AF_INET ? &_originator : &NETADDR_UNSPEC;
+}
+
+bool
+olsrv2_originator_is_local(const struct netaddr *addr) {
+  return netaddr_cmp(addr, &_originator) == 0;
+}
+
+struct avl_tree *
+olsrv2_lan_get_tree(void) {
+  return &_lan_tree;
+}
+
+bool
+olsrv2_is_nhdp_routable(struct netaddr *addr __attribute__((unused))) {
+  return true;
+}
+
+bool
+olsrv2_is_routable(struct netaddr *addr __attribute__((unused))) {
+  return true;
+}
+
+void
+olsrv2_writer_content_changed(void) {}
+
+/* kernel stubs, routes are never reported as finished */
+int
+os_routing_linux_set(struct os_route *route __attribute__((unused)), bool set __attribute__((unused)),
+  bool del_similar __attribute__((unused))) {
+  return 0;
+}
+
+void
+os_routing_linux_interrupt(struct os_route *route __attribute__((unused))) {}
+
+void
+os_routing_linux_transaction_begin(void) {}
+
+void
+os_routing_linux_transaction_commit(void) {}
+
+/* timer stubs, timers never fire */
+void
+oonf_timer_add(struct oonf_timer_class *ti __attribute__((unused))) {}
+
+void
+oonf_timer_remove(struct oonf_timer_class *ti __attribute__((unused))) {}
+
+void
+oonf_timer_set_ext(struct oonf_timer_instance *timer, uint64_t first, uint64_t interval) {
+  if (first == 0) {
+    oonf_timer_stop(timer);
+    return;
+  }
+  oonf_timer_start_ext(timer, first, interval);
+}
+
+void
+oonf_timer_start_ext(struct oonf_timer_instance *timer, uint64_t first, uint64_t interval) {
+  timer->_clock = first;
+  timer->_period = interval;
+}
+
+void
+oonf_timer_stop(struct oonf_timer_instance *timer) {
+  timer->_clock = 0;
+}
+
+static void
+_get_addr(struct netaddr *addr, uint32_t i) {
+  uint8_t bin[4];
+
+  bin[0] = 10;
+  bin[1] = 1;
+  bin[2] = 0;
+  bin[3] = i + 1;
+  netaddr_from_binary(addr, bin, 4, AF_INET);
+}
+
+/**
+ * @return random metric, including infinite ones
+ */
+static uint32_t
+_random_cost(void) {
+  if (rand() % 10 == 0) {
+    return RFC7181_METRIC_INFINITE;
+  }
+
+  /* use a wide range to make equal path costs unlikely */
+  return 0x100 + rand() % 0x100000;
+}
+
+static struct olsrv2_tc_edge *
+_get_edge(uint32_t i, uint32_t j) {
+  struct olsrv2_tc_edge *edge;
+
+  return avl_find_element(&_node[i]->_edges, &_node[j]->target.prefix.dst, edge, _node);
+}
+
+/**
+ * Set the cost of an edge the way the TC reader does
+ * @param i index of source node
+ * @param j index of destination node
+ * @param cost new cost of edge
+ */
+static void
+_set_edge(uint32_t i, uint32_t j, uint32_t cost) {
+  struct olsrv2_tc_edge *edge;
+
+  edge = olsrv2_tc_edge_add(_node[i], &_node[j]->target.prefix.dst);
+  edge->cost[_domain.index] = cost;
+
+  olsrv2_routing_dijkstra_node_changed(&_node[i]->target._dijkstra);
+  olsrv2_routing_domain_changed(&_domain, false);
+}
+
+static void
+_add_neighbor(uint32_t x) {
+  struct nhdp_neighbor_domaindata *neighdata;
+  struct nhdp_neighbor *neigh;
+
+  neigh = oonf_class_malloc(&_neigh_class);
+  _get_addr(&neigh->originator, x);
+  memcpy(&neigh->_old_originator, &neigh->originator, sizeof(neigh->originator));
+  list_init_head(&neigh->_links);
+  avl_init(&neigh->_neigh_addresses, avl_comp_netaddr, false);
+  neigh->symmetric = 1;
+
+  memcpy(&_link[x].if_addr, &neigh->originator, sizeof(_link[x].if_addr));
+  neighdata = nhdp_domain_get_neighbordata(&_domain, neigh);
+  neighdata->metric.in = 0x1000;
+  neighdata->metric.out = 0x100 + rand() % 0x100000;
+  neighdata->best_out_link = &_link[x];
+  neighdata->best_link_ifindex = 1;
+
+  list_add_tail(&_neigh_list, &neigh->_global_node);
+  oonf_class_event(&_neigh_class, neigh, OONF_OBJECT_ADDED);
+
+  _neigh[x] = neigh;
+}
+
+static void
+_remove_neighbor(uint32_t x) {
+  oonf_class_event(&_neigh_class, _neigh[x], OONF_OBJECT_REMOVED);
+  list_remove(&_neigh[x]->_global_node);
+  oonf_class_free(&_neigh_class, _neigh[x]);
+
+  _neigh[x] = NULL;
+  olsrv2_routing_domain_changed(&_domain, false);
+}
+
+/**
+ * Create a random topology with symmetric edges and calculate
+ * the first shortest path tree
+ */
+static void
+_create_topology(void) {
+  struct netaddr addr;
+  uint32_t i, j, e;
+
+  for (i = 0; i < NODE_COUNT; i++) {
+    _get_addr(&addr, i);
+    _node[i] = olsrv2_tc_node_add(&addr, 1000000, 0);
+  }
+  for (i = 0; i < NODE_COUNT; i++) {
+    for (e = 0; e < EDGES_PER_NODE; e++) {
+      j = rand() % NODE_COUNT;
+      if (i != j) {
+        _set_edge(i, j, _random_cost());
+        _set_edge(j, i, _random_cost());
+      }
+    }
+  }
+  for (i = 0; i < NEIGH_COUNT; i++) {
+    _add_neighbor(i);
+  }
+
+  olsrv2_routing_domain_changed(&_domain, false);
+  olsrv2_routing_force_update(true);
+}
+
+/**
+ * Compare the current shortest path tree with the result of a full dijkstra run
+ * @return true if both trees are the same
+ */
+static bool
+_check_with_full_run(void) {
+  struct olsrv2_dijkstra_node tree[NODE_COUNT];
+  struct olsrv2_dijkstra_node *full;
+  uint32_t i;
+  bool ok;
+
+  for (i = 0; i < NODE_COUNT; i++) {
+    memcpy(&tree[i], &_node[i]->target._dijkstra, sizeof(tree[i]));
+  }
+
+  olsrv2_routing_dijkstra_invalidate();
+  olsrv2_routing_domain_changed(&_domain, false);
+  olsrv2_routing_force_update(true);
+
+  ok = true;
+  for (i = 0; i < NODE_COUNT; i++) {
+    full = &_node[i]->target._dijkstra;
+
+    CHECK_TRUE(tree[i].path_cost == full->path_cost, "node %u has path cost %u, full run %u", i, tree[i].path_cost,
+      full->path_cost);
+    CHECK_TRUE(tree[i].first_hop == full->first_hop, "node %u has a different first hop", i);
+    CHECK_TRUE(tree[i].path_hops == full->path_hops, "node %u has %u hops, full run %u", i, tree[i].path_hops,
+      full->path_hops);
+    ok &= tree[i].path_cost == full->path_cost && tree[i].first_hop == full->first_hop &&
+          tree[i].path_hops == full->path_hops;
+  }
+  return ok;
+}
+
+static void
+clear_elements(void) {
+  uint32_t x;
+
+  for (x = 0; x < NEIGH_COUNT; x++) {
+    if (_neigh[x]) {
+      _remove_neighbor(x);
+    }
+  }
+
+  olsrv2_tc_cleanup();
+  olsrv2_tc_init();
+
+  memset(_node, 0, sizeof(_node));
+  _domain_count = 1;
+  _get_addr(&_originator, NODE_COUNT);
+  olsrv2_routing_set_incremental_limit(100);
+}
+
+static void
+test_random_changes(void) {
+  const struct olsrv2_routing_statistics *stats;
+  struct nhdp_neighbor_domaindata *neighdata;
+  struct olsrv2_tc_edge *edge;
+  uint32_t step, i, j, incremental_runs;
+
+  START_TEST();
+
+  stats = olsrv2_routing_get_statistics();
+  _create_topology();
+
+  incremental_runs = stats->incremental_runs;
+  for (step = 0; step < 1000; step++) {
+    i = rand() % NODE_COUNT;
+    j = rand() % NODE_COUNT;
+    edge = i == j ? NULL : _get_edge(i, j);
+
+    switch (rand() % 6) {
+      case 0:
+        /* edge gets cheaper or more expensive */
+        if (edge && !edge->virtual) {
+          _set_edge(i, j, _random_cost());
+        }
+        break;
+      case 1:
+        /* new edge */
+        if (i != j && (edge == NULL || edge->virtual)) {
+          _set_edge(i, j, _random_cost());
+        }
+        break;
+      case 2:
+        /* edge is lost */
+        if (edge && !edge->virtual) {
+          olsrv2_tc_edge_remove(edge);
+        }
+        break;
+      case 3:
+        /* link gets cheaper or more expensive */
+        neighdata = nhdp_domain_get_neighbordata(&_domain, _neigh[i % NEIGH_COUNT]);
+        neighdata->metric.out = _random_cost();
+        olsrv2_routing_domain_changed(&_domain, false);
+        break;
+      case 4:
+        /* link is lost or comes back */
+        _neigh[i % NEIGH_COUNT]->symmetric = _neigh[i % NEIGH_COUNT]->symmetric ? 0 : 1;
+        olsrv2_routing_domain_changed(&_domain, false);
+        break;
+      default:
+        /* incoming link metric is lost or comes back */
+        neighdata = nhdp_domain_get_neighbordata(&_domain, _neigh[i % NEIGH_COUNT]);
+        neighdata->metric.in = neighdata->metric.in == RFC7181_METRIC_INFINITE ? 0x1000 : RFC7181_METRIC_INFINITE;
+        olsrv2_routing_domain_changed(&_domain, false);
+        break;
+    }
+
+    olsrv2_routing_force_update(true);
+    if (!_check_with_full_run()) {
+      break;
+    }
+  }
+
+  CHECK_TRUE(stats->incremental_runs - incremental_runs > 500, "only %u of %u runs were incremental",
+    stats->incremental_runs - incremental_runs, step);
+
+  END_TEST();
+}
+
+static void
+test_invalidation(void) {
+  const struct olsrv2_routing_statistics *stats;
+  struct netaddr addr;
+  uint32_t full_runs, incremental_runs, fallbacks;
+
+  START_TEST();
+
+  stats = olsrv2_routing_get_statistics();
+  _create_topology();
+
+  /* a single edge change is repaired */
+  incremental_runs = stats->incremental_runs;
+  _set_edge(0, NEIGH_COUNT, 0x100);
+  olsrv2_routing_force_update(true);
+  CHECK_TRUE(stats->incremental_runs == incremental_runs + 1, "edge change was not repaired incrementally");
+  _check_with_full_run();
+
+  /* explicit invalidation */
+  full_runs = stats->full_runs;
+  olsrv2_routing_dijkstra_invalidate();
+  olsrv2_routing_domain_changed(&_domain, false);
+  olsrv2_routing_force_update(true);
+  CHECK_TRUE(stats->full_runs == full_runs + 1, "invalidated tree was not recalculated");
+
+  /* removal of a tc node */
+  full_runs = stats->full_runs;
+  _get_addr(&addr, NODE_COUNT + 1);
+  olsrv2_tc_node_remove(olsrv2_tc_node_add(&addr, 1000000, 0));
+  olsrv2_routing_force_update(true);
+  CHECK_TRUE(stats->full_runs == full_runs + 1, "tree was not recalculated after tc node removal");
+
+  /* removal of a neighbor */
+  full_runs = stats->full_runs;
+  _remove_neighbor(0);
+  olsrv2_routing_force_update(true);
+  CHECK_TRUE(stats->full_runs == full_runs + 1, "tree was not recalculated after neighbor removal");
+  CHECK_TRUE(_check_with_full_run(), "tree after neighbor removal");
+
+  /* originator becomes part of the topology */
+  full_runs = stats->full_runs;
+  _get_addr(&_originator, 1);
+  olsrv2_routing_domain_changed(&_domain, false);
+  olsrv2_routing_force_update(true);
+  CHECK_TRUE(stats->full_runs == full_runs + 1, "tree was not recalculated after originator change");
+  CHECK_TRUE(_node[1]->target._dijkstra.local, "originator is not the root of the tree");
+
+  /* incremental runs are disabled */
+  full_runs = stats->full_runs;
+  olsrv2_routing_set_incremental_limit(0);
+  _set_edge(2, 3, 0x100);
+  olsrv2_routing_force_update(true);
+  CHECK_TRUE(stats->full_runs == full_runs + 1, "full run without incremental limit");
+
+  /* too many changes */
+  full_runs = stats->full_runs;
+  fallbacks = stats->fallbacks;
+  olsrv2_routing_set_incremental_limit(1);
+  _set_edge(2, 3, 0x200);
+  _set_edge(3, 2, 0x200);
+  olsrv2_routing_force_update(true);
+  CHECK_TRUE(stats->full_runs == full_runs + 1, "full run after too many changes");
+  CHECK_TRUE(stats->fallbacks == fallbacks + 1, "fallback was not counted");
+
+  /* more than one domain */
+  olsrv2_routing_set_incremental_limit(100);
+  _domain_count = 2;
+  full_runs = stats->full_runs;
+  _set_edge(2, 3, 0x300);
+  olsrv2_routing_force_update(true);
+  _set_edge(2, 3, 0x400);
+  olsrv2_routing_force_update(true);
+  CHECK_TRUE(stats->full_runs == full_runs + 2, "incremental run with multiple domains");
+
+  /* back to a single domain, first run builds a valid tree */
+  _domain_count = 1;
+  _set_edge(2, 3, 0x500);
+  olsrv2_routing_force_update(true);
+  incremental_runs = stats->incremental_runs;
+  _set_edge(2, 3, 0x600);
+  olsrv2_routing_force_update(true);
+  CHECK_TRUE(stats->incremental_runs == incremental_runs + 1, "no incremental run after valid tree");
+  CHECK_TRUE(_check_with_full_run(), "tree after domain count change");
+
+  END_TEST();
+}
+
+int
+main(int argc __attribute__((unused)), char **argv __attribute__((unused))) {
+  struct oonf_subsystem *class_subsystem;
+  int result;
+
+  if (oonf_log_init(&_appdata, LOG_SEVERITY_WARN)) {
+    return 1;
+  }
+
+  class_subsystem = oonf_subsystem_get(OONF_CLASS_SUBSYSTEM);
+  if (class_subsystem == NULL || class_subsystem->init()) {
+    oonf_log_cleanup();
+    return 1;
+  }
+
+  oonf_class_add(&_neigh_class);
+
+  list_init_head(&_domain_list);
+  list_init_head(&_neigh_list);
+  avl_init(&_if_addr_tree, avl_comp_netaddr, false);
+  avl_init(&_lan_tree, os_routing_avl_cmp_route_key, false);
+
+  _domain.index = 0;
+  list_add_tail(&_domain_list, &_domain._node);
+
+  srand(42);
+  olsrv2_tc_init();
+  if (olsrv2_routing_init()) {
+    return 1;
+  }
+
+  BEGIN_TESTING(clear_elements);
+
+  test_random_changes();
+  test_invalidation();
+
+  result = FINISH_TESTING();
+
+  clear_elements();
+  olsrv2_routing_cleanup();
+  olsrv2_tc_cleanup();
+
+  oonf_class_remove(&_neigh_class);
+
+  class_subsystem->cleanup();
+  oonf_log_cleanup();
+  return result;
+}
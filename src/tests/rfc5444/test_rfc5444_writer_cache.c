@@ -0,0 +1,270 @@
+
+/*
+ * The olsr.org Optimized Link-State Routing daemon version 2 (olsrd2)
+ * Copyright (c) 2004-2015, the olsr.org team - see HISTORY file
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * * Neither the name of olsr.org, olsrd nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Visit http://www.olsr.org for more information.
+ *
+ * If you find this software useful feel free to make a donation
+ * to the project. For more information see the website or contact
+ * the copyright holders.
+ *
+ */
+
+/**
+ * @file
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <oonf/librfc5444/rfc5444_context.h>
+#include <oonf/librfc5444/rfc5444_writer.h>
+#include <oonf/cunit/cunit.h>
+
+#define MSG_TYPE 1
+
+/* packet header (1) + type, flags, size (4) + originator (4) */
+#define OFFSET_HOPLIMIT 9
+#define OFFSET_HOPCOUNT 10
+#define OFFSET_SEQNO    11
+
+static void write_packet(struct rfc5444_writer *,
+    struct rfc5444_writer_target *, void *, size_t);
+static void addMessageTLVs(struct rfc5444_writer *wr);
+static void addAddresses(struct rfc5444_writer *wr);
+
+static uint8_t msg_buffer[128];
+static uint8_t msg_addrtlvs[1000];
+
+static struct rfc5444_writer writer = {
+  .msg_buffer = msg_buffer,
+  .msg_size = sizeof(msg_buffer),
+  .addrtlv_buffer = msg_addrtlvs,
+  .addrtlv_size = sizeof(msg_addrtlvs),
+};
+
+static struct rfc5444_writer_content_provider cpr = {
+  .msg_type = MSG_TYPE,
+  .addMessageTLVs = addMessageTLVs,
+  .addAddresses = addAddresses,
+};
+
+static struct rfc5444_writer_tlvtype addrtlvs[] = {
+  { .type = 3 },
+};
+
+static uint8_t packet_buffer_if[128];
+static struct rfc5444_writer_target interf = {
+  .packet_buffer = packet_buffer_if,
+  .packet_size = sizeof(packet_buffer_if),
+  .sendPacket = write_packet,
+};
+
+static struct rfc5444_writer_message *msg;
+
+static const uint8_t originator[4] = { 10, 0, 0, 1 };
+static uint16_t seqno;
+static uint8_t hoplimit;
+static int addrcount, provider_calls;
+
+static uint8_t packet[2][128];
+static size_t packet_len[2];
+static int packets;
+
+static int addMessageHeader(struct rfc5444_writer *wr, struct rfc5444_writer_message *m) {
+  rfc5444_writer_set_msg_header(wr, m, true, true, true, true);
+  rfc5444_writer_set_msg_originator(wr, m, originator);
+  rfc5444_writer_set_msg_hoplimit(wr, m, hoplimit);
+  rfc5444_writer_set_msg_hopcount(wr, m, 0);
+  return RFC5444_OKAY;
+}
+
+static void finishMessageHeader(struct rfc5444_writer *wr,
+    struct rfc5444_writer_message *m,
+    struct rfc5444_writer_address *first_addr __attribute__ ((unused)),
+    struct rfc5444_writer_address *last_addr __attribute__ ((unused)),
+    bool not_fragmented __attribute__ ((unused))) {
+  rfc5444_writer_set_msg_seqno(wr, m, ++seqno);
+}
+
+static void addMessageTLVs(struct rfc5444_writer *wr) {
+  uint8_t value = 42;
+
+  provider_calls++;
+  rfc5444_writer_add_messagetlv(wr, 1, 0, &value, sizeof(value));
+}
+
+static void addAddresses(struct rfc5444_writer *wr) {
+  struct netaddr ip = { { 10,0,0,0}, AF_INET, 32 };
+  struct rfc5444_writer_address *addr;
+  uint8_t value[20];
+  int i;
+
+  memset(value, 0, sizeof(value));
+  for (i=0; i<addrcount; i++) {
+    ip._addr[2] = i+1;
+    ip._addr[3] = i+1;
+
+    addr = rfc5444_writer_add_address(wr, cpr.creator, &ip, false);
+    value[0] = i;
+    rfc5444_writer_add_addrtlv(wr, addr, &addrtlvs[0], value, sizeof(value), false);
+  }
+}
+
+static void write_packet(struct rfc5444_writer *w __attribute__ ((unused)),
+    struct rfc5444_writer_target *iface __attribute__ ((unused)),
+    void *buffer, size_t length) {
+  if (packets < 2) {
+    memcpy(packet[packets], buffer, length);
+    packet_len[packets] = length;
+  }
+  packets++;
+}
+
+static void clear_elements(void) {
+  provider_calls = 0;
+  packets = 0;
+  addrcount = 2;
+  hoplimit = 255;
+  msg->cache_hits = 0;
+  msg->cache_misses = 0;
+  msg->content_generation++;
+}
+
+static void send_message(void) {
+  rfc5444_writer_create_message_alltarget(&writer, MSG_TYPE, 4);
+  rfc5444_writer_flush(&writer, &interf, false);
+}
+
+static void test_cache_reuse(void) {
+  START_TEST();
+
+  send_message();
+  send_message();
+
+  CHECK_TRUE(provider_calls == 1, "content provider called %d times", provider_calls);
+  CHECK_TRUE(msg->cache_hits == 1, "cache hits: %u", msg->cache_hits);
+  CHECK_TRUE(msg->cache_misses == 1, "cache misses: %u", msg->cache_misses);
+  CHECK_TRUE(packets == 2, "packets: %d", packets);
+
+  CHECK_TRUE(packet_len[0] == packet_len[1], "packet length changed: %zu != %zu", packet_len[0], packet_len[1]);
+  CHECK_TRUE(packet[1][OFFSET_SEQNO] == (seqno >> 8) && packet[1][OFFSET_SEQNO + 1] == (seqno & 255),
+      "seqno not patched: %02x%02x != %04x", packet[1][OFFSET_SEQNO], packet[1][OFFSET_SEQNO + 1], seqno);
+  CHECK_TRUE(memcmp(packet[0], packet[1], OFFSET_SEQNO) == 0, "message header changed");
+  CHECK_TRUE(memcmp(&packet[0][OFFSET_SEQNO + 2], &packet[1][OFFSET_SEQNO + 2], packet_len[0] - OFFSET_SEQNO - 2) == 0,
+      "message content changed");
+
+  END_TEST();
+}
+
+static void test_cache_hoplimit(void) {
+  START_TEST();
+
+  send_message();
+  hoplimit = 17;
+  send_message();
+
+  CHECK_TRUE(provider_calls == 1, "content provider called %d times", provider_calls);
+  CHECK_TRUE(packet[0][OFFSET_HOPLIMIT] == 255, "bad hoplimit of first message: %u", packet[0][OFFSET_HOPLIMIT]);
+  CHECK_TRUE(packet[1][OFFSET_HOPLIMIT] == 17, "hoplimit not patched: %u", packet[1][OFFSET_HOPLIMIT]);
+  CHECK_TRUE(packet[1][OFFSET_HOPCOUNT] == 0, "bad hopcount: %u", packet[1][OFFSET_HOPCOUNT]);
+
+  END_TEST();
+}
+
+static void test_cache_generation(void) {
+  START_TEST();
+
+  send_message();
+  addrcount = 1;
+  msg->content_generation++;
+  send_message();
+
+  CHECK_TRUE(provider_calls == 2, "content provider called %d times", provider_calls);
+  CHECK_TRUE(msg->cache_hits == 0, "cache hits: %u", msg->cache_hits);
+  CHECK_TRUE(packet_len[0] > packet_len[1], "content did not change: %zu <= %zu", packet_len[0], packet_len[1]);
+
+  END_TEST();
+}
+
+static void test_cache_clear(void) {
+  START_TEST();
+
+  send_message();
+  rfc5444_writer_clear_message_cache(msg);
+  send_message();
+
+  CHECK_TRUE(provider_calls == 2, "content provider called %d times", provider_calls);
+  CHECK_TRUE(msg->cache_hits == 0, "cache hits: %u", msg->cache_hits);
+
+  END_TEST();
+}
+
+static void test_cache_fragmented(void) {
+  START_TEST();
+
+  addrcount = 8;
+  send_message();
+  send_message();
+
+  CHECK_TRUE(packets == 4, "message was not fragmented: %d packets", packets);
+  CHECK_TRUE(provider_calls == 2, "content provider called %d times", provider_calls);
+  CHECK_TRUE(msg->cache_hits == 0, "cache hits: %u", msg->cache_hits);
+
+  END_TEST();
+}
+
+int main(int argc __attribute__ ((unused)), char **argv __attribute__ ((unused))) {
+  rfc5444_writer_init(&writer);
+
+  rfc5444_writer_register_target(&writer, &interf);
+
+  msg = rfc5444_writer_register_message(&writer, MSG_TYPE, false);
+  msg->addMessageHeader = addMessageHeader;
+  msg->finishMessageHeader = finishMessageHeader;
+  msg->cache_enabled = true;
+
+  rfc5444_writer_register_msgcontentprovider(&writer, &cpr, addrtlvs, ARRAYSIZE(addrtlvs));
+
+  BEGIN_TESTING(clear_elements);
+
+  test_cache_reuse();
+  test_cache_hoplimit();
+  test_cache_generation();
+  test_cache_clear();
+  test_cache_fragmented();
+
+  rfc5444_writer_cleanup(&writer);
+
+  return FINISH_TESTING();
+}